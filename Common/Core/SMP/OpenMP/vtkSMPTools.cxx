@@ -34,11 +34,6 @@ void vtkSMPTools::Initialize(int numThreads)
   }
 }
 
-int vtkSMPTools::GetEstimatedNumberOfThreads()
-{
-  return vtk::detail::smp::GetNumberOfThreads();
-}
-
 int vtk::detail::smp::GetNumberOfThreads()
 {
   return vtkSMPNumberOfSpecifiedThreads ? vtkSMPNumberOfSpecifiedThreads :
@@ -49,13 +44,22 @@ void vtk::detail::smp::vtkSMPTools_Impl_For_OpenMP(vtkIdType first,
   vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
   void *functor)
 {
+  int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
   if (grain <= 0)
   {
-    vtkIdType estimateGrain = (last - first)/(omp_get_max_threads() * 4);
+    vtkIdType estimateGrain = (last - first)/(numThreads * 4);
     grain = (estimateGrain > 0) ? estimateGrain : 1;
   }
 
-# pragma omp parallel for schedule(runtime)
+  // Nested loops only get here when vtkSMPTools::SetNestedParallelism() is
+  // on. Make sure the OpenMP runtime does not serialize them.
+  if (omp_in_parallel() &&
+      omp_get_max_active_levels() <= omp_get_active_level())
+  {
+    omp_set_max_active_levels(omp_get_active_level() + 1);
+  }
+
+# pragma omp parallel for schedule(runtime) num_threads(numThreads)
   for (vtkIdType from = first; from < last; from += grain)
   {
     functorExecuter(functor, from, grain, last);
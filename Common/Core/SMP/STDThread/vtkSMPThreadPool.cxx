@@ -0,0 +1,239 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPThreadPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPThreadPool.h"
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+namespace
+{
+// A range of chunk indices owned by one participant. The owner pops from
+// the front, thieves pop from the back. Chunks are only ever removed, so a
+// simple lock per queue is enough and is rarely contended.
+struct ChunkQueue
+{
+  std::mutex Lock;
+  vtkIdType Begin;
+  vtkIdType End;
+
+  ChunkQueue() : Begin(0), End(0)
+  {
+  }
+
+  bool PopFront(vtkIdType& chunk)
+  {
+    std::lock_guard<std::mutex> guard(this->Lock);
+    if (this->Begin >= this->End)
+    {
+      return false;
+    }
+    chunk = this->Begin++;
+    return true;
+  }
+
+  bool PopBack(vtkIdType& chunk)
+  {
+    std::lock_guard<std::mutex> guard(this->Lock);
+    if (this->Begin >= this->End)
+    {
+      return false;
+    }
+    chunk = --this->End;
+    return true;
+  }
+};
+}
+
+struct vtkSMPThreadPool::Job
+{
+  ExecuteFunctorPtrType Executer;
+  void *Functor;
+  vtkIdType First;
+  vtkIdType Last;
+  vtkIdType Grain;
+
+  std::vector<ChunkQueue> Queues;
+  // Next participant slot to hand out to a worker, and the number of
+  // workers currently inside RunJob(). Both are protected by the pool mutex.
+  int NextSlot;
+  int ActiveWorkers;
+
+  explicit Job(int numParticipants)
+    : Executer(nullptr), Functor(nullptr), First(0), Last(0), Grain(1),
+      Queues(numParticipants), NextSlot(1), ActiveWorkers(0)
+  {
+  }
+};
+
+//--------------------------------------------------------------------------------
+vtkSMPThreadPool& vtkSMPThreadPool::GetInstance()
+{
+  static vtkSMPThreadPool instance;
+  return instance;
+}
+
+//--------------------------------------------------------------------------------
+vtkSMPThreadPool::vtkSMPThreadPool() : Stop(false)
+{
+}
+
+//--------------------------------------------------------------------------------
+vtkSMPThreadPool::~vtkSMPThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Stop = true;
+  }
+  this->WorkAvailable.notify_all();
+  for (size_t i = 0; i < this->Workers.size(); ++i)
+  {
+    this->Workers[i].join();
+  }
+}
+
+//--------------------------------------------------------------------------------
+// Must be called with the pool mutex held.
+void vtkSMPThreadPool::EnsureWorkers(int numWorkers)
+{
+  while (static_cast<int>(this->Workers.size()) < numWorkers)
+  {
+    this->Workers.push_back(std::thread(&vtkSMPThreadPool::WorkerLoop, this));
+  }
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::WorkerLoop()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  for (;;)
+  {
+    while (!this->Stop && this->Jobs.empty())
+    {
+      this->WorkAvailable.wait(lock);
+    }
+    if (this->Stop)
+    {
+      return;
+    }
+
+    Job *job = this->Jobs.front();
+    int slot = job->NextSlot++;
+    if (job->NextSlot >= static_cast<int>(job->Queues.size()))
+    {
+      // Every participant slot is taken, the job no longer needs helpers.
+      this->Jobs.pop_front();
+    }
+    ++job->ActiveWorkers;
+
+    lock.unlock();
+    vtkSMPThreadPool::RunJob(job, slot);
+    lock.lock();
+
+    --job->ActiveWorkers;
+    this->WorkerDone.notify_all();
+  }
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::RunJob(Job *job, int slot)
+{
+  const int numQueues = static_cast<int>(job->Queues.size());
+  ChunkQueue& own = job->Queues[slot];
+  vtkIdType chunk;
+  for (;;)
+  {
+    bool found = own.PopFront(chunk);
+    for (int i = 1; !found && i < numQueues; ++i)
+    {
+      found = job->Queues[(slot + i) % numQueues].PopBack(chunk);
+    }
+    if (!found)
+    {
+      return;
+    }
+    job->Executer(job->Functor, job->First + chunk * job->Grain, job->Grain,
+                  job->Last);
+  }
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::ParallelFor(vtkIdType first, vtkIdType last,
+  vtkIdType grain, ExecuteFunctorPtrType functorExecuter, void *functor,
+  int numThreads)
+{
+  vtkIdType numChunks = (last - first + grain - 1) / grain;
+  if (numThreads > numChunks)
+  {
+    numThreads = static_cast<int>(numChunks);
+  }
+  if (numThreads <= 1)
+  {
+    for (vtkIdType from = first; from < last; from += grain)
+    {
+      functorExecuter(functor, from, grain, last);
+    }
+    return;
+  }
+
+  // Give each participant a contiguous block of chunks so that a balanced
+  // loop behaves like a static schedule.
+  Job job(numThreads);
+  job.Executer = functorExecuter;
+  job.Functor = functor;
+  job.First = first;
+  job.Last = last;
+  job.Grain = grain;
+  for (int i = 0; i < numThreads; ++i)
+  {
+    job.Queues[i].Begin = numChunks * i / numThreads;
+    job.Queues[i].End = numChunks * (i + 1) / numThreads;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->EnsureWorkers(numThreads - 1);
+    this->Jobs.push_back(&job);
+  }
+  this->WorkAvailable.notify_all();
+
+  // The calling thread is participant 0.
+  vtkSMPThreadPool::RunJob(&job, 0);
+
+  // All chunks have been claimed. Make sure no new worker picks up the job
+  // and wait for the ones still executing their last chunk.
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  for (std::deque<Job*>::iterator it = this->Jobs.begin();
+       it != this->Jobs.end(); ++it)
+  {
+    if (*it == &job)
+    {
+      this->Jobs.erase(it);
+      break;
+    }
+  }
+  while (job.ActiveWorkers > 0)
+  {
+    this->WorkerDone.wait(lock);
+  }
+}
+
+}//namespace smp
+}//namespace detail
+}//namespace vtk
@@ -0,0 +1,96 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPThreadPool.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSMPThreadPool - A persistent, work-stealing pool of std::threads.
+// .SECTION Description
+// vtkSMPThreadPool is the execution engine of the STDThread backend of
+// vtkSMPTools. The worker threads are created the first time a parallel
+// loop is run and live until the process exits.
+//
+// A parallel loop is cut into chunks of "grain" iterations. The chunks are
+// distributed in contiguous blocks over one double-ended queue per
+// participating thread. Each thread consumes its own queue from the front
+// and, once it is empty, steals chunks from the back of the other queues.
+// This keeps the locality of a static schedule for regular work while
+// balancing irregular work (contouring, clipping...) dynamically.
+//
+// The thread that calls ParallelFor() always participates in the loop, so a
+// loop never waits for a worker to become available. This also makes calls
+// from several application threads, or from inside another parallel loop,
+// safe: idle workers join whichever loops are pending.
+//
+// This class is an implementation detail of vtkSMPTools and is not
+// installed.
+
+#ifndef vtkSMPThreadPool_h
+#define vtkSMPThreadPool_h
+
+#include "vtkSystemIncludes.h"
+#include "vtkSMPToolsInternal.h" // For ExecuteFunctorPtrType
+
+#include <condition_variable> // For std::condition_variable
+#include <deque> // For std::deque
+#include <mutex> // For std::mutex
+#include <thread> // For std::thread
+#include <vector> // For std::vector
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+class vtkSMPThreadPool
+{
+public:
+  // Description:
+  // Returns the process-wide pool.
+  static vtkSMPThreadPool& GetInstance();
+
+  // Description:
+  // Execute functorExecuter over [first, last) in chunks of grain using at
+  // most numThreads threads, including the calling one. Returns once all
+  // chunks have been executed.
+  void ParallelFor(vtkIdType first, vtkIdType last, vtkIdType grain,
+    ExecuteFunctorPtrType functorExecuter, void *functor, int numThreads);
+
+  ~vtkSMPThreadPool();
+
+private:
+  struct Job;
+
+  vtkSMPThreadPool();
+
+  void EnsureWorkers(int numWorkers);
+  void WorkerLoop();
+  static void RunJob(Job *job, int slot);
+
+  std::mutex Mutex;
+  std::condition_variable WorkAvailable;
+  std::condition_variable WorkerDone;
+  std::deque<Job*> Jobs;
+  std::vector<std::thread> Workers;
+  bool Stop;
+
+  vtkSMPThreadPool(const vtkSMPThreadPool&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkSMPThreadPool&) VTK_DELETE_FUNCTION;
+};
+
+}//namespace smp
+}//namespace detail
+}//namespace vtk
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPThreadPool.h
@@ -0,0 +1,62 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTools.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPTools.h"
+
+#include "vtkSMPThreadPool.h"
+
+#include <atomic>
+#include <thread>
+
+namespace
+{
+std::atomic<int> vtkSMPNumberOfSpecifiedThreads(0);
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPTools::Initialize(int numThreads)
+{
+  if (numThreads > 0)
+  {
+    vtkSMPNumberOfSpecifiedThreads = numThreads;
+  }
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::GetNumberOfThreads()
+{
+  int numThreads = vtkSMPNumberOfSpecifiedThreads;
+  if (numThreads <= 0)
+  {
+    numThreads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  return numThreads > 0 ? numThreads : 1;
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPTools_Impl_For_STDThread(vtkIdType first,
+  vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
+  void *functor)
+{
+  int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  if (grain <= 0)
+  {
+    vtkIdType estimateGrain = (last - first)/(numThreads * 4);
+    grain = (estimateGrain > 0) ? estimateGrain : 1;
+  }
+
+  vtkSMPThreadPool::GetInstance().ParallelFor(first, last, grain,
+    functorExecuter, functor, numThreads);
+}
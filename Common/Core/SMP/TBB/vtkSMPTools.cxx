@@ -51,7 +51,7 @@ void vtkSMPTools::Initialize(int numThreads)
 }
 
 //--------------------------------------------------------------------------------
-int vtkSMPTools::GetEstimatedNumberOfThreads()
+int vtk::detail::smp::GetNumberOfThreads()
 {
   return vtkTBBNumSpecifiedThreads ? vtkTBBNumSpecifiedThreads
     : tbb::task_scheduler_init::default_num_threads();
@@ -15,9 +15,41 @@
 #include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkNew.h"
+#include "vtkObjectFactory.h"
 
 #include <limits>
 
+namespace
+{
+// A periodic array whose ranges are overridden: GetRange() must report them.
+class FixedRangePeriodicArray : public vtkAngularPeriodicDataArray<double>
+{
+public:
+  static FixedRangePeriodicArray* New()
+  {
+    VTK_STANDARD_NEW_BODY(FixedRangePeriodicArray)
+  }
+
+protected:
+  bool ComputeScalarRange(double* ranges) VTK_OVERRIDE
+  {
+    for (int c = 0; c < this->GetNumberOfComponents(); ++c)
+    {
+      ranges[2 * c] = -c;
+      ranges[2 * c + 1] = c;
+    }
+    return true;
+  }
+
+  bool ComputeVectorRange(double range[2]) VTK_OVERRIDE
+  {
+    range[0] = 0.5;
+    range[1] = 1.5;
+    return true;
+  }
+};
+}
+
 int TestAngularPeriodicDataArray(int, char * [])
 {
   vtkNew<vtkDoubleArray> array;
@@ -99,6 +131,19 @@ int TestAngularPeriodicDataArray(int, char * [])
     return 1;
   }
 
+  vtkNew<FixedRangePeriodicArray> fixedRangeArray;
+  fixedRangeArray->InitializeArray(array.Get());
+  fixedRangeArray->GetRange(range, 2);
+  fixedRangeArray->GetRange(range + 2, -1);
+  if (range[0] != -2. || range[1] != 2. ||
+      range[2] != 0.5 || range[3] != 1.5)
+  {
+    cerr << "Error in vtkAngularPeriodicDataArray : " << endl
+         << "Overridden ranges are not used : " << range[0] << " "
+         << range[1] << " " << range[2] << " " << range[3] << endl;
+    return 1;
+  }
+
   vtkNew<vtkDoubleArray> tensorArray;
   vtkNew<vtkAngularPeriodicDataArray<double> > tensorPArray;
 
@@ -1,6 +1,11 @@
 #include "vtkIntArray.h"
 #include "vtkDoubleArray.h"
+#include "vtkInformation.h"
+#include "vtkMath.h"
 #include "vtkMathUtilities.h"
+#include "vtkShortArray.h"
+
+#include <algorithm>
 
 // Define this to run benchmarking tests on some vtkDataArray methods:
 #undef BENCHMARK
@@ -220,6 +225,63 @@ int TestDataArray(int,char *[])
   }
   cout << endl;
   farray->Delete();
+
+  // The ranges of large arrays are computed in blocks, possibly by several
+  // threads, make sure they are those of the whole array.
+  vtkShortArray* sarray = vtkShortArray::New();
+  sarray->SetNumberOfComponents(3);
+  sarray->SetNumberOfTuples(100000);
+  for ( cc = 0; cc < 100000; ++cc )
+  {
+    sarray->SetTuple3(cc, cc % 1001, -(cc % 997), (cc * 7) % 1013 - 500);
+  }
+  sarray->SetTuple3(77777, 1500, 0, 0);
+  sarray->SetTuple3(50001, 0, -1500, 0);
+  double expected[4][2] = { { 0, 1500 }, { -1500, 0 }, { -500, 512 },
+                            { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN } };
+  for ( cc = 0; cc < 100000; ++cc )
+  {
+    double norm = vtkMath::Norm(sarray->GetTuple3(cc));
+    expected[3][0] = std::min(expected[3][0], norm);
+    expected[3][1] = std::max(expected[3][1], norm);
+  }
+  for ( int comp = -1; comp < 3; ++comp )
+  {
+    sarray->GetRange( range, comp );
+    double *e = expected[comp < 0 ? 3 : comp];
+    if ( range[0] != e[0] || range[1] != e[1] )
+    {
+      cerr
+        << "Getting range of component " << comp << " of a large array "
+        << "failed, min: " << range[0] << " max: " << range[1] << "\n";
+      sarray->Delete();
+      return 1;
+    }
+  }
+
+  // Shallow copies share the cached ranges.
+  vtkShortArray* scopy = vtkShortArray::New();
+  scopy->ShallowCopy(sarray);
+  if ( !scopy->GetInformation()->Has(vtkDataArray::L2_NORM_RANGE()) ||
+       !scopy->GetInformation()->Has(vtkAbstractArray::PER_COMPONENT()) )
+  {
+    cerr << "Shallow copy did not keep the cached ranges.\n";
+    scopy->Delete();
+    sarray->Delete();
+    return 1;
+  }
+  scopy->GetRange( range, 1 );
+  if ( range[0] != -1500 || range[1] != 0 )
+  {
+    cerr
+      << "Getting range of a shallow copy failed, min: "
+      << range[0] << " max: " << range[1] << "\n";
+    scopy->Delete();
+    sarray->Delete();
+    return 1;
+  }
+  scopy->Delete();
+  sarray->Delete();
   return 0;
 }
 
@@ -0,0 +1,196 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataArraySIMD.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the vectorized range and conversion kernels of the data
+// arrays give the same results as the scalar implementations, for every
+// instruction set supported by the processor.
+
+#include "vtkDataArraySIMD.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkSmartPointer.h"
+#include "vtkSOADataArrayTemplate.h"
+
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+namespace
+{
+
+const char *InstructionSetNames[] = { "scalar", "SSE2", "AVX2" };
+
+// The ranges of all components and of the magnitude, regular and finite.
+std::vector<double> GetRanges(vtkDataArray *array)
+{
+  std::vector<double> ranges;
+  double range[2];
+  array->Modified(); // Discard the cached ranges.
+  for (int comp = -1; comp < array->GetNumberOfComponents(); ++comp)
+  {
+    array->GetRange(range, comp);
+    ranges.push_back(range[0]);
+    ranges.push_back(range[1]);
+    array->GetFiniteRange(range, comp);
+    ranges.push_back(range[0]);
+    ranges.push_back(range[1]);
+  }
+  return ranges;
+}
+
+// Fill the array with random values, including NaN and infinite values
+// for floating point arrays.
+void FillArray(vtkDataArray *array, vtkMinimalStandardRandomSequence *random)
+{
+  const bool isFloat = array->GetDataType() == VTK_FLOAT ||
+                       array->GetDataType() == VTK_DOUBLE;
+  const vtkIdType numValues =
+    array->GetNumberOfTuples() * array->GetNumberOfComponents();
+  for (vtkIdType i = 0; i < numValues; ++i)
+  {
+    double value = random->GetRangeValue(-1000.0, 1000.0);
+    random->Next();
+    if (isFloat && i % 97 == 13)
+    {
+      value = std::numeric_limits<double>::quiet_NaN();
+    }
+    else if (isFloat && i % 89 == 7)
+    {
+      value = (i % 2 ? 1.0 : -1.0) * std::numeric_limits<double>::infinity();
+    }
+    array->SetComponent(i / array->GetNumberOfComponents(),
+                        static_cast<int>(i % array->GetNumberOfComponents()),
+                        value);
+  }
+}
+
+int CheckRanges(vtkDataArray *array, const char *name)
+{
+  vtkDataArraySIMD::SetMaximumInstructionSet(vtkDataArraySIMD::SCALAR);
+  std::vector<double> expected = GetRanges(array);
+
+  int errors = 0;
+  for (int is = vtkDataArraySIMD::SSE2; is <= vtkDataArraySIMD::AVX2; ++is)
+  {
+    vtkDataArraySIMD::SetMaximumInstructionSet(is);
+    if (vtkDataArraySIMD::GetInstructionSet() != is)
+    {
+      continue;
+    }
+    std::vector<double> ranges = GetRanges(array);
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+      // Compare NaN values as equal.
+      if (ranges[i] != expected[i] &&
+          (ranges[i] == ranges[i] || expected[i] == expected[i]))
+      {
+        cerr << name << " with " << array->GetNumberOfComponents()
+             << " components and " << array->GetNumberOfTuples()
+             << " tuples, " << InstructionSetNames[is] << " range value "
+             << i << " is " << ranges[i] << " instead of " << expected[i]
+             << "\n";
+        ++errors;
+        break;
+      }
+    }
+  }
+  vtkDataArraySIMD::SetMaximumInstructionSet(vtkDataArraySIMD::AVX2);
+  return errors;
+}
+
+template <typename ArrayT>
+int TestRanges(vtkMinimalStandardRandomSequence *random, const char *name)
+{
+  // Odd sizes exercise the scalar remainder of the kernels. More than
+  // VTK_DATA_ARRAY_SIMD_MAX_COMPONENTS components uses the scalar code.
+  const int numComps[] = { 1, 2, 3, 4, 7, 9 };
+  const vtkIdType numTuples[] = { 1, 5, 1027 };
+  int errors = 0;
+  for (int c = 0; c < 6; ++c)
+  {
+    for (int t = 0; t < 3; ++t)
+    {
+      vtkNew<ArrayT> array;
+      array->SetNumberOfComponents(numComps[c]);
+      array->SetNumberOfTuples(numTuples[t]);
+      FillArray(array.GetPointer(), random);
+      errors += CheckRanges(array.GetPointer(), name);
+    }
+  }
+  return errors;
+}
+
+template <typename SrcArrayT, typename DstArrayT>
+int TestConversion(vtkMinimalStandardRandomSequence *random, const char *name)
+{
+  typedef typename DstArrayT::ValueType DstType;
+
+  vtkNew<SrcArrayT> src;
+  src->SetNumberOfComponents(3);
+  src->SetNumberOfTuples(1029);
+  FillArray(src.GetPointer(), random);
+
+  vtkNew<DstArrayT> dst;
+  dst->DeepCopy(src.GetPointer());
+  for (vtkIdType i = 0; i < src->GetNumberOfValues(); ++i)
+  {
+    DstType expected = static_cast<DstType>(src->GetValue(i));
+    DstType value = dst->GetValue(i);
+    // Compare NaN values as equal.
+    if (value != expected && (value == value || expected == expected))
+    {
+      cerr << name << " conversion of value " << i << " gives " << value
+           << " instead of " << expected << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+
+} // end anon namespace
+
+int TestDataArraySIMD(int, char *[])
+{
+  cout << "Instruction set: "
+       << InstructionSetNames[vtkDataArraySIMD::GetInstructionSet()] << "\n";
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+
+  int errors = 0;
+  errors += TestRanges<vtkFloatArray>(random.GetPointer(), "vtkFloatArray");
+  errors += TestRanges<vtkDoubleArray>(random.GetPointer(), "vtkDoubleArray");
+  errors += TestRanges<vtkIntArray>(random.GetPointer(), "vtkIntArray");
+  errors += TestRanges<vtkSOADataArrayTemplate<float> >(
+    random.GetPointer(), "vtkSOADataArrayTemplate<float>");
+  errors += TestRanges<vtkSOADataArrayTemplate<double> >(
+    random.GetPointer(), "vtkSOADataArrayTemplate<double>");
+
+  errors += TestConversion<vtkFloatArray, vtkDoubleArray>(
+    random.GetPointer(), "float to double");
+  errors += TestConversion<vtkDoubleArray, vtkFloatArray>(
+    random.GetPointer(), "double to float");
+  errors += TestConversion<vtkIntArray, vtkFloatArray>(
+    random.GetPointer(), "int to float");
+  errors += TestConversion<vtkIntArray, vtkDoubleArray>(
+    random.GetPointer(), "int to double");
+  errors += TestConversion<vtkSOADataArrayTemplate<float>,
+                           vtkSOADataArrayTemplate<double> >(
+    random.GetPointer(), "SOA float to double");
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -18,7 +18,10 @@
 #include "vtkObjectFactory.h"
 #include "vtkSMPTools.h"
 #include "vtkSMPThreadLocalObject.h"
+#include <algorithm>
+#include <cstring>
 #include <functional>
+#include <string>
 #include <vector>
 
 static const int Target = 10000;
@@ -91,6 +94,109 @@ public:
 
 };
 
+// Work per index grows with the index so that a static schedule is badly
+// balanced. Every index must still be visited exactly once.
+class IrregularFunctor
+{
+public:
+  std::vector<int> Visits;
+  vtkSMPThreadLocal<double> Sum;
+
+  IrregularFunctor() : Visits(Target, 0), Sum(0.0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double& sum = this->Sum.Local();
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      for (vtkIdType j=0; j<i/10; j++)
+      {
+        sum += 1.0;
+      }
+      this->Visits[i]++;
+    }
+  }
+};
+
+// Runs a parallel loop from within a parallel loop.
+class NestedFunctor
+{
+public:
+  vtkSMPThreadLocal<int> Counter;
+
+  NestedFunctor(): Counter(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      ARangeFunctor inner;
+      vtkSMPTools::For(0, 100, inner);
+      int innerTotal = 0;
+      for (vtkSMPThreadLocal<int>::iterator itr = inner.Counter.begin();
+           itr != inner.Counter.end(); ++itr)
+      {
+        innerTotal += *itr;
+      }
+      this->Counter.Local() += innerTotal;
+    }
+  }
+};
+
+// Checks that loop bodies see a parallel scope and that, unless nested
+// parallelism is enabled, inner loops run in the calling thread.
+class ScopeFunctor
+{
+public:
+  vtkSMPThreadLocal<int> Errors;
+
+  ScopeFunctor(): Errors(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      if (!vtkSMPTools::IsParallelScope())
+      {
+        this->Errors.Local()++;
+      }
+      ARangeFunctor inner;
+      vtkSMPTools::For(0, 1000, 10, inner);
+      if (inner.Counter.size() != 1 || *inner.Counter.begin() != 1000)
+      {
+        this->Errors.Local()++;
+      }
+    }
+  }
+};
+
+// Records the largest number of threads that the loop bodies may use.
+class ThreadLimitFunctor
+{
+public:
+  vtkSMPThreadLocal<int> MaxThreads;
+
+  ThreadLimitFunctor(): MaxThreads(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    int& maxThreads = this->MaxThreads.Local();
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      maxThreads = std::max(maxThreads,
+                            vtkSMPTools::GetEstimatedNumberOfThreads());
+    }
+  }
+};
+
 // For sorting comparison
 bool myComp (double a, double b) { return (a<b); }
 
@@ -140,6 +246,89 @@ int TestSMP(int, char*[])
     return 1;
   }
 
+  IrregularFunctor functor3;
+
+  vtkSMPTools::For(0, Target, 10, functor3);
+
+  double expectedSum = 0.0;
+  for (int i=0; i<Target; i++)
+  {
+    if (functor3.Visits[i] != 1)
+    {
+      cerr << "Error: IrregularFunctor visited " << i << " "
+           << functor3.Visits[i] << " times" << endl;
+      return 1;
+    }
+    expectedSum += i/10;
+  }
+  double sum = 0.0;
+  for (vtkSMPThreadLocal<double>::iterator itr3 = functor3.Sum.begin();
+       itr3 != functor3.Sum.end(); ++itr3)
+  {
+    sum += *itr3;
+  }
+  if (sum != expectedSum)
+  {
+    cerr << "Error: IrregularFunctor did not generate " << expectedSum << endl;
+    return 1;
+  }
+
+  NestedFunctor functor4;
+
+  vtkSMPTools::For(0, 100, 1, functor4);
+
+  total = 0;
+  for (vtkSMPThreadLocal<int>::iterator itr4 = functor4.Counter.begin();
+       itr4 != functor4.Counter.end(); ++itr4)
+  {
+    total += *itr4;
+  }
+  if (total != 100 * 100)
+  {
+    cerr << "Error: NestedFunctor did not generate " << 100 * 100 << endl;
+    return 1;
+  }
+
+  vtkSMPTools::SetNestedParallelism(true);
+  NestedFunctor functor6;
+  vtkSMPTools::For(0, 100, 1, functor6);
+  vtkSMPTools::SetNestedParallelism(false);
+
+  total = 0;
+  for (vtkSMPThreadLocal<int>::iterator itr6 = functor6.Counter.begin();
+       itr6 != functor6.Counter.end(); ++itr6)
+  {
+    total += *itr6;
+  }
+  if (total != 100 * 100)
+  {
+    cerr << "Error: NestedFunctor with nested parallelism did not generate "
+         << 100 * 100 << endl;
+    return 1;
+  }
+
+  if (vtkSMPTools::IsParallelScope())
+  {
+    cerr << "Error: Parallel scope reported outside of a parallel loop!" << endl;
+    return 1;
+  }
+  ScopeFunctor functor7;
+  vtkSMPTools::For(0, 100, 1, functor7);
+  for (vtkSMPThreadLocal<int>::iterator itr7 = functor7.Errors.begin();
+       itr7 != functor7.Errors.end(); ++itr7)
+  {
+    if (*itr7 != 0)
+    {
+      cerr << "Error: Nested loop was not run sequentially!" << endl;
+      return 1;
+    }
+  }
+  if (vtkSMPTools::IsParallelScope())
+  {
+    cerr << "Error: Parallel scope was not closed!" << endl;
+    return 1;
+  }
+
   // Test sorting
   double data0[] = {2,1,0,3,9,6,7,3,8,4,5};
   std::vector<double> myvector (data0, data0+11);
@@ -167,5 +356,61 @@ int TestSMP(int, char*[])
     }
   }
 
+  // Test runtime backend selection and scoped thread limits
+  std::string defaultBackend = vtkSMPTools::GetBackend();
+  if (vtkSMPTools::SetBackend("NotABackend") ||
+      defaultBackend != vtkSMPTools::GetBackend())
+  {
+    cerr << "Error: Unknown backend was accepted!" << endl;
+    return 1;
+  }
+  {
+    vtkSMPTools::LocalScope scope(vtkSMPTools::Config(2));
+    if (vtkSMPTools::GetEstimatedNumberOfThreads() > 2)
+    {
+      cerr << "Error: LocalScope did not limit the number of threads!" << endl;
+      return 1;
+    }
+    ThreadLimitFunctor functor8;
+    vtkSMPTools::For(0, 1000, 1, functor8);
+    for (vtkSMPThreadLocal<int>::iterator itr8 = functor8.MaxThreads.begin();
+         itr8 != functor8.MaxThreads.end(); ++itr8)
+    {
+      if (*itr8 > 2)
+      {
+        cerr << "Error: LocalScope did not reach the worker threads!" << endl;
+        return 1;
+      }
+    }
+    {
+      vtkSMPTools::LocalScope inner(vtkSMPTools::Config(std::string("Sequential")));
+      if (vtkSMPTools::GetEstimatedNumberOfThreads() != 1 ||
+          strcmp(vtkSMPTools::GetBackend(), "Sequential") != 0)
+      {
+        cerr << "Error: LocalScope did not select the Sequential backend!" << endl;
+        return 1;
+      }
+      ARangeFunctor functor5;
+      vtkSMPTools::For(0, Target, functor5);
+      if (functor5.Counter.size() != 1 || *functor5.Counter.begin() != Target)
+      {
+        cerr << "Error: Sequential backend did not generate " << Target << endl;
+        return 1;
+      }
+    }
+    if (defaultBackend != vtkSMPTools::GetBackend())
+    {
+      cerr << "Error: LocalScope did not restore the backend!" << endl;
+      return 1;
+    }
+  }
+  if (!vtkSMPTools::SetBackend("Sequential") ||
+      vtkSMPTools::GetEstimatedNumberOfThreads() != 1 ||
+      !vtkSMPTools::SetBackend(defaultBackend.c_str()))
+  {
+    cerr << "Error: Could not switch backends at runtime!" << endl;
+    return 1;
+  }
+
   return 0;
 }
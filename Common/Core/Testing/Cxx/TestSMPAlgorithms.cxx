@@ -0,0 +1,214 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPAlgorithms.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the vtkSMPTools algorithms (Transform, Fill, Reduce, ExclusiveScan
+// and Sort) against their sequential std:: equivalents.
+
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct Square
+{
+  double operator()(double x) const
+  {
+    return x * x;
+  }
+};
+
+struct GreaterAbs
+{
+  bool operator()(int a, int b) const
+  {
+    return std::abs(a) > std::abs(b);
+  }
+};
+
+struct MaxOp
+{
+  int operator()(int a, int b) const
+  {
+    return a > b ? a : b;
+  }
+};
+
+int TestAlgorithms(vtkIdType size)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+
+  std::vector<int> ints(size);
+  std::vector<double> doubles(size);
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    ints[i] = static_cast<int>(random->GetRangeValue(-1000000, 1000000));
+    doubles[i] = random->GetRangeValue(-1.0, 1.0);
+    random->Next();
+  }
+
+  // Transform
+  std::vector<double> squares(size);
+  vtkSMPTools::Transform(doubles.begin(), doubles.end(), squares.begin(),
+                         Square());
+  std::vector<double> sums(size);
+  vtkSMPTools::Transform(doubles.begin(), doubles.end(), squares.begin(),
+                         sums.begin(), std::plus<double>());
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    if (squares[i] != doubles[i] * doubles[i] ||
+        sums[i] != doubles[i] + squares[i])
+    {
+      cerr << "Error: Transform failed at " << i << endl;
+      return 1;
+    }
+  }
+
+  // Fill
+  std::vector<vtkIdType> filled(size, 0);
+  vtkSMPTools::Fill(filled.begin(), filled.end(), vtkIdType(7));
+  if (std::count(filled.begin(), filled.end(), 7) != size)
+  {
+    cerr << "Error: Fill failed" << endl;
+    return 1;
+  }
+
+  // Reduce
+  long long expected = 0;
+  int expectedMax = -1000001;
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    expected += ints[i];
+    expectedMax = std::max(expectedMax, ints[i]);
+  }
+  if (vtkSMPTools::Reduce(ints.begin(), ints.end(), 0LL) != expected ||
+      vtkSMPTools::Reduce(ints.begin(), ints.end(), -1000001, MaxOp()) !=
+        expectedMax)
+  {
+    cerr << "Error: Reduce failed" << endl;
+    return 1;
+  }
+
+  // ExclusiveScan, out of place and in place
+  std::vector<vtkIdType> counts(size);
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    counts[i] = i % 5;
+  }
+  std::vector<vtkIdType> offsets(size);
+  vtkIdType total = vtkSMPTools::ExclusiveScan(counts.begin(), counts.end(),
+                                               offsets.begin(), vtkIdType(3));
+  vtkIdType running = 3;
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    if (offsets[i] != running)
+    {
+      cerr << "Error: ExclusiveScan failed at " << i << endl;
+      return 1;
+    }
+    running += counts[i];
+  }
+  if (total != running)
+  {
+    cerr << "Error: ExclusiveScan returned " << total << " instead of "
+         << running << endl;
+    return 1;
+  }
+  vtkSMPTools::ExclusiveScan(counts.begin(), counts.end(), counts.begin(),
+                             vtkIdType(3));
+  if (counts != offsets)
+  {
+    cerr << "Error: In place ExclusiveScan failed" << endl;
+    return 1;
+  }
+
+  // Sort, with and without a comparison
+  std::vector<int> sorted(ints);
+  std::vector<int> reference(ints);
+  vtkSMPTools::Sort(sorted.begin(), sorted.end());
+  std::sort(reference.begin(), reference.end());
+  if (sorted != reference)
+  {
+    cerr << "Error: Sort failed" << endl;
+    return 1;
+  }
+  sorted = ints;
+  vtkSMPTools::Sort(sorted.data(), sorted.data() + size, GreaterAbs());
+  for (vtkIdType i = 1; i < size; ++i)
+  {
+    if (GreaterAbs()(sorted[i], sorted[i - 1]))
+    {
+      cerr << "Error: Sort with comparison failed at " << i << endl;
+      return 1;
+    }
+  }
+  std::sort(sorted.begin(), sorted.end());
+  if (sorted != reference)
+  {
+    cerr << "Error: Sort with comparison lost values" << endl;
+    return 1;
+  }
+
+  // Sort values that are moved, not copied, by the merge passes
+  std::vector<std::string> strings(size);
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    strings[i] = std::to_string(ints[i]);
+  }
+  std::vector<std::string> sortedStrings(strings);
+  vtkSMPTools::Sort(sortedStrings.begin(), sortedStrings.end());
+  std::sort(strings.begin(), strings.end());
+  if (sortedStrings != strings)
+  {
+    cerr << "Error: Sort of strings failed" << endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+}
+
+int TestSMPAlgorithms(int, char*[])
+{
+  // Use several threads even on small machines so that the parallel code
+  // paths, such as the merge passes of Sort(), are exercised.
+  vtkSMPTools::Initialize(4);
+
+  const vtkIdType sizes[] = { 0, 1, 17, 10000, 100003 };
+  const char* backends[] = { vtkSMPTools::GetBackend(), "Sequential" };
+  for (int b = 0; b < 2; ++b)
+  {
+    vtkSMPTools::LocalScope scope(vtkSMPTools::Config(std::string(backends[b])));
+    for (int s = 0; s < 5; ++s)
+    {
+      if (TestAlgorithms(sizes[s]))
+      {
+        cerr << "Failed with " << sizes[s] << " values using the "
+             << vtkSMPTools::GetBackend() << " backend." << endl;
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
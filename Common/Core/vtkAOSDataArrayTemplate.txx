@@ -285,6 +285,7 @@ void vtkAOSDataArrayTemplate<ValueTypeT>::ShallowCopy(vtkDataArray *other)
       this->Buffer->Register(nullptr);
     }
     this->DataChanged();
+    this->CopyRangeCache(o);
   }
   else
   {
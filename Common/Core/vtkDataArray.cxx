@@ -18,6 +18,7 @@
 #include "vtkDataArray.h"
 #include "vtkDataArrayAccessor.h"
 #include "vtkDataArrayPrivate.txx"
+#include "vtkDataArraySIMD.h"
 #include "vtkBitArray.h"
 #include "vtkCharArray.h"
 #include "vtkDoubleArray.h"
@@ -34,6 +35,8 @@
 #include "vtkLookupTable.h"
 #include "vtkLongArray.h"
 #include "vtkMath.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSOADataArrayTemplate.h" // For fast paths
 #include "vtkShortArray.h"
 #include "vtkSignedCharArray.h"
@@ -44,6 +47,8 @@
 #include "vtkUnsignedShortArray.h"
 
 #include <algorithm> // for min(), max()
+#include <cmath> // for sqrt()
+#include <vector>
 
 namespace {
 
@@ -64,7 +69,7 @@ struct DeepCopyWorker
                   vtkSOADataArrayTemplate<ValueType> *dst)
   {
     vtkIdType numTuples = src->GetNumberOfTuples();
-    for (int comp; comp < src->GetNumberOfComponents(); ++comp)
+    for (int comp = 0; comp < src->GetNumberOfComponents(); ++comp)
     {
       ValueType *srcBegin = src->GetComponentArrayPointer(comp);
       ValueType *srcEnd = srcBegin + numTuples;
@@ -74,6 +79,46 @@ struct DeepCopyWorker
     }
   }
 
+  // AoS --> AoS type conversion, vectorized for the common conversions
+  // between float, double and int:
+  template <typename SrcValueType, typename DstValueType>
+  void operator()(vtkAOSDataArrayTemplate<SrcValueType> *src,
+                  vtkAOSDataArrayTemplate<DstValueType> *dst)
+  {
+    if (!vtkDataArraySIMD::ConvertValues(src->Begin(), dst->Begin(),
+                                         src->GetNumberOfValues()))
+    {
+      this->Convert(src->Begin(), src->End(), dst->Begin());
+    }
+  }
+
+  // SoA --> SoA type conversion:
+  template <typename SrcValueType, typename DstValueType>
+  void operator()(vtkSOADataArrayTemplate<SrcValueType> *src,
+                  vtkSOADataArrayTemplate<DstValueType> *dst)
+  {
+    vtkIdType numTuples = src->GetNumberOfTuples();
+    for (int comp = 0; comp < src->GetNumberOfComponents(); ++comp)
+    {
+      SrcValueType *srcBegin = src->GetComponentArrayPointer(comp);
+      DstValueType *dstBegin = dst->GetComponentArrayPointer(comp);
+      if (!vtkDataArraySIMD::ConvertValues(srcBegin, dstBegin, numTuples))
+      {
+        this->Convert(srcBegin, srcBegin + numTuples, dstBegin);
+      }
+    }
+  }
+
+  template <typename SrcValueType, typename DstValueType>
+  void Convert(const SrcValueType *srcBegin, const SrcValueType *srcEnd,
+               DstValueType *dstBegin)
+  {
+    for (; srcBegin != srcEnd; ++srcBegin, ++dstBegin)
+    {
+      *dstBegin = static_cast<DstValueType>(*srcBegin);
+    }
+  }
+
   // Generic implementation:
   template <typename Array1T, typename Array2T>
   void operator()(Array1T *src, Array2T *dst)
@@ -357,6 +402,22 @@ bool hasValidKey(InfoType info, KeyType key, ComponentKeyType ckey, double range
   return false;
 }
 
+// Cache the ranges of all the components of an array under key.
+void SetComponentRanges(vtkInformation *info,
+                        vtkInformationInformationVectorKey *key,
+                        const double *ranges, int numComps)
+{
+  vtkInformationVector* infoVec = vtkInformationVector::New();
+  info->Set(key, infoVec);
+  infoVec->SetNumberOfInformationObjects(numComps);
+  for (int i = 0; i < numComps; ++i)
+  {
+    infoVec->GetInformationObject(i)->Set(vtkDataArray::COMPONENT_RANGE(),
+                                          ranges + (i * 2), 2);
+  }
+  infoVec->FastDelete();
+}
+
 } // end anon namespace
 
 vtkInformationKeyRestrictedMacro(vtkDataArray, COMPONENT_RANGE, DoubleVector, 2);
@@ -1469,8 +1530,6 @@ int vtkDataArray::CopyInformation(vtkInformation* infoFrom, int deep)
 //----------------------------------------------------------------------------
 void vtkDataArray::ComputeFiniteRange(double range[2], int comp)
 {
-  //this method needs a large refactoring to be way easier to read
-
   if ( comp >= this->NumberOfComponents )
   { // Ignore requests for nonexistent components.
     return;
@@ -1485,57 +1544,51 @@ void vtkDataArray::ComputeFiniteRange(double range[2], int comp)
   range[1] = vtkTypeTraits<double>::Min();
 
   vtkInformation* info = this->GetInformation();
-  vtkInformationDoubleVectorKey* rkey;
-  if ( comp < 0 )
+  //hasValidKey will update range to the cached value if it exists.
+  if (comp < 0 ? hasValidKey(info, L2_NORM_FINITE_RANGE(), range) :
+      hasValidKey(info, PER_FINITE_COMPONENT(), COMPONENT_RANGE(), range,
+                  comp))
   {
-    rkey = L2_NORM_FINITE_RANGE();
-    //hasValidKey will update range to the cached value if it exists.
-    if( !hasValidKey(info,rkey,range) )
-    {
-
-      this->ComputeFiniteVectorRange(range);
-      info->Set( rkey, range, 2 );
-    }
     return;
   }
-  else
-  {
-    rkey = COMPONENT_RANGE();
 
-    //hasValidKey will update range to the cached value if it exists.
-    if(!hasValidKey(info, PER_FINITE_COMPONENT(), rkey, range, comp))
-    {
-      double* allCompRanges = new double[this->NumberOfComponents*2];
-      const bool computed = this->ComputeFiniteScalarRange(allCompRanges);
-      if(computed)
-      {
-        //construct the keys and add them to the info object
-        vtkInformationVector* infoVec = vtkInformationVector::New();
-        info->Set(PER_FINITE_COMPONENT(), infoVec);
+  // Compute the ranges of all the components and the range of the magnitude
+  // in the same pass, and cache those that are missing.
+  const bool needComponents =
+    this->NumberOfComponents > 0 && !info->Has(PER_FINITE_COMPONENT());
+  const bool needVector = comp < 0 ||
+    (this->NumberOfComponents > 1 && !info->Has(L2_NORM_FINITE_RANGE()));
+  std::vector<double> allCompRanges(2 * this->NumberOfComponents);
+  double vectorRange[2];
+  const bool computed = this->ComputeFiniteScalarAndVectorRange(
+    needComponents ? &allCompRanges[0] : nullptr,
+    needVector ? vectorRange : nullptr);
 
-        infoVec->SetNumberOfInformationObjects( this->NumberOfComponents );
-        for ( int i = 0; i < this->NumberOfComponents; ++i )
-        {
-          infoVec->GetInformationObject( i )->Set( rkey,
-                                                   allCompRanges+(i*2),
-                                                   2 );
-        }
-        infoVec->FastDelete();
+  if (needVector)
+  {
+    info->Set(L2_NORM_FINITE_RANGE(), vectorRange, 2);
+  }
+  if (needComponents && computed)
+  {
+    SetComponentRanges(info, PER_FINITE_COMPONENT(), &allCompRanges[0],
+                       this->NumberOfComponents);
+  }
 
-        //update the range passed in since we have a valid range.
-        range[0] = allCompRanges[comp*2];
-        range[1] = allCompRanges[(comp*2)+1];
-      }
-      delete[] allCompRanges;
-    }
+  if (comp < 0)
+  {
+    range[0] = vectorRange[0];
+    range[1] = vectorRange[1];
+  }
+  else if (computed)
+  {
+    range[0] = allCompRanges[comp * 2];
+    range[1] = allCompRanges[comp * 2 + 1];
   }
 }
 
 //----------------------------------------------------------------------------
 void vtkDataArray::ComputeRange(double range[2], int comp)
 {
-  //this method needs a large refactoring to be way easier to read
-
   if (comp >= this->NumberOfComponents)
   { // Ignore requests for nonexistent components.
     return;
@@ -1550,48 +1603,44 @@ void vtkDataArray::ComputeRange(double range[2], int comp)
   range[1] = vtkTypeTraits<double>::Min();
 
   vtkInformation* info = this->GetInformation();
-  vtkInformationDoubleVectorKey* rkey;
-  if (comp < 0)
+  // hasValidKey will update range to the cached value if it exists.
+  if (comp < 0 ? hasValidKey(info, L2_NORM_RANGE(), range) :
+      hasValidKey(info, PER_COMPONENT(), COMPONENT_RANGE(), range, comp))
   {
-    rkey = L2_NORM_RANGE();
-    // hasValidKey will update range to the cached value if it exists.
-    if (!hasValidKey(info, rkey, range))
-    {
-      this->ComputeVectorRange(range);
-      info->Set(rkey, range, 2);
-    }
     return;
   }
-  else
-  {
-    rkey = COMPONENT_RANGE();
 
-    // hasValidKey will update range to the cached value if it exists.
-    if (!hasValidKey(info, PER_COMPONENT(), rkey, range, comp))
-    {
-      double* allCompRanges = new double[this->NumberOfComponents*2];
-      const bool computed = this->ComputeScalarRange(allCompRanges);
-      if (computed)
-      {
-        // construct the keys and add them to the info object
-        vtkInformationVector* infoVec = vtkInformationVector::New();
-        info->Set(PER_COMPONENT(), infoVec);
+  // Compute the ranges of all the components and the range of the magnitude
+  // in the same pass, and cache those that are missing.
+  const bool needComponents =
+    this->NumberOfComponents > 0 && !info->Has(PER_COMPONENT());
+  const bool needVector = comp < 0 ||
+    (this->NumberOfComponents > 1 && !info->Has(L2_NORM_RANGE()));
+  std::vector<double> allCompRanges(2 * this->NumberOfComponents);
+  double vectorRange[2];
+  const bool computed = this->ComputeScalarAndVectorRange(
+    needComponents ? &allCompRanges[0] : nullptr,
+    needVector ? vectorRange : nullptr);
 
-        infoVec->SetNumberOfInformationObjects(this->NumberOfComponents);
-        for (int i = 0; i < this->NumberOfComponents; ++i)
-        {
-          infoVec->GetInformationObject(i)->Set( rkey,
-                                                 allCompRanges+(i*2),
-                                                 2 );
-        }
-        infoVec->FastDelete();
+  if (needVector)
+  {
+    info->Set(L2_NORM_RANGE(), vectorRange, 2);
+  }
+  if (needComponents && computed)
+  {
+    SetComponentRanges(info, PER_COMPONENT(), &allCompRanges[0],
+                       this->NumberOfComponents);
+  }
 
-        // update the range passed in since we have a valid range.
-        range[0] = allCompRanges[comp*2];
-        range[1] = allCompRanges[(comp*2)+1];
-      }
-      delete[] allCompRanges;
-    }
+  if (comp < 0)
+  {
+    range[0] = vectorRange[0];
+    range[1] = vectorRange[1];
+  }
+  else if (computed)
+  {
+    range[0] = allCompRanges[comp * 2];
+    range[1] = allCompRanges[comp * 2 + 1];
   }
 }
 
@@ -1609,107 +1658,495 @@ void vtkDataArray::Modified()
 namespace
 {
 
-// Wrap the DoCompute[Scalar|Vector]Range calls for vtkArrayDispatch:
-struct ScalarRangeDispatchWrapper
+// Compute the ranges of the tuples [begin, end) of arrays whose values are
+// contiguous in memory with the vectorized kernels of vtkDataArraySIMD. These
+// return false for the arrays and value types the kernels do not handle, and
+// for empty ranges.
+template <typename ArrayT>
+bool SIMDComputeScalarRange(ArrayT *, vtkIdType, vtkIdType, double *, bool)
 {
-  bool Success;
-  double *Range;
+  return false;
+}
 
-  ScalarRangeDispatchWrapper(double *range) : Success(false), Range(range) {}
+template <typename ValueType>
+bool SIMDComputeScalarRange(vtkAOSDataArrayTemplate<ValueType> *array,
+                            vtkIdType begin, vtkIdType end, double *ranges,
+                            bool finite)
+{
+  const int numComps = array->GetNumberOfComponents();
+  return begin < end &&
+    vtkDataArraySIMD::ComputeScalarRange(array->GetPointer(begin * numComps),
+                                         end - begin, numComps, ranges,
+                                         finite);
+}
 
-  template <typename ArrayT>
-  void operator()(ArrayT *array)
+template <typename ValueType>
+bool SIMDComputeScalarRange(vtkSOADataArrayTemplate<ValueType> *array,
+                            vtkIdType begin, vtkIdType end, double *ranges,
+                            bool finite)
+{
+  const int numComps = array->GetNumberOfComponents();
+  if (begin >= end)
   {
-    this->Success = vtkDataArrayPrivate::DoComputeScalarRange(array,
-                                                              this->Range);
+    return false;
   }
+  for (int c = 0; c < numComps; ++c)
+  {
+    if (!vtkDataArraySIMD::ComputeScalarRange(
+          array->GetComponentArrayPointer(c) + begin, end - begin, 1,
+          ranges + 2 * c, finite))
+    {
+      return false;
+    }
+    // SOA arrays are not dispatched, the scalar fallback starts from the
+    // double extremes instead of those of ValueType. A range still at the
+    // ValueType extremes is ambiguous, leave it to the scalar code.
+    if (ranges[2 * c] == vtkTypeTraits<ValueType>::Max() ||
+        ranges[2 * c + 1] == vtkTypeTraits<ValueType>::Min())
+    {
+      return false;
+    }
+  }
+  return true;
+}
 
-};
+template <typename ArrayT>
+bool SIMDComputeVectorRange(ArrayT *, vtkIdType, vtkIdType, double *, bool)
+{
+  return false;
+}
 
-struct VectorRangeDispatchWrapper
+template <typename ValueType>
+bool SIMDComputeVectorRange(vtkAOSDataArrayTemplate<ValueType> *array,
+                            vtkIdType begin, vtkIdType end, double range[2],
+                            bool finite)
 {
-  bool Success;
-  double *Range;
+  const int numComps = array->GetNumberOfComponents();
+  if (begin >= end)
+  {
+    return false;
+  }
+  std::vector<const ValueType*> components(numComps);
+  for (int c = 0; c < numComps; ++c)
+  {
+    components[c] = array->GetPointer(begin * numComps + c);
+  }
+  if (!vtkDataArraySIMD::ComputeVectorRange(&components[0], numComps,
+                                            numComps, end - begin, range,
+                                            finite))
+  {
+    return false;
+  }
+  range[0] = sqrt(range[0]);
+  range[1] = sqrt(range[1]);
+  return true;
+}
 
-  VectorRangeDispatchWrapper(double *range) : Success(false), Range(range) {}
+template <typename ValueType>
+bool SIMDComputeVectorRange(vtkSOADataArrayTemplate<ValueType> *array,
+                            vtkIdType begin, vtkIdType end, double range[2],
+                            bool finite)
+{
+  const int numComps = array->GetNumberOfComponents();
+  if (begin >= end)
+  {
+    return false;
+  }
+  std::vector<const ValueType*> components(numComps);
+  for (int c = 0; c < numComps; ++c)
+  {
+    components[c] = array->GetComponentArrayPointer(c) + begin;
+  }
+  if (!vtkDataArraySIMD::ComputeVectorRange(&components[0], 1, numComps,
+                                            end - begin, range, finite))
+  {
+    return false;
+  }
+  range[0] = sqrt(range[0]);
+  range[1] = sqrt(range[1]);
+  return true;
+}
 
-  template <typename ArrayT>
-  void operator()(ArrayT *array)
+// SOA arrays are not dispatched by default, the fallback worker gets them
+// as plain vtkDataArrays.
+template <typename WorkerT>
+bool SIMDExecuteSOA(vtkDataArray *array, WorkerT &worker)
+{
+  if (array->GetArrayType() != vtkAbstractArray::SoADataArrayTemplate)
   {
-    this->Success = vtkDataArrayPrivate::DoComputeVectorRange(array,
-                                                              this->Range);
+    return false;
   }
+  switch (array->GetDataType())
+  {
+    case VTK_FLOAT:
+      return worker(vtkSOADataArrayTemplate<float>::FastDownCast(array));
+    case VTK_DOUBLE:
+      return worker(vtkSOADataArrayTemplate<double>::FastDownCast(array));
+    case VTK_INT:
+      return worker(vtkSOADataArrayTemplate<int>::FastDownCast(array));
+    default:
+      return false;
+  }
+}
 
+struct SIMDScalarRangeWorker
+{
+  vtkIdType Begin;
+  vtkIdType End;
+  double *Range;
+  bool Finite;
+
+  template <typename ArrayT>
+  bool operator()(ArrayT *array)
+  {
+    return SIMDComputeScalarRange(array, this->Begin, this->End, this->Range,
+                                  this->Finite);
+  }
 };
 
-// Wrap the DoCompute[Scalar|Vector]Range calls for vtkArrayDispatch:
-struct FiniteScalarRangeDispatchWrapper {
-  bool Success;
+struct SIMDVectorRangeWorker
+{
+  vtkIdType Begin;
+  vtkIdType End;
   double *Range;
-
-  FiniteScalarRangeDispatchWrapper(double *range) : Success(false), Range(range) {}
+  bool Finite;
 
   template <typename ArrayT>
-  void operator()(ArrayT *array)
+  bool operator()(ArrayT *array)
+  {
+    return SIMDComputeVectorRange(array, this->Begin, this->End, this->Range,
+                                  this->Finite);
+  }
+};
+
+bool SIMDComputeScalarRange(vtkDataArray *array, vtkIdType begin,
+                            vtkIdType end, double *ranges, bool finite)
+{
+  SIMDScalarRangeWorker worker = { begin, end, ranges, finite };
+  return SIMDExecuteSOA(array, worker);
+}
+
+bool SIMDComputeVectorRange(vtkDataArray *array, vtkIdType begin,
+                            vtkIdType end, double *range, bool finite)
+{
+  SIMDVectorRangeWorker worker = { begin, end, range, finite };
+  return SIMDExecuteSOA(array, worker);
+}
+
+//----------------------------------------------------------------------------
+// Compute the ranges of the components and/or the range of the magnitude of
+// the tuples with vtkSMPTools. Each thread walks its tuples in blocks small
+// enough to stay in cache and computes both ranges of a block back to back,
+// so that they come from a single pass over memory. The result is the one
+// of the serial code: each block goes through vtkDataArraySIMD or
+// vtkDataArrayPrivate, and the min/max of the blocks is the min/max of the
+// array.
+template <typename ArrayT>
+class RangeFunctor
+{
+public:
+  // The values processed per block.
+  enum { BlockSize = 16384 };
+
+  RangeFunctor(ArrayT *array, double *ranges, double *vectorRange,
+               bool finite)
+    : Array(array),
+      NumberOfComponents(array->GetNumberOfComponents()),
+      Ranges(ranges),
+      VectorRange(vectorRange),
+      Finite(finite)
+  {
+    this->TuplesPerBlock =
+      std::max<vtkIdType>(1, BlockSize / std::max(this->NumberOfComponents, 1));
+  }
+
+  vtkIdType GetTuplesPerBlock() const { return this->TuplesPerBlock; }
+
+  void Initialize()
   {
-    this->Success = vtkDataArrayPrivate::DoComputeScalarFiniteRange(array,
-                                                              this->Range);
+    // The per-thread ranges, followed by the ranges of the current block.
+    // Component c is at 2*c, the magnitude at 2*NumberOfComponents.
+    std::vector<double> &ranges = this->TLRanges.Local();
+    ranges.resize(4 * (this->NumberOfComponents + 1));
+    for (int i = 0; i <= this->NumberOfComponents; ++i)
+    {
+      ranges[2 * i] = vtkTypeTraits<double>::Max();
+      ranges[2 * i + 1] = vtkTypeTraits<double>::Min();
+    }
   }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::vector<double> &ranges = this->TLRanges.Local();
+    const int numComps = this->NumberOfComponents;
+    double *blockRanges = &ranges[2 * (numComps + 1)];
+    for (vtkIdType blockBegin = begin; blockBegin < end;
+         blockBegin += this->TuplesPerBlock)
+    {
+      const vtkIdType blockEnd =
+        std::min(blockBegin + this->TuplesPerBlock, end);
+      if (this->Ranges)
+      {
+        if (!SIMDComputeScalarRange(this->Array, blockBegin, blockEnd,
+                                    blockRanges, this->Finite))
+        {
+          if (this->Finite)
+          {
+            vtkDataArrayPrivate::DoComputeScalarFiniteRange(
+              this->Array, blockRanges, blockBegin, blockEnd);
+          }
+          else
+          {
+            vtkDataArrayPrivate::DoComputeScalarRange(
+              this->Array, blockRanges, blockBegin, blockEnd);
+          }
+        }
+        this->Merge(&ranges[0], blockRanges, numComps);
+      }
+      if (this->VectorRange)
+      {
+        if (!SIMDComputeVectorRange(this->Array, blockBegin, blockEnd,
+                                    blockRanges, this->Finite))
+        {
+          if (this->Finite)
+          {
+            vtkDataArrayPrivate::DoComputeVectorFiniteRange(
+              this->Array, blockRanges, blockBegin, blockEnd);
+          }
+          else
+          {
+            vtkDataArrayPrivate::DoComputeVectorRange(
+              this->Array, blockRanges, blockBegin, blockEnd);
+          }
+        }
+        this->Merge(&ranges[2 * numComps], blockRanges, 1);
+      }
+    }
+  }
+
+  void Reduce()
+  {
+    const int numComps = this->NumberOfComponents;
+    std::vector<double> result(2 * (numComps + 1));
+    for (int i = 0; i <= numComps; ++i)
+    {
+      result[2 * i] = vtkTypeTraits<double>::Max();
+      result[2 * i + 1] = vtkTypeTraits<double>::Min();
+    }
+    typename vtkSMPThreadLocal<std::vector<double> >::iterator iter;
+    for (iter = this->TLRanges.begin(); iter != this->TLRanges.end(); ++iter)
+    {
+      this->Merge(&result[0], &(*iter)[0], numComps + 1);
+    }
+    if (this->Ranges)
+    {
+      std::copy(result.begin(), result.begin() + 2 * numComps, this->Ranges);
+    }
+    if (this->VectorRange)
+    {
+      this->VectorRange[0] = result[2 * numComps];
+      this->VectorRange[1] = result[2 * numComps + 1];
+    }
+  }
+
+private:
+  static void Merge(double *ranges, const double *other, int numRanges)
+  {
+    for (int i = 0; i < numRanges; ++i)
+    {
+      ranges[2 * i] = std::min(ranges[2 * i], other[2 * i]);
+      ranges[2 * i + 1] = std::max(ranges[2 * i + 1], other[2 * i + 1]);
+    }
+  }
+
+  ArrayT *Array;
+  int NumberOfComponents;
+  vtkIdType TuplesPerBlock;
+  double *Ranges;
+  double *VectorRange;
+  bool Finite;
+  vtkSMPThreadLocal<std::vector<double> > TLRanges;
 };
 
-struct FiniteVectorRangeDispatchWrapper {
+// Wrap the RangeFunctor for vtkArrayDispatch. Ranges and/or VectorRange are
+// computed, the other may be null.
+struct RangeDispatchWrapper
+{
   bool Success;
-  double *Range;
+  double *Ranges;
+  double *VectorRange;
+  bool Finite;
+  bool Threaded;
 
-  FiniteVectorRangeDispatchWrapper(double *range) : Success(false), Range(range) {}
+  RangeDispatchWrapper(double *ranges, double *vectorRange, bool finite)
+    : Success(false), Ranges(ranges), VectorRange(vectorRange), Finite(finite),
+      Threaded(true)
+  {
+  }
 
-  template <typename ArrayT> void operator()(ArrayT *array)
+  template <typename ArrayT>
+  void operator()(ArrayT *array)
   {
-    this->Success = vtkDataArrayPrivate::DoComputeVectorFiniteRange(array,
-                                                              this->Range);
+    const vtkIdType numTuples = array->GetNumberOfTuples();
+    const int numComps = array->GetNumberOfComponents();
+
+    // Same initial ranges as vtkDataArrayPrivate.
+    for (int i = 0; this->Ranges && i < numComps; ++i)
+    {
+      this->Ranges[2 * i] = vtkTypeTraits<double>::Max();
+      this->Ranges[2 * i + 1] = vtkTypeTraits<double>::Min();
+    }
+    if (this->VectorRange)
+    {
+      this->VectorRange[0] = vtkTypeTraits<double>::Max();
+      this->VectorRange[1] = vtkTypeTraits<double>::Min();
+    }
+    if (numTuples == 0)
+    {
+      this->Success = false;
+      return;
+    }
+
+    RangeFunctor<ArrayT> functor(array, this->Ranges, this->VectorRange,
+                                 this->Finite);
+    if (this->Threaded)
+    {
+      // Small arrays are processed by the calling thread.
+      vtkSMPTools::For(0, numTuples, 8 * functor.GetTuplesPerBlock(),
+                       functor);
+    }
+    else
+    {
+      functor.Initialize();
+      functor(0, numTuples);
+      functor.Reduce();
+    }
+    this->Success = true;
   }
 };
 
+bool ComputeRanges(vtkDataArray *array, double *ranges, double *vectorRange,
+                   bool finite)
+{
+  RangeDispatchWrapper worker(ranges, vectorRange, finite);
+  if (!vtkArrayDispatch::Dispatch::Execute(array, worker))
+  {
+    // The generic API of other arrays (implicit, mapped, bit arrays...) is
+    // not known to be thread safe, only SOA arrays are read concurrently.
+    worker.Threaded =
+      (array->GetArrayType() == vtkAbstractArray::SoADataArrayTemplate);
+    worker(array);
+  }
+  return worker.Success;
+}
+
+// The ranges of the AOS and SOA arrays are computed in a single pass. The
+// other arrays go through ComputeScalarRange() and ComputeVectorRange(),
+// which they may override.
+bool HasFusedRanges(vtkDataArray *array)
+{
+  return array->GetArrayType() == vtkAbstractArray::AoSDataArrayTemplate ||
+    array->GetArrayType() == vtkAbstractArray::SoADataArrayTemplate;
+}
+
 } // end anon namespace
 
 //----------------------------------------------------------------------------
 bool vtkDataArray::ComputeScalarRange(double* ranges)
 {
-  ScalarRangeDispatchWrapper worker(ranges);
-  if (!vtkArrayDispatch::Dispatch::Execute(this, worker))
-  {
-    worker(this);
-  }
-  return worker.Success;
+  return ComputeRanges(this, ranges, nullptr, false);
 }
 
 //-----------------------------------------------------------------------------
 bool vtkDataArray::ComputeVectorRange(double range[2])
 {
-  VectorRangeDispatchWrapper worker(range);
-  if (!vtkArrayDispatch::Dispatch::Execute(this, worker))
+  return ComputeRanges(this, nullptr, range, false);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDataArray::ComputeScalarAndVectorRange(double* ranges,
+                                               double range[2])
+{
+  if (HasFusedRanges(this))
   {
-    worker(this);
+    return ComputeRanges(this, ranges, range, false);
   }
-  return worker.Success;
+  bool computed = true;
+  if (ranges)
+  {
+    computed = this->ComputeScalarRange(ranges);
+  }
+  if (range)
+  {
+    computed = this->ComputeVectorRange(range) && computed;
+  }
+  return computed;
 }
 
 //----------------------------------------------------------------------------
-bool vtkDataArray::ComputeFiniteScalarRange(double *ranges) {
-  FiniteScalarRangeDispatchWrapper worker(ranges);
-  if (!vtkArrayDispatch::Dispatch::Execute(this, worker)) {
-    worker(this);
+bool vtkDataArray::ComputeFiniteScalarRange(double *ranges)
+{
+  return ComputeRanges(this, ranges, nullptr, true);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDataArray::ComputeFiniteVectorRange(double range[2])
+{
+  return ComputeRanges(this, nullptr, range, true);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDataArray::ComputeFiniteScalarAndVectorRange(double* ranges,
+                                                     double range[2])
+{
+  if (HasFusedRanges(this))
+  {
+    return ComputeRanges(this, ranges, range, true);
   }
-  return worker.Success;
+  bool computed = true;
+  if (ranges)
+  {
+    computed = this->ComputeFiniteScalarRange(ranges);
+  }
+  if (range)
+  {
+    computed = this->ComputeFiniteVectorRange(range) && computed;
+  }
+  return computed;
 }
 
 //-----------------------------------------------------------------------------
-bool vtkDataArray::ComputeFiniteVectorRange(double range[2]) {
-  FiniteVectorRangeDispatchWrapper worker(range);
-  if (!vtkArrayDispatch::Dispatch::Execute(this, worker)) {
-    worker(this);
+void vtkDataArray::CopyRangeCache(vtkDataArray *other)
+{
+  if (other == this)
+  {
+    return;
+  }
+  vtkInformation *info = this->GetInformation();
+  info->Remove(PER_COMPONENT());
+  info->Remove(PER_FINITE_COMPONENT());
+  info->Remove(L2_NORM_RANGE());
+  info->Remove(L2_NORM_FINITE_RANGE());
+  if (other && other->HasInformation())
+  {
+    vtkInformation *otherInfo = other->GetInformation();
+    if (otherInfo->Has(PER_COMPONENT()))
+    {
+      info->CopyEntry(otherInfo, PER_COMPONENT(), 1);
+    }
+    if (otherInfo->Has(PER_FINITE_COMPONENT()))
+    {
+      info->CopyEntry(otherInfo, PER_FINITE_COMPONENT(), 1);
+    }
+    if (otherInfo->Has(L2_NORM_RANGE()))
+    {
+      info->CopyEntry(otherInfo, L2_NORM_RANGE());
+    }
+    if (otherInfo->Has(L2_NORM_FINITE_RANGE()))
+    {
+      info->CopyEntry(otherInfo, L2_NORM_FINITE_RANGE());
+    }
   }
-  return worker.Success;
 }
 
 //----------------------------------------------------------------------------
@@ -331,7 +331,9 @@ public:
    * of the magnitude (L2 norm) over all components will be provided. The
    * range is computed and then cached, and will not be re-computed on
    * subsequent calls to GetRange() unless the array is modified or the
-   * requested component changes.
+   * requested component changes. The ranges of all the components and of
+   * the magnitude are computed together, with vtkSMPTools, and the cache
+   * is shared by shallow copies of the array.
    * THIS METHOD IS NOT THREAD SAFE.
    */
   void GetRange(double range[2], int comp)
@@ -563,6 +565,28 @@ protected:
   // if you try to compute the range of an array of length zero.
   virtual bool ComputeFiniteVectorRange(double range[2]);
 
+  //@{
+  /**
+   * Computes the range of each component of an array and the range of
+   * the L2 norm of its tuples in a single pass over the values. Either
+   * \a ranges (two times the number of components) or \a range may be
+   * nullptr. AOS and SOA arrays compute them in a single pass; the other
+   * arrays call ComputeScalarRange() and ComputeVectorRange() (or their
+   * finite versions), so that overriding these is enough. Returns false if
+   * you try to compute the ranges of an array of length zero.
+   */
+  virtual bool ComputeScalarAndVectorRange(double* ranges, double range[2]);
+  virtual bool ComputeFiniteScalarAndVectorRange(double* ranges,
+                                                 double range[2]);
+  //@}
+
+  /**
+   * Replace the cached ranges of this array by those of \a other. Used by
+   * ShallowCopy() implementations that share the values of \a other, so
+   * that the ranges are not computed again.
+   */
+  void CopyRangeCache(vtkDataArray *other);
+
   // Construct object with default tuple dimension (number of components) of 1.
   vtkDataArray();
   ~vtkDataArray() VTK_OVERRIDE;
@@ -94,7 +94,8 @@ template <class APIType, int NumComps, int RangeSize>
 struct ComputeScalarRange
 {
   template<class ArrayT>
-  bool operator()(ArrayT *array, double *ranges)
+  bool operator()(ArrayT *array, double *ranges, vtkIdType begin,
+                  vtkIdType end)
   {
     VTK_ASSUME(array->GetNumberOfComponents() == NumComps);
 
@@ -108,8 +109,7 @@ struct ComputeScalarRange
     }
 
     //compute the range for each component of the data array at the same time
-    const vtkIdType numTuples = array->GetNumberOfTuples();
-    for(vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+    for(vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
     {
       for(int compIdx = 0, j = 0; compIdx < NumComps; ++compIdx, j+=2)
       {
@@ -134,7 +134,8 @@ template <class APIType, int NumComps, int RangeSize>
 struct ComputeScalarFiniteRange
 {
   template<class ArrayT>
-  bool operator()(ArrayT *array, double *ranges)
+  bool operator()(ArrayT *array, double *ranges, vtkIdType begin,
+                  vtkIdType end)
   {
     VTK_ASSUME(array->GetNumberOfComponents() == NumComps);
 
@@ -148,8 +149,7 @@ struct ComputeScalarFiniteRange
     }
 
     //compute the range for each component of the data array at the same time
-    const vtkIdType numTuples = array->GetNumberOfTuples();
-    for(vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+    for(vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
     {
       for(int compIdx = 0, j = 0; compIdx < NumComps; ++compIdx, j+=2)
       {
@@ -174,12 +174,12 @@ struct ComputeScalarFiniteRange
 
 //----------------------------------------------------------------------------
 template <typename ArrayT>
-bool DoComputeScalarFiniteRange(ArrayT *array, double *ranges)
+bool DoComputeScalarFiniteRange(ArrayT *array, double *ranges,
+                                vtkIdType begin, vtkIdType end)
 {
   vtkDataArrayAccessor<ArrayT> access(array);
   typedef typename vtkDataArrayAccessor<ArrayT>::APIType APIType;
 
-  const vtkIdType numTuples = array->GetNumberOfTuples();
   const int numComp = array->GetNumberOfComponents();
 
   //setup the initial ranges to be the max,min for double
@@ -190,7 +190,7 @@ bool DoComputeScalarFiniteRange(ArrayT *array, double *ranges)
   }
 
   //do this after we make sure range is max to min
-  if (numTuples == 0)
+  if (begin >= end)
   {
     return false;
   }
@@ -199,39 +199,39 @@ bool DoComputeScalarFiniteRange(ArrayT *array, double *ranges)
   //compiler detect it can perform loop optimizations.
   if (numComp == 1)
   {
-    return ComputeScalarFiniteRange<APIType,1,2>()(array, ranges);
+    return ComputeScalarFiniteRange<APIType,1,2>()(array, ranges, begin, end);
   }
   else if (numComp == 2)
   {
-    return ComputeScalarFiniteRange<APIType,2,4>()(array, ranges);
+    return ComputeScalarFiniteRange<APIType,2,4>()(array, ranges, begin, end);
   }
   else if (numComp == 3)
   {
-    return ComputeScalarFiniteRange<APIType,3,6>()(array, ranges);
+    return ComputeScalarFiniteRange<APIType,3,6>()(array, ranges, begin, end);
   }
   else if (numComp == 4)
   {
-    return ComputeScalarFiniteRange<APIType,4,8>()(array, ranges);
+    return ComputeScalarFiniteRange<APIType,4,8>()(array, ranges, begin, end);
   }
   else if (numComp == 5)
   {
-    return ComputeScalarFiniteRange<APIType,5,10>()(array, ranges);
+    return ComputeScalarFiniteRange<APIType,5,10>()(array, ranges, begin, end);
   }
   else if (numComp == 6)
   {
-    return ComputeScalarFiniteRange<APIType,6,12>()(array, ranges);
+    return ComputeScalarFiniteRange<APIType,6,12>()(array, ranges, begin, end);
   }
   else if (numComp == 7)
   {
-    return ComputeScalarFiniteRange<APIType,7,14>()(array, ranges);
+    return ComputeScalarFiniteRange<APIType,7,14>()(array, ranges, begin, end);
   }
   else if (numComp == 8)
   {
-    return ComputeScalarFiniteRange<APIType,8,16>()(array, ranges);
+    return ComputeScalarFiniteRange<APIType,8,16>()(array, ranges, begin, end);
   }
   else if (numComp == 9)
   {
-    return ComputeScalarFiniteRange<APIType,9,18>()(array, ranges);
+    return ComputeScalarFiniteRange<APIType,9,18>()(array, ranges, begin, end);
   }
   else
   {
@@ -244,7 +244,7 @@ bool DoComputeScalarFiniteRange(ArrayT *array, double *ranges)
     }
 
     //compute the range for each component of the data array at the same time
-    for (vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+    for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
     {
       for(int compIdx = 0, j = 0; compIdx < numComp; ++compIdx, j+=2)
       {
@@ -273,12 +273,12 @@ bool DoComputeScalarFiniteRange(ArrayT *array, double *ranges)
 
 //----------------------------------------------------------------------------
 template <typename ArrayT>
-bool DoComputeScalarRange(ArrayT *array, double *ranges)
+bool DoComputeScalarRange(ArrayT *array, double *ranges,
+                          vtkIdType begin, vtkIdType end)
 {
   vtkDataArrayAccessor<ArrayT> access(array);
   typedef typename vtkDataArrayAccessor<ArrayT>::APIType APIType;
 
-  const vtkIdType numTuples = array->GetNumberOfTuples();
   const int numComp = array->GetNumberOfComponents();
 
   //setup the initial ranges to be the max,min for double
@@ -289,7 +289,7 @@ bool DoComputeScalarRange(ArrayT *array, double *ranges)
   }
 
   //do this after we make sure range is max to min
-  if (numTuples == 0)
+  if (begin >= end)
   {
     return false;
   }
@@ -298,39 +298,39 @@ bool DoComputeScalarRange(ArrayT *array, double *ranges)
   //compiler detect it can perform loop optimizations.
   if (numComp == 1)
   {
-    return ComputeScalarRange<APIType,1,2>()(array, ranges);
+    return ComputeScalarRange<APIType,1,2>()(array, ranges, begin, end);
   }
   else if (numComp == 2)
   {
-    return ComputeScalarRange<APIType,2,4>()(array, ranges);
+    return ComputeScalarRange<APIType,2,4>()(array, ranges, begin, end);
   }
   else if (numComp == 3)
   {
-    return ComputeScalarRange<APIType,3,6>()(array, ranges);
+    return ComputeScalarRange<APIType,3,6>()(array, ranges, begin, end);
   }
   else if (numComp == 4)
   {
-    return ComputeScalarRange<APIType,4,8>()(array, ranges);
+    return ComputeScalarRange<APIType,4,8>()(array, ranges, begin, end);
   }
   else if (numComp == 5)
   {
-    return ComputeScalarRange<APIType,5,10>()(array, ranges);
+    return ComputeScalarRange<APIType,5,10>()(array, ranges, begin, end);
   }
   else if (numComp == 6)
   {
-    return ComputeScalarRange<APIType,6,12>()(array, ranges);
+    return ComputeScalarRange<APIType,6,12>()(array, ranges, begin, end);
   }
   else if (numComp == 7)
   {
-    return ComputeScalarRange<APIType,7,14>()(array, ranges);
+    return ComputeScalarRange<APIType,7,14>()(array, ranges, begin, end);
   }
   else if (numComp == 8)
   {
-    return ComputeScalarRange<APIType,8,16>()(array, ranges);
+    return ComputeScalarRange<APIType,8,16>()(array, ranges, begin, end);
   }
   else if (numComp == 9)
   {
-    return ComputeScalarRange<APIType,9,18>()(array, ranges);
+    return ComputeScalarRange<APIType,9,18>()(array, ranges, begin, end);
   }
   else
   {
@@ -343,7 +343,7 @@ bool DoComputeScalarRange(ArrayT *array, double *ranges)
     }
 
     //compute the range for each component of the data array at the same time
-    for (vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+    for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
     {
       for(int compIdx = 0, j = 0; compIdx < numComp; ++compIdx, j+=2)
       {
@@ -369,24 +369,24 @@ bool DoComputeScalarRange(ArrayT *array, double *ranges)
 
 //----------------------------------------------------------------------------
 template <typename ArrayT>
-bool DoComputeVectorRange(ArrayT *array, double range[2])
+bool DoComputeVectorRange(ArrayT *array, double range[2],
+                          vtkIdType begin, vtkIdType end)
 {
   vtkDataArrayAccessor<ArrayT> access(array);
 
-  const vtkIdType numTuples = array->GetNumberOfTuples();
   const int numComps = array->GetNumberOfComponents();
 
   range[0] = vtkTypeTraits<double>::Max();
   range[1] = vtkTypeTraits<double>::Min();
 
   //do this after we make sure range is max to min
-  if (numTuples == 0)
+  if (begin >= end)
   {
     return false;
   }
 
-  //iterate over all the tuples
-  for (vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+  //iterate over the tuples
+  for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
   {
     double squaredSum = 0.0;
     for (int compIdx = 0; compIdx < numComps; ++compIdx)
@@ -408,24 +408,24 @@ bool DoComputeVectorRange(ArrayT *array, double range[2])
 
 //----------------------------------------------------------------------------
 template <typename ArrayT>
-bool DoComputeVectorFiniteRange(ArrayT *array, double range[2])
+bool DoComputeVectorFiniteRange(ArrayT *array, double range[2],
+                                vtkIdType begin, vtkIdType end)
 {
   vtkDataArrayAccessor<ArrayT> access(array);
 
-  const vtkIdType numTuples = array->GetNumberOfTuples();
   const int numComps = array->GetNumberOfComponents();
 
   range[0] = vtkTypeTraits<double>::Max();
   range[1] = vtkTypeTraits<double>::Min();
 
   //do this after we make sure range is max to min
-  if (numTuples == 0)
+  if (begin >= end)
   {
     return false;
   }
 
-  //iterate over all the tuples
-  for (vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+  //iterate over the tuples
+  for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
   {
     double squaredSum = 0.0;
     for (int compIdx = 0; compIdx < numComps; ++compIdx)
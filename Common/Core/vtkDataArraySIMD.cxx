@@ -0,0 +1,401 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArraySIMD.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDataArraySIMD.h"
+#define VTK_DATA_ARRAY_SIMD_KERNELS vtkDataArraySIMDKernelsSSE2
+#include "vtkDataArraySIMDKernels.txx"
+
+using namespace vtkDataArraySIMDKernelsSSE2;
+
+#include <atomic>
+
+// SSE2 is part of every x86-64 processor, it is used whenever the compiler
+// targets it. VTK_DATA_ARRAY_SIMD_AVX2 is defined by CMake when
+// vtkDataArraySIMDAVX2.cxx could be compiled with the AVX2 flags.
+#if defined(__SSE2__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VTK_DATA_ARRAY_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(VTK_DATA_ARRAY_SIMD_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Whether the processor and the operating system support AVX2.
+bool vtkDataArraySIMDHasAVX2()
+{
+#if defined(VTK_DATA_ARRAY_SIMD_AVX2) && defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+  {
+    return false;
+  }
+  __cpuid(info, 1);
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  const bool avx = (info[2] & (1 << 28)) != 0;
+  if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+  {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#elif defined(VTK_DATA_ARRAY_SIMD_AVX2)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#else
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+int vtkDataArraySIMDDetectInstructionSet()
+{
+  if (vtkDataArraySIMDHasAVX2())
+  {
+    return vtkDataArraySIMD::AVX2;
+  }
+#ifdef VTK_DATA_ARRAY_SIMD_SSE2
+  return vtkDataArraySIMD::SSE2;
+#else
+  return vtkDataArraySIMD::SCALAR;
+#endif
+}
+
+std::atomic<int> vtkDataArraySIMDMaximumInstructionSet(vtkDataArraySIMD::AVX2);
+
+#ifdef VTK_DATA_ARRAY_SIMD_SSE2
+
+//----------------------------------------------------------------------------
+// SSE2 traits of the kernels, see vtkDataArraySIMDKernels.txx.
+struct SSE2Float
+{
+  typedef float ValueType;
+  typedef __m128 V;
+  enum { Width = 4 };
+  static float Highest() { return VTK_FLOAT_MAX; }
+  static float Lowest() { return VTK_FLOAT_MIN; }
+  static V Set1(float x) { return _mm_set1_ps(x); }
+  static V Load(const float *p) { return _mm_loadu_ps(p); }
+  static void Store(float *p, V v) { _mm_storeu_ps(p, v); }
+  static V Min(V v, V acc) { return _mm_min_ps(v, acc); }
+  static V Max(V v, V acc) { return _mm_max_ps(v, acc); }
+  static V Finite(V v) { return _mm_add_ps(v, _mm_sub_ps(v, v)); }
+};
+
+struct SSE2Double
+{
+  typedef double ValueType;
+  typedef __m128d V;
+  enum { Width = 2 };
+  static double Highest() { return VTK_DOUBLE_MAX; }
+  static double Lowest() { return VTK_DOUBLE_MIN; }
+  static V Set1(double x) { return _mm_set1_pd(x); }
+  static V Load(const double *p) { return _mm_loadu_pd(p); }
+  static void Store(double *p, V v) { _mm_storeu_pd(p, v); }
+  static V Min(V v, V acc) { return _mm_min_pd(v, acc); }
+  static V Max(V v, V acc) { return _mm_max_pd(v, acc); }
+  static V Finite(V v) { return _mm_add_pd(v, _mm_sub_pd(v, v)); }
+
+  // Magnitude traits.
+  static V Zero() { return _mm_setzero_pd(); }
+  static V Add(V a, V b) { return _mm_add_pd(a, b); }
+  static V Mul(V a, V b) { return _mm_mul_pd(a, b); }
+  static V Load(const float *p)
+  {
+    return _mm_cvtps_pd(
+      _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+  }
+  static V Load(const int *p)
+  {
+    return _mm_cvtepi32_pd(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+  }
+  template <typename T>
+  static V Load(const T *p, vtkIdType stride)
+  {
+    return _mm_set_pd(static_cast<double>(p[stride]),
+                      static_cast<double>(p[0]));
+  }
+};
+
+struct SSE2Int
+{
+  typedef int ValueType;
+  typedef __m128i V;
+  enum { Width = 4 };
+  static int Highest() { return VTK_INT_MAX; }
+  static int Lowest() { return VTK_INT_MIN; }
+  static V Set1(int x) { return _mm_set1_epi32(x); }
+  static V Load(const int *p)
+  {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  }
+  static void Store(int *p, V v)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+  }
+  // SSE2 has no 32-bit integer min and max, select with a comparison mask.
+  static V Min(V v, V acc)
+  {
+    V mask = _mm_cmplt_epi32(v, acc);
+    return _mm_or_si128(_mm_and_si128(mask, v), _mm_andnot_si128(mask, acc));
+  }
+  static V Max(V v, V acc)
+  {
+    V mask = _mm_cmpgt_epi32(v, acc);
+    return _mm_or_si128(_mm_and_si128(mask, v), _mm_andnot_si128(mask, acc));
+  }
+  static V Finite(V v) { return v; }
+};
+
+struct SSE2FloatToDouble
+{
+  enum { Width = 4 };
+  static void Convert(const float *src, double *dst)
+  {
+    __m128 v = _mm_loadu_ps(src);
+    _mm_storeu_pd(dst, _mm_cvtps_pd(v));
+    _mm_storeu_pd(dst + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+  }
+};
+
+struct SSE2DoubleToFloat
+{
+  enum { Width = 4 };
+  static void Convert(const double *src, float *dst)
+  {
+    __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src));
+    __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src + 2));
+    _mm_storeu_ps(dst, _mm_movelh_ps(lo, hi));
+  }
+};
+
+struct SSE2IntToFloat
+{
+  enum { Width = 4 };
+  static void Convert(const int *src, float *dst)
+  {
+    _mm_storeu_ps(dst, _mm_cvtepi32_ps(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src))));
+  }
+};
+
+struct SSE2IntToDouble
+{
+  enum { Width = 4 };
+  static void Convert(const int *src, double *dst)
+  {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    _mm_storeu_pd(dst, _mm_cvtepi32_pd(v));
+    _mm_storeu_pd(dst + 2, _mm_cvtepi32_pd(_mm_srli_si128(v, 8)));
+  }
+};
+
+template <typename T> struct SSE2RangeTraits;
+template <> struct SSE2RangeTraits<float> { typedef SSE2Float Type; };
+template <> struct SSE2RangeTraits<double> { typedef SSE2Double Type; };
+template <> struct SSE2RangeTraits<int> { typedef SSE2Int Type; };
+
+template <typename SrcType, typename DstType> struct SSE2ConvertTraits;
+template <> struct SSE2ConvertTraits<float, double>
+  { typedef SSE2FloatToDouble Type; };
+template <> struct SSE2ConvertTraits<double, float>
+  { typedef SSE2DoubleToFloat Type; };
+template <> struct SSE2ConvertTraits<int, float>
+  { typedef SSE2IntToFloat Type; };
+template <> struct SSE2ConvertTraits<int, double>
+  { typedef SSE2IntToDouble Type; };
+
+#endif // VTK_DATA_ARRAY_SIMD_SSE2
+
+//----------------------------------------------------------------------------
+template <typename T>
+bool ComputeScalarRangeImpl(const T *values, vtkIdType numTuples,
+                            int numComps, double *ranges, bool finite)
+{
+  if (numComps < 1 || numComps > VTK_DATA_ARRAY_SIMD_MAX_COMPONENTS)
+  {
+    return false;
+  }
+
+  T range[2 * VTK_DATA_ARRAY_SIMD_MAX_COMPONENTS];
+  switch (vtkDataArraySIMD::GetInstructionSet())
+  {
+#ifdef VTK_DATA_ARRAY_SIMD_AVX2
+    case vtkDataArraySIMD::AVX2:
+      vtkDataArraySIMDAVX2::ComputeScalarRange(values, numTuples, numComps,
+                                               range, finite);
+      break;
+#endif
+#ifdef VTK_DATA_ARRAY_SIMD_SSE2
+    case vtkDataArraySIMD::SSE2:
+      vtkDataArraySIMDScalarRange<typename SSE2RangeTraits<T>::Type>(
+        values, numTuples, numComps, range, finite);
+      break;
+#endif
+    default:
+      return false;
+  }
+
+  for (int i = 0; i < 2 * numComps; ++i)
+  {
+    ranges[i] = static_cast<double>(range[i]);
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+bool ComputeVectorRangeImpl(const T *const *components, vtkIdType stride,
+                            int numComps, vtkIdType numTuples,
+                            double range[2], bool finite)
+{
+  switch (vtkDataArraySIMD::GetInstructionSet())
+  {
+#ifdef VTK_DATA_ARRAY_SIMD_AVX2
+    case vtkDataArraySIMD::AVX2:
+      vtkDataArraySIMDAVX2::ComputeVectorRange(components, stride, numComps,
+                                               numTuples, range, finite);
+      return true;
+#endif
+#ifdef VTK_DATA_ARRAY_SIMD_SSE2
+    case vtkDataArraySIMD::SSE2:
+      vtkDataArraySIMDVectorRange<SSE2Double>(components, stride, numComps,
+                                              numTuples, range, finite);
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+//----------------------------------------------------------------------------
+template <typename SrcType, typename DstType>
+bool ConvertValuesImpl(const SrcType *src, DstType *dst, vtkIdType numValues)
+{
+  switch (vtkDataArraySIMD::GetInstructionSet())
+  {
+#ifdef VTK_DATA_ARRAY_SIMD_AVX2
+    case vtkDataArraySIMD::AVX2:
+      vtkDataArraySIMDAVX2::ConvertValues(src, dst, numValues);
+      return true;
+#endif
+#ifdef VTK_DATA_ARRAY_SIMD_SSE2
+    case vtkDataArraySIMD::SSE2:
+      vtkDataArraySIMDConvert<
+        typename SSE2ConvertTraits<SrcType, DstType>::Type>(
+          src, dst, numValues);
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+int vtkDataArraySIMD::GetInstructionSet()
+{
+  static const int supported = vtkDataArraySIMDDetectInstructionSet();
+  const int maximum = vtkDataArraySIMDMaximumInstructionSet.load();
+  return supported < maximum ? supported : maximum;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArraySIMD::SetMaximumInstructionSet(int instructionSet)
+{
+  vtkDataArraySIMDMaximumInstructionSet.store(instructionSet);
+}
+
+//----------------------------------------------------------------------------
+int vtkDataArraySIMD::GetMaximumInstructionSet()
+{
+  return vtkDataArraySIMDMaximumInstructionSet.load();
+}
+
+//----------------------------------------------------------------------------
+bool vtkDataArraySIMD::ComputeScalarRange(const float *values,
+  vtkIdType numTuples, int numComps, double *ranges, bool finite)
+{
+  return ComputeScalarRangeImpl(values, numTuples, numComps, ranges, finite);
+}
+
+bool vtkDataArraySIMD::ComputeScalarRange(const double *values,
+  vtkIdType numTuples, int numComps, double *ranges, bool finite)
+{
+  return ComputeScalarRangeImpl(values, numTuples, numComps, ranges, finite);
+}
+
+bool vtkDataArraySIMD::ComputeScalarRange(const int *values,
+  vtkIdType numTuples, int numComps, double *ranges, bool finite)
+{
+  return ComputeScalarRangeImpl(values, numTuples, numComps, ranges, finite);
+}
+
+//----------------------------------------------------------------------------
+bool vtkDataArraySIMD::ComputeVectorRange(const float *const *components,
+  vtkIdType stride, int numComps, vtkIdType numTuples, double range[2],
+  bool finite)
+{
+  return ComputeVectorRangeImpl(components, stride, numComps, numTuples,
+                                range, finite);
+}
+
+bool vtkDataArraySIMD::ComputeVectorRange(const double *const *components,
+  vtkIdType stride, int numComps, vtkIdType numTuples, double range[2],
+  bool finite)
+{
+  return ComputeVectorRangeImpl(components, stride, numComps, numTuples,
+                                range, finite);
+}
+
+bool vtkDataArraySIMD::ComputeVectorRange(const int *const *components,
+  vtkIdType stride, int numComps, vtkIdType numTuples, double range[2],
+  bool finite)
+{
+  return ComputeVectorRangeImpl(components, stride, numComps, numTuples,
+                                range, finite);
+}
+
+//----------------------------------------------------------------------------
+bool vtkDataArraySIMD::ConvertValues(const float *src, double *dst,
+                                     vtkIdType numValues)
+{
+  return ConvertValuesImpl(src, dst, numValues);
+}
+
+bool vtkDataArraySIMD::ConvertValues(const double *src, float *dst,
+                                     vtkIdType numValues)
+{
+  return ConvertValuesImpl(src, dst, numValues);
+}
+
+bool vtkDataArraySIMD::ConvertValues(const int *src, float *dst,
+                                     vtkIdType numValues)
+{
+  return ConvertValuesImpl(src, dst, numValues);
+}
+
+bool vtkDataArraySIMD::ConvertValues(const int *src, double *dst,
+                                     vtkIdType numValues)
+{
+  return ConvertValuesImpl(src, dst, numValues);
+}
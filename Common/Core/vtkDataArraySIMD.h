@@ -0,0 +1,136 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArraySIMD.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @file   vtkDataArraySIMD.h
+ * Vectorized kernels for the data arrays (private, not wrapped).
+ *
+ * These functions operate on the contiguous memory of
+ * vtkAOSDataArrayTemplate and vtkSOADataArrayTemplate arrays of float,
+ * double and int values. They are used by vtkDataArray to compute ranges
+ * and to convert values during DeepCopy(). The instruction set is chosen
+ * at runtime: AVX2 when both the compiler and the processor support it,
+ * SSE2 on any x86-64 processor. When no instruction set is available, or
+ * for other value types, the functions return false and the caller uses
+ * its scalar implementation.
+ *
+ * The results are identical to the scalar implementations of
+ * vtkDataArray: NaN values are ignored, and the finite variants also
+ * ignore infinite values.
+ */
+
+#ifndef vtkDataArraySIMD_h
+#define vtkDataArraySIMD_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkType.h"
+
+namespace vtkDataArraySIMD
+{
+
+/**
+ * The instruction sets used by the kernels.
+ */
+enum InstructionSets
+{
+  SCALAR = 0,
+  SSE2 = 1,
+  AVX2 = 2
+};
+
+/**
+ * The instruction set the kernels use, which is the best one supported by
+ * the compiler and the processor, limited by SetMaximumInstructionSet().
+ */
+VTKCOMMONCORE_EXPORT int GetInstructionSet();
+
+/**
+ * Limit the instruction set used by the kernels, for instance to SCALAR to
+ * compare against the scalar implementations. The default is AVX2, that is
+ * no limit.
+ */
+VTKCOMMONCORE_EXPORT void SetMaximumInstructionSet(int instructionSet);
+VTKCOMMONCORE_EXPORT int GetMaximumInstructionSet();
+
+//@{
+/**
+ * Compute the range of each component of numTuples tuples of numComps
+ * interleaved components (ranges is min0,max0,min1,max1,...). Use
+ * numComps=1 for each component array of a SOA array. Return false if
+ * the kernels cannot handle the values, in which case ranges is left
+ * untouched.
+ */
+VTKCOMMONCORE_EXPORT bool ComputeScalarRange(const float *values,
+  vtkIdType numTuples, int numComps, double *ranges, bool finite);
+VTKCOMMONCORE_EXPORT bool ComputeScalarRange(const double *values,
+  vtkIdType numTuples, int numComps, double *ranges, bool finite);
+VTKCOMMONCORE_EXPORT bool ComputeScalarRange(const int *values,
+  vtkIdType numTuples, int numComps, double *ranges, bool finite);
+template <typename ValueType>
+bool ComputeScalarRange(const ValueType *, vtkIdType, int, double *, bool)
+{
+  return false;
+}
+//@}
+
+//@{
+/**
+ * Compute the range of the magnitude of numTuples tuples of numComps
+ * components. Component c of tuple t is components[c][t*stride], which
+ * covers both AOS (components[c] = values + c, stride = numComps) and SOA
+ * (stride = 1) layouts. Return false if the kernels cannot handle the
+ * values, in which case range is left untouched.
+ */
+VTKCOMMONCORE_EXPORT bool ComputeVectorRange(const float *const *components,
+  vtkIdType stride, int numComps, vtkIdType numTuples, double range[2],
+  bool finite);
+VTKCOMMONCORE_EXPORT bool ComputeVectorRange(const double *const *components,
+  vtkIdType stride, int numComps, vtkIdType numTuples, double range[2],
+  bool finite);
+VTKCOMMONCORE_EXPORT bool ComputeVectorRange(const int *const *components,
+  vtkIdType stride, int numComps, vtkIdType numTuples, double range[2],
+  bool finite);
+template <typename ValueType>
+bool ComputeVectorRange(const ValueType *const *, vtkIdType, int, vtkIdType,
+  double [2], bool)
+{
+  return false;
+}
+//@}
+
+//@{
+/**
+ * Convert numValues values with static_cast semantics. Return false if
+ * the kernels cannot handle the conversion, in which case nothing is
+ * written.
+ */
+VTKCOMMONCORE_EXPORT bool ConvertValues(const float *src, double *dst,
+                                        vtkIdType numValues);
+VTKCOMMONCORE_EXPORT bool ConvertValues(const double *src, float *dst,
+                                        vtkIdType numValues);
+VTKCOMMONCORE_EXPORT bool ConvertValues(const int *src, float *dst,
+                                        vtkIdType numValues);
+VTKCOMMONCORE_EXPORT bool ConvertValues(const int *src, double *dst,
+                                        vtkIdType numValues);
+template <typename SrcType, typename DstType>
+bool ConvertValues(const SrcType *, DstType *, vtkIdType)
+{
+  return false;
+}
+//@}
+
+} // end namespace vtkDataArraySIMD
+
+#endif
+// VTK-HeaderTest-Exclude: vtkDataArraySIMD.h
@@ -0,0 +1,215 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArraySIMDAVX2.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// The AVX2 kernels of vtkDataArraySIMD. This file is compiled with the AVX2
+// flags, its functions are only called once vtkDataArraySIMD has checked
+// that the processor supports AVX2.
+
+#define VTK_DATA_ARRAY_SIMD_KERNELS vtkDataArraySIMDKernelsAVX2
+#include "vtkDataArraySIMDKernels.txx"
+
+using namespace vtkDataArraySIMDKernelsAVX2;
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// AVX2 traits of the kernels, see vtkDataArraySIMDKernels.txx.
+struct AVX2Float
+{
+  typedef float ValueType;
+  typedef __m256 V;
+  enum { Width = 8 };
+  static float Highest() { return VTK_FLOAT_MAX; }
+  static float Lowest() { return VTK_FLOAT_MIN; }
+  static V Set1(float x) { return _mm256_set1_ps(x); }
+  static V Load(const float *p) { return _mm256_loadu_ps(p); }
+  static void Store(float *p, V v) { _mm256_storeu_ps(p, v); }
+  static V Min(V v, V acc) { return _mm256_min_ps(v, acc); }
+  static V Max(V v, V acc) { return _mm256_max_ps(v, acc); }
+  static V Finite(V v) { return _mm256_add_ps(v, _mm256_sub_ps(v, v)); }
+};
+
+struct AVX2Double
+{
+  typedef double ValueType;
+  typedef __m256d V;
+  enum { Width = 4 };
+  static double Highest() { return VTK_DOUBLE_MAX; }
+  static double Lowest() { return VTK_DOUBLE_MIN; }
+  static V Set1(double x) { return _mm256_set1_pd(x); }
+  static V Load(const double *p) { return _mm256_loadu_pd(p); }
+  static void Store(double *p, V v) { _mm256_storeu_pd(p, v); }
+  static V Min(V v, V acc) { return _mm256_min_pd(v, acc); }
+  static V Max(V v, V acc) { return _mm256_max_pd(v, acc); }
+  static V Finite(V v) { return _mm256_add_pd(v, _mm256_sub_pd(v, v)); }
+
+  // Magnitude traits.
+  static V Zero() { return _mm256_setzero_pd(); }
+  static V Add(V a, V b) { return _mm256_add_pd(a, b); }
+  static V Mul(V a, V b) { return _mm256_mul_pd(a, b); }
+  static V Load(const float *p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+  static V Load(const int *p)
+  {
+    return _mm256_cvtepi32_pd(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+  }
+  template <typename T>
+  static V Load(const T *p, vtkIdType stride)
+  {
+    return _mm256_set_pd(static_cast<double>(p[3 * stride]),
+                         static_cast<double>(p[2 * stride]),
+                         static_cast<double>(p[stride]),
+                         static_cast<double>(p[0]));
+  }
+};
+
+struct AVX2Int
+{
+  typedef int ValueType;
+  typedef __m256i V;
+  enum { Width = 8 };
+  static int Highest() { return VTK_INT_MAX; }
+  static int Lowest() { return VTK_INT_MIN; }
+  static V Set1(int x) { return _mm256_set1_epi32(x); }
+  static V Load(const int *p)
+  {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+  static void Store(int *p, V v)
+  {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+  }
+  static V Min(V v, V acc) { return _mm256_min_epi32(v, acc); }
+  static V Max(V v, V acc) { return _mm256_max_epi32(v, acc); }
+  static V Finite(V v) { return v; }
+};
+
+struct AVX2FloatToDouble
+{
+  enum { Width = 4 };
+  static void Convert(const float *src, double *dst)
+  {
+    _mm256_storeu_pd(dst, _mm256_cvtps_pd(_mm_loadu_ps(src)));
+  }
+};
+
+struct AVX2DoubleToFloat
+{
+  enum { Width = 4 };
+  static void Convert(const double *src, float *dst)
+  {
+    _mm_storeu_ps(dst, _mm256_cvtpd_ps(_mm256_loadu_pd(src)));
+  }
+};
+
+struct AVX2IntToFloat
+{
+  enum { Width = 8 };
+  static void Convert(const int *src, float *dst)
+  {
+    _mm256_storeu_ps(dst, _mm256_cvtepi32_ps(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src))));
+  }
+};
+
+struct AVX2IntToDouble
+{
+  enum { Width = 4 };
+  static void Convert(const int *src, double *dst)
+  {
+    _mm256_storeu_pd(dst, _mm256_cvtepi32_pd(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src))));
+  }
+};
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+void vtkDataArraySIMDAVX2::ComputeScalarRange(const float *values,
+  vtkIdType numTuples, int numComps, float *range, bool finite)
+{
+  vtkDataArraySIMDScalarRange<AVX2Float>(values, numTuples, numComps, range,
+                                         finite);
+}
+
+void vtkDataArraySIMDAVX2::ComputeScalarRange(const double *values,
+  vtkIdType numTuples, int numComps, double *range, bool finite)
+{
+  vtkDataArraySIMDScalarRange<AVX2Double>(values, numTuples, numComps, range,
+                                          finite);
+}
+
+void vtkDataArraySIMDAVX2::ComputeScalarRange(const int *values,
+  vtkIdType numTuples, int numComps, int *range, bool finite)
+{
+  vtkDataArraySIMDScalarRange<AVX2Int>(values, numTuples, numComps, range,
+                                       finite);
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArraySIMDAVX2::ComputeVectorRange(const float *const *components,
+  vtkIdType stride, int numComps, vtkIdType numTuples, double range[2],
+  bool finite)
+{
+  vtkDataArraySIMDVectorRange<AVX2Double>(components, stride, numComps,
+                                          numTuples, range, finite);
+}
+
+void vtkDataArraySIMDAVX2::ComputeVectorRange(const double *const *components,
+  vtkIdType stride, int numComps, vtkIdType numTuples, double range[2],
+  bool finite)
+{
+  vtkDataArraySIMDVectorRange<AVX2Double>(components, stride, numComps,
+                                          numTuples, range, finite);
+}
+
+void vtkDataArraySIMDAVX2::ComputeVectorRange(const int *const *components,
+  vtkIdType stride, int numComps, vtkIdType numTuples, double range[2],
+  bool finite)
+{
+  vtkDataArraySIMDVectorRange<AVX2Double>(components, stride, numComps,
+                                          numTuples, range, finite);
+}
+
+//----------------------------------------------------------------------------
+void vtkDataArraySIMDAVX2::ConvertValues(const float *src, double *dst,
+                                         vtkIdType numValues)
+{
+  vtkDataArraySIMDConvert<AVX2FloatToDouble>(src, dst, numValues);
+}
+
+void vtkDataArraySIMDAVX2::ConvertValues(const double *src, float *dst,
+                                         vtkIdType numValues)
+{
+  vtkDataArraySIMDConvert<AVX2DoubleToFloat>(src, dst, numValues);
+}
+
+void vtkDataArraySIMDAVX2::ConvertValues(const int *src, float *dst,
+                                         vtkIdType numValues)
+{
+  vtkDataArraySIMDConvert<AVX2IntToFloat>(src, dst, numValues);
+}
+
+void vtkDataArraySIMDAVX2::ConvertValues(const int *src, double *dst,
+                                         vtkIdType numValues)
+{
+  vtkDataArraySIMDConvert<AVX2IntToDouble>(src, dst, numValues);
+}
+
+#endif // __AVX2__
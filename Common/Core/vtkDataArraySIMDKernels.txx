@@ -0,0 +1,300 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataArraySIMDKernels.txx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// The kernels of vtkDataArraySIMD, written once against a small traits
+// interface and instantiated for each instruction set. This file is
+// included by translation units compiled with different instruction set
+// flags, so everything it defines has internal linkage and is named after
+// the instruction set: the including file defines
+// VTK_DATA_ARRAY_SIMD_KERNELS, the namespace of its kernels. The kernels
+// must not instantiate inline functions of other headers (which could
+// otherwise be merged with their SSE2 versions by the linker).
+//
+// Range traits, for vectors V of Width values of type ValueType:
+//   Highest(), Lowest()   the initial min and max values
+//   Load(p), Store(p, v)  unaligned loads and stores
+//   Min(v, acc), Max(v, acc)  return acc when v is NaN
+//   Finite(v)             v with infinite values replaced by NaN
+//
+// Magnitude traits, for vectors V of Width doubles:
+//   Zero(), Set1(x), Add(a, b), Mul(a, b), Min, Max, Finite, Store
+//   Load(const T *p)              Width contiguous values, as doubles
+//   Load(const T *p, stride)      Width values stride apart, as doubles
+//
+// Conversion traits: Width, and Convert(src, dst) for Width values.
+
+#ifndef vtkDataArraySIMDKernels_txx
+#define vtkDataArraySIMDKernels_txx
+
+#include "vtkType.h"
+
+// The largest number of interleaved components the range kernel handles.
+#define VTK_DATA_ARRAY_SIMD_MAX_COMPONENTS 8
+
+#ifndef VTK_DATA_ARRAY_SIMD_KERNELS
+#error "Define VTK_DATA_ARRAY_SIMD_KERNELS before including this file."
+#endif
+
+namespace
+{
+namespace VTK_DATA_ARRAY_SIMD_KERNELS
+{
+
+//----------------------------------------------------------------------------
+// Scalar part of the kernels, for the values left over by the vectors.
+template <typename T>
+inline bool vtkDataArraySIMDIsFinite(T x)
+{
+  // x - x is zero for finite values and NaN otherwise.
+  return (x - x) == T(0);
+}
+
+//----------------------------------------------------------------------------
+// Range of each interleaved component. The values are processed in blocks
+// of Width*numComps values, one accumulator per vector of the block: as the
+// block size is a multiple of numComps, lane l of accumulator k always
+// holds component (k*Width + l) % numComps.
+template <typename Traits, bool Finite>
+void vtkDataArraySIMDScalarRange(const typename Traits::ValueType *values,
+                                 vtkIdType numTuples, int numComps,
+                                 typename Traits::ValueType *range)
+{
+  typedef typename Traits::ValueType T;
+  typedef typename Traits::V V;
+  const int width = Traits::Width;
+
+  V mins[VTK_DATA_ARRAY_SIMD_MAX_COMPONENTS];
+  V maxs[VTK_DATA_ARRAY_SIMD_MAX_COMPONENTS];
+  for (int k = 0; k < numComps; ++k)
+  {
+    mins[k] = Traits::Set1(Traits::Highest());
+    maxs[k] = Traits::Set1(Traits::Lowest());
+  }
+
+  const vtkIdType numValues = numTuples * numComps;
+  const vtkIdType blockSize = static_cast<vtkIdType>(width) * numComps;
+  const T *p = values;
+  const T *blockEnd = values + (numValues / blockSize) * blockSize;
+  for (; p != blockEnd; p += blockSize)
+  {
+    for (int k = 0; k < numComps; ++k)
+    {
+      V v = Traits::Load(p + k * width);
+      if (Finite)
+      {
+        v = Traits::Finite(v);
+      }
+      mins[k] = Traits::Min(v, mins[k]);
+      maxs[k] = Traits::Max(v, maxs[k]);
+    }
+  }
+
+  for (int c = 0; c < numComps; ++c)
+  {
+    range[2 * c] = Traits::Highest();
+    range[2 * c + 1] = Traits::Lowest();
+  }
+
+  T laneMins[Traits::Width];
+  T laneMaxs[Traits::Width];
+  for (int k = 0; k < numComps; ++k)
+  {
+    Traits::Store(laneMins, mins[k]);
+    Traits::Store(laneMaxs, maxs[k]);
+    for (int l = 0; l < width; ++l)
+    {
+      int c = (k * width + l) % numComps;
+      range[2 * c] = laneMins[l] < range[2 * c] ? laneMins[l] : range[2 * c];
+      range[2 * c + 1] =
+        laneMaxs[l] > range[2 * c + 1] ? laneMaxs[l] : range[2 * c + 1];
+    }
+  }
+
+  // The remaining values start at a tuple boundary.
+  const T *end = values + numValues;
+  for (int c = 0; p != end; ++p)
+  {
+    T value = *p;
+    if (!Finite || vtkDataArraySIMDIsFinite(value))
+    {
+      range[2 * c] = value < range[2 * c] ? value : range[2 * c];
+      range[2 * c + 1] = value > range[2 * c + 1] ? value : range[2 * c + 1];
+    }
+    c = (c + 1 == numComps ? 0 : c + 1);
+  }
+}
+
+//----------------------------------------------------------------------------
+template <typename Traits>
+void vtkDataArraySIMDScalarRange(const typename Traits::ValueType *values,
+                                 vtkIdType numTuples, int numComps,
+                                 typename Traits::ValueType *range,
+                                 bool finite)
+{
+  if (finite)
+  {
+    vtkDataArraySIMDScalarRange<Traits, true>(values, numTuples, numComps,
+                                              range);
+  }
+  else
+  {
+    vtkDataArraySIMDScalarRange<Traits, false>(values, numTuples, numComps,
+                                               range);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Range of the squared magnitude of the tuples, Width tuples at a time.
+template <typename Traits, typename T, bool Finite, bool Contiguous>
+void vtkDataArraySIMDVectorRange(const T *const *components, vtkIdType stride,
+                                 int numComps, vtkIdType numTuples,
+                                 double range[2])
+{
+  typedef typename Traits::V V;
+  const int width = Traits::Width;
+
+  V mins = Traits::Set1(VTK_DOUBLE_MAX);
+  V maxs = Traits::Set1(VTK_DOUBLE_MIN);
+
+  vtkIdType tupleIdx = 0;
+  for (; tupleIdx + width <= numTuples; tupleIdx += width)
+  {
+    V squaredSum = Traits::Zero();
+    for (int c = 0; c < numComps; ++c)
+    {
+      V v = Contiguous ?
+        Traits::Load(components[c] + tupleIdx) :
+        Traits::Load(components[c] + tupleIdx * stride, stride);
+      squaredSum = Traits::Add(squaredSum, Traits::Mul(v, v));
+    }
+    if (Finite)
+    {
+      squaredSum = Traits::Finite(squaredSum);
+    }
+    mins = Traits::Min(squaredSum, mins);
+    maxs = Traits::Max(squaredSum, maxs);
+  }
+
+  double laneMins[Traits::Width];
+  double laneMaxs[Traits::Width];
+  Traits::Store(laneMins, mins);
+  Traits::Store(laneMaxs, maxs);
+  range[0] = VTK_DOUBLE_MAX;
+  range[1] = VTK_DOUBLE_MIN;
+  for (int l = 0; l < width; ++l)
+  {
+    range[0] = laneMins[l] < range[0] ? laneMins[l] : range[0];
+    range[1] = laneMaxs[l] > range[1] ? laneMaxs[l] : range[1];
+  }
+
+  for (; tupleIdx < numTuples; ++tupleIdx)
+  {
+    double squaredSum = 0.0;
+    for (int c = 0; c < numComps; ++c)
+    {
+      const double t = static_cast<double>(components[c][tupleIdx * stride]);
+      squaredSum += t * t;
+    }
+    if (!Finite || vtkDataArraySIMDIsFinite(squaredSum))
+    {
+      range[0] = squaredSum < range[0] ? squaredSum : range[0];
+      range[1] = squaredSum > range[1] ? squaredSum : range[1];
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+template <typename Traits, typename T>
+void vtkDataArraySIMDVectorRange(const T *const *components, vtkIdType stride,
+                                 int numComps, vtkIdType numTuples,
+                                 double range[2], bool finite)
+{
+  if (finite)
+  {
+    if (stride == 1)
+    {
+      vtkDataArraySIMDVectorRange<Traits, T, true, true>(
+        components, stride, numComps, numTuples, range);
+    }
+    else
+    {
+      vtkDataArraySIMDVectorRange<Traits, T, true, false>(
+        components, stride, numComps, numTuples, range);
+    }
+  }
+  else
+  {
+    if (stride == 1)
+    {
+      vtkDataArraySIMDVectorRange<Traits, T, false, true>(
+        components, stride, numComps, numTuples, range);
+    }
+    else
+    {
+      vtkDataArraySIMDVectorRange<Traits, T, false, false>(
+        components, stride, numComps, numTuples, range);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+template <typename Traits, typename SrcType, typename DstType>
+void vtkDataArraySIMDConvert(const SrcType *src, DstType *dst,
+                             vtkIdType numValues)
+{
+  const int width = Traits::Width;
+  vtkIdType i = 0;
+  for (; i + width <= numValues; i += width)
+  {
+    Traits::Convert(src + i, dst + i);
+  }
+  for (; i < numValues; ++i)
+  {
+    dst[i] = static_cast<DstType>(src[i]);
+  }
+}
+
+} // end namespace VTK_DATA_ARRAY_SIMD_KERNELS
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+// The AVX2 kernels, compiled separately with the AVX2 flags. The range
+// kernels write ranges in the value type, the caller converts them.
+namespace vtkDataArraySIMDAVX2
+{
+void ComputeScalarRange(const float *values, vtkIdType numTuples,
+                        int numComps, float *range, bool finite);
+void ComputeScalarRange(const double *values, vtkIdType numTuples,
+                        int numComps, double *range, bool finite);
+void ComputeScalarRange(const int *values, vtkIdType numTuples,
+                        int numComps, int *range, bool finite);
+
+void ComputeVectorRange(const float *const *components, vtkIdType stride,
+                        int numComps, vtkIdType numTuples, double range[2],
+                        bool finite);
+void ComputeVectorRange(const double *const *components, vtkIdType stride,
+                        int numComps, vtkIdType numTuples, double range[2],
+                        bool finite);
+void ComputeVectorRange(const int *const *components, vtkIdType stride,
+                        int numComps, vtkIdType numTuples, double range[2],
+                        bool finite);
+
+void ConvertValues(const float *src, double *dst, vtkIdType numValues);
+void ConvertValues(const double *src, float *dst, vtkIdType numValues);
+void ConvertValues(const int *src, float *dst, vtkIdType numValues);
+void ConvertValues(const int *src, double *dst, vtkIdType numValues);
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkDataArraySIMDKernels.txx
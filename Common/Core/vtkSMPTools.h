@@ -19,8 +19,10 @@
  * vtkSMPTools provides a set of utility functions that can
  * be used to parallelize parts of VTK code using multiple threads.
  * There are several back-end implementations of parallel functionality
- * (currently Sequential, TBB and X-Kaapi) that actual execution is
- * delegated to.
+ * (currently Sequential, STDThread, OpenMP and TBB) that actual execution is
+ * delegated to. The STDThread backend only depends on the C++ standard
+ * library: it runs loops on a persistent thread pool and balances irregular
+ * work by letting idle threads steal chunks from busy ones.
 */
 
 #ifndef vtkSMPTools_h
@@ -32,6 +34,12 @@
 #include "vtkSMPThreadLocal.h" // For Initialized
 #include "vtkSMPToolsInternal.h"
 
+#include <algorithm> // For std::sort
+#include <functional> // For std::plus
+#include <iterator> // For std::iterator_traits
+#include <string> // For std::string
+#include <vector> // For std::vector
+
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 #ifndef __VTK_WRAP__
@@ -41,6 +49,70 @@ namespace detail
 {
 namespace smp
 {
+// Runtime state shared by all backends, see vtkSMPTools::SetBackend() and
+// vtkSMPTools::LocalScope.
+bool VTKCOMMONCORE_EXPORT GetUseSequentialBackend();
+int VTKCOMMONCORE_EXPORT GetLocalMaxNumberOfThreads();
+bool VTKCOMMONCORE_EXPORT GetRunNestedSequentially();
+
+// The vtkSMPTools::LocalScope settings of the thread that starts a parallel
+// loop. They are captured when the loop starts and applied to the threads
+// that execute its body, so that the loops nested in it honor them too.
+struct vtkSMPTools_ScopeState
+{
+  int Backend;
+  int MaxNumberOfThreads;
+};
+vtkSMPTools_ScopeState VTKCOMMONCORE_EXPORT GetScopeState();
+
+// Marks the calling thread as executing the body of a parallel loop, see
+// vtkSMPTools::IsParallelScope(), and applies the settings of the thread
+// that started the loop until the body returns.
+class VTKCOMMONCORE_EXPORT vtkSMPTools_ParallelScope
+{
+public:
+  explicit vtkSMPTools_ParallelScope(const vtkSMPTools_ScopeState& state);
+  ~vtkSMPTools_ParallelScope();
+
+private:
+  vtkSMPTools_ScopeState Previous;
+
+  vtkSMPTools_ParallelScope(const vtkSMPTools_ParallelScope&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkSMPTools_ParallelScope&) VTK_DELETE_FUNCTION;
+};
+
+template <typename FunctorInternal>
+void vtkSMPTools_Sequential_For(vtkIdType first, vtkIdType last,
+                                vtkIdType grain, FunctorInternal& fi)
+{
+  if (grain <= 0 || grain >= last - first)
+  {
+    if (last > first)
+    {
+      fi.Execute(first, last);
+    }
+    return;
+  }
+  for (vtkIdType b = first; b < last; b += grain)
+  {
+    fi.Execute(b, (b + grain < last) ? b + grain : last);
+  }
+}
+
+template <typename FunctorInternal>
+void vtkSMPTools_Dispatch_For(vtkIdType first, vtkIdType last,
+                              vtkIdType grain, FunctorInternal& fi)
+{
+  if (GetUseSequentialBackend() || GetRunNestedSequentially())
+  {
+    vtkSMPTools_Sequential_For(first, last, grain, fi);
+  }
+  else
+  {
+    vtkSMPTools_Impl_For(first, last, grain, fi);
+  }
+}
+
 template <typename T>
 class vtkSMPTools_Has_Initialize
 {
@@ -72,14 +144,16 @@ template <typename Functor>
 struct vtkSMPTools_FunctorInternal<Functor, false>
 {
   Functor& F;
-  vtkSMPTools_FunctorInternal(Functor& f): F(f) {}
+  vtkSMPTools_ScopeState State;
+  vtkSMPTools_FunctorInternal(Functor& f): F(f), State(GetScopeState()) {}
   void Execute(vtkIdType first, vtkIdType last)
   {
+    vtkSMPTools_ParallelScope scope(this->State);
     this->F(first, last);
   }
   void For(vtkIdType first, vtkIdType last, vtkIdType grain)
   {
-    vtk::detail::smp::vtkSMPTools_Impl_For(first, last, grain, *this);
+    vtk::detail::smp::vtkSMPTools_Dispatch_For(first, last, grain, *this);
   }
   vtkSMPTools_FunctorInternal<Functor, false>& operator=(
     const vtkSMPTools_FunctorInternal<Functor, false>&);
@@ -91,10 +165,13 @@ template <typename Functor>
 struct vtkSMPTools_FunctorInternal<Functor, true>
 {
   Functor& F;
+  vtkSMPTools_ScopeState State;
   vtkSMPThreadLocal<unsigned char> Initialized;
-  vtkSMPTools_FunctorInternal(Functor& f): F(f), Initialized(0) {}
+  vtkSMPTools_FunctorInternal(Functor& f)
+    : F(f), State(GetScopeState()), Initialized(0) {}
   void Execute(vtkIdType first, vtkIdType last)
   {
+    vtkSMPTools_ParallelScope scope(this->State);
     unsigned char& inited = this->Initialized.Local();
     if (!inited)
     {
@@ -105,7 +182,7 @@ struct vtkSMPTools_FunctorInternal<Functor, true>
   }
   void For(vtkIdType first, vtkIdType last, vtkIdType grain)
   {
-    vtk::detail::smp::vtkSMPTools_Impl_For(first, last, grain, *this);
+    vtk::detail::smp::vtkSMPTools_Dispatch_For(first, last, grain, *this);
     this->F.Reduce();
   }
   vtkSMPTools_FunctorInternal<Functor, true>& operator=(
@@ -129,6 +206,128 @@ class vtkSMPTools_Lookup_For<Functor const>
 public:
   typedef vtkSMPTools_FunctorInternal<Functor const, init> type;
 };
+
+// Reductions and scans work on fixed size blocks so that the result does
+// not depend on the number of threads or on the scheduling.
+const vtkIdType vtkSMPTools_BlockSize = 8192;
+
+template <typename InputIt, typename OutputIt, typename UnaryOp>
+struct vtkSMPTools_UnaryTransform
+{
+  InputIt In;
+  OutputIt Out;
+  UnaryOp Op;
+
+  vtkSMPTools_UnaryTransform(InputIt in, OutputIt out, UnaryOp op)
+    : In(in), Out(out), Op(op)
+  {
+  }
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::transform(this->In + begin, this->In + end, this->Out + begin,
+                   this->Op);
+  }
+};
+
+template <typename InputIt1, typename InputIt2, typename OutputIt,
+          typename BinaryOp>
+struct vtkSMPTools_BinaryTransform
+{
+  InputIt1 In1;
+  InputIt2 In2;
+  OutputIt Out;
+  BinaryOp Op;
+
+  vtkSMPTools_BinaryTransform(InputIt1 in1, InputIt2 in2, OutputIt out,
+                              BinaryOp op)
+    : In1(in1), In2(in2), Out(out), Op(op)
+  {
+  }
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::transform(this->In1 + begin, this->In1 + end, this->In2 + begin,
+                   this->Out + begin, this->Op);
+  }
+};
+
+template <typename Iterator, typename T>
+struct vtkSMPTools_Fill
+{
+  Iterator Begin;
+  const T& Value;
+
+  vtkSMPTools_Fill(Iterator begin, const T& value)
+    : Begin(begin), Value(value)
+  {
+  }
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::fill(this->Begin + begin, this->Begin + end, this->Value);
+  }
+  void operator=(const vtkSMPTools_Fill&) VTK_DELETE_FUNCTION;
+};
+
+// Reduce each block of vtkSMPTools_BlockSize values into Partials.
+template <typename InputIt, typename T, typename BinaryOp>
+struct vtkSMPTools_BlockReduce
+{
+  InputIt In;
+  vtkIdType Size;
+  T* Partials;
+  BinaryOp Op;
+
+  vtkSMPTools_BlockReduce(InputIt in, vtkIdType size, T* partials,
+                          BinaryOp op)
+    : In(in), Size(size), Partials(partials), Op(op)
+  {
+  }
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkIdType i = block * vtkSMPTools_BlockSize;
+      vtkIdType end = std::min(i + vtkSMPTools_BlockSize, this->Size);
+      T acc = this->In[i];
+      for (++i; i < end; ++i)
+      {
+        acc = this->Op(acc, this->In[i]);
+      }
+      this->Partials[block] = acc;
+    }
+  }
+};
+
+// Exclusive scan of each block, starting from the block's offset.
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+struct vtkSMPTools_BlockScan
+{
+  InputIt In;
+  OutputIt Out;
+  vtkIdType Size;
+  const T* Offsets;
+  BinaryOp Op;
+
+  vtkSMPTools_BlockScan(InputIt in, OutputIt out, vtkIdType size,
+                        const T* offsets, BinaryOp op)
+    : In(in), Out(out), Size(size), Offsets(offsets), Op(op)
+  {
+  }
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkIdType i = block * vtkSMPTools_BlockSize;
+      vtkIdType end = std::min(i + vtkSMPTools_BlockSize, this->Size);
+      T acc = this->Offsets[block];
+      for (; i < end; ++i)
+      {
+        T value = this->In[i]; // read first so that In may alias Out
+        this->Out[i] = acc;
+        acc = this->Op(acc, value);
+      }
+    }
+  }
+};
 } // namespace smp
 } // namespace detail
 } // namespace vtk
@@ -210,7 +409,7 @@ public:
    * not required as it is automatically called before the first
    * execution of any parallel code. However, it can be used to
    * control the maximum number of threads used when the back-end
-   * supports it (currently Simple and TBB only). Make sure to call
+   * supports it (currently STDThread, OpenMP and TBB). Make sure to call
    * it before any other parallel operation.
    * When using Kaapi, use the KAAPI_CPUCOUNT env. variable to control
    * the number of threads used in the thread pool.
@@ -221,35 +420,495 @@ public:
    * Get the estimated number of threads being used by the backend.
    * This should be used as just an estimate since the number of threads may
    * vary dynamically and a particular task may not be executed on all the
-   * available threads.
+   * available threads. The value accounts for the active backend and for the
+   * limit of the innermost LocalScope of the calling thread.
    */
   static int GetEstimatedNumberOfThreads();
 
+  /**
+   * Select the backend used by parallel operations of this process. Only
+   * the backend chosen at configure time (VTK_SMP_IMPLEMENTATION_TYPE) and
+   * "Sequential" are available: vtkSMPThreadLocal and the atomics are
+   * compiled for a single backend, so OpenMP and TBB cannot be switched
+   * between at runtime. Returns false and leaves the current backend
+   * unchanged if the requested one was not built. The initial value can be
+   * set with the VTK_SMP_BACKEND_IN_USE environment variable.
+   */
+  static bool SetBackend(const char* backend);
+
+  /**
+   * Get the name of the backend used by parallel operations started by the
+   * calling thread.
+   */
+  static const char* GetBackend();
+
+  //@{
+  /**
+   * Control what happens when a parallel operation is started from inside
+   * the body of another one, for example by a filter executed per block by
+   * vtkThreadedCompositeDataPipeline. When off (the default) the inner
+   * operation runs sequentially in the calling thread, which avoids
+   * oversubscribing the cores when the outer loop already keeps every
+   * thread busy. When on, the inner operation is handed to the backend and
+   * may use the threads that are idle. This setting applies to the whole
+   * process.
+   */
+  static void SetNestedParallelism(bool isNested);
+  static bool GetNestedParallelism();
+  //@}
+
+  /**
+   * Return true if the calling thread is executing the body of a
+   * vtkSMPTools parallel operation. Code that can either be run on its own or
+   * from a parallel loop can use it to pick a sequential algorithm when it
+   * is nested.
+   */
+  static bool IsParallelScope();
+
+  /**
+   * Settings applied by a LocalScope. A MaxNumberOfThreads of 0 and an
+   * empty Backend leave the corresponding setting unchanged.
+   */
+  struct Config
+  {
+    int MaxNumberOfThreads;
+    std::string Backend;
+
+    Config() : MaxNumberOfThreads(0)
+    {
+    }
+    Config(int maxNumberOfThreads) : MaxNumberOfThreads(maxNumberOfThreads)
+    {
+    }
+    Config(const std::string& backend) : MaxNumberOfThreads(0), Backend(backend)
+    {
+    }
+  };
+
+  /**
+   * Apply a Config to the parallel operations started by the calling thread
+   * for the lifetime of this object. This lets several pipelines running in
+   * different threads of one process each cap their own concurrency:
+   *
+   * \code
+   * {
+   *   vtkSMPTools::LocalScope scope(vtkSMPTools::Config(4));
+   *   filter->Update(); // uses at most 4 threads
+   * }
+   * \endcode
+   *
+   * Scopes can be nested; a nested scope can only lower the thread limit of
+   * the enclosing one. The settings also apply to the parallel operations
+   * nested in the ones started within the scope, whichever thread runs
+   * them. The limit is honored by the STDThread, OpenMP and TBB backends.
+   */
+  class VTKCOMMONCORE_EXPORT LocalScope
+  {
+  public:
+    explicit LocalScope(const Config& config);
+    ~LocalScope();
+
+  private:
+    int PreviousMaxNumberOfThreads;
+    int PreviousBackend;
+
+    LocalScope(const LocalScope&) VTK_DELETE_FUNCTION;
+    void operator=(const LocalScope&) VTK_DELETE_FUNCTION;
+  };
+
+  /**
+   * A parallel version of std::transform() for random access iterators.
+   * op is called concurrently from several threads and must be thread safe.
+   */
+  template <typename InputIt, typename OutputIt, typename UnaryOp>
+  static void Transform(InputIt inBegin, InputIt inEnd, OutputIt outBegin,
+                        UnaryOp op)
+  {
+    vtk::detail::smp::vtkSMPTools_UnaryTransform<InputIt, OutputIt, UnaryOp>
+      worker(inBegin, outBegin, op);
+    vtkSMPTools::For(0, inEnd - inBegin, worker);
+  }
+
+  /**
+   * A parallel version of the binary std::transform() for random access
+   * iterators. op is called concurrently from several threads and must be
+   * thread safe.
+   */
+  template <typename InputIt1, typename InputIt2, typename OutputIt,
+            typename BinaryOp>
+  static void Transform(InputIt1 inBegin1, InputIt1 inEnd, InputIt2 inBegin2,
+                        OutputIt outBegin, BinaryOp op)
+  {
+    vtk::detail::smp::vtkSMPTools_BinaryTransform<InputIt1, InputIt2,
+      OutputIt, BinaryOp> worker(inBegin1, inBegin2, outBegin, op);
+    vtkSMPTools::For(0, inEnd - inBegin1, worker);
+  }
+
+  /**
+   * A parallel version of std::fill() for random access iterators.
+   */
+  template <typename Iterator, typename T>
+  static void Fill(Iterator begin, Iterator end, const T& value)
+  {
+    vtk::detail::smp::vtkSMPTools_Fill<Iterator, T> worker(begin, value);
+    vtkSMPTools::For(0, end - begin, worker);
+  }
+
+  /**
+   * Combine init and all the values of [begin, end) with op, which must be
+   * associative. Values are combined in fixed size blocks, in order, so the
+   * result does not depend on the backend or on the number of threads,
+   * even for floating point values.
+   */
+  template <typename InputIt, typename T, typename BinaryOp>
+  static T Reduce(InputIt begin, InputIt end, T init, BinaryOp op)
+  {
+    vtkIdType size = end - begin;
+    vtkIdType numBlocks = (size + vtk::detail::smp::vtkSMPTools_BlockSize - 1)
+      / vtk::detail::smp::vtkSMPTools_BlockSize;
+    std::vector<T> partials(numBlocks, init);
+    vtk::detail::smp::vtkSMPTools_BlockReduce<InputIt, T, BinaryOp>
+      worker(begin, size, partials.data(), op);
+    vtkSMPTools::For(0, numBlocks, worker);
+    for (vtkIdType block = 0; block < numBlocks; ++block)
+    {
+      init = op(init, partials[block]);
+    }
+    return init;
+  }
+
+  /**
+   * Sum init and all the values of [begin, end).
+   */
+  template <typename InputIt, typename T>
+  static T Reduce(InputIt begin, InputIt end, T init)
+  {
+    return vtkSMPTools::Reduce(begin, end, init, std::plus<T>());
+  }
+
+  /**
+   * A parallel exclusive prefix scan: outBegin[i] is init combined with
+   * the values [inBegin, inBegin + i) using op, which must be associative.
+   * The combination of init with all the input values is returned, which
+   * is convenient to turn per-item counts into offsets:
+   *
+   * \code
+   * vtkIdType total = vtkSMPTools::ExclusiveScan(counts, counts + n,
+   *   offsets, vtkIdType(0));
+   * \endcode
+   *
+   * The output may alias the input. Like Reduce(), the result does not
+   * depend on the number of threads.
+   */
+  template <typename InputIt, typename OutputIt, typename T,
+            typename BinaryOp>
+  static T ExclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin,
+                         T init, BinaryOp op)
+  {
+    vtkIdType size = inEnd - inBegin;
+    vtkIdType numBlocks = (size + vtk::detail::smp::vtkSMPTools_BlockSize - 1)
+      / vtk::detail::smp::vtkSMPTools_BlockSize;
+    std::vector<T> offsets(numBlocks, init);
+    vtk::detail::smp::vtkSMPTools_BlockReduce<InputIt, T, BinaryOp>
+      reduce(inBegin, size, offsets.data(), op);
+    vtkSMPTools::For(0, numBlocks, reduce);
+    for (vtkIdType block = 0; block < numBlocks; ++block)
+    {
+      T blockTotal = offsets[block];
+      offsets[block] = init;
+      init = op(init, blockTotal);
+    }
+    vtk::detail::smp::vtkSMPTools_BlockScan<InputIt, OutputIt, T, BinaryOp>
+      scan(inBegin, outBegin, size, offsets.data(), op);
+    vtkSMPTools::For(0, numBlocks, scan);
+    return init;
+  }
+
+  /**
+   * A parallel exclusive prefix sum, see the version taking a BinaryOp.
+   */
+  template <typename InputIt, typename OutputIt, typename T>
+  static T ExclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin,
+                         T init)
+  {
+    return vtkSMPTools::ExclusiveScan(inBegin, inEnd, outBegin, init,
+                                      std::plus<T>());
+  }
+
   /**
    * A convenience method for sorting data. It is a drop in replacement for
-   * std::sort(). Under the hood different methods are used. For example,
-   * tbb::parallel_sort is used in TBB.
+   * std::sort(). Under the hood different methods are used:
+   * tbb::parallel_sort is used in TBB, the STDThread and OpenMP backends
+   * use a parallel merge sort and std::sort is used otherwise. The merge
+   * sort needs a temporary copy of the data, so the value type must be
+   * default constructible.
    */
   template<typename RandomAccessIterator>
     static void Sort(RandomAccessIterator begin, RandomAccessIterator end)
   {
-    vtk::detail::smp::vtkSMPTools_Impl_Sort(begin,end);
+    if (vtk::detail::smp::GetUseSequentialBackend() ||
+        vtk::detail::smp::GetRunNestedSequentially())
+    {
+      std::sort(begin,end);
+    }
+    else
+    {
+      vtk::detail::smp::vtkSMPTools_Impl_Sort(begin,end);
+    }
   }
 
   /**
    * A convenience method for sorting data. It is a drop in replacement for
-   * std::sort(). Under the hood different methods are used. For example,
-   * tbb::parallel_sort is used in TBB. This version of Sort() takes a
-   * comparison class.
+   * std::sort(). Under the hood different methods are used, see above.
+   * This version of Sort() takes a comparison class.
    */
   template<typename RandomAccessIterator, typename Compare>
     static void Sort(RandomAccessIterator begin, RandomAccessIterator end,
       Compare comp)
   {
-    vtk::detail::smp::vtkSMPTools_Impl_Sort(begin,end,comp);
+    if (vtk::detail::smp::GetUseSequentialBackend() ||
+        vtk::detail::smp::GetRunNestedSequentially())
+    {
+      std::sort(begin,end,comp);
+    }
+    else
+    {
+      vtk::detail::smp::vtkSMPTools_Impl_Sort(begin,end,comp);
+    }
   }
 
 };
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+#ifndef __VTK_WRAP__
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+template <typename RandomAccessIterator, typename Compare>
+struct vtkSMPTools_SortBlocks
+{
+  RandomAccessIterator Begin;
+  const vtkIdType* Bounds;
+  Compare Comp;
+
+  vtkSMPTools_SortBlocks(RandomAccessIterator begin, const vtkIdType* bounds,
+                         Compare comp)
+    : Begin(begin), Bounds(bounds), Comp(comp)
+  {
+  }
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      std::sort(this->Begin + this->Bounds[block],
+                this->Begin + this->Bounds[block + 1], this->Comp);
+    }
+  }
+};
+
+// Merges pairs of sorted runs of Width blocks. Each merge is cut into
+// Pieces pieces of equal output size, located with a binary search along
+// the merge path, so that the last passes also run in parallel. The split
+// points of all the pieces are computed first since merging moves values
+// out of the input.
+template <typename InputIt, typename OutputIt, typename Compare>
+struct vtkSMPTools_MergeRuns
+{
+  InputIt In;
+  OutputIt Out;
+  const vtkIdType* Bounds;
+  vtkIdType Width;
+  vtkIdType Pieces;
+  vtkIdType* Splits;
+  Compare Comp;
+
+  vtkSMPTools_MergeRuns(InputIt in, OutputIt out, const vtkIdType* bounds,
+                        vtkIdType width, vtkIdType pieces, vtkIdType* splits,
+                        Compare comp)
+    : In(in), Out(out), Bounds(bounds), Width(width), Pieces(pieces),
+      Splits(splits), Comp(comp)
+  {
+  }
+
+  // Number of values of a that are among the first k values of the stable
+  // merge of a (size m) and b (size n).
+  vtkIdType CoRank(vtkIdType k, InputIt a, vtkIdType m, InputIt b,
+                   vtkIdType n)
+  {
+    vtkIdType lo = (k > n) ? k - n : 0;
+    vtkIdType hi = (k < m) ? k : m;
+    while (lo < hi)
+    {
+      vtkIdType i = (lo + hi) / 2;
+      if (this->Comp(b[k - i - 1], a[i]))
+      {
+        hi = i;
+      }
+      else
+      {
+        lo = i + 1;
+      }
+    }
+    return lo;
+  }
+
+  // Fill Splits with the co-rank of the first output value of each task.
+  void ComputeSplits(vtkIdType beginTask, vtkIdType endTask)
+  {
+    for (vtkIdType task = beginTask; task < endTask; ++task)
+    {
+      vtkIdType pair = task / this->Pieces;
+      vtkIdType lo = this->Bounds[2 * pair * this->Width];
+      vtkIdType mid = this->Bounds[(2 * pair + 1) * this->Width];
+      vtkIdType hi = this->Bounds[(2 * pair + 2) * this->Width];
+      vtkIdType k = (hi - lo) * (task % this->Pieces) / this->Pieces;
+      this->Splits[task] = this->CoRank(k, this->In + lo, mid - lo,
+                                        this->In + mid, hi - mid);
+    }
+  }
+
+  void Merge(vtkIdType beginTask, vtkIdType endTask)
+  {
+    for (vtkIdType task = beginTask; task < endTask; ++task)
+    {
+      vtkIdType pair = task / this->Pieces;
+      vtkIdType piece = task % this->Pieces;
+      vtkIdType lo = this->Bounds[2 * pair * this->Width];
+      vtkIdType mid = this->Bounds[(2 * pair + 1) * this->Width];
+      vtkIdType hi = this->Bounds[(2 * pair + 2) * this->Width];
+      vtkIdType k0 = (hi - lo) * piece / this->Pieces;
+      vtkIdType k1 = (hi - lo) * (piece + 1) / this->Pieces;
+      vtkIdType i0 = this->Splits[task];
+      vtkIdType i1 = (piece + 1 < this->Pieces) ? this->Splits[task + 1] :
+        mid - lo;
+      InputIt a = this->In + lo;
+      InputIt b = this->In + mid;
+      std::merge(std::make_move_iterator(a + i0),
+                 std::make_move_iterator(a + i1),
+                 std::make_move_iterator(b + (k0 - i0)),
+                 std::make_move_iterator(b + (k1 - i1)),
+                 this->Out + lo + k0, this->Comp);
+    }
+  }
+
+  // Run both steps over all the tasks of a pass.
+  struct SplitStep
+  {
+    vtkSMPTools_MergeRuns& Self;
+    explicit SplitStep(vtkSMPTools_MergeRuns& self) : Self(self)
+    {
+    }
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      this->Self.ComputeSplits(begin, end);
+    }
+    void operator=(const SplitStep&) VTK_DELETE_FUNCTION;
+  };
+  struct MergeStep
+  {
+    vtkSMPTools_MergeRuns& Self;
+    explicit MergeStep(vtkSMPTools_MergeRuns& self) : Self(self)
+    {
+    }
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      this->Self.Merge(begin, end);
+    }
+    void operator=(const MergeStep&) VTK_DELETE_FUNCTION;
+  };
+  void Run(vtkIdType numTasks)
+  {
+    SplitStep split(*this);
+    vtkSMPTools::For(0, numTasks, 1, split);
+    MergeStep merge(*this);
+    vtkSMPTools::For(0, numTasks, 1, merge);
+  }
+};
+
+template <typename InputIt, typename OutputIt>
+struct vtkSMPTools_MoveRange
+{
+  InputIt In;
+  OutputIt Out;
+
+  vtkSMPTools_MoveRange(InputIt in, OutputIt out) : In(in), Out(out)
+  {
+  }
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::move(this->In + begin, this->In + end, this->Out + begin);
+  }
+};
+
+// Parallel merge sort used by the backends that do not provide their own
+// parallel sort. The range is cut in a power of two number of blocks that
+// are sorted independently, then merged pairwise through a buffer.
+template <typename RandomAccessIterator, typename Compare>
+void vtkSMPTools_MergeSort(RandomAccessIterator begin,
+                           RandomAccessIterator end, Compare comp)
+{
+  typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+    ValueType;
+  const vtkIdType minBlockSize = 4096;
+  vtkIdType size = end - begin;
+  int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  vtkIdType numBlocks = 1;
+  while (numBlocks < numThreads && size / (2 * numBlocks) >= minBlockSize)
+  {
+    numBlocks *= 2;
+  }
+  if (numBlocks == 1)
+  {
+    std::sort(begin, end, comp);
+    return;
+  }
+
+  std::vector<vtkIdType> bounds(numBlocks + 1);
+  for (vtkIdType block = 0; block <= numBlocks; ++block)
+  {
+    bounds[block] = size * block / numBlocks;
+  }
+  vtkSMPTools_SortBlocks<RandomAccessIterator, Compare> sorter(begin,
+    bounds.data(), comp);
+  vtkSMPTools::For(0, numBlocks, 1, sorter);
+
+  std::vector<ValueType> buffer(size);
+  ValueType* tmp = buffer.data();
+  std::vector<vtkIdType> splits(numBlocks);
+  bool inBuffer = false;
+  for (vtkIdType width = 1; width < numBlocks; width *= 2)
+  {
+    // Every pass runs numBlocks tasks: numBlocks / (2 * width) merges of
+    // 2 * width pieces each.
+    vtkIdType pieces = 2 * width;
+    if (inBuffer)
+    {
+      vtkSMPTools_MergeRuns<ValueType*, RandomAccessIterator, Compare>
+        merger(tmp, begin, bounds.data(), width, pieces, splits.data(), comp);
+      merger.Run(numBlocks);
+    }
+    else
+    {
+      vtkSMPTools_MergeRuns<RandomAccessIterator, ValueType*, Compare>
+        merger(begin, tmp, bounds.data(), width, pieces, splits.data(), comp);
+      merger.Run(numBlocks);
+    }
+    inBuffer = !inBuffer;
+  }
+  if (inBuffer)
+  {
+    vtkSMPTools_MoveRange<ValueType*, RandomAccessIterator> mover(tmp, begin);
+    vtkSMPTools::For(0, size, mover);
+  }
+}
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+#endif // __VTK_WRAP__
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 #endif
 // VTK-HeaderTest-Exclude: vtkSMPTools.h
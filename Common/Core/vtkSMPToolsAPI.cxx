@@ -0,0 +1,215 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsAPI.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Backend independent part of vtkSMPTools: runtime backend selection,
+// per-thread scopes and nested parallelism. The backend specific parts live
+// in SMP/<backend>.
+
+#include "vtkSMPTools.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+// The backend chosen at configure time and the sequential fallback.
+enum
+{
+  BackendUnset = -1,
+  BackendDefault = 0,
+  BackendSequential = 1
+};
+
+int BackendFromName(const char* name)
+{
+  if (!name)
+  {
+    return BackendUnset;
+  }
+  if (strcmp(name, "Sequential") == 0)
+  {
+    return BackendSequential;
+  }
+  if (strcmp(name, VTK_SMP_BACKEND) == 0)
+  {
+    return BackendDefault;
+  }
+  return BackendUnset;
+}
+
+std::atomic<int>& ProcessBackend()
+{
+  static std::atomic<int> backend(BackendFromName(
+    getenv("VTK_SMP_BACKEND_IN_USE")) == BackendSequential ?
+    BackendSequential : BackendDefault);
+  return backend;
+}
+
+// Not all the compilers supported by VTK implement thread_local (Visual
+// Studio 2013, Xcode before 8), but they all have an extension for thread
+// local variables of plain types, which is all that is needed here.
+#if defined(_MSC_VER)
+# define VTK_SMP_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+# define VTK_SMP_THREAD_LOCAL __thread
+#else
+# define VTK_SMP_THREAD_LOCAL thread_local
+#endif
+
+// Settings of the innermost LocalScope of each thread, or of the thread that
+// started the parallel loop it is executing.
+VTK_SMP_THREAD_LOCAL int LocalBackend = BackendUnset;
+VTK_SMP_THREAD_LOCAL int LocalMaxNumberOfThreads = 0;
+
+// Number of parallel loop bodies the thread is currently executing.
+VTK_SMP_THREAD_LOCAL int ParallelScopeDepth = 0;
+
+std::atomic<bool> NestedParallelism(false);
+
+int GetActiveBackend()
+{
+  return LocalBackend != BackendUnset ? LocalBackend : ProcessBackend().load();
+}
+}
+
+//--------------------------------------------------------------------------------
+bool vtk::detail::smp::GetUseSequentialBackend()
+{
+  return GetActiveBackend() == BackendSequential;
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::GetLocalMaxNumberOfThreads()
+{
+  return LocalMaxNumberOfThreads;
+}
+
+//--------------------------------------------------------------------------------
+bool vtk::detail::smp::GetRunNestedSequentially()
+{
+  return ParallelScopeDepth > 0 && !NestedParallelism;
+}
+
+//--------------------------------------------------------------------------------
+vtk::detail::smp::vtkSMPTools_ScopeState vtk::detail::smp::GetScopeState()
+{
+  vtkSMPTools_ScopeState state;
+  state.Backend = LocalBackend;
+  state.MaxNumberOfThreads = LocalMaxNumberOfThreads;
+  return state;
+}
+
+//--------------------------------------------------------------------------------
+vtk::detail::smp::vtkSMPTools_ParallelScope::vtkSMPTools_ParallelScope(
+  const vtkSMPTools_ScopeState& state)
+  : Previous(GetScopeState())
+{
+  LocalBackend = state.Backend;
+  LocalMaxNumberOfThreads = state.MaxNumberOfThreads;
+  ++ParallelScopeDepth;
+}
+
+//--------------------------------------------------------------------------------
+vtk::detail::smp::vtkSMPTools_ParallelScope::~vtkSMPTools_ParallelScope()
+{
+  --ParallelScopeDepth;
+  LocalBackend = this->Previous.Backend;
+  LocalMaxNumberOfThreads = this->Previous.MaxNumberOfThreads;
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPTools::SetNestedParallelism(bool isNested)
+{
+  NestedParallelism = isNested;
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::GetNestedParallelism()
+{
+  return NestedParallelism;
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::IsParallelScope()
+{
+  return ParallelScopeDepth > 0;
+}
+
+//--------------------------------------------------------------------------------
+int vtkSMPTools::GetEstimatedNumberOfThreads()
+{
+  if (GetActiveBackend() == BackendSequential)
+  {
+    return 1;
+  }
+  int numThreads = vtk::detail::smp::GetNumberOfThreads();
+  if (LocalMaxNumberOfThreads > 0 && LocalMaxNumberOfThreads < numThreads)
+  {
+    numThreads = LocalMaxNumberOfThreads;
+  }
+  return numThreads;
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::SetBackend(const char* backend)
+{
+  int value = BackendFromName(backend);
+  if (value == BackendUnset)
+  {
+    return false;
+  }
+  ProcessBackend() = value;
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+const char* vtkSMPTools::GetBackend()
+{
+  return GetActiveBackend() == BackendSequential ? "Sequential" :
+    VTK_SMP_BACKEND;
+}
+
+//--------------------------------------------------------------------------------
+vtkSMPTools::LocalScope::LocalScope(const Config& config)
+  : PreviousMaxNumberOfThreads(LocalMaxNumberOfThreads),
+    PreviousBackend(LocalBackend)
+{
+  if (config.MaxNumberOfThreads > 0 &&
+      (LocalMaxNumberOfThreads <= 0 ||
+       config.MaxNumberOfThreads < LocalMaxNumberOfThreads))
+  {
+    LocalMaxNumberOfThreads = config.MaxNumberOfThreads;
+  }
+  if (!config.Backend.empty())
+  {
+    int backend = BackendFromName(config.Backend.c_str());
+    if (backend != BackendUnset)
+    {
+      LocalBackend = backend;
+    }
+    else
+    {
+      vtkGenericWarningMacro("SMP backend " << config.Backend
+        << " is not available, using " << vtkSMPTools::GetBackend());
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------
+vtkSMPTools::LocalScope::~LocalScope()
+{
+  LocalMaxNumberOfThreads = this->PreviousMaxNumberOfThreads;
+  LocalBackend = this->PreviousBackend;
+}
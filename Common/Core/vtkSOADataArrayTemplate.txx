@@ -108,6 +108,7 @@ void vtkSOADataArrayTemplate<ValueType>::ShallowCopy(vtkDataArray *other)
       }
     }
     this->DataChanged();
+    this->CopyRangeCache(o);
   }
   else
   {
@@ -0,0 +1,385 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestBVHCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the queries of vtkBVHCellLocator against a brute force search over
+// all the cells.
+
+#include "vtkBVHCellLocator.h"
+#include "vtkCellType.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+// Two layers of a bumpy surface made of triangles, quads and polygons, and
+// a pile of coincident triangles.
+void MakeSurface(vtkPolyData *surface)
+{
+  const int res = 40;
+  vtkNew<vtkPoints> points;
+  surface->SetPoints(points.GetPointer());
+  surface->Allocate(4 * res * res);
+  for (int layer = 0; layer < 2; ++layer)
+  {
+    vtkIdType offset = points->GetNumberOfPoints();
+    for (int j = 0; j <= res; ++j)
+    {
+      for (int i = 0; i <= res; ++i)
+      {
+        double x = static_cast<double>(i) / res;
+        double y = static_cast<double>(j) / res;
+        points->InsertNextPoint(x, y, 0.5 * layer + 0.1 * sin(6.0 * x) *
+                                cos(4.0 * y));
+      }
+    }
+    for (int j = 0; j < res; ++j)
+    {
+      for (int i = 0; i < res; ++i)
+      {
+        vtkIdType p0 = offset + i + j * (res + 1);
+        vtkIdType quad[4] = { p0, p0 + 1, p0 + res + 2, p0 + res + 1 };
+        vtkIdType tri0[3] = { quad[0], quad[1], quad[2] };
+        vtkIdType tri1[3] = { quad[0], quad[2], quad[3] };
+        switch ((i + j) % 3)
+        {
+          case 0:
+            surface->InsertNextCell(VTK_QUAD, 4, quad);
+            break;
+          case 1:
+            surface->InsertNextCell(VTK_TRIANGLE, 3, tri0);
+            surface->InsertNextCell(VTK_TRIANGLE, 3, tri1);
+            break;
+          default:
+            surface->InsertNextCell(VTK_POLYGON, 4, quad);
+            break;
+        }
+      }
+    }
+  }
+
+  vtkIdType tri[3];
+  tri[0] = points->InsertNextPoint(0.2, 0.2, 0.8);
+  tri[1] = points->InsertNextPoint(0.3, 0.2, 0.8);
+  tri[2] = points->InsertNextPoint(0.2, 0.3, 0.8);
+  for (int i = 0; i < 100; ++i)
+  {
+    surface->InsertNextCell(VTK_TRIANGLE, 3, tri);
+  }
+}
+
+// A grid of slightly warped hexahedra. There are enough cells for the top
+// of the tree to be built in parallel.
+void MakeVolume(vtkUnstructuredGrid *volume)
+{
+  const int res = 17;
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k <= res; ++k)
+  {
+    for (int j = 0; j <= res; ++j)
+    {
+      for (int i = 0; i <= res; ++i)
+      {
+        double x = static_cast<double>(i) / res;
+        double y = static_cast<double>(j) / res;
+        double z = static_cast<double>(k) / res;
+        points->InsertNextPoint(x, y, z + 0.02 * sin(6.0 * x) * cos(4.0 * y));
+      }
+    }
+  }
+  volume->SetPoints(points.GetPointer());
+  volume->Allocate(res * res * res);
+  const vtkIdType dj = res + 1, dk = (res + 1) * (res + 1);
+  for (int k = 0; k < res; ++k)
+  {
+    for (int j = 0; j < res; ++j)
+    {
+      for (int i = 0; i < res; ++i)
+      {
+        vtkIdType p0 = i + j * dj + k * dk;
+        vtkIdType hex[8] = { p0, p0 + 1, p0 + 1 + dj, p0 + dj,
+                             p0 + dk, p0 + 1 + dk, p0 + 1 + dj + dk,
+                             p0 + dj + dk };
+        volume->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+      }
+    }
+  }
+}
+
+struct CellTypeLess
+{
+  vtkPolyData *Surface;
+  CellTypeLess(vtkPolyData *surface) : Surface(surface) {}
+  bool operator()(vtkIdType a, vtkIdType b) const
+  {
+    return this->Surface->GetCellType(a) < this->Surface->GetCellType(b);
+  }
+};
+
+double Random(vtkMinimalStandardRandomSequence *random, double min, double max)
+{
+  random->Next();
+  return random->GetRangeValue(min, max);
+}
+
+int TestSurface(vtkMinimalStandardRandomSequence *random)
+{
+  vtkNew<vtkPolyData> surface;
+  MakeSurface(surface.GetPointer());
+  vtkNew<vtkBVHCellLocator> locator;
+  locator->SetDataSet(surface.GetPointer());
+  locator->SetNumberOfCellsPerNode(4);
+  locator->BuildLocator();
+  if (locator->GetNumberOfNodes() < 3 || locator->GetDepth() < 1)
+  {
+    cerr << "The tree has " << locator->GetNumberOfNodes() << " nodes\n";
+    return 1;
+  }
+
+  int errors = 0;
+  vtkIdType numCells = surface->GetNumberOfCells();
+  vtkNew<vtkGenericCell> cell;
+  double weights[VTK_CELL_SIZE];
+
+  // The brute force searches visit the cells grouped by type, which saves
+  // the generic cell from changing its type all the time.
+  std::vector<vtkIdType> byType(numCells);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    byType[cellId] = cellId;
+  }
+  std::stable_sort(byType.begin(), byType.end(),
+                   CellTypeLess(surface.GetPointer()));
+
+  // Closest intersections with lines, some of them lying in a layer
+  const double tol = 1.0e-6;
+  vtkIdType numHits = 0;
+  for (int i = 0; i < 1000; ++i)
+  {
+    double a0[3], a1[3];
+    for (int j = 0; j < 2; ++j)
+    {
+      a0[j] = Random(random, -0.1, 1.1);
+      a1[j] = (i % 2 ? Random(random, -0.1, 1.1) : a0[j]);
+    }
+    a0[2] = (i % 5 == 0 ? 0.25 : -1.0);
+    a1[2] = (i % 7 == 0 ? a0[2] : 2.0);
+
+    double tMin = VTK_DOUBLE_MAX;
+    for (vtkIdType k = 0; k < numCells; ++k)
+    {
+      double t, x[3], pcoords[3];
+      int subId;
+      surface->GetCell(byType[k], cell.GetPointer());
+      if (cell->IntersectWithLine(a0, a1, tol, t, x, pcoords, subId))
+      {
+        tMin = std::min(t, tMin);
+      }
+    }
+
+    double t, x[3], pcoords[3];
+    int subId;
+    vtkIdType cellId;
+    int hit = locator->IntersectWithLine(a0, a1, tol, t, x, pcoords, subId,
+                                         cellId, cell.GetPointer());
+    if (hit != (tMin < VTK_DOUBLE_MAX) || (hit && cellId < 0))
+    {
+      cerr << "Line " << i << ": hit " << hit << " cell " << cellId << "\n";
+      ++errors;
+    }
+    else if (hit && fabs(t - tMin) > 1.0e-9)
+    {
+      cerr << "Line " << i << ": t " << t << " instead of " << tMin << "\n";
+      ++errors;
+    }
+    numHits += hit;
+  }
+  if (numHits < 500)
+  {
+    cerr << "Only " << numHits << " lines intersect the surface\n";
+    ++errors;
+  }
+
+  // Closest points, within a radius or not
+  const double radius = 0.1;
+  for (int i = 0; i < 500; ++i)
+  {
+    double p[3];
+    p[0] = Random(random, -0.5, 1.5);
+    p[1] = Random(random, -0.5, 1.5);
+    p[2] = Random(random, -0.5, 1.0);
+
+    double minDist2 = VTK_DOUBLE_MAX;
+    for (vtkIdType k = 0; k < numCells; ++k)
+    {
+      double closest[3], pcoords[3], dist2;
+      int subId;
+      surface->GetCell(byType[k], cell.GetPointer());
+      if (cell->EvaluatePosition(p, closest, subId, pcoords, dist2,
+                                 weights) != -1)
+      {
+        minDist2 = std::min(dist2, minDist2);
+      }
+    }
+
+    double closest[3], dist2;
+    int subId, inside;
+    vtkIdType cellId;
+    locator->FindClosestPoint(p, closest, cell.GetPointer(), cellId, subId,
+                              dist2);
+    if (cellId < 0 || fabs(dist2 - minDist2) > 1.0e-12 ||
+        fabs(vtkMath::Distance2BetweenPoints(p, closest) - dist2) > 1.0e-12)
+    {
+      cerr << "Point " << i << ": distance2 " << dist2 << " instead of "
+           << minDist2 << "\n";
+      ++errors;
+    }
+
+    vtkIdType found = locator->FindClosestPointWithinRadius(
+      p, radius, closest, cell.GetPointer(), cellId, subId, dist2, inside);
+    if (found != (minDist2 <= radius * radius) ||
+        (found && fabs(dist2 - minDist2) > 1.0e-12))
+    {
+      cerr << "Point " << i << ": found " << found << " within radius\n";
+      ++errors;
+    }
+  }
+
+  // Cells within bounds
+  vtkNew<vtkIdList> cells;
+  for (int i = 0; i < 50; ++i)
+  {
+    double bbox[6];
+    for (int j = 0; j < 3; ++j)
+    {
+      bbox[2 * j] = Random(random, -0.1, 1.0);
+      bbox[2 * j + 1] = bbox[2 * j] + Random(random, 0.0, 0.3);
+    }
+    std::vector<vtkIdType> expected;
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      double b[6];
+      surface->GetCellBounds(cellId, b);
+      if (b[0] <= bbox[1] && b[1] >= bbox[0] && b[2] <= bbox[3] &&
+          b[3] >= bbox[2] && b[4] <= bbox[5] && b[5] >= bbox[4])
+      {
+        expected.push_back(cellId);
+      }
+    }
+    locator->FindCellsWithinBounds(bbox, cells.GetPointer());
+    std::vector<vtkIdType> result(cells->GetPointer(0),
+                                  cells->GetPointer(0) + cells->GetNumberOfIds());
+    std::sort(result.begin(), result.end());
+    if (result != expected)
+    {
+      cerr << "Box " << i << ": " << result.size() << " cells instead of "
+           << expected.size() << "\n";
+      ++errors;
+    }
+  }
+
+  vtkNew<vtkPolyData> representation;
+  locator->GenerateRepresentation(-1, representation.GetPointer());
+  if (representation->GetNumberOfCells() == 0)
+  {
+    cerr << "Empty representation\n";
+    ++errors;
+  }
+
+  return errors;
+}
+
+int TestVolume(vtkMinimalStandardRandomSequence *random)
+{
+  vtkNew<vtkUnstructuredGrid> volume;
+  MakeVolume(volume.GetPointer());
+  vtkNew<vtkBVHCellLocator> locator;
+  locator->SetDataSet(volume.GetPointer());
+  locator->BuildLocator();
+
+  int errors = 0;
+  vtkIdType numCells = volume->GetNumberOfCells();
+  vtkNew<vtkGenericCell> cell;
+  double weights[VTK_CELL_SIZE];
+  for (int i = 0; i < 500; ++i)
+  {
+    double p[3], closest[3], pcoords[3], dist2;
+    int subId;
+    p[0] = Random(random, -0.1, 1.1);
+    p[1] = Random(random, -0.1, 1.1);
+    p[2] = Random(random, -0.1, 1.1);
+
+    bool expected = false;
+    for (vtkIdType cellId = 0; cellId < numCells && !expected; ++cellId)
+    {
+      double b[6];
+      volume->GetCellBounds(cellId, b);
+      if (p[0] < b[0] || p[0] > b[1] || p[1] < b[2] || p[1] > b[3] ||
+          p[2] < b[4] || p[2] > b[5])
+      {
+        continue;
+      }
+      volume->GetCell(cellId, cell.GetPointer());
+      expected = (cell->EvaluatePosition(p, closest, subId, pcoords, dist2,
+                                         weights) == 1);
+    }
+
+    vtkIdType cellId = locator->FindCell(p, 0.0, cell.GetPointer(), pcoords,
+                                         weights);
+    if (expected != (cellId >= 0))
+    {
+      cerr << "Point " << i << ": cell " << cellId << "\n";
+      ++errors;
+    }
+    else if (cellId >= 0)
+    {
+      volume->GetCell(cellId, cell.GetPointer());
+      if (cell->EvaluatePosition(p, closest, subId, pcoords, dist2,
+                                 weights) != 1)
+      {
+        cerr << "Point " << i << ": not inside cell " << cellId << "\n";
+        ++errors;
+      }
+    }
+  }
+
+  return errors;
+}
+
+} // end anon namespace
+
+int TestBVHCellLocator(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+
+  int errors = TestSurface(random.GetPointer());
+  errors += TestVolume(random.GetPointer());
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,188 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetCellPoints.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks vtkDataSet::GetCellPoints(cellId, npts, pts, ptIds) against the
+// copying GetCellPoints() from several threads, and that it leaves the
+// connectivity storage untouched.
+
+#include "vtkCellArray.h"
+#include "vtkCellType.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <atomic>
+#include <vector>
+
+namespace
+{
+
+class CheckCellPoints
+{
+public:
+  CheckCellPoints(vtkDataSet *ds, const std::vector<vtkIdType> &offsets,
+                  const std::vector<vtkIdType> &ids)
+    : DataSet(ds), Offsets(offsets), Ids(ids), Errors(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *buffer = this->Buffer.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      vtkIdType npts;
+      const vtkIdType *pts;
+      this->DataSet->GetCellPoints(cellId, npts, pts, buffer);
+      const vtkIdType *expected = &this->Ids[0] + this->Offsets[cellId];
+      if (npts != this->Offsets[cellId + 1] - this->Offsets[cellId])
+      {
+        ++this->Errors;
+        continue;
+      }
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        if (pts[i] != expected[i])
+        {
+          ++this->Errors;
+          break;
+        }
+      }
+    }
+  }
+
+  vtkDataSet *DataSet;
+  const std::vector<vtkIdType> &Offsets;
+  const std::vector<vtkIdType> &Ids;
+  vtkSMPThreadLocalObject<vtkIdList> Buffer;
+  std::atomic<int> Errors;
+};
+
+int TestDataSet(vtkDataSet *ds, const char *name,
+                vtkDataSet *reference = nullptr)
+{
+  // The reference, copied serially.
+  vtkDataSet *copied = reference ? reference : ds;
+  vtkIdType numCells = ds->GetNumberOfCells();
+  std::vector<vtkIdType> offsets(1, 0);
+  std::vector<vtkIdType> ids;
+  vtkNew<vtkIdList> cellIds;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    copied->GetCellPoints(cellId, cellIds.GetPointer());
+    ids.insert(ids.end(), cellIds->GetPointer(0),
+               cellIds->GetPointer(0) + cellIds->GetNumberOfIds());
+    offsets.push_back(static_cast<vtkIdType>(ids.size()));
+  }
+
+  CheckCellPoints check(ds, offsets, ids);
+  vtkSMPTools::For(0, numCells, 16, check);
+  if (check.Errors > 0)
+  {
+    cerr << "Error: " << check.Errors << " cells of the " << name
+         << " differ." << endl;
+    return 1;
+  }
+  return 0;
+}
+
+}
+
+int TestDataSetCellPoints(int, char*[])
+{
+  vtkNew<vtkPoints> points;
+  for (int i = 0; i < 2000; ++i)
+  {
+    points->InsertNextPoint(i, i % 17, i % 31);
+  }
+  int status = 0;
+
+  // Polygonal data mixing lines, triangles and quads, with the polygons in
+  // 32-bit storage when vtkIdType is 64-bit.
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(points.GetPointer());
+  polyData->Allocate(1000);
+  for (vtkIdType i = 0; i < 1000; ++i)
+  {
+    vtkIdType cellPts[4] = { i, i + 1, i + 2, i + 3 };
+    int type = i % 3 == 0 ? VTK_LINE : (i % 3 == 1 ? VTK_TRIANGLE : VTK_QUAD);
+    polyData->InsertNextCell(type, type == VTK_LINE ? 2 : (type == VTK_QUAD ?
+      4 : 3), cellPts);
+  }
+  polyData->GetPolys()->SetStorageToOffsets32();
+  int polysStorage = polyData->GetPolys()->GetStorage();
+  polyData->BuildCells();
+  status += TestDataSet(polyData.GetPointer(), "polydata");
+  if (polyData->GetPolys()->GetStorage() != polysStorage)
+  {
+    cerr << "Error: the polydata storage changed." << endl;
+    status++;
+  }
+
+  // The same cells without building them: the cell ids then follow the
+  // lines and the polygons. The reference builds the cells of its own.
+  vtkNew<vtkPolyData> unbuilt;
+  vtkNew<vtkPolyData> reference;
+  vtkPolyData *arrays[2] = { unbuilt.GetPointer(), reference.GetPointer() };
+  for (int i = 0; i < 2; ++i)
+  {
+    arrays[i]->SetPoints(points.GetPointer());
+    arrays[i]->SetLines(polyData->GetLines());
+    arrays[i]->SetPolys(polyData->GetPolys());
+  }
+  status += TestDataSet(unbuilt.GetPointer(), "unbuilt polydata",
+                        reference.GetPointer());
+  if (!unbuilt->NeedToBuildCells())
+  {
+    cerr << "Error: the polydata cells were built." << endl;
+    status++;
+  }
+
+  // Unstructured grids in each storage.
+  const int storages[3] = { vtkCellArray::LEGACY_STORAGE,
+    vtkCellArray::OFFSETS_STORAGE, vtkCellArray::OFFSETS32_STORAGE };
+  for (int s = 0; s < 3; ++s)
+  {
+    vtkNew<vtkUnstructuredGrid> grid;
+    grid->SetPoints(points.GetPointer());
+    grid->Allocate(1000);
+    for (vtkIdType i = 0; i < 1000; ++i)
+    {
+      vtkIdType cellPts[8] = { i, i + 1, i + 2, i + 3, i + 4, i + 5, i + 6,
+                               i + 7 };
+      grid->InsertNextCell(i % 2 ? VTK_HEXAHEDRON : VTK_TETRA, i % 2 ? 8 : 4,
+                           cellPts);
+    }
+    grid->GetCells()->SetStorage(storages[s]);
+    int storage = grid->GetCells()->GetStorage();
+    status += TestDataSet(grid.GetPointer(), "unstructured grid");
+    if (grid->GetCells()->GetStorage() != storage)
+    {
+      cerr << "Error: the unstructured grid storage changed." << endl;
+      status++;
+    }
+  }
+
+  // Implicit connectivity uses the default implementation.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(12, 11, 10);
+  status += TestDataSet(image.GetPointer(), "image data");
+
+  return status;
+}
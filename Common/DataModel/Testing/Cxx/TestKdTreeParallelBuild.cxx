@@ -0,0 +1,261 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestKdTreeParallelBuild.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the k-d trees built with several threads are the same as the
+// ones built with a single thread, both from cells and from points.
+
+#include "vtkCellType.h"
+#include "vtkIdTypeArray.h"
+#include "vtkKdTree.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+
+double Random(vtkMinimalStandardRandomSequence *random, double min, double max)
+{
+  random->Next();
+  return random->GetRangeValue(min, max);
+}
+
+// A grid of jittered hexahedra.
+void MakeVolume(vtkUnstructuredGrid *volume,
+                vtkMinimalStandardRandomSequence *random)
+{
+  const int res = 16;
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k <= res; ++k)
+  {
+    for (int j = 0; j <= res; ++j)
+    {
+      for (int i = 0; i <= res; ++i)
+      {
+        double d = 0.2 / res;
+        points->InsertNextPoint(
+          static_cast<double>(i) / res + Random(random, -d, d),
+          static_cast<double>(j) / res + Random(random, -d, d),
+          static_cast<double>(k) / res + Random(random, -d, d));
+      }
+    }
+  }
+  volume->SetPoints(points.GetPointer());
+  volume->Allocate(res * res * res);
+  const vtkIdType dj = res + 1, dk = (res + 1) * (res + 1);
+  for (int k = 0; k < res; ++k)
+  {
+    for (int j = 0; j < res; ++j)
+    {
+      for (int i = 0; i < res; ++i)
+      {
+        vtkIdType p0 = i + j * dj + k * dk;
+        vtkIdType hex[8] = { p0, p0 + 1, p0 + 1 + dj, p0 + dj,
+                             p0 + dk, p0 + 1 + dk, p0 + 1 + dj + dk,
+                             p0 + dj + dk };
+        volume->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+      }
+    }
+  }
+}
+
+// Triangles above the volume, many of them coincident so that the median
+// selection meets repeated values.
+void MakeSurface(vtkPolyData *surface,
+                 vtkMinimalStandardRandomSequence *random)
+{
+  vtkNew<vtkPoints> points;
+  surface->SetPoints(points.GetPointer());
+  surface->Allocate(3000);
+  for (int i = 0; i < 3000; ++i)
+  {
+    double x = (i % 3 ? Random(random, 0.0, 1.0) : 0.5);
+    double y = (i % 3 ? Random(random, 0.0, 1.0) : 0.5);
+    vtkIdType tri[3];
+    tri[0] = points->InsertNextPoint(x, y, 1.5);
+    tri[1] = points->InsertNextPoint(x + 0.01, y, 1.5);
+    tri[2] = points->InsertNextPoint(x, y + 0.01, 1.5);
+    surface->InsertNextCell(VTK_TRIANGLE, 3, tri);
+  }
+}
+
+int CompareRegions(vtkKdTree *serial, vtkKdTree *parallel, const char *what)
+{
+  int numRegions = serial->GetNumberOfRegions();
+  if (numRegions < 2 || parallel->GetNumberOfRegions() != numRegions)
+  {
+    cerr << what << ": " << parallel->GetNumberOfRegions()
+         << " regions instead of " << numRegions << "\n";
+    return 1;
+  }
+
+  int errors = 0;
+  for (int r = 0; r < numRegions; ++r)
+  {
+    double b0[6], b1[6], d0[6], d1[6];
+    serial->GetRegionBounds(r, b0);
+    parallel->GetRegionBounds(r, b1);
+    serial->GetRegionDataBounds(r, d0);
+    parallel->GetRegionDataBounds(r, d1);
+    for (int i = 0; i < 6; ++i)
+    {
+      if (b0[i] != b1[i] || d0[i] != d1[i])
+      {
+        cerr << what << ": the bounds of region " << r << " differ\n";
+        ++errors;
+        break;
+      }
+    }
+  }
+  return errors;
+}
+
+int TestCells(vtkMinimalStandardRandomSequence *random)
+{
+  vtkNew<vtkUnstructuredGrid> volume;
+  MakeVolume(volume.GetPointer(), random);
+  vtkNew<vtkPolyData> surface;
+  MakeSurface(surface.GetPointer(), random);
+
+  vtkNew<vtkKdTree> serial;
+  vtkNew<vtkKdTree> parallel;
+  vtkKdTree *trees[2] = { serial.GetPointer(), parallel.GetPointer() };
+  for (int i = 0; i < 2; ++i)
+  {
+    trees[i]->AddDataSet(volume.GetPointer());
+    trees[i]->AddDataSet(surface.GetPointer());
+    trees[i]->SetMinCells(4);
+  }
+  {
+    vtkSMPTools::LocalScope scope(vtkSMPTools::Config(1));
+    serial->BuildLocator();
+  }
+  parallel->BuildLocator();
+
+  int errors = CompareRegions(serial.GetPointer(), parallel.GetPointer(),
+                              "Cells");
+
+  vtkIdType numCells =
+    volume->GetNumberOfCells() + surface->GetNumberOfCells();
+  const int *serialRegions = serial->AllGetRegionContainingCell();
+  const int *parallelRegions = parallel->AllGetRegionContainingCell();
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    if (serialRegions[cellId] != parallelRegions[cellId] ||
+        serialRegions[cellId] < 0)
+    {
+      cerr << "Cell " << cellId << " is in region "
+           << parallelRegions[cellId] << " instead of "
+           << serialRegions[cellId] << "\n";
+      ++errors;
+    }
+  }
+
+  // The region of each cell is also the one found for one cell at a time
+  for (vtkIdType cellId = 0; cellId < surface->GetNumberOfCells();
+       cellId += 37)
+  {
+    int region = parallel->GetRegionContainingCell(surface.GetPointer(),
+                                                   cellId);
+    if (region != parallelRegions[volume->GetNumberOfCells() + cellId])
+    {
+      cerr << "Surface cell " << cellId << " is in region " << region
+           << "\n";
+      ++errors;
+    }
+  }
+  return errors;
+}
+
+int TestPoints(vtkMinimalStandardRandomSequence *random)
+{
+  // Random points, a tenth of them duplicated
+  const int numPoints = 20000;
+  vtkNew<vtkPoints> points;
+  for (int i = 0; i < numPoints; ++i)
+  {
+    if (i % 10 == 9)
+    {
+      points->InsertNextPoint(points->GetPoint(i - 1));
+    }
+    else
+    {
+      points->InsertNextPoint(Random(random, -1.0, 1.0),
+                              Random(random, -1.0, 1.0),
+                              Random(random, -1.0, 1.0));
+    }
+  }
+
+  vtkNew<vtkKdTree> serial;
+  vtkNew<vtkKdTree> parallel;
+  serial->SetMinCells(8);
+  parallel->SetMinCells(8);
+  {
+    vtkSMPTools::LocalScope scope(vtkSMPTools::Config(1));
+    serial->BuildLocatorFromPoints(points.GetPointer());
+  }
+  parallel->BuildLocatorFromPoints(points.GetPointer());
+
+  int errors = CompareRegions(serial.GetPointer(), parallel.GetPointer(),
+                              "Points");
+
+  for (int i = 0; i < 500; ++i)
+  {
+    double x[3] = { Random(random, -1.0, 1.0), Random(random, -1.0, 1.0),
+                    Random(random, -1.0, 1.0) };
+    double d0, d1;
+    vtkIdType p0 = serial->FindClosestPoint(x, d0);
+    vtkIdType p1 = parallel->FindClosestPoint(x, d1);
+    if (p0 != p1 || d0 != d1)
+    {
+      cerr << "Closest point " << p1 << " instead of " << p0 << "\n";
+      ++errors;
+    }
+  }
+
+  vtkIdTypeArray *map0 = serial->BuildMapForDuplicatePoints(1.0e-6);
+  vtkIdTypeArray *map1 = parallel->BuildMapForDuplicatePoints(1.0e-6);
+  for (vtkIdType i = 0; i < numPoints; ++i)
+  {
+    vtkIdType unique = map1->GetValue(i);
+    if (unique != map0->GetValue(i) || (i % 10 == 9 && unique != map1->GetValue(i - 1)))
+    {
+      cerr << "Point " << i << " is mapped to " << unique << "\n";
+      ++errors;
+      break;
+    }
+  }
+  map0->Delete();
+  map1->Delete();
+  return errors;
+}
+
+}
+
+int TestKdTreeParallelBuild(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(2017);
+
+  int errors = TestCells(random.GetPointer());
+  errors += TestPoints(random.GetPointer());
+  return (errors ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,188 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPointLocatorsBatched.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the batched queries of the point locators, which run in
+// parallel, find the same points as one query per point.
+
+#include "vtkAbstractPointLocator.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkKdTreePointLocator.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkOctreePointLocator.h"
+#include "vtkPointLocator.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticPointLocator.h"
+
+#include <cstdlib>
+
+namespace
+{
+
+bool SameList(vtkIdList *list, vtkIdTypeArray *offsets, vtkIdTypeArray *ids,
+              vtkIdType queryId)
+{
+  vtkIdType begin = offsets->GetValue(queryId);
+  vtkIdType end = offsets->GetValue(queryId + 1);
+  if (end - begin != list->GetNumberOfIds())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < list->GetNumberOfIds(); ++i)
+  {
+    if (ids && ids->GetValue(begin + i) != list->GetId(i))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+int TestLocator(vtkAbstractPointLocator *locator, vtkPolyData *data,
+                vtkPoints *queryPoints)
+{
+  int errors = 0;
+  locator->SetDataSet(data);
+  locator->BuildLocator();
+
+  vtkNew<vtkIdTypeArray> closestIds;
+  vtkNew<vtkIdTypeArray> nOffsets;
+  vtkNew<vtkIdTypeArray> nIds;
+  vtkNew<vtkIdTypeArray> rOffsets;
+  vtkNew<vtkIdTypeArray> rIds;
+  vtkNew<vtkIdTypeArray> countOffsets;
+  const int N = 7;
+  const double R = 0.08;
+  locator->FindClosestPoints(queryPoints, closestIds.GetPointer());
+  locator->FindClosestNPoints(N, queryPoints, nOffsets.GetPointer(),
+                              nIds.GetPointer());
+  locator->FindPointsWithinRadius(R, queryPoints, rOffsets.GetPointer(),
+                                  rIds.GetPointer());
+  locator->FindPointsWithinRadius(R, queryPoints, countOffsets.GetPointer(),
+                                  nullptr);
+
+  vtkIdType numQueryPts = queryPoints->GetNumberOfPoints();
+  if (closestIds->GetNumberOfValues() != numQueryPts ||
+      nOffsets->GetNumberOfValues() != numQueryPts + 1 ||
+      rOffsets->GetNumberOfValues() != numQueryPts + 1 ||
+      nIds->GetNumberOfValues() != nOffsets->GetValue(numQueryPts) ||
+      rIds->GetNumberOfValues() != rOffsets->GetValue(numQueryPts))
+  {
+    cerr << locator->GetClassName() << ": unexpected result sizes\n";
+    return 1;
+  }
+
+  vtkNew<vtkIdList> list;
+  vtkIdType numFound = 0;
+  for (vtkIdType queryId = 0; queryId < numQueryPts; ++queryId)
+  {
+    double x[3];
+    queryPoints->GetPoint(queryId, x);
+    if (closestIds->GetValue(queryId) != locator->FindClosestPoint(x))
+    {
+      ++errors;
+    }
+    locator->FindClosestNPoints(N, x, list.GetPointer());
+    if (!SameList(list.GetPointer(), nOffsets.GetPointer(),
+                  nIds.GetPointer(), queryId))
+    {
+      ++errors;
+    }
+    locator->FindPointsWithinRadius(R, x, list.GetPointer());
+    numFound += list->GetNumberOfIds();
+    if (!SameList(list.GetPointer(), rOffsets.GetPointer(),
+                  rIds.GetPointer(), queryId) ||
+        !SameList(list.GetPointer(), countOffsets.GetPointer(), nullptr,
+                  queryId))
+    {
+      ++errors;
+    }
+  }
+  if (errors || numFound == 0)
+  {
+    cerr << locator->GetClassName() << ": " << errors
+         << " batched queries differ, " << numFound
+         << " points found within the radius\n";
+    return 1;
+  }
+  return 0;
+}
+
+} // end anon namespace
+
+int TestPointLocatorsBatched(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  vtkNew<vtkPoints> points;
+  for (int i = 0; i < 5000; ++i)
+  {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      random->Next();
+      x[j] = random->GetValue();
+    }
+    points->InsertNextPoint(x);
+  }
+  vtkNew<vtkPolyData> data;
+  data->SetPoints(points.GetPointer());
+
+  // Query points inside and around the data.
+  vtkNew<vtkPoints> queryPoints;
+  for (int i = 0; i < 2000; ++i)
+  {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      random->Next();
+      x[j] = random->GetRangeValue(-0.2, 1.2);
+    }
+    queryPoints->InsertNextPoint(x);
+  }
+
+  int errors = 0;
+  vtkNew<vtkStaticPointLocator> staticLocator;
+  errors += TestLocator(staticLocator.GetPointer(), data.GetPointer(),
+                        queryPoints.GetPointer());
+  vtkNew<vtkPointLocator> pointLocator;
+  errors += TestLocator(pointLocator.GetPointer(), data.GetPointer(),
+                        queryPoints.GetPointer());
+  vtkNew<vtkKdTreePointLocator> kdTreeLocator;
+  errors += TestLocator(kdTreeLocator.GetPointer(), data.GetPointer(),
+                        queryPoints.GetPointer());
+  vtkNew<vtkOctreePointLocator> octreeLocator;
+  errors += TestLocator(octreeLocator.GetPointer(), data.GetPointer(),
+                        queryPoints.GetPointer());
+
+  // No query point at all.
+  vtkNew<vtkPoints> noPoints;
+  vtkNew<vtkIdTypeArray> offsets;
+  vtkNew<vtkIdTypeArray> ids;
+  staticLocator->FindClosestNPoints(3, noPoints.GetPointer(),
+                                    offsets.GetPointer(), ids.GetPointer());
+  if (offsets->GetNumberOfValues() != 1 || offsets->GetValue(0) != 0 ||
+      ids->GetNumberOfValues() != 0)
+  {
+    cerr << "Unexpected result without query points\n";
+    ++errors;
+  }
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -23,6 +23,8 @@
 #include "vtkSphereSource.h"
 #include "vtkTimerLog.h"
 
+#include <algorithm>
+
 // Test the building of static cell links in both unstructured and structured
 // grids.
 int TestStaticCellLinks( int, char *[] )
@@ -191,5 +193,43 @@ int TestStaticCellLinks( int, char *[] )
     return EXIT_FAILURE;
   }
 
+  //----------------------------------------------------------------------------
+  // The static links built by vtkPolyData::BuildLinks() must list the same
+  // cells, in the same order, as the editable links.
+  vtkSmartPointer<vtkPolyData> editable =
+    vtkSmartPointer<vtkPolyData>::New();
+  editable->DeepCopy(pdata);
+  editable->EditableOn();
+  editable->BuildLinks();
+  pdata->BuildLinks();
+
+  unsigned short nStatic, nEditable;
+  vtkIdType *staticCells, *editableCells;
+  for (vtkIdType ptId=0; ptId < pdata->GetNumberOfPoints(); ++ptId)
+  {
+    pdata->GetPointCells(ptId, nStatic, staticCells);
+    editable->GetPointCells(ptId, nEditable, editableCells);
+    if ( nStatic != nEditable ||
+         !std::equal(staticCells, staticCells + nStatic, editableCells) )
+    {
+      cout << "Static and editable links differ at point " << ptId << "\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // GetCellLinks() still returns editable links, rebuilt from static ones.
+  slinks.BuildLinks(ugrid);
+  ugrid->BuildLinks();
+  if ( ugrid->GetLinks()->GetType() !=
+         vtkAbstractCellLinks::STATIC_CELL_LINKS ||
+       !ugrid->GetCellLinks() ||
+       ugrid->GetLinks()->GetType() != vtkAbstractCellLinks::CELL_LINKS ||
+       ugrid->GetCellLinks()->GetNcells(0) != slinks.GetNumberOfCells(0) )
+  {
+    cout << "GetCellLinks() did not return editable links\n";
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,178 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStaticCellLocatorLines.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the batched line intersections of vtkStaticCellLocator, which
+// run in parallel and test triangles and quads in packets, find the same
+// cells as one IntersectWithLine() per line.
+
+#include "vtkCellType.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticCellLocator.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+
+// Two layers of a bumpy surface made of triangles, quads and polygons.
+void MakeSurface(vtkPolyData *surface)
+{
+  const int res = 40;
+  vtkNew<vtkPoints> points;
+  surface->SetPoints(points.GetPointer());
+  surface->Allocate(4 * res * res);
+  for (int layer = 0; layer < 2; ++layer)
+  {
+    vtkIdType offset = points->GetNumberOfPoints();
+    for (int j = 0; j <= res; ++j)
+    {
+      for (int i = 0; i <= res; ++i)
+      {
+        double x = static_cast<double>(i) / res;
+        double y = static_cast<double>(j) / res;
+        points->InsertNextPoint(x, y, 0.5 * layer + 0.1 * sin(6.0 * x) *
+                                cos(4.0 * y));
+      }
+    }
+    for (int j = 0; j < res; ++j)
+    {
+      for (int i = 0; i < res; ++i)
+      {
+        vtkIdType p0 = offset + i + j * (res + 1);
+        vtkIdType quad[4] = { p0, p0 + 1, p0 + res + 2, p0 + res + 1 };
+        vtkIdType tri0[3] = { quad[0], quad[1], quad[2] };
+        vtkIdType tri1[3] = { quad[0], quad[2], quad[3] };
+        switch ((i + j) % 3)
+        {
+          case 0:
+            surface->InsertNextCell(VTK_QUAD, 4, quad);
+            break;
+          case 1:
+            surface->InsertNextCell(VTK_TRIANGLE, 3, tri0);
+            surface->InsertNextCell(VTK_TRIANGLE, 3, tri1);
+            break;
+          default:
+            // polygons go through vtkCell::IntersectWithLine()
+            surface->InsertNextCell(VTK_POLYGON, 4, quad);
+            break;
+        }
+      }
+    }
+  }
+}
+
+} // end anon namespace
+
+int TestStaticCellLocatorLines(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkNew<vtkPolyData> surface;
+  MakeSurface(surface.GetPointer());
+  vtkNew<vtkStaticCellLocator> locator;
+  locator->SetDataSet(surface.GetPointer());
+  locator->AutomaticOn();
+  locator->BuildLocator();
+
+  // Lines crossing both layers, oblique lines, lines starting between the
+  // layers and lines lying in a layer.
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  vtkNew<vtkPoints> p1s;
+  vtkNew<vtkPoints> p2s;
+  for (int i = 0; i < 4000; ++i)
+  {
+    double a0[3], a1[3];
+    for (int j = 0; j < 2; ++j)
+    {
+      random->Next();
+      a0[j] = random->GetRangeValue(-0.1, 1.1);
+      random->Next();
+      a1[j] = (i % 2 ? random->GetRangeValue(-0.1, 1.1) : a0[j]);
+    }
+    a0[2] = (i % 5 == 0 ? 0.25 : -1.0);
+    a1[2] = (i % 7 == 0 ? a0[2] : 2.0);
+    p1s->InsertNextPoint(a0);
+    p2s->InsertNextPoint(a1);
+  }
+
+  vtkNew<vtkIdTypeArray> cellIds;
+  vtkNew<vtkDoubleArray> ts;
+  vtkNew<vtkPoints> hits;
+  const double tol = 1.0e-6;
+  locator->IntersectWithLines(p1s.GetPointer(), p2s.GetPointer(), tol,
+                              cellIds.GetPointer(), ts.GetPointer(),
+                              hits.GetPointer());
+  if (cellIds->GetNumberOfValues() != p1s->GetNumberOfPoints() ||
+      ts->GetNumberOfValues() != p1s->GetNumberOfPoints() ||
+      hits->GetNumberOfPoints() != p1s->GetNumberOfPoints())
+  {
+    cerr << "Unexpected result sizes\n";
+    return EXIT_FAILURE;
+  }
+
+  int errors = 0;
+  vtkIdType numHits = 0;
+  vtkNew<vtkGenericCell> cell;
+  for (vtkIdType i = 0; i < p1s->GetNumberOfPoints(); ++i)
+  {
+    double a0[3], a1[3], t, x[3], pcoords[3], hit[3];
+    int subId;
+    vtkIdType cellId = -1;
+    p1s->GetPoint(i, a0);
+    p2s->GetPoint(i, a1);
+    if (!locator->IntersectWithLine(a0, a1, tol, t, x, pcoords, subId,
+                                    cellId, cell.GetPointer()))
+    {
+      cellId = -1;
+    }
+    if (cellId != cellIds->GetValue(i))
+    {
+      cerr << "Line " << i << ": cell " << cellIds->GetValue(i)
+           << " instead of " << cellId << "\n";
+      ++errors;
+      continue;
+    }
+    if (cellId < 0)
+    {
+      continue;
+    }
+    ++numHits;
+    hits->GetPoint(i, hit);
+    if (fabs(ts->GetValue(i) - t) > 1.0e-9 ||
+        vtkMath::Distance2BetweenPoints(hit, x) > 1.0e-18)
+    {
+      cerr << "Line " << i << ": t " << ts->GetValue(i) << " instead of "
+           << t << "\n";
+      ++errors;
+    }
+  }
+
+  if (numHits < p1s->GetNumberOfPoints() / 2)
+  {
+    cerr << "Only " << numHits << " lines intersect the surface\n";
+    ++errors;
+  }
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
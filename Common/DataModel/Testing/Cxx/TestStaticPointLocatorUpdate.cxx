@@ -0,0 +1,205 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStaticPointLocatorUpdate.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that a vtkStaticPointLocator updated incrementally after the points
+// moved is the same as a locator built from scratch.
+
+#include "vtkIdList.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticPointLocator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+double Random(vtkMinimalStandardRandomSequence *random, double min, double max)
+{
+  random->Next();
+  return random->GetRangeValue(min, max);
+}
+
+void SortedIds(vtkIdList *list, std::vector<vtkIdType>& ids)
+{
+  ids.assign(list->GetPointer(0), list->GetPointer(0) + list->GetNumberOfIds());
+  std::sort(ids.begin(), ids.end());
+}
+
+// Move the points by up to the given distance, keeping them in the unit
+// cube. The first two points are fixed at opposite corners so that the
+// bounds do not change.
+void MovePoints(vtkPoints *points, double dist,
+                vtkMinimalStandardRandomSequence *random)
+{
+  for (vtkIdType i = 2; i < points->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    points->GetPoint(i, x);
+    for (int j = 0; j < 3; ++j)
+    {
+      x[j] = std::min(1.0, std::max(0.0, x[j] + Random(random, -dist, dist)));
+    }
+    points->SetPoint(i, x);
+  }
+  points->Modified();
+}
+
+// Compare the buckets and some queries of the two locators.
+int Compare(vtkStaticPointLocator *updated, vtkStaticPointLocator *built,
+            vtkMinimalStandardRandomSequence *random)
+{
+  int errors = 0;
+  vtkIdType numBuckets = built->GetNumberOfBuckets();
+  if (updated->GetNumberOfBuckets() != numBuckets)
+  {
+    cerr << "The locators have " << updated->GetNumberOfBuckets() << " and "
+         << numBuckets << " buckets\n";
+    return 1;
+  }
+
+  vtkNew<vtkIdList> list0, list1;
+  std::vector<vtkIdType> ids0, ids1;
+  for (vtkIdType bucket = 0; bucket < numBuckets; ++bucket)
+  {
+    updated->GetBucketIds(bucket, list0.GetPointer());
+    built->GetBucketIds(bucket, list1.GetPointer());
+    SortedIds(list0.GetPointer(), ids0);
+    SortedIds(list1.GetPointer(), ids1);
+    if (ids0 != ids1 ||
+        updated->GetNumberOfPointsInBucket(bucket) !=
+          static_cast<vtkIdType>(ids1.size()))
+    {
+      cerr << "Bucket " << bucket << " differs\n";
+      ++errors;
+      break;
+    }
+  }
+
+  for (int i = 0; i < 200; ++i)
+  {
+    double x[3] = { Random(random, -0.1, 1.1), Random(random, -0.1, 1.1),
+                    Random(random, -0.1, 1.1) };
+    if (updated->FindClosestPoint(x) != built->FindClosestPoint(x))
+    {
+      cerr << "Query " << i << ": different closest points\n";
+      ++errors;
+    }
+    updated->FindPointsWithinRadius(0.05, x, list0.GetPointer());
+    built->FindPointsWithinRadius(0.05, x, list1.GetPointer());
+    SortedIds(list0.GetPointer(), ids0);
+    SortedIds(list1.GetPointer(), ids1);
+    if (ids0 != ids1)
+    {
+      cerr << "Query " << i << ": different points within radius\n";
+      ++errors;
+    }
+  }
+  return errors;
+}
+
+int TestUpdates(int dataType, vtkMinimalStandardRandomSequence *random)
+{
+  const vtkIdType numPts = 20000;
+  vtkNew<vtkPoints> points;
+  points->SetDataType(dataType);
+  points->SetNumberOfPoints(numPts);
+  points->SetPoint(0, 0.0, 0.0, 0.0);
+  points->SetPoint(1, 1.0, 1.0, 1.0);
+  for (vtkIdType i = 2; i < numPts; ++i)
+  {
+    points->SetPoint(i, Random(random, 0.0, 1.0), Random(random, 0.0, 1.0),
+                     Random(random, 0.0, 1.0));
+  }
+  vtkNew<vtkPolyData> polydata;
+  polydata->SetPoints(points.GetPointer());
+
+  vtkNew<vtkStaticPointLocator> locator;
+  locator->SetDataSet(polydata.GetPointer());
+  locator->IncrementalUpdateOn();
+  locator->BuildLocator();
+  int errors = 0;
+  if (locator->GetNumberOfMovedPoints() != -1)
+  {
+    cerr << "The first build is incremental\n";
+    ++errors;
+  }
+
+  // Small moves are re-binned, large ones rebuild the locator
+  const double moves[4] = { 0.0, 0.001, 0.002, 0.5 };
+  for (int step = 0; step < 4; ++step)
+  {
+    if (step > 0)
+    {
+      MovePoints(points.GetPointer(), moves[step], random);
+    }
+    polydata->Modified();
+    locator->BuildLocator();
+
+    vtkIdType numMoved = locator->GetNumberOfMovedPoints();
+    bool incremental = (step < 3);
+    if ((numMoved >= 0) != incremental || (step > 0 && numMoved == 0) ||
+        numMoved > 0.25 * numPts)
+    {
+      cerr << "Step " << step << ": " << numMoved << " points moved\n";
+      ++errors;
+    }
+
+    vtkNew<vtkStaticPointLocator> built;
+    built->SetDataSet(polydata.GetPointer());
+    built->BuildLocator();
+    errors += Compare(locator.GetPointer(), built.GetPointer(), random);
+  }
+
+  // A point out of the bounds of the buckets also rebuilds the locator
+  points->SetPoint(numPts / 2, 1.5, 0.5, 0.5);
+  points->Modified();
+  locator->BuildLocator();
+  if (locator->GetNumberOfMovedPoints() != -1 ||
+      locator->FindClosestPoint(points->GetPoint(numPts / 2)) != numPts / 2)
+  {
+    cerr << "The locator was not rebuilt for a point out of bounds\n";
+    ++errors;
+  }
+
+  // So does a change of the number of points
+  points->InsertNextPoint(0.5, 0.5, 0.5);
+  points->Modified();
+  locator->BuildLocator();
+  if (locator->GetNumberOfMovedPoints() != -1 ||
+      locator->FindClosestPoint(points->GetPoint(numPts)) != numPts)
+  {
+    cerr << "The locator was not rebuilt for a new point\n";
+    ++errors;
+  }
+  return errors;
+}
+
+}
+
+int TestStaticPointLocatorUpdate(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1977);
+
+  int errors = TestUpdates(VTK_FLOAT, random.GetPointer());
+  errors += TestUpdates(VTK_DOUBLE, random.GetPointer());
+  return (errors ? EXIT_FAILURE : EXIT_SUCCESS);
+}
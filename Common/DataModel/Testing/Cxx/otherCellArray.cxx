@@ -22,8 +22,10 @@
 #include "vtkCellArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
+#include "vtkNew.h"
 #include "vtkQuad.h"
 
+#include <algorithm>
 #include <sstream>
 
 int TestCellArray(ostream& strm)
@@ -81,8 +83,239 @@ int TestCellArray(ostream& strm)
   return 0;
 }
 
+// Compare the cells of two arrays through the traversal, location and
+// cell id interfaces.
+static int CompareCells(vtkCellArray *a, vtkCellArray *b)
+{
+  if (a->GetNumberOfCells() != b->GetNumberOfCells() ||
+      a->GetNumberOfConnectivityEntries() !=
+        b->GetNumberOfConnectivityEntries() ||
+      a->GetMaxCellSize() != b->GetMaxCellSize())
+  {
+    return 1;
+  }
+  vtkIdType nptsA, *ptsA, nptsB, *ptsB;
+  vtkIdType cellId = 0;
+  vtkNew<vtkIdList> ids;
+  a->InitTraversal();
+  b->InitTraversal();
+  while (a->GetNextCell(nptsA, ptsA))
+  {
+    if (!b->GetNextCell(nptsB, ptsB) || nptsA != nptsB ||
+        a->GetTraversalLocation() != b->GetTraversalLocation())
+    {
+      return 1;
+    }
+    // Check the copying accessors with 32-bit storage, the pointer ones
+    // otherwise.
+    vtkIdType loc = a->GetTraversalLocation(nptsA);
+    if (b->GetStorage() == vtkCellArray::OFFSETS32_STORAGE)
+    {
+      b->GetCell(loc, ids);
+    }
+    else
+    {
+      b->GetCell(loc, nptsB, ptsB);
+      ids->SetNumberOfIds(nptsB);
+      std::copy(ptsB, ptsB + nptsB, ids->GetPointer(0));
+    }
+    if (ids->GetNumberOfIds() != nptsA || b->GetCellSize(cellId) != nptsA)
+    {
+      return 1;
+    }
+    for (vtkIdType i = 0; i < nptsA; i++)
+    {
+      if (ptsA[i] != ids->GetId(i))
+      {
+        return 1;
+      }
+    }
+    b->GetCellAtId(cellId, ids);
+    for (vtkIdType i = 0; i < nptsA; i++)
+    {
+      if (ptsA[i] != ids->GetId(i))
+      {
+        return 1;
+      }
+    }
+    cellId++;
+  }
+  return b->GetNextCell(nptsB, ptsB);
+}
+
+static int TestOffsetsStorage()
+{
+  vtkCellArray *legacy = vtkCellArray::New();
+  vtkCellArray *offsets = vtkCellArray::New();
+  offsets->SetStorageToOffsets();
+
+  // Cells of varying sizes, including an empty one, built with both
+  // insertion interfaces.
+  vtkIdType pts[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+  for (vtkIdType i = 0; i < 100; i++)
+  {
+    legacy->InsertNextCell(i % 9, pts);
+    offsets->InsertNextCell(i % 9, pts);
+  }
+  legacy->InsertNextCell(5);
+  offsets->InsertNextCell(5);
+  for (vtkIdType i = 0; i < 3; i++)
+  {
+    legacy->InsertCellPoint(i + 10);
+    offsets->InsertCellPoint(i + 10);
+  }
+  legacy->UpdateCellCount(3);
+  offsets->UpdateCellCount(3);
+  legacy->InsertNextCell(2, pts);
+  offsets->InsertNextCell(2, pts);
+
+  if (offsets->GetStorage() != vtkCellArray::OFFSETS_STORAGE ||
+      offsets->GetNumberOfConnectivityIds() !=
+        offsets->GetNumberOfConnectivityEntries() -
+          offsets->GetNumberOfCells() ||
+      CompareCells(legacy, offsets))
+  {
+    cerr << "Error: offsets storage differs from legacy storage" << endl;
+    return 1;
+  }
+
+  // Locations address the same cells in both storages.
+  vtkIdType loc = legacy->GetInsertLocation(2);
+  if (offsets->GetInsertLocation(2) != loc)
+  {
+    cerr << "Error: insert locations differ" << endl;
+    return 1;
+  }
+  vtkIdType reversed[5] = {4, 3, 2, 1, 0};
+  legacy->ReplaceCell(loc, 2, reversed);
+  offsets->ReplaceCell(loc, 2, reversed);
+  legacy->ReverseCell(legacy->GetInsertLocation(2) - 4);
+  offsets->ReverseCell(offsets->GetInsertLocation(2) - 4);
+  if (CompareCells(legacy, offsets))
+  {
+    cerr << "Error: ReplaceCell/ReverseCell differ" << endl;
+    return 1;
+  }
+
+  // Converting back and forth preserves the cells and the traversal.
+  vtkCellArray *copy = vtkCellArray::New();
+  copy->DeepCopy(offsets);
+  copy->InitTraversal();
+  vtkIdType npts, *ppts;
+  copy->GetNextCell(npts, ppts);
+  copy->GetNextCell(npts, ppts);
+  vtkIdType traversal = copy->GetTraversalLocation();
+  vtkIdType numEntries = legacy->GetNumberOfConnectivityEntries();
+  vtkIdType *legacyCells = copy->GetPointer();
+  if (copy->GetStorage() != vtkCellArray::OFFSETS_STORAGE ||
+      copy->GetData()->GetNumberOfTuples() != numEntries ||
+      !std::equal(legacyCells, legacyCells + numEntries,
+                  legacy->GetPointer()))
+  {
+    cerr << "Error: legacy copy of offsets storage differs" << endl;
+    return 1;
+  }
+  copy->SetStorageToLegacy();
+  if (copy->GetStorage() != vtkCellArray::LEGACY_STORAGE ||
+      copy->GetTraversalLocation() != traversal ||
+      CompareCells(legacy, copy))
+  {
+    cerr << "Error: conversion to legacy storage failed" << endl;
+    return 1;
+  }
+  legacy->SetStorageToOffsets();
+  if (CompareCells(copy, legacy))
+  {
+    cerr << "Error: conversion to offsets storage failed" << endl;
+    return 1;
+  }
+
+  // Cells given as offsets and connectivity arrays.
+  vtkIdTypeArray *offsetsArray = vtkIdTypeArray::New();
+  vtkIdTypeArray *connArray = vtkIdTypeArray::New();
+  vtkIdType offsetValues[4] = {0, 3, 7, 8};
+  vtkIdType connValues[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+  for (int i = 0; i < 4; i++)
+  {
+    offsetsArray->InsertNextValue(offsetValues[i]);
+  }
+  for (int i = 0; i < 8; i++)
+  {
+    connArray->InsertNextValue(connValues[i]);
+  }
+  copy->SetData(offsetsArray, connArray);
+  vtkIdList *ids = vtkIdList::New();
+  copy->GetCellAtId(1, ids);
+  if (copy->GetNumberOfCells() != 3 || ids->GetNumberOfIds() != 4 ||
+      ids->GetId(0) != 3 || copy->GetData()->GetValue(4) != 4)
+  {
+    cerr << "Error: SetData failed" << endl;
+    return 1;
+  }
+
+  // 32-bit storage is read without widening and widens when an id does not
+  // fit, or when a vtkIdType pointer to a cell is requested.
+  vtkCellArray *offsets32 = vtkCellArray::New();
+  offsets32->DeepCopy(offsets);
+  offsets32->SetStorageToOffsets32();
+  vtkIdType expectedStorage = vtkCellArray::OFFSETS32_STORAGE;
+#if VTK_SIZEOF_ID_TYPE == 4
+  expectedStorage = vtkCellArray::OFFSETS_STORAGE;
+#endif
+  if (!offsets32->CanConvertTo32BitStorage() ||
+      offsets32->GetStorage() != expectedStorage ||
+      CompareCells(offsets, offsets32))
+  {
+    cerr << "Error: 32-bit offsets storage differs" << endl;
+    return 1;
+  }
+  offsets32->GetCellAtId(3, ids);
+  offsets32->InsertNextCell(ids);
+  offsets->InsertNextCell(ids);
+  // A pointer to a cell reads the legacy copy, which is refreshed when the
+  // cells change.
+  offsets32->GetCellAtId(offsets32->GetNumberOfCells() - 1, npts, ppts);
+  if (offsets32->GetStorage() != expectedStorage ||
+      npts != ids->GetNumberOfIds() ||
+      !std::equal(ppts, ppts + npts, ids->GetPointer(0)))
+  {
+    cerr << "Error: 32-bit cell pointer differs" << endl;
+    return 1;
+  }
+  offsets32->InsertNextCell(npts, ppts);
+  offsets->InsertNextCell(ids);
+  if (offsets32->GetStorage() != expectedStorage ||
+      offsets32->GetMaxCellSize() != offsets->GetMaxCellSize() ||
+      CompareCells(offsets, offsets32))
+  {
+    cerr << "Error: 32-bit insertion failed" << endl;
+    return 1;
+  }
+#if VTK_SIZEOF_ID_TYPE == 8
+  vtkIdType large[2] = {1, VTK_TYPE_INT32_MAX + vtkIdType(1)};
+  offsets32->InsertNextCell(2, large);
+  offsets->InsertNextCell(2, large);
+  if (offsets32->GetStorage() != vtkCellArray::OFFSETS_STORAGE ||
+      offsets32->CanConvertTo32BitStorage() ||
+      CompareCells(offsets, offsets32))
+  {
+    cerr << "Error: 32-bit storage did not widen" << endl;
+    return 1;
+  }
+#endif
+
+  offsets32->Delete();
+  ids->Delete();
+  offsetsArray->Delete();
+  connArray->Delete();
+  copy->Delete();
+  legacy->Delete();
+  offsets->Delete();
+  return 0;
+}
+
 int otherCellArray(int,char *[])
 {
   std::ostringstream vtkmsg_with_warning_C4701;
-  return TestCellArray(vtkmsg_with_warning_C4701);
+  return TestCellArray(vtkmsg_with_warning_C4701) || TestOffsetsStorage();
 }
@@ -19,6 +19,7 @@
 
 //----------------------------------------------------------------------------
 vtkAbstractCellLinks::vtkAbstractCellLinks()
+  : Type(vtkAbstractCellLinks::LINKS_NOT_DEFINED)
 {
 }
 
@@ -54,4 +55,6 @@ GetIdType(vtkIdType maxPtId, vtkIdType maxCellId, vtkCellArray *ca)
 void vtkAbstractCellLinks::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Type: " << this->Type << "\n";
 }
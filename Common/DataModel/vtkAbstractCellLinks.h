@@ -55,6 +55,42 @@ public:
    */
   virtual void BuildLinks(vtkDataSet *data) = 0;
 
+  /**
+   * The concrete type of the links, one of the values below. This allows
+   * datasets to dispatch to the non-virtual, inline accessors of the
+   * subclasses without a SafeDownCast().
+   */
+  enum LinksTypes
+  {
+    LINKS_NOT_DEFINED = 0,
+    CELL_LINKS = 1,
+    STATIC_CELL_LINKS = 2
+  };
+  int GetType()
+    { return this->Type; }
+
+  /**
+   * Release the memory held by the links. Does nothing by default.
+   */
+  virtual void Initialize() {}
+
+  /**
+   * Reclaim any unused memory. Does nothing by default.
+   */
+  virtual void Squeeze() {}
+
+  /**
+   * Reset to a state of no entries without freeing the memory. Does
+   * nothing by default.
+   */
+  virtual void Reset() {}
+
+  /**
+   * Return the memory in kibibytes (1024 bytes) consumed by the links, 0
+   * by default.
+   */
+  virtual unsigned long GetActualMemorySize() { return 0; }
+
   /**
    * Based on the input (i.e., number of points, number of cells, and length
    * of connectivity array) this helper method returns the integral type to
@@ -70,6 +106,8 @@ protected:
   vtkAbstractCellLinks();
   ~vtkAbstractCellLinks() VTK_OVERRIDE;
 
+  int Type;
+
 private:
   vtkAbstractCellLinks(const vtkAbstractCellLinks&) VTK_DELETE_FUNCTION;
   void operator=(const vtkAbstractCellLinks&) VTK_DELETE_FUNCTION;
@@ -16,6 +16,174 @@
 
 #include "vtkDataSet.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkPoints.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+// Finds the closest point of each query point.
+struct vtkClosestPointsQuery
+{
+  vtkAbstractPointLocator *Locator;
+  vtkPoints *QueryPoints;
+  vtkIdType *ClosestIds;
+
+  void operator()(vtkIdType queryId, vtkIdType endQueryId)
+  {
+    double x[3];
+    for (; queryId < endQueryId; ++queryId)
+    {
+      this->QueryPoints->GetPoint(queryId, x);
+      this->ClosestIds[queryId] = this->Locator->FindClosestPoint(x);
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Finds the N closest points of each query point, or the points within a
+// radius when N is negative. The number of points found is stored in
+// Counts. Each thread appends the points it finds to its own buffer and
+// records the ranges of query points it processed, so that the buffers can
+// then be copied to their place in the ids.
+struct vtkPointLists
+{
+  std::vector<vtkIdType> Ids;
+  std::vector<vtkIdType> Ranges;
+};
+
+struct vtkPointListsQuery
+{
+  vtkAbstractPointLocator *Locator;
+  vtkPoints *QueryPoints;
+  int N;
+  double Radius;
+  vtkIdType *Counts;
+  bool KeepIds;
+
+  vtkSMPThreadLocalObject<vtkIdList> Result;
+  vtkSMPThreadLocal<vtkPointLists> Lists;
+
+  vtkPointListsQuery(vtkAbstractPointLocator *locator, vtkPoints *queryPoints,
+                     int n, double radius, vtkIdType *counts, bool keepIds) :
+    Locator(locator), QueryPoints(queryPoints), N(n), Radius(radius),
+    Counts(counts), KeepIds(keepIds)
+  {
+  }
+
+  void Initialize()
+  {
+    this->Result.Local()->Allocate(128);
+  }
+
+  void operator()(vtkIdType queryId, vtkIdType endQueryId)
+  {
+    vtkIdList *result = this->Result.Local();
+    vtkPointLists &lists = this->Lists.Local();
+    if (this->KeepIds)
+    {
+      lists.Ranges.push_back(queryId);
+      lists.Ranges.push_back(endQueryId);
+    }
+
+    double x[3];
+    for (; queryId < endQueryId; ++queryId)
+    {
+      this->QueryPoints->GetPoint(queryId, x);
+      if (this->N >= 0)
+      {
+        this->Locator->FindClosestNPoints(this->N, x, result);
+      }
+      else
+      {
+        this->Locator->FindPointsWithinRadius(this->Radius, x, result);
+      }
+      vtkIdType numIds = result->GetNumberOfIds();
+      this->Counts[queryId] = numIds;
+      if (this->KeepIds && numIds > 0)
+      {
+        lists.Ids.insert(lists.Ids.end(), result->GetPointer(0),
+                   result->GetPointer(0) + numIds);
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Copies the ids found for each range of query points from the buffer of the
+// thread that processed it.
+struct vtkPointListsCopy
+{
+  const vtkIdType *Offsets;
+  vtkIdType *Ids;
+  std::vector<vtkIdType> Ranges;
+  std::vector<const vtkIdType*> Sources;
+
+  void operator()(vtkIdType range, vtkIdType endRange)
+  {
+    for (; range < endRange; ++range)
+    {
+      const vtkIdType *begin = this->Offsets + this->Ranges[2*range];
+      const vtkIdType *end = this->Offsets + this->Ranges[2*range + 1];
+      std::copy(this->Sources[range], this->Sources[range] + (*end - *begin),
+                this->Ids + *begin);
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+void vtkFindPointLists(vtkAbstractPointLocator *locator, int N, double R,
+                       vtkPoints *queryPoints, vtkIdTypeArray *offsets,
+                       vtkIdTypeArray *ids)
+{
+  vtkIdType numQueryPts = queryPoints->GetNumberOfPoints();
+  offsets->SetNumberOfComponents(1);
+  offsets->SetNumberOfValues(numQueryPts + 1);
+  vtkIdType *offsetsPtr = offsets->GetPointer(0);
+
+  vtkPointListsQuery query(locator, queryPoints, N, R, offsetsPtr,
+                           ids != nullptr);
+  vtkSMPTools::For(0, numQueryPts, query);
+  offsetsPtr[numQueryPts] = vtkSMPTools::ExclusiveScan(
+    offsetsPtr, offsetsPtr + numQueryPts, offsetsPtr, vtkIdType(0));
+  if (!ids)
+  {
+    return;
+  }
+
+  vtkPointListsCopy copy;
+  copy.Offsets = offsetsPtr;
+  ids->SetNumberOfComponents(1);
+  ids->SetNumberOfValues(offsetsPtr[numQueryPts]);
+  copy.Ids = ids->GetPointer(0);
+  vtkSMPThreadLocal<vtkPointLists>::iterator itr = query.Lists.begin();
+  for (; itr != query.Lists.end(); ++itr)
+  {
+    const std::vector<vtkIdType> &ranges = itr->Ranges;
+    const vtkIdType *source = itr->Ids.empty() ? nullptr : &itr->Ids[0];
+    for (size_t i = 0; i < ranges.size(); i += 2)
+    {
+      copy.Ranges.push_back(ranges[i]);
+      copy.Ranges.push_back(ranges[i + 1]);
+      copy.Sources.push_back(source);
+      source += offsetsPtr[ranges[i + 1]] - offsetsPtr[ranges[i]];
+    }
+  }
+  vtkSMPTools::For(0, static_cast<vtkIdType>(copy.Sources.size()), copy);
+}
+
+} // end anon namespace
 
 
 //-----------------------------------------------------------------------------
@@ -68,6 +236,38 @@ void vtkAbstractPointLocator::FindPointsWithinRadius(double R, double x,
   this->FindPointsWithinRadius(R,p,result);
 }
 
+//-----------------------------------------------------------------------------
+void vtkAbstractPointLocator::FindClosestPoints(vtkPoints *queryPoints,
+                                                vtkIdTypeArray *closestIds)
+{
+  this->BuildLocator();
+  vtkIdType numQueryPts = queryPoints->GetNumberOfPoints();
+  closestIds->SetNumberOfComponents(1);
+  closestIds->SetNumberOfValues(numQueryPts);
+  vtkClosestPointsQuery query = { this, queryPoints,
+                                  closestIds->GetPointer(0) };
+  vtkSMPTools::For(0, numQueryPts, query);
+}
+
+//-----------------------------------------------------------------------------
+void vtkAbstractPointLocator::FindClosestNPoints(int N, vtkPoints *queryPoints,
+                                                 vtkIdTypeArray *offsets,
+                                                 vtkIdTypeArray *ids)
+{
+  this->BuildLocator();
+  vtkFindPointLists(this, std::max(N, 0), 0.0, queryPoints, offsets, ids);
+}
+
+//-----------------------------------------------------------------------------
+void vtkAbstractPointLocator::FindPointsWithinRadius(double R,
+                                                     vtkPoints *queryPoints,
+                                                     vtkIdTypeArray *offsets,
+                                                     vtkIdTypeArray *ids)
+{
+  this->BuildLocator();
+  vtkFindPointLists(this, -1, R, queryPoints, offsets, ids);
+}
+
 //-----------------------------------------------------------------------------
 void vtkAbstractPointLocator::GetBounds(double* bnds)
 {
@@ -34,6 +34,8 @@
 #include "vtkLocator.h"
 
 class vtkIdList;
+class vtkIdTypeArray;
+class vtkPoints;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkAbstractPointLocator : public vtkLocator
 {
@@ -93,6 +95,34 @@ public:
                                       vtkIdList *result);
   //@}
 
+  //@{
+  /**
+   * Batched versions of FindClosestPoint(), FindClosestNPoints() and
+   * FindPointsWithinRadius(), which answer the query for every point of
+   * queryPoints. The closest point of the i-th query point is
+   * closestIds[i]. The points found for the i-th query point by the two
+   * other methods are ids[offsets[i]] to ids[offsets[i+1]-1], so offsets has
+   * one more value than there are query points. When ids is nullptr only
+   * the offsets are computed, which is enough to count the points. The
+   * locator is built from the calling thread, then the queries run in
+   * parallel with vtkSMPTools.
+   *
+   * These methods call the single point queries of the subclass from
+   * several threads, so they require them to be thread safe once the
+   * locator is built. This holds for vtkPointLocator, vtkStaticPointLocator,
+   * vtkOctreePointLocator and vtkKdTreePointLocator; it has not been checked
+   * for vtkIncrementalOctreePointLocator. The ids found for all the query
+   * points are kept in memory at once: callers with many query points and
+   * many neighbors per point should rather run the single point queries
+   * from their own threads.
+   */
+  void FindClosestPoints(vtkPoints *queryPoints, vtkIdTypeArray *closestIds);
+  void FindClosestNPoints(int N, vtkPoints *queryPoints,
+                          vtkIdTypeArray *offsets, vtkIdTypeArray *ids);
+  void FindPointsWithinRadius(double R, vtkPoints *queryPoints,
+                              vtkIdTypeArray *offsets, vtkIdTypeArray *ids);
+  //@}
+
   /**
    * Provide an accessor to the bounds.
    */
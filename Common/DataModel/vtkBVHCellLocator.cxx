@@ -0,0 +1,1405 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBVHCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkBVHCellLocator.h"
+
+#include "vtkCellArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+vtkStandardNewMacro(vtkBVHCellLocator);
+
+//----------------------------------------------------------------------------
+// Helper classes to support efficient computing, and threaded execution.
+//
+// The hierarchy is built top down. Each node owns a contiguous range of a
+// permuted array of cell ids. To split a node, the centers of its cells are
+// binned along the longest axis of their bounding box, and the split between
+// two bins that minimizes the surface area heuristic (the sum over the two
+// children of their surface area times their number of cells) is selected,
+// unless keeping the cells in a leaf is cheaper. The range is then
+// partitioned so that the cells of each child are contiguous.
+//
+// The construction has two phases. The few nodes at the top of the tree have
+// many cells: they are split one at a time, and the bounds, binning and
+// partition of their cells are computed in parallel (the partition with a
+// prefix sum). Once the nodes are small enough, there are many of them, and
+// the subtrees rooted at them are built concurrently, each one serially into
+// its own array of nodes. These arrays are finally appended to the array of
+// the top nodes, renumbering the children.
+//
+// The two children of a node are stored next to each other so that a node
+// only needs the index of its first child, which keeps the nodes at 32 bytes.
+
+namespace {
+
+// Relative cost of traversing a node with respect to testing a cell, used
+// by the surface area heuristic.
+const double VTK_BVH_TRAVERSAL_COST = 1.0;
+
+// Leaves cannot hold more cells than fit in a node.
+const int VTK_BVH_MAX_LEAF_SIZE = 65535;
+
+// Size of the traversal stacks that are not allocated on the heap.
+const int VTK_BVH_STACK_SIZE = 64;
+
+// Maximum number of bins of the surface area heuristic.
+const int VTK_BVH_MAX_BINS = 256;
+
+// Bounds are rounded outwards when stored in single precision, so that the
+// boxes of the nodes always contain the boxes of their cells.
+inline float vtkRoundDown(double v)
+{
+  if ( v <= -FLT_MAX )
+  {
+    return -std::numeric_limits<float>::infinity();
+  }
+  float f = static_cast<float>(v);
+  return ( f > v ? std::nextafter(f, -std::numeric_limits<float>::infinity()) : f );
+}
+
+inline float vtkRoundUp(double v)
+{
+  if ( v >= FLT_MAX )
+  {
+    return std::numeric_limits<float>::infinity();
+  }
+  float f = static_cast<float>(v);
+  return ( f < v ? std::nextafter(f, std::numeric_limits<float>::infinity()) : f );
+}
+
+inline void vtkInitializeBounds(double bounds[6])
+{
+  bounds[0] = bounds[2] = bounds[4] = VTK_DOUBLE_MAX;
+  bounds[1] = bounds[3] = bounds[5] = -VTK_DOUBLE_MAX;
+}
+
+inline void vtkAddBounds(double bounds[6], const double b[6])
+{
+  for (int i=0; i < 3; ++i)
+  {
+    bounds[2*i] = std::min(bounds[2*i], b[2*i]);
+    bounds[2*i+1] = std::max(bounds[2*i+1], b[2*i+1]);
+  }
+}
+
+inline void vtkAddPoint(double bounds[6], const double x[3])
+{
+  for (int i=0; i < 3; ++i)
+  {
+    bounds[2*i] = std::min(bounds[2*i], x[i]);
+    bounds[2*i+1] = std::max(bounds[2*i+1], x[i]);
+  }
+}
+
+// Surface area of a box (up to a factor 2), zero if it is empty.
+inline double vtkHalfArea(const double bounds[6])
+{
+  double dx = bounds[1] - bounds[0];
+  double dy = bounds[3] - bounds[2];
+  double dz = bounds[5] - bounds[4];
+  if ( dx < 0.0 || dy < 0.0 || dz < 0.0 )
+  {
+    return 0.0;
+  }
+  return dx*dy + dy*dz + dz*dx;
+}
+
+// Squared distance from a point to a box, zero if the point is inside.
+template <typename TBounds>
+inline double vtkDistance2ToBounds(const double x[3], const TBounds *bounds)
+{
+  double dist2 = 0.0;
+  for (int i=0; i < 3; ++i)
+  {
+    double d = 0.0;
+    if ( x[i] < bounds[2*i] )
+    {
+      d = bounds[2*i] - x[i];
+    }
+    else if ( x[i] > bounds[2*i+1] )
+    {
+      d = x[i] - bounds[2*i+1];
+    }
+    dist2 += d*d;
+  }
+  return dist2;
+}
+
+// Clip the line a0 + t*(a1-a0) with a box expanded by tol. invDir is the
+// inverse of a1-a0 (with VTK_DOUBLE_MAX for the null components). Returns
+// whether some t in [0,tMax] is inside the box, and the first such t.
+template <typename TBounds>
+inline bool vtkClipLine(const TBounds *bounds, const double a0[3],
+                        const double invDir[3], double tol, double tMax,
+                        double &tEntry)
+{
+  double t0 = 0.0, t1 = tMax;
+  for (int i=0; i < 3; ++i)
+  {
+    double tNear = (bounds[2*i] - tol - a0[i]) * invDir[i];
+    double tFar = (bounds[2*i+1] + tol - a0[i]) * invDir[i];
+    if ( tNear > tFar )
+    {
+      std::swap(tNear, tFar);
+    }
+    t0 = ( tNear > t0 ? tNear : t0 );
+    t1 = ( tFar < t1 ? tFar : t1 );
+    if ( t0 > t1 )
+    {
+      return false;
+    }
+  }
+  tEntry = t0;
+  return true;
+}
+
+inline bool vtkOverlaps(const double *bbox, const double *bounds)
+{
+  return ( bounds[0] <= bbox[1] && bounds[1] >= bbox[0] &&
+           bounds[2] <= bbox[3] && bounds[3] >= bbox[2] &&
+           bounds[4] <= bbox[5] && bounds[5] >= bbox[4] );
+}
+
+inline bool vtkOverlaps(const double *bbox, const float *bounds)
+{
+  return ( bounds[0] <= bbox[1] && bounds[1] >= bbox[0] &&
+           bounds[2] <= bbox[3] && bounds[3] >= bbox[2] &&
+           bounds[4] <= bbox[5] && bounds[5] >= bbox[4] );
+}
+
+// The traversal stack. It lives on the stack of the caller unless the tree
+// is unusually deep.
+template <typename T>
+class vtkBVHStack
+{
+public:
+  vtkBVHStack(int depth) : Size(0)
+  {
+    if ( depth + 2 > VTK_BVH_STACK_SIZE )
+    {
+      this->Heap.resize(depth + 2);
+      this->Data = &this->Heap[0];
+    }
+    else
+    {
+      this->Data = this->Local;
+    }
+  }
+  void Push(const T &item) { this->Data[this->Size++] = item; }
+  T Pop() { return this->Data[--this->Size]; }
+  bool IsEmpty() const { return this->Size == 0; }
+
+private:
+  T Local[VTK_BVH_STACK_SIZE];
+  std::vector<T> Heap;
+  T *Data;
+  int Size;
+};
+
+// A node of the traversal stack, with its distance to the query.
+struct vtkBVHStackItem
+{
+  int Node;
+  double Distance;
+};
+
+// The weights passed to vtkCell::EvaluatePosition(), grown as needed.
+class vtkBVHWeights
+{
+public:
+  vtkBVHWeights() : Size(16) { this->Data = this->Local; }
+  double *Get(int numPts)
+  {
+    if ( numPts > this->Size )
+    {
+      this->Heap.resize(2*numPts);
+      this->Size = 2*numPts;
+      this->Data = &this->Heap[0];
+    }
+    return this->Data;
+  }
+
+private:
+  double Local[16];
+  std::vector<double> Heap;
+  double *Data;
+  int Size;
+};
+
+} // anonymous namespace
+
+//----------------------------------------------------------------------------
+// A node of the hierarchy. The bounds are stored in single precision, rounded
+// outwards. A leaf holds Count > 0 cells, whose ids are CellIds[Offset] ...
+// CellIds[Offset+Count-1]. An interior node has Count == 0; its children are
+// the nodes Offset and Offset+1, and Axis is the axis it was split along.
+struct vtkBVHNode
+{
+  float Bounds[6];
+  int Offset;
+  unsigned short Count;
+  unsigned char Axis;
+  unsigned char Pad;
+
+  bool IsLeaf() const
+    {return this->Count > 0;}
+  void SetBounds(const double bounds[6])
+  {
+    for (int i=0; i < 3; ++i)
+    {
+      this->Bounds[2*i] = vtkRoundDown(bounds[2*i]);
+      this->Bounds[2*i+1] = vtkRoundUp(bounds[2*i+1]);
+    }
+  }
+  void MakeLeaf(vtkIdType begin, vtkIdType end)
+  {
+    this->Offset = static_cast<int>(begin);
+    this->Count = static_cast<unsigned short>(end - begin);
+    this->Axis = 0;
+    this->Pad = 0;
+  }
+  void MakeNode(int firstChild, int axis)
+  {
+    this->Offset = firstChild;
+    this->Count = 0;
+    this->Axis = static_cast<unsigned char>(axis);
+    this->Pad = 0;
+  }
+};
+
+//----------------------------------------------------------------------------
+// PIMPLd class which holds the hierarchy and implements the queries.
+struct vtkBVHTree
+{
+  vtkDataSet *DataSet;
+  double (*CellBounds)[6];
+  std::vector<vtkBVHNode> Nodes;
+  std::vector<vtkIdType> CellIds;
+  int Depth;
+
+  vtkBVHTree(vtkDataSet *ds, double (*cellBounds)[6]) :
+    DataSet(ds), CellBounds(cellBounds), Depth(0)
+  {
+  }
+
+  vtkIdType FindCell(double x[3], vtkGenericCell *cell, double pcoords[3],
+                     double *weights) const;
+  void FindCellsWithinBounds(double *bbox, vtkIdList *cells) const;
+  int IntersectWithLine(double a0[3], double a1[3], double tol, double &t,
+                        double x[3], double pcoords[3], int &subId,
+                        vtkIdType &cellId, vtkGenericCell *cell) const;
+  int FindClosestPoint(double x[3], double radius2, double closestPoint[3],
+                       vtkGenericCell *cell, vtkIdType &cellId, int &subId,
+                       double &dist2, int &inside) const;
+};
+
+//----------------------------------------------------------------------------
+// Bins of the surface area heuristic.
+struct vtkBVHBin
+{
+  double Bounds[6];
+  vtkIdType Count;
+
+  void Initialize()
+  {
+    vtkInitializeBounds(this->Bounds);
+    this->Count = 0;
+  }
+  void Add(const vtkBVHBin &bin)
+  {
+    vtkAddBounds(this->Bounds, bin.Bounds);
+    this->Count += bin.Count;
+  }
+};
+
+//----------------------------------------------------------------------------
+// The data shared by the construction of all the nodes. Ids is the permuted
+// array of cell ids, Centers holds the center of the bounds of each cell.
+struct vtkBVHBuilder
+{
+  double (*CellBounds)[6];
+  const double *Centers;
+  vtkIdType *Ids;
+  int NumberOfBins;
+  int MaxLeafSize;
+
+  // Binning along an axis of a box of centers
+  struct Binning
+  {
+    int Axis;
+    double Min;
+    double Scale;
+    int NumberOfBins;
+
+    int GetBin(const double *center) const
+    {
+      int bin = static_cast<int>((center[this->Axis] - this->Min) * this->Scale);
+      return ( bin < 0 ? 0 : (bin >= this->NumberOfBins ? this->NumberOfBins-1 : bin) );
+    }
+  };
+
+  // Bounds of the cells [begin,end), and of their centers.
+  void ComputeBounds(vtkIdType begin, vtkIdType end, double bounds[6],
+                     double centerBounds[6]) const
+  {
+    for ( ; begin < end; ++begin )
+    {
+      vtkIdType cellId = this->Ids[begin];
+      vtkAddBounds(bounds, this->CellBounds[cellId]);
+      vtkAddPoint(centerBounds, this->Centers + 3*cellId);
+    }
+  }
+
+  // Bounds of the centers of the cells [begin,end).
+  void ComputeCenterBounds(vtkIdType begin, vtkIdType end,
+                           double centerBounds[6]) const
+  {
+    for ( ; begin < end; ++begin )
+    {
+      vtkAddPoint(centerBounds, this->Centers + 3*this->Ids[begin]);
+    }
+  }
+
+  // Add the cells [begin,end) to the bins.
+  void Bin(vtkIdType begin, vtkIdType end, const Binning &binning,
+           vtkBVHBin *bins) const
+  {
+    for ( ; begin < end; ++begin )
+    {
+      vtkIdType cellId = this->Ids[begin];
+      vtkBVHBin &bin = bins[binning.GetBin(this->Centers + 3*cellId)];
+      vtkAddBounds(bin.Bounds, this->CellBounds[cellId]);
+      bin.Count++;
+    }
+  }
+
+  // Select the split of a node. Returns false if the cells should stay in a
+  // leaf; otherwise the binning, the bin after which to split, and the
+  // bounds and number of cells of the two children are returned.
+  bool SelectSplit(vtkIdType numCells, const double bounds[6],
+                   const Binning &binning, const vtkBVHBin *bins,
+                   int &splitBin, vtkBVHBin &left, vtkBVHBin &right) const
+  {
+    int numBins = binning.NumberOfBins;
+    double rightCost[VTK_BVH_MAX_BINS];
+    vtkBVHBin accum;
+    accum.Initialize();
+    for (int i=numBins-1; i > 0; --i)
+    {
+      accum.Add(bins[i]);
+      rightCost[i] = vtkHalfArea(accum.Bounds) * accum.Count;
+    }
+
+    double bestCost = VTK_DOUBLE_MAX;
+    splitBin = -1;
+    accum.Initialize();
+    for (int i=0; i < numBins-1; ++i)
+    {
+      accum.Add(bins[i]);
+      if ( accum.Count > 0 && accum.Count < numCells )
+      {
+        double cost = vtkHalfArea(accum.Bounds) * accum.Count + rightCost[i+1];
+        if ( cost < bestCost )
+        {
+          bestCost = cost;
+          splitBin = i;
+        }
+      }
+    }
+    if ( splitBin < 0 )
+    {
+      return false;
+    }
+
+    // Leaf cost is numCells, split costs are relative to the node area
+    double area = vtkHalfArea(bounds);
+    double splitCost = VTK_BVH_TRAVERSAL_COST +
+      ( area > 0.0 ? bestCost / area : 0.0 );
+    if ( numCells <= this->MaxLeafSize && splitCost >= numCells )
+    {
+      return false;
+    }
+
+    left.Initialize();
+    right.Initialize();
+    for (int i=0; i < numBins; ++i)
+    {
+      (i <= splitBin ? left : right).Add(bins[i]);
+    }
+    return true;
+  }
+
+  // Set up the binning of a box of centers, returns false if it is a point.
+  bool SetUpBinning(const double centerBounds[6], Binning &binning) const
+  {
+    int axis = 0;
+    double extent = centerBounds[1] - centerBounds[0];
+    for (int i=1; i < 3; ++i)
+    {
+      if ( centerBounds[2*i+1] - centerBounds[2*i] > extent )
+      {
+        axis = i;
+        extent = centerBounds[2*i+1] - centerBounds[2*i];
+      }
+    }
+    if ( !(extent > 0.0) )
+    {
+      return false;
+    }
+    binning.Axis = axis;
+    binning.Min = centerBounds[2*axis];
+    binning.NumberOfBins = this->NumberOfBins;
+    binning.Scale = this->NumberOfBins / extent;
+    return true;
+  }
+};
+
+//----------------------------------------------------------------------------
+// A node waiting to be split, with the range of its cells.
+struct vtkBVHTask
+{
+  int Node;
+  vtkIdType Begin;
+  vtkIdType End;
+  int Depth;
+  double Bounds[6];
+};
+
+//----------------------------------------------------------------------------
+// Compute the bounds of the cells and their centers, and initialize the
+// permutation.
+struct vtkBVHCellBounds
+{
+  vtkDataSet *DataSet;
+  double (*CellBounds)[6];
+  double *Centers;
+  vtkIdType *Ids;
+
+  void operator() (vtkIdType cellId, vtkIdType endCellId)
+  {
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      double *bds = this->CellBounds[cellId];
+      this->DataSet->GetCellBounds(cellId, bds);
+      double *center = this->Centers + 3*cellId;
+      center[0] = 0.5 * (bds[0] + bds[1]);
+      center[1] = 0.5 * (bds[2] + bds[3]);
+      center[2] = 0.5 * (bds[4] + bds[5]);
+      this->Ids[cellId] = cellId;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Compute the bounds of a range of cells and of their centers in parallel.
+struct vtkBVHRangeBounds
+{
+  const vtkBVHBuilder *Builder;
+  vtkSMPThreadLocal<std::vector<double> > LocalBounds;
+  double Bounds[6];
+  double CenterBounds[6];
+
+  vtkBVHRangeBounds(const vtkBVHBuilder *builder) : Builder(builder)
+  {
+  }
+
+  void Initialize()
+  {
+    std::vector<double> &bounds = this->LocalBounds.Local();
+    bounds.resize(12);
+    vtkInitializeBounds(&bounds[0]);
+    vtkInitializeBounds(&bounds[6]);
+  }
+
+  void operator() (vtkIdType begin, vtkIdType end)
+  {
+    std::vector<double> &bounds = this->LocalBounds.Local();
+    this->Builder->ComputeBounds(begin, end, &bounds[0], &bounds[6]);
+  }
+
+  void Reduce()
+  {
+    vtkInitializeBounds(this->Bounds);
+    vtkInitializeBounds(this->CenterBounds);
+    vtkSMPThreadLocal<std::vector<double> >::iterator itr;
+    for ( itr=this->LocalBounds.begin(); itr != this->LocalBounds.end(); ++itr )
+    {
+      vtkAddBounds(this->Bounds, &(*itr)[0]);
+      vtkAddBounds(this->CenterBounds, &(*itr)[6]);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Bin a range of cells in parallel.
+struct vtkBVHRangeBins
+{
+  const vtkBVHBuilder *Builder;
+  const vtkBVHBuilder::Binning *Binning;
+  vtkSMPThreadLocal<std::vector<vtkBVHBin> > LocalBins;
+  std::vector<vtkBVHBin> Bins;
+
+  vtkBVHRangeBins(const vtkBVHBuilder *builder,
+                  const vtkBVHBuilder::Binning *binning) :
+    Builder(builder), Binning(binning)
+  {
+  }
+
+  void Initialize()
+  {
+    std::vector<vtkBVHBin> &bins = this->LocalBins.Local();
+    bins.resize(this->Binning->NumberOfBins);
+    for (size_t i=0; i < bins.size(); ++i)
+    {
+      bins[i].Initialize();
+    }
+  }
+
+  void operator() (vtkIdType begin, vtkIdType end)
+  {
+    this->Builder->Bin(begin, end, *this->Binning, &this->LocalBins.Local()[0]);
+  }
+
+  void Reduce()
+  {
+    this->Bins.resize(this->Binning->NumberOfBins);
+    for (size_t i=0; i < this->Bins.size(); ++i)
+    {
+      this->Bins[i].Initialize();
+    }
+    vtkSMPThreadLocal<std::vector<vtkBVHBin> >::iterator itr;
+    for ( itr=this->LocalBins.begin(); itr != this->LocalBins.end(); ++itr )
+    {
+      for (size_t i=0; i < this->Bins.size(); ++i)
+      {
+        this->Bins[i].Add((*itr)[i]);
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Partition a range of cells in parallel. The cells going to the first
+// child are flagged, the prefix sum of the flags gives the new position of
+// each cell, and the permuted ids are scattered in a scratch array and
+// copied back.
+struct vtkBVHMarkCells
+{
+  const vtkBVHBuilder *Builder;
+  const vtkBVHBuilder::Binning *Binning;
+  int SplitBin;
+  vtkIdType Begin;
+  vtkIdType *Flags;
+
+  void operator() (vtkIdType i, vtkIdType end)
+  {
+    const vtkIdType *ids = this->Builder->Ids;
+    for ( ; i < end; ++i )
+    {
+      this->Flags[i-this->Begin] = ( this->Binning->GetBin(
+        this->Builder->Centers + 3*ids[i]) <= this->SplitBin ? 1 : 0 );
+    }
+  }
+};
+
+struct vtkBVHScatterCells
+{
+  const vtkIdType *Ids;
+  vtkIdType *Scratch;
+  vtkIdType Begin;
+  vtkIdType NumLeft;
+  const vtkIdType *Offsets;
+
+  void operator() (vtkIdType i, vtkIdType end)
+  {
+    for ( ; i < end; ++i )
+    {
+      vtkIdType k = i - this->Begin;
+      vtkIdType offset = this->Offsets[k];
+      if ( this->Offsets[k+1] > offset )
+      {
+        this->Scratch[this->Begin + offset] = this->Ids[i];
+      }
+      else
+      {
+        this->Scratch[this->Begin + this->NumLeft + k - offset] = this->Ids[i];
+      }
+    }
+  }
+};
+
+struct vtkBVHCopyCells
+{
+  const vtkIdType *Scratch;
+  vtkIdType *Ids;
+
+  void operator() (vtkIdType i, vtkIdType end)
+  {
+    std::copy(this->Scratch + i, this->Scratch + end, this->Ids + i);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Build subtrees concurrently, each one into its own array of nodes. The
+// local index of a node is its position in that array; the root of the
+// subtree is at index 0.
+struct vtkBVHSubtree
+{
+  vtkBVHTask Root;
+  std::vector<vtkBVHNode> Nodes;
+  int Depth;
+};
+
+struct vtkBVHBuildSubtrees
+{
+  const vtkBVHBuilder *Builder;
+  vtkBVHSubtree *Subtrees;
+
+  void operator() (vtkIdType subtree, vtkIdType endSubtree)
+  {
+    const vtkBVHBuilder *builder = this->Builder;
+    std::vector<vtkBVHBin> bins(builder->NumberOfBins);
+    std::vector<vtkBVHTask> tasks;
+    for ( ; subtree < endSubtree; ++subtree )
+    {
+      vtkBVHSubtree &s = this->Subtrees[subtree];
+      s.Nodes.reserve(2*(s.Root.End - s.Root.Begin));
+      s.Nodes.resize(1);
+      s.Nodes[0].SetBounds(s.Root.Bounds);
+      s.Depth = s.Root.Depth;
+      tasks.push_back(s.Root);
+      tasks.back().Node = 0;
+      while ( !tasks.empty() )
+      {
+        vtkBVHTask task = tasks.back();
+        tasks.pop_back();
+        s.Depth = std::max(s.Depth, task.Depth);
+        vtkIdType begin = task.Begin, end = task.End, numCells = end - begin;
+
+        double centerBounds[6];
+        vtkInitializeBounds(centerBounds);
+        builder->ComputeCenterBounds(begin, end, centerBounds);
+
+        vtkBVHBuilder::Binning binning;
+        int splitBin = -1, axis = 0;
+        vtkIdType mid = begin;
+        vtkBVHBin left, right;
+        if ( numCells > 1 && builder->SetUpBinning(centerBounds, binning) )
+        {
+          for (int i=0; i < binning.NumberOfBins; ++i)
+          {
+            bins[i].Initialize();
+          }
+          builder->Bin(begin, end, binning, &bins[0]);
+          if ( builder->SelectSplit(numCells, task.Bounds, binning, &bins[0],
+                                    splitBin, left, right) )
+          {
+            mid = std::partition(builder->Ids + begin, builder->Ids + end,
+              [&](vtkIdType cellId)
+              { return binning.GetBin(builder->Centers + 3*cellId) <= splitBin; })
+              - builder->Ids;
+            axis = binning.Axis;
+          }
+          else
+          {
+            splitBin = -1;
+          }
+        }
+        if ( splitBin < 0 && numCells > builder->MaxLeafSize )
+        {
+          // The centers coincide: split the cells in two halves
+          mid = begin + numCells / 2;
+          left.Initialize();
+          right.Initialize();
+          vtkInitializeBounds(centerBounds);
+          builder->ComputeBounds(begin, mid, left.Bounds, centerBounds);
+          builder->ComputeBounds(mid, end, right.Bounds, centerBounds);
+          splitBin = 0;
+        }
+
+        if ( splitBin < 0 )
+        {
+          s.Nodes[task.Node].MakeLeaf(begin, end);
+          continue;
+        }
+
+        int child = static_cast<int>(s.Nodes.size());
+        s.Nodes[task.Node].MakeNode(child, axis);
+        s.Nodes.resize(child + 2);
+        s.Nodes[child].SetBounds(left.Bounds);
+        s.Nodes[child+1].SetBounds(right.Bounds);
+
+        vtkBVHTask leftTask = { child, begin, mid, task.Depth + 1, {} };
+        vtkBVHTask rightTask = { child + 1, mid, end, task.Depth + 1, {} };
+        std::copy(left.Bounds, left.Bounds + 6, leftTask.Bounds);
+        std::copy(right.Bounds, right.Bounds + 6, rightTask.Bounds);
+        tasks.push_back(rightTask);
+        tasks.push_back(leftTask);
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Append the nodes of the subtrees to the top of the tree. The nodes of
+// subtree s (but its root, which is already in the tree) start at
+// Offsets[s].
+struct vtkBVHMergeSubtrees
+{
+  vtkBVHSubtree *Subtrees;
+  const vtkIdType *Offsets;
+  vtkBVHNode *Nodes;
+
+  void operator() (vtkIdType subtree, vtkIdType endSubtree)
+  {
+    for ( ; subtree < endSubtree; ++subtree )
+    {
+      vtkBVHSubtree &s = this->Subtrees[subtree];
+      int base = static_cast<int>(this->Offsets[subtree]) - 1;
+      for (size_t i=0; i < s.Nodes.size(); ++i)
+      {
+        vtkBVHNode node = s.Nodes[i];
+        if ( !node.IsLeaf() )
+        {
+          node.Offset += base;
+        }
+        this->Nodes[ i == 0 ? s.Root.Node : base + static_cast<int>(i) ] = node;
+      }
+      std::vector<vtkBVHNode>().swap(s.Nodes);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+vtkIdType vtkBVHTree::
+FindCell(double x[3], vtkGenericCell *cell, double pcoords[3],
+         double *weights) const
+{
+  const vtkBVHNode *nodes = &this->Nodes[0];
+  double closestPoint[3], dist2;
+  int subId;
+
+  vtkBVHStack<int> stack(this->Depth);
+  stack.Push(0);
+  while ( !stack.IsEmpty() )
+  {
+    const vtkBVHNode &node = nodes[stack.Pop()];
+    if ( vtkDistance2ToBounds(x, node.Bounds) > 0.0 )
+    {
+      continue;
+    }
+    if ( !node.IsLeaf() )
+    {
+      stack.Push(node.Offset + 1);
+      stack.Push(node.Offset);
+      continue;
+    }
+    for (int i=0; i < node.Count; ++i)
+    {
+      vtkIdType cellId = this->CellIds[node.Offset + i];
+      if ( vtkDistance2ToBounds(x, this->CellBounds[cellId]) == 0.0 )
+      {
+        this->DataSet->GetCell(cellId, cell);
+        if ( cell->EvaluatePosition(x, closestPoint, subId, pcoords, dist2,
+                                    weights) == 1 )
+        {
+          return cellId;
+        }
+      }
+    }
+  }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkBVHTree::
+FindCellsWithinBounds(double *bbox, vtkIdList *cells) const
+{
+  const vtkBVHNode *nodes = &this->Nodes[0];
+
+  vtkBVHStack<int> stack(this->Depth);
+  stack.Push(0);
+  while ( !stack.IsEmpty() )
+  {
+    const vtkBVHNode &node = nodes[stack.Pop()];
+    if ( !vtkOverlaps(bbox, node.Bounds) )
+    {
+      continue;
+    }
+    if ( !node.IsLeaf() )
+    {
+      stack.Push(node.Offset + 1);
+      stack.Push(node.Offset);
+      continue;
+    }
+    for (int i=0; i < node.Count; ++i)
+    {
+      vtkIdType cellId = this->CellIds[node.Offset + i];
+      if ( vtkOverlaps(bbox, this->CellBounds[cellId]) )
+      {
+        cells->InsertNextId(cellId);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Closest intersection along the line. The children of a node are visited
+// in the order the line enters them, and the nodes that the line enters
+// after the best intersection found so far are skipped.
+int vtkBVHTree::
+IntersectWithLine(double a0[3], double a1[3], double tol, double &t,
+                  double x[3], double pcoords[3], int &subId,
+                  vtkIdType &cellId, vtkGenericCell *cell) const
+{
+  const vtkBVHNode *nodes = &this->Nodes[0];
+  double invDir[3], tEntry;
+  for (int i=0; i < 3; ++i)
+  {
+    double d = a1[i] - a0[i];
+    invDir[i] = ( d != 0.0 ? 1.0 / d : VTK_DOUBLE_MAX );
+  }
+
+  double tBest = 1.0, tCell, xCell[3], pcoordsCell[3];
+  int subIdCell;
+  cellId = -1;
+
+  vtkBVHStack<vtkBVHStackItem> stack(this->Depth);
+  if ( vtkClipLine(nodes[0].Bounds, a0, invDir, tol, tBest, tEntry) )
+  {
+    vtkBVHStackItem item = { 0, tEntry };
+    stack.Push(item);
+  }
+  while ( !stack.IsEmpty() )
+  {
+    vtkBVHStackItem item = stack.Pop();
+    if ( item.Distance > tBest )
+    {
+      continue;
+    }
+    const vtkBVHNode &node = nodes[item.Node];
+    if ( !node.IsLeaf() )
+    {
+      vtkBVHStackItem nearChild = { node.Offset, 0.0 };
+      vtkBVHStackItem farChild = { node.Offset + 1, 0.0 };
+      bool hitNear = vtkClipLine(nodes[nearChild.Node].Bounds, a0, invDir, tol,
+                                 tBest, nearChild.Distance);
+      bool hitFar = vtkClipLine(nodes[farChild.Node].Bounds, a0, invDir, tol,
+                                tBest, farChild.Distance);
+      if ( hitNear && hitFar )
+      {
+        if ( farChild.Distance < nearChild.Distance )
+        {
+          std::swap(nearChild, farChild);
+        }
+        stack.Push(farChild);
+        stack.Push(nearChild);
+      }
+      else if ( hitNear )
+      {
+        stack.Push(nearChild);
+      }
+      else if ( hitFar )
+      {
+        stack.Push(farChild);
+      }
+      continue;
+    }
+    for (int i=0; i < node.Count; ++i)
+    {
+      vtkIdType cId = this->CellIds[node.Offset + i];
+      if ( vtkClipLine(this->CellBounds[cId], a0, invDir, tol, tBest, tEntry) )
+      {
+        this->DataSet->GetCell(cId, cell);
+        if ( cell->IntersectWithLine(a0, a1, tol, tCell, xCell, pcoordsCell,
+                                     subIdCell) &&
+             (tCell < tBest || (cellId < 0 && tCell <= tBest)) )
+        {
+          tBest = tCell;
+          cellId = cId;
+          subId = subIdCell;
+          for (int j=0; j < 3; ++j)
+          {
+            x[j] = xCell[j];
+            pcoords[j] = pcoordsCell[j];
+          }
+        }
+      }
+    }
+  }
+
+  if ( cellId < 0 )
+  {
+    return 0;
+  }
+  t = tBest;
+  this->DataSet->GetCell(cellId, cell);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Closest point within a squared radius. The children of a node are visited
+// closest first, and the nodes farther than the closest point found so far
+// are skipped.
+int vtkBVHTree::
+FindClosestPoint(double x[3], double radius2, double closestPoint[3],
+                 vtkGenericCell *cell, vtkIdType &cellId, int &subId,
+                 double &dist2, int &inside) const
+{
+  const vtkBVHNode *nodes = &this->Nodes[0];
+  double best2 = radius2, d2, point[3], pcoords[3];
+  int subIdCell, stat;
+  vtkBVHWeights weights;
+  cellId = -1;
+
+  vtkBVHStack<vtkBVHStackItem> stack(this->Depth);
+  vtkBVHStackItem root = { 0, vtkDistance2ToBounds(x, nodes[0].Bounds) };
+  if ( root.Distance <= best2 )
+  {
+    stack.Push(root);
+  }
+  while ( !stack.IsEmpty() )
+  {
+    vtkBVHStackItem item = stack.Pop();
+    if ( item.Distance > best2 )
+    {
+      continue;
+    }
+    const vtkBVHNode &node = nodes[item.Node];
+    if ( !node.IsLeaf() )
+    {
+      vtkBVHStackItem nearChild =
+        { node.Offset, vtkDistance2ToBounds(x, nodes[node.Offset].Bounds) };
+      vtkBVHStackItem farChild =
+        { node.Offset + 1, vtkDistance2ToBounds(x, nodes[node.Offset+1].Bounds) };
+      if ( farChild.Distance < nearChild.Distance )
+      {
+        std::swap(nearChild, farChild);
+      }
+      if ( farChild.Distance <= best2 )
+      {
+        stack.Push(farChild);
+      }
+      if ( nearChild.Distance <= best2 )
+      {
+        stack.Push(nearChild);
+      }
+      continue;
+    }
+    for (int i=0; i < node.Count; ++i)
+    {
+      vtkIdType cId = this->CellIds[node.Offset + i];
+      if ( vtkDistance2ToBounds(x, this->CellBounds[cId]) > best2 )
+      {
+        continue;
+      }
+      this->DataSet->GetCell(cId, cell);
+      stat = cell->EvaluatePosition(x, point, subIdCell, pcoords, d2,
+                                    weights.Get(cell->GetNumberOfPoints()));
+      if ( stat != -1 && (d2 < best2 || (cellId < 0 && d2 <= best2)) )
+      {
+        best2 = d2;
+        cellId = cId;
+        subId = subIdCell;
+        inside = stat;
+        closestPoint[0] = point[0];
+        closestPoint[1] = point[1];
+        closestPoint[2] = point[2];
+      }
+    }
+  }
+
+  if ( cellId < 0 )
+  {
+    return 0;
+  }
+  dist2 = best2;
+  this->DataSet->GetCell(cellId, cell);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+vtkBVHCellLocator::vtkBVHCellLocator()
+{
+  this->CacheCellBounds = 1; //always cached
+  this->NumberOfCellsPerNode = 8;
+  this->NumberOfBins = 16;
+  this->Tree = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+vtkBVHCellLocator::~vtkBVHCellLocator()
+{
+  this->FreeSearchStructure();
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::FreeSearchStructure()
+{
+  if ( this->Tree )
+  {
+    delete this->Tree;
+    this->Tree = nullptr;
+  }
+  this->FreeCellBounds();
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::GetNumberOfNodes()
+{
+  return ( this->Tree ? static_cast<vtkIdType>(this->Tree->Nodes.size()) : 0 );
+}
+
+//-----------------------------------------------------------------------------
+int vtkBVHCellLocator::GetDepth()
+{
+  return ( this->Tree ? this->Tree->Depth : 0 );
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::
+FindCell(double pos[3], double, vtkGenericCell *cell,
+         double pcoords[3], double* weights )
+{
+  this->BuildLocator();
+  if ( ! this->Tree )
+  {
+    return -1;
+  }
+  return this->Tree->FindCell(pos, cell, pcoords, weights);
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::
+FindCellsWithinBounds(double *bbox, vtkIdList *cells)
+{
+  cells->Reset();
+  this->BuildLocator();
+  if ( ! this->Tree )
+  {
+    return;
+  }
+  this->Tree->FindCellsWithinBounds(bbox, cells);
+}
+
+//-----------------------------------------------------------------------------
+int vtkBVHCellLocator::
+IntersectWithLine(double a0[3], double a1[3], double tol,
+                  double &t, double x[3], double pcoords[3],
+                  int &subId, vtkIdType &cellId, vtkGenericCell *cell)
+{
+  this->BuildLocator();
+  if ( ! this->Tree )
+  {
+    cellId = -1;
+    return 0;
+  }
+  return this->Tree->IntersectWithLine(a0, a1, tol, t, x, pcoords, subId,
+                                       cellId, cell);
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::
+FindClosestPoint(double x[3], double closestPoint[3], vtkGenericCell *cell,
+                 vtkIdType &cellId, int &subId, double& dist2)
+{
+  int inside;
+  this->BuildLocator();
+  if ( ! this->Tree ||
+       ! this->Tree->FindClosestPoint(x, VTK_DOUBLE_MAX, closestPoint, cell,
+                                      cellId, subId, dist2, inside) )
+  {
+    cellId = -1;
+  }
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::
+FindClosestPointWithinRadius(double x[3], double radius,
+                             double closestPoint[3], vtkGenericCell *cell,
+                             vtkIdType &cellId, int &subId, double& dist2,
+                             int &inside)
+{
+  this->BuildLocator();
+  if ( ! this->Tree )
+  {
+    return 0;
+  }
+  return this->Tree->FindClosestPoint(x, radius*radius, closestPoint, cell,
+                                      cellId, subId, dist2, inside);
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::
+BuildLocator()
+{
+  vtkDebugMacro( << "Building BVH cell locator" );
+
+  // Do we need to build?
+  if ( (this->Tree != nullptr) && (this->BuildTime > this->MTime)
+       && (this->BuildTime > this->DataSet->GetMTime()) )
+  {
+    return;
+  }
+
+  vtkIdType numCells;
+  if ( !this->DataSet || (numCells = this->DataSet->GetNumberOfCells()) < 1 )
+  {
+    vtkErrorMacro( << "No cells to build");
+    return;
+  }
+  if ( numCells >= VTK_INT_MAX )
+  {
+    vtkErrorMacro( << "Too many cells to build");
+    return;
+  }
+
+  this->FreeSearchStructure();
+
+  // The first cell is requested serially: some data sets build their cell
+  // structures then, which is not thread safe.
+  this->DataSet->GetCell(0, this->GenericCell);
+
+  // Bounds and centers of the cells, in parallel
+  this->CellBounds = new double [numCells][6];
+  std::vector<double> centers(3*numCells);
+  vtkBVHTree *tree = new vtkBVHTree(this->DataSet, this->CellBounds);
+  tree->CellIds.resize(numCells);
+
+  vtkBVHCellBounds cellBounds = { this->DataSet, this->CellBounds,
+                                  &centers[0], &tree->CellIds[0] };
+  vtkSMPTools::For(0, numCells, cellBounds);
+
+  vtkBVHBuilder builder;
+  builder.CellBounds = this->CellBounds;
+  builder.Centers = &centers[0];
+  builder.Ids = &tree->CellIds[0];
+  builder.NumberOfBins = this->NumberOfBins;
+  builder.MaxLeafSize = std::min(this->NumberOfCellsPerNode,
+                                 VTK_BVH_MAX_LEAF_SIZE);
+
+  // Split the top nodes one at a time, processing their cells in parallel.
+  // The nodes small enough to be built serially are kept for later.
+  vtkIdType subtreeSize = std::max(
+    numCells / (8 * vtkSMPTools::GetEstimatedNumberOfThreads()),
+    static_cast<vtkIdType>(4096));
+  std::vector<vtkBVHSubtree> subtrees;
+  std::vector<vtkIdType> scratch;
+  std::vector<vtkBVHTask> tasks;
+
+  vtkBVHRangeBounds rootBounds(&builder);
+  vtkSMPTools::For(0, numCells, rootBounds);
+  vtkBVHTask root = { 0, 0, numCells, 0, {} };
+  std::copy(rootBounds.Bounds, rootBounds.Bounds + 6, root.Bounds);
+  tree->Nodes.resize(1);
+  tree->Nodes[0].SetBounds(root.Bounds);
+  tasks.push_back(root);
+
+  for (size_t next=0; next < tasks.size(); ++next)
+  {
+    vtkBVHTask task = tasks[next];
+    vtkIdType begin = task.Begin, end = task.End, numTaskCells = end - begin;
+    if ( numTaskCells <= subtreeSize )
+    {
+      vtkBVHSubtree subtree;
+      subtree.Root = task;
+      subtree.Depth = task.Depth;
+      subtrees.push_back(subtree);
+      continue;
+    }
+    tree->Depth = std::max(tree->Depth, task.Depth);
+
+    vtkBVHRangeBounds rangeBounds(&builder);
+    vtkSMPTools::For(begin, end, rangeBounds);
+
+    vtkBVHBuilder::Binning binning;
+    int splitBin = -1;
+    vtkIdType mid = begin + numTaskCells / 2;
+    vtkBVHBin left, right;
+    if ( builder.SetUpBinning(rangeBounds.CenterBounds, binning) )
+    {
+      vtkBVHRangeBins rangeBins(&builder, &binning);
+      vtkSMPTools::For(begin, end, rangeBins);
+      if ( !builder.SelectSplit(numTaskCells, task.Bounds, binning,
+                                &rangeBins.Bins[0], splitBin, left, right) )
+      {
+        splitBin = -1;
+      }
+    }
+
+    if ( splitBin >= 0 )
+    {
+      if ( scratch.empty() )
+      {
+        scratch.resize(numCells + 1);
+      }
+      std::vector<vtkIdType> flags(numTaskCells + 1);
+      vtkBVHMarkCells mark = { &builder, &binning, splitBin, begin, &flags[0] };
+      vtkSMPTools::For(begin, end, mark);
+      vtkIdType numLeft = vtkSMPTools::ExclusiveScan(
+        &flags[0], &flags[0] + numTaskCells, &flags[0], vtkIdType(0));
+      flags[numTaskCells] = numLeft;
+      vtkBVHScatterCells scatter = { builder.Ids, &scratch[0], begin,
+                                     numLeft, &flags[0] };
+      vtkSMPTools::For(begin, end, scatter);
+      vtkBVHCopyCells copy = { &scratch[0], builder.Ids };
+      vtkSMPTools::For(begin, end, copy);
+      mid = begin + numLeft;
+    }
+    else if ( numTaskCells > builder.MaxLeafSize )
+    {
+      // The centers coincide: split the cells in two halves
+      vtkBVHRangeBounds leftBounds(&builder);
+      vtkSMPTools::For(begin, mid, leftBounds);
+      vtkBVHRangeBounds rightBounds(&builder);
+      vtkSMPTools::For(mid, end, rightBounds);
+      std::copy(leftBounds.Bounds, leftBounds.Bounds + 6, left.Bounds);
+      std::copy(rightBounds.Bounds, rightBounds.Bounds + 6, right.Bounds);
+      binning.Axis = 0;
+    }
+    else
+    {
+      tree->Nodes[task.Node].MakeLeaf(begin, end);
+      continue;
+    }
+
+    int child = static_cast<int>(tree->Nodes.size());
+    tree->Nodes[task.Node].MakeNode(child, binning.Axis);
+    tree->Nodes.resize(child + 2);
+    tree->Nodes[child].SetBounds(left.Bounds);
+    tree->Nodes[child+1].SetBounds(right.Bounds);
+
+    vtkBVHTask leftTask = { child, begin, mid, task.Depth + 1, {} };
+    vtkBVHTask rightTask = { child + 1, mid, end, task.Depth + 1, {} };
+    std::copy(left.Bounds, left.Bounds + 6, leftTask.Bounds);
+    std::copy(right.Bounds, right.Bounds + 6, rightTask.Bounds);
+    tasks.push_back(leftTask);
+    tasks.push_back(rightTask);
+  }
+  std::vector<vtkIdType>().swap(scratch);
+
+  // Build the subtrees concurrently
+  vtkIdType numSubtrees = static_cast<vtkIdType>(subtrees.size());
+  if ( numSubtrees == 0 )
+  {
+    this->Tree = tree;
+    this->BuildTime.Modified();
+    return;
+  }
+  vtkBVHBuildSubtrees buildSubtrees = { &builder, &subtrees[0] };
+  vtkSMPTools::For(0, numSubtrees, 1, buildSubtrees);
+  std::vector<double>().swap(centers);
+
+  // Append their nodes to the tree
+  std::vector<vtkIdType> offsets(numSubtrees + 1);
+  for (vtkIdType i=0; i < numSubtrees; ++i)
+  {
+    offsets[i] = static_cast<vtkIdType>(subtrees[i].Nodes.size()) - 1;
+    tree->Depth = std::max(tree->Depth, subtrees[i].Depth);
+  }
+  vtkIdType numNodes = vtkSMPTools::ExclusiveScan(
+    &offsets[0], &offsets[0] + numSubtrees, &offsets[0],
+    static_cast<vtkIdType>(tree->Nodes.size()));
+  tree->Nodes.resize(numNodes);
+  vtkBVHMergeSubtrees merge = { &subtrees[0], &offsets[0], &tree->Nodes[0] };
+  vtkSMPTools::For(0, numSubtrees, 1, merge);
+
+  this->Tree = tree;
+  this->BuildTime.Modified();
+}
+
+//-----------------------------------------------------------------------------
+// Produce a polygonal representation of the locator: the boxes of the nodes
+// at the given level (and of the leaves above it), or of all the leaves if
+// the level is negative.
+void vtkBVHCellLocator::
+GenerateRepresentation(int level, vtkPolyData *pd)
+{
+  // Make sure locator has been built successfully
+  this->BuildLocator();
+  if ( ! this->Tree )
+  {
+    return;
+  }
+
+  vtkPoints *pts = vtkPoints::New();
+  pts->SetDataTypeToFloat();
+  vtkCellArray *polys = vtkCellArray::New();
+  pd->SetPoints(pts);
+  pd->SetPolys(polys);
+
+  static const vtkIdType faces[6][4] = { {0,4,6,2}, {1,3,7,5}, {0,1,5,4},
+                                         {2,6,7,3}, {0,2,3,1}, {4,5,7,6} };
+  const vtkBVHNode *nodes = &this->Tree->Nodes[0];
+  std::vector<std::pair<int,int> > stack(1, std::make_pair(0, 0));
+  while ( !stack.empty() )
+  {
+    int nodeId = stack.back().first, depth = stack.back().second;
+    stack.pop_back();
+    const vtkBVHNode &node = nodes[nodeId];
+    if ( !node.IsLeaf() && (level < 0 || depth < level) )
+    {
+      stack.push_back(std::make_pair(node.Offset + 1, depth + 1));
+      stack.push_back(std::make_pair(node.Offset, depth + 1));
+      continue;
+    }
+
+    // Points in (i-j-k) order
+    vtkIdType pIds[8], face[4];
+    const float *b = node.Bounds;
+    for (int i=0; i < 8; ++i)
+    {
+      pIds[i] = pts->InsertNextPoint(b[i&1], b[2 + ((i>>1)&1)],
+                                     b[4 + ((i>>2)&1)]);
+    }
+    for (int i=0; i < 6; ++i)
+    {
+      for (int j=0; j < 4; ++j)
+      {
+        face[j] = pIds[faces[i][j]];
+      }
+      polys->InsertNextCell(4, face);
+    }
+  }
+
+  // Clean up
+  polys->Delete();
+  pts->Delete();
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  // Cell bounds are always cached
+  this->CacheCellBounds = 1;
+
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Bins: " << this->NumberOfBins << "\n";
+  os << indent << "Number Of Nodes: " << this->GetNumberOfNodes() << "\n";
+  os << indent << "Depth: " << this->GetDepth() << "\n";
+}
@@ -0,0 +1,230 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBVHCellLocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkBVHCellLocator
+ * @brief   cell locator based on a bounding volume hierarchy
+ *
+ * vtkBVHCellLocator is a type of vtkAbstractCellLocator that organizes the
+ * cells in a bounding volume hierarchy (BVH): a binary tree of axis-aligned
+ * boxes where each cell belongs to exactly one leaf. The tree is built top
+ * down with the surface area heuristic (SAH), evaluated over a fixed number
+ * of bins along the longest axis of the cell centers, which tends to
+ * produce trees that are very fast for ray casting (IntersectWithLine()) and
+ * closest point queries (FindClosestPoint()).
+ *
+ * The construction is threaded (via vtkSMPTools): the cell bounds and the
+ * binning of the top levels of the tree are computed in parallel, and the
+ * lower subtrees are then built concurrently. The nodes are stored in a flat
+ * array of 32 bytes per node (single precision bounds, conservatively
+ * rounded), and the queries traverse the tree with an explicit stack,
+ * visiting the closest child first and skipping the subtrees that cannot
+ * improve on the best result found so far.
+ *
+ * The maximum number of cells in a leaf is given by
+ * vtkAbstractCellLocator::NumberOfCellsPerNode. Once built, the locator may
+ * be queried from several threads as long as each thread provides its own
+ * vtkGenericCell.
+ *
+ * @warning
+ * This class *always* caches cell bounds. Incremental cell insertion is not
+ * supported.
+ *
+ * @sa
+ * vtkLocator vtkAbstractCellLocator vtkCellLocator vtkStaticCellLocator
+ * vtkCellTreeLocator vtkModifiedBSPTree vtkOBBTree
+ */
+
+#ifndef vtkBVHCellLocator_h
+#define vtkBVHCellLocator_h
+
+#include "vtkCommonDataModelModule.h" // For export macro
+#include "vtkAbstractCellLocator.h"
+
+// Forward declaration for PIMPL
+struct vtkBVHTree;
+
+class VTKCOMMONDATAMODEL_EXPORT vtkBVHCellLocator : public vtkAbstractCellLocator
+{
+public:
+  //@{
+  /**
+   * Standard methods to instantiate, print and obtain type-related information.
+   */
+  static vtkBVHCellLocator *New();
+  vtkTypeMacro(vtkBVHCellLocator,vtkAbstractCellLocator);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of bins used to evaluate the surface area heuristic
+   * when a node is split. More bins give slightly better trees at the cost
+   * of a slower construction. By default 16 bins are used.
+   */
+  vtkSetClampMacro(NumberOfBins,int,2,256);
+  vtkGetMacro(NumberOfBins,int);
+  //@}
+
+  /**
+   * Return the number of nodes, and the depth, of the hierarchy. They are
+   * zero when the locator has not been built.
+   */
+  vtkIdType GetNumberOfNodes();
+  int GetDepth();
+
+  /**
+   * Test a point to find if it is inside a cell. Returns the cellId if inside
+   * or -1 if not.
+   */
+  vtkIdType FindCell(double pos[3], double vtkNotUsed, vtkGenericCell *cell,
+                     double pcoords[3], double* weights ) VTK_OVERRIDE;
+
+  /**
+   * Reimplemented from vtkAbstractCellLocator to support bad compilers.
+   */
+  vtkIdType FindCell(double x[3]) VTK_OVERRIDE
+    { return this->Superclass::FindCell(x); }
+
+  /**
+   * Return a list of unique cell ids inside of a given bounding box. The
+   * user must provide the vtkIdList to populate. This method returns data
+   * only after the locator has been built.
+   */
+  void FindCellsWithinBounds(double *bbox, vtkIdList *cells) VTK_OVERRIDE;
+
+  /**
+   * Return the intersection point (if any) of the finite line with the
+   * cells that is the closest to a0, AND the cell which was intersected.
+   * The cell is returned as a cell id and as a generic cell.
+   */
+  int IntersectWithLine(double a0[3], double a1[3], double tol,
+                        double& t, double x[3], double pcoords[3],
+                        int &subId, vtkIdType &cellId,
+                        vtkGenericCell *cell) VTK_OVERRIDE;
+
+  /**
+   * Reimplemented from vtkAbstractCellLocator to support bad compilers.
+   */
+  int IntersectWithLine(double p1[3], double p2[3], double tol,
+                        double& t, double x[3], double pcoords[3], int &subId) VTK_OVERRIDE
+  {
+    return this->Superclass::IntersectWithLine(p1, p2, tol, t, x, pcoords, subId);
+  }
+
+  /**
+   * Reimplemented from vtkAbstractCellLocator to support bad compilers.
+   */
+  int IntersectWithLine(double p1[3], double p2[3], double tol,
+                        double &t, double x[3], double pcoords[3],
+                        int &subId, vtkIdType &cellId) VTK_OVERRIDE
+  {
+    return this->Superclass::IntersectWithLine(p1, p2, tol, t, x, pcoords, subId, cellId);
+  }
+
+  /**
+   * Reimplemented from vtkAbstractCellLocator to support bad compilers.
+   */
+  int IntersectWithLine(const double p1[3], const double p2[3],
+                        vtkPoints *points, vtkIdList *cellIds) VTK_OVERRIDE
+  {
+    return this->Superclass::IntersectWithLine(p1, p2, points, cellIds);
+  }
+
+  /**
+   * Return the closest point and the cell which is closest to the point x.
+   * The closest point is somewhere on a cell, it need not be one of the
+   * vertices of the cell. If a cell is found, "cell" contains the points
+   * and ptIds for the cell "cellId" upon exit.
+   */
+  void FindClosestPoint(double x[3], double closestPoint[3],
+                        vtkGenericCell *cell, vtkIdType &cellId,
+                        int &subId, double& dist2) VTK_OVERRIDE;
+
+  /**
+   * Reimplemented from vtkAbstractCellLocator to support bad compilers.
+   */
+  void FindClosestPoint(double x[3], double closestPoint[3],
+                        vtkIdType &cellId, int &subId, double& dist2) VTK_OVERRIDE
+  {
+    this->Superclass::FindClosestPoint(x, closestPoint, cellId, subId, dist2);
+  }
+
+  /**
+   * Return the closest point within a specified radius and the cell which is
+   * closest to the point x. The closest point is somewhere on a cell, it
+   * need not be one of the vertices of the cell. This method returns 1 if a
+   * point is found within the specified radius, and 0 otherwise (the values
+   * of closestPoint, cellId, subId, and dist2 are then undefined). If a
+   * closest point is found, "cell" contains the points and ptIds for the
+   * cell "cellId", and inside the value returned by EvaluatePosition() for
+   * it: inside(=1) or outside(=0).
+   */
+  vtkIdType FindClosestPointWithinRadius(double x[3], double radius,
+                                         double closestPoint[3],
+                                         vtkGenericCell *cell,
+                                         vtkIdType &cellId, int &subId,
+                                         double& dist2, int &inside) VTK_OVERRIDE;
+
+  /**
+   * Reimplemented from vtkAbstractCellLocator to support bad compilers.
+   */
+  vtkIdType FindClosestPointWithinRadius(double x[3], double radius,
+                                         double closestPoint[3],
+                                         vtkIdType &cellId, int &subId,
+                                         double& dist2) VTK_OVERRIDE
+  {
+    return this->Superclass::FindClosestPointWithinRadius(
+      x, radius, closestPoint, cellId, subId, dist2);
+  }
+
+  /**
+   * Reimplemented from vtkAbstractCellLocator to support bad compilers.
+   */
+  vtkIdType FindClosestPointWithinRadius(double x[3], double radius,
+                                         double closestPoint[3],
+                                         vtkGenericCell *cell,
+                                         vtkIdType &cellId, int &subId,
+                                         double& dist2) VTK_OVERRIDE
+  {
+    return this->Superclass::FindClosestPointWithinRadius(
+      x, radius, closestPoint, cell, cellId, subId, dist2);
+  }
+
+  //@{
+  /**
+   * Satisfy vtkLocator abstract interface. GenerateRepresentation() produces
+   * the boxes of the nodes at the given level of the tree (and of the leaves
+   * above that level); a negative level produces the boxes of all the leaves.
+   */
+  void GenerateRepresentation(int level, vtkPolyData *pd) VTK_OVERRIDE;
+  void FreeSearchStructure() VTK_OVERRIDE;
+  void BuildLocator() VTK_OVERRIDE;
+  //@}
+
+protected:
+  vtkBVHCellLocator();
+  ~vtkBVHCellLocator() VTK_OVERRIDE;
+
+  int NumberOfBins; // Number of bins of the surface area heuristic
+
+  // Support PIMPLd implementation
+  vtkBVHTree *Tree; // The nodes and the cell ids of the leaves
+
+private:
+  vtkBVHCellLocator(const vtkBVHCellLocator&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkBVHCellLocator&) VTK_DELETE_FUNCTION;
+};
+
+#endif
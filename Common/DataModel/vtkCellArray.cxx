@@ -14,13 +14,263 @@
 =========================================================================*/
 #include "vtkCellArray.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+#include "vtkTypeInt32Array.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 vtkStandardNewMacro(vtkCellArray);
 
+//----------------------------------------------------------------------------
+class vtkCellArray::vtkInternals
+{
+public:
+  vtkInternals() : LegacyCached(false)
+  {
+  }
+
+  // Whether Ia holds the legacy copy of offsets storage cells.
+  std::atomic<bool> LegacyCached;
+  std::mutex Lock;
+};
+
+namespace
+{
+const vtkIdType Int32Max = VTK_TYPE_INT32_MAX;
+
+vtkDataArray* NewOffsetsStorageArray(int storage)
+{
+  if (storage == vtkCellArray::OFFSETS32_STORAGE)
+  {
+    return vtkTypeInt32Array::New();
+  }
+  return vtkIdTypeArray::New();
+}
+
+struct MaxOp
+{
+  vtkIdType operator()(vtkIdType a, vtkIdType b) const
+  {
+    return a > b ? a : b;
+  }
+};
+
+template <typename T>
+struct StaticCast
+{
+  template <typename U>
+  T operator()(U value) const
+  {
+    return static_cast<T>(value);
+  }
+};
+
+// Copy the point ids between the two layouts, one cell per index.
+template <typename ValueType>
+struct CopyToOffsets
+{
+  const vtkIdType *Legacy;
+  const ValueType *Offsets;
+  ValueType *Connectivity;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+    {
+      const vtkIdType *src = this->Legacy + this->Offsets[cellId] + cellId + 1;
+      std::transform(src,
+                     src + (this->Offsets[cellId + 1] - this->Offsets[cellId]),
+                     this->Connectivity + this->Offsets[cellId],
+                     StaticCast<ValueType>());
+    }
+  }
+};
+
+template <typename ValueType>
+struct CopyToLegacy
+{
+  const ValueType *Offsets;
+  const ValueType *Connectivity;
+  vtkIdType *Legacy;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+    {
+      vtkIdType *dst = this->Legacy + this->Offsets[cellId] + cellId;
+      *dst++ = this->Offsets[cellId + 1] - this->Offsets[cellId];
+      std::copy(this->Connectivity + this->Offsets[cellId],
+                this->Connectivity + this->Offsets[cellId + 1], dst);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void LegacyToOffsets(const vtkIdType *legacy, vtkIdType numCells,
+                     ArrayT *offsetsArray, ArrayT *connectivity)
+{
+  typedef typename ArrayT::ValueType ValueType;
+
+  // The cell sizes can only be found by walking the cells in order.
+  offsetsArray->SetNumberOfValues(numCells + 1);
+  ValueType *offsets = offsetsArray->GetPointer(0);
+  vtkIdType loc = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+  {
+    offsets[cellId] = static_cast<ValueType>(loc - cellId);
+    loc += legacy[loc] + 1;
+  }
+  offsets[numCells] = static_cast<ValueType>(loc - numCells);
+
+  connectivity->SetNumberOfValues(offsets[numCells]);
+  CopyToOffsets<ValueType> copier = { legacy, offsets,
+                                      connectivity->GetPointer(0) };
+  vtkSMPTools::For(0, numCells, copier);
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void OffsetsToLegacy(ArrayT *offsetsArray, ArrayT *connectivity,
+                     vtkIdType numCells, vtkIdTypeArray *legacy)
+{
+  typedef typename ArrayT::ValueType ValueType;
+  const ValueType *offsets = offsetsArray->GetPointer(0);
+  legacy->SetNumberOfValues(offsets[numCells] + numCells);
+  CopyToLegacy<ValueType> copier = { offsets, connectivity->GetPointer(0),
+                                     legacy->GetPointer(0) };
+  vtkSMPTools::For(0, numCells, copier);
+}
+
+//----------------------------------------------------------------------------
+template <typename SrcArrayT, typename DstArrayT>
+void CastValues(SrcArrayT *src, DstArrayT *dst)
+{
+  vtkIdType numValues = src->GetNumberOfValues();
+  dst->SetNumberOfValues(numValues);
+  vtkSMPTools::Transform(src->GetPointer(0), src->GetPointer(0) + numValues,
+                         dst->GetPointer(0),
+                         StaticCast<typename DstArrayT::ValueType>());
+}
+
+//----------------------------------------------------------------------------
+template <typename ValueType>
+vtkIdType FindCellAtLocation(const ValueType *offsets, vtkIdType numCells,
+                             vtkIdType loc)
+{
+  // The legacy location of cell i is offsets[i] + i, which strictly
+  // increases with i.
+  vtkIdType low = 0;
+  vtkIdType high = numCells;
+  while (low < high)
+  {
+    vtkIdType mid = low + (high - low) / 2;
+    if (offsets[mid] + mid < loc)
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+int MaxCellSize(ArrayT *offsetsArray, vtkIdType numCells)
+{
+  const typename ArrayT::ValueType *offsets = offsetsArray->GetPointer(0);
+  vtkIdType maxSize = 0;
+  for (vtkIdType i = 0; i < numCells; i++)
+  {
+    maxSize = std::max<vtkIdType>(maxSize, offsets[i + 1] - offsets[i]);
+  }
+  return static_cast<int>(maxSize);
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void CopyCell(ArrayT *offsetsArray, ArrayT *connectivity, vtkIdType cellId,
+              vtkIdList *pts)
+{
+  const typename ArrayT::ValueType *offsets = offsetsArray->GetPointer(0);
+  const typename ArrayT::ValueType *cell =
+    connectivity->GetPointer(0) + offsets[cellId];
+  vtkIdType npts = offsets[cellId + 1] - offsets[cellId];
+  pts->SetNumberOfIds(npts);
+  std::copy(cell, cell + npts, pts->GetPointer(0));
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void AppendCell(ArrayT *offsets, ArrayT *connectivity, vtkIdType npts,
+                const vtkIdType *pts)
+{
+  typedef typename ArrayT::ValueType ValueType;
+  vtkIdType end = connectivity->GetMaxId() + 1;
+  ValueType *ptr = connectivity->WritePointer(end, npts);
+  std::transform(pts, pts + npts, ptr, StaticCast<ValueType>());
+  offsets->InsertNextValue(static_cast<ValueType>(end + npts));
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void AppendCellPoint(ArrayT *offsets, ArrayT *connectivity,
+                     vtkIdType numCells, vtkIdType id)
+{
+  typedef typename ArrayT::ValueType ValueType;
+  vtkIdType end = connectivity->InsertNextValue(static_cast<ValueType>(id)) + 1;
+  offsets->SetValue(numCells, static_cast<ValueType>(end));
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void ReverseCellIds(ArrayT *offsets, ArrayT *connectivity, vtkIdType cellId)
+{
+  typename ArrayT::ValueType *ptr = connectivity->GetPointer(0);
+  std::reverse(ptr + offsets->GetValue(cellId),
+               ptr + offsets->GetValue(cellId + 1));
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+void ReplaceCellIds(ArrayT *offsets, ArrayT *connectivity, vtkIdType cellId,
+                    int npts, const vtkIdType *pts)
+{
+  typedef typename ArrayT::ValueType ValueType;
+  std::transform(pts, pts + npts,
+                 connectivity->GetPointer(offsets->GetValue(cellId)),
+                 StaticCast<ValueType>());
+}
+
+//----------------------------------------------------------------------------
+bool FitsIn32(vtkIdType npts, const vtkIdType *pts)
+{
+  for (vtkIdType i = 0; i < npts; i++)
+  {
+    if (pts[i] > Int32Max || pts[i] < VTK_TYPE_INT32_MIN)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
 //----------------------------------------------------------------------------
 vtkCellArray::vtkCellArray()
 {
+  this->Storage = LEGACY_STORAGE;
   this->Ia = vtkIdTypeArray::New();
+  this->Offsets = nullptr;
+  this->Connectivity = nullptr;
+  this->TraversalCell = vtkIdList::New();
+  this->Internals = new vtkInternals;
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
@@ -35,7 +285,27 @@ void vtkCellArray::DeepCopy (vtkCellArray *ca)
     return;
   }
 
-  this->Ia->DeepCopy(ca->Ia);
+  this->ReleaseLegacyCells();
+  if (ca->Storage != LEGACY_STORAGE)
+  {
+    // Do not convert this array just to discard its cells.
+    this->Ia->Initialize();
+    if (this->Storage != ca->Storage)
+    {
+      this->ReleaseOffsets();
+      this->Offsets = NewOffsetsStorageArray(ca->Storage);
+      this->Connectivity = NewOffsetsStorageArray(ca->Storage);
+      this->Storage = ca->Storage;
+    }
+    this->Offsets->DeepCopy(ca->Offsets);
+    this->Connectivity->DeepCopy(ca->Connectivity);
+  }
+  else
+  {
+    this->ReleaseOffsets();
+    this->Storage = LEGACY_STORAGE;
+    this->Ia->DeepCopy(ca->Ia);
+  }
   this->NumberOfCells = ca->NumberOfCells;
   this->InsertLocation = ca->InsertLocation;
   this->TraversalLocation = ca->TraversalLocation;
@@ -45,22 +315,648 @@ void vtkCellArray::DeepCopy (vtkCellArray *ca)
 vtkCellArray::~vtkCellArray()
 {
   this->Ia->Delete();
+  this->ReleaseOffsets();
+  this->TraversalCell->Delete();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReleaseOffsets()
+{
+  if (this->Offsets)
+  {
+    this->Offsets->Delete();
+    this->Offsets = nullptr;
+    this->Connectivity->Delete();
+    this->Connectivity = nullptr;
+  }
 }
 
 //----------------------------------------------------------------------------
 void vtkCellArray::Initialize()
 {
+  this->ReleaseLegacyCells();
   this->Ia->Initialize();
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    this->Offsets->Initialize();
+    this->Offsets->InsertNextTuple1(0);
+    this->Connectivity->Initialize();
+  }
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
 }
 
+//----------------------------------------------------------------------------
+void vtkCellArray::Reset()
+{
+  this->ReleaseLegacyCells();
+  this->NumberOfCells = 0;
+  this->InsertLocation = 0;
+  this->TraversalLocation = 0;
+  this->Ia->Reset();
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    this->Offsets->Reset();
+    this->Offsets->InsertNextTuple1(0);
+    this->Connectivity->Reset();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetStorage(int storage)
+{
+#if VTK_SIZEOF_ID_TYPE == 4
+  // vtkIdType is already 32-bit, narrowing would not save anything.
+  if (storage == OFFSETS32_STORAGE)
+  {
+    storage = OFFSETS_STORAGE;
+  }
+#endif
+  if (storage == OFFSETS32_STORAGE && this->Storage != OFFSETS32_STORAGE &&
+      !this->CanConvertTo32BitStorage())
+  {
+    storage = OFFSETS_STORAGE;
+  }
+  if (storage == this->Storage)
+  {
+    return;
+  }
+
+  switch (storage)
+  {
+    case LEGACY_STORAGE:
+      this->ConvertToLegacy();
+      break;
+    case OFFSETS_STORAGE:
+    case OFFSETS32_STORAGE:
+      if (this->Storage == LEGACY_STORAGE)
+      {
+        this->ConvertToOffsets(storage);
+      }
+      else
+      {
+        this->ConvertOffsets(storage);
+      }
+      break;
+    default:
+      vtkErrorMacro("Unknown storage " << storage);
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::CanConvertTo32BitStorage()
+{
+  if (this->Storage == OFFSETS32_STORAGE)
+  {
+    return true;
+  }
+  if (this->GetNumberOfConnectivityIds() > Int32Max)
+  {
+    return false;
+  }
+
+  // The cell sizes of the legacy layout are smaller than the largest
+  // point id of the cells, they do not change the result.
+  vtkIdTypeArray *ids = this->Storage == LEGACY_STORAGE ?
+    this->Ia : static_cast<vtkIdTypeArray*>(this->Connectivity);
+  const vtkIdType *begin = ids->GetPointer(0);
+  const vtkIdType *end = begin + ids->GetNumberOfValues();
+  return vtkSMPTools::Reduce(begin, end, vtkIdType(0), MaxOp()) <= Int32Max;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ConvertToOffsets(int storage)
+{
+  vtkDataArray *offsets = NewOffsetsStorageArray(storage);
+  vtkDataArray *connectivity = NewOffsetsStorageArray(storage);
+  const vtkIdType *legacy = this->Ia->GetPointer(0);
+  if (storage == OFFSETS32_STORAGE)
+  {
+    LegacyToOffsets(legacy, this->NumberOfCells,
+                    static_cast<vtkTypeInt32Array*>(offsets),
+                    static_cast<vtkTypeInt32Array*>(connectivity));
+  }
+  else
+  {
+    LegacyToOffsets(legacy, this->NumberOfCells,
+                    static_cast<vtkIdTypeArray*>(offsets),
+                    static_cast<vtkIdTypeArray*>(connectivity));
+  }
+
+  this->Offsets = offsets;
+  this->Connectivity = connectivity;
+  this->Storage = storage;
+
+  // The traversal location becomes a cell id.
+  this->TraversalLocation = this->GetCellIdAtLocation(this->TraversalLocation);
+  this->Ia->Initialize();
+  this->InsertLocation = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ConvertToLegacy()
+{
+  vtkIdType numCells = this->NumberOfCells;
+  if (numCells > 0)
+  {
+    this->TraversalLocation =
+      this->GetOffset(this->TraversalLocation) + this->TraversalLocation;
+    if (this->Internals->LegacyCached)
+    {
+      // Ia already holds the cells.
+      this->Internals->LegacyCached = false;
+    }
+    else if (this->Storage == OFFSETS32_STORAGE)
+    {
+      OffsetsToLegacy(static_cast<vtkTypeInt32Array*>(this->Offsets),
+                      static_cast<vtkTypeInt32Array*>(this->Connectivity),
+                      numCells, this->Ia);
+    }
+    else
+    {
+      OffsetsToLegacy(static_cast<vtkIdTypeArray*>(this->Offsets),
+                      static_cast<vtkIdTypeArray*>(this->Connectivity),
+                      numCells, this->Ia);
+    }
+    this->InsertLocation = this->Ia->GetNumberOfValues();
+  }
+  else
+  {
+    this->ReleaseLegacyCells();
+    this->Ia->Reset();
+    this->InsertLocation = 0;
+    this->TraversalLocation = 0;
+  }
+
+  this->ReleaseOffsets();
+  this->Storage = LEGACY_STORAGE;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ConvertOffsets(int storage)
+{
+  vtkDataArray *offsets = NewOffsetsStorageArray(storage);
+  vtkDataArray *connectivity = NewOffsetsStorageArray(storage);
+  if (storage == OFFSETS32_STORAGE)
+  {
+    CastValues(static_cast<vtkIdTypeArray*>(this->Offsets),
+               static_cast<vtkTypeInt32Array*>(offsets));
+    CastValues(static_cast<vtkIdTypeArray*>(this->Connectivity),
+               static_cast<vtkTypeInt32Array*>(connectivity));
+  }
+  else
+  {
+    CastValues(static_cast<vtkTypeInt32Array*>(this->Offsets),
+               static_cast<vtkIdTypeArray*>(offsets));
+    CastValues(static_cast<vtkTypeInt32Array*>(this->Connectivity),
+               static_cast<vtkIdTypeArray*>(connectivity));
+  }
+
+  this->ReleaseOffsets();
+  this->Offsets = offsets;
+  this->Connectivity = connectivity;
+  this->Storage = storage;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetOffset(vtkIdType cellId)
+{
+  if (this->Storage == OFFSETS32_STORAGE)
+  {
+    return static_cast<vtkTypeInt32Array*>(this->Offsets)->GetValue(cellId);
+  }
+  return static_cast<vtkIdTypeArray*>(this->Offsets)->GetValue(cellId);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetCellIdAtLocation(vtkIdType loc)
+{
+  if (this->Storage == OFFSETS32_STORAGE)
+  {
+    return FindCellAtLocation(
+      static_cast<vtkTypeInt32Array*>(this->Offsets)->GetPointer(0),
+      this->NumberOfCells, loc);
+  }
+  return FindCellAtLocation(
+    static_cast<vtkIdTypeArray*>(this->Offsets)->GetPointer(0),
+    this->NumberOfCells, loc);
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::Allocate(vtkIdType sz, vtkIdType ext)
+{
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    // sz counts the cell sizes too. Assume triangles to size the offsets,
+    // they grow as needed.
+    this->ReleaseLegacyCells();
+    int ok = this->Connectivity->Allocate(sz, ext) &&
+             this->Offsets->Allocate(sz / 4 + 1, ext);
+    this->Offsets->InsertNextTuple1(0);
+    this->NumberOfCells = 0;
+    this->TraversalLocation = 0;
+    return ok;
+  }
+  return this->Ia->Allocate(sz,ext);
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::AllocateExact(vtkIdType numCells, vtkIdType connectivitySize)
+{
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    this->ReleaseLegacyCells();
+    int ok = this->Connectivity->Allocate(connectivitySize) &&
+             this->Offsets->Allocate(numCells + 1);
+    this->Offsets->InsertNextTuple1(0);
+    this->NumberOfCells = 0;
+    this->TraversalLocation = 0;
+    return ok;
+  }
+  return this->Allocate(numCells + connectivitySize);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetSize()
+{
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    return this->Offsets->GetSize() + this->Connectivity->GetSize();
+  }
+  return this->Ia->GetSize();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetNumberOfConnectivityEntries()
+{
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    return this->Connectivity->GetMaxId() + 1 + this->NumberOfCells;
+  }
+  return this->Ia->GetMaxId()+1;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetNumberOfConnectivityIds()
+{
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    return this->Connectivity->GetMaxId() + 1;
+  }
+  return this->Ia->GetMaxId() + 1 - this->NumberOfCells;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetInsertLocation(int npts)
+{
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    return this->GetNumberOfConnectivityEntries() - npts - 1;
+  }
+  return (this->InsertLocation - npts - 1);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetTraversalLocation()
+{
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    return this->GetOffset(this->TraversalLocation) + this->TraversalLocation;
+  }
+  return this->TraversalLocation;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetTraversalLocation(vtkIdType loc)
+{
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    this->TraversalLocation = this->GetCellIdAtLocation(loc);
+    return;
+  }
+  this->TraversalLocation = loc;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdList *pts)
+{
+  if (this->Storage == OFFSETS32_STORAGE)
+  {
+    CopyCell(static_cast<vtkTypeInt32Array*>(this->Offsets),
+             static_cast<vtkTypeInt32Array*>(this->Connectivity), cellId, pts);
+    return;
+  }
+
+  vtkIdType npts, *ppts;
+  this->GetCellAtId(cellId, npts, ppts);
+  pts->SetNumberOfIds(npts);
+  std::copy(ppts, ppts + npts, pts->GetPointer(0));
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetCellSize(vtkIdType cellId)
+{
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    return this->GetOffset(cellId + 1) - this->GetOffset(cellId);
+  }
+
+  vtkIdType npts, *pts;
+  this->GetCellAtId(cellId, npts, pts);
+  return npts;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::InsertNextCellOffsets(vtkIdType npts,
+                                              const vtkIdType* pts)
+{
+  if (this->Storage == OFFSETS32_STORAGE &&
+      (this->Connectivity->GetMaxId() + 1 + npts > Int32Max ||
+       !FitsIn32(npts, pts)))
+  {
+    // pts may point into the legacy copy, which widening releases.
+    std::vector<vtkIdType> ids(pts, pts + npts);
+    this->SetStorageToOffsets();
+    AppendCell(static_cast<vtkIdTypeArray*>(this->Offsets),
+               static_cast<vtkIdTypeArray*>(this->Connectivity), npts,
+               ids.data());
+    return this->NumberOfCells++;
+  }
+
+  if (this->Storage == OFFSETS32_STORAGE)
+  {
+    AppendCell(static_cast<vtkTypeInt32Array*>(this->Offsets),
+               static_cast<vtkTypeInt32Array*>(this->Connectivity), npts, pts);
+  }
+  else
+  {
+    AppendCell(static_cast<vtkIdTypeArray*>(this->Offsets),
+               static_cast<vtkIdTypeArray*>(this->Connectivity), npts, pts);
+  }
+  this->ReleaseLegacyCells(); // Last, pts may point into it
+  return this->NumberOfCells++;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::InsertNextCellOffsets(int)
+{
+  // The end of the cell follows the points added by InsertCellPoint().
+  this->ReleaseLegacyCells();
+  this->Offsets->InsertNextTuple1(this->Connectivity->GetMaxId() + 1);
+  return this->NumberOfCells++;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::InsertCellPointOffsets(vtkIdType id)
+{
+  this->ReleaseLegacyCells();
+  if (this->Storage == OFFSETS32_STORAGE &&
+      (this->Connectivity->GetMaxId() + 2 > Int32Max || !FitsIn32(1, &id)))
+  {
+    this->SetStorageToOffsets();
+  }
+
+  if (this->Storage == OFFSETS32_STORAGE)
+  {
+    AppendCellPoint(static_cast<vtkTypeInt32Array*>(this->Offsets),
+                    static_cast<vtkTypeInt32Array*>(this->Connectivity),
+                    this->NumberOfCells, id);
+  }
+  else
+  {
+    AppendCellPoint(static_cast<vtkIdTypeArray*>(this->Offsets),
+                    static_cast<vtkIdTypeArray*>(this->Connectivity),
+                    this->NumberOfCells, id);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::UpdateCellCountOffsets(int npts)
+{
+  // The cell already ends after the last point inserted; only drop the
+  // extra points if fewer are kept.
+  this->ReleaseLegacyCells();
+  vtkIdType end = this->GetOffset(this->NumberOfCells - 1) + npts;
+  if (end < this->GetOffset(this->NumberOfCells))
+  {
+    this->Offsets->SetTuple1(this->NumberOfCells, end);
+    this->Connectivity->SetNumberOfValues(end);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReverseCellOffsets(vtkIdType cellId)
+{
+  this->ReleaseLegacyCells();
+  if (this->Storage == OFFSETS32_STORAGE)
+  {
+    ReverseCellIds(static_cast<vtkTypeInt32Array*>(this->Offsets),
+                   static_cast<vtkTypeInt32Array*>(this->Connectivity),
+                   cellId);
+  }
+  else
+  {
+    ReverseCellIds(static_cast<vtkIdTypeArray*>(this->Offsets),
+                   static_cast<vtkIdTypeArray*>(this->Connectivity), cellId);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReplaceCellOffsets(vtkIdType cellId, int npts,
+                                      const vtkIdType *pts)
+{
+  if (this->Storage == OFFSETS32_STORAGE && !FitsIn32(npts, pts))
+  {
+    // pts may point into the legacy copy, which widening releases.
+    std::vector<vtkIdType> ids(pts, pts + npts);
+    this->SetStorageToOffsets();
+    ReplaceCellIds(static_cast<vtkIdTypeArray*>(this->Offsets),
+                   static_cast<vtkIdTypeArray*>(this->Connectivity),
+                   cellId, npts, ids.data());
+    return;
+  }
+
+  if (this->Storage == OFFSETS32_STORAGE)
+  {
+    ReplaceCellIds(static_cast<vtkTypeInt32Array*>(this->Offsets),
+                   static_cast<vtkTypeInt32Array*>(this->Connectivity),
+                   cellId, npts, pts);
+  }
+  else
+  {
+    ReplaceCellIds(static_cast<vtkIdTypeArray*>(this->Offsets),
+                   static_cast<vtkIdTypeArray*>(this->Connectivity),
+                   cellId, npts, pts);
+  }
+  this->ReleaseLegacyCells();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::GetNextCell32(vtkIdType& npts, vtkIdType* &pts)
+{
+  CopyCell(static_cast<vtkTypeInt32Array*>(this->Offsets),
+           static_cast<vtkTypeInt32Array*>(this->Connectivity),
+           this->TraversalLocation, this->TraversalCell);
+  npts = this->TraversalCell->GetNumberOfIds();
+  pts = this->TraversalCell->GetPointer(0);
+}
+
+//----------------------------------------------------------------------------
+const vtkTypeInt32 *vtkCellArray::GetCell32(vtkIdType loc, vtkIdType &npts)
+{
+  return this->GetCellAtId32(this->GetCellIdAtLocation(loc), npts);
+}
+
+//----------------------------------------------------------------------------
+const vtkTypeInt32 *vtkCellArray::GetCellAtId32(vtkIdType cellId,
+                                                vtkIdType &npts)
+{
+  const vtkTypeInt32 *offsets =
+    static_cast<vtkTypeInt32Array*>(this->Offsets)->GetPointer(0);
+  npts = offsets[cellId + 1] - offsets[cellId];
+  return static_cast<vtkTypeInt32Array*>(this->Connectivity)->GetPointer(
+    offsets[cellId]);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType *vtkCellArray::GetLegacyCells()
+{
+  // Double-checked so that threads reading the cells only lock until the
+  // copy is made.
+  if (!this->Internals->LegacyCached.load(std::memory_order_acquire))
+  {
+    std::lock_guard<std::mutex> guard(this->Internals->Lock);
+    if (!this->Internals->LegacyCached.load(std::memory_order_relaxed))
+    {
+      if (this->NumberOfCells == 0)
+      {
+        this->Ia->Reset();
+      }
+      else if (this->Storage == OFFSETS32_STORAGE)
+      {
+        OffsetsToLegacy(static_cast<vtkTypeInt32Array*>(this->Offsets),
+                        static_cast<vtkTypeInt32Array*>(this->Connectivity),
+                        this->NumberOfCells, this->Ia);
+      }
+      else
+      {
+        OffsetsToLegacy(static_cast<vtkIdTypeArray*>(this->Offsets),
+                        static_cast<vtkIdTypeArray*>(this->Connectivity),
+                        this->NumberOfCells, this->Ia);
+      }
+      this->Internals->LegacyCached.store(true, std::memory_order_release);
+    }
+  }
+  return this->Ia->GetPointer(0);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReleaseLegacyCells()
+{
+  if (this->Internals->LegacyCached)
+  {
+    this->Ia->Initialize();
+    this->Internals->LegacyCached = false;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::Modified()
+{
+  this->ReleaseLegacyCells();
+  this->Superclass::Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetData(vtkIdTypeArray *offsets,
+                           vtkIdTypeArray *connectivity)
+{
+  this->SetOffsetsData(offsets, connectivity, OFFSETS_STORAGE);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetData(vtkTypeInt32Array *offsets,
+                           vtkTypeInt32Array *connectivity)
+{
+  this->SetOffsetsData(offsets, connectivity, OFFSETS32_STORAGE);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetOffsetsData(vtkDataArray *offsets,
+                                  vtkDataArray *connectivity, int storage)
+{
+  if (!offsets || !connectivity || offsets->GetNumberOfTuples() < 1)
+  {
+    vtkErrorMacro("Offsets must hold at least one value.");
+    return;
+  }
+
+  offsets->Register(this);
+  connectivity->Register(this);
+  this->ReleaseLegacyCells();
+  this->ReleaseOffsets();
+  this->Offsets = offsets;
+  this->Connectivity = connectivity;
+  this->Ia->Initialize();
+  this->Storage = storage;
+  this->NumberOfCells = offsets->GetNumberOfTuples() - 1;
+  this->InsertLocation = 0;
+  this->TraversalLocation = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* vtkCellArray::GetOffsetsArray()
+{
+  if (this->Storage == LEGACY_STORAGE)
+  {
+    this->SetStorageToOffsets();
+  }
+  return this->Offsets;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* vtkCellArray::GetConnectivityArray()
+{
+  if (this->Storage == LEGACY_STORAGE)
+  {
+    this->SetStorageToOffsets();
+  }
+  return this->Connectivity;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::Squeeze()
+{
+  this->Ia->Squeeze();
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    this->Offsets->Squeeze();
+    this->Connectivity->Squeeze();
+  }
+}
+
 //----------------------------------------------------------------------------
 // Returns the size of the largest cell. The size is the number of points
 // defining the cell.
 int vtkCellArray::GetMaxCellSize()
 {
+  if (this->Storage == OFFSETS32_STORAGE)
+  {
+    return MaxCellSize(static_cast<vtkTypeInt32Array*>(this->Offsets),
+                       this->NumberOfCells);
+  }
+  if (this->Storage == OFFSETS_STORAGE)
+  {
+    return MaxCellSize(static_cast<vtkIdTypeArray*>(this->Offsets),
+                       this->NumberOfCells);
+  }
+
   int npts=0, maxSize=0;
   vtkIdType i;
 
@@ -80,6 +976,9 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
 {
   if ( cells && cells != this->Ia )
   {
+    this->ReleaseLegacyCells();
+    this->ReleaseOffsets();
+    this->Storage = LEGACY_STORAGE;
     this->Modified();
     this->Ia->Delete();
     this->Ia = cells;
@@ -94,12 +993,28 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
 //----------------------------------------------------------------------------
 unsigned long vtkCellArray::GetActualMemorySize()
 {
-  return this->Ia->GetActualMemorySize();
+  unsigned long size = this->Ia->GetActualMemorySize();
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    size += this->Offsets->GetActualMemorySize() +
+      this->Connectivity->GetActualMemorySize();
+  }
+  return size;
 }
 
 //----------------------------------------------------------------------------
 int vtkCellArray::GetNextCell(vtkIdList *pts)
 {
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    if (this->TraversalLocation < this->NumberOfCells)
+    {
+      this->GetCellAtId(this->TraversalLocation++, pts);
+      return 1;
+    }
+    return 0;
+  }
+
   vtkIdType npts, *ppts;
   if (this->GetNextCell(npts, ppts))
   {
@@ -116,6 +1031,12 @@ int vtkCellArray::GetNextCell(vtkIdList *pts)
 //----------------------------------------------------------------------------
 void vtkCellArray::GetCell(vtkIdType loc, vtkIdList *pts)
 {
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    this->GetCellAtId(this->GetCellIdAtLocation(loc), pts);
+    return;
+  }
+
   vtkIdType npts = this->Ia->GetValue(loc++);
   vtkIdType *ppts = this->Ia->GetPointer(loc);
   pts->SetNumberOfIds(npts);
@@ -130,6 +1051,8 @@ void vtkCellArray::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
 
+  os << indent << "Storage: " << (this->Storage == LEGACY_STORAGE ? "Legacy" :
+    (this->Storage == OFFSETS_STORAGE ? "Offsets" : "Offsets32")) << endl;
   os << indent << "Number Of Cells: " << this->NumberOfCells << endl;
   os << indent << "Insert Location: " << this->InsertLocation << endl;
   os << indent << "Traversal Location: " << this->TraversalLocation << endl;
@@ -28,6 +28,40 @@
  * using the vtkCellTypes and vtkCellLinks objects to extend the definition of
  * the data structure.
  *
+ * Alternatively the cells can be stored as two arrays (see
+ * SetStorageToOffsets()): a connectivity array holding the point ids of
+ * all cells back to back, (id1,id2,...,idn, id1,id2,...,idn, ...), and an
+ * offsets array of NumberOfCells+1 entries where cell i uses the point ids
+ * in [offsets[i], offsets[i+1]) of the connectivity array. This layout
+ * gives O(1) access to any cell with GetCellAtId() and can be read from
+ * several threads at once, so loops over the cells can be run with
+ * vtkSMPTools. It is also a bit smaller since the point counts are not
+ * stored.
+ *
+ * With OFFSETS32_STORAGE both arrays hold 32-bit integers, which halves the
+ * memory used by the cells when vtkIdType is 64-bit and the connectivity
+ * fits. Point ids are widened to vtkIdType by the accessors: the methods
+ * copying point ids to a vtkIdList read the 32-bit values directly and
+ * GetNextCell() widens the current cell into an internal buffer that is
+ * only valid until the next call. Inserting a point id that does not fit
+ * in 32 bits converts the array to OFFSETS_STORAGE.
+ *
+ * Locations (as used by GetCell(loc,...), GetInsertLocation(),
+ * GetTraversalLocation(), ReverseCell() and ReplaceCell()) always refer to
+ * the legacy layout, whatever the storage, so that location arrays kept
+ * elsewhere (e.g. by vtkUnstructuredGrid) stay valid when the storage is
+ * changed. With offsets storage a location is converted to a cell id by a
+ * binary search; prefer the cell id based methods.
+ *
+ * Reading the cells never changes the storage. With offsets storage,
+ * GetPointer() and GetData() return a legacy copy of the cells, and with
+ * OFFSETS32_STORAGE the methods returning a vtkIdType pointer to a cell
+ * point into that copy. The copy is made on the first call, which is safe
+ * from several threads, and released when the cells are modified. It is
+ * read only: call SetStorageToLegacy() before editing the cells through
+ * these pointers. WritePointer() discards the cells and switches to legacy
+ * storage.
+ *
  * @sa
  * vtkCellTypes vtkCellLinks
 */
@@ -41,6 +75,8 @@
 #include "vtkIdTypeArray.h" // Needed for inline methods
 #include "vtkCell.h" // Needed for inline methods
 
+class vtkTypeInt32Array;
+
 class VTKCOMMONDATAMODEL_EXPORT vtkCellArray : public vtkObject
 {
 public:
@@ -53,10 +89,50 @@ public:
   static vtkCellArray *New();
 
   /**
-   * Allocate memory and set the size to extend by.
+   * The layouts used to store the cells, see the class description.
+   */
+  enum StorageTypes
+  {
+    LEGACY_STORAGE = 0,
+    OFFSETS_STORAGE = 1,
+    OFFSETS32_STORAGE = 2
+  };
+
+  //@{
+  /**
+   * Set/Get how the cells are stored. Changing the storage converts the
+   * cells already in the array. The default is LEGACY_STORAGE. Asking for
+   * OFFSETS32_STORAGE when the cells do not fit in 32 bits (see
+   * CanConvertTo32BitStorage()) or when vtkIdType is 32-bit gives
+   * OFFSETS_STORAGE instead.
+   */
+  void SetStorage(int storage);
+  vtkGetMacro(Storage, int);
+  void SetStorageToLegacy()
+    {this->SetStorage(LEGACY_STORAGE);}
+  void SetStorageToOffsets()
+    {this->SetStorage(OFFSETS_STORAGE);}
+  void SetStorageToOffsets32()
+    {this->SetStorage(OFFSETS32_STORAGE);}
+  //@}
+
+  /**
+   * Return true if the point ids and the offsets of the cells fit in 32-bit
+   * integers, i.e. if OFFSETS32_STORAGE can be used.
+   */
+  bool CanConvertTo32BitStorage();
+
+  /**
+   * Allocate memory and set the size to extend by. The size is expressed
+   * in legacy entries, see EstimateSize().
    */
-  int Allocate(vtkIdType sz, vtkIdType ext=1000)
-    {return this->Ia->Allocate(sz,ext);}
+  int Allocate(vtkIdType sz, vtkIdType ext=1000);
+
+  /**
+   * Allocate memory for numCells cells using connectivitySize point ids in
+   * total. Unlike Allocate(), this is exact for offsets storage.
+   */
+  int AllocateExact(vtkIdType numCells, vtkIdType connectivitySize);
 
   /**
    * Free any memory and reset to an empty state.
@@ -99,7 +175,9 @@ public:
    * A cell traversal methods that is more efficient than vtkDataSet traversal
    * methods.  GetNextCell() gets the next cell in the list. If end of list
    * is encountered, 0 is returned. A value of 1 is returned whenever
-   * npts and pts have been updated without error.
+   * npts and pts have been updated without error. pts is valid until the
+   * cell array is modified, except with OFFSETS32_STORAGE where it points
+   * to an internal buffer that the next call to GetNextCell() overwrites.
    */
   int GetNextCell(vtkIdType& npts, vtkIdType* &pts);
 
@@ -111,18 +189,64 @@ public:
   int GetNextCell(vtkIdList *pts);
 
   /**
-   * Get the size of the allocated connectivity array.
+   * Get the size of the allocated connectivity array. With offsets storage
+   * this is the allocated size of both arrays.
    */
-  vtkIdType GetSize()
-    {return this->Ia->GetSize();}
+  vtkIdType GetSize();
 
   /**
    * Get the total number of entries (i.e., data values) in the connectivity
    * array. This may be much less than the allocated size (i.e., return value
-   * from GetSize().)
+   * from GetSize().) This is the size of the legacy layout, that is the
+   * number of point ids plus the number of cells, whatever the storage.
+   */
+  vtkIdType GetNumberOfConnectivityEntries();
+
+  /**
+   * Get the number of point ids used by all cells, without the cell sizes.
+   */
+  vtkIdType GetNumberOfConnectivityIds();
+
+  /**
+   * Random access to a cell given its id. With offsets storage this is
+   * O(1) and, as long as the cell array is not modified, safe to call from
+   * several threads. With legacy storage the cells before cellId have to be
+   * walked, so it is O(n). The returned pointer is valid until the cell
+   * array is modified. With OFFSETS32_STORAGE it points into the read only
+   * legacy copy of the cells, see the class description.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdType &npts, vtkIdType* &pts);
+
+  /**
+   * Random access to a cell given its id, copying its point ids to the
+   * list. See GetCellAtId() above; this one reads OFFSETS32_STORAGE
+   * without making the legacy copy.
    */
-  vtkIdType GetNumberOfConnectivityEntries()
-    {return this->Ia->GetMaxId()+1;}
+  void GetCellAtId(vtkIdType cellId, vtkIdList* pts);
+
+  //@{
+  /**
+   * With OFFSETS32_STORAGE only, return the 32-bit point ids of a cell
+   * given its legacy location or its id, without widening or copying them.
+   * Safe to call from several threads as long as the cell array is not
+   * modified.
+   */
+  const vtkTypeInt32 *GetCell32(vtkIdType loc, vtkIdType &npts);
+  const vtkTypeInt32 *GetCellAtId32(vtkIdType cellId, vtkIdType &npts);
+  //@}
+
+  /**
+   * Return the number of points of the cell with the given id. See
+   * GetCellAtId().
+   */
+  vtkIdType GetCellSize(vtkIdType cellId);
+
+  /**
+   * Replace the point ids of the cell with the given id. See GetCellAtId()
+   * for the cost. OFFSETS32_STORAGE is only widened when one of
+   * the ids does not fit in 32 bits.
+   */
+  void ReplaceCellAtId(vtkIdType cellId, int npts, const vtkIdType *pts);
 
   /**
    * Internal method used to retrieve a cell given an offset into
@@ -177,23 +301,20 @@ public:
    * Computes the current insertion location within the internal array.
    * Used in conjunction with GetCell(int loc,...).
    */
-  vtkIdType GetInsertLocation(int npts)
-    {return (this->InsertLocation - npts - 1);};
+  vtkIdType GetInsertLocation(int npts);
 
   /**
    * Get/Set the current traversal location.
    */
-  vtkIdType GetTraversalLocation()
-    {return this->TraversalLocation;}
-  void SetTraversalLocation(vtkIdType loc)
-    {this->TraversalLocation = loc;}
+  vtkIdType GetTraversalLocation();
+  void SetTraversalLocation(vtkIdType loc);
 
   /**
    * Computes the current traversal location within the internal array. Used
    * in conjunction with GetCell(int loc,...).
    */
   vtkIdType GetTraversalLocation(vtkIdType npts)
-    {return(this->TraversalLocation-npts-1);}
+    {return(this->GetTraversalLocation()-npts-1);}
 
   /**
    * Special method inverts ordering of current cell. Must be called
@@ -216,15 +337,23 @@ public:
   int GetMaxCellSize();
 
   /**
-   * Get pointer to array of cell data.
+   * Get pointer to array of cell data. With offsets storage this is the
+   * read only legacy copy of the cells, see the class description.
    */
   vtkIdType *GetPointer()
-    {return this->Ia->GetPointer(0);}
+  {
+    if (this->Storage != LEGACY_STORAGE)
+    {
+      return this->GetLegacyCells();
+    }
+    return this->Ia->GetPointer(0);
+  }
 
   /**
    * Get pointer to data array for purpose of direct writes of data. Size is the
    * total storage consumed by the cell array. ncells is the number of cells
-   * represented in the array.
+   * represented in the array. This switches the cell array to legacy
+   * storage.
    */
   vtkIdType *WritePointer(const vtkIdType ncells, const vtkIdType size);
 
@@ -239,16 +368,46 @@ public:
    */
   void SetCells(vtkIdType ncells, vtkIdTypeArray *cells);
 
+  /**
+   * Define the cells with offsets storage from an offsets array of
+   * (number of cells + 1) values starting at 0, and a connectivity array
+   * of point ids. The arrays are used directly, not copied. The same
+   * caveats as for SetCells() apply.
+   */
+  void SetData(vtkIdTypeArray *offsets, vtkIdTypeArray *connectivity);
+
+  /**
+   * Same as above with OFFSETS32_STORAGE.
+   */
+  void SetData(vtkTypeInt32Array *offsets, vtkTypeInt32Array *connectivity);
+
   /**
    * Perform a deep copy (no reference counting) of the given cell array.
    */
   void DeepCopy(vtkCellArray *ca);
 
   /**
-   * Return the underlying data as a data array.
+   * Return the underlying data as a data array. With offsets storage this
+   * is the read only legacy copy of the cells, see the class description.
    */
   vtkIdTypeArray* GetData()
-    {return this->Ia;}
+  {
+    if (this->Storage != LEGACY_STORAGE)
+    {
+      this->GetLegacyCells();
+    }
+    return this->Ia;
+  }
+
+  //@{
+  /**
+   * Return the offsets and connectivity arrays of the offsets storage, a
+   * vtkIdTypeArray or a vtkTypeInt32Array depending on the storage. Legacy
+   * storage is converted to OFFSETS_STORAGE.
+   */
+  vtkDataArray* GetOffsetsArray();
+  vtkDataArray* GetConnectivityArray();
+  //@}
 
   /**
    * Reuse list. Reset to initial condition.
@@ -258,8 +417,7 @@ public:
   /**
    * Reclaim any extra memory.
    */
-  void Squeeze()
-    {this->Ia->Squeeze();}
+  void Squeeze();
 
   /**
    * Return the memory in kibibytes (1024 bytes) consumed by this cell array. Used to
@@ -271,15 +429,56 @@ public:
    */
   unsigned long GetActualMemorySize();
 
+  /**
+   * Also releases the legacy copy of offsets storage cells.
+   */
+  void Modified() VTK_OVERRIDE;
+
 protected:
   vtkCellArray();
   ~vtkCellArray() VTK_OVERRIDE;
 
+  // Binary search for the id of the cell at a legacy location, offsets
+  // storages only.
+  vtkIdType GetCellIdAtLocation(vtkIdType loc);
+
+  // Offsets storages part of the inline methods.
+  vtkIdType InsertNextCellOffsets(vtkIdType npts, const vtkIdType* pts);
+  vtkIdType InsertNextCellOffsets(int npts);
+  void InsertCellPointOffsets(vtkIdType id);
+  void UpdateCellCountOffsets(int npts);
+  void ReverseCellOffsets(vtkIdType cellId);
+  void ReplaceCellOffsets(vtkIdType cellId, int npts, const vtkIdType *pts);
+  void GetNextCell32(vtkIdType& npts, vtkIdType* &pts);
+
+  // The legacy copy of offsets storage cells, kept in Ia.
+  vtkIdType *GetLegacyCells();
+  void ReleaseLegacyCells();
+
+  void ConvertToOffsets(int storage);
+  void ConvertToLegacy();
+  void ConvertOffsets(int storage);
+  void SetOffsetsData(vtkDataArray *offsets, vtkDataArray *connectivity,
+                      int storage);
+  void ReleaseOffsets();
+  vtkIdType GetOffset(vtkIdType cellId);
+
+  int Storage;
   vtkIdType NumberOfCells;
   vtkIdType InsertLocation;     //keep track of current insertion point
   vtkIdType TraversalLocation;   //keep track of traversal position
   vtkIdTypeArray *Ia;
 
+  // Offsets storages: vtkIdTypeArray for OFFSETS_STORAGE and
+  // vtkTypeInt32Array for OFFSETS32_STORAGE. The traversal location is then
+  // the id of the next cell and the insert location is not used.
+  vtkDataArray *Offsets;
+  vtkDataArray *Connectivity;
+  vtkIdList *TraversalCell; // GetNextCell() buffer for OFFSETS32_STORAGE
+
+  class vtkInternals;
+  vtkInternals *Internals; // Guards the legacy copy of the cells
+
 private:
   vtkCellArray(const vtkCellArray&) VTK_DELETE_FUNCTION;
   void operator=(const vtkCellArray&) VTK_DELETE_FUNCTION;
@@ -290,6 +489,11 @@ private:
 inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
                                               const vtkIdType* pts)
 {
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    return this->InsertNextCellOffsets(npts, pts);
+  }
+
   vtkIdType i = this->Ia->GetMaxId() + 1;
   vtkIdType *ptr = this->Ia->WritePointer(i, npts+1);
 
@@ -307,6 +511,11 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 {
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    return this->InsertNextCellOffsets(npts);
+  }
+
   this->InsertLocation = this->Ia->InsertNextValue(npts) + 1;
   this->NumberOfCells++;
 
@@ -316,12 +525,24 @@ inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 //----------------------------------------------------------------------------
 inline void vtkCellArray::InsertCellPoint(vtkIdType id)
 {
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    this->InsertCellPointOffsets(id);
+    return;
+  }
+
   this->Ia->InsertValue(this->InsertLocation++, id);
 }
 
 //----------------------------------------------------------------------------
 inline void vtkCellArray::UpdateCellCount(int npts)
 {
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    this->UpdateCellCountOffsets(npts);
+    return;
+  }
+
   this->Ia->SetValue(this->InsertLocation-npts-1, npts);
 }
 
@@ -338,18 +559,29 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkCell *cell)
                               cell->PointIds->GetPointer(0));
 }
 
-//----------------------------------------------------------------------------
-inline void vtkCellArray::Reset()
-{
-  this->NumberOfCells = 0;
-  this->InsertLocation = 0;
-  this->TraversalLocation = 0;
-  this->Ia->Reset();
-}
-
 //----------------------------------------------------------------------------
 inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 {
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    if (this->TraversalLocation < this->NumberOfCells)
+    {
+      if (this->Storage == OFFSETS_STORAGE)
+      {
+        this->GetCellAtId(this->TraversalLocation, npts, pts);
+      }
+      else
+      {
+        this->GetNextCell32(npts, pts);
+      }
+      this->TraversalLocation++;
+      return 1;
+    }
+    npts=0;
+    pts=nullptr;
+    return 0;
+  }
+
   if ( this->Ia->GetMaxId() >= 0 &&
        this->TraversalLocation <= this->Ia->GetMaxId() )
   {
@@ -363,10 +595,46 @@ inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
   return 0;
 }
 
+//----------------------------------------------------------------------------
+inline void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdType &npts,
+                                      vtkIdType* &pts)
+{
+  if (this->Storage == OFFSETS32_STORAGE)
+  {
+    vtkIdType *legacy = this->GetLegacyCells();
+    vtkIdType loc = this->GetOffset(cellId) + cellId;
+    npts = legacy[loc];
+    pts = legacy + loc + 1;
+    return;
+  }
+  if (this->Storage == OFFSETS_STORAGE)
+  {
+    vtkIdType *offsets =
+      static_cast<vtkIdTypeArray*>(this->Offsets)->GetPointer(0);
+    npts = offsets[cellId + 1] - offsets[cellId];
+    pts = static_cast<vtkIdTypeArray*>(this->Connectivity)->GetPointer(
+      offsets[cellId]);
+    return;
+  }
+
+  vtkIdType loc = 0;
+  for (vtkIdType i = 0; i < cellId; i++)
+  {
+    loc += this->Ia->GetValue(loc) + 1;
+  }
+  this->GetCell(loc, npts, pts);
+}
+
 //----------------------------------------------------------------------------
 inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
                                   vtkIdType* &pts)
 {
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    this->GetCellAtId(this->GetCellIdAtLocation(loc), npts, pts);
+    return;
+  }
+
   npts = this->Ia->GetValue(loc++);
   pts  = this->Ia->GetPointer(loc);
 }
@@ -374,6 +642,12 @@ inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
 //----------------------------------------------------------------------------
 inline void vtkCellArray::ReverseCell(vtkIdType loc)
 {
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    this->ReverseCellOffsets(this->GetCellIdAtLocation(loc));
+    return;
+  }
+
   int i;
   vtkIdType tmp;
   vtkIdType npts=this->Ia->GetValue(loc);
@@ -390,6 +664,12 @@ inline void vtkCellArray::ReverseCell(vtkIdType loc)
 inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
                                       const vtkIdType *pts)
 {
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    this->ReplaceCellOffsets(this->GetCellIdAtLocation(loc), npts, pts);
+    return;
+  }
+
   vtkIdType *oldPts=this->Ia->GetPointer(loc+1);
   for (int i=0; i < npts; i++)
   {
@@ -397,10 +677,34 @@ inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
   }
 }
 
+//----------------------------------------------------------------------------
+inline void vtkCellArray::ReplaceCellAtId(vtkIdType cellId, int npts,
+                                          const vtkIdType *pts)
+{
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    this->ReplaceCellOffsets(cellId, npts, pts);
+    return;
+  }
+
+  vtkIdType loc = 0;
+  for (vtkIdType i = 0; i < cellId; i++)
+  {
+    loc += this->Ia->GetValue(loc) + 1;
+  }
+  this->ReplaceCell(loc, npts, pts);
+}
+
 //----------------------------------------------------------------------------
 inline vtkIdType *vtkCellArray::WritePointer(const vtkIdType ncells,
                                              const vtkIdType size)
 {
+  if (this->Storage != LEGACY_STORAGE)
+  {
+    // The old cells are discarded, there is nothing to convert.
+    this->NumberOfCells = 0;
+    this->ConvertToLegacy();
+  }
   this->NumberOfCells = ncells;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
@@ -16,9 +16,8 @@
 
 #include "vtkCellArray.h"
 #include "vtkDataSet.h"
-#include "vtkGenericCell.h"
+#include "vtkIdList.h"
 #include "vtkObjectFactory.h"
-#include "vtkPolyData.h"
 
 vtkStandardNewMacro(vtkCellLinks);
 
@@ -129,78 +128,45 @@ void vtkCellLinks::BuildLinks(vtkDataSet *data)
 {
   vtkIdType numPts = data->GetNumberOfPoints();
   vtkIdType numCells = data->GetNumberOfCells();
-  int j;
-  vtkIdType cellId;
-  unsigned short *linkLoc;
-
-  // fill out lists with number of references to cells
-  linkLoc = new unsigned short[numPts];
-  memset(linkLoc, 0, numPts*sizeof(unsigned short));
+  vtkIdType npts, j, cellId;
+  const vtkIdType *pts;
+  vtkIdList *cellPts = vtkIdList::New();
 
-  // Use fast path if polydata
-  if ( data->GetDataObjectType() == VTK_POLY_DATA )
+  // The first access builds the cell structures of the dataset, if needed.
+  if (numCells > 0)
   {
-    vtkIdType *pts, npts;
-
-    vtkPolyData *pdata = static_cast<vtkPolyData *>(data);
-    // traverse data to determine number of uses of each point
-    for (cellId=0; cellId < numCells; cellId++)
-    {
-      pdata->GetCellPoints(cellId, npts, pts);
-      for (j=0; j < npts; j++)
-      {
-        this->IncrementLinkCount(pts[j]);
-      }
-    }
-
-    // now allocate storage for the links
-    this->AllocateLinks(numPts);
-    this->MaxId = numPts - 1;
-
-    for (cellId=0; cellId < numCells; cellId++)
-    {
-      pdata->GetCellPoints(cellId, npts, pts);
-      for (j=0; j < npts; j++)
-      {
-        this->InsertCellReference(pts[j], (linkLoc[pts[j]])++, cellId);
-      }
-    }
+    data->GetCellPoints(0, cellPts);
   }
 
-  else //any other type of dataset
+  // traverse data to determine number of uses of each point
+  for (cellId=0; cellId < numCells; cellId++)
   {
-    vtkIdType numberOfPoints, ptId;
-    vtkGenericCell *cell=vtkGenericCell::New();
-
-    // traverse data to determine number of uses of each point
-    for (cellId=0; cellId < numCells; cellId++)
+    data->GetCellPoints(cellId, npts, pts, cellPts);
+    for (j=0; j < npts; j++)
     {
-      data->GetCell(cellId,cell);
-      numberOfPoints = cell->GetNumberOfPoints();
-      for (j=0; j < numberOfPoints; j++)
-      {
-        this->IncrementLinkCount(cell->PointIds->GetId(j));
-      }
+      this->IncrementLinkCount(pts[j]);
     }
+  }
 
-    // now allocate storage for the links
-    this->AllocateLinks(numPts);
-    this->MaxId = numPts - 1;
+  // now allocate storage for the links
+  this->AllocateLinks(numPts);
+  this->MaxId = numPts - 1;
 
-    for (cellId=0; cellId < numCells; cellId++)
+  // fill out lists with references to cells
+  unsigned short *linkLoc = new unsigned short[numPts];
+  memset(linkLoc, 0, numPts*sizeof(unsigned short));
+
+  for (cellId=0; cellId < numCells; cellId++)
+  {
+    data->GetCellPoints(cellId, npts, pts, cellPts);
+    for (j=0; j < npts; j++)
     {
-      data->GetCell(cellId,cell);
-      numberOfPoints = cell->GetNumberOfPoints();
-      for (j=0; j < numberOfPoints; j++)
-      {
-        ptId = cell->PointIds->GetId(j);
-        this->InsertCellReference(ptId, (linkLoc[ptId])++, cellId);
-      }
+      this->InsertCellReference(pts[j], (linkLoc[pts[j]])++, cellId);
     }
-    cell->Delete();
-  }//end else
+  }
 
   delete [] linkLoc;
+  cellPts->Delete();
 }
 
 //----------------------------------------------------------------------------
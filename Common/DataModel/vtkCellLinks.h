@@ -80,7 +80,7 @@ public:
   /**
    * Clear out any previously allocated data structures
    */
-  void Initialize();
+  void Initialize() VTK_OVERRIDE;
 
   /**
    * Get a link structure given a point id.
@@ -138,12 +138,12 @@ public:
   /**
    * Reclaim any unused memory.
    */
-  void Squeeze();
+  void Squeeze() VTK_OVERRIDE;
 
   /**
    * Reset to a state of no entries without freeing the memory.
    */
-  void Reset();
+  void Reset() VTK_OVERRIDE;
 
   /**
    * Return the memory in kibibytes (1024 bytes) consumed by this cell links array.
@@ -153,7 +153,7 @@ public:
    * The information returned is valid only after the pipeline has
    * been updated.
    */
-  unsigned long GetActualMemorySize();
+  unsigned long GetActualMemorySize() VTK_OVERRIDE;
 
   /**
    * Standard DeepCopy method.  Since this object contains no reference
@@ -162,7 +162,8 @@ public:
   void DeepCopy(vtkCellLinks *src);
 
 protected:
-  vtkCellLinks():Array(nullptr),Size(0),MaxId(-1),Extend(1000) {}
+  vtkCellLinks():Array(nullptr),Size(0),MaxId(-1),Extend(1000)
+    { this->Type = vtkAbstractCellLinks::CELL_LINKS; }
   ~vtkCellLinks() VTK_OVERRIDE;
 
   /**
@@ -325,6 +325,17 @@ void vtkDataSet::GetCellTypes(vtkCellTypes *types)
   }
 }
 
+//----------------------------------------------------------------------------
+// Default implementation, copying the ids. Datasets with explicit
+// connectivity override it to avoid the copy.
+void vtkDataSet::GetCellPoints(vtkIdType cellId, vtkIdType& npts,
+                               vtkIdType const*& pts, vtkIdList *ptIds) const
+{
+  // The implicit datasets compute the ids without modifying themselves.
+  const_cast<vtkDataSet*>(this)->GetCellPoints(cellId, ptIds);
+  npts = ptIds->GetNumberOfIds();
+  pts = ptIds->GetPointer(0);
+}
 
 //----------------------------------------------------------------------------
 // Default implementation. This is very slow way to compute this information.
@@ -163,6 +163,19 @@ public:
    */
   virtual void GetCellPoints(vtkIdType cellId, vtkIdList *ptIds) = 0;
 
+  /**
+   * Topological inquiry to get the points defining a cell without copying
+   * them when possible. On return pts points to the npts point ids of the
+   * cell. Datasets with explicit connectivity point into their own storage;
+   * otherwise the ids are copied to ptIds, which must not be nullptr, and
+   * pts points into it. pts is valid until the dataset or ptIds is
+   * modified.
+   * This method does not modify the dataset. THIS METHOD IS THREAD SAFE
+   * WITH ONE ptIds PER THREAD as long as the dataset is not modified.
+   */
+  virtual void GetCellPoints(vtkIdType cellId, vtkIdType& npts,
+                             vtkIdType const*& pts, vtkIdList *ptIds) const;
+
   /**
    * Topological inquiry to get cells using point.
    * THIS METHOD IS THREAD SAFE IF FIRST CALLED FROM A SINGLE THREAD AND
@@ -34,6 +34,7 @@
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
 #include "vtkUnsignedShortArray.h"
+#include <mutex>
 #include <vector>
 
 namespace
@@ -877,6 +878,92 @@ void vtkDataSetAttributes::CopyData(vtkDataSetAttributes *fromPd,
   }
 }
 
+//--------------------------------------------------------------------------
+namespace {
+// Serializes the GatherData() calls that cannot use the typed worker.
+std::mutex GatherDataMutex;
+
+struct GatherDataWorker
+{
+  const vtkIdType *SrcIds;
+  vtkIdType DstStart;
+  vtkIdType N;
+
+  GatherDataWorker(const vtkIdType *srcIds, vtkIdType dstStart, vtkIdType n)
+    : SrcIds(srcIds), DstStart(dstStart), N(n)
+  {}
+
+  template <typename Array1T, typename Array2T>
+  void operator()(Array1T *dest, Array2T *src)
+  {
+    VTK_ASSUME(src->GetNumberOfComponents() == dest->GetNumberOfComponents());
+
+    vtkDataArrayAccessor<Array1T> d(dest);
+    vtkDataArrayAccessor<Array2T> s(src);
+
+    const int numComps = dest->GetNumberOfComponents();
+    for (vtkIdType i = 0; i < this->N; ++i)
+    {
+      const vtkIdType srcId = this->SrcIds[i];
+      for (int comp = 0; comp < numComps; ++comp)
+      {
+        d.Set(this->DstStart + i, comp, s.Get(srcId, comp));
+      }
+    }
+  }
+};
+} // end anon namespace
+
+//--------------------------------------------------------------------------
+void vtkDataSetAttributes::GatherData(vtkDataSetAttributes *fromPd,
+                                      const vtkIdType *srcIds,
+                                      vtkIdType dstStart, vtkIdType n)
+{
+  // Iterate over a copy of the required arrays, the threads must not share
+  // the position of the iterator.
+  vtkFieldData::BasicIterator requiredArrays(this->RequiredArrays);
+  for (int i = requiredArrays.BeginIndex(); !requiredArrays.End();
+       i = requiredArrays.NextIndex())
+  {
+    vtkAbstractArray *fromArray = fromPd->Data[i];
+    vtkAbstractArray *toArray = this->Data[this->TargetIndices[i]];
+    vtkDataArray *fromDA = vtkArrayDownCast<vtkDataArray>(fromArray);
+    vtkDataArray *toDA = vtkArrayDownCast<vtkDataArray>(toArray);
+
+    GatherDataWorker worker(srcIds, dstStart, n);
+    if (fromDA && toDA &&
+        vtkArrayDispatch::Dispatch2SameValueType::Execute(toDA, fromDA,
+                                                          worker))
+    {
+      continue;
+    }
+
+    // Fallback to the tuple API, exact for any array type. It is not
+    // thread-safe for every array (the tuples of a vtkBitArray share bytes,
+    // mapped arrays fill temporary tuples...), so the threads take turns.
+    std::lock_guard<std::mutex> lock(GatherDataMutex);
+    for (vtkIdType j = 0; j < n; ++j)
+    {
+      toArray->SetTuple(dstStart + j, srcIds[j], fromArray);
+    }
+  }
+}
+
+//--------------------------------------------------------------------------
+vtkAbstractArray* vtkDataSetAttributes::GetTargetArray(int fromIndex)
+{
+  vtkFieldData::BasicIterator requiredArrays(this->RequiredArrays);
+  for (int i = requiredArrays.BeginIndex(); !requiredArrays.End();
+       i = requiredArrays.NextIndex())
+  {
+    if (i == fromIndex)
+    {
+      return this->Data[this->TargetIndices[i]];
+    }
+  }
+  return nullptr;
+}
+
 //--------------------------------------------------------------------------
 void vtkDataSetAttributes::CopyAllocate(vtkDataSetAttributes* pd,
                                         vtkIdType sze, vtkIdType ext,
@@ -472,6 +472,29 @@ public:
   void CopyData(vtkDataSetAttributes *fromPd, vtkIdType dstStart, vtkIdType n,
                 vtkIdType srcStart);
 
+  /**
+   * Copy the attributes srcIds[0], ..., srcIds[n-1] of fromPd to the n
+   * consecutive tuples of this container starting at dstStart. Make sure
+   * CopyAllocate() has been invoked with fromPd, and that the output arrays
+   * already hold the dstStart+n tuples (see SetNumberOfTuples()): unlike
+   * CopyData(), this method allocates nothing and is thread-safe, so
+   * several threads can fill disjoint ranges of tuples. Only the arrays
+   * handled by vtkArrayDispatch are filled concurrently, the others (e.g.
+   * vtkBitArray or mapped arrays) are copied by one thread at a time.
+   */
+  void GatherData(vtkDataSetAttributes *fromPd, const vtkIdType *srcIds,
+                  vtkIdType dstStart, vtkIdType n);
+
+  /**
+   * Return the array of this container that receives the values of the
+   * array at index fromIndex of the container given to the last
+   * CopyAllocate() or InterpolateAllocate(), or nullptr if that array is
+   * not copied.
+   * This lets filters process the array pairs with their own (e.g. typed
+   * or threaded) kernels instead of CopyData() or InterpolatePoint().
+   */
+  vtkAbstractArray *GetTargetArray(int fromIndex);
+
   //@{
   /**
    * Copy a tuple (or set of tuples) of data from one data array to another.
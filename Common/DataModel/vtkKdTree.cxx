@@ -41,6 +41,10 @@
 #include "vtkUniformGrid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkCallbackCommand.h"
+#include "vtkGenericCell.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #ifdef _MSC_VER
 #pragma warning ( disable : 4100 )
@@ -50,6 +54,7 @@
 #include <map>
 #include <queue>
 #include <set>
+#include <vector>
 
 
 // Timing data ---------------------------------------------
@@ -173,6 +178,27 @@ namespace
     float LargestDist2;
     std::map<float, std::list<vtkIdType> > dist2ToIds; // map from dist^2 to a list of ids
   };
+
+  // Lists the regions whose data bounds intersect a sphere, as
+  // vtkBSPIntersections::IntersectsSphere2() does with
+  // ComputeIntersectionsUsingDataBounds on. Toggling that flag would make
+  // concurrent point queries race, so the tree is walked here instead.
+  int FindRegionsInSphere(vtkKdNode *node, int *ids,
+                          double x, double y, double z, double rSquared)
+  {
+    if (!node->IntersectsSphere2(x, y, z, rSquared, 1))
+    {
+      return 0;
+    }
+    if (node->GetLeft() == nullptr)
+    {
+      ids[0] = node->GetID();
+      return 1;
+    }
+    int nnodes = FindRegionsInSphere(node->GetLeft(), ids, x, y, z, rSquared);
+    return nnodes +
+      FindRegionsInSphere(node->GetRight(), ids + nnodes, x, y, z, rSquared);
+  }
 }
 
 vtkStandardNewMacro(vtkKdTree);
@@ -568,6 +594,127 @@ void vtkKdTree::GetLeafNodeIds(vtkKdNode *node, vtkIntArray *ids)
   }
 }
 
+//----------------------------------------------------------------------------
+// Helper classes to support threaded execution of the build.
+namespace
+{
+
+// Compute the centers of a range of cells of one data set.
+struct vtkKdTreeCellCenters
+{
+  vtkDataSet *DataSet;
+  float *Centers;
+  int MaxCellSize;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocal<std::vector<double> > Weights;
+
+  vtkKdTreeCellCenters(vtkDataSet *set, float *centers) :
+    DataSet(set), Centers(centers)
+  {
+    // Some data sets build their cell structures on the first request,
+    // which is not thread safe.
+    this->MaxCellSize = set->GetMaxCellSize();
+    set->GetCell(0, this->Cell.Local());
+  }
+
+  void Initialize()
+  {
+    this->Weights.Local().resize(this->MaxCellSize > 0 ? this->MaxCellSize : 1);
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkGenericCell *cell = this->Cell.Local();
+    double *weights = &this->Weights.Local()[0];
+    float *cptr = this->Centers + 3*cellId;
+    double pcoords[3], dcenter[3];
+
+    for ( ; cellId < endCellId; ++cellId, cptr += 3)
+    {
+      this->DataSet->GetCell(cellId, cell);
+      int subId = cell->GetParametricCenter(pcoords);
+      cell->EvaluateLocation(subId, pcoords, dcenter, weights);
+      cptr[0] = static_cast<float>(dcenter[0]);
+      cptr[1] = static_cast<float>(dcenter[1]);
+      cptr[2] = static_cast<float>(dcenter[2]);
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// Find the region containing the center of each cell of a range.
+struct vtkKdTreeFindRegions
+{
+  vtkKdTree *Tree;
+  const float *Centers;
+  int *Regions;
+
+  vtkKdTreeFindRegions(vtkKdTree *tree, const float *centers, int *regions) :
+    Tree(tree), Centers(centers), Regions(regions)
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    const float *pt = this->Centers + 3*cellId;
+    for ( ; cellId < endCellId; ++cellId, pt += 3)
+    {
+      this->Regions[cellId] =
+        this->Tree->GetRegionContainingPoint(pt[0], pt[1], pt[2]);
+    }
+  }
+};
+
+} // anonymous namespace
+
+// A region waiting to be divided, with its cell centers (and ids).
+struct vtkKdTreeRegion
+{
+  vtkKdNode *Node;
+  float *Centers;
+  int *Ids;
+  int Level;
+};
+
+// Divide a set of independent regions, one region at a time per thread.
+// Either the regions are only split in two (the top levels of the tree) or
+// they are divided recursively.
+struct vtkKdTreeDivideRegions
+{
+  vtkKdTree *Tree;
+  std::vector<vtkKdTreeRegion> &Regions;
+  bool Recursive;
+
+  vtkKdTreeDivideRegions(vtkKdTree *tree,
+                         std::vector<vtkKdTreeRegion> &regions,
+                         bool recursive) :
+    Tree(tree), Regions(regions), Recursive(recursive)
+  {
+  }
+
+  void operator()(vtkIdType region, vtkIdType endRegion)
+  {
+    for ( ; region < endRegion; ++region)
+    {
+      vtkKdTreeRegion &r = this->Regions[region];
+      if (this->Recursive)
+      {
+        this->Tree->DivideRegion(r.Node, r.Centers, r.Ids, r.Level);
+      }
+      else
+      {
+        this->Tree->SplitRegion(r.Node, r.Centers, r.Ids, r.Level);
+      }
+    }
+  }
+
+private:
+  void operator=(const vtkKdTreeDivideRegions&) VTK_DELETE_FUNCTION;
+};
+
 //----------------------------------------------------------------------------
 float *vtkKdTree::ComputeCellCenters()
 {
@@ -614,69 +761,30 @@ float *vtkKdTree::ComputeCellCenters(vtkDataSet *set)
     return nullptr;
   }
 
-  int maxCellSize = 0;
-
-  if (set)
-  {
-    maxCellSize = set->GetMaxCellSize();
-  }
-  else
-  {
-    vtkCollectionSimpleIterator cookie;
-    this->DataSets->InitTraversal(cookie);
-    for (vtkDataSet *iset = this->DataSets->GetNextDataSet(cookie);
-         iset != nullptr; iset = this->DataSets->GetNextDataSet(cookie))
-    {
-      int cellSize = iset->GetMaxCellSize();
-      maxCellSize = (cellSize > maxCellSize) ? cellSize : maxCellSize;
-    }
-  }
-
-  double *weights = new double [maxCellSize];
-
+  // The centers are computed in parallel, one data set after the other.
   float *cptr = center;
-  double dcenter[3];
+  int numCellsSoFar = 0;
 
-  if (set)
+  vtkCollectionSimpleIterator cookie;
+  this->DataSets->InitTraversal(cookie);
+  for (vtkDataSet *iset = (set ? set : this->DataSets->GetNextDataSet(cookie));
+       iset != nullptr;
+       iset = (set ? nullptr : this->DataSets->GetNextDataSet(cookie)))
   {
-    for (int j=0; j<totalCells; j++)
+    int nCells = iset->GetNumberOfCells();
+    if (nCells == 0)
     {
-      this->ComputeCellCenter(set->GetCell(j), dcenter, weights);
-      cptr[0] = static_cast<float>(dcenter[0]);
-      cptr[1] = static_cast<float>(dcenter[1]);
-      cptr[2] = static_cast<float>(dcenter[2]);
-      cptr += 3;
-      if (j%1000 == 0)
-      {
-        this->UpdateSubOperationProgress(static_cast<double>(j)/totalCells);
-      }
+      continue;
     }
-  }
-  else
-  {
-    vtkCollectionSimpleIterator cookie;
-    this->DataSets->InitTraversal(cookie);
-    for (vtkDataSet *iset = this->DataSets->GetNextDataSet(cookie);
-         iset != nullptr; iset = this->DataSets->GetNextDataSet(cookie))
-    {
-      int nCells = iset->GetNumberOfCells();
 
-      for (int j=0; j<nCells; j++)
-      {
-        this->ComputeCellCenter(iset->GetCell(j), dcenter, weights);
-        cptr[0] = static_cast<float>(dcenter[0]);
-        cptr[1] = static_cast<float>(dcenter[1]);
-        cptr[2] = static_cast<float>(dcenter[2]);
-        cptr += 3;
-        if (j%1000 == 0)
-        {
-          this->UpdateSubOperationProgress(static_cast<double>(j)/totalCells);
-        }
-      }
-    }
-  }
+    vtkKdTreeCellCenters centers(iset, cptr);
+    vtkSMPTools::For(0, nCells, centers);
+    cptr += 3 * nCells;
 
-  delete [] weights;
+    numCellsSoFar += nCells;
+    this->UpdateSubOperationProgress(
+      static_cast<double>(numCellsSoFar)/totalCells);
+  }
 
   this->UpdateSubOperationProgress(1.0);
   return center;
@@ -887,7 +995,7 @@ void vtkKdTree::BuildLocator()
 
     this->ProgressOffset += this->ProgressScale;
     this->ProgressScale = 0.7;
-    this->DivideRegion(kd, ptarray, nullptr, 0);
+    this->DivideRegionInParallel(kd, ptarray, nullptr);
 
     TIMERDONE("Build tree");
 
@@ -1214,6 +1322,77 @@ int vtkKdTree::DivideTest(int size, int level)
 }
 //----------------------------------------------------------------------------
 int vtkKdTree::DivideRegion(vtkKdNode *kd, float *c1, int *ids, int level)
+{
+  if (!this->SplitRegion(kd, c1, ids, level))
+  {
+    return 0;
+  }
+
+  int nleft = kd->GetLeft()->GetNumberOfPoints();
+
+  int *leftIds  = ids;
+  int *rightIds = ids ? ids + nleft : nullptr;
+
+  this->DivideRegion(kd->GetLeft(), c1, leftIds, level + 1);
+
+  this->DivideRegion(kd->GetRight(), c1 + nleft*3, rightIds, level + 1);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+// The regions of one level of the tree are independent. The top levels are
+// split one level at a time, the regions of a level in parallel, until there
+// are enough regions to keep all the threads busy. These regions are then
+// divided recursively in parallel. The tree is the same as the one built by
+// DivideRegion(), only the order in which the nodes are created changes.
+void vtkKdTree::DivideRegionInParallel(vtkKdNode *kd, float *c1, int *ids)
+{
+  int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  if (numThreads < 2)
+  {
+    this->DivideRegion(kd, c1, ids, 0);
+    return;
+  }
+
+  std::vector<vtkKdTreeRegion> regions, nextRegions;
+  vtkKdTreeRegion top = { kd, c1, ids, 0 };
+  regions.push_back(top);
+
+  while (!regions.empty() &&
+         regions.size() < static_cast<size_t>(8 * numThreads))
+  {
+    vtkKdTreeDivideRegions split(this, regions, false);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(regions.size()), 1, split);
+
+    nextRegions.clear();
+    for (size_t i = 0; i < regions.size(); i++)
+    {
+      const vtkKdTreeRegion &r = regions[i];
+      if (r.Node->GetLeft() == nullptr)
+      {
+        continue;   // a leaf
+      }
+      int nleft = r.Node->GetLeft()->GetNumberOfPoints();
+      vtkKdTreeRegion left = { r.Node->GetLeft(), r.Centers, r.Ids,
+                               r.Level + 1 };
+      vtkKdTreeRegion right = { r.Node->GetRight(), r.Centers + nleft*3,
+                                r.Ids ? r.Ids + nleft : nullptr, r.Level + 1 };
+      nextRegions.push_back(left);
+      nextRegions.push_back(right);
+    }
+    regions.swap(nextRegions);
+  }
+
+  vtkKdTreeDivideRegions divide(this, regions, true);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(regions.size()), 1, divide);
+}
+
+//----------------------------------------------------------------------------
+// Split a region in two, if the division criteria allow it.  Returns 1 if
+// the region now has two children.
+//
+int vtkKdTree::SplitRegion(vtkKdNode *kd, float *c1, int *ids, int level)
 {
   int ok = this->DivideTest(kd->GetNumberOfPoints(), level);
 
@@ -1268,21 +1447,7 @@ int vtkKdTree::DivideRegion(vtkKdNode *kd, float *c1, int *ids, int level)
 
   this->DoMedianFind(kd, c1, ids, dim1, dim2, dim3);
 
-  if (kd->GetLeft() == nullptr)
-  {
-    return 0;   // unable to divide region further
-  }
-
-  int nleft = kd->GetLeft()->GetNumberOfPoints();
-
-  int *leftIds  = ids;
-  int *rightIds = ids ? ids + nleft : nullptr;
-
-  this->DivideRegion(kd->GetLeft(), c1, leftIds, level + 1);
-
-  this->DivideRegion(kd->GetRight(), c1 + nleft*3, rightIds, level + 1);
-
-  return 0;
+  return (kd->GetLeft() != nullptr);
 }
 
 //----------------------------------------------------------------------------
@@ -1838,7 +2003,7 @@ void vtkKdTree::BuildLocatorFromPoints(vtkPoints **ptArrays, int numPtArrays)
 
   TIMER("Build tree");
 
-  this->DivideRegion(kd, points, ptIds, 0);
+  this->DivideRegionInParallel(kd, points, ptIds);
 
   this->SetActualLevel();
   this->BuildRegionList();
@@ -2357,12 +2522,8 @@ int vtkKdTree::FindClosestPointInSphere(double x, double y, double z,
   }
   int *regionIds = new int [this->NumberOfRegions];
 
-  this->BSPCalculator->ComputeIntersectionsUsingDataBoundsOn();
-
   int nRegions =
-    this->BSPCalculator->IntersectsSphere2(regionIds, this->NumberOfRegions, x, y, z, radius*radius);
-
-  this->BSPCalculator->ComputeIntersectionsUsingDataBoundsOff();
+    FindRegionsInSphere(this->Top, regionIds, x, y, z, radius*radius);
 
   double minDistance2 = 4 * this->MaxWidth * this->MaxWidth;
   int localCloseId = -1;
@@ -4089,14 +4250,10 @@ int *vtkKdTree::AllGetRegionContainingCell()
 
     float *centers = this->ComputeCellCenters(iset);
 
-    float *pt = centers;
-
-    for (int cellId = 0; cellId < setCells; cellId++)
+    if (centers)
     {
-      listPtr[cellId] =
-        this->GetRegionContainingPoint(pt[0], pt[1], pt[2]);
-
-      pt += 3;
+      vtkKdTreeFindRegions findRegions(this, centers, listPtr);
+      vtkSMPTools::For(0, setCells, findRegions);
     }
 
     listPtr += setCells;
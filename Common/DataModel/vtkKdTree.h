@@ -785,6 +785,16 @@ protected:
 
   int DivideRegion(vtkKdNode *kd, float *c1, int *ids, int nlevels);
 
+  // Same as DivideRegion(kd, c1, ids, 0), with the independent regions
+  // divided in parallel.
+  void DivideRegionInParallel(vtkKdNode *kd, float *c1, int *ids);
+
+  // Split a region in two without dividing its children.  Returns 1 if the
+  // region was split.
+  int SplitRegion(vtkKdNode *kd, float *c1, int *ids, int nlevels);
+
+  friend struct vtkKdTreeDivideRegions;
+
   void DoMedianFind(vtkKdNode *kd, float *c1, int *ids, int d1, int d2, int d3);
 
   void SelfRegister(vtkKdNode *kd);
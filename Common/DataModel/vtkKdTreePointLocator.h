@@ -39,6 +39,11 @@ public:
   static vtkKdTreePointLocator* New();
   void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
 
+  // Re-use any superclass signatures that we don't override.
+  using vtkAbstractPointLocator::FindClosestPoint;
+  using vtkAbstractPointLocator::FindClosestNPoints;
+  using vtkAbstractPointLocator::FindPointsWithinRadius;
+
   /**
    * Given a position x, return the id of the point closest to it. Alternative
    * method requires separate x-y-z values.
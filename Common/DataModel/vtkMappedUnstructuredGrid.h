@@ -165,6 +165,7 @@ public:
   vtkCell* GetCell(vtkIdType cellId) VTK_OVERRIDE;
   void GetCell(vtkIdType cellId, vtkGenericCell *cell) VTK_OVERRIDE;
   int GetCellType(vtkIdType cellId) VTK_OVERRIDE;
+  using vtkDataSet::GetCellPoints;
   void GetCellPoints(vtkIdType cellId, vtkIdList *ptIds) VTK_OVERRIDE;
   vtkCellIterator* NewCellIterator() VTK_OVERRIDE;
   void GetPointCells(vtkIdType ptId, vtkIdList *cellIds) VTK_OVERRIDE;
@@ -119,6 +119,10 @@ public:
    */
   void BuildLocator() VTK_OVERRIDE;
 
+  // Re-use any superclass signatures that we don't override.
+  using vtkAbstractPointLocator::FindClosestNPoints;
+  using vtkAbstractPointLocator::FindPointsWithinRadius;
+
   //@{
   /**
    * Return the Id of the point that is closest to the given point.
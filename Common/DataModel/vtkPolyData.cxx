@@ -30,6 +30,7 @@
 #include "vtkPolyVertex.h"
 #include "vtkPolygon.h"
 #include "vtkQuad.h"
+#include "vtkStaticCellLinks.h"
 #include "vtkTriangle.h"
 #include "vtkTriangleStrip.h"
 #include "vtkVertex.h"
@@ -56,11 +57,94 @@ struct vtkPolyDataDummyContainter
 
 vtkPolyDataDummyContainter vtkPolyData::DummyContainer;
 
+namespace
+{
+// Bounds of the points of a cell, for either width of point ids.
+template <class TId>
+void ComputeCellBounds(vtkPoints *points, vtkIdType numPts, const TId *pts,
+                       double bounds[6])
+{
+  // carefully compute the bounds
+  double x[3];
+  if (numPts)
+  {
+    points->GetPoint( pts[0], x );
+    bounds[0] = x[0];
+    bounds[2] = x[1];
+    bounds[4] = x[2];
+    bounds[1] = x[0];
+    bounds[3] = x[1];
+    bounds[5] = x[2];
+    for (vtkIdType i=1; i < numPts; i++)
+    {
+      points->GetPoint( pts[i], x );
+      bounds[0] = (x[0] < bounds[0] ? x[0] : bounds[0]);
+      bounds[1] = (x[0] > bounds[1] ? x[0] : bounds[1]);
+      bounds[2] = (x[1] < bounds[2] ? x[1] : bounds[2]);
+      bounds[3] = (x[1] > bounds[3] ? x[1] : bounds[3]);
+      bounds[4] = (x[2] < bounds[4] ? x[2] : bounds[4]);
+      bounds[5] = (x[2] > bounds[5] ? x[2] : bounds[5]);
+    }
+  }
+  else
+  {
+    vtkMath::UninitializeBounds(bounds);
+  }
+}
+
+// Read the point ids of the cell at loc. 32-bit connectivity is copied to
+// ids rather than widened, pts then points into ids.
+inline void GetCellIds(vtkCellArray *cells, vtkIdType loc, vtkIdType &npts,
+                       vtkIdType* &pts, vtkIdList *ids)
+{
+  if (cells->GetStorage() == vtkCellArray::OFFSETS32_STORAGE)
+  {
+    cells->GetCell(loc, ids);
+    npts = ids->GetNumberOfIds();
+    pts = ids->GetPointer(0);
+    return;
+  }
+  cells->GetCell(loc, npts, pts);
+}
+
+// BuildCells() walks the cell sizes in the legacy layout directly, other
+// storages are read cell by cell without converting them.
+inline const vtkIdType* LegacyCells(vtkCellArray *cells)
+{
+  return cells->GetStorage() == vtkCellArray::LEGACY_STORAGE ?
+    cells->GetPointer() : nullptr;
+}
+
+inline vtkIdType CellSize(vtkCellArray *cells, const vtkIdType *legacy,
+                          vtkIdType cellId, vtkIdType loc)
+{
+  return legacy ? legacy[loc] : cells->GetCellSize(cellId);
+}
+
+// The cells using a point, for either kind of links.
+inline void GetLinkedCells(vtkAbstractCellLinks *links, vtkIdType ptId,
+                           vtkIdType &ncells, const vtkIdType* &cells)
+{
+  if (links->GetType() == vtkAbstractCellLinks::STATIC_CELL_LINKS)
+  {
+    vtkStaticCellLinks *staticLinks = static_cast<vtkStaticCellLinks*>(links);
+    ncells = staticLinks->GetNumberOfCells(ptId);
+    cells = staticLinks->GetCells(ptId);
+  }
+  else
+  {
+    vtkCellLinks *cellLinks = static_cast<vtkCellLinks*>(links);
+    ncells = cellLinks->GetNcells(ptId);
+    cells = cellLinks->GetCells(ptId);
+  }
+}
+}
+
 vtkPolyData::vtkPolyData () :
   Vertex(nullptr), PolyVertex(nullptr), Line(nullptr), PolyLine(nullptr),
   Triangle(nullptr), Quad(nullptr), Polygon(nullptr), TriangleStrip(nullptr),
   EmptyCell(nullptr), Verts(nullptr), Lines(nullptr), Polys(nullptr),
-  Strips(nullptr), Cells(nullptr), Links(nullptr)
+  Strips(nullptr), Cells(nullptr), Links(nullptr), Editable(false)
 {
   this->Information->Set(vtkDataObject::DATA_EXTENT_TYPE(), VTK_PIECES_EXTENT);
   this->Information->Set(vtkDataObject::DATA_PIECE_NUMBER(), -1);
@@ -243,7 +327,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Vertex = vtkVertex::New();
       }
       cell = this->Vertex;
-      this->Verts->GetCell(loc,numPts,pts);
+      GetCellIds(this->Verts, loc, numPts, pts, cell->PointIds);
       break;
 
     case VTK_POLY_VERTEX:
@@ -252,7 +336,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->PolyVertex = vtkPolyVertex::New();
       }
       cell = this->PolyVertex;
-      this->Verts->GetCell(loc,numPts,pts);
+      GetCellIds(this->Verts, loc, numPts, pts, cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -263,7 +347,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Line = vtkLine::New();
       }
       cell = this->Line;
-      this->Lines->GetCell(loc,numPts,pts);
+      GetCellIds(this->Lines, loc, numPts, pts, cell->PointIds);
       break;
 
     case VTK_POLY_LINE:
@@ -272,7 +356,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->PolyLine = vtkPolyLine::New();
       }
       cell = this->PolyLine;
-      this->Lines->GetCell(loc,numPts,pts);
+      GetCellIds(this->Lines, loc, numPts, pts, cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -283,7 +367,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Triangle = vtkTriangle::New();
       }
       cell = this->Triangle;
-      this->Polys->GetCell(loc,numPts,pts);
+      GetCellIds(this->Polys, loc, numPts, pts, cell->PointIds);
       break;
 
     case VTK_QUAD:
@@ -292,7 +376,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Quad = vtkQuad::New();
       }
       cell = this->Quad;
-      this->Polys->GetCell(loc,numPts,pts);
+      GetCellIds(this->Polys, loc, numPts, pts, cell->PointIds);
       break;
 
     case VTK_POLYGON:
@@ -301,7 +385,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Polygon = vtkPolygon::New();
       }
       cell = this->Polygon;
-      this->Polys->GetCell(loc,numPts,pts);
+      GetCellIds(this->Polys, loc, numPts, pts, cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -312,7 +396,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->TriangleStrip = vtkTriangleStrip::New();
       }
       cell = this->TriangleStrip;
-      this->Strips->GetCell(loc,numPts,pts);
+      GetCellIds(this->Strips, loc, numPts, pts, cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -356,48 +440,48 @@ void vtkPolyData::GetCell(vtkIdType cellId, vtkGenericCell *cell)
   {
     case VTK_VERTEX:
       cell->SetCellTypeToVertex();
-      this->Verts->GetCell(loc,numPts,pts);
+      GetCellIds(this->Verts, loc, numPts, pts, cell->PointIds);
       break;
 
     case VTK_POLY_VERTEX:
       cell->SetCellTypeToPolyVertex();
-      this->Verts->GetCell(loc,numPts,pts);
+      GetCellIds(this->Verts, loc, numPts, pts, cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
 
     case VTK_LINE:
       cell->SetCellTypeToLine();
-      this->Lines->GetCell(loc,numPts,pts);
+      GetCellIds(this->Lines, loc, numPts, pts, cell->PointIds);
       break;
 
     case VTK_POLY_LINE:
       cell->SetCellTypeToPolyLine();
-      this->Lines->GetCell(loc,numPts,pts);
+      GetCellIds(this->Lines, loc, numPts, pts, cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
 
     case VTK_TRIANGLE:
       cell->SetCellTypeToTriangle();
-      this->Polys->GetCell(loc,numPts,pts);
+      GetCellIds(this->Polys, loc, numPts, pts, cell->PointIds);
       break;
 
     case VTK_QUAD:
       cell->SetCellTypeToQuad();
-      this->Polys->GetCell(loc,numPts,pts);
+      GetCellIds(this->Polys, loc, numPts, pts, cell->PointIds);
       break;
 
     case VTK_POLYGON:
       cell->SetCellTypeToPolygon();
-      this->Polys->GetCell(loc,numPts,pts);
+      GetCellIds(this->Polys, loc, numPts, pts, cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
 
     case VTK_TRIANGLE_STRIP:
       cell->SetCellTypeToTriangleStrip();
-      this->Strips->GetCell(loc,numPts,pts);
+      GetCellIds(this->Strips, loc, numPts, pts, cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -494,10 +578,9 @@ void vtkPolyData::CopyCells(vtkPolyData *pd, vtkIdList *idList,
 // constructing a cell.
 void vtkPolyData::GetCellBounds(vtkIdType cellId, double bounds[6])
 {
-  int i, loc;
-  vtkIdType *pts, numPts;
+  int loc;
+  vtkIdType numPts;
   unsigned char type;
-  double x[3];
 
   if ( !this->Cells )
   {
@@ -507,26 +590,27 @@ void vtkPolyData::GetCellBounds(vtkIdType cellId, double bounds[6])
   type = this->Cells->GetCellType(cellId);
   loc = this->Cells->GetCellLocation(cellId);
 
+  vtkCellArray *cells;
   switch (type)
   {
     case VTK_VERTEX:
     case VTK_POLY_VERTEX:
-      this->Verts->GetCell(loc,numPts,pts);
+      cells = this->Verts;
       break;
 
     case VTK_LINE:
     case VTK_POLY_LINE:
-      this->Lines->GetCell(loc,numPts,pts);
+      cells = this->Lines;
       break;
 
     case VTK_TRIANGLE:
     case VTK_QUAD:
     case VTK_POLYGON:
-      this->Polys->GetCell(loc,numPts,pts);
+      cells = this->Polys;
       break;
 
     case VTK_TRIANGLE_STRIP:
-      this->Strips->GetCell(loc,numPts,pts);
+      cells = this->Strips;
       break;
 
     default:
@@ -535,34 +619,21 @@ void vtkPolyData::GetCellBounds(vtkIdType cellId, double bounds[6])
       return;
   }
 
-  // carefully compute the bounds
-  if (numPts)
+  // This may be called from several threads, 32-bit connectivity is read
+  // as is rather than widened.
+  if (cells->GetStorage() == vtkCellArray::OFFSETS32_STORAGE)
   {
-    this->Points->GetPoint( pts[0], x );
-    bounds[0] = x[0];
-    bounds[2] = x[1];
-    bounds[4] = x[2];
-    bounds[1] = x[0];
-    bounds[3] = x[1];
-    bounds[5] = x[2];
-    for (i=1; i < numPts; i++)
-    {
-      this->Points->GetPoint( pts[i], x );
-      bounds[0] = (x[0] < bounds[0] ? x[0] : bounds[0]);
-      bounds[1] = (x[0] > bounds[1] ? x[0] : bounds[1]);
-      bounds[2] = (x[1] < bounds[2] ? x[1] : bounds[2]);
-      bounds[3] = (x[1] > bounds[3] ? x[1] : bounds[3]);
-      bounds[4] = (x[2] < bounds[4] ? x[2] : bounds[4]);
-      bounds[5] = (x[2] > bounds[5] ? x[2] : bounds[5]);
-    }
+    const vtkTypeInt32 *pts = cells->GetCell32(loc, numPts);
+    ComputeCellBounds(this->Points, numPts, pts, bounds);
   }
   else
   {
-    vtkMath::UninitializeBounds(bounds);
+    vtkIdType *pts;
+    cells->GetCell(loc, numPts, pts);
+    ComputeCellBounds(this->Points, numPts, pts, bounds);
   }
 }
 
-
 //----------------------------------------------------------------------------
 void vtkPolyData::ComputeBounds()
 {
@@ -953,14 +1024,14 @@ void vtkPolyData::BuildCells()
   vtkIdType nextCellPts;
   if (nVerts)
   {
-    vtkIdType *pVerts = vertCells->GetData()->GetPointer(0);
-    numCellPts = pVerts[0];
+    const vtkIdType *pVerts = LegacyCells(vertCells);
+    numCellPts = CellSize(vertCells, pVerts, 0, 0);
     nextCellPts = numCellPts + 1;
     pLocs[0] = 0;
     pTypes[0] = numCellPts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX;
     for (vtkIdType i = 1; i < nVerts; ++i)
     {
-      numCellPts = pVerts[nextCellPts];
+      numCellPts = CellSize(vertCells, pVerts, i, nextCellPts);
       pLocs[i] = nextCellPts;
       pTypes[i] = numCellPts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX;
       nextCellPts += numCellPts + 1;
@@ -972,8 +1043,8 @@ void vtkPolyData::BuildCells()
   // lines
   if (nLines)
   {
-    vtkIdType *pLines = lineCells->GetData()->GetPointer(0);
-    numCellPts = pLines[0];
+    const vtkIdType *pLines = LegacyCells(lineCells);
+    numCellPts = CellSize(lineCells, pLines, 0, 0);
     pLocs[0] = 0;
     pTypes[0] = numCellPts > 2 ? VTK_POLY_LINE : VTK_LINE;
     if (numCellPts == 1)
@@ -984,7 +1055,7 @@ void vtkPolyData::BuildCells()
     nextCellPts = numCellPts + 1;
     for (vtkIdType i = 1; i < nLines; ++i)
     {
-      numCellPts = pLines[nextCellPts];
+      numCellPts = CellSize(lineCells, pLines, i, nextCellPts);
       pLocs[i] = nextCellPts;
       pTypes[i] = numCellPts > 2 ? VTK_POLY_LINE : VTK_LINE;
       if (numCellPts == 1)
@@ -1001,8 +1072,8 @@ void vtkPolyData::BuildCells()
   // polys
   if (nPolys)
   {
-    vtkIdType *pPolys = polyCells->GetData()->GetPointer(0);
-    numCellPts = pPolys[0];
+    const vtkIdType *pPolys = LegacyCells(polyCells);
+    numCellPts = CellSize(polyCells, pPolys, 0, 0);
     pLocs[0] = 0;
     if (numCellPts < 3)
     {
@@ -1014,7 +1085,7 @@ void vtkPolyData::BuildCells()
     nextCellPts = numCellPts + 1;
     for (vtkIdType i = 1; i < nPolys; ++i)
     {
-      numCellPts = pPolys[nextCellPts];
+      numCellPts = CellSize(polyCells, pPolys, i, nextCellPts);
       pLocs[i] = nextCellPts;
       if (numCellPts < 3)
       {
@@ -1034,13 +1105,13 @@ void vtkPolyData::BuildCells()
   if (nStrips)
   {
     std::fill_n(pTypes, nStrips, VTK_TRIANGLE_STRIP);
-    vtkIdType *pStrips = stripCells->GetData()->GetPointer(0);
-    numCellPts = pStrips[0];
+    const vtkIdType *pStrips = LegacyCells(stripCells);
+    numCellPts = CellSize(stripCells, pStrips, 0, 0);
     pLocs[0] = 0;
     nextCellPts = numCellPts + 1;
     for (vtkIdType i = 1; i < nStrips; ++i)
     {
-      numCellPts = pStrips[nextCellPts];
+      numCellPts = CellSize(stripCells, pStrips, i, nextCellPts);
       pLocs[i] = nextCellPts;
       nextCellPts += numCellPts + 1;
     }
@@ -1080,19 +1151,33 @@ void vtkPolyData::BuildLinks(int initialSize)
     this->BuildCells();
   }
 
-  this->Links = vtkCellLinks::New();
+  if ( !this->Editable )
+  {
+    this->Links = vtkStaticCellLinks::New();
+    this->Links->BuildLinks(this);
+    return;
+  }
+
+  vtkCellLinks *links = vtkCellLinks::New();
   if ( initialSize > 0 )
   {
-    this->Links->Allocate(initialSize);
+    links->Allocate(initialSize);
   }
   else
   {
-    this->Links->Allocate(this->GetNumberOfPoints());
+    links->Allocate(this->GetNumberOfPoints());
   }
-  this->Links->Register(this);
-  this->Links->Delete();
+  this->Links = links;
+  links->BuildLinks(this);
+}
 
-  this->Links->BuildLinks(this);
+//----------------------------------------------------------------------------
+void vtkPolyData::BuildEditableLinks()
+{
+  bool editable = this->Editable;
+  this->Editable = true;
+  this->BuildLinks();
+  this->Editable = editable;
 }
 
 //----------------------------------------------------------------------------
@@ -1108,6 +1193,14 @@ void vtkPolyData::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
     this->BuildCells();
   }
 
+  unsigned char type = this->Cells->GetCellType(cellId);
+  vtkCellArray *cells = this->GetCellArrayOfType(type);
+  if (cells && cells->GetStorage() == vtkCellArray::OFFSETS32_STORAGE)
+  {
+    cells->GetCell(this->Cells->GetCellLocation(cellId), ptIds);
+    return;
+  }
+
   this->vtkPolyData::GetCellPoints(cellId, npts, pts);
   ptIds->InsertId (npts-1,pts[npts-1]);
   for (i=0; i<npts-1; i++)
@@ -1116,10 +1209,113 @@ void vtkPolyData::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkPolyData::GetCellPoints(vtkIdType cellId, vtkIdType& npts,
+                                vtkIdType const*& pts, vtkIdList *ptIds) const
+{
+  vtkIdType *cellPts;
+  if ( this->Cells == nullptr )
+  {
+    // The cells are not built, which this method does not do as it may be
+    // called from several threads. The cell ids follow the verts, lines,
+    // polys then strips.
+    vtkCellArray *arrays[4] = { this->Verts, this->Lines, this->Polys,
+                                this->Strips };
+    for (int i = 0; i < 4; i++)
+    {
+      vtkIdType numCells = arrays[i] ? arrays[i]->GetNumberOfCells() : 0;
+      if (cellId < numCells)
+      {
+        if (arrays[i]->GetStorage() == vtkCellArray::OFFSETS32_STORAGE)
+        {
+          arrays[i]->GetCellAtId(cellId, ptIds);
+          npts = ptIds->GetNumberOfIds();
+          pts = ptIds->GetPointer(0);
+          return;
+        }
+        arrays[i]->GetCellAtId(cellId, npts, cellPts);
+        pts = cellPts;
+        return;
+      }
+      cellId -= numCells;
+    }
+    npts = 0;
+    pts = nullptr;
+    return;
+  }
+
+  vtkCellArray *cells =
+    this->GetCellArrayOfType(this->Cells->GetCellType(cellId));
+  if (!cells)
+  {
+    npts = 0;
+    pts = nullptr;
+    return;
+  }
+
+  GetCellIds(cells, this->Cells->GetCellLocation(cellId), npts, cellPts,
+             ptIds);
+  pts = cellPts;
+}
+
+//----------------------------------------------------------------------------
+void vtkPolyData::GetPointCells(vtkIdType ptId, unsigned short& ncells,
+                                       vtkIdType* &cells)
+{
+  if (this->Links->GetType() == vtkAbstractCellLinks::STATIC_CELL_LINKS)
+  {
+    vtkStaticCellLinks *links = static_cast<vtkStaticCellLinks*>(this->Links);
+    ncells = links->GetNcells(ptId);
+    cells = const_cast<vtkIdType*>(links->GetCells(ptId));
+  }
+  else
+  {
+    vtkCellLinks *links = static_cast<vtkCellLinks*>(this->Links);
+    ncells = links->GetNcells(ptId);
+    cells = links->GetCells(ptId);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkPolyData::GetPointCells(vtkIdType ptId, vtkIdType& ncells,
+                                       vtkIdType* &cells)
+{
+  if (this->Links->GetType() == vtkAbstractCellLinks::STATIC_CELL_LINKS)
+  {
+    vtkStaticCellLinks *links = static_cast<vtkStaticCellLinks*>(this->Links);
+    ncells = links->GetNumberOfCells(ptId);
+    cells = const_cast<vtkIdType*>(links->GetCells(ptId));
+  }
+  else
+  {
+    vtkCellLinks *links = static_cast<vtkCellLinks*>(this->Links);
+    ncells = links->GetNcells(ptId);
+    cells = links->GetCells(ptId);
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkCellArray* vtkPolyData::GetCellArrayOfType(unsigned char type) const
+{
+  switch (type)
+  {
+    case VTK_VERTEX: case VTK_POLY_VERTEX:
+      return this->Verts;
+    case VTK_LINE: case VTK_POLY_LINE:
+      return this->Lines;
+    case VTK_TRIANGLE: case VTK_QUAD: case VTK_POLYGON:
+      return this->Polys;
+    case VTK_TRIANGLE_STRIP:
+      return this->Strips;
+    default:
+      return nullptr;
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkPolyData::GetPointCells(vtkIdType ptId, vtkIdList *cellIds)
 {
-  vtkIdType *cells;
+  const vtkIdType *cells;
   vtkIdType numCells;
   vtkIdType i;
 
@@ -1129,8 +1325,7 @@ void vtkPolyData::GetPointCells(vtkIdType ptId, vtkIdList *cellIds)
   }
   cellIds->Reset();
 
-  numCells = this->Links->GetNcells(ptId);
-  cells = this->Links->GetCells(ptId);
+  GetLinkedCells(this->Links, ptId, numCells, cells);
 
   for (i=0; i < numCells; i++)
   {
@@ -1459,7 +1654,7 @@ void vtkPolyData::ReverseCell(vtkIdType cellId)
 // use this method, make sure points are available and BuildLinks() has been invoked.)
 vtkIdType vtkPolyData::InsertNextLinkedPoint(int numLinks)
 {
-  return this->Links->InsertNextPoint(numLinks);
+  return this->GetEditableLinks()->InsertNextPoint(numLinks);
 }
 
 //----------------------------------------------------------------------------
@@ -1469,7 +1664,7 @@ vtkIdType vtkPolyData::InsertNextLinkedPoint(int numLinks)
 // and BuildLinks() has been invoked.)
 vtkIdType vtkPolyData::InsertNextLinkedPoint(double x[3], int numLinks)
 {
-  this->Links->InsertNextPoint(numLinks);
+  this->GetEditableLinks()->InsertNextPoint(numLinks);
   return this->Points->InsertNextPoint(x);
 }
 
@@ -1480,13 +1675,14 @@ vtkIdType vtkPolyData::InsertNextLinkedPoint(double x[3], int numLinks)
 vtkIdType vtkPolyData::InsertNextLinkedCell(int type, int npts, vtkIdType *pts)
 {
   vtkIdType i, id;
+  vtkCellLinks *links = this->GetEditableLinks();
 
   id = this->InsertNextCell(type,npts,pts);
 
   for (i=0; i<npts; i++)
   {
-    this->Links->ResizeCellList(pts[i],1);
-    this->Links->AddCellReference(id,pts[i]);
+    links->ResizeCellList(pts[i],1);
+    links->AddCellReference(id,pts[i]);
   }
 
   return id;
@@ -1499,7 +1695,7 @@ vtkIdType vtkPolyData::InsertNextLinkedCell(int type, int npts, vtkIdType *pts)
 // operator ResizeCellList() to do this if necessary.
 void vtkPolyData::RemoveReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 {
-  this->Links->RemoveCellReference(cellId, ptId);
+  this->GetEditableLinks()->RemoveCellReference(cellId, ptId);
 }
 
 //----------------------------------------------------------------------------
@@ -1509,7 +1705,7 @@ void vtkPolyData::RemoveReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 // operator ResizeCellList() to do this if necessary.
 void vtkPolyData::AddReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 {
-  this->Links->AddCellReference(cellId, ptId);
+  this->GetEditableLinks()->AddCellReference(cellId, ptId);
 }
 
 //----------------------------------------------------------------------------
@@ -1560,6 +1756,7 @@ void vtkPolyData::ReplaceCell(vtkIdType cellId, int npts, vtkIdType *pts)
 // link list is changing size.
 void vtkPolyData::ReplaceLinkedCell(vtkIdType cellId, int npts, vtkIdType *pts)
 {
+  vtkCellLinks *links = this->GetEditableLinks();
   int loc = this->Cells->GetCellLocation(cellId);
   int type = this->Cells->GetCellType(cellId);
 
@@ -1587,7 +1784,7 @@ void vtkPolyData::ReplaceLinkedCell(vtkIdType cellId, int npts, vtkIdType *pts)
 
   for (int i=0; i < npts; i++)
   {
-    this->Links->InsertNextCellReference(pts[i],cellId);
+    links->InsertNextCellReference(pts[i],cellId);
   }
 }
 
@@ -1600,14 +1797,13 @@ void vtkPolyData::GetCellEdgeNeighbors(vtkIdType cellId, vtkIdType p1,
 {
   cellIds->Reset();
 
-  const vtkCellLinks::Link &link1(this->Links->GetLink(p1));
-  const vtkCellLinks::Link &link2(this->Links->GetLink(p2));
-
-  const vtkIdType *cells1 = link1.cells;
-  const vtkIdType *cells1End = cells1 + link1.ncells;
+  vtkIdType ncells1, ncells2;
+  const vtkIdType *cells1, *cells2;
+  GetLinkedCells(this->Links, p1, ncells1, cells1);
+  GetLinkedCells(this->Links, p2, ncells2, cells2);
 
-  const vtkIdType *cells2 = link2.cells;
-  const vtkIdType *cells2End = cells2 + link2.ncells;
+  const vtkIdType *cells1End = cells1 + ncells1;
+  const vtkIdType *cells2End = cells2 + ncells2;
 
   while (cells1 != cells1End)
   {
@@ -1644,8 +1840,9 @@ void vtkPolyData::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
 
   // load list with candidate cells, remove current cell
   vtkIdType ptId = ptIds->GetId(0);
-  int numPrime = this->Links->GetNcells(ptId);
-  vtkIdType *primeCells = this->Links->GetCells(ptId);
+  vtkIdType numPrime;
+  const vtkIdType *primeCells;
+  GetLinkedCells(this->Links, ptId, numPrime, primeCells);
   numPts = ptIds->GetNumberOfIds();
 
   // for each potential cell
@@ -1658,8 +1855,9 @@ void vtkPolyData::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
       for (allFound=1, i=1; i < numPts && allFound; i++)
       {
         ptId = ptIds->GetId(i);
-        int numCurrent = this->Links->GetNcells(ptId);
-        vtkIdType *currentCells = this->Links->GetCells(ptId);
+        vtkIdType numCurrent;
+        const vtkIdType *currentCells;
+        GetLinkedCells(this->Links, ptId, numCurrent, currentCells);
         oneFound = 0;
         for (j = 0; j < numCurrent; j++)
         {
@@ -1822,6 +2020,7 @@ void vtkPolyData::ShallowCopy(vtkDataObject *dataObject)
     {
       this->Links->Register(this);
     }
+    this->Editable = polyData->Editable;
   }
 
   // Do superclass
@@ -1876,6 +2075,7 @@ void vtkPolyData::DeepCopy(vtkDataObject *dataObject)
       this->Links->UnRegister(this);
       this->Links = nullptr;
     }
+    this->Editable = polyData->Editable;
     if (polyData->Links)
     {
       this->BuildLinks();
@@ -2095,6 +2295,7 @@ void vtkPolyData::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Number Of Pieces: " << this->GetNumberOfPieces() << endl;
   os << indent << "Piece: " << this->GetPiece() << endl;
   os << indent << "Ghost Level: " << this->GetGhostLevel() << endl;
+  os << indent << "Editable: " << (this->Editable ? "true" : "false") << endl;
 }
 
 
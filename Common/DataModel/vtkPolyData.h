@@ -122,6 +122,15 @@ public:
    */
   void GetCellPoints(vtkIdType cellId, vtkIdList *ptIds) VTK_OVERRIDE;
 
+  /**
+   * See vtkDataSet. This method does not build the cells: until BuildCells()
+   * is called it walks the cell arrays, which takes linear time with legacy
+   * storage.
+   */
+  void GetCellPoints(vtkIdType cellId, vtkIdType& npts,
+                     vtkIdType const*& pts,
+                     vtkIdList *ptIds) const VTK_OVERRIDE;
+
   /**
    * Efficient method to obtain cells using a particular point. Make sure that
    * routine BuildLinks() has been called.
@@ -253,6 +262,9 @@ public:
    * of GetCell/GetCellPoints. One may check if cells need to be built via
    * NeedToBuilds before invoking. Cells always need to be built/re-built after
    * low level direct modifications to verts, lines, polys or strips cell arrays.
+   * The cells are otherwise built on first access, which is not thread safe:
+   * call BuildCells() (and BuildLinks() for point to cell queries) before
+   * accessing the cells from several threads.
    */
   void BuildCells();
 
@@ -263,12 +275,29 @@ public:
 
   /**
    * Create upward links from points to cells that use each point. Enables
-   * topologically complex queries. Normally the links array is allocated
-   * based on the number of points in the vtkPolyData. The optional
-   * initialSize parameter can be used to allocate a larger size initially.
+   * topologically complex queries. Unless Editable is on, the links are
+   * static (vtkStaticCellLinks) and built in parallel. Editable links
+   * (vtkCellLinks) are normally allocated based on the number of points in
+   * the vtkPolyData. The optional initialSize parameter can be used to
+   * allocate a larger size initially.
    */
   void BuildLinks(int initialSize=0);
 
+  //@{
+  /**
+   * Specify whether BuildLinks() builds links that can be edited with the
+   * methods below, such as RemoveReferenceToCell(), ResizeCellList() or
+   * InsertNextLinkedCell(). Editable links are built serially and use more
+   * memory, so this is off by default. Set it before BuildLinks() when the
+   * links are going to be edited. Editing static links first rebuilds them
+   * as editable links from the current cells, which is only correct if the
+   * cells have not been modified since the links were built.
+   */
+  vtkSetMacro(Editable, bool);
+  vtkGetMacro(Editable, bool);
+  vtkBooleanMacro(Editable, bool);
+  //@}
+
   /**
    * Release data structure that allows random access of the cells. This must
    * be done before a 2nd call to BuildLinks(). DeleteCells implicitly deletes
@@ -281,11 +310,17 @@ public:
    */
   void DeleteLinks();
 
+  //@{
   /**
-   * Special (efficient) operations on poly data. Use carefully.
+   * Special (efficient) operations on poly data. Use carefully: the links
+   * must have been built and the returned cell ids must not be modified.
+   * The unsigned short count wraps around for points used by more than
+   * 65535 cells. Safe to call from several threads.
    */
   void GetPointCells(vtkIdType ptId, unsigned short& ncells,
                      vtkIdType* &cells);
+  void GetPointCells(vtkIdType ptId, vtkIdType& ncells, vtkIdType* &cells);
+  //@}
 
   /**
    * Get the neighbors at an edge. More efficient than the general
@@ -558,7 +593,16 @@ protected:
   // supporting structures for more complex topological operations
   // built only when necessary
   vtkCellTypes *Cells;
-  vtkCellLinks *Links;
+  vtkAbstractCellLinks *Links;
+  bool Editable;
+
+  // The links as vtkCellLinks, rebuilt as editable links if they are static.
+  vtkCellLinks *GetEditableLinks();
+  void BuildEditableLinks();
+
+  // The cell array holding the cells of the given type, nullptr for unknown
+  // types.
+  vtkCellArray* GetCellArrayOfType(unsigned char type) const;
 
 private:
   // Hide these from the user and the compiler.
@@ -576,11 +620,14 @@ private:
   void operator=(const vtkPolyData&) VTK_DELETE_FUNCTION;
 };
 
-inline void vtkPolyData::GetPointCells(vtkIdType ptId, unsigned short& ncells,
-                                       vtkIdType* &cells)
+inline vtkCellLinks *vtkPolyData::GetEditableLinks()
 {
-  ncells = this->Links->GetNcells(ptId);
-  cells = this->Links->GetCells(ptId);
+  if (!this->Links ||
+      this->Links->GetType() != vtkAbstractCellLinks::CELL_LINKS)
+  {
+    this->BuildEditableLinks();
+  }
+  return static_cast<vtkCellLinks*>(this->Links);
 }
 
 inline int vtkPolyData::IsTriangle(int v1, int v2, int v3)
@@ -631,7 +678,7 @@ inline int vtkPolyData::IsPointUsedByCell(vtkIdType ptId, vtkIdType cellId)
 
 inline void vtkPolyData::DeletePoint(vtkIdType ptId)
 {
-  this->Links->DeletePoint(ptId);
+  this->GetEditableLinks()->DeletePoint(ptId);
 }
 
 inline void vtkPolyData::DeleteCell(vtkIdType cellId)
@@ -641,29 +688,31 @@ inline void vtkPolyData::DeleteCell(vtkIdType cellId)
 
 inline void vtkPolyData::RemoveCellReference(vtkIdType cellId)
 {
+  vtkCellLinks *links = this->GetEditableLinks();
   vtkIdType *pts, npts;
 
   this->GetCellPoints(cellId, npts, pts);
   for (vtkIdType i=0; i<npts; i++)
   {
-    this->Links->RemoveCellReference(cellId, pts[i]);
+    links->RemoveCellReference(cellId, pts[i]);
   }
 }
 
 inline void vtkPolyData::AddCellReference(vtkIdType cellId)
 {
+  vtkCellLinks *links = this->GetEditableLinks();
   vtkIdType *pts, npts;
 
   this->GetCellPoints(cellId, npts, pts);
   for (vtkIdType i=0; i<npts; i++)
   {
-    this->Links->AddCellReference(cellId, pts[i]);
+    links->AddCellReference(cellId, pts[i]);
   }
 }
 
 inline void vtkPolyData::ResizeCellList(vtkIdType ptId, int size)
 {
-  this->Links->ResizeCellList(ptId,size);
+  this->GetEditableLinks()->ResizeCellList(ptId,size);
 }
 
 inline void vtkPolyData::ReplaceCellPoint(vtkIdType cellId, vtkIdType oldPtId,
@@ -678,6 +727,14 @@ inline void vtkPolyData::ReplaceCellPoint(vtkIdType cellId, vtkIdType oldPtId,
     if ( verts[i] == oldPtId )
     {
       verts[i] = newPtId; // this is very nasty! direct write!
+      vtkCellArray *cells =
+        this->GetCellArrayOfType(this->Cells->GetCellType(cellId));
+      if (cells->GetStorage() == vtkCellArray::OFFSETS32_STORAGE)
+      {
+        // verts points into the read only legacy copy of the cells.
+        cells->ReplaceCell(this->Cells->GetCellLocation(cellId), nverts,
+                           verts);
+      }
       return;
     }
   }
@@ -94,6 +94,7 @@ public:
                           double tol2, int& subId, double pcoords[3],
                           double *weights) VTK_OVERRIDE;
   int GetCellType(vtkIdType cellId) VTK_OVERRIDE;
+  using vtkDataSet::GetCellPoints;
   void GetCellPoints(vtkIdType cellId, vtkIdList *ptIds) VTK_OVERRIDE
     {vtkStructuredData::GetCellPoints(cellId,ptIds,this->DataDescription,
                                       this->Dimensions);}
@@ -21,6 +21,7 @@ vtkStandardNewMacro(vtkStaticCellLinks);
 vtkStaticCellLinks::vtkStaticCellLinks()
 {
   this->Impl = new vtkStaticCellLinksTemplate<vtkIdType>;
+  this->Type = vtkAbstractCellLinks::STATIC_CELL_LINKS;
 }
 
 //----------------------------------------------------------------------------
@@ -65,7 +65,7 @@ public:
   //@}
 
   /**
-   * Build the link list array. Satisfy the superclass API.
+   * Build the link list array, in parallel. Satisfy the superclass API.
    */
   void BuildLinks(vtkDataSet *ds) VTK_OVERRIDE
     {this->Impl->BuildLinks(ds);}
@@ -92,9 +92,28 @@ public:
   /**
    * Make sure any previously created links are cleaned up.
    */
-  void Initialize()
+  void Initialize() VTK_OVERRIDE
     {this->Impl->Initialize();}
 
+  /**
+   * The links are allocated to their exact size, there is nothing to
+   * reclaim.
+   */
+  void Squeeze() VTK_OVERRIDE {}
+
+  /**
+   * Static links cannot be refilled incrementally, so this releases them
+   * like Initialize().
+   */
+  void Reset() VTK_OVERRIDE
+    {this->Impl->Initialize();}
+
+  /**
+   * Return the memory in kibibytes (1024 bytes) consumed by the links.
+   */
+  unsigned long GetActualMemorySize() VTK_OVERRIDE
+    {return this->Impl->GetActualMemorySize();}
+
 protected:
   vtkStaticCellLinks();
   ~vtkStaticCellLinks() VTK_OVERRIDE;
@@ -48,7 +48,6 @@
 class vtkDataSet;
 class vtkPolyData;
 class vtkUnstructuredGrid;
-class vtkCellArray;
 
 
 template <typename TIds>
@@ -75,7 +74,11 @@ public:
   virtual void Initialize();
 
   /**
-   * Build the link list array. Satisfy superclass' API.
+   * Build the link list array. The links are built in parallel with
+   * vtkSMPTools using a count, prefix sum and fill pattern; the cells
+   * using a point are listed in increasing cell id order. Any previously
+   * built links are released first. The connectivity of the dataset is
+   * only read (32-bit cell storage is not widened).
    */
   virtual void BuildLinks(vtkDataSet *ds);
 
@@ -105,6 +108,11 @@ public:
       return this->Links + this->Offsets[ptId];
   }
 
+  /**
+   * Return the memory in kibibytes (1024 bytes) consumed by the links.
+   */
+  unsigned long GetActualMemorySize();
+
 protected:
   // The various templated data members
   TIds LinksSize;
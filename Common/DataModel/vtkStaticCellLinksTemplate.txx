@@ -17,257 +17,213 @@
 #ifndef vtkStaticCellLinksTemplate_txx
 #define vtkStaticCellLinksTemplate_txx
 
-#include "vtkCellArray.h"
 #include "vtkDataSet.h"
+#include "vtkIdList.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <atomic>
+
 //----------------------------------------------------------------------------
-// Note: this class is a faster, serial version of vtkCellLinks. Future work
-// to parallelize this class is possible. This includes:
-// = using a parallel prefix sum operation
-// = using atomics to update counts (i.e., number of cells using a point)
+// The links are built in three parallel passes over the cells and points:
+// the uses of each point are counted with atomics, a prefix sum of the
+// counts gives the offsets, and the cell ids are then scattered into their
+// runs. Threads insert concurrently into the same runs, so the runs are
+// sorted afterwards to keep the cells of each point in increasing order.
 
 //----------------------------------------------------------------------------
-// Clean up any previously allocated memory
-template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
-Initialize()
+// Count the number of cells using each point.
+template <typename TIds>
+struct vtkStaticCellLinksCountUses
 {
-  if ( this->Links )
+  vtkDataSet *DataSet;
+  std::atomic<TIds> *Counts;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  vtkStaticCellLinksCountUses(vtkDataSet *ds, std::atomic<TIds> *counts)
+    : DataSet(ds), Counts(counts)
   {
-    delete [] this->Links;
-    this->Links = nullptr;
   }
-  if ( this->Offsets )
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
   {
-    delete [] this->Offsets;
-    this->Offsets = nullptr;
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      this->DataSet->GetCellPoints(cellId, npts, pts, cellPts);
+      for (vtkIdType i=0; i < npts; ++i)
+      {
+        this->Counts[pts[i]].fetch_add(1, std::memory_order_relaxed);
+      }
+    }
   }
-}
+};
 
 //----------------------------------------------------------------------------
-// Build the link list array for any dataset type. Specialized methods are
-// used for dataset types that use vtkCellArrays to represent cells.
-template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
-BuildLinks(vtkDataSet *ds)
+// Insert the cell ids into the runs. The remaining count of a point gives
+// the next free slot counted from the end of its run, so that a sequential
+// traversal inserts the cells in increasing order.
+template <typename TIds>
+struct vtkStaticCellLinksInsertCells
 {
-  // Use a fast path if polydata or unstructured grid
-  if ( ds->GetDataObjectType() == VTK_POLY_DATA )
+  vtkDataSet *DataSet;
+  std::atomic<TIds> *Counts;
+  const TIds *Offsets;
+  TIds *Links;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  vtkStaticCellLinksInsertCells(vtkDataSet *ds, std::atomic<TIds> *counts,
+                                const TIds *offsets, TIds *links)
+    : DataSet(ds), Counts(counts), Offsets(offsets), Links(links)
   {
-    return this->BuildLinks(static_cast<vtkPolyData*>(ds));
   }
 
-  else if ( ds->GetDataObjectType() == VTK_UNSTRUCTURED_GRID )
-  {
-    return this->BuildLinks(static_cast<vtkUnstructuredGrid*>(ds));
-  }
-
-  // Any other type of dataset. Generally this is not called as datasets have
-  // their own, more efficient ways of getting similar information.
-  // Make sure that we clear out previous allocation.
-  this->NumCells = ds->GetNumberOfCells();
-  this->NumPts = ds->GetNumberOfPoints();
-
-  vtkIdType npts, ptId;
-  vtkIdType cellId, j;
-  vtkIdList *cellPts = vtkIdList::New();
-
-  // Traverse data to determine number of uses of each point. Also count the
-  // number of links to allocate.
-  this->Offsets = new TIds[this->NumPts+1];
-  std::fill_n(this->Offsets, this->NumPts, 0);
-
-  for (this->LinksSize=0, cellId=0; cellId < this->NumCells; cellId++)
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
   {
-    ds->GetCellPoints(cellId,cellPts);
-    npts = cellPts->GetNumberOfIds();
-    for (j=0; j < npts; j++)
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts, ptId;
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId )
     {
-      this->Offsets[cellPts->GetId(j)]++;
-      this->LinksSize++;
+      this->DataSet->GetCellPoints(cellId, npts, pts, cellPts);
+      for (vtkIdType i=0; i < npts; ++i)
+      {
+        ptId = pts[i];
+        TIds remaining =
+          this->Counts[ptId].fetch_sub(1, std::memory_order_relaxed);
+        this->Links[this->Offsets[ptId+1] - remaining] =
+          static_cast<TIds>(cellId);
+      }
     }
   }
+};
 
-  // Allocate space for links. Perform prefix sum.
-  this->Links = new TIds[this->LinksSize+1];
-  this->Links[this->LinksSize] = this->NumPts;
+//----------------------------------------------------------------------------
+// Sort the cells using each point.
+template <typename TIds>
+struct vtkStaticCellLinksSortRuns
+{
+  const TIds *Offsets;
+  TIds *Links;
 
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
+  vtkStaticCellLinksSortRuns(const TIds *offsets, TIds *links)
+    : Offsets(offsets), Links(links)
   {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
   }
 
-  // Now build the links. The summation from the prefix sum indicates where
-  // the cells are to be inserted. Each time a cell is inserted, the offset
-  // is decremented. In the end, the offset array is also constructed as it
-  // points to the beginning of each cell run.
-  for ( cellId=0; cellId < this->NumCells; ++cellId )
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
   {
-    ds->GetCellPoints(cellId,cellPts);
-    npts = cellPts->GetNumberOfIds();
-    for (j=0; j<npts; ++j)
+    for ( ; ptId < endPtId; ++ptId )
     {
-      ptId = cellPts->GetId(j);
-      this->Offsets[ptId]--;
-      this->Links[this->Offsets[ptId]] = cellId;
+      std::sort(this->Links + this->Offsets[ptId],
+                this->Links + this->Offsets[ptId+1]);
     }
   }
-  this->Offsets[this->NumPts] = this->LinksSize;
+};
 
-  cellPts->Delete();
+//----------------------------------------------------------------------------
+// Clean up any previously allocated memory
+template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
+Initialize()
+{
+  if ( this->Links )
+  {
+    delete [] this->Links;
+    this->Links = nullptr;
+  }
+  if ( this->Offsets )
+  {
+    delete [] this->Offsets;
+    this->Offsets = nullptr;
+  }
+  this->LinksSize = 0;
+  this->NumPts = 0;
+  this->NumCells = 0;
 }
 
 //----------------------------------------------------------------------------
-// Build the link list array for unstructured grids
+// Build the link list array for any dataset type. The cells are read with
+// the thread safe vtkDataSet::GetCellPoints(cellId, npts, pts, ptIds).
 template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
-BuildLinks(vtkUnstructuredGrid *ugrid)
+BuildLinks(vtkDataSet *ds)
 {
-  // Basic information about the grid
-  this->NumCells = ugrid->GetNumberOfCells();
-  this->NumPts = ugrid->GetNumberOfPoints();
+  this->Initialize();
+
+  this->NumCells = static_cast<TIds>(ds->GetNumberOfCells());
+  this->NumPts = static_cast<TIds>(ds->GetNumberOfPoints());
+
+  // The first access builds the cell structures of the dataset, if needed.
+  // This must be done before the threads read the cells.
+  if ( this->NumCells > 0 )
+  {
+    vtkIdList *cellPts = vtkIdList::New();
+    ds->GetCellPoints(0, cellPts);
+    cellPts->Delete();
+  }
 
-  // We're going to get into the guts of the class
-  vtkCellArray *cellArray = ugrid->GetCells();
-  const vtkIdType *cells = cellArray->GetPointer();
+  // Count the number of uses of each point.
+  std::atomic<TIds> *counts = new std::atomic<TIds>[this->NumPts];
+  vtkSMPTools::Fill(counts, counts + this->NumPts, TIds(0));
+  vtkStaticCellLinksCountUses<TIds> countUses(ds, counts);
+  vtkSMPTools::For(0, this->NumCells, countUses);
 
-  // I love this trick: the size of the Links array is equal to
-  // the size of the cell array, minus the number of cells.
-  this->LinksSize =
-    cellArray->GetNumberOfConnectivityEntries() - this->NumCells;
+  // Perform prefix sum. The number of links is the total number of uses.
+  this->Offsets = new TIds[this->NumPts+1];
+  this->LinksSize = vtkSMPTools::ExclusiveScan(counts, counts + this->NumPts,
+                                               this->Offsets, TIds(0));
+  this->Offsets[this->NumPts] = this->LinksSize;
 
   // Extra one allocated to simplify later pointer manipulation
   this->Links = new TIds[this->LinksSize+1];
   this->Links[this->LinksSize] = this->NumPts;
-  this->Offsets = new TIds[this->NumPts+1];
-  std::fill_n(this->Offsets, this->NumPts, 0);
-
-  // Now create the links.
-  vtkIdType npts, cellId, ptId;
-  const vtkIdType *cell=cells;
-  int i;
 
-  // Count number of point uses
-  for ( cellId=0; cellId < this->NumCells; ++cellId )
-  {
-    npts = *cell++;
-    for (i=0; i<npts; ++i)
-    {
-      this->Offsets[*cell++]++;
-    }
-  }
-
-  // Perform prefix sum
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
-  {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
-  }
+  // Now build the links. The counts are consumed, and the cell ids end up in
+  // the run of each point given by the offsets.
+  vtkStaticCellLinksInsertCells<TIds> insertCells(ds, counts, this->Offsets,
+                                                  this->Links);
+  vtkSMPTools::For(0, this->NumCells, insertCells);
+  delete [] counts;
 
-  // Now build the links. The summation from the prefix sum indicates where
-  // the cells are to be inserted. Each time a cell is inserted, the offset
-  // is decremented. In the end, the offset array is also constructed as it
-  // points to the beginning of each cell run.
-  for ( cell=cells, cellId=0; cellId < this->NumCells; ++cellId )
+  if ( vtkSMPTools::GetEstimatedNumberOfThreads() > 1 )
   {
-    npts = *cell++;
-    for (i=0; i<npts; ++i)
-    {
-      this->Offsets[*cell]--;
-      this->Links[this->Offsets[*cell++]] = cellId;
-    }
+    vtkStaticCellLinksSortRuns<TIds> sortRuns(this->Offsets, this->Links);
+    vtkSMPTools::For(0, this->NumPts, sortRuns);
   }
-  this->Offsets[this->NumPts] = this->LinksSize;
 }
 
 //----------------------------------------------------------------------------
-// Build the link list array for poly data. This is more complex because there
-// are potentially fout different cell arrays to contend with.
 template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
 BuildLinks(vtkPolyData *pd)
 {
-  // Basic information about the grid
-  this->NumCells = pd->GetNumberOfCells();
-  this->NumPts = pd->GetNumberOfPoints();
-
-  vtkCellArray *cellArrays[4];
-  vtkIdType numCells[4];
-  vtkIdType sizes[4];
-  int i, j;
-
-  cellArrays[0] = pd->GetVerts();
-  cellArrays[1] = pd->GetLines();
-  cellArrays[2] = pd->GetPolys();
-  cellArrays[3] = pd->GetStrips();
-
-  for (i=0; i<4; ++i)
-  {
-    if ( cellArrays[i] != nullptr )
-    {
-      numCells[i] = cellArrays[i]->GetNumberOfCells();
-      sizes[i] = cellArrays[i]->GetNumberOfConnectivityEntries() - numCells[i];
-    }
-    else
-    {
-      numCells[i] = 0;
-      sizes[i] = 0;
-    }
-  }//for the four polydata arrays
-
-  // Allocate
-  this->LinksSize = sizes[0] + sizes[1] + sizes[2] + sizes[3];
-  this->Links = new TIds[this->LinksSize+1];
-  this->Links[this->LinksSize] = this->NumPts;
-  this->Offsets = new TIds[this->NumPts+1];
-  this->Offsets[this->NumPts] = this->LinksSize;
-  std::fill_n(this->Offsets, this->NumPts, 0);
-
-  // Now create the links.
-  vtkIdType npts, cellId, CellId, ptId;
-  const vtkIdType *cell;
+  this->BuildLinks(static_cast<vtkDataSet*>(pd));
+}
 
-  // Visit the four arrays
-  for ( CellId=0, j=0; j < 4; ++j )
-  {
-    // Count number of point uses
-    cell = cellArrays[j]->GetPointer();
-    for ( cellId=0; cellId < numCells[j]; ++cellId )
-    {
-      npts = *cell++;
-      for (i=0; i<npts; ++i)
-      {
-        this->Offsets[CellId+(*cell++)]++;
-      }
-    }
-    CellId += numCells[j];
-  } //for each of the four polydata cell arrays
+//----------------------------------------------------------------------------
+template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
+BuildLinks(vtkUnstructuredGrid *ugrid)
+{
+  this->BuildLinks(static_cast<vtkDataSet*>(ugrid));
+}
 
-  // Perform prefix sum
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
+//----------------------------------------------------------------------------
+template <typename TIds> unsigned long vtkStaticCellLinksTemplate<TIds>::
+GetActualMemorySize()
+{
+  vtkIdType size = 0;
+  if ( this->Links )
   {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
+    size += (static_cast<vtkIdType>(this->LinksSize) + 1) * sizeof(TIds);
   }
-
-  // Now build the links. The summation from the prefix sum indicates where
-  // the cells are to be inserted. Each time a cell is inserted, the offset
-  // is decremented. In the end, the offset array is also constructed as it
-  // points to the beginning of each cell run.
-  for ( CellId=0, j=0; j < 4; ++j )
+  if ( this->Offsets )
   {
-    cell = cellArrays[j]->GetPointer();
-    for ( cellId=0; cellId < numCells[j]; ++cellId )
-    {
-      npts = *cell++;
-      for (i=0; i<npts; ++i)
-      {
-        this->Offsets[*cell]--;
-        this->Links[this->Offsets[*cell++]] = CellId+cellId;
-      }
-    }
-    CellId += numCells[j];
-  }//for each of the four polydata arrays
-  this->Offsets[this->NumPts] = this->LinksSize;
+    size += (static_cast<vtkIdType>(this->NumPts) + 1) * sizeof(TIds);
+  }
+  return static_cast<unsigned long>((size + 1023) / 1024); // kibibytes
 }
 
 #endif
@@ -28,6 +28,21 @@
 #include "vtkSMPTools.h"
 #include "vtkSMPThreadLocal.h"
 #include "vtkSMPThreadLocalObject.h"
+#include "vtkIdTypeArray.h"
+#include "vtkCellType.h"
+#include "vtkNew.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// SSE2 is part of every x86-64 processor, the packet intersection of
+// triangles uses it whenever the compiler targets it.
+#if defined(__SSE2__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VTK_STATIC_CELL_LOCATOR_SSE2
+#include <emmintrin.h>
+#endif
 
 vtkStandardNewMacro(vtkStaticCellLocator);
 
@@ -175,18 +190,10 @@ struct vtkCellBinner
         }
     }
 
+  // The prefix sum of the counts is computed in parallel once all the
+  // cells have been visited, see BuildLocator().
   void Reduce()
     {
-      //Perform prefix sum
-      vtkIdType *counts = this->Counts;
-      vtkIdType numBins, total=0, numCells=this->NumCells;
-      for ( vtkIdType i=0; i < numCells; ++i )
-        {
-        numBins = *counts;
-        *counts++ = total;
-        total += numBins;
-        }
-      this->NumFragments = total;
     }
 
 }; //vtkCellBinner
@@ -209,6 +216,360 @@ struct CellFragments
     {return BinId < tuple.BinId;}
 };
 
+//-----------------------------------------------------------------------------
+// Support for the batched line queries. Triangles and quads (split into two
+// triangles along the diagonal vtkQuad uses) are stored with the data the
+// Moller-Trumbore intersection needs, and the candidate triangles of a bin
+// are gathered in packets that are intersected with the line several at a
+// time. The packet test only decides the clear cases: the line crosses the
+// triangle well inside its edges, or misses it by more than the tolerance.
+// Anything closer to an edge, to the ends of the line, or nearly parallel
+// to the triangle is left to vtkCell::IntersectWithLine(), so that the
+// result matches the one cell at a time query.
+namespace {
+
+// Layout of a triangle: first point, the two edges from it, the (not
+// normalized) normal, the inverse heights from each point and whether the
+// triangle is not degenerate.
+enum
+{
+  VTK_TRI_P0 = 0,
+  VTK_TRI_E1 = 3,
+  VTK_TRI_E2 = 6,
+  VTK_TRI_N = 9,
+  VTK_TRI_INV_H = 12,
+  VTK_TRI_VALID = 15,
+  VTK_TRI_SIZE = 16
+};
+
+// Outcome of the packet test of a triangle.
+enum
+{
+  VTK_PACKET_MISS = 0,
+  VTK_PACKET_HIT = 1,
+  VTK_PACKET_UNSURE = 2
+};
+
+// Relative margins of the packet test. Barycentric coordinates and line
+// parametric coordinates this close to the boundaries are unsure. The
+// parallel margin is twice the one of vtkPlane::IntersectWithLine().
+const double VTK_PACKET_EPS = 1.0e-09;
+const double VTK_PACKET_PARALLEL_TOL = 2.0e-06;
+
+void vtkSetTriangle(const double p0[3], const double p1[3],
+                    const double p2[3], double *tri)
+{
+  double e12[3];
+  for (int i=0; i < 3; ++i)
+  {
+    tri[VTK_TRI_P0+i] = p0[i];
+    tri[VTK_TRI_E1+i] = p1[i] - p0[i];
+    tri[VTK_TRI_E2+i] = p2[i] - p0[i];
+    e12[i] = p2[i] - p1[i];
+  }
+  vtkMath::Cross(tri+VTK_TRI_E1, tri+VTK_TRI_E2, tri+VTK_TRI_N);
+  double twiceArea = vtkMath::Norm(tri+VTK_TRI_N);
+  if ( twiceArea > 0.0 )
+  {
+    tri[VTK_TRI_INV_H] = vtkMath::Norm(e12) / twiceArea;
+    tri[VTK_TRI_INV_H+1] = vtkMath::Norm(tri+VTK_TRI_E2) / twiceArea;
+    tri[VTK_TRI_INV_H+2] = vtkMath::Norm(tri+VTK_TRI_E1) / twiceArea;
+    tri[VTK_TRI_VALID] = 1.0;
+  }
+  else
+  {
+    tri[VTK_TRI_INV_H] = tri[VTK_TRI_INV_H+1] = tri[VTK_TRI_INV_H+2] = 0.0;
+    tri[VTK_TRI_VALID] = 0.0;
+  }
+}
+
+// Scalar operations of the packet test.
+struct vtkScalarOps
+{
+  typedef double V;
+  typedef bool M;
+  enum { Width = 1 };
+
+  static V Gather(const double *const *tris, int field)
+    { return tris[0][field]; }
+  static V Set(double v) { return v; }
+  static V Add(V a, V b) { return a + b; }
+  static V Sub(V a, V b) { return a - b; }
+  static V Mul(V a, V b) { return a * b; }
+  static V Div(V a, V b) { return a / b; }
+  static V Abs(V a) { return (a < 0.0 ? -a : a); }
+  static M Lt(V a, V b) { return a < b; }
+  static M Le(V a, V b) { return a <= b; }
+  static M And(M a, M b) { return a && b; }
+  static M Or(M a, M b) { return a || b; }
+  static M AndNot(M a, M b) { return a && !b; }
+  static void Store(double *p, V a) { *p = a; }
+  static void StoreStates(M hit, M miss, int *states)
+  {
+    states[0] = (hit ? VTK_PACKET_HIT :
+                 (miss ? VTK_PACKET_MISS : VTK_PACKET_UNSURE));
+  }
+};
+
+#ifdef VTK_STATIC_CELL_LOCATOR_SSE2
+// SSE2 operations of the packet test, two triangles at a time.
+struct vtkSSE2Ops
+{
+  typedef __m128d V;
+  typedef __m128d M;
+  enum { Width = 2 };
+
+  static V Gather(const double *const *tris, int field)
+    { return _mm_set_pd(tris[1][field], tris[0][field]); }
+  static V Set(double v) { return _mm_set1_pd(v); }
+  static V Add(V a, V b) { return _mm_add_pd(a, b); }
+  static V Sub(V a, V b) { return _mm_sub_pd(a, b); }
+  static V Mul(V a, V b) { return _mm_mul_pd(a, b); }
+  static V Div(V a, V b) { return _mm_div_pd(a, b); }
+  static V Abs(V a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+  static M Lt(V a, V b) { return _mm_cmplt_pd(a, b); }
+  static M Le(V a, V b) { return _mm_cmple_pd(a, b); }
+  static M And(M a, M b) { return _mm_and_pd(a, b); }
+  static M Or(M a, M b) { return _mm_or_pd(a, b); }
+  static M AndNot(M a, M b) { return _mm_andnot_pd(b, a); }
+  static void Store(double *p, V a) { _mm_storeu_pd(p, a); }
+  static void StoreStates(M hit, M miss, int *states)
+  {
+    int hits = _mm_movemask_pd(hit);
+    int misses = _mm_movemask_pd(miss);
+    for (int i=0; i < 2; ++i)
+    {
+      states[i] = ((hits >> i) & 1 ? VTK_PACKET_HIT :
+                   ((misses >> i) & 1 ? VTK_PACKET_MISS : VTK_PACKET_UNSURE));
+    }
+  }
+};
+#endif
+
+// Intersect the line a0 + t*d, 0 <= t <= 1, with Ops::Width triangles.
+template <typename Ops>
+void vtkIntersectTriangles(const double *const *tris, const double a0[3],
+                           const double d[3], double tol, double *ts,
+                           int *states)
+{
+  typedef typename Ops::V V;
+  typedef typename Ops::M M;
+
+  V dx = Ops::Set(d[0]), dy = Ops::Set(d[1]), dz = Ops::Set(d[2]);
+  V e1x = Ops::Gather(tris, VTK_TRI_E1);
+  V e1y = Ops::Gather(tris, VTK_TRI_E1+1);
+  V e1z = Ops::Gather(tris, VTK_TRI_E1+2);
+  V e2x = Ops::Gather(tris, VTK_TRI_E2);
+  V e2y = Ops::Gather(tris, VTK_TRI_E2+1);
+  V e2z = Ops::Gather(tris, VTK_TRI_E2+2);
+
+  // Vector from the first point of the triangles to the line origin
+  V tx = Ops::Sub(Ops::Set(a0[0]), Ops::Gather(tris, VTK_TRI_P0));
+  V ty = Ops::Sub(Ops::Set(a0[1]), Ops::Gather(tris, VTK_TRI_P0+1));
+  V tz = Ops::Sub(Ops::Set(a0[2]), Ops::Gather(tris, VTK_TRI_P0+2));
+
+  // p = d x e2, det = e1.p = -n.d
+  V px = Ops::Sub(Ops::Mul(dy, e2z), Ops::Mul(dz, e2y));
+  V py = Ops::Sub(Ops::Mul(dz, e2x), Ops::Mul(dx, e2z));
+  V pz = Ops::Sub(Ops::Mul(dx, e2y), Ops::Mul(dy, e2x));
+  V det = Ops::Add(Ops::Add(Ops::Mul(e1x, px), Ops::Mul(e1y, py)),
+                   Ops::Mul(e1z, pz));
+
+  // Same parallel test as vtkPlane::IntersectWithLine(), with num = -n.t
+  V num = Ops::Add(Ops::Add(
+    Ops::Mul(Ops::Gather(tris, VTK_TRI_N), tx),
+    Ops::Mul(Ops::Gather(tris, VTK_TRI_N+1), ty)),
+    Ops::Mul(Ops::Gather(tris, VTK_TRI_N+2), tz));
+  M parallel = Ops::Le(Ops::Abs(det), Ops::Mul(Ops::Abs(num),
+                                 Ops::Set(VTK_PACKET_PARALLEL_TOL)));
+  M unsure = Ops::Or(parallel, Ops::Lt(Ops::Gather(tris, VTK_TRI_VALID),
+                                        Ops::Set(0.5)));
+
+  // Barycentric coordinates (w,u,v) of the intersection and parametric
+  // coordinate t along the line, with q = t x e1.
+  V invDet = Ops::Div(Ops::Set(1.0), det);
+  V u = Ops::Mul(Ops::Add(Ops::Add(Ops::Mul(tx, px), Ops::Mul(ty, py)),
+                          Ops::Mul(tz, pz)), invDet);
+  V qx = Ops::Sub(Ops::Mul(ty, e1z), Ops::Mul(tz, e1y));
+  V qy = Ops::Sub(Ops::Mul(tz, e1x), Ops::Mul(tx, e1z));
+  V qz = Ops::Sub(Ops::Mul(tx, e1y), Ops::Mul(ty, e1x));
+  V v = Ops::Mul(Ops::Add(Ops::Add(Ops::Mul(dx, qx), Ops::Mul(dy, qy)),
+                          Ops::Mul(dz, qz)), invDet);
+  V t = Ops::Mul(Ops::Add(Ops::Add(Ops::Mul(e2x, qx), Ops::Mul(e2y, qy)),
+                          Ops::Mul(e2z, qz)), invDet);
+  V w = Ops::Sub(Ops::Sub(Ops::Set(1.0), u), v);
+
+  V eps = Ops::Set(VTK_PACKET_EPS);
+  V zero = Ops::Set(0.0);
+  M tIn = Ops::And(Ops::Lt(eps, t), Ops::Lt(t, Ops::Set(1.0-VTK_PACKET_EPS)));
+  M tOut = Ops::Or(Ops::Lt(t, Ops::Set(-VTK_PACKET_EPS)),
+                   Ops::Lt(Ops::Set(1.0+VTK_PACKET_EPS), t));
+  M inside = Ops::And(Ops::And(Ops::Lt(eps, w), Ops::Lt(eps, u)),
+                      Ops::Lt(eps, v));
+
+  // A negative barycentric coordinate times the height of its point is
+  // the distance to the line of the opposite edge, which bounds the
+  // distance to the triangle.
+  V tolV = Ops::Set(tol*(1.0+VTK_PACKET_EPS));
+  M far = Ops::Or(Ops::Or(
+    Ops::Lt(Ops::Add(w, Ops::Add(Ops::Mul(tolV,
+      Ops::Gather(tris, VTK_TRI_INV_H)), eps)), zero),
+    Ops::Lt(Ops::Add(u, Ops::Add(Ops::Mul(tolV,
+      Ops::Gather(tris, VTK_TRI_INV_H+1)), eps)), zero)),
+    Ops::Lt(Ops::Add(v, Ops::Add(Ops::Mul(tolV,
+      Ops::Gather(tris, VTK_TRI_INV_H+2)), eps)), zero));
+
+  M hit = Ops::AndNot(Ops::And(tIn, inside), unsure);
+  M miss = Ops::AndNot(Ops::Or(tOut, Ops::And(tIn, far)), unsure);
+  Ops::Store(ts, t);
+  Ops::StoreStates(hit, miss, states);
+}
+
+// The candidate triangles of a line query, gathered for the packet test.
+// A quad takes two consecutive triangles.
+struct vtkTrianglePacket
+{
+  enum { Size = 8 };
+  vtkIdType CellIds[Size];
+  int NumCells;
+  const double *Triangles[Size];
+  int NumTriangles;
+  double T[Size];
+  int States[Size];
+
+  vtkTrianglePacket() : NumCells(0), NumTriangles(0) {}
+
+  void Intersect(const double a0[3], const double d[3], double tol)
+  {
+    int i = 0;
+#ifdef VTK_STATIC_CELL_LOCATOR_SSE2
+    for ( ; i+2 <= this->NumTriangles; i+=2 )
+    {
+      vtkIntersectTriangles<vtkSSE2Ops>(this->Triangles+i, a0, d, tol,
+                                        this->T+i, this->States+i);
+    }
+#endif
+    for ( ; i < this->NumTriangles; ++i )
+    {
+      vtkIntersectTriangles<vtkScalarOps>(this->Triangles+i, a0, d, tol,
+                                          this->T+i, this->States+i);
+    }
+  }
+};
+
+// Count the triangles of each cell: one per triangle, two per quad.
+struct vtkCountTriangles
+{
+  vtkDataSet *DataSet;
+  vtkIdType *Offsets;
+
+  void operator() (vtkIdType cellId, vtkIdType endCellId)
+  {
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      int type = this->DataSet->GetCellType(cellId);
+      this->Offsets[cellId] = (type == VTK_TRIANGLE ? 1 :
+                               (type == VTK_QUAD ? 2 : 0));
+    }
+  }
+};
+
+// Store the triangles of each cell.
+struct vtkFillTriangles
+{
+  vtkDataSet *DataSet;
+  const vtkIdType *Offsets;
+  double *Triangles;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds;
+
+  vtkFillTriangles(vtkDataSet *ds, const vtkIdType *offsets, double *tris) :
+    DataSet(ds), Offsets(offsets), Triangles(tris)
+  {
+  }
+
+  void Initialize()
+  {
+  }
+
+  void operator() (vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *ptIds = this->PtIds.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    double x[4][3];
+
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      vtkIdType numTris = this->Offsets[cellId+1] - this->Offsets[cellId];
+      if ( numTris < 1 )
+      {
+        continue;
+      }
+      double *tri = this->Triangles + VTK_TRI_SIZE*this->Offsets[cellId];
+      this->DataSet->GetCellPoints(cellId, npts, pts, ptIds);
+      for (int i=0; i < npts; ++i)
+      {
+        this->DataSet->GetPoint(pts[i], x[i]);
+      }
+      if ( numTris == 1 )
+      {
+        vtkSetTriangle(x[0], x[1], x[2], tri);
+        continue;
+      }
+
+      // Same diagonal as vtkQuad::IntersectWithLine(). It compares the
+      // lengths of the diagonals from two vtkPoints::GetPoint() calls,
+      // which return the same buffer, so the point ids always decide.
+      vtkIdType maxId = 0;
+      int maxIdx = 0;
+      for (int i=0; i < 4; ++i)
+      {
+        if ( pts[i] > maxId )
+        {
+          maxId = pts[i];
+          maxIdx = i;
+        }
+      }
+      int diagonalCase = ( maxIdx == 0 || maxIdx == 2 ? 0 : 1 );
+      if ( diagonalCase == 0 )
+      {
+        vtkSetTriangle(x[0], x[1], x[2], tri);
+        vtkSetTriangle(x[2], x[3], x[0], tri+VTK_TRI_SIZE);
+      }
+      else
+      {
+        vtkSetTriangle(x[0], x[1], x[3], tri);
+        vtkSetTriangle(x[2], x[3], x[1], tri+VTK_TRI_SIZE);
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// The state of the line queries of one thread. The visited marks avoid
+// testing a cell several times when it spans several bins, they are only
+// cleared when the query number rolls over.
+struct vtkLineQuery
+{
+  unsigned char *CellHasBeenVisited;
+  unsigned char QueryNumber;
+  vtkTrianglePacket *Packet; // nullptr to test every cell with vtkCell
+};
+
+// The best intersection found by a line query.
+struct vtkLineHit
+{
+  vtkIdType CellId;
+  double T;
+  double MinPDistance;
+  double X[3];
+};
+
+} //anonymous namespace
+
 // Perform locator operations like FindCell. Uses templated subclasses
 // to reduce memory and enhance speed.
 struct vtkCellProcessor
@@ -226,6 +587,12 @@ struct vtkCellProcessor
   unsigned char *CellHasBeenVisited; //intersection operations
   unsigned char QueryNumber;
 
+  // Triangles of the batched line queries, see BuildTriangles(). The
+  // triangles of a cell are TriangleOffsets[cellId] to
+  // TriangleOffsets[cellId+1]-1.
+  std::vector<vtkIdType> TriangleOffsets;
+  std::vector<double> Triangles;
+
   vtkCellProcessor(vtkCellBinner *cb) : Binner(cb)
     {
       this->DataSet = cb->DataSet;
@@ -267,6 +634,38 @@ struct vtkCellProcessor
                                 double& t, double x[3], double pcoords[3],
                                 int &subId, vtkIdType &cellId,
                                 vtkGenericCell *cell) = 0;
+  virtual void IntersectWithLines(vtkPoints *p1s, vtkPoints *p2s,
+                                  double tol, vtkIdType *cellIds,
+                                  double *ts, double *hits) = 0;
+
+  // Store the triangles and quads of the dataset for the packet test of
+  // the batched line queries. This is done once, in parallel.
+  void BuildTriangles()
+    {
+      if ( !this->TriangleOffsets.empty() )
+      {
+        return;
+      }
+
+      // Build the cells of the dataset from this thread.
+      vtkNew<vtkGenericCell> cell;
+      this->DataSet->GetCell(0, cell.GetPointer());
+
+      this->TriangleOffsets.resize(this->NumCells+1);
+      vtkIdType *offsets = &this->TriangleOffsets[0];
+      vtkCountTriangles count = { this->DataSet, offsets };
+      vtkSMPTools::For(0, this->NumCells, count);
+      vtkIdType numTris = vtkSMPTools::ExclusiveScan(
+        offsets, offsets+this->NumCells, offsets, vtkIdType(0));
+      offsets[this->NumCells] = numTris;
+      if ( numTris > 0 )
+      {
+        this->Triangles.resize(VTK_TRI_SIZE*numTris);
+        vtkFillTriangles fill(this->DataSet, offsets, &this->Triangles[0]);
+        vtkSMPTools::For(0, this->NumCells, fill);
+      }
+    }
+
   // Convenience for computing
   virtual int IsEmpty(vtkIdType binId) = 0;
 };
@@ -342,11 +741,31 @@ struct CellProcessor : public vtkCellProcessor
                                 double& t, double x[3], double pcoords[3],
                                 int &subId, vtkIdType &cellId,
                                 vtkGenericCell *cell);
+  virtual void IntersectWithLines(vtkPoints *p1s, vtkPoints *p2s,
+                                  double tol, vtkIdType *cellIds,
+                                  double *ts, double *hits);
   virtual int IsEmpty(vtkIdType binId)
   {
     return ( this->GetNumberOfIds(static_cast<T>(binId)) > 0 ? 0 : 1 );
   }
 
+  // Line query support. TraceLine() walks the bins along the line and
+  // returns the best intersection in hit. The candidate cells are tested
+  // with TestCell(), or gathered in the packet of the query when it has
+  // one and tested with IntersectPacket().
+  bool TraceLine(double a0[3], double a1[3], double tol,
+                 vtkGenericCell *cell, vtkLineQuery &query, vtkLineHit &hit);
+  void TestCell(vtkIdType cId, double a0[3], double a1[3], double tol,
+                double binBounds[6], double deltaT, vtkGenericCell *cell,
+                vtkLineQuery &query, vtkLineHit &hit);
+  void IntersectPacket(double a0[3], double a1[3], double direction[3],
+                       double tol, double binBounds[6], double deltaT,
+                       vtkGenericCell *cell, vtkLineQuery &query,
+                       vtkLineHit &hit);
+  void UpdateHit(vtkIdType cId, double t, double x[3], double pDistance,
+                 double binBounds[6], double tol, double deltaT,
+                 vtkLineQuery &query, vtkLineHit &hit);
+
   // This functor is used to perform the final cell binning
   void Initialize()
     {
@@ -570,10 +989,9 @@ FindCellsWithinBounds(double *bbox, vtkIdList *cells)
 // years.  Why mess with success? If I was to rewrite the algorithm I'd use a
 // deterministic approach to identify the bins, in order, that the line
 // intersects.
-template <typename T> int CellProcessor<T>::
-IntersectWithLine(double a0[3], double a1[3], double tol, double& t, double x[3],
-                  double pcoords[3], int &subId, vtkIdType &cellId,
-                  vtkGenericCell *cell)
+template <typename T> bool CellProcessor<T>::
+TraceLine(double a0[3], double a1[3], double tol, vtkGenericCell *cell,
+          vtkLineQuery &query, vtkLineHit &hit)
 {
   double origin[3];
   double direction1[3];
@@ -586,17 +1004,23 @@ IntersectWithLine(double a0[3], double a1[3], double tol, double& t, double x[3]
   double binBounds[6];
   double *bounds=this->Binner->Bounds, bounds2[6];
   int i, loop;
-  vtkIdType bestCellId=(-1), cId;
+  vtkIdType cId;
   int idx;
   double tMax, dist[3];
   int npos[3];
   int pos[3];
   int bestDir;
   double stopDist, currDist;
-  double deltaT, pDistance, minPDistance=1.0e38;
+  double deltaT;
   double length, maxLength=0.0;
-  T numCellsInBin;
+  T numCellsInBin, binCellId;
   vtkIdType numDivisions=0, prod=ndivs[0]*ndivs[1];
+  vtkTrianglePacket *packet = query.Packet;
+  const vtkIdType *triOffsets =
+    ( packet ? &this->TriangleOffsets[0] : nullptr );
+
+  hit.CellId = -1;
+  hit.MinPDistance = 1.0e38;
 
   // convert the line into i,j,k coordinates
   tMax = 0.0;
@@ -633,23 +1057,14 @@ IntersectWithLine(double a0[3], double a1[3], double tol, double& t, double x[3]
 
   if (vtkBox::IntersectBox(bounds2, origin, direction2, hitPosition, result))
   {
-    // start walking through the bins
-    bestCellId = -1;
-
-    // Initialize intersection query array if necessary
-    if ( this->CellHasBeenVisited == nullptr )
-    {
-      this->CellHasBeenVisited = new unsigned char [ this->NumCells ];
-    }
-
     // Clear the array that indicates whether we have visited this cell.
     // The array is only cleared when the query number rolls over.  This
     // saves a number of calls to memset.
-    this->QueryNumber++;
-    if (this->QueryNumber == 0)
+    query.QueryNumber++;
+    if (query.QueryNumber == 0)
     {
-      this->ClearCellHasBeenVisited();
-      this->QueryNumber++;    // can't use 0 as a marker
+      memset(query.CellHasBeenVisited, 0, this->NumCells);
+      query.QueryNumber++;    // can't use 0 as a marker
     }
 
     // set up curr and stop dist
@@ -675,7 +1090,7 @@ IntersectWithLine(double a0[3], double a1[3], double tol, double& t, double x[3]
 
     idx = pos[0] - 1 + (pos[1] - 1)*ndivs[0] + (pos[2] - 1)*prod;
 
-    while ((bestCellId < 0) && (pos[0] > 0) && (pos[1] > 0) && (pos[2] > 0) &&
+    while ((hit.CellId < 0) && (pos[0] > 0) && (pos[1] > 0) && (pos[2] > 0) &&
       (pos[0] <= ndivs[0]) && (pos[1] <= ndivs[1]) && (pos[2] <= ndivs[2]) &&
       (currDist < stopDist))
     {
@@ -683,48 +1098,55 @@ IntersectWithLine(double a0[3], double a1[3], double tol, double& t, double x[3]
       {
         const CellFragments<T> *cellIds = this->GetIds(idx);
         this->ComputeBinBounds(pos[0]-1,pos[1]-1,pos[2]-1, binBounds);
-        for (tMax = VTK_DOUBLE_MAX, cellId=0; cellId < numCellsInBin; cellId++)
+        for (hit.T = VTK_DOUBLE_MAX, binCellId=0; binCellId < numCellsInBin;
+             binCellId++)
         {
-          cId = cellIds[cellId].CellId;
-          if (this->CellHasBeenVisited[cId] != this->QueryNumber)
+          cId = cellIds[binCellId].CellId;
+          if (query.CellHasBeenVisited[cId] != query.QueryNumber)
           {
-            this->CellHasBeenVisited[cId] = this->QueryNumber;
-            int hitCellBounds = 0;
-
-            // check whether we intersect the cell bounds
-            hitCellBounds = vtkBox::IntersectBox(this->CellBounds+(6*cId),
-                                                 a0, direction1,
-                                                 hitCellBoundsPosition, result);
-
-            if (hitCellBounds)
+            query.CellHasBeenVisited[cId] = query.QueryNumber;
+
+            // check whether we intersect the cell bounds first; the
+            // triangles and quads then wait for the packet test, other
+            // cells do the expensive GetCell call and intersect with line
+            if ( !vtkBox::IntersectBox(this->CellBounds+(6*cId), a0,
+                                       direction1, hitCellBoundsPosition,
+                                       result) )
+            {
+              continue;
+            }
+            vtkIdType numTris = 0;
+            if ( triOffsets )
+            {
+              numTris = triOffsets[cId+1] - triOffsets[cId];
+            }
+            if ( numTris > 0 )
             {
-              // now, do the expensive GetCell call and the expensive
-              // intersect with line call
-              this->DataSet->GetCell(cId, cell);
-              if (cell->IntersectWithLine(a0, a1, tol, t, x, pcoords, subId) )
+              if ( packet->NumTriangles + numTris > vtkTrianglePacket::Size )
+              {
+                this->IntersectPacket(a0, a1, direction1, tol, binBounds,
+                                      deltaT, cell, query, hit);
+              }
+              const double *tri = &this->Triangles[0] +
+                VTK_TRI_SIZE*triOffsets[cId];
+              packet->CellIds[packet->NumCells++] = cId;
+              for (vtkIdType j=0; j < numTris; ++j, tri+=VTK_TRI_SIZE)
               {
-                if ( ! this->IsInBinBounds(binBounds, x, tol) )
-                {
-                  this->CellHasBeenVisited[cId] = 0; //mark the cell non-visited
-                }
-                else
-                {
-                  if ( t < (tMax+deltaT) ) //it might be close
-                  {
-                    pDistance = cell->GetParametricDistance(pcoords);
-                    if ( pDistance < minPDistance ||
-                         (pDistance == minPDistance && t < tMax) )
-                    {
-                      tMax = t;
-                      minPDistance = pDistance;
-                      bestCellId = cId;
-                    }
-                  } //intersection point is in current bin
-                } //if within current parametric range
-              } // if intersection
-            } // if (hitCellBounds)
+                packet->Triangles[packet->NumTriangles++] = tri;
+              }
+            }
+            else
+            {
+              this->TestCell(cId, a0, a1, tol, binBounds, deltaT, cell,
+                             query, hit);
+            }
           } // if (!this->CellHasBeenVisited[cId])
         }
+        if ( packet && packet->NumCells > 0 )
+        {
+          this->IntersectPacket(a0, a1, direction1, tol, binBounds, deltaT,
+                                cell, query, hit);
+        }
       }
 
       // move to the next bin
@@ -784,19 +1206,217 @@ IntersectWithLine(double a0[3], double a1[3], double tol, double& t, double x[3]
     }
   } // if (vtkBox::IntersectBox(...))
 
-  if (bestCellId >= 0)
+  return ( hit.CellId >= 0 );
+}
+
+//-----------------------------------------------------------------------------
+// Intersect the line with one cell through vtkCell.
+template <typename T> void CellProcessor<T>::
+TestCell(vtkIdType cId, double a0[3], double a1[3], double tol,
+         double binBounds[6], double deltaT, vtkGenericCell *cell,
+         vtkLineQuery &query, vtkLineHit &hit)
+{
+  double t, x[3], pcoords[3];
+  int subId;
+  this->DataSet->GetCell(cId, cell);
+  if (cell->IntersectWithLine(a0, a1, tol, t, x, pcoords, subId) )
   {
-    this->DataSet->GetCell(bestCellId, cell);
+    this->UpdateHit(cId, t, x, cell->GetParametricDistance(pcoords),
+                    binBounds, tol, deltaT, query, hit);
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Intersect the line with the triangles and quads of the packet. The cells
+// the packet test cannot decide are tested through vtkCell.
+template <typename T> void CellProcessor<T>::
+IntersectPacket(double a0[3], double a1[3], double direction[3], double tol,
+                double binBounds[6], double deltaT, vtkGenericCell *cell,
+                vtkLineQuery &query, vtkLineHit &hit)
+{
+  vtkTrianglePacket *packet = query.Packet;
+  packet->Intersect(a0, direction, tol);
+
+  double x[3];
+  int tri = 0;
+  for (int i=0; i < packet->NumCells; ++i)
+  {
+    vtkIdType cId = packet->CellIds[i];
+    int state = packet->States[tri];
+    double t = packet->T[tri];
+    if ( this->TriangleOffsets[cId+1] - this->TriangleOffsets[cId] == 2 )
+    {
+      // vtkQuad reports the first triangle it intersects
+      if ( state == VTK_PACKET_MISS )
+      {
+        state = packet->States[tri+1];
+        t = packet->T[tri+1];
+      }
+      tri += 2;
+    }
+    else
+    {
+      tri++;
+    }
+
+    if ( state == VTK_PACKET_HIT )
+    {
+      x[0] = a0[0] + t*direction[0];
+      x[1] = a0[1] + t*direction[1];
+      x[2] = a0[2] + t*direction[2];
+      this->UpdateHit(cId, t, x, 0.0, binBounds, tol, deltaT, query, hit);
+    }
+    else if ( state == VTK_PACKET_UNSURE )
+    {
+      this->TestCell(cId, a0, a1, tol, binBounds, deltaT, cell, query, hit);
+    }
+  }
+  packet->NumCells = 0;
+  packet->NumTriangles = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Keep the intersection (t,x) with a cell if it is the best so far.
+template <typename T> void CellProcessor<T>::
+UpdateHit(vtkIdType cId, double t, double x[3], double pDistance,
+          double binBounds[6], double tol, double deltaT, vtkLineQuery &query,
+          vtkLineHit &hit)
+{
+  if ( ! this->IsInBinBounds(binBounds, x, tol) )
+  {
+    query.CellHasBeenVisited[cId] = 0; //mark the cell non-visited
+  }
+  else
+  {
+    if ( t < (hit.T+deltaT) ) //it might be close
+    {
+      if ( pDistance < hit.MinPDistance ||
+           (pDistance == hit.MinPDistance && t < hit.T) )
+      {
+        hit.T = t;
+        hit.MinPDistance = pDistance;
+        hit.CellId = cId;
+        hit.X[0] = x[0];
+        hit.X[1] = x[1];
+        hit.X[2] = x[2];
+      }
+    } //intersection point is in current bin
+  } //if within current parametric range
+}
+
+//-----------------------------------------------------------------------------
+template <typename T> int CellProcessor<T>::
+IntersectWithLine(double a0[3], double a1[3], double tol, double& t, double x[3],
+                  double pcoords[3], int &subId, vtkIdType &cellId,
+                  vtkGenericCell *cell)
+{
+  // Initialize intersection query array if necessary
+  if ( this->CellHasBeenVisited == nullptr )
+  {
+    this->CellHasBeenVisited = new unsigned char [ this->NumCells ]();
+  }
+
+  vtkLineQuery query = { this->CellHasBeenVisited, this->QueryNumber,
+                         nullptr };
+  vtkLineHit hit;
+  bool found = this->TraceLine(a0, a1, tol, cell, query, hit);
+  this->QueryNumber = query.QueryNumber;
+
+  if ( found )
+  {
+    this->DataSet->GetCell(hit.CellId, cell);
     cell->IntersectWithLine(a0, a1, tol, t, x, pcoords, subId);
 
     // store the best cell id in the return "parameter"
-    cellId = bestCellId;
+    cellId = hit.CellId;
     return 1;
   }
 
   return 0;
 }
 
+//-----------------------------------------------------------------------------
+// Threaded batched line queries. Each thread has its own visited marks,
+// packet and generic cell.
+template <typename T>
+struct IntersectLines
+{
+  CellProcessor<T> *Processor;
+  vtkPoints *P1s;
+  vtkPoints *P2s;
+  double Tol;
+  vtkIdType *CellIds;
+  double *Ts;
+  double *Hits;
+
+  vtkSMPThreadLocal<std::vector<unsigned char> > Visited;
+  vtkSMPThreadLocal<unsigned char> QueryNumber;
+  vtkSMPThreadLocal<vtkTrianglePacket> Packet;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+
+  IntersectLines(CellProcessor<T> *p, vtkPoints *p1s, vtkPoints *p2s,
+                 double tol, vtkIdType *cellIds, double *ts, double *hits) :
+    Processor(p), P1s(p1s), P2s(p2s), Tol(tol), CellIds(cellIds), Ts(ts),
+    Hits(hits)
+  {
+  }
+
+  void Initialize()
+  {
+    this->Visited.Local().assign(this->Processor->NumCells, 0);
+    this->QueryNumber.Local() = 0;
+  }
+
+  void operator() (vtkIdType lineId, vtkIdType endLineId)
+  {
+    vtkLineQuery query = { &this->Visited.Local()[0],
+                           this->QueryNumber.Local(), &this->Packet.Local() };
+    vtkGenericCell *cell = this->Cell.Local();
+    vtkLineHit hit;
+    double a0[3], a1[3];
+
+    for ( ; lineId < endLineId; ++lineId )
+    {
+      this->P1s->GetPoint(lineId, a0);
+      this->P2s->GetPoint(lineId, a1);
+      if ( this->Processor->TraceLine(a0, a1, this->Tol, cell, query, hit) )
+      {
+        this->CellIds[lineId] = hit.CellId;
+        if ( this->Ts )
+        {
+          this->Ts[lineId] = hit.T;
+        }
+        if ( this->Hits )
+        {
+          double *x = this->Hits + 3*lineId;
+          x[0] = hit.X[0];
+          x[1] = hit.X[1];
+          x[2] = hit.X[2];
+        }
+      }
+      else
+      {
+        this->CellIds[lineId] = -1;
+      }
+    }
+    this->QueryNumber.Local() = query.QueryNumber;
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+//-----------------------------------------------------------------------------
+template <typename T> void CellProcessor<T>::
+IntersectWithLines(vtkPoints *p1s, vtkPoints *p2s, double tol,
+                   vtkIdType *cellIds, double *ts, double *hits)
+{
+  this->BuildTriangles();
+  IntersectLines<T> intersect(this, p1s, p2s, tol, cellIds, ts, hits);
+  vtkSMPTools::For(0, p1s->GetNumberOfPoints(), intersect);
+}
+
 //-----------------------------------------------------------------------------
 // Here is the VTK class proper.
 
@@ -886,6 +1506,47 @@ IntersectWithLine(double p1[3], double p2[3], double tol,
 }
 
 
+//-----------------------------------------------------------------------------
+void vtkStaticCellLocator::
+IntersectWithLines(vtkPoints *p1s, vtkPoints *p2s, double tol,
+                   vtkIdTypeArray *cellIds, vtkDoubleArray *ts,
+                   vtkPoints *hits)
+{
+  vtkIdType numLines = p1s->GetNumberOfPoints();
+  if ( p2s->GetNumberOfPoints() != numLines )
+    {
+    vtkErrorMacro( << "The lines must have as many end points as start points");
+    return;
+    }
+
+  cellIds->SetNumberOfComponents(1);
+  cellIds->SetNumberOfValues(numLines);
+  double *tsPtr = nullptr;
+  if ( ts )
+    {
+    ts->SetNumberOfComponents(1);
+    ts->SetNumberOfValues(numLines);
+    tsPtr = ts->GetPointer(0);
+    }
+  double *hitsPtr = nullptr;
+  if ( hits )
+    {
+    hits->SetDataTypeToDouble();
+    hits->SetNumberOfPoints(numLines);
+    hitsPtr = static_cast<double*>(hits->GetVoidPointer(0));
+    }
+
+  this->BuildLocator();
+  if ( ! this->Processor )
+    {
+    std::fill_n(cellIds->GetPointer(0), numLines, -1);
+    return;
+    }
+  this->Processor->IntersectWithLines(p1s, p2s, tol, cellIds->GetPointer(0),
+                                      tsPtr, hitsPtr);
+}
+
+
 //-----------------------------------------------------------------------------
 void vtkStaticCellLocator::
 BuildLocator()
@@ -957,6 +1618,10 @@ BuildLocator()
   delete this->Processor;
   this->Binner = new vtkCellBinner(this, numCells, numBins);
   vtkSMPTools::For(0, numCells, *(this->Binner));
+  vtkIdType *counts = this->Binner->Counts;
+  this->Binner->NumFragments = vtkSMPTools::ExclusiveScan(
+    counts, counts+numCells, counts, vtkIdType(0));
+  counts[numCells] = this->Binner->NumFragments;
 
   // Create sorted cell fragments tuples of (cellId,binId). Depending
   // on problem size, different types are used.
@@ -25,6 +25,11 @@
  * threaded (via vtkSMPTools), and supports one-time static construction
  * (i.e., incremental cell insertion is not supported).
  *
+ * Many lines can be intersected at once with IntersectWithLines(), which
+ * processes the lines in parallel. Triangles and quads are then tested
+ * several at a time with SIMD instructions, other cells through
+ * vtkCell::IntersectWithLine().
+ *
  * @warning
  * This class is templated. It may run slower than serial execution if the code
  * is not optimized during compilation. Build in Release or ReleaseWithDebugInfo.
@@ -45,6 +50,10 @@
 #include "vtkAbstractCellLocator.h"
 
 
+class vtkDoubleArray;
+class vtkIdTypeArray;
+class vtkPoints;
+
 // Forward declarations for PIMPL
 struct vtkCellBinner;
 struct vtkCellProcessor;
@@ -131,6 +140,20 @@ public:
     return this->Superclass::IntersectWithLine(p1, p2, points, cellIds);
   }
 
+  /**
+   * Intersect many finite lines with the cells, in parallel. The i-th line
+   * goes from p1s[i] to p2s[i]. On return, cellIds[i] is the id of the cell
+   * that the i-th line intersects, as IntersectWithLine() would return it,
+   * or -1 when the line misses all the cells. ts[i] is then the parametric
+   * coordinate of the intersection along the line, and hits[i] its
+   * position (they are left undefined for lines that miss). ts and hits may
+   * be nullptr when they are not needed. The first call after the locator
+   * is built prepares the triangles and quads for the SIMD tests.
+   */
+  void IntersectWithLines(vtkPoints *p1s, vtkPoints *p2s, double tol,
+                          vtkIdTypeArray *cellIds, vtkDoubleArray *ts,
+                          vtkPoints *hits);
+
   //@{
   /**
    * Satisfy vtkLocator abstract interface.
@@ -21,8 +21,11 @@
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkPointSet.h"
+#include "vtkSMPThreadLocal.h"
 #include "vtkSMPTools.h"
 
+#include <algorithm>
 #include <vector>
 
 vtkStandardNewMacro(vtkStaticPointLocator);
@@ -44,6 +47,15 @@ static const int VTK_INITIAL_BUCKET_SIZE=10000;
 // 3) The bucket offsets are updated to refer to the right entry location into
 // the sorted point ids array. This enables quick access, and an indirect count
 // of the number of points in each bucket.
+//
+// When only the points of the data set have changed, the locator may instead
+// be updated incrementally (see vtkStaticPointLocator::IncrementalUpdate):
+// 1) The bucket of every point is computed again in parallel, and the points
+// that changed bucket are gathered and sorted by their new bucket.
+// 2) The new number of points of each bucket (the points that stay plus the
+// points that arrive) is computed in parallel, and a parallel prefix sum of
+// these counts gives the new offsets.
+// 3) Each bucket is then filled in parallel in a new sorted map.
 
 // Believe it or not I had to change the name because MS Visual Studio was
 // mistakenly linking the hidden, scoped classes (vtkNeighborBuckets) found
@@ -102,6 +114,7 @@ public:
   // Virtuals for templated subclasses
   virtual ~vtkBucketList() {}
   virtual void BuildLocator() = 0;
+  virtual bool UpdateLocator(double maxFraction, vtkIdType &numMoved) = 0;
 
   // place points in appropriate buckets
   void GetBucketNeighbors(NeighborBuckets* buckets,
@@ -432,6 +445,7 @@ public:
   // Okay the various ivars
   LocatorTuple<TIds> *Map; //the map to be sorted
   TIds               *Offsets; //offsets for each bucket into the map
+  TIds               *PointBuckets; //bucket of each point, for updates
 
   // Construction
   BucketList(vtkStaticPointLocator *loc, vtkIdType numPts, int numBuckets) :
@@ -442,6 +456,7 @@ public:
       this->Map[numPts].Bucket = numBuckets;
       this->Offsets = new TIds[numBuckets+1];
       this->Offsets[numBuckets] = numPts;
+      this->PointBuckets = nullptr;
   }
 
   // Release allocated memory
@@ -449,6 +464,7 @@ public:
   {
       delete [] this->Map;
       delete [] this->Offsets;
+      delete [] this->PointBuckets;
   }
 
   // The number of point ids in a bucket is determined by computing the
@@ -545,6 +561,28 @@ public:
       }
   };
 
+  // Copy the buckets of the points from the map, before it is sorted.
+  template <typename T>
+  class CopyPointBuckets
+  {
+    public:
+      BucketList<T> *BList;
+
+      CopyPointBuckets(BucketList<T> *blist) : BList(blist)
+      {
+      }
+
+      void  operator()(vtkIdType ptId, vtkIdType end)
+      {
+        const LocatorTuple<T> *t = this->BList->Map + ptId;
+        T *bucket = this->BList->PointBuckets + ptId;
+        for ( ; ptId < end; ++ptId, ++t, ++bucket )
+        {
+          *bucket = t->Bucket;
+        }
+      }
+  };
+
   // A clever way to build offsets in parallel. Basically each thread builds
   // offsets across a range of the sorted map. Recall that offsets are an
   // integral value referring to the locations of the sorted points that
@@ -644,6 +682,15 @@ public:
         vtkSMPTools::For(0,this->NumPts, mapper);
       }
 
+      // Incremental updates need the bucket of each point. The map is still
+      // in point order.
+      if ( this->Locator->GetIncrementalUpdate() )
+      {
+        this->PointBuckets = new TIds[this->NumPts];
+        CopyPointBuckets<TIds> copier(this);
+        vtkSMPTools::For(0,this->NumPts, copier);
+      }
+
       // Now gather the points into contiguous runs in buckets
       //
       vtkSMPTools::Sort(this->Map, this->Map + this->NumPts);
@@ -658,6 +705,261 @@ public:
       MapOffsets<TIds> offMapper(this);
       vtkSMPTools::For(0,numBatches, offMapper);
   }
+
+  // Order the points that changed bucket by bucket, then by point id so that
+  // the update does not depend on the number of threads.
+  class TupleLess
+  {
+    public:
+      bool operator()(const LocatorTuple<TIds>& a,
+                      const LocatorTuple<TIds>& b) const
+      {
+          return ( a.Bucket < b.Bucket ||
+                   (a.Bucket == b.Bucket && a.PtId < b.PtId) );
+      }
+  };
+
+  // Find the points whose bucket changed. They are flagged, their bucket is
+  // updated, and they are gathered with their new bucket in thread local
+  // lists. The points are read from the points array if there is one, from
+  // the data set otherwise.
+  template <typename T, typename TPts>
+  class FindMovedPoints
+  {
+    public:
+      BucketList<T> *BList;
+      const TPts *Points;
+      vtkDataSet *DataSet;
+      unsigned char *Moved;
+      vtkSMPThreadLocal<std::vector<LocatorTuple<T> > > MovedTuples;
+
+      FindMovedPoints(BucketList<T> *blist, const TPts *pts, vtkDataSet *ds,
+                      unsigned char *moved) :
+        BList(blist), Points(pts), DataSet(ds), Moved(moved)
+      {
+      }
+
+      void  operator()(vtkIdType ptId, vtkIdType end)
+      {
+        double p[3];
+        T *pointBucket = this->BList->PointBuckets + ptId;
+        unsigned char *moved = this->Moved + ptId;
+        std::vector<LocatorTuple<T> >& movedTuples = this->MovedTuples.Local();
+        for ( ; ptId < end; ++ptId, ++pointBucket, ++moved )
+        {
+          if ( this->Points )
+          {
+            const TPts *x = this->Points + 3*ptId;
+            p[0] = static_cast<double>(x[0]);
+            p[1] = static_cast<double>(x[1]);
+            p[2] = static_cast<double>(x[2]);
+          }
+          else
+          {
+            this->DataSet->GetPoint(ptId,p);
+          }
+          T bucket = static_cast<T>(this->BList->GetBucketIndex(p));
+          *moved = ( bucket != *pointBucket ? 1 : 0 );
+          if ( *moved )
+          {
+            LocatorTuple<T> tuple;
+            tuple.PtId = static_cast<T>(ptId);
+            tuple.Bucket = bucket;
+            movedTuples.push_back(tuple);
+            *pointBucket = bucket;
+          }
+        }//for all points in this batch
+      }
+  };
+
+  // Count the points of each bucket after the update: the points that stay
+  // in the bucket plus the points that arrive in it. The arriving points
+  // are sorted by bucket.
+  template <typename T>
+  class CountBucketPoints
+  {
+    public:
+      BucketList<T> *BList;
+      const unsigned char *Moved;
+      const LocatorTuple<T> *Arrived;
+      const LocatorTuple<T> *ArrivedEnd;
+      T *Counts;
+
+      CountBucketPoints(BucketList<T> *blist, const unsigned char *moved,
+                        const LocatorTuple<T> *arrived,
+                        const LocatorTuple<T> *arrivedEnd, T *counts) :
+        BList(blist), Moved(moved), Arrived(arrived), ArrivedEnd(arrivedEnd),
+        Counts(counts)
+      {
+      }
+
+      void  operator()(vtkIdType bucket, vtkIdType end)
+      {
+        const T *offsets = this->BList->Offsets;
+        const LocatorTuple<T> *map = this->BList->Map;
+        LocatorTuple<T> key;
+        key.PtId = 0;
+        key.Bucket = static_cast<T>(bucket);
+        const LocatorTuple<T> *arrived =
+          std::lower_bound(this->Arrived, this->ArrivedEnd, key);
+        for ( ; bucket < end; ++bucket )
+        {
+          T count = 0;
+          for ( T i=offsets[bucket]; i < offsets[bucket+1]; ++i )
+          {
+            count += ( this->Moved[map[i].PtId] ? 0 : 1 );
+          }
+          for ( ; arrived < this->ArrivedEnd && arrived->Bucket == bucket;
+                ++arrived )
+          {
+            ++count;
+          }
+          this->Counts[bucket] = count;
+        }
+      }
+  };
+
+  // Fill the buckets of the new map at their new offsets, with the points
+  // that stay followed by the points that arrive.
+  template <typename T>
+  class FillBuckets
+  {
+    public:
+      BucketList<T> *BList;
+      const unsigned char *Moved;
+      const LocatorTuple<T> *Arrived;
+      const LocatorTuple<T> *ArrivedEnd;
+      const T *NewOffsets;
+      LocatorTuple<T> *NewMap;
+
+      FillBuckets(BucketList<T> *blist, const unsigned char *moved,
+                  const LocatorTuple<T> *arrived,
+                  const LocatorTuple<T> *arrivedEnd, const T *newOffsets,
+                  LocatorTuple<T> *newMap) :
+        BList(blist), Moved(moved), Arrived(arrived), ArrivedEnd(arrivedEnd),
+        NewOffsets(newOffsets), NewMap(newMap)
+      {
+      }
+
+      void  operator()(vtkIdType bucket, vtkIdType end)
+      {
+        const T *offsets = this->BList->Offsets;
+        const LocatorTuple<T> *map = this->BList->Map;
+        LocatorTuple<T> key;
+        key.PtId = 0;
+        key.Bucket = static_cast<T>(bucket);
+        const LocatorTuple<T> *arrived =
+          std::lower_bound(this->Arrived, this->ArrivedEnd, key);
+        for ( ; bucket < end; ++bucket )
+        {
+          LocatorTuple<T> *t = this->NewMap + this->NewOffsets[bucket];
+          for ( T i=offsets[bucket]; i < offsets[bucket+1]; ++i )
+          {
+            if ( ! this->Moved[map[i].PtId] )
+            {
+              *t++ = map[i];
+            }
+          }
+          for ( ; arrived < this->ArrivedEnd && arrived->Bucket == bucket;
+                ++arrived )
+          {
+            *t++ = *arrived;
+          }
+        }
+      }
+  };
+
+  // Gather the points that changed bucket, sorted by their new bucket.
+  template <typename TPts>
+  void GatherMovedPoints(const TPts *pts, unsigned char *moved,
+                         std::vector<LocatorTuple<TIds> >& arrived)
+  {
+      FindMovedPoints<TIds,TPts> finder(this,pts,this->DataSet,moved);
+      vtkSMPTools::For(0,this->NumPts, finder);
+
+      typename vtkSMPThreadLocal<std::vector<LocatorTuple<TIds> > >::iterator
+        itr = finder.MovedTuples.begin();
+      typename vtkSMPThreadLocal<std::vector<LocatorTuple<TIds> > >::iterator
+        itrEnd = finder.MovedTuples.end();
+      for ( ; itr != itrEnd; ++itr )
+      {
+        arrived.insert(arrived.end(), itr->begin(), itr->end());
+      }
+  }
+
+  // Re-bin the points whose bucket changed since the map was built. The
+  // buckets themselves are unchanged. Returns false if more than maxFraction
+  // of the points moved, in which case the locator must be built again.
+  bool UpdateLocator(double maxFraction, vtkIdType &numMoved) VTK_OVERRIDE
+  {
+      if ( ! this->PointBuckets )
+      {
+        numMoved = this->NumPts;
+        return false;
+      }
+
+      // Find the points that moved to another bucket
+      //
+      std::vector<unsigned char> moved(this->NumPts);
+      std::vector<LocatorTuple<TIds> > arrived;
+      vtkPointSet *ps = vtkPointSet::SafeDownCast(this->DataSet);
+      int dataType = ( ps && ps->GetPoints() ?
+                       ps->GetPoints()->GetDataType() : VTK_VOID );
+      if ( dataType == VTK_FLOAT )
+      {
+        this->GatherMovedPoints(
+          static_cast<float*>(ps->GetPoints()->GetVoidPointer(0)),
+          &moved[0], arrived);
+      }
+      else if ( dataType == VTK_DOUBLE )
+      {
+        this->GatherMovedPoints(
+          static_cast<double*>(ps->GetPoints()->GetVoidPointer(0)),
+          &moved[0], arrived);
+      }
+      else
+      {
+        this->GatherMovedPoints(static_cast<float*>(nullptr),
+                                &moved[0], arrived);
+      }
+
+      numMoved = static_cast<vtkIdType>(arrived.size());
+      if ( numMoved == 0 )
+      {
+        return true;
+      }
+      if ( numMoved > maxFraction * this->NumPts )
+      {
+        return false;
+      }
+      LocatorTuple<TIds> *arrivedBegin = &arrived[0];
+      LocatorTuple<TIds> *arrivedEnd = arrivedBegin + numMoved;
+      vtkSMPTools::Sort(arrivedBegin, arrivedEnd, TupleLess());
+
+      // The new offsets are the prefix sum of the new bucket counts
+      //
+      TIds *offsets = new TIds[this->NumBuckets+1];
+      CountBucketPoints<TIds> counter(this, &moved[0], arrivedBegin,
+                                      arrivedEnd, offsets);
+      vtkSMPTools::For(0,this->NumBuckets, counter);
+      vtkSMPTools::ExclusiveScan(offsets, offsets + this->NumBuckets,
+                                 offsets, static_cast<TIds>(0));
+      offsets[this->NumBuckets] = static_cast<TIds>(this->NumPts);
+
+      // Move the points into the new map
+      //
+      LocatorTuple<TIds> *map = new LocatorTuple<TIds>[this->NumPts+1];
+      map[this->NumPts].Bucket = static_cast<TIds>(this->NumBuckets);
+      FillBuckets<TIds> filler(this, &moved[0], arrivedBegin, arrivedEnd,
+                               offsets, map);
+      vtkSMPTools::For(0,this->NumBuckets, filler);
+
+      delete [] this->Map;
+      delete [] this->Offsets;
+      this->Map = map;
+      this->Offsets = offsets;
+      return true;
+  }
 };
 
 //-----------------------------------------------------------------------------
@@ -1339,6 +1641,9 @@ vtkStaticPointLocator::vtkStaticPointLocator()
   this->H[0] = this->H[1] = this->H[2] = 0.0;
   this->Buckets = nullptr;
   this->LargeIds = false;
+  this->IncrementalUpdate = 0;
+  this->MaximumFractionOfMovedPoints = 0.25;
+  this->NumberOfMovedPoints = -1;
 }
 
 //-----------------------------------------------------------------------------
@@ -1382,6 +1687,16 @@ void vtkStaticPointLocator::BuildLocator()
     return;
   }
 
+  // If only the points of the data set have changed, try to re-bin the
+  // points that moved instead of building from scratch.
+  if ( this->IncrementalUpdate && (this->Buckets != nullptr) &&
+       (this->BuildTime > this->MTime) && this->UpdateLocator() )
+  {
+    this->BuildTime.Modified();
+    return;
+  }
+  this->NumberOfMovedPoints = -1;
+
   vtkDebugMacro( << "Hashing points..." );
   this->Level = 1; //only single lowest level - from superclass
 
@@ -1485,6 +1800,41 @@ void vtkStaticPointLocator::BuildLocator()
   this->BuildTime.Modified();
 }
 
+//-----------------------------------------------------------------------------
+// Re-bin the points that changed bucket since the last build. The buckets
+// are kept, so this requires the same number of points, all of them within
+// the bounds of the buckets. Returns false if a full build is needed.
+bool vtkStaticPointLocator::UpdateLocator()
+{
+  if ( !this->DataSet ||
+       this->DataSet->GetNumberOfPoints() != this->Buckets->NumPts )
+  {
+    return false;
+  }
+
+  const double *bounds = this->DataSet->GetBounds();
+  for (int i=0; i<3; i++)
+  {
+    if ( bounds[2*i] < this->Bounds[2*i] ||
+         bounds[2*i+1] > this->Bounds[2*i+1] )
+    {
+      return false;
+    }
+  }
+
+  vtkIdType numMoved;
+  if ( ! this->Buckets->UpdateLocator(this->MaximumFractionOfMovedPoints,
+                                      numMoved) )
+  {
+    vtkDebugMacro( << numMoved << " points moved, rebuilding the locator" );
+    return false;
+  }
+
+  vtkDebugMacro( << "Re-binned " << numMoved << " points" );
+  this->NumberOfMovedPoints = numMoved;
+  return true;
+}
+
 
 //-----------------------------------------------------------------------------
 // These methods satisfy the vtkStaticPointLocator API. The implementation is
@@ -1669,4 +2019,13 @@ void vtkStaticPointLocator::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Divisions: (" << this->Divisions[0] << ", "
      << this->Divisions[1] << ", " << this->Divisions[2] << ")\n";
+
+  os << indent << "Incremental Update: "
+     << (this->IncrementalUpdate ? "On\n" : "Off\n");
+
+  os << indent << "Maximum Fraction Of Moved Points: "
+     << this->MaximumFractionOfMovedPoints << "\n";
+
+  os << indent << "Number Of Moved Points: "
+     << this->NumberOfMovedPoints << "\n";
 }
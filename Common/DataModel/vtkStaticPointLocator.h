@@ -28,6 +28,13 @@
  * (i.e., incremental point insertion is not supported). If you need to
  * incrementally insert points, use the vtkPointLocator or its kin to do so.
  *
+ * When the points of the data set move over time (particles, deforming
+ * meshes), IncrementalUpdate can be enabled: the locator is then rebuilt by
+ * re-binning only the points that changed bucket, as long as the number of
+ * points is unchanged, the points stay within the bounds of the buckets,
+ * and not too many of them moved (see MaximumFractionOfMovedPoints).
+ * Otherwise the locator is built from scratch.
+ *
  * @warning
  * This class is templated. It may run slower than serial execution if the code
  * is not optimized during compilation. Build in Release or ReleaseWithDebugInfo.
@@ -95,6 +102,38 @@ public:
   vtkGetVectorMacro(Divisions,int,3);
   //@}
 
+  //@{
+  /**
+   * Enable the incremental update of the locator when only the points of
+   * the data set have changed since the last build. The buckets of the last
+   * full build are kept, and only the points that changed bucket are
+   * re-binned. The locator is built from scratch if the number of points
+   * changed, if some point left the bounds of the buckets, or if more than
+   * MaximumFractionOfMovedPoints of the points changed bucket. The locator
+   * then stores the bucket of each point, which costs one id per point. By
+   * default this is off.
+   */
+  vtkSetMacro(IncrementalUpdate,int);
+  vtkGetMacro(IncrementalUpdate,int);
+  vtkBooleanMacro(IncrementalUpdate,int);
+  //@}
+
+  //@{
+  /**
+   * Specify the largest fraction of points that may change bucket for an
+   * incremental update; above it the locator is built from scratch. By
+   * default it is 0.25.
+   */
+  vtkSetClampMacro(MaximumFractionOfMovedPoints,double,0.0,1.0);
+  vtkGetMacro(MaximumFractionOfMovedPoints,double);
+  //@}
+
+  /**
+   * Return the number of points that were re-binned by the last build if it
+   * was an incremental update, or -1 if the locator was built from scratch.
+   */
+  vtkGetMacro(NumberOfMovedPoints,vtkIdType);
+
   // Re-use any superclass signatures that we don't override.
   using vtkAbstractPointLocator::FindClosestPoint;
   using vtkAbstractPointLocator::FindClosestNPoints;
@@ -185,6 +224,13 @@ protected:
   double H[3]; // Width of each bucket in x-y-z directions
   vtkBucketList *Buckets; // Lists of point ids in each bucket
   bool LargeIds; //indicate whether integer ids are small or large
+  int IncrementalUpdate; // Re-bin only the points that moved, if possible
+  double MaximumFractionOfMovedPoints; // Above it, build from scratch
+  vtkIdType NumberOfMovedPoints; // Points re-binned by the last update
+
+  // Re-bin the points that moved since the last build. Returns false if the
+  // locator must be built from scratch.
+  bool UpdateLocator();
 
 private:
   vtkStaticPointLocator(const vtkStaticPointLocator&) VTK_DELETE_FUNCTION;
@@ -88,6 +88,7 @@ public:
   void GetCellBounds(vtkIdType cellId, double bounds[6]) VTK_OVERRIDE;
   int GetCellType(vtkIdType cellId) VTK_OVERRIDE;
   vtkIdType GetNumberOfCells() VTK_OVERRIDE;
+  using vtkDataSet::GetCellPoints;
   void GetCellPoints(vtkIdType cellId, vtkIdList *ptIds) VTK_OVERRIDE;
   void GetPointCells(vtkIdType ptId, vtkIdList *cellIds) VTK_OVERRIDE
   {
@@ -61,11 +61,66 @@
 #include "vtkBiQuadraticQuadraticWedge.h"
 #include "vtkBiQuadraticQuadraticHexahedron.h"
 #include "vtkBiQuadraticTriangle.h"
+#include "vtkStaticCellLinks.h"
 
 #include <set>
 
 vtkStandardNewMacro(vtkUnstructuredGrid);
 
+namespace
+{
+// Bounds of the points of a cell, for either width of point ids.
+template <class TId>
+void ComputeCellBounds(vtkPoints *points, vtkIdType numPts, const TId *pts,
+                       double bounds[6])
+{
+  // carefully compute the bounds
+  double x[3];
+  if (numPts)
+  {
+    points->GetPoint( pts[0], x );
+    bounds[0] = x[0];
+    bounds[2] = x[1];
+    bounds[4] = x[2];
+    bounds[1] = x[0];
+    bounds[3] = x[1];
+    bounds[5] = x[2];
+    for (vtkIdType i=1; i < numPts; i++)
+    {
+      points->GetPoint( pts[i], x );
+      bounds[0] = (x[0] < bounds[0] ? x[0] : bounds[0]);
+      bounds[1] = (x[0] > bounds[1] ? x[0] : bounds[1]);
+      bounds[2] = (x[1] < bounds[2] ? x[1] : bounds[2]);
+      bounds[3] = (x[1] > bounds[3] ? x[1] : bounds[3]);
+      bounds[4] = (x[2] < bounds[4] ? x[2] : bounds[4]);
+      bounds[5] = (x[2] > bounds[5] ? x[2] : bounds[5]);
+    }
+  }
+  else
+  {
+    vtkMath::UninitializeBounds(bounds);
+  }
+}
+
+// The cells using a point, for either kind of links.
+inline void GetLinkedCells(vtkAbstractCellLinks *links, vtkIdType ptId,
+                           vtkIdType &ncells, const vtkIdType* &cells)
+{
+  if (links->GetType() == vtkAbstractCellLinks::STATIC_CELL_LINKS)
+  {
+    vtkStaticCellLinks *staticLinks = static_cast<vtkStaticCellLinks*>(links);
+    ncells = staticLinks->GetNumberOfCells(ptId);
+    cells = staticLinks->GetCells(ptId);
+  }
+  else
+  {
+    vtkCellLinks *cellLinks = static_cast<vtkCellLinks*>(links);
+    ncells = cellLinks->GetNcells(ptId);
+    cells = cellLinks->GetCells(ptId);
+  }
+}
+}
+
 vtkUnstructuredGrid::vtkUnstructuredGrid ()
 {
   this->Vertex = nullptr;
@@ -112,6 +167,7 @@ vtkUnstructuredGrid::vtkUnstructuredGrid ()
 
   this->Connectivity = nullptr;
   this->Links = nullptr;
+  this->Editable = false;
   this->Types = nullptr;
   this->Locations = nullptr;
 
@@ -481,17 +537,65 @@ int vtkUnstructuredGrid::GetCellType(vtkIdType cellId)
   return static_cast<int>(this->Types->GetValue(cellId));
 }
 
+//----------------------------------------------------------------------------
+void vtkUnstructuredGrid::GetCellConnectivity(vtkIdType cellId,
+                                              vtkIdType& npts, vtkIdType* &pts)
+{
+  if (this->Connectivity->GetStorage() != vtkCellArray::LEGACY_STORAGE)
+  {
+    this->Connectivity->GetCellAtId(cellId,npts,pts);
+  }
+  else
+  {
+    this->Connectivity->GetCell(
+      this->Locations->GetValue(cellId),npts,pts);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkUnstructuredGrid::BuildLocations()
+{
+  // Build the locations from the cell sizes without widening 32-bit
+  // storage.
+  vtkIdType numCells = this->Connectivity->GetNumberOfCells();
+  bool legacy =
+    this->Connectivity->GetStorage() == vtkCellArray::LEGACY_STORAGE;
+  this->Locations = vtkIdTypeArray::New();
+  this->Locations->SetNumberOfValues(numCells);
+  vtkIdType *locs = this->Locations->GetPointer(0);
+  vtkIdType npts, *pts;
+  vtkIdType loc = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+  {
+    locs[cellId] = loc;
+    if (legacy)
+    {
+      this->Connectivity->GetCell(loc, npts, pts);
+    }
+    else
+    {
+      npts = this->Connectivity->GetCellSize(cellId);
+    }
+    loc += npts + 1;
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkUnstructuredGrid::CompactCellStorage()
+{
+  if (!this->Connectivity)
+  {
+    return false;
+  }
+  this->Connectivity->SetStorageToOffsets32();
+  return this->Connectivity->GetStorage() == vtkCellArray::OFFSETS32_STORAGE;
+}
+
 //----------------------------------------------------------------------------
 vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
 {
   vtkIdType i;
-  vtkIdType loc;
   vtkCell *cell = nullptr;
-  vtkIdType *pts, numPts;
-
-  loc = this->Locations->GetValue(cellId);
-  vtkDebugMacro(<< "location = " <<  loc);
-  this->Connectivity->GetCell(loc,numPts,pts);
 
   int cellType = static_cast<int>(this->Types->GetValue(cellId));
   switch (cellType)
@@ -782,12 +886,12 @@ vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
   }
 
   // Copy the points over to the cell.
-  cell->PointIds->SetNumberOfIds(numPts);
+  this->GetCellPoints(cellId, cell->PointIds);
+  vtkIdType numPts = cell->PointIds->GetNumberOfIds();
   cell->Points->SetNumberOfPoints(numPts);
   for (i=0; i<numPts; i++)
   {
-    cell->PointIds->SetId(i,pts[i]);
-    cell->Points->SetPoint(i,this->Points->GetPoint(pts[i]));
+    cell->Points->SetPoint(i,this->Points->GetPoint(cell->PointIds->GetId(i)));
   }
 
   // Some cells require special initialization to build data structures
@@ -803,18 +907,10 @@ vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::GetCell(vtkIdType cellId, vtkGenericCell *cell)
 {
-  vtkIdType loc;
-  vtkIdType *pts, numPts;
-
   int cellType = static_cast<int>(this->Types->GetValue(cellId));
   cell->SetCellType(cellType);
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
-
-  cell->PointIds->SetNumberOfIds(numPts);
-
-  std::copy(pts, pts + numPts, cell->PointIds->GetPointer(0));
+  this->GetCellPoints(cellId, cell->PointIds);
   this->Points->GetPoints(cell->PointIds, cell->Points);
 
   // Explicit face representation
@@ -836,40 +932,18 @@ void vtkUnstructuredGrid::GetCell(vtkIdType cellId, vtkGenericCell *cell)
 // constructing a cell.
 void vtkUnstructuredGrid::GetCellBounds(vtkIdType cellId, double bounds[6])
 {
-  vtkIdType i;
-  vtkIdType loc;
-  double x[3];
-  vtkIdType *pts, numPts;
-
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
-
-  // carefully compute the bounds
-  if (numPts)
+  vtkIdType numPts;
+  if (this->Connectivity->GetStorage() == vtkCellArray::OFFSETS32_STORAGE)
   {
-    this->Points->GetPoint( pts[0], x );
-    bounds[0] = x[0];
-    bounds[2] = x[1];
-    bounds[4] = x[2];
-    bounds[1] = x[0];
-    bounds[3] = x[1];
-    bounds[5] = x[2];
-    for (i=1; i < numPts; i++)
-    {
-      this->Points->GetPoint( pts[i], x );
-      bounds[0] = (x[0] < bounds[0] ? x[0] : bounds[0]);
-      bounds[1] = (x[0] > bounds[1] ? x[0] : bounds[1]);
-      bounds[2] = (x[1] < bounds[2] ? x[1] : bounds[2]);
-      bounds[3] = (x[1] > bounds[3] ? x[1] : bounds[3]);
-      bounds[4] = (x[2] < bounds[4] ? x[2] : bounds[4]);
-      bounds[5] = (x[2] > bounds[5] ? x[2] : bounds[5]);
-    }
+    const vtkTypeInt32 *pts = this->Connectivity->GetCellAtId32(cellId, numPts);
+    ComputeCellBounds(this->Points, numPts, pts, bounds);
   }
   else
   {
-    vtkMath::UninitializeBounds(bounds);
+    vtkIdType *pts;
+    this->GetCellConnectivity(cellId,numPts,pts);
+    ComputeCellBounds(this->Points, numPts, pts, bounds);
   }
-
 }
 
 //----------------------------------------------------------------------------
@@ -913,7 +987,11 @@ vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdList *ptIds)
   // insert type and storage information
   vtkDebugMacro(<< "insert location "
                 << this->Connectivity->GetInsertLocation(npts));
-  this->Locations->InsertNextValue(this->Connectivity->GetInsertLocation(npts));
+  if ( this->Locations )
+  {
+    this->Locations->InsertNextValue(
+      this->Connectivity->GetInsertLocation(npts));
+  }
 
   // If faces have been created, we need to pad them (we are not creating
   // a polyhedral cell in this method)
@@ -940,8 +1018,11 @@ vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdType npts,
     // insert type and storage information
     vtkDebugMacro(<< "insert location "
                   << this->Connectivity->GetInsertLocation(npts));
-    this->Locations->InsertNextValue(
-      this->Connectivity->GetInsertLocation(npts));
+    if ( this->Locations )
+    {
+      this->Locations->InsertNextValue(
+        this->Connectivity->GetInsertLocation(npts));
+    }
 
     // If faces have been created, we need to pad them (we are not creating
     // a polyhedral cell in this method)
@@ -972,7 +1053,11 @@ vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdType npts,
     }
 
     // insert cell location
-    this->Locations->InsertNextValue(this->Connectivity->GetData()->GetMaxId()+1);
+    if ( this->Locations )
+    {
+      this->Locations->InsertNextValue(
+        this->Connectivity->GetNumberOfConnectivityEntries());
+    }
     // insert face location
     this->FaceLocations->InsertNextValue(this->Faces->GetMaxId()+1);
     // insert cell connectivity and faces stream
@@ -995,8 +1080,11 @@ InsertNextCell(int type, vtkIdType npts, vtkIdType *pts,
   this->Connectivity->InsertNextCell(npts,pts);
 
   // Insert location of cell in connectivity array
-  this->Locations->InsertNextValue(
-    this->Connectivity->GetInsertLocation(npts));
+  if ( this->Locations )
+  {
+    this->Locations->InsertNextValue(
+      this->Connectivity->GetInsertLocation(npts));
+  }
 
   // Now insert faces; allocate storage if necessary.
   // We defer allocation for the faces because they are not commonly used and
@@ -1113,11 +1201,25 @@ void vtkUnstructuredGrid::SetCells(int *types, vtkCellArray *cells)
 
   vtkIdType npts, nfaces, realnpts, *pts;
 
-  vtkIdTypeArray *cellLocations = vtkIdTypeArray::New();
-  cellLocations->Allocate(ncells);
   vtkUnsignedCharArray *cellTypes = vtkUnsignedCharArray::New();
   cellTypes->Allocate(ncells);
 
+  // With offsets storage the locations are computed from the offsets.
+  if (!containPolyhedron &&
+      cells->GetStorage() != vtkCellArray::LEGACY_STORAGE)
+  {
+    for (i = 0; i < ncells; i++)
+    {
+      cellTypes->InsertNextValue(static_cast<unsigned char>(types[i]));
+    }
+    this->SetCells(cellTypes, nullptr, cells, nullptr, nullptr);
+    cellTypes->Delete();
+    return;
+  }
+
+  vtkIdTypeArray *cellLocations = vtkIdTypeArray::New();
+  cellLocations->Allocate(ncells);
+
   if (!containPolyhedron)
   {
     // only need to build types and locations
@@ -1271,6 +1373,12 @@ void vtkUnstructuredGrid::SetCells(vtkUnsignedCharArray *cellTypes,
   {
     this->Locations->Register(this);
   }
+  else if ( this->Connectivity )
+  {
+    // Built now rather than on first access, which may be from several
+    // threads.
+    this->BuildLocations();
+  }
 
   if ( this->Faces )
   {
@@ -1302,21 +1410,52 @@ void vtkUnstructuredGrid::BuildLinks()
     this->Links->UnRegister(this);
   }
 
-  this->Links = vtkCellLinks::New();
-  this->Links->Allocate(this->GetNumberOfPoints());
-  this->Links->Register(this);
-  this->Links->BuildLinks(this, this->Connectivity);
-  this->Links->Delete();
+  if (!this->Editable)
+  {
+    this->Links = vtkStaticCellLinks::New();
+    this->Links->BuildLinks(this);
+    return;
+  }
+
+  vtkCellLinks *links = vtkCellLinks::New();
+  links->Allocate(this->GetNumberOfPoints());
+  this->Links = links;
+  links->BuildLinks(this, this->Connectivity);
+}
+
+//----------------------------------------------------------------------------
+vtkCellLinks *vtkUnstructuredGrid::GetCellLinks()
+{
+  return this->Links ? this->GetEditableLinks() : nullptr;
+}
+
+//----------------------------------------------------------------------------
+vtkCellLinks *vtkUnstructuredGrid::GetEditableLinks()
+{
+  if (!this->Links ||
+      this->Links->GetType() != vtkAbstractCellLinks::CELL_LINKS)
+  {
+    bool editable = this->Editable;
+    this->Editable = true;
+    this->BuildLinks();
+    this->Editable = editable;
+  }
+  return static_cast<vtkCellLinks*>(this->Links);
 }
 
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
 {
-  vtkIdType i, loc;
+  if (this->Connectivity->GetStorage() != vtkCellArray::LEGACY_STORAGE)
+  {
+    this->Connectivity->GetCellAtId(cellId, ptIds);
+    return;
+  }
+
+  vtkIdType i;
   vtkIdType *pts, numPts;
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  this->GetCellConnectivity(cellId,numPts,pts);
   ptIds->SetNumberOfIds(numPts);
   for (i=0; i<numPts; i++)
   {
@@ -1325,17 +1464,41 @@ void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
 
 }
 
+//----------------------------------------------------------------------------
+void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdType& npts,
+                                        vtkIdType const*& pts,
+                                        vtkIdList *ptIds) const
+{
+  // Only read the connectivity: 32-bit storage is copied rather than
+  // converted.
+  int storage = this->Connectivity->GetStorage();
+  vtkIdType *cellPts;
+  if (storage == vtkCellArray::OFFSETS_STORAGE)
+  {
+    this->Connectivity->GetCellAtId(cellId, npts, cellPts);
+    pts = cellPts;
+  }
+  else if (storage == vtkCellArray::LEGACY_STORAGE)
+  {
+    this->Connectivity->GetCell(this->Locations->GetValue(cellId), npts,
+                                cellPts);
+    pts = cellPts;
+  }
+  else
+  {
+    this->Connectivity->GetCellAtId(cellId, ptIds);
+    npts = ptIds->GetNumberOfIds();
+    pts = ptIds->GetPointer(0);
+  }
+}
+
 //----------------------------------------------------------------------------
 // Return a pointer to a list of point ids defining cell. (More efficient than alternative
 // method.)
 void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdType& npts,
                                         vtkIdType* &pts)
 {
-  vtkIdType loc;
-
-  loc = this->Locations->GetValue(cellId);
-
-  this->Connectivity->GetCell(loc,npts,pts);
+  this->GetCellConnectivity(cellId,npts,pts);
 }
 
 //----------------------------------------------------------------------------
@@ -1395,9 +1558,9 @@ void vtkUnstructuredGrid::GetFaceStream(vtkIdType cellId, vtkIdType& nfaces,
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::GetPointCells(vtkIdType ptId, vtkIdList *cellIds)
 {
-  vtkIdType *cells;
-  int numCells;
-  int i;
+  const vtkIdType *cells;
+  vtkIdType numCells;
+  vtkIdType i;
 
   if ( ! this->Links )
   {
@@ -1405,8 +1568,7 @@ void vtkUnstructuredGrid::GetPointCells(vtkIdType ptId, vtkIdList *cellIds)
   }
   cellIds->Reset();
 
-  numCells = this->Links->GetNcells(ptId);
-  cells = this->Links->GetCells(ptId);
+  GetLinkedCells(this->Links, ptId, numCells, cells);
 
   cellIds->SetNumberOfIds(numCells);
   for (i=0; i < numCells; i++)
@@ -1491,7 +1653,7 @@ void vtkUnstructuredGrid::Squeeze()
 void vtkUnstructuredGrid::RemoveReferenceToCell(vtkIdType ptId,
                                                 vtkIdType cellId)
 {
-  this->Links->RemoveCellReference(cellId, ptId);
+  this->GetEditableLinks()->RemoveCellReference(cellId, ptId);
 }
 
 //----------------------------------------------------------------------------
@@ -1501,7 +1663,7 @@ void vtkUnstructuredGrid::RemoveReferenceToCell(vtkIdType ptId,
 // operator ResizeCellList() to do this if necessary.
 void vtkUnstructuredGrid::AddReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 {
-  this->Links->AddCellReference(cellId, ptId);
+  this->GetEditableLinks()->AddCellReference(cellId, ptId);
 }
 
 //----------------------------------------------------------------------------
@@ -1509,7 +1671,7 @@ void vtkUnstructuredGrid::AddReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 // that BuildLinks() has been called.)
 void vtkUnstructuredGrid::ResizeCellList(vtkIdType ptId, int size)
 {
-  this->Links->ResizeCellList(ptId,size);
+  this->GetEditableLinks()->ResizeCellList(ptId,size);
 }
 
 //----------------------------------------------------------------------------
@@ -1520,9 +1682,15 @@ void vtkUnstructuredGrid::ResizeCellList(vtkIdType ptId, int size)
 void vtkUnstructuredGrid::ReplaceCell(vtkIdType cellId, int npts,
                                       vtkIdType *pts)
 {
+  if (this->Connectivity->GetStorage() != vtkCellArray::LEGACY_STORAGE)
+  {
+    this->Connectivity->ReplaceCellAtId(cellId,npts,pts);
+    return;
+  }
+
   vtkIdType loc;
 
-  loc = this->Locations->GetValue(cellId);
+  loc = this->GetCellLocationsArray()->GetValue(cellId);
   this->Connectivity->ReplaceCell(loc,npts,pts);
 }
 
@@ -1534,13 +1702,14 @@ vtkIdType vtkUnstructuredGrid::InsertNextLinkedCell(int type, int npts,
                                                     vtkIdType *pts)
 {
   vtkIdType i, id;
+  vtkCellLinks *links = this->GetEditableLinks();
 
   id = this->InsertNextCell(type,npts,pts);
 
   for (i=0; i<npts; i++)
   {
-    this->Links->ResizeCellList(pts[i],1);
-    this->Links->AddCellReference(id,pts[i]);
+    links->ResizeCellList(pts[i],1);
+    links->AddCellReference(id,pts[i]);
   }
 
   return id;
@@ -1609,6 +1778,7 @@ void vtkUnstructuredGrid::ShallowCopy(vtkDataObject *dataObject)
     {
       this->Links->Register(this);
     }
+    this->Editable = grid->Editable;
 
     if (this->Types)
     {
@@ -1761,6 +1931,7 @@ void vtkUnstructuredGrid::DeepCopy(vtkDataObject *dataObject)
   // Finally Build Links if we need to
   if (grid && grid->Links)
   {
+    this->Editable = grid->Editable;
     this->BuildLinks();
   }
 }
@@ -1774,6 +1945,7 @@ void vtkUnstructuredGrid::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Number Of Pieces: " << this->GetNumberOfPieces() << endl;
   os << indent << "Piece: " << this->GetPiece() << endl;
   os << indent << "Ghost Level: " << this->GetGhostLevel() << endl;
+  os << indent << "Editable: " << (this->Editable ? "true" : "false") << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -1800,14 +1972,15 @@ void vtkUnstructuredGrid::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
 
   //Find the point used by the fewest number of cells
   vtkIdType *pts = ptIds->GetPointer(0);
-  int minNumCells = VTK_INT_MAX;
-  vtkIdType *minCells = nullptr;
+  vtkIdType minNumCells = VTK_ID_MAX;
+  const vtkIdType *minCells = nullptr;
   vtkIdType minPtId = 0;
   for (vtkIdType i=0; i<numPts; i++)
   {
     vtkIdType ptId = pts[i];
-    int numCells = this->Links->GetNcells(ptId);
-    vtkIdType *cells = this->Links->GetCells(ptId);
+    vtkIdType numCells;
+    const vtkIdType *cells;
+    GetLinkedCells(this->Links, ptId, numCells, cells);
     if ( numCells < minNumCells )
     {
       minNumCells = numCells;
@@ -1819,7 +1992,7 @@ void vtkUnstructuredGrid::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
   //Now for each cell, see if it contains all the points
   //in the ptIds list.
   bool match;
-  for (int i=0; i<minNumCells; i++)
+  for (vtkIdType i=0; i<minNumCells; i++)
   {
     if ( minCells[i] != cellId ) //don't include current cell
     {
@@ -30,6 +30,7 @@
 #include "vtkCommonDataModelModule.h" // For export macro
 #include "vtkUnstructuredGridBase.h"
 
+class vtkAbstractCellLinks;
 class vtkCellArray;
 class vtkCellLinks;
 class vtkConvexPointSet;
@@ -139,18 +140,59 @@ public:
   void GetCell(vtkIdType cellId, vtkGenericCell *cell) VTK_OVERRIDE;
   void GetCellBounds(vtkIdType cellId, double bounds[6]) VTK_OVERRIDE;
   void GetCellPoints(vtkIdType cellId, vtkIdList *ptIds) VTK_OVERRIDE;
+  void GetCellPoints(vtkIdType cellId, vtkIdType& npts,
+                     vtkIdType const*& pts,
+                     vtkIdList *ptIds) const VTK_OVERRIDE;
   void GetPointCells(vtkIdType ptId, vtkIdList *cellIds) VTK_OVERRIDE;
   vtkCellIterator* NewCellIterator() VTK_OVERRIDE;
   //@}
 
   int GetCellType(vtkIdType cellId) VTK_OVERRIDE;
   vtkUnsignedCharArray* GetCellTypesArray() { return this->Types; }
+
+  /**
+   * Get the legacy location of each cell in the connectivity array, see
+   * vtkCellArray. It is kept whatever the storage of the cells.
+   */
   vtkIdTypeArray* GetCellLocationsArray() { return this->Locations; }
+
   void Squeeze() VTK_OVERRIDE;
   void Initialize() VTK_OVERRIDE;
   int GetMaxCellSize() VTK_OVERRIDE;
+
+  /**
+   * Create upward links from points to cells that use each point. Unless
+   * Editable is on, the links are static (vtkStaticCellLinks) and built in
+   * parallel, otherwise they are editable vtkCellLinks.
+   */
   void BuildLinks();
-  vtkCellLinks *GetCellLinks() {return this->Links;};
+
+  /**
+   * Return the links built by BuildLinks(), either a vtkStaticCellLinks or
+   * a vtkCellLinks (see vtkAbstractCellLinks::GetType()).
+   */
+  vtkAbstractCellLinks *GetLinks() {return this->Links;};
+
+  /**
+   * Return the links built by BuildLinks() as editable vtkCellLinks, or
+   * nullptr if they were not built. Static links are first rebuilt as
+   * editable links; use GetLinks() to read the links as built.
+   */
+  vtkCellLinks *GetCellLinks();
+
+  //@{
+  /**
+   * Specify whether BuildLinks() builds links that can be edited with
+   * RemoveReferenceToCell(), AddReferenceToCell(), ResizeCellList() and
+   * InsertNextLinkedCell(). Off by default. Set it before BuildLinks() when
+   * the links are going to be edited; editing static links first rebuilds
+   * them as editable links from the current cells.
+   */
+  vtkSetMacro(Editable, bool);
+  vtkGetMacro(Editable, bool);
+  vtkBooleanMacro(Editable, bool);
+  //@}
+
   virtual void GetCellPoints(vtkIdType cellId, vtkIdType& npts,
                              vtkIdType* &pts);
 
@@ -184,7 +226,8 @@ public:
    * vtkPolyhedron, SetCells() support a special input cellConnectivities format
    * (numCellFaces, numFace0Pts, id1, id2, id3, numFace1Pts,id1, id2, id3, ...)
    * The functions use vtkPolyhedron::DecomposeAPolyhedronCell() to convert
-   * polyhedron cells into standard format.
+   * polyhedron cells into standard format. cellLocations may be nullptr, it
+   * is then built from the cells.
    */
   void SetCells(int type, vtkCellArray *cells);
   void SetCells(int *types, vtkCellArray *cells);
@@ -195,6 +238,15 @@ public:
                 vtkIdTypeArray *faces);
   //@}
 
+  /**
+   * Convert the cells to 32-bit offsets storage when all the point ids and
+   * the connectivity size fit in 32 bits, and to 64-bit offsets storage
+   * otherwise. The cell locations array stays valid. This roughly
+   * halves the memory used by the cells of large grids when vtkIdType is
+   * 64-bit. Returns true if 32-bit storage is used.
+   */
+  bool CompactCellStorage();
+
   vtkCellArray *GetCells() {return this->Connectivity;};
   void ReplaceCell(vtkIdType cellId, int npts, vtkIdType *pts) VTK_OVERRIDE;
   vtkIdType InsertNextLinkedCell(int type, int npts, vtkIdType *pts);
@@ -404,7 +456,12 @@ protected:
   // points inherited
   // point data (i.e., scalars, vectors, normals, tcoords) inherited
   vtkCellArray *Connectivity;
-  vtkCellLinks *Links;
+  vtkAbstractCellLinks *Links;
+  bool Editable;
+
+  // The links as vtkCellLinks, rebuilt as editable links if they are static.
+  vtkCellLinks *GetEditableLinks();
+  void BuildLocations();
   vtkUnsignedCharArray *Types;
   vtkIdTypeArray *Locations;
 
@@ -422,6 +479,11 @@ private:
   void operator=(const vtkUnstructuredGrid&) VTK_DELETE_FUNCTION;
 
   void Cleanup();
+
+  // Fetch the point ids of a cell. With offsets storage the connectivity is
+  // indexed by cell id directly and the locations are not needed. 32-bit
+  // storage is widened, copy the cell to a vtkIdList to avoid it.
+  void GetCellConnectivity(vtkIdType cellId, vtkIdType& npts, vtkIdType* &pts);
 };
 
 #endif
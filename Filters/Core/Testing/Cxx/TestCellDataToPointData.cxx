@@ -21,6 +21,7 @@
 #include <vtkPointData.h>
 #include <vtkPointDataToCellData.h>
 #include <vtkRTAnalyticSource.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkUnstructuredGrid.h>
 #include <vtkThreshold.h>
@@ -31,6 +32,9 @@
 
 int TestCellDataToPointData (int, char*[])
 {
+  // Use several threads, the mapped values must not depend on them.
+  vtkSMPTools::Initialize(4);
+
   char const name [] = "RTData";
   vsp(RTAnalyticSource, wavelet);
     wavelet->SetWholeExtent(-2, 2, -2, 2, -2, 2);
@@ -96,5 +100,31 @@ int TestCellDataToPointData (int, char*[])
       return EXIT_FAILURE;
     }
   }
+
+  // Only the selected arrays are mapped.
+  vtkSmartPointer<vtkDataArray> reference = x;
+  p2c->ProcessAllArraysOff();
+  p2c->AddPointDataArray("NotAnArray");
+  sc2p->Update();
+  if (sc2p->GetOutput()->GetPointData()->GetArray(name))
+  {
+    cerr << "Unselected point array mapped to cell data" << endl;
+    return EXIT_FAILURE;
+  }
+  p2c->AddPointDataArray(name);
+  sc2p->ProcessAllArraysOff();
+  sc2p->AddCellDataArray(name);
+  sc2p->Update();
+  vtkDataArray* const z = sc2p->GetOutput()->GetPointData()->GetArray(name);
+  bool same = z && z->GetNumberOfTuples() == reference->GetNumberOfTuples();
+  for (vtkIdType i = 0; same && i < reference->GetNumberOfTuples(); ++i)
+  {
+    same = reference->GetTuple1(i) == z->GetTuple1(i);
+  }
+  if (!same)
+  {
+    cerr << "Failure with the selected arrays" << endl;
+    return EXIT_FAILURE;
+  }
   return EXIT_SUCCESS;
 }
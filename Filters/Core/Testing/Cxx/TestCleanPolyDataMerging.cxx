@@ -0,0 +1,277 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCleanPolyDataMerging.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkCleanPolyData merges the duplicate points of two copies of
+// a sphere into points of the input, and that the parallel merge gives the
+// same output whatever the number of threads, and the same output as a
+// locator. Also checks that near duplicate points are merged with a
+// tolerance, with or without a locator.
+
+#include "vtkAppendPolyData.h"
+#include "vtkCellArray.h"
+#include "vtkCleanPolyData.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMergePoints.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestDataSetComparison.h"
+
+#include <cstdlib>
+
+namespace
+{
+
+// Clean the input with the given number of threads. With useLocator, a
+// vtkMergePoints locator merges the points one at a time.
+vtkSmartPointer<vtkPolyData> Clean(vtkPolyData *input, double tolerance,
+                                   bool useLocator, int numberOfThreads)
+{
+  vtkSMPTools::LocalScope scope((vtkSMPTools::Config(numberOfThreads)));
+  vtkNew<vtkCleanPolyData> clean;
+  clean->SetInputData(input);
+  clean->SetTolerance(tolerance);
+  if (useLocator)
+  {
+    vtkNew<vtkMergePoints> locator;
+    clean->SetLocator(locator.GetPointer());
+  }
+  clean->Update();
+  return clean->GetOutput();
+}
+
+// A grid of points, each with a copy moved by less than the tolerance. The
+// copies are merged in parallel, whether or not GetLocator() was called,
+// and by a vtkMergePoints locator used without tolerance before, which is
+// then replaced by a vtkPointLocator.
+int TestNearDuplicates()
+{
+  vtkNew<vtkPolyData> input;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> verts;
+  for (int j = 0; j < 10; ++j)
+  {
+    for (int i = 0; i < 10; ++i)
+    {
+      vtkIdType ptIds[2];
+      ptIds[0] = points->InsertNextPoint(i, j, 0.0);
+      ptIds[1] = points->InsertNextPoint(i + 1.0e-4, j, 1.0e-4);
+      verts->InsertNextCell(2, ptIds);
+    }
+  }
+  input->SetPoints(points.GetPointer());
+  input->SetVerts(verts.GetPointer());
+
+  int errors = 0;
+  const char *names[3] = { "parallel", "GetLocator()", "vtkMergePoints" };
+  for (int mode = 0; mode < 3; ++mode)
+  {
+    vtkNew<vtkCleanPolyData> clean;
+    clean->SetInputData(input.GetPointer());
+    clean->SetTolerance(0.001);
+    if (mode == 1 && clean->GetLocator())
+    {
+      cerr << "GetLocator() created a locator\n";
+      ++errors;
+    }
+    vtkNew<vtkMergePoints> locator;
+    if (mode == 2)
+    {
+      // merge the exact duplicates first, then change the tolerance
+      clean->SetLocator(locator.GetPointer());
+      clean->SetTolerance(0.0);
+      clean->Update();
+      if (clean->GetOutput()->GetNumberOfPoints() != 200)
+      {
+        cerr << "Expected 200 points without tolerance, got "
+             << clean->GetOutput()->GetNumberOfPoints() << "\n";
+        ++errors;
+      }
+      clean->SetTolerance(0.001);
+    }
+    clean->Update();
+    if (clean->GetOutput()->GetNumberOfPoints() != 100)
+    {
+      cerr << names[mode] << ": expected 100 points, got "
+           << clean->GetOutput()->GetNumberOfPoints() << "\n";
+      ++errors;
+    }
+    if (mode == 2 && (!clean->GetLocator() ||
+                      clean->GetLocator()->IsA("vtkMergePoints")))
+    {
+      cerr << "The vtkMergePoints locator was not replaced\n";
+      ++errors;
+    }
+  }
+  return errors;
+}
+
+// Check that each output point has the coordinates of the input point given
+// by the PointIds array, and that the output polygons, when none were
+// removed, use the points of the input polygons.
+int CheckPoints(vtkPolyData *output, vtkPolyData *input)
+{
+  vtkIdTypeArray *pointIds = vtkArrayDownCast<vtkIdTypeArray>(
+    output->GetPointData()->GetArray("PointIds"));
+  if (!pointIds || pointIds->GetNumberOfTuples() != output->GetNumberOfPoints())
+  {
+    cerr << "Missing PointIds array\n";
+    return 1;
+  }
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3], y[3];
+    output->GetPoint(ptId, x);
+    input->GetPoint(pointIds->GetValue(ptId), y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      cerr << "Output point " << ptId << " is not at input point "
+           << pointIds->GetValue(ptId) << "\n";
+      return 1;
+    }
+  }
+
+  vtkCellArray *inPolys = input->GetPolys();
+  vtkCellArray *outPolys = output->GetPolys();
+  if (inPolys->GetNumberOfCells() != outPolys->GetNumberOfCells())
+  {
+    return 0;
+  }
+  vtkIdType nptsIn, nptsOut, *ptsIn, *ptsOut;
+  inPolys->InitTraversal();
+  outPolys->InitTraversal();
+  for (vtkIdType cellId = 0; inPolys->GetNextCell(nptsIn, ptsIn) &&
+       outPolys->GetNextCell(nptsOut, ptsOut); ++cellId)
+  {
+    bool same = (nptsIn == nptsOut);
+    for (vtkIdType i = 0; same && i < nptsIn; ++i)
+    {
+      double x[3], y[3];
+      output->GetPoint(ptsOut[i], x);
+      input->GetPoint(ptsIn[i], y);
+      same = (x[0] == y[0] && x[1] == y[1] && x[2] == y[2]);
+    }
+    if (!same)
+    {
+      cerr << "Polygon " << cellId << " does not use the input points\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+
+} // end anon namespace
+
+int TestCleanPolyDataMerging(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+
+  // Two copies of a sphere, the second one with its points reversed, and a
+  // few degenerate cells using them.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  sphere->Update();
+  vtkPolyData *sphereOutput = sphere->GetOutput();
+  vtkIdType numSpherePts = sphereOutput->GetNumberOfPoints();
+
+  vtkNew<vtkPolyData> reversed;
+  vtkNew<vtkPoints> reversedPoints;
+  vtkNew<vtkCellArray> reversedPolys;
+  reversedPoints->SetNumberOfPoints(numSpherePts);
+  for (vtkIdType ptId = 0; ptId < numSpherePts; ++ptId)
+  {
+    reversedPoints->SetPoint(numSpherePts - 1 - ptId,
+                             sphereOutput->GetPoint(ptId));
+  }
+  vtkIdType npts, *pts;
+  vtkCellArray *polys = sphereOutput->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    reversedPolys->InsertNextCell(static_cast<int>(npts));
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      reversedPolys->InsertCellPoint(numSpherePts - 1 - pts[i]);
+    }
+  }
+  vtkNew<vtkCellArray> lines;
+  for (vtkIdType ptId = 0; ptId < numSpherePts; ptId += 7)
+  {
+    vtkIdType line[2] = { ptId, ptId };
+    lines->InsertNextCell(2, line);
+  }
+  reversed->SetPoints(reversedPoints.GetPointer());
+  reversed->SetPolys(reversedPolys.GetPointer());
+  reversed->SetLines(lines.GetPointer());
+
+  vtkNew<vtkAppendPolyData> append;
+  append->AddInputData(sphereOutput);
+  append->AddInputData(reversed.GetPointer());
+  append->Update();
+  vtkPolyData *input = append->GetOutput();
+  vtkNew<vtkIdTypeArray> pointIds;
+  pointIds->SetName("PointIds");
+  pointIds->SetNumberOfTuples(input->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    pointIds->SetValue(ptId, ptId);
+  }
+  input->GetPointData()->AddArray(pointIds.GetPointer());
+
+  int errors = 0;
+  vtkSmartPointer<vtkPolyData> serial = Clean(input, 0.0, false, 1);
+  if (serial->GetNumberOfPoints() != numSpherePts ||
+      serial->GetNumberOfPolys() != 2 * sphereOutput->GetNumberOfPolys() ||
+      serial->GetNumberOfVerts() != lines->GetNumberOfCells() ||
+      serial->GetNumberOfLines() != 0)
+  {
+    cerr << "Expected " << numSpherePts << " points, got "
+         << serial->GetNumberOfPoints() << "\n";
+    ++errors;
+  }
+  errors += CheckPoints(serial, input);
+  if (!vtkTest::SameDataSets(serial, Clean(input, 0.0, false, 4)))
+  {
+    cerr << "Threaded merge differs\n";
+    ++errors;
+  }
+  if (!vtkTest::SameDataSets(serial, Clean(input, 0.0, true, 4)))
+  {
+    cerr << "Merge differs from the locator\n";
+    ++errors;
+  }
+
+  // With a tolerance, the neighboring points of the sphere are merged too.
+  serial = Clean(input, 0.01, false, 1);
+  if (serial->GetNumberOfPoints() >= numSpherePts)
+  {
+    cerr << "Expected less than " << numSpherePts << " points, got "
+         << serial->GetNumberOfPoints() << "\n";
+    ++errors;
+  }
+  errors += CheckPoints(serial, input);
+  if (!vtkTest::SameDataSets(serial, Clean(input, 0.01, false, 4)))
+  {
+    cerr << "Threaded merge with tolerance differs\n";
+    ++errors;
+  }
+
+  errors += TestNearDuplicates();
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,202 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConnectedRegions.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkPolyDataConnectivityFilter and vtkConnectivityFilter find
+// the expected regions, numbered by lowest cell id, and give the same
+// output whatever the number of threads in every extraction mode, with and
+// without scalar connectivity.
+
+#include "vtkAppendPolyData.h"
+#include "vtkCellArray.h"
+#include "vtkConnectivityFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataConnectivityFilter.h"
+#include "vtkSMPTools.h"
+#include "vtkSphereSource.h"
+#include "vtkTestDataSetComparison.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstdlib>
+
+namespace
+{
+
+// Compare a sequential and a threaded run of the filter.
+template <class TFilter>
+bool SameOutputs(TFilter *connectivity)
+{
+  int serialRegions;
+  {
+    vtkSMPTools::LocalScope scope(vtkSMPTools::Config(1));
+    connectivity->Modified();
+    connectivity->Update();
+    serialRegions = connectivity->GetNumberOfExtractedRegions();
+  }
+  return vtkTest::SameThreadedOutputs(connectivity, 4) &&
+    serialRegions == connectivity->GetNumberOfExtractedRegions();
+}
+
+// The expected sizes are the numbers of cells and points of each mode
+// without scalar connectivity, in the order of the extraction modes.
+template <class TFilter>
+int TestModes(TFilter *connectivity, const char *name,
+              const vtkIdType expectedCells[6],
+              const vtkIdType expectedPoints[6])
+{
+  int errors = 0;
+  connectivity->ColorRegionsOn();
+  connectivity->InitializeSeedList();
+  connectivity->AddSeed(0);
+  connectivity->AddSeed(1500);
+  connectivity->InitializeSpecifiedRegionList();
+  connectivity->AddSpecifiedRegion(1);
+  connectivity->AddSpecifiedRegion(3);
+  connectivity->SetClosestPoint(0.0, 0.0, 5.0);
+  for (int scalarConnectivity = 0; scalarConnectivity < 2;
+       ++scalarConnectivity)
+  {
+    connectivity->SetScalarConnectivity(scalarConnectivity);
+    for (int mode = VTK_EXTRACT_POINT_SEEDED_REGIONS;
+         mode <= VTK_EXTRACT_CLOSEST_POINT_REGION; ++mode)
+    {
+      connectivity->SetExtractionMode(mode);
+      if (!SameOutputs(connectivity))
+      {
+        cerr << "Threaded " << name << " differs in mode "
+             << connectivity->GetExtractionModeAsString()
+             << " with scalar connectivity " << scalarConnectivity << "\n";
+        ++errors;
+      }
+
+      vtkDataSet *output = connectivity->GetOutput();
+      int i = mode - VTK_EXTRACT_POINT_SEEDED_REGIONS;
+      if (!scalarConnectivity &&
+          (output->GetNumberOfCells() != expectedCells[i] ||
+           output->GetNumberOfPoints() != expectedPoints[i]))
+      {
+        cerr << name << " extracts " << output->GetNumberOfCells()
+             << " cells and " << output->GetNumberOfPoints()
+             << " points in mode "
+             << connectivity->GetExtractionModeAsString() << " instead of "
+             << expectedCells[i] << " and " << expectedPoints[i] << "\n";
+        ++errors;
+      }
+    }
+  }
+  return errors;
+}
+
+} // end anon namespace
+
+int TestConnectedRegions(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+
+  // Three spheres listed from the last to the first in space, each made of
+  // one region, and a vertex on its own. The vertex is the first cell of the
+  // appended polydata, so it is region 0, but its point is the last one.
+  vtkNew<vtkAppendPolyData> append;
+  vtkIdType sphereCells[3], spherePoints[3];
+  for (int i = 2; i >= 0; --i)
+  {
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetThetaResolution(20 + 10 * i);
+    sphere->SetPhiResolution(20 + 10 * i);
+    sphere->SetCenter(0.0, 0.0, 2.0 * i);
+    sphere->Update();
+    sphereCells[i] = sphere->GetOutput()->GetNumberOfCells();
+    spherePoints[i] = sphere->GetOutput()->GetNumberOfPoints();
+    append->AddInputData(sphere->GetOutput());
+  }
+  vtkNew<vtkPolyData> vertex;
+  vtkNew<vtkPoints> vertexPoint;
+  vtkNew<vtkCellArray> verts;
+  vtkIdType vertexId = vertexPoint->InsertNextPoint(10.0, 0.0, 0.0);
+  verts->InsertNextCell(1, &vertexId);
+  vertex->SetPoints(vertexPoint.GetPointer());
+  vertex->SetVerts(verts.GetPointer());
+  append->AddInputData(vertex.GetPointer());
+  append->Update();
+
+  vtkPolyData *input = append->GetOutput();
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetNumberOfTuples(input->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    scalars->SetValue(ptId, static_cast<float>((ptId * 37) % 101) / 100.0f);
+  }
+  input->GetPointData()->SetScalars(scalars.GetPointer());
+
+  int errors = 0;
+  vtkNew<vtkPolyDataConnectivityFilter> polyConnectivity;
+  polyConnectivity->SetInputData(input);
+  polyConnectivity->SetExtractionModeToAllRegions();
+  polyConnectivity->Update();
+  vtkIdTypeArray *sizes = polyConnectivity->GetRegionSizes();
+  if (polyConnectivity->GetNumberOfExtractedRegions() != 4 ||
+      sizes->GetValue(0) != 1 || sizes->GetValue(1) != sphereCells[2] ||
+      sizes->GetValue(2) != sphereCells[1] ||
+      sizes->GetValue(3) != sphereCells[0])
+  {
+    cerr << "Expected 4 regions sized like the vertex and the spheres, got "
+         << polyConnectivity->GetNumberOfExtractedRegions() << "\n";
+    ++errors;
+  }
+
+  vtkNew<vtkConnectivityFilter> connectivity;
+  connectivity->SetInputData(input);
+  connectivity->SetExtractionModeToLargestRegion();
+  connectivity->Update();
+  if (connectivity->GetNumberOfExtractedRegions() != 4 ||
+      connectivity->GetOutput()->GetNumberOfCells() != sphereCells[2])
+  {
+    cerr << "Expected the largest of 4 regions with " << sphereCells[2]
+         << " cells, got "
+         << connectivity->GetOutput()->GetNumberOfCells() << " cells of "
+         << connectivity->GetNumberOfExtractedRegions() << " regions\n";
+    ++errors;
+  }
+
+  // Point 0 and point 1500, and cell 1500, are on the last sphere, which is
+  // region 1 and the largest one, and the closest to (0, 0, 5). Cell 0 is
+  // the vertex. The specified regions are the last and the first spheres.
+  // When all the regions are traversed, all their points are passed.
+  const vtkIdType expectedCells[6] = {
+    sphereCells[2], 1 + sphereCells[2], sphereCells[2] + sphereCells[0],
+    sphereCells[2], 1 + sphereCells[0] + sphereCells[1] + sphereCells[2],
+    sphereCells[2] };
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType expectedPoints[6] = {
+    spherePoints[2], 1 + spherePoints[2], numPts, numPts, numPts,
+    spherePoints[2] };
+
+  errors += TestModes(polyConnectivity.GetPointer(),
+                      "vtkPolyDataConnectivityFilter", expectedCells,
+                      expectedPoints);
+  polyConnectivity->SetScalarRange(0.2, 0.8);
+  polyConnectivity->FullScalarConnectivityOn();
+  errors += TestModes(polyConnectivity.GetPointer(),
+                      "vtkPolyDataConnectivityFilter with full scalars",
+                      expectedCells, expectedPoints);
+  connectivity->SetScalarRange(0.2, 0.8);
+  errors += TestModes(connectivity.GetPointer(), "vtkConnectivityFilter",
+                      expectedCells, expectedPoints);
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -13,16 +13,26 @@
 
 =========================================================================*/
 #include "vtkSmartPointer.h"
+#include "vtkAppendFilter.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
 #include "vtkCutter.h"
+#include "vtkDataArray.h"
 #include "vtkRTAnalyticSource.h"
 #include "vtkPolyData.h"
 #include "vtkPlane.h"
 #include "vtkPolygonBuilder.h"
+#include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
 #include "vtkDataSetTriangleFilter.h"
 #include "vtkPointDataToCellData.h"
 #include "vtkImageDataToPointSet.h"
+#include "vtkMath.h"
+#include "vtkTestDataSetComparison.h"
+#include "vtkUnstructuredGrid.h"
 #include <cassert>
+#include <cmath>
 
 bool TestStructured(int type)
 {
@@ -103,8 +113,126 @@ bool TestUnstructured()
   return true;
 }
 
+// The total area of the polygons and length of the lines of a cut.
+void Measure(vtkPolyData *cut, double &area, double &length)
+{
+  area = length = 0.0;
+  vtkIdType npts, *pts;
+  double x0[3], x1[3], x2[3], e1[3], e2[3], n[3];
+  vtkCellArray *polys = cut->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    cut->GetPoint(pts[0], x0);
+    for (vtkIdType i = 2; i < npts; ++i)
+    {
+      cut->GetPoint(pts[i - 1], x1);
+      cut->GetPoint(pts[i], x2);
+      vtkMath::Subtract(x1, x0, e1);
+      vtkMath::Subtract(x2, x0, e2);
+      vtkMath::Cross(e1, e2, n);
+      area += 0.5 * vtkMath::Norm(n);
+    }
+  }
+  vtkCellArray *lines = cut->GetLines();
+  for (lines->InitTraversal(); lines->GetNextCell(npts, pts);)
+  {
+    for (vtkIdType i = 1; i < npts; ++i)
+    {
+      cut->GetPoint(pts[i - 1], x0);
+      cut->GetPoint(pts[i], x1);
+      length += std::sqrt(vtkMath::Distance2BetweenPoints(x0, x1));
+    }
+  }
+}
+
+// Cut a grid of tetrahedra and triangles large enough to be cut with
+// several threads. The cut is compared with the output of a single thread,
+// and with the cuts of the image data the cells come from: the cut surfaces
+// are planar, so their area and length do not depend on the cells.
+bool TestThreadedUnstructured()
+{
+  vtkSmartPointer<vtkRTAnalyticSource> volumeSource = vtkSmartPointer<vtkRTAnalyticSource>::New();
+  volumeSource->SetWholeExtent(-12,12,-12,12,-12,12);
+  vtkSmartPointer<vtkRTAnalyticSource> sliceSource = vtkSmartPointer<vtkRTAnalyticSource>::New();
+  sliceSource->SetWholeExtent(-12,12,-12,12,0,0);
+
+  vtkSmartPointer<vtkAppendFilter> append = vtkSmartPointer<vtkAppendFilter>::New();
+  vtkRTAnalyticSource *sources[2] = { volumeSource, sliceSource };
+  for (int i = 0; i < 2; ++i)
+  {
+    vtkSmartPointer<vtkPointDataToCellData> dataFilter = vtkSmartPointer<vtkPointDataToCellData>::New();
+    dataFilter->SetInputConnection(sources[i]->GetOutputPort());
+    dataFilter->PassPointDataOn();
+    vtkSmartPointer<vtkDataSetTriangleFilter> tetraFilter = vtkSmartPointer<vtkDataSetTriangleFilter>::New();
+    tetraFilter->SetInputConnection(dataFilter->GetOutputPort());
+    append->AddInputConnection(tetraFilter->GetOutputPort());
+  }
+
+  vtkSmartPointer<vtkCutter> cutter = vtkSmartPointer<vtkCutter>::New();
+  vtkSmartPointer<vtkPlane> p3d = vtkSmartPointer<vtkPlane>::New();
+  p3d->SetOrigin(0.5,0.25,0.125);
+  p3d->SetNormal(1,2,3);
+  cutter->SetCutFunction(p3d);
+  cutter->SetInputConnection(0, append->GetOutputPort());
+  cutter->GenerateCutScalarsOn();
+  cutter->SetGenerateTriangles(1);
+  for (int i = 0; i < 5; ++i)
+  {
+    cutter->SetValue(i, -20.0 + 10.0 * i);
+  }
+
+  vtkSmartPointer<vtkDataSet> serialOutput = vtkTest::UpdateWithThreads(cutter, 1);
+  vtkSmartPointer<vtkDataSet> threadedOutput = vtkTest::UpdateWithThreads(cutter, 4);
+  vtkPolyData* output = vtkPolyData::SafeDownCast(threadedOutput);
+  if (output->GetNumberOfLines() == 0 || output->GetNumberOfPolys() == 0 ||
+      !vtkTest::SameDataSets(serialOutput, output) || output->CheckAttributes())
+  {
+    return false;
+  }
+
+  // The cut scalars are the values of the plane at the points.
+  vtkDataArray* cutScalars = output->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    output->GetPoint(i, x);
+    double value = p3d->EvaluateFunction(x);
+    double expected = -20.0 + 10.0 * std::floor((value + 25.0) / 10.0);
+    if (std::fabs(value - expected) > 1.0e-4 ||
+        std::fabs(cutScalars->GetTuple1(i) - expected) > 1.0e-4)
+    {
+      return false;
+    }
+  }
+
+  double area, length, expectedArea, expectedLength, unused;
+  Measure(output, area, length);
+  vtkSmartPointer<vtkCutter> imageCutter = vtkSmartPointer<vtkCutter>::New();
+  imageCutter->SetCutFunction(p3d);
+  for (int i = 0; i < cutter->GetNumberOfContours(); ++i)
+  {
+    imageCutter->SetValue(i, cutter->GetValue(i));
+  }
+  imageCutter->SetInputConnection(volumeSource->GetOutputPort());
+  imageCutter->Update();
+  Measure(imageCutter->GetOutput(), expectedArea, unused);
+  imageCutter->SetInputConnection(sliceSource->GetOutputPort());
+  imageCutter->Update();
+  Measure(imageCutter->GetOutput(), unused, expectedLength);
+  if (std::fabs(area - expectedArea) > 1.0e-6 * expectedArea ||
+      std::fabs(length - expectedLength) > 1.0e-6 * expectedLength)
+  {
+    cerr << "Cut area " << area << " and length " << length << " instead of "
+         << expectedArea << " and " << expectedLength << endl;
+    return false;
+  }
+  return true;
+}
+
 int TestCutter(int, char *[])
 {
+  vtkSMPTools::Initialize(4);
+
   for(int type=0; type<2; type++)
   {
     if(!TestStructured(type))
@@ -120,5 +248,11 @@ int TestCutter(int, char *[])
     return EXIT_FAILURE;
   }
 
+  if(!TestThreadedUnstructured())
+  {
+    cerr<<"Threaded cutting of Unstructured failed"<<endl;
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
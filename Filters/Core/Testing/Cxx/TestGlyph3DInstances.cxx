@@ -0,0 +1,237 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGlyph3DInstances.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkGlyph3D gives the same glyphs whatever the number of
+// threads, and the same as its sequential loop, that they are where a
+// vtkTransform puts them, and that the transforms of its instanced output
+// move the source points there too.
+
+#include "vtkAngularPeriodicDataArray.h"
+#include "vtkConeSource.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkGlyph3D.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetComparison.h"
+#include "vtkTransform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+
+void SetUpGlyph(vtkGlyph3D *glyph, vtkPolyData *input, vtkPolyData *source,
+                vtkTransform *sourceTransform, bool instanced)
+{
+  glyph->SetInputData(input);
+  glyph->SetSourceData(source);
+  glyph->SetSourceTransform(sourceTransform);
+  glyph->SetScaleModeToScaleByVector();
+  glyph->SetScaleFactor(0.5);
+  glyph->GeneratePointIdsOn();
+  glyph->SetInstancedOutput(instanced);
+}
+
+// The transform of the glyph of an input point: move the source with its
+// transform, scale it by half the vector norm, turn its x axis to the
+// vector and translate it to the point.
+void GlyphTransform(vtkPolyData *input, vtkIdType ptId,
+                    vtkTransform *sourceTransform, vtkTransform *transform)
+{
+  double x[3], v[3];
+  input->GetPoint(ptId, x);
+  input->GetPointData()->GetVectors()->GetTuple(ptId, v);
+  double norm = vtkMath::Norm(v);
+
+  transform->Identity();
+  transform->Translate(x);
+  if (norm > 0.0 && v[1] == 0.0 && v[2] == 0.0)
+  {
+    if (v[0] < 0.0)
+    {
+      transform->RotateY(180.0);
+    }
+  }
+  else if (norm > 0.0)
+  {
+    // a half turn around the bisector of the x axis and the vector
+    transform->RotateWXYZ(180.0, v[0] + norm, v[1], v[2]);
+  }
+  double scale = norm > 0.0 ? 0.5 * norm : 1.0e-10;
+  transform->Scale(scale, scale, scale);
+  transform->Concatenate(sourceTransform);
+}
+
+} // end anon namespace
+
+int TestGlyph3DInstances(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+
+  // Points with vectors of every direction, some along the x axis and some
+  // null, whose glyphs are not rotated.
+  vtkNew<vtkPolyData> input;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetNumberOfComponents(3);
+  for (int i = 0; i < 500; ++i)
+  {
+    points->InsertNextPoint(i % 10, (i / 10) % 10, i / 100);
+    double v[3] = { std::cos(0.1 * i), std::sin(0.3 * i), std::cos(0.7 * i) };
+    if (i % 7 == 0)
+    {
+      v[1] = v[2] = 0.0;
+    }
+    if (i % 11 == 0)
+    {
+      v[0] = v[1] = v[2] = 0.0;
+    }
+    vectors->InsertNextTuple(v);
+  }
+  input->SetPoints(points.GetPointer());
+  input->GetPointData()->SetVectors(vectors.GetPointer());
+
+  vtkNew<vtkConeSource> cone;
+  cone->SetResolution(8);
+  cone->Update();
+  vtkPolyData *source = cone->GetOutput();
+  vtkNew<vtkTransform> sourceTransform;
+  sourceTransform->RotateZ(30.0);
+  sourceTransform->Translate(0.5, 0.0, 0.0);
+
+  // The glyph points where the transforms put them.
+  vtkIdType numSourcePts = source->GetNumberOfPoints();
+  vtkNew<vtkPoints> expected;
+  expected->SetDataTypeToDouble();
+  vtkNew<vtkPoints> glyphPoints;
+  glyphPoints->SetDataTypeToDouble();
+  vtkNew<vtkTransform> transform;
+  for (vtkIdType ptId = 0; ptId < 500; ++ptId)
+  {
+    GlyphTransform(input.GetPointer(), ptId, sourceTransform.GetPointer(),
+                   transform.GetPointer());
+    glyphPoints->Reset();
+    transform->TransformPoints(source->GetPoints(), glyphPoints.GetPointer());
+    for (vtkIdType i = 0; i < numSourcePts; ++i)
+    {
+      expected->InsertNextPoint(glyphPoints->GetPoint(i));
+    }
+  }
+
+  int errors = 0;
+  vtkNew<vtkGlyph3D> glyph;
+  SetUpGlyph(glyph.GetPointer(), input.GetPointer(), source,
+             sourceTransform.GetPointer(), false);
+  vtkSmartPointer<vtkDataSet> glyphs =
+    vtkTest::UpdateWithThreads(glyph.GetPointer(), 4);
+  if (glyphs->GetNumberOfPoints() != 500 * numSourcePts ||
+      glyphs->GetNumberOfCells() != 500 * source->GetNumberOfPolys())
+  {
+    cerr << "Expected " << 500 * numSourcePts << " points, got "
+         << glyphs->GetNumberOfPoints() << "\n";
+    return EXIT_FAILURE;
+  }
+  double maxError = 0.0;
+  for (vtkIdType ptId = 0; ptId < glyphs->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3], y[3];
+    glyphs->GetPoint(ptId, x);
+    expected->GetPoint(ptId, y);
+    maxError = std::max(maxError,
+                        std::sqrt(vtkMath::Distance2BetweenPoints(x, y)));
+  }
+  if (maxError > 1.0e-5)
+  {
+    cerr << "The glyph points are off by " << maxError << "\n";
+    ++errors;
+  }
+  if (!vtkTest::SameThreadedOutputs(glyph.GetPointer(), 4))
+  {
+    cerr << "Threaded glyphs differ\n";
+    ++errors;
+  }
+
+  // The same input with its points in a mapped array, not rotated, which
+  // the threads do not read: the glyphs come from the sequential loop.
+  vtkNew<vtkAngularPeriodicDataArray<float> > mappedCoords;
+  mappedCoords->InitializeArray(
+    vtkArrayDownCast<vtkFloatArray>(points->GetData()));
+  mappedCoords->SetAngle(0.0);
+  vtkNew<vtkPoints> mappedPoints;
+  mappedPoints->SetData(mappedCoords.GetPointer());
+  vtkNew<vtkPolyData> mappedInput;
+  mappedInput->SetPoints(mappedPoints.GetPointer());
+  mappedInput->GetPointData()->SetVectors(vectors.GetPointer());
+  vtkNew<vtkGlyph3D> serialGlyph;
+  SetUpGlyph(serialGlyph.GetPointer(), mappedInput.GetPointer(), source,
+             sourceTransform.GetPointer(), false);
+  serialGlyph->Update();
+  if (!vtkTest::SameDataSets(glyphs, serialGlyph->GetOutput()))
+  {
+    cerr << "Threaded glyphs differ from the sequential ones\n";
+    ++errors;
+  }
+
+  vtkNew<vtkGlyph3D> instancer;
+  SetUpGlyph(instancer.GetPointer(), input.GetPointer(), source,
+             sourceTransform.GetPointer(), true);
+  vtkSmartPointer<vtkDataSet> instances =
+    vtkTest::UpdateWithThreads(instancer.GetPointer(), 4);
+  vtkDataArray *transforms =
+    instances->GetPointData()->GetArray("GlyphTransform");
+  if (!transforms || transforms->GetNumberOfComponents() != 16 ||
+      instances->GetNumberOfPoints() != 500)
+  {
+    cerr << "Expected 500 instances with 16 component transforms\n";
+    return EXIT_FAILURE;
+  }
+  maxError = 0.0;
+  for (vtkIdType glyphId = 0; glyphId < 500; ++glyphId)
+  {
+    double m[16];
+    transforms->GetTuple(glyphId, m);
+    for (vtkIdType i = 0; i < numSourcePts; ++i)
+    {
+      double x[3], y[3];
+      source->GetPoint(i, x);
+      expected->GetPoint(glyphId * numSourcePts + i, y);
+      for (int j = 0; j < 3; ++j)
+      {
+        double z = m[4*j] * x[0] + m[4*j+1] * x[1] + m[4*j+2] * x[2] + m[4*j+3];
+        maxError = std::max(maxError, std::fabs(z - y[j]));
+      }
+    }
+  }
+  if (maxError > 1.0e-9)
+  {
+    cerr << "Instanced transforms are off by " << maxError << "\n";
+    ++errors;
+  }
+  if (!vtkTest::SameThreadedOutputs(instancer.GetPointer(), 4))
+  {
+    cerr << "Threaded instances differ\n";
+    ++errors;
+  }
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,148 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormals.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkPolyDataNormals gives the same output whatever the number
+// of threads, that the normals of a sphere whose polygons are inconsistently
+// ordered are radial, follow the order of the polygons or are made
+// consistent, and that automatic orientation makes them point outwards.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkSMPTools.h"
+#include "vtkSphereSource.h"
+#include "vtkTestDataSetComparison.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+
+// Check the normals of the sphere centered at the origin. They are radial,
+// and point outwards, or inwards for every third cell, as the polygons are
+// ordered, unless the filter reorders the polygons consistently. The normals
+// of the points are only checked then, when they all agree.
+bool CheckNormals(vtkPolyDataNormals *normals)
+{
+  vtkPolyData *output = normals->GetOutput();
+  vtkDataArray *cellNormals = output->GetCellData()->GetNormals();
+  const bool reordered =
+    normals->GetConsistency() || normals->GetAutoOrientNormals();
+  vtkNew<vtkIdList> pts;
+  double firstSign = 0.0;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    double c[3] = { 0.0, 0.0, 0.0 };
+    output->GetCellPoints(cellId, pts.GetPointer());
+    for (vtkIdType i = 0; i < pts->GetNumberOfIds(); ++i)
+    {
+      double x[3];
+      output->GetPoint(pts->GetId(i), x);
+      vtkMath::Add(c, x, c);
+    }
+    vtkMath::Normalize(c);
+    double d = vtkMath::Dot(cellNormals->GetTuple3(cellId), c);
+    double sign = d > 0.0 ? 1.0 : -1.0;
+    if (firstSign == 0.0)
+    {
+      firstSign = sign;
+    }
+    double expectedSign = normals->GetAutoOrientNormals() ? 1.0 :
+      (reordered ? firstSign : (cellId % 3 == 0 ? -1.0 : 1.0));
+    if (std::fabs(d) < 0.99 || sign != expectedSign)
+    {
+      cerr << "Cell normal " << cellId << " is not radial, or points the "
+           << "wrong way\n";
+      return false;
+    }
+  }
+
+  vtkDataArray *pointNormals = output->GetPointData()->GetNormals();
+  for (vtkIdType ptId = 0; reordered && ptId < output->GetNumberOfPoints();
+       ++ptId)
+  {
+    double x[3];
+    output->GetPoint(ptId, x);
+    vtkMath::Normalize(x);
+    double d = vtkMath::Dot(pointNormals->GetTuple3(ptId), x);
+    if (d * firstSign < 0.99)
+    {
+      cerr << "Point normal " << ptId << " is not radial, or points the "
+           << "wrong way\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestPolyDataNormals(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+
+  // A sphere large enough for the consistency waves to be checked in
+  // parallel, with every third triangle reversed.
+  vtkNew<vtkSphereSource> source;
+  source->SetThetaResolution(400);
+  source->SetPhiResolution(400);
+  source->Update();
+  vtkNew<vtkPolyData> sphere;
+  sphere->DeepCopy(source->GetOutput());
+  sphere->BuildCells();
+  for (vtkIdType cellId = 0; cellId < sphere->GetNumberOfCells(); cellId += 3)
+  {
+    sphere->ReverseCell(cellId);
+  }
+
+  int errors = 0;
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputData(sphere.GetPointer());
+  normals->ComputeCellNormalsOn();
+  for (int options = 0; options < 8; ++options)
+  {
+    normals->SetSplitting(options & 1);
+    normals->SetConsistency((options >> 1) & 1);
+    normals->SetAutoOrientNormals((options >> 2) & 1);
+    if (!vtkTest::SameThreadedOutputs(normals.GetPointer(), 4) ||
+        !CheckNormals(normals.GetPointer()))
+    {
+      cerr << "Normals fail with splitting "
+           << normals->GetSplitting() << ", consistency "
+           << normals->GetConsistency() << ", auto orientation "
+           << normals->GetAutoOrientNormals() << "\n";
+      ++errors;
+    }
+  }
+
+  // The last run oriented the sphere automatically, without splitting the
+  // points since the polygons are then consistently ordered.
+  vtkPolyData *output = normals->GetOutput();
+  if (output->GetNumberOfPoints() != sphere->GetNumberOfPoints())
+  {
+    cerr << "Oriented sphere has " << output->GetNumberOfPoints()
+         << " points instead of " << sphere->GetNumberOfPoints() << "\n";
+    ++errors;
+  }
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -15,8 +15,16 @@
 
 #include <vtkCellArray.h>
 #include <vtkMinimalStandardRandomSequence.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkSmoothPolyDataFilter.h>
+#include <vtkSphereSource.h>
+#include <vtkTestDataSetComparison.h>
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <vector>
 
 namespace
 {
@@ -83,6 +91,83 @@ int SmoothPolyData(int dataType, int outputPointsPrecision)
 
   return points->GetDataType();
 }
+
+// Check that the smoothing gives the same points whatever the number of
+// threads, and the points of a plain Laplacian smoothing: on a sphere, every
+// point is a simple vertex moved toward the mean of its neighbors, all the
+// points moving at once at each iteration.
+bool SmoothThreaded()
+{
+  vtkSmartPointer<vtkSphereSource> sphere
+    = vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(60);
+  sphere->SetPhiResolution(60);
+  sphere->Update();
+
+  vtkSmartPointer<vtkSmoothPolyDataFilter> smoothPolyDataFilter
+    = vtkSmartPointer<vtkSmoothPolyDataFilter>::New();
+  smoothPolyDataFilter->SetInputConnection(sphere->GetOutputPort());
+  smoothPolyDataFilter->SetRelaxationFactor(0.1);
+  smoothPolyDataFilter->FeatureEdgeSmoothingOn();
+
+  if (!vtkTest::SameThreadedOutputs(smoothPolyDataFilter, 4))
+  {
+    return false;
+  }
+
+  vtkPolyData *input = sphere->GetOutput();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  std::vector<std::set<vtkIdType> > neighbors(numPts);
+  vtkIdType npts, *pts;
+  vtkCellArray *polys = input->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      neighbors[pts[i]].insert(pts[(i + 1) % npts]);
+      neighbors[pts[(i + 1) % npts]].insert(pts[i]);
+    }
+  }
+  std::vector<double> x(3 * numPts), newX(3 * numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    input->GetPoint(i, &x[3 * i]);
+  }
+  for (int iteration = 0;
+       iteration < smoothPolyDataFilter->GetNumberOfIterations(); ++iteration)
+  {
+    for (vtkIdType i = 0; i < numPts; ++i)
+    {
+      double mean[3] = { 0.0, 0.0, 0.0 };
+      std::set<vtkIdType>::iterator it;
+      for (it = neighbors[i].begin(); it != neighbors[i].end(); ++it)
+      {
+        for (int k = 0; k < 3; ++k)
+        {
+          mean[k] += x[3 * *it + k] / neighbors[i].size();
+        }
+      }
+      for (int k = 0; k < 3; ++k)
+      {
+        newX[3 * i + k] = x[3 * i + k] + 0.1 * (mean[k] - x[3 * i + k]);
+      }
+    }
+    x.swap(newX);
+  }
+
+  vtkPoints *points = smoothPolyDataFilter->GetOutput()->GetPoints();
+  double maxError = 0.0;
+  for(vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+  {
+    double y[3];
+    points->GetPoint(i, y);
+    for (int k = 0; k < 3; ++k)
+    {
+      maxError = std::max(maxError, std::fabs(y[k] - x[3 * i + k]));
+    }
+  }
+  return points->GetNumberOfPoints() == numPts && maxError < 1.0e-5;
+}
 }
 
 int TestSmoothPolyDataFilter(int vtkNotUsed(argc), char *vtkNotUsed(argv)[])
@@ -129,5 +214,10 @@ int TestSmoothPolyDataFilter(int vtkNotUsed(argc), char *vtkNotUsed(argv)[])
     return EXIT_FAILURE;
   }
 
+  if(!SmoothThreaded())
+  {
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
@@ -16,13 +16,133 @@
 #include "vtkNew.h"
 #include "vtkThreshold.h"
 #include "vtkRTAnalyticSource.h"
+#include "vtkBitArray.h"
 #include "vtkDataObject.h"
 #include "vtkUnstructuredGrid.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkPointData.h"
 #include "vtkFloatArray.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkPointDataToCellData.h"
+#include "vtkSMPTools.h"
+#include "vtkTestDataSetComparison.h"
+
+#include <vector>
+
+namespace
+{
+
+// Threshold the input with several threads, and check the output against
+// the cells that satisfy the criterion, found one cell at a time, and
+// against the output of a single thread.
+bool CheckOutput(vtkThreshold *filter, vtkImageData *input, double lower,
+                 double upper, bool usePointScalars)
+{
+  vtkDataArray *scalars = usePointScalars ?
+    input->GetPointData()->GetArray("RTData") :
+    input->GetCellData()->GetArray("RTData");
+  std::vector<vtkIdType> keptCells;
+  std::vector<char> keptPoints(input->GetNumberOfPoints(), 0);
+  vtkNew<vtkIdList> pts;
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    input->GetCellPoints(cellId, pts.GetPointer());
+    bool keep = true;
+    if (usePointScalars)
+    {
+      for (vtkIdType i = 0; keep && i < pts->GetNumberOfIds(); ++i)
+      {
+        double s = scalars->GetTuple1(pts->GetId(i));
+        keep = (s >= lower && s <= upper);
+      }
+    }
+    else
+    {
+      double s = scalars->GetTuple1(cellId);
+      keep = (s >= lower && s <= upper);
+    }
+    if (keep)
+    {
+      keptCells.push_back(cellId);
+      for (vtkIdType i = 0; i < pts->GetNumberOfIds(); ++i)
+      {
+        keptPoints[pts->GetId(i)] = 1;
+      }
+    }
+  }
+  vtkIdType numKeptPoints = 0;
+  for (size_t i = 0; i < keptPoints.size(); ++i)
+  {
+    numKeptPoints += keptPoints[i];
+  }
+
+  vtkSmartPointer<vtkDataSet> output = vtkTest::UpdateWithThreads(filter, 4);
+  if (keptCells.empty() ||
+      output->GetNumberOfCells() != static_cast<vtkIdType>(keptCells.size()) ||
+      output->GetNumberOfPoints() != numKeptPoints)
+  {
+    cerr << "Expected " << keptCells.size() << " cells and " << numKeptPoints
+         << " points, got " << output->GetNumberOfCells() << " cells and "
+         << output->GetNumberOfPoints() << " points" << endl;
+    return false;
+  }
+
+  // The cells keep their order, and the attributes follow the points and
+  // cells, including the bit array.
+  vtkDataArray *cellIds = output->GetCellData()->GetArray("CellIds");
+  vtkDataArray *pointIds = output->GetPointData()->GetArray("PointIds");
+  vtkDataArray *bits = output->GetPointData()->GetArray("Bits");
+  vtkDataArray *inRTData = input->GetPointData()->GetArray("RTData");
+  vtkDataArray *outRTData = output->GetPointData()->GetArray("RTData");
+  vtkNew<vtkIdList> outPts;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    vtkIdType inCellId = keptCells[cellId];
+    input->GetCellPoints(inCellId, pts.GetPointer());
+    output->GetCellPoints(cellId, outPts.GetPointer());
+    if (cellIds->GetTuple1(cellId) != inCellId ||
+        output->GetCellType(cellId) != input->GetCellType(inCellId) ||
+        outPts->GetNumberOfIds() != pts->GetNumberOfIds())
+    {
+      cerr << "Cell " << cellId << " is not input cell " << inCellId << endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < pts->GetNumberOfIds(); ++i)
+    {
+      vtkIdType ptId = outPts->GetId(i);
+      vtkIdType inPtId = pts->GetId(i);
+      double x[3], y[3];
+      output->GetPoint(ptId, x);
+      input->GetPoint(inPtId, y);
+      if (pointIds->GetTuple1(ptId) != inPtId ||
+          x[0] != y[0] || x[1] != y[1] || x[2] != y[2] ||
+          outRTData->GetTuple1(ptId) != inRTData->GetTuple1(inPtId) ||
+          bits->GetTuple1(ptId) != (inPtId % 3 == 0 ? 1 : 0))
+      {
+        cerr << "Point " << ptId << " of cell " << cellId
+             << " is not input point " << inPtId << endl;
+        return false;
+      }
+    }
+  }
+
+  if (!vtkTest::SameDataSets(vtkTest::UpdateWithThreads(filter, 1), output))
+  {
+    cerr << "Threaded threshold differs from the sequential one" << endl;
+    return false;
+  }
+  return true;
+}
+
+} // end anon namespace
+
 int TestThreshold(int, char *[])
 {
+  vtkSMPTools::Initialize(4);
+
   //---------------------------------------------------
   // Test using different thresholding methods
   //---------------------------------------------------
@@ -64,5 +184,53 @@ int TestThreshold(int, char *[])
     return EXIT_FAILURE;
   }
 
+  //---------------------------------------------------
+  // Test the threaded execution with point and cell scalars, and with
+  // attributes of several types
+  //---------------------------------------------------
+  vtkNew<vtkPointDataToCellData> cellScalars;
+  cellScalars->SetInputConnection(source->GetOutputPort());
+  cellScalars->PassPointDataOn();
+  cellScalars->Update();
+  vtkNew<vtkImageData> input;
+  input->DeepCopy(cellScalars->GetOutput());
+  vtkNew<vtkIdTypeArray> pointIds;
+  vtkNew<vtkBitArray> bits;
+  pointIds->SetName("PointIds");
+  bits->SetName("Bits");
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    pointIds->InsertNextValue(ptId);
+    bits->InsertNextValue(ptId % 3 == 0 ? 1 : 0);
+  }
+  input->GetPointData()->AddArray(pointIds.GetPointer());
+  input->GetPointData()->AddArray(bits.GetPointer());
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->InsertNextValue(cellId);
+  }
+  input->GetCellData()->AddArray(cellIds.GetPointer());
+
+  filter->SetInputData(input.GetPointer());
+  filter->UseContinuousCellRangeOff();
+  filter->SetAllScalars(1);
+  filter->ThresholdBetween(L,U);
+  filter->SetInputArrayToProcess(0, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_POINTS, "RTData");
+  if (!CheckOutput(filter.GetPointer(), input.GetPointer(), L, U, true))
+  {
+    cerr << "Threaded threshold of point scalars failed" << endl;
+    return EXIT_FAILURE;
+  }
+  filter->SetInputArrayToProcess(0, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_CELLS, "RTData");
+  if (!CheckOutput(filter.GetPointer(), input.GetPointer(), L, U, false))
+  {
+    cerr << "Threaded threshold of cell scalars failed" << endl;
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,186 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestWindowedSincPolyDataFilter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkWindowedSincPolyDataFilter gives the same output whatever
+// the number of threads, on a mesh with boundaries, sharp edges and lines,
+// that it removes the noise of a sphere without shrinking it, and that the
+// points used by vertex cells do not move.
+
+#include "vtkAppendPolyData.h"
+#include "vtkCellArray.h"
+#include "vtkCylinderSource.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSphereSource.h"
+#include "vtkTestDataSetComparison.h"
+#include "vtkWindowedSincPolyDataFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+
+// The mean and the standard deviation of the distance of the points
+// [begin, end) to their centroid. With normalized coordinates the smoothing
+// may move the sphere slightly, so the origin is not used.
+void RadiusStatistics(vtkPoints *points, vtkIdType begin, vtkIdType end,
+                      double &mean, double &deviation)
+{
+  double center[3] = { 0.0, 0.0, 0.0 };
+  for (vtkIdType i = begin; i < end; ++i)
+  {
+    double x[3];
+    points->GetPoint(i, x);
+    for (int j = 0; j < 3; ++j)
+    {
+      center[j] += x[j] / (end - begin);
+    }
+  }
+  double sum = 0.0, sum2 = 0.0;
+  for (vtkIdType i = begin; i < end; ++i)
+  {
+    double x[3];
+    points->GetPoint(i, x);
+    double r = std::sqrt(vtkMath::Distance2BetweenPoints(x, center));
+    sum += r;
+    sum2 += r * r;
+  }
+  mean = sum / (end - begin);
+  deviation = std::sqrt(std::max(0.0, sum2 / (end - begin) - mean * mean));
+}
+
+} // end anon namespace
+
+int TestWindowedSincPolyDataFilter(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+
+  // A sphere with holes, a capped cylinder, and a line whose middle point
+  // is also a vertex cell.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(60);
+  sphere->SetPhiResolution(60);
+  sphere->Update();
+  // The points of the sphere are moved by up to 2% of the radius, enough
+  // for some of its edges to be feature edges.
+  vtkNew<vtkPolyData> holed;
+  vtkNew<vtkPoints> noisyPoints;
+  vtkPoints *spherePoints = sphere->GetOutput()->GetPoints();
+  noisyPoints->SetNumberOfPoints(spherePoints->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < spherePoints->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    spherePoints->GetPoint(ptId, x);
+    double scale = 1.0 + 0.004 * ((ptId * 37) % 11 - 5);
+    noisyPoints->SetPoint(ptId, scale * x[0], scale * x[1], scale * x[2]);
+  }
+  holed->SetPoints(noisyPoints.GetPointer());
+  vtkNew<vtkCellArray> polys;
+  vtkCellArray *spherePolys = sphere->GetOutput()->GetPolys();
+  vtkIdType npts, *pts, cellId = 0;
+  for (spherePolys->InitTraversal(); spherePolys->GetNextCell(npts, pts);
+       ++cellId)
+  {
+    if (cellId % 97 != 5)
+    {
+      polys->InsertNextCell(npts, pts);
+    }
+  }
+  holed->SetPolys(polys.GetPointer());
+
+  vtkNew<vtkCylinderSource> cylinder;
+  cylinder->SetResolution(40);
+
+  vtkNew<vtkPolyData> line;
+  vtkNew<vtkPoints> linePoints;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> verts;
+  lines->InsertNextCell(21);
+  for (int i = 0; i <= 20; ++i)
+  {
+    lines->InsertCellPoint(linePoints->InsertNextPoint(
+      0.1 * i, 0.2 * ((i * 7) % 3), 3.0));
+  }
+  vtkIdType fixedId = 10;
+  verts->InsertNextCell(1, &fixedId);
+  line->SetPoints(linePoints.GetPointer());
+  line->SetLines(lines.GetPointer());
+  line->SetVerts(verts.GetPointer());
+
+  vtkNew<vtkAppendPolyData> append;
+  append->AddInputData(line.GetPointer());
+  append->AddInputData(holed.GetPointer());
+  append->AddInputConnection(cylinder->GetOutputPort());
+
+  double inputMean, inputDeviation;
+  RadiusStatistics(noisyPoints.GetPointer(), 0,
+                   noisyPoints->GetNumberOfPoints(), inputMean,
+                   inputDeviation);
+
+  int errors = 0;
+  vtkNew<vtkWindowedSincPolyDataFilter> smooth;
+  smooth->SetInputConnection(append->GetOutputPort());
+  for (int options = 0; options < 8; ++options)
+  {
+    smooth->SetFeatureEdgeSmoothing(options & 1);
+    smooth->SetBoundarySmoothing((options >> 1) & 1);
+    smooth->SetNormalizeCoordinates((options >> 2) & 1);
+    if (!vtkTest::SameThreadedOutputs(smooth.GetPointer(), 4))
+    {
+      cerr << "Threaded smoothing differs with feature edge smoothing "
+           << smooth->GetFeatureEdgeSmoothing() << ", boundary smoothing "
+           << smooth->GetBoundarySmoothing() << ", normalized coordinates "
+           << smooth->GetNormalizeCoordinates() << "\n";
+      ++errors;
+    }
+
+    // The points of the sphere follow those of the line. The feature edges
+    // found on the noisy sphere are only smoothed along each other, so the
+    // noise is checked without them.
+    if (smooth->GetFeatureEdgeSmoothing())
+    {
+      continue;
+    }
+    double mean, deviation;
+    RadiusStatistics(smooth->GetOutput()->GetPoints(), 21,
+                     21 + noisyPoints->GetNumberOfPoints(), mean, deviation);
+    if (std::fabs(mean - inputMean) > 0.005 * inputMean ||
+        deviation > 0.5 * inputDeviation)
+    {
+      cerr << "The smoothed sphere has a mean radius of " << mean
+           << " and a deviation of " << deviation << " instead of "
+           << inputMean << " and " << inputDeviation << "\n";
+      ++errors;
+    }
+  }
+
+  double x[3], y[3];
+  smooth->NormalizeCoordinatesOff();
+  smooth->Update();
+  smooth->GetOutput()->GetPoint(fixedId, x);
+  append->GetOutput()->GetPoint(fixedId, y);
+  if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+  {
+    cerr << "Point " << fixedId << " used by a vertex cell moved to ("
+         << x[0] << ", " << x[1] << ", " << x[2] << ")\n";
+    ++errors;
+  }
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -14,117 +14,278 @@
   =========================================================================*/
 #include "vtkCellDataToPointData.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
-#include "vtkCell.h"
+#include "vtkCellTypes.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
+#include "vtkDataSetAttributesRemoveArrays.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinks.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUniformGrid.h"
-#include "vtkUnsignedIntArray.h"
 
 #include <algorithm>
-#include <functional>
+#include <set>
+#include <string>
+#include <vector>
 
 #define VTK_MAX_CELLS_PER_POINT 4096
 
+// The names of the arrays to process when ProcessAllArrays is off.
+class vtkCellDataToPointData::Internals
+{
+public:
+  std::set<std::string> CellDataArrays;
+};
+
 vtkStandardNewMacro(vtkCellDataToPointData);
 
 namespace
 {
 //----------------------------------------------------------------------------
-// Helper template function that implement the major part of the algorighm
-// which will be expanded by the vtkTemplateMacro. The template function is
-// provided so that coverage test can cover this function.
-  template <typename T>
-  void __spread (vtkDataSet* const src, vtkUnsignedIntArray* const num,
-                 vtkDataArray* const srcarray, vtkDataArray* const dstarray,
-                 vtkIdType ncells, vtkIdType npoints, vtkIdType ncomps,
-                 int highestCellDimension, int contributingCellOption)
+// Average the cell values of an array over the cells using each point of an
+// unstructured dataset, given by static links. The values are accumulated
+// in the value type of the array, cell after cell in increasing id order,
+// so the results do not depend on the number of threads. Only the cells of
+// dimension MinDimension or more contribute, or with Patch only the cells
+// of the highest dimension around each point.
+template <typename DstArrayT, typename SrcArrayT>
+struct vtkCellDataToPointDataSpread
+{
+  typedef typename vtkDataArrayAccessor<SrcArrayT>::APIType ValueType;
+
+  DstArrayT *Dst;
+  SrcArrayT *Src;
+  vtkDataSet *DataSet;
+  vtkStaticCellLinks *Links;
+  const int *TypeDimensions;
+  int MinDimension;
+  bool Patch;
+
+  vtkCellDataToPointDataSpread(DstArrayT *dst, SrcArrayT *src, vtkDataSet *ds,
+                               vtkStaticCellLinks *links,
+                               const int *typeDimensions, int minDimension,
+                               bool patch)
+    : Dst(dst), Src(src), DataSet(ds), Links(links),
+      TypeDimensions(typeDimensions), MinDimension(minDimension), Patch(patch)
   {
-    T const* const srcptr = static_cast<T const*>(srcarray->GetVoidPointer(0));
-    T      * const dstptr = static_cast<T      *>(dstarray->GetVoidPointer(0));
+  }
 
-    // zero initialization
-    std::fill_n(dstptr, npoints*ncomps, T(0));
+  int GetCellDimension(vtkIdType cellId)
+  {
+    return this->TypeDimensions[this->DataSet->GetCellType(cellId)];
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkDataArrayAccessor<DstArrayT> dst(this->Dst);
+    vtkDataArrayAccessor<SrcArrayT> src(this->Src);
+    const int numComps = this->Src->GetNumberOfComponents();
+    std::vector<ValueType> sums(numComps);
 
-    // accumulate
-    if (contributingCellOption != vtkCellDataToPointData::Patch)
+    for ( ; ptId < endPtId; ++ptId )
     {
-      T const* srcbeg = srcptr;
-      for (vtkIdType cid = 0; cid < ncells; ++cid, srcbeg += ncomps)
+      const vtkIdType numCells = this->Links->GetNumberOfCells(ptId);
+      const vtkIdType *cells = this->Links->GetCells(ptId);
+
+      int minDimension = this->MinDimension;
+      if (this->Patch)
       {
-        vtkCell* cell = src->GetCell(cid);
-        if (cell->GetCellDimension() >= highestCellDimension)
+        for (vtkIdType i = 0; i < numCells; ++i)
         {
-          vtkIdList* pids = cell->GetPointIds();
-          for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
-          {
-            T* const dstbeg = dstptr + pids->GetId(i)*ncomps;
-            // accumulate cell data to point data <==> point_data += cell_data
-            std::transform(srcbeg,srcbeg+ncomps,dstbeg,dstbeg,std::plus<T>());
-          }
+          minDimension =
+            std::max(minDimension, this->GetCellDimension(cells[i]));
         }
       }
-      // average
-      T* dstbeg = dstptr;
-      for (vtkIdType pid = 0; pid < npoints; ++pid, dstbeg += ncomps)
+
+      std::fill(sums.begin(), sums.end(), ValueType(0));
+      unsigned int count = 0;
+      for (vtkIdType i = 0; i < numCells; ++i)
       {
-        // guard against divide by zero
-        if (unsigned int const denom = num->GetValue(pid))
+        const vtkIdType cellId = cells[i];
+        if (minDimension > 0 && this->GetCellDimension(cellId) < minDimension)
         {
-          // divide point data by the number of cells using it <==>
-          // point_data /= denum
-          std::transform(dstbeg, dstbeg+ncomps, dstbeg,
-                         std::bind2nd(std::divides<T>(), denom));
+          continue;
         }
+        ++count;
+        for (int comp = 0; comp < numComps; ++comp)
+        {
+          sums[comp] = static_cast<ValueType>(sums[comp] +
+                                              src.Get(cellId, comp));
+        }
+      }
+
+      // Points without contributing cells are set to zero.
+      for (int comp = 0; comp < numComps; ++comp)
+      {
+        dst.Set(ptId, comp, count == 0 ? ValueType(0) :
+          static_cast<ValueType>(sums[comp] / static_cast<ValueType>(count)));
       }
     }
+  }
+};
+
+struct vtkCellDataToPointDataSpreadWorker
+{
+  vtkDataSet *DataSet;
+  vtkStaticCellLinks *Links;
+  const int *TypeDimensions;
+  int MinDimension;
+  bool Patch;
+  bool Threaded;
+
+  template <typename DstArrayT, typename SrcArrayT>
+  void operator()(DstArrayT *dst, SrcArrayT *src)
+  {
+    vtkCellDataToPointDataSpread<DstArrayT, SrcArrayT> spread(dst, src,
+      this->DataSet, this->Links, this->TypeDimensions, this->MinDimension,
+      this->Patch);
+    if (this->Threaded)
+    {
+      vtkSMPTools::For(0, this->DataSet->GetNumberOfPoints(), spread);
+    }
     else
-    { // compute over cell patches
-      vtkNew<vtkIdList> cellsOnPoint;
-      std::vector<T> data(4*ncomps);
-      for (vtkIdType pid = 0; pid < npoints; ++pid)
+    {
+      spread(0, this->DataSet->GetNumberOfPoints());
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Average the cell values of an array over the cells using each point, for
+// datasets that compute the cells of a point (structured datasets). This
+// gives the same values as vtkDataSetAttributes::InterpolatePoint() with
+// equal weights.
+template <typename DstArrayT, typename SrcArrayT>
+struct vtkCellDataToPointDataAverage
+{
+  typedef typename vtkDataArrayAccessor<DstArrayT>::APIType ValueType;
+
+  DstArrayT *Dst;
+  SrcArrayT *Src;
+  vtkDataSet *DataSet;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+
+  vtkCellDataToPointDataAverage(DstArrayT *dst, SrcArrayT *src,
+                                vtkDataSet *ds)
+    : Dst(dst), Src(src), DataSet(ds)
+  {
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkDataArrayAccessor<DstArrayT> dst(this->Dst);
+    vtkDataArrayAccessor<SrcArrayT> src(this->Src);
+    const int numComps = this->Src->GetNumberOfComponents();
+    vtkIdList *cellIds = this->CellIds.Local();
+
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      this->DataSet->GetPointCells(ptId, cellIds);
+      const vtkIdType numCells = cellIds->GetNumberOfIds();
+      const vtkIdType *cells = cellIds->GetPointer(0);
+      if (numCells > 0 && numCells < VTK_MAX_CELLS_PER_POINT)
       {
-        std::fill(data.begin(), data.end(), 0);
-        T numPointCells[4] = {0, 0, 0, 0};
-        // Get all cells touching this point.
-        src->GetPointCells(pid, cellsOnPoint.GetPointer());
-        vtkIdType numPatchCells = cellsOnPoint->GetNumberOfIds();
-        for (vtkIdType pc = 0; pc  < numPatchCells; pc++)
+        const double weight = 1.0 / numCells;
+        for (int comp = 0; comp < numComps; ++comp)
         {
-          vtkIdType cellId = cellsOnPoint->GetId(pc);
-          int cellDimension = src->GetCell(cellId)->GetCellDimension();
-          numPointCells[cellDimension] += 1;
-          for (int comp=0;comp<ncomps;comp++)
+          double value = 0.0;
+          for (vtkIdType i = 0; i < numCells; ++i)
           {
-            data[comp+ncomps*cellDimension] += srcptr[comp+cellId*ncomps];
+            value += weight * static_cast<double>(src.Get(cells[i], comp));
           }
+          ValueType valueT;
+          vtkMath::RoundDoubleToIntegralIfNecessary(value, &valueT);
+          dst.Set(ptId, comp, valueT);
         }
-        for (int dimension=3;dimension>=0;dimension--)
+      }
+      else
+      {
+        for (int comp = 0; comp < numComps; ++comp)
         {
-          if (numPointCells[dimension])
-          {
-            for (int comp=0;comp<ncomps;comp++)
-            {
-              dstptr[comp+pid*ncomps] = data[comp+dimension*ncomps] / numPointCells[dimension];
-            }
-            break;
-          }
+          dst.Set(ptId, comp, ValueType(0));
         }
       }
     }
   }
+};
+
+struct vtkCellDataToPointDataAverageWorker
+{
+  vtkDataSet *DataSet;
+  bool Threaded;
+
+  template <typename DstArrayT, typename SrcArrayT>
+  void operator()(DstArrayT *dst, SrcArrayT *src)
+  {
+    vtkCellDataToPointDataAverage<DstArrayT, SrcArrayT> average(dst, src,
+                                                               this->DataSet);
+    if (this->Threaded)
+    {
+      vtkSMPTools::For(0, this->DataSet->GetNumberOfPoints(), average);
+    }
+    else
+    {
+      average(0, this->DataSet->GetNumberOfPoints());
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Interpolate an array the typed kernels do not handle (e.g. a
+// vtkStringArray, or an attribute copied from the nearest cell) one point
+// at a time, as vtkDataSetAttributes::InterpolatePoint() does.
+void vtkCellDataToPointDataInterpolateArray(vtkDataSet *input,
+                                            vtkAbstractArray *dstArray,
+                                            vtkAbstractArray *srcArray,
+                                            bool nearest)
+{
+  vtkNew<vtkIdList> cellIds;
+  std::vector<double> weights;
+  std::vector<double> nullTuple(dstArray->GetNumberOfComponents(), 0.0);
+  vtkDataArray *dstDA = vtkArrayDownCast<vtkDataArray>(dstArray);
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    input->GetPointCells(ptId, cellIds.GetPointer());
+    const vtkIdType numCells = cellIds->GetNumberOfIds();
+    if (numCells > 0 && numCells < VTK_MAX_CELLS_PER_POINT)
+    {
+      if (nearest)
+      {
+        // All the cells have the same weight, the first one is the nearest.
+        dstArray->InsertTuple(ptId, cellIds->GetId(0), srcArray);
+      }
+      else
+      {
+        weights.assign(numCells, 1.0 / numCells);
+        dstArray->InterpolateTuple(ptId, cellIds.GetPointer(), srcArray,
+                                   &weights[0]);
+      }
+    }
+    else if (dstDA)
+    {
+      dstDA->InsertTuple(ptId, &nullTuple[0]);
+    }
+  }
+}
 
   // Special traversal algorithm for vtkUniformGrid and vtkRectilinearGrid to support blanking
   // points will not have more than 8 cells for either of these data sets
   template <typename T>
-  void InterpolatePointDataWithMask(vtkCellDataToPointData* filter, T *input, vtkDataSet *output)
+  void InterpolatePointDataWithMask(vtkCellDataToPointData* filter, T *input,
+                                    vtkDataSet *output, vtkCellData *inCD)
   {
     vtkNew<vtkIdList> allCellIds;
     allCellIds->Allocate(8);
@@ -133,7 +294,6 @@ namespace
 
     vtkIdType numPts = input->GetNumberOfPoints();
 
-    vtkCellData *inCD = input->GetCellData();
     vtkPointData *outPD = output->GetPointData();
     outPD->InterpolateAllocate(inCD,numPts);
 
@@ -185,6 +345,70 @@ vtkCellDataToPointData::vtkCellDataToPointData()
 {
   this->PassCellData = 0;
   this->ContributingCellOption = vtkCellDataToPointData::All;
+  this->ProcessAllArrays = 1;
+  this->Implementation = new Internals();
+}
+
+//----------------------------------------------------------------------------
+vtkCellDataToPointData::~vtkCellDataToPointData()
+{
+  delete this->Implementation;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellDataToPointData::AddCellDataArray(const char *name)
+{
+  if (name && this->Implementation->CellDataArrays.insert(name).second)
+  {
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellDataToPointData::RemoveCellDataArray(const char *name)
+{
+  if (name && this->Implementation->CellDataArrays.erase(name) > 0)
+  {
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellDataToPointData::ClearCellDataArrays()
+{
+  if (!this->Implementation->CellDataArrays.empty())
+  {
+    this->Implementation->CellDataArrays.clear();
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkCellDataToPointData::GetNumberOfCellArraysToProcess()
+{
+  return static_cast<int>(this->Implementation->CellDataArrays.size());
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkCellData>
+vtkCellDataToPointData::GetCellDataToProcess(vtkDataSet *input)
+{
+  vtkSmartPointer<vtkCellData> inCD = input->GetCellData();
+  if (!this->ProcessAllArrays)
+  {
+    inCD = vtkSmartPointer<vtkCellData>::New();
+    inCD->ShallowCopy(input->GetCellData());
+    const std::set<std::string> &names = this->Implementation->CellDataArrays;
+    for (int i = inCD->GetNumberOfArrays(); i--;)
+    {
+      const char *name = inCD->GetAbstractArray(i)->GetName();
+      if (!name || names.find(name) == names.end())
+      {
+        inCD->RemoveArray(i);
+      }
+    }
+  }
+  return inCD;
 }
 
 //----------------------------------------------------------------------------
@@ -228,19 +452,20 @@ int vtkCellDataToPointData::RequestData(
   }
 
   // Do the interpolation, taking care of masked cells if needed.
+  vtkSmartPointer<vtkCellData> inCD = this->GetCellDataToProcess(input);
   vtkStructuredGrid *sGrid = vtkStructuredGrid::SafeDownCast(input);
   vtkUniformGrid *uniformGrid = vtkUniformGrid::SafeDownCast(input);
   if (sGrid && sGrid->HasAnyBlankCells())
   {
-    InterpolatePointDataWithMask(this, sGrid, output);
+    InterpolatePointDataWithMask(this, sGrid, output, inCD);
   }
   else if (uniformGrid && uniformGrid->HasAnyBlankCells())
   {
-    InterpolatePointDataWithMask(this, uniformGrid, output);
+    InterpolatePointDataWithMask(this, uniformGrid, output, inCD);
   }
   else
   {
-    this->InterpolatePointData(input, output);
+    this->InterpolatePointData(input, output, inCD);
   }
 
   if (!this->PassCellData)
@@ -260,6 +485,10 @@ void vtkCellDataToPointData::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "PassCellData: " << (this->PassCellData ? "On\n" : "Off\n");
   os << indent << "ContributingCellOption: " << this->ContributingCellOption << endl;
+  os << indent << "ProcessAllArrays: "
+     << (this->ProcessAllArrays ? "On\n" : "Off\n");
+  os << indent << "CellDataArrays: "
+     << this->Implementation->CellDataArrays.size() << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -281,44 +510,37 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
     return 1;
   }
 
-  // count the number of cells associated with each point. if we are doing patches
-  // though we will do that later on.
-  vtkSmartPointer<vtkUnsignedIntArray> num;
-  int highestCellDimension = 0;
-  if (this->ContributingCellOption != vtkCellDataToPointData::Patch)
+  // The cells using each point, built in parallel. Unlike GetPointCells(),
+  // this leaves the input untouched.
+  vtkNew<vtkStaticCellLinks> links;
+  links->BuildLinks(src);
+
+  // The dimension of each cell type of the dataset, to select the cells
+  // that contribute to the points. When all the cells have the same
+  // dimension, all the options select all the cells.
+  std::vector<int> typeDimensions(VTK_NUMBER_OF_CELL_TYPES, 0);
+  int minDimension = 0;
+  bool patch = false;
+  if (this->ContributingCellOption != vtkCellDataToPointData::All)
   {
-    num = vtkSmartPointer<vtkUnsignedIntArray>::New();
-    num->SetNumberOfComponents(1);
-    num->SetNumberOfTuples(npoints);
-    std::fill_n(num->GetPointer(0), npoints, 0u);
-    if (this->ContributingCellOption == vtkCellDataToPointData::DataSetMax)
+    vtkNew<vtkCellTypes> cellTypes;
+    src->GetCellTypes(cellTypes.GetPointer());
+    vtkNew<vtkGenericCell> cell;
+    int lowestCellDimension = 3;
+    int highestCellDimension = 0;
+    for (vtkIdType i = 0; i < cellTypes->GetNumberOfTypes(); ++i)
     {
-      int maxDimension = src->IsA("vtkPolyData") == 1 ? 2 : 3;
-      for (vtkIdType i=0;i<src->GetNumberOfCells();i++)
-      {
-        int dim = src->GetCell(i)->GetCellDimension();
-        if (dim > highestCellDimension)
-        {
-          highestCellDimension = dim;
-          if (highestCellDimension == maxDimension)
-          {
-            break;
-          }
-        }
-      }
+      const unsigned char type = cellTypes->GetCellType(i);
+      cell->SetCellType(type);
+      const int dim = cell->GetCellDimension();
+      typeDimensions[type] = dim;
+      lowestCellDimension = std::min(lowestCellDimension, dim);
+      highestCellDimension = std::max(highestCellDimension, dim);
     }
-    vtkNew<vtkIdList> pids;
-    for (vtkIdType cid = 0; cid < ncells; ++cid)
+    if (lowestCellDimension < highestCellDimension)
     {
-      if (src->GetCell(cid)->GetCellDimension() >= highestCellDimension)
-      {
-        src->GetCellPoints(cid, pids.GetPointer());
-        for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
-        {
-          vtkIdType const pid = pids->GetId(i);
-          num->SetValue(pid, num->GetValue(pid)+1);
-        }
-      }
+      patch = this->ContributingCellOption == vtkCellDataToPointData::Patch;
+      minDimension = patch ? 0 : highestCellDimension;
     }
   }
 
@@ -335,7 +557,7 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
 
   // Copy all existing cell fields into a temporary cell data array
   vtkSmartPointer<vtkCellData> clean = vtkSmartPointer<vtkCellData>::New();
-  clean->PassData(src->GetCellData());
+  clean->PassData(this->GetCellDataToProcess(src));
 
   // Remove all fields that are not a data array.
   for (vtkIdType fid = clean->GetNumberOfArrays(); fid--;)
@@ -351,12 +573,28 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
   cfl.InitializeFieldList(clean);
   opd->InterpolateAllocate(cfl, npoints, npoints);
 
+  vtkCellDataToPointDataSpreadWorker worker;
+  worker.DataSet = src;
+  worker.Links = links.GetPointer();
+  worker.TypeDimensions = &typeDimensions[0];
+  worker.MinDimension = minDimension;
+  worker.Patch = patch;
+
   for (int fid = 0, nfields = cfl.GetNumberOfFields(); fid < nfields; ++fid)
   {
     // update progress and check for an abort request.
     this->UpdateProgress((fid+1.)/nfields);
     if (this->GetAbortExecute())
     {
+      std::vector<vtkAbstractArray*> unmapped;
+      for ( ; fid < nfields; ++fid)
+      {
+        if (cfl.GetFieldIndex(fid) >= 0 && cfl.GetDSAIndex(0, fid) >= 0)
+        {
+          unmapped.push_back(opd->GetAbstractArray(cfl.GetFieldIndex(fid)));
+        }
+      }
+      vtkDataSetAttributesRemoveArrays(opd, unmapped);
       break;
     }
 
@@ -369,23 +607,18 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
       continue;
     }
 
-    vtkCellData * const srccelldata  = clean;
-    vtkPointData* const dstpointdata = dst->GetPointData();
-
-    if (!srccelldata || !dstpointdata)
-    {
-      continue;
-    }
-
-    vtkDataArray* const srcarray = srccelldata ->GetArray(srcid);
-    vtkDataArray* const dstarray = dstpointdata->GetArray(dstid);
+    vtkDataArray* const srcarray = clean->GetArray(srcid);
+    vtkDataArray* const dstarray = opd->GetArray(dstid);
     dstarray->SetNumberOfTuples(npoints);
 
-    vtkIdType const ncomps = srcarray->GetNumberOfComponents();
-    switch (srcarray->GetDataType())
+    // Average the arrays in parallel with typed kernels, or sequentially
+    // through the vtkDataArray API when the dispatch fails.
+    worker.Threaded = true;
+    if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(dstarray, srcarray,
+                                                           worker))
     {
-      vtkTemplateMacro
-        (__spread<VTK_TT>(src,num,srcarray,dstarray,ncells,npoints,ncomps, highestCellDimension, this->ContributingCellOption));
+      worker.Threaded = false;
+      worker(dstarray, srcarray);
     }
   }
 
@@ -399,44 +632,68 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
   return 1;
 }
 
-void vtkCellDataToPointData::InterpolatePointData(vtkDataSet *input, vtkDataSet *output)
+//----------------------------------------------------------------------------
+void vtkCellDataToPointData::InterpolatePointData(vtkDataSet *input,
+                                                  vtkDataSet *output,
+                                                  vtkCellData *inCD)
 {
-  vtkNew<vtkIdList> cellIds;
-  cellIds->Allocate(VTK_MAX_CELLS_PER_POINT);
-
   vtkIdType numPts = input->GetNumberOfPoints();
 
-  vtkCellData *inCD = input->GetCellData();
   vtkPointData *outPD = output->GetPointData();
   outPD->InterpolateAllocate(inCD,numPts);
 
-  double weights[VTK_MAX_CELLS_PER_POINT];
+  // The first call sets up what the dataset needs to compute the cells of
+  // a point; it must be done before the threads do the same.
+  vtkNew<vtkIdList> cellIds;
+  input->GetPointCells(0, cellIds.GetPointer());
+
+  vtkCellDataToPointDataAverageWorker worker;
+  worker.DataSet = input;
 
-  int abort = 0;
-  vtkIdType progressInterval = numPts / 20 + 1;
-  for (vtkIdType ptId = 0; ptId < numPts && !abort; ptId++)
+  const int numArrays = inCD->GetNumberOfArrays();
+  for (int i = 0; i < numArrays; ++i)
   {
-    if ( !(ptId % progressInterval) )
+    this->UpdateProgress(static_cast<double>(i) / numArrays);
+    if (this->GetAbortExecute())
     {
-      this->UpdateProgress(static_cast<double>(ptId)/numPts);
-      abort = GetAbortExecute();
+      vtkDataSetAttributesRemoveTargetArrays(outPD, i, numArrays);
+      break;
     }
 
-    input->GetPointCells(ptId, cellIds.GetPointer());
-    vtkIdType numCells = cellIds->GetNumberOfIds();
+    vtkAbstractArray *srcArray = inCD->GetAbstractArray(i);
+    vtkAbstractArray *dstArray = outPD->GetTargetArray(i);
+    if (!dstArray)
+    {
+      continue;
+    }
 
-    if ( numCells > 0 && numCells < VTK_MAX_CELLS_PER_POINT )
+    // Attributes may be copied from the nearest cell instead.
+    bool nearest = false;
+    for (int attr = 0; attr < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attr)
     {
-      double weight = 1.0 / numCells;
-      for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+      if (outPD->GetAbstractAttribute(attr) == dstArray &&
+          outPD->GetCopyAttribute(attr, vtkDataSetAttributes::INTERPOLATE) == 2)
       {
-        weights[cellId] = weight;
+        nearest = true;
       }
-      outPD->InterpolatePoint(inCD, ptId, cellIds.GetPointer(), weights);
     }
-    else
+
+    vtkDataArray *srcDA = vtkArrayDownCast<vtkDataArray>(srcArray);
+    vtkDataArray *dstDA = vtkArrayDownCast<vtkDataArray>(dstArray);
+    if (!srcDA || !dstDA || nearest)
+    {
+      vtkCellDataToPointDataInterpolateArray(input, dstArray, srcArray,
+                                             nearest);
+      continue;
+    }
+
+    dstDA->SetNumberOfTuples(numPts);
+    worker.Threaded = true;
+    if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(dstDA, srcDA,
+                                                           worker))
     {
-      outPD->NullPoint(ptId);
+      worker.Threaded = false;
+      worker(dstDA, srcDA);
     }
   }
 }
@@ -28,6 +28,13 @@
  * cells attached to a point. DataSetMax uses the highest cell dimension in
  * the entire data set.
  *
+ * The point values are computed in parallel with vtkSMPTools, one typed
+ * kernel per array. The cells using each point of unstructured grids and
+ * polydata are taken from vtkStaticCellLinks built for the occasion, so the
+ * input is not modified. By default all the cell data arrays are mapped;
+ * turn ProcessAllArrays off and list the arrays with AddCellDataArray() to
+ * map only some of them.
+ *
  * @warning
  * This filter is an abstract filter, that is, the output is an abstract type
  * (i.e., vtkDataSet). Use the convenience methods (e.g.,
@@ -43,7 +50,9 @@
 
 #include "vtkFiltersCoreModule.h" // For export macro
 #include "vtkDataSetAlgorithm.h"
+#include "vtkSmartPointer.h" // For GetCellDataToProcess
 
+class vtkCellData;
 class vtkDataSet;
 
 class VTKFILTERSCORE_EXPORT vtkCellDataToPointData : public vtkDataSetAlgorithm
@@ -80,9 +89,35 @@ public:
   vtkGetMacro(ContributingCellOption, int);
   //@}
 
+  //@{
+  /**
+   * Control whether all the cell data arrays are mapped to point data, or
+   * only the arrays listed with AddCellDataArray(). The arrays that are not
+   * processed are not present in the output point data. The default is on.
+   */
+  vtkSetMacro(ProcessAllArrays, int);
+  vtkGetMacro(ProcessAllArrays, int);
+  vtkBooleanMacro(ProcessAllArrays, int);
+  //@}
+
+  //@{
+  /**
+   * Add, remove or clear the names of the cell data arrays to map when
+   * ProcessAllArrays is off. Names that are not in the input are ignored.
+   */
+  void AddCellDataArray(const char *name);
+  void RemoveCellDataArray(const char *name);
+  void ClearCellDataArrays();
+  //@}
+
+  /**
+   * Return the number of cell data arrays listed with AddCellDataArray().
+   */
+  int GetNumberOfCellArraysToProcess();
+
 protected:
   vtkCellDataToPointData();
-  ~vtkCellDataToPointData() VTK_OVERRIDE {}
+  ~vtkCellDataToPointData() VTK_OVERRIDE;
 
   int RequestData(vtkInformation* request,
                   vtkInformationVector** inputVector,
@@ -97,7 +132,19 @@ protected:
     (vtkInformation*, vtkInformationVector**, vtkInformationVector*);
   //@}
 
-  void InterpolatePointData(vtkDataSet *input, vtkDataSet *output);
+  /**
+   * Average the cell data inCD of the cells using each point of input into
+   * the point data of output, for datasets that compute their point cells.
+   */
+  void InterpolatePointData(vtkDataSet *input, vtkDataSet *output,
+                            vtkCellData *inCD);
+
+  /**
+   * Return the cell data of input to map: the input cell data itself when
+   * ProcessAllArrays is on, otherwise a shallow copy holding only the
+   * listed arrays.
+   */
+  vtkSmartPointer<vtkCellData> GetCellDataToProcess(vtkDataSet *input);
 
   //@{
   /**
@@ -114,6 +161,11 @@ protected:
   int ContributingCellOption;
   //@}
 
+  int ProcessAllArrays;
+
+  class Internals;
+  Internals *Implementation;
+
 private:
   vtkCellDataToPointData(const vtkCellDataToPointData&) VTK_DELETE_FUNCTION;
   void operator=(const vtkCellDataToPointData&) VTK_DELETE_FUNCTION;
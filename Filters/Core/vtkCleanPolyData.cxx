@@ -16,15 +16,26 @@
 
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkIdList.h"
 #include "vtkMergePoints.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <vector>
+
 vtkStandardNewMacro(vtkCleanPolyData);
 
 //---------------------------------------------------------------------------
@@ -46,6 +57,7 @@ vtkCleanPolyData::vtkCleanPolyData()
   this->Locator = nullptr;
   this->PieceInvariant = 1;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->ThreadSafeOperateOnPoint = 1;
 }
 
 //--------------------------------------------------------------------------
@@ -113,482 +125,938 @@ int vtkCleanPolyData::RequestUpdateExtent(
   return 1;
 }
 
-//--------------------------------------------------------------------------
-int vtkCleanPolyData::RequestData(
-  vtkInformation *vtkNotUsed(request),
-  vtkInformationVector **inputVector,
-  vtkInformationVector *outputVector)
+namespace
 {
-  // get the info objects
-  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
-  vtkInformation *outInfo = outputVector->GetInformationObject(0);
 
-  // get the input and output
-  vtkPolyData *input = vtkPolyData::SafeDownCast(
-    inInfo->Get(vtkDataObject::DATA_OBJECT()));
-  vtkPolyData *output = vtkPolyData::SafeDownCast(
-    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+// The cells are counted, then copied, in batches of this many cells. The
+// points first used by a batch are numbered together.
+const vtkIdType vtkCleanBatchSize = 1024;
 
-  vtkPoints   *inPts = input->GetPoints();
-  vtkIdType   numPts = input->GetNumberOfPoints();
+// The kinds of cells, in the order of the polydata cell arrays.
+enum
+{
+  VTK_CLEAN_VERTS = 0,
+  VTK_CLEAN_LINES,
+  VTK_CLEAN_POLYS,
+  VTK_CLEAN_STRIPS,
+  VTK_CLEAN_KINDS
+};
 
-  vtkDebugMacro(<<"Beginning PolyData clean");
-  if ( (numPts<1) || (inPts == nullptr ) )
+//----------------------------------------------------------------------------
+// Renumber the points of a cell of the given kind and return the kind of
+// cell it becomes once its repeated points are removed, or -1 if it is
+// dropped. The new ids are written to newPts.
+struct vtkCleanConvertCell
+{
+  const vtkIdType *PointMap;
+  int ConvertLinesToPoints;
+  int ConvertPolysToLines;
+  int ConvertStripsToPolys;
+
+  int operator()(int kind, vtkIdType npts, const vtkIdType *pts,
+                 vtkIdType *newPts, vtkIdType &numNewPts) const
   {
-    vtkDebugMacro(<<"No data to Operate On!");
-    return 1;
+    numNewPts = 0;
+    for (vtkIdType i=0; i < npts; i++)
+    {
+      vtkIdType ptId = this->PointMap[pts[i]];
+      if ( kind == VTK_CLEAN_VERTS || numNewPts == 0 ||
+           ptId != newPts[numNewPts-1] )
+      {
+        newPts[numNewPts++] = ptId;
+      }
+    }
+
+    switch (kind)
+    {
+      case VTK_CLEAN_VERTS:
+        return numNewPts > 0 ? VTK_CLEAN_VERTS : -1;
+
+      case VTK_CLEAN_LINES:
+        // lines reduced to one point are eliminated or made into verts
+        if ( numNewPts > 1 || !this->ConvertLinesToPoints )
+        {
+          return VTK_CLEAN_LINES;
+        }
+        return numNewPts == 1 ? VTK_CLEAN_VERTS : -1;
+
+      case VTK_CLEAN_POLYS:
+        // polygons reduced to two points or less are either eliminated
+        // or converted to lines or points if enabled
+        if ( numNewPts > 2 && newPts[0] == newPts[numNewPts-1] )
+        {
+          numNewPts--;
+        }
+        if ( numNewPts > 2 || !this->ConvertPolysToLines )
+        {
+          return VTK_CLEAN_POLYS;
+        }
+        if ( numNewPts == 2 || !this->ConvertLinesToPoints )
+        {
+          return VTK_CLEAN_LINES;
+        }
+        return numNewPts == 1 ? VTK_CLEAN_VERTS : -1;
+
+      default:
+        // triangle strips can reduced to polys/lines/points etc
+        if ( numNewPts > 3 || !this->ConvertStripsToPolys )
+        {
+          return VTK_CLEAN_STRIPS;
+        }
+        if ( numNewPts == 3 || !this->ConvertPolysToLines )
+        {
+          return VTK_CLEAN_POLYS;
+        }
+        if ( numNewPts == 2 || !this->ConvertLinesToPoints )
+        {
+          return VTK_CLEAN_LINES;
+        }
+        return numNewPts == 1 ? VTK_CLEAN_VERTS : -1;
+    }
   }
-  vtkIdType *updatedPts = new vtkIdType[input->GetMaxCellSize()];
+};
 
-  vtkIdType numNewPts;
-  vtkIdType numUsedPts=0;
-  vtkPoints *newPts = inPts->NewInstance();
+//----------------------------------------------------------------------------
+// The input cells, split in batches of consecutive cells of the same cell
+// array. The batches follow the polydata cell ids: verts, lines, polys then
+// strips. Their cells are read with a vtkCleanCellCursor, which unlike
+// vtkPolyData::GetCellPoints() does not need the cells to be built.
+struct vtkCleanBatches
+{
+  vtkCellArray *Cells[VTK_CLEAN_KINDS];
+  // The polydata id of the first cell, and the first batch, of each array.
+  vtkIdType FirstCellIds[VTK_CLEAN_KINDS + 1];
+  vtkIdType FirstBatches[VTK_CLEAN_KINDS + 1];
+  // The location of the first cell of each batch in legacy storage.
+  std::vector<vtkIdType> Locations;
 
-  // Set the desired precision for the points in the output.
-  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  void Initialize(vtkPolyData *input)
   {
-    newPts->SetDataType(inPts->GetDataType());
+    this->Cells[VTK_CLEAN_VERTS] = input->GetVerts();
+    this->Cells[VTK_CLEAN_LINES] = input->GetLines();
+    this->Cells[VTK_CLEAN_POLYS] = input->GetPolys();
+    this->Cells[VTK_CLEAN_STRIPS] = input->GetStrips();
+    this->FirstCellIds[0] = this->FirstBatches[0] = 0;
+    for (int kind=0; kind < VTK_CLEAN_KINDS; kind++)
+    {
+      vtkIdType numCells = this->Cells[kind]->GetNumberOfCells();
+      this->FirstCellIds[kind+1] = this->FirstCellIds[kind] + numCells;
+      this->FirstBatches[kind+1] = this->FirstBatches[kind] +
+        (numCells + vtkCleanBatchSize - 1) / vtkCleanBatchSize;
+    }
+
+    this->Locations.resize(this->FirstBatches[VTK_CLEAN_KINDS]);
+    for (int kind=0; kind < VTK_CLEAN_KINDS; kind++)
+    {
+      vtkCellArray *cells = this->Cells[kind];
+      if ( cells->GetStorage() != vtkCellArray::LEGACY_STORAGE )
+      {
+        continue;
+      }
+      const vtkIdType *legacy = cells->GetPointer();
+      vtkIdType *locations = &this->Locations[this->FirstBatches[kind]];
+      vtkIdType loc = 0;
+      for (vtkIdType cellId=0; cellId < cells->GetNumberOfCells(); cellId++)
+      {
+        if ( cellId % vtkCleanBatchSize == 0 )
+        {
+          *locations++ = loc;
+        }
+        loc += legacy[loc] + 1;
+      }
+    }
   }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+
+  vtkIdType GetNumberOfBatches() const
   {
-    newPts->SetDataType(VTK_FLOAT);
+    return this->FirstBatches[VTK_CLEAN_KINDS];
   }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+
+  // The batch holding a cell.
+  vtkIdType GetBatch(vtkIdType cellId) const
   {
-    newPts->SetDataType(VTK_DOUBLE);
+    int kind = VTK_CLEAN_VERTS;
+    while ( cellId >= this->FirstCellIds[kind+1] )
+    {
+      kind++;
+    }
+    return this->FirstBatches[kind] +
+      (cellId - this->FirstCellIds[kind]) / vtkCleanBatchSize;
   }
+};
 
-  newPts->Allocate(numPts);
-
-  // we'll be needing these
-  vtkIdType inCellID, newId;
-  int i;
-  vtkIdType ptId;
-  vtkIdType npts = 0;
-  vtkIdType *pts = nullptr;
-  double x[3];
-  double newx[3];
-  vtkIdType *pointMap=nullptr; //used if no merging
-
-  vtkCellArray *inVerts  = input->GetVerts(),  *newVerts  = nullptr;
-  vtkCellArray *inLines  = input->GetLines(),  *newLines  = nullptr;
-  vtkCellArray *inPolys  = input->GetPolys(),  *newPolys  = nullptr;
-  vtkCellArray *inStrips = input->GetStrips(), *newStrips = nullptr;
+//----------------------------------------------------------------------------
+// Traverse the cells of a batch. Several cursors can run at once on
+// different threads, each with its own buffer.
+class vtkCleanCellCursor
+{
+public:
+  vtkCleanCellCursor(const vtkCleanBatches *batches, vtkIdType batch,
+                     vtkIdList *buffer) : Buffer(buffer)
+  {
+    this->Kind = VTK_CLEAN_VERTS;
+    while ( batch >= batches->FirstBatches[this->Kind+1] )
+    {
+      this->Kind++;
+    }
+    this->Cells = batches->Cells[this->Kind];
+    this->Storage = this->Cells->GetStorage();
+    this->Legacy = this->Storage == vtkCellArray::LEGACY_STORAGE ?
+      this->Cells->GetPointer() : nullptr;
+    vtkIdType first =
+      (batch - batches->FirstBatches[this->Kind]) * vtkCleanBatchSize;
+    this->CellId = batches->FirstCellIds[this->Kind] + first;
+    this->EndCellId = std::min(this->CellId + vtkCleanBatchSize,
+                               batches->FirstCellIds[this->Kind+1]);
+    this->Location = this->Legacy ? batches->Locations[batch] : first;
+  }
 
-  vtkPointData *inputPD = input->GetPointData();
-  vtkCellData  *inputCD = input->GetCellData();
+  // The cell array of the batch.
+  int GetKind() const { return this->Kind; }
 
-  // We must be careful to 'operate' on the bounds of the locator so
-  // that all inserted points lie inside it
-  if ( this->PointMerging )
+  // Get the next cell of the batch, or return false at the end.
+  bool Next(vtkIdType& cellId, vtkIdType& npts, const vtkIdType *&pts)
   {
-    this->CreateDefaultLocator(input);
-    if (this->ToleranceIsAbsolute)
+    if ( this->CellId >= this->EndCellId )
+    {
+      return false;
+    }
+    if ( this->Legacy )
+    {
+      npts = this->Legacy[this->Location];
+      pts = this->Legacy + this->Location + 1;
+      this->Location += npts + 1;
+    }
+    else if ( this->Storage == vtkCellArray::OFFSETS_STORAGE )
     {
-      this->Locator->SetTolerance(this->AbsoluteTolerance);
+      vtkIdType *cellPts;
+      this->Cells->GetCellAtId(this->Location++, npts, cellPts);
+      pts = cellPts;
     }
     else
     {
-      this->Locator->SetTolerance(this->Tolerance*input->GetLength());
+      // 32-bit ids are copied, GetCellAtId() would convert the array
+      this->Cells->GetCellAtId(this->Location++, this->Buffer);
+      npts = this->Buffer->GetNumberOfIds();
+      pts = this->Buffer->GetPointer(0);
     }
-    double originalbounds[6], mappedbounds[6];
-    input->GetBounds(originalbounds);
-    this->OperateOnBounds(originalbounds,mappedbounds);
-    this->Locator->InitPointInsertion(newPts, mappedbounds);
+    cellId = this->CellId++;
+    return true;
   }
-  else
+
+private:
+  vtkIdList *Buffer;
+  int Kind;
+  vtkCellArray *Cells;
+  int Storage;
+  const vtkIdType *Legacy;
+  vtkIdType CellId;
+  vtkIdType EndCellId;
+  vtkIdType Location;
+};
+
+//----------------------------------------------------------------------------
+inline void vtkCleanAtomicMin(std::atomic<vtkIdType>& value,
+                              vtkIdType candidate)
+{
+  vtkIdType current = value.load(std::memory_order_relaxed);
+  while (candidate < current &&
+         !value.compare_exchange_weak(current, candidate,
+                                      std::memory_order_relaxed))
   {
-    pointMap = new vtkIdType [numPts];
-    for (i=0; i < numPts; i++)
-    {
-      pointMap[i] = -1; //initialize unused
-    }
   }
+}
 
-  vtkPointData *outputPD = output->GetPointData();
-  vtkCellData  *outputCD = output->GetCellData();
-  outputPD->CopyAllocate(inputPD);
-  outputCD->CopyAllocate(inputCD);
-
-  // Celldata needs to be copied correctly. If a poly is converted to
-  // a line, or a line to a point, then using a CellCounter will not
-  // do, as the cells should be ordered verts, lines, polys,
-  // strips. We need to maintain separate cell data lists so we can
-  // copy them all correctly. Tedious but easy to implement. We can
-  // use outputCD for vertex cell data, then add the rest at the end.
-  vtkCellData  *outLineData = nullptr;
-  vtkCellData  *outPolyData = nullptr;
-  vtkCellData  *outStrpData = nullptr;
-  vtkIdType vertIDcounter = 0, lineIDcounter = 0;
-  vtkIdType polyIDcounter = 0, strpIDcounter = 0;
-
-  // Begin to adjust topology.
-  //
-  // Vertices are renumbered and we remove duplicates
-  inCellID = 0;
-  if ( !this->GetAbortExecute() && inVerts->GetNumberOfCells() > 0 )
-  {
-    newVerts = vtkCellArray::New();
-    newVerts->Allocate(inVerts->GetSize());
-
-    vtkDebugMacro(<<"Starting Verts "<<inCellID);
-    for (inVerts->InitTraversal(); inVerts->GetNextCell(npts,pts);
-         inCellID++)
-    {
-      for ( numNewPts=0, i=0; i < npts; i++ )
-      {
-        inPts->GetPoint(pts[i],x);
-        this->OperateOnPoint(x, newx);
-        if ( ! this->PointMerging )
-        {
-          if ( (ptId=pointMap[pts[i]]) == -1 )
-          {
-            pointMap[pts[i]] = ptId = numUsedPts++;
-            newPts->SetPoint(ptId,newx);
-            outputPD->CopyData(inputPD,pts[i],ptId);
-          }
-        }
-        else if ( this->Locator->InsertUniquePoint(newx, ptId) )
-        {
-          outputPD->CopyData(inputPD,pts[i],ptId);
-        }
-        updatedPts[numNewPts++] = ptId;
-      }//for all points of vertex cell
+//----------------------------------------------------------------------------
+// Find the first cell using each point.
+struct vtkCleanFirstUses
+{
+  const vtkCleanBatches *Batches;
+  std::atomic<vtkIdType> *FirstCells;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
 
-      if ( numNewPts > 0 )
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType cellId, npts;
+    const vtkIdType *pts;
+    for ( ; batch < endBatch; batch++)
+    {
+      vtkCleanCellCursor cursor(this->Batches, batch, cellPts);
+      while ( cursor.Next(cellId, npts, pts) )
       {
-        newId = newVerts->InsertNextCell(numNewPts,updatedPts);
-        outputCD->CopyData(inputCD, inCellID, newId);
-        if ( vertIDcounter != newId)
+        for (vtkIdType i=0; i < npts; i++)
         {
-          vtkErrorMacro(<<"Vertex ID fault in vertex test");
+          vtkCleanAtomicMin(this->FirstCells[pts[i]], cellId);
         }
-        vertIDcounter++;
       }
     }
   }
-  this->UpdateProgress(0.25);
+};
+
+//----------------------------------------------------------------------------
+// Number the points in the order the cells first use them, within each
+// batch of cells. Only the batch holding the first cell of a point writes
+// its rank.
+struct vtkCleanRankPoints
+{
+  const vtkCleanBatches *Batches;
+  const std::atomic<vtkIdType> *FirstCells;
+  vtkIdType *Ranks;
+  vtkIdType *BatchCounts;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
 
-  // lines reduced to one point are eliminated or made into verts
-  if ( !this->GetAbortExecute() && inLines->GetNumberOfCells() > 0 )
+  void operator()(vtkIdType batch, vtkIdType endBatch)
   {
-    newLines = vtkCellArray::New();
-    newLines->Allocate(inLines->GetSize());
-    outLineData = vtkCellData::New();
-    outLineData->CopyAllocate(inputCD);
-    //
-    vtkDebugMacro(<<"Starting Lines "<<inCellID);
-    for (inLines->InitTraversal(); inLines->GetNextCell(npts,pts); inCellID++)
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType cellId, npts;
+    const vtkIdType *pts;
+    for ( ; batch < endBatch; batch++)
     {
-      for ( numNewPts=0, i=0; i<npts; i++ )
+      vtkIdType count = 0;
+      vtkCleanCellCursor cursor(this->Batches, batch, cellPts);
+      while ( cursor.Next(cellId, npts, pts) )
       {
-        inPts->GetPoint(pts[i],x);
-        this->OperateOnPoint(x, newx);
-        if ( ! this->PointMerging )
+        for (vtkIdType i=0; i < npts; i++)
         {
-          if ( (ptId=pointMap[pts[i]]) == -1 )
+          vtkIdType ptId = pts[i];
+          if ( this->FirstCells[ptId].load(std::memory_order_relaxed) ==
+               cellId && this->Ranks[ptId] < 0 )
           {
-            pointMap[pts[i]] = ptId = numUsedPts++;
-            newPts->SetPoint(ptId,newx);
-            outputPD->CopyData(inputPD,pts[i],ptId);
+            this->Ranks[ptId] = count++;
           }
         }
-        else if ( this->Locator->InsertUniquePoint(newx, ptId) )
-        {
-          outputPD->CopyData(inputPD,pts[i],ptId);
-        }
-        if ( i == 0 || ptId != updatedPts[numNewPts-1] )
-        {
-          updatedPts[numNewPts++] = ptId;
-        }
-      }//for all cell points
-      if ( (numNewPts>1) || !this->ConvertLinesToPoints )
-      {
-        newId = newLines->InsertNextCell(numNewPts,updatedPts);
-        outLineData->CopyData(inputCD, inCellID, newId);
-        if (lineIDcounter!=newId)
-        {
-          vtkErrorMacro(<<"Line ID fault in line test");
-        }
-        lineIDcounter++;
       }
-      else if ( numNewPts==1 )
+      this->BatchCounts[batch] = count;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Offset the ranks of the points by the points first used by the previous
+// batches, and list the used points in order.
+struct vtkCleanOrderPoints
+{
+  const vtkCleanBatches *Batches;
+  const std::atomic<vtkIdType> *FirstCells;
+  const vtkIdType *BatchOffsets;
+  vtkIdType *Ranks;
+  vtkIdType *Order;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ptId++)
+    {
+      if ( this->Ranks[ptId] >= 0 )
       {
-        if (!newVerts)
-        {
-          newVerts = vtkCellArray::New();
-          newVerts->Allocate(5);
-        }
-        newId = newVerts->InsertNextCell(numNewPts,updatedPts);
-        outputCD->CopyData(inputCD, inCellID, newId);
-        if (vertIDcounter!=newId)
-        {
-          vtkErrorMacro(<<"Vertex ID fault in line test");
-        }
-        vertIDcounter++;
+        vtkIdType cellId =
+          this->FirstCells[ptId].load(std::memory_order_relaxed);
+        this->Ranks[ptId] +=
+          this->BatchOffsets[this->Batches->GetBatch(cellId)];
+        this->Order[this->Ranks[ptId]] = ptId;
       }
     }
-    vtkDebugMacro(<<"Removed "
-             << inLines->GetNumberOfCells() - newLines->GetNumberOfCells()
-             << " lines");
   }
-  this->UpdateProgress(0.50);
+};
 
-  // polygons reduced to two points or less are either eliminated
-  // or converted to lines or points if enabled
-  if ( !this->GetAbortExecute() && inPolys->GetNumberOfCells() > 0 )
+//----------------------------------------------------------------------------
+// Apply OperateOnPoint() to the used points, in order.
+struct vtkCleanOperateOnPoints
+{
+  vtkCleanPolyData *Filter;
+  vtkPoints *InPts;
+  const vtkIdType *Order;
+  vtkPoints *NewPts;
+
+  void operator()(vtkIdType rank, vtkIdType endRank)
   {
-    newPolys = vtkCellArray::New();
-    newPolys->Allocate(inPolys->GetSize());
-    outPolyData = vtkCellData::New();
-    outPolyData->CopyAllocate(inputCD);
+    double x[3], newx[3];
+    for ( ; rank < endRank; rank++)
+    {
+      this->InPts->GetPoint(this->Order[rank], x);
+      this->Filter->OperateOnPoint(x, newx);
+      this->NewPts->SetPoint(rank, newx);
+    }
+  }
+};
 
-    vtkDebugMacro(<<"Starting Polys "<<inCellID);
-    for (inPolys->InitTraversal(); inPolys->GetNextCell(npts,pts); inCellID++)
+//----------------------------------------------------------------------------
+// Find the first point, in order, within the tolerance of each point. It
+// is the point itself when no earlier point is that close.
+struct vtkCleanFindEarliest
+{
+  vtkStaticPointLocator *Locator;
+  vtkPoints *Points;
+  double Tolerance;
+  vtkIdType *Earliest;
+  vtkSMPThreadLocalObject<vtkIdList> Neighbors;
+
+  void operator()(vtkIdType rank, vtkIdType endRank)
+  {
+    vtkIdList *neighbors = this->Neighbors.Local();
+    double x[3];
+    for ( ; rank < endRank; rank++)
     {
-      for ( numNewPts=0, i=0; i<npts; i++ )
+      this->Points->GetPoint(rank, x);
+      this->Locator->FindPointsWithinRadius(this->Tolerance, x, neighbors);
+      vtkIdType earliest = rank;
+      for (vtkIdType i=0; i < neighbors->GetNumberOfIds(); i++)
       {
-        inPts->GetPoint(pts[i],x);
-        this->OperateOnPoint(x, newx);
-        if ( ! this->PointMerging )
-        {
-          if ( (ptId=pointMap[pts[i]]) == -1 )
-          {
-            pointMap[pts[i]] = ptId = numUsedPts++;
-            newPts->SetPoint(ptId,newx);
-            outputPD->CopyData(inputPD,pts[i],ptId);
-          }
-        }
-        else if ( this->Locator->InsertUniquePoint(newx, ptId) )
-        {
-          outputPD->CopyData(inputPD,pts[i],ptId);
-        }
-        if ( i == 0 || ptId != updatedPts[numNewPts-1] )
-        {
-          updatedPts[numNewPts++] = ptId;
-        }
-      } //for points in cell
-      if ( numNewPts>2 && updatedPts[0] == updatedPts[numNewPts-1] )
-      {
-        numNewPts--;
-      }
-      if ( (numNewPts > 2) || !this->ConvertPolysToLines )
-      {
-        newId = newPolys->InsertNextCell(numNewPts,updatedPts);
-        outPolyData->CopyData(inputCD, inCellID, newId);
-        if (polyIDcounter!=newId)
-        {
-          vtkErrorMacro(<<"Poly ID fault in poly test");
-        }
-        polyIDcounter++;
-      }
-      else if ( (numNewPts==2) || !this->ConvertLinesToPoints )
-      {
-        if (!newLines)
-        {
-          newLines = vtkCellArray::New();
-          newLines->Allocate(5);
-          outLineData = vtkCellData::New();
-          outLineData->CopyAllocate(inputCD);
-        }
-        newId = newLines->InsertNextCell(numNewPts,updatedPts);
-        outLineData->CopyData(inputCD, inCellID, newId);
-        if (lineIDcounter!=newId)
-        {
-          vtkErrorMacro(<<"Line ID fault in poly test");
-        }
-        lineIDcounter++;
-      }
-      else if ( numNewPts==1 )
-      {
-        if (!newVerts)
-        {
-          newVerts = vtkCellArray::New();
-          newVerts->Allocate(5);
-        }
-        newId = newVerts->InsertNextCell(numNewPts,updatedPts);
-        outputCD->CopyData(inputCD, inCellID, newId);
-        if (vertIDcounter!=newId)
-        {
-          vtkErrorMacro(<<"Vertex ID fault in poly test");
-        }
-        vertIDcounter++;
+        earliest = std::min(earliest, neighbors->GetId(i));
       }
+      this->Earliest[rank] = earliest;
     }
-    vtkDebugMacro(<<"Removed "
-           << inPolys->GetNumberOfCells() - newPolys->GetNumberOfCells()
-           << " polys");
   }
-  this->UpdateProgress(0.75);
+};
 
-  // triangle strips can reduced to polys/lines/points etc
-  if ( !this->GetAbortExecute() && inStrips->GetNumberOfCells() > 0 )
+//----------------------------------------------------------------------------
+// A point is merged into the first kept point within the tolerance, and
+// kept if there is none. Decide the points for which this only depends on
+// their earliest neighbor: a point that has no earlier neighbor is kept. The
+// others are left at -1.
+struct vtkCleanMergeEarliest
+{
+  const vtkIdType *Earliest;
+  vtkIdType *Merged;
+
+  void operator()(vtkIdType rank, vtkIdType endRank)
   {
-    newStrips = vtkCellArray::New();
-    newStrips->Allocate(inStrips->GetSize());
-    outStrpData = vtkCellData::New();
-    outStrpData->CopyAllocate(inputCD);
+    for ( ; rank < endRank; rank++)
+    {
+      vtkIdType earliest = this->Earliest[rank];
+      this->Merged[rank] = this->Earliest[earliest] == earliest ?
+        earliest : -1;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Flag the kept points.
+struct vtkCleanFlagKept
+{
+  const vtkIdType *Merged;
+  vtkIdType *NewIds;
 
-    for (inStrips->InitTraversal(); inStrips->GetNextCell(npts,pts);
-         inCellID++)
+  void operator()(vtkIdType rank, vtkIdType endRank)
+  {
+    for ( ; rank < endRank; rank++)
     {
-      for ( numNewPts=0, i=0; i < npts; i++ )
-      {
-        inPts->GetPoint(pts[i],x);
-        this->OperateOnPoint(x, newx);
-        if ( ! this->PointMerging )
-        {
-          if ( (ptId=pointMap[pts[i]]) == -1 )
-          {
-            pointMap[pts[i]] = ptId = numUsedPts++;
-            newPts->SetPoint(ptId,newx);
-            outputPD->CopyData(inputPD,pts[i],ptId);
-          }
-        }
-        else if ( this->Locator->InsertUniquePoint(newx, ptId) )
-        {
-          outputPD->CopyData(inputPD,pts[i],ptId);
-        }
-        if ( i == 0 || ptId != updatedPts[numNewPts-1] )
-        {
-          updatedPts[numNewPts++] = ptId;
-        }
-      }
-      if ( (numNewPts > 3) || !this->ConvertStripsToPolys )
+      this->NewIds[rank] = this->Merged[rank] == rank ? 1 : 0;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the kept points and list the input points they come from.
+struct vtkCleanCopyKept
+{
+  const vtkIdType *Merged;
+  const vtkIdType *NewIds;
+  const vtkIdType *Order;
+  vtkPoints *Candidates;
+  vtkPoints *NewPts;
+  vtkIdType *Sources;
+
+  void operator()(vtkIdType rank, vtkIdType endRank)
+  {
+    double x[3];
+    for ( ; rank < endRank; rank++)
+    {
+      if ( this->Merged[rank] == rank )
       {
-        newId = newStrips->InsertNextCell(numNewPts,updatedPts);
-        outStrpData->CopyData(inputCD, inCellID, newId);
-        if (strpIDcounter!=newId)
-        {
-          vtkErrorMacro(<<"Strip ID fault in strip test");
-        }
-        strpIDcounter++;
+        vtkIdType newId = this->NewIds[rank];
+        this->Candidates->GetPoint(rank, x);
+        this->NewPts->SetPoint(newId, x);
+        this->Sources[newId] = this->Order[rank];
       }
-      else if ( (numNewPts==3) || !this->ConvertPolysToLines )
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Map the used input points to the output points they are merged into.
+struct vtkCleanMapPoints
+{
+  const vtkIdType *Ranks;
+  const vtkIdType *Merged;
+  const vtkIdType *NewIds;
+  vtkIdType *PointMap;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ptId++)
+    {
+      vtkIdType rank = this->Ranks[ptId];
+      this->PointMap[ptId] =
+        rank < 0 ? -1 : this->NewIds[this->Merged[rank]];
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the point data of the output points.
+struct vtkCleanCopyPointData
+{
+  const vtkIdType *Sources;
+  vtkPointData *InPD;
+  vtkPointData *OutPD;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    this->OutPD->GatherData(this->InPD, this->Sources + ptId, ptId,
+                            endPtId - ptId);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Count the output cells of each kind and their points, per batch.
+struct vtkCleanCountCells
+{
+  const vtkCleanBatches *Batches;
+  vtkCleanConvertCell Convert;
+  vtkIdType *BatchCells;
+  vtkIdType *BatchIds;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > NewPts;
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    std::vector<vtkIdType>& newPts = this->NewPts.Local();
+    vtkIdType cellId, npts, numNewPts;
+    const vtkIdType *pts;
+    for ( ; batch < endBatch; batch++)
+    {
+      vtkIdType *cells = this->BatchCells + batch * VTK_CLEAN_KINDS;
+      vtkIdType *ids = this->BatchIds + batch * VTK_CLEAN_KINDS;
+      std::fill_n(cells, VTK_CLEAN_KINDS, 0);
+      std::fill_n(ids, VTK_CLEAN_KINDS, 0);
+      vtkCleanCellCursor cursor(this->Batches, batch, cellPts);
+      while ( cursor.Next(cellId, npts, pts) )
       {
-        if (!newPolys)
+        if ( newPts.size() < static_cast<size_t>(npts) )
         {
-          newPolys = vtkCellArray::New();
-          newPolys->Allocate(5);
-          outPolyData = vtkCellData::New();
-          outPolyData->CopyAllocate(inputCD);
+          newPts.resize(npts);
         }
-        newId = newPolys->InsertNextCell(numNewPts,updatedPts);
-        outPolyData->CopyData(inputCD, inCellID, newId);
-        if (polyIDcounter!=newId)
+        int kind = this->Convert(cursor.GetKind(), npts, pts, newPts.data(),
+                                 numNewPts);
+        if ( kind >= 0 )
         {
-          vtkErrorMacro(<<"Poly ID fault in strip test");
+          cells[kind]++;
+          ids[kind] += numNewPts;
         }
-        polyIDcounter++;
       }
-      else if ( (numNewPts==2) || !this->ConvertLinesToPoints )
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Write the output cells of each batch where the counts put them.
+struct vtkCleanCopyCells
+{
+  const vtkCleanBatches *Batches;
+  vtkCleanConvertCell Convert;
+  const vtkIdType *BatchCells;
+  const vtkIdType *BatchIds;
+  vtkIdType *Connectivity[VTK_CLEAN_KINDS];
+  vtkIdType FirstCells[VTK_CLEAN_KINDS];
+  vtkIdType *OldCellIds;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > NewPts;
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    std::vector<vtkIdType>& newPts = this->NewPts.Local();
+    vtkIdType cellId, npts, numNewPts;
+    const vtkIdType *pts;
+    for ( ; batch < endBatch; batch++)
+    {
+      const vtkIdType *cells = this->BatchCells + batch * VTK_CLEAN_KINDS;
+      const vtkIdType *ids = this->BatchIds + batch * VTK_CLEAN_KINDS;
+      vtkIdType newCellIds[VTK_CLEAN_KINDS];
+      vtkIdType *conn[VTK_CLEAN_KINDS];
+      for (int kind=0; kind < VTK_CLEAN_KINDS; kind++)
       {
-        if (!newLines)
-        {
-          newLines = vtkCellArray::New();
-          newLines->Allocate(5);
-          outLineData = vtkCellData::New();
-          outLineData->CopyAllocate(inputCD);
-        }
-        newId = newLines->InsertNextCell(numNewPts,updatedPts);
-        outLineData->CopyData(inputCD, inCellID, newId);
-        if (lineIDcounter!=newId)
-        {
-          vtkErrorMacro(<<"Line ID fault in strip test");
-        }
-        lineIDcounter++;
+        newCellIds[kind] = this->FirstCells[kind] + cells[kind];
+        conn[kind] = this->Connectivity[kind] + cells[kind] + ids[kind];
       }
-      else if ( numNewPts==1 )
+      vtkCleanCellCursor cursor(this->Batches, batch, cellPts);
+      while ( cursor.Next(cellId, npts, pts) )
       {
-        if (!newVerts)
+        if ( newPts.size() < static_cast<size_t>(npts) )
         {
-          newVerts = vtkCellArray::New();
-          newVerts->Allocate(5);
+          newPts.resize(npts);
         }
-        newId = newVerts->InsertNextCell(numNewPts,updatedPts);
-        outputCD->CopyData(inputCD, inCellID, newId);
-        if (vertIDcounter!=newId)
+        int kind = this->Convert(cursor.GetKind(), npts, pts, newPts.data(),
+                                 numNewPts);
+        if ( kind >= 0 )
         {
-          vtkErrorMacro(<<"Vertex ID fault in strip test");
+          *conn[kind]++ = numNewPts;
+          conn[kind] = std::copy(newPts.data(), newPts.data() + numNewPts,
+                                 conn[kind]);
+          this->OldCellIds[newCellIds[kind]++] = cellId;
         }
-        vertIDcounter++;
       }
     }
-    vtkDebugMacro(<<"Removed "
-              << inStrips->GetNumberOfCells() - newStrips->GetNumberOfCells()
-              << " strips");
   }
+};
 
-  vtkDebugMacro(<<"Removed "
-                << numPts - newPts->GetNumberOfPoints() << " points");
+//----------------------------------------------------------------------------
+// Copy the cell data of the output cells.
+struct vtkCleanCopyCellData
+{
+  const vtkIdType *OldCellIds;
+  vtkCellData *InCD;
+  vtkCellData *OutCD;
 
-  // Update ourselves and release memory
-  //
-  delete [] updatedPts;
-  if ( this->PointMerging )
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
   {
-    this->Locator->Initialize(); //release memory.
+    this->OutCD->GatherData(this->InCD, this->OldCellIds + cellId, cellId,
+                            endCellId - cellId);
   }
-  else
+};
+
+} // end anon namespace
+
+//--------------------------------------------------------------------------
+int vtkCleanPolyData::RequestData(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  // get the info objects
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+
+  // get the input and output
+  vtkPolyData *input = vtkPolyData::SafeDownCast(
+    inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkPolyData *output = vtkPolyData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  vtkPoints   *inPts = input->GetPoints();
+  vtkIdType   numPts = input->GetNumberOfPoints();
+
+  vtkDebugMacro(<<"Beginning PolyData clean");
+  if ( (numPts<1) || (inPts == nullptr ) )
   {
-    newPts->SetNumberOfPoints(numUsedPts);
-    delete [] pointMap;
+    vtkDebugMacro(<<"No data to Operate On!");
+    return 1;
   }
 
-  // Now transfer all CellData from Lines/Polys/Strips into final
-  // Cell data output
-  int CombinedCellID = vertIDcounter;
-  if (newLines)
+  vtkPoints *newPts = inPts->NewInstance();
+
+  // Set the desired precision for the points in the output.
+  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
   {
-    for (i=0; i<lineIDcounter; i++, CombinedCellID++)
+    newPts->SetDataType(inPts->GetDataType());
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
+
+  vtkPointData *inputPD = input->GetPointData();
+  vtkCellData  *inputCD = input->GetCellData();
+  vtkPointData *outputPD = output->GetPointData();
+  vtkCellData  *outputCD = output->GetCellData();
+
+  // The cells are processed in batches, from several threads.
+  vtkCleanBatches batches;
+  batches.Initialize(input);
+  vtkIdType numCells = batches.FirstCellIds[VTK_CLEAN_KINDS];
+  vtkIdType numBatches = batches.GetNumberOfBatches();
+
+  // Number the used points in the order the cells first use them, which is
+  // the order they are met in when the cells are traversed one after the
+  // other. ranks holds the number of each input point, or -1 if it is not
+  // used, and order lists the used points.
+  std::vector<vtkIdType> ranks(numPts, -1);
+  std::vector<vtkIdType> order;
+  {
+    std::atomic<vtkIdType> *firstCells = new std::atomic<vtkIdType>[numPts];
+    vtkSMPTools::Fill(firstCells, firstCells + numPts,
+                      vtkIdType(VTK_ID_MAX));
+    vtkCleanFirstUses firstUses;
+    firstUses.Batches = &batches;
+    firstUses.FirstCells = firstCells;
+    vtkSMPTools::For(0, numBatches, firstUses);
+
+    std::vector<vtkIdType> batchOffsets(numBatches);
+    vtkCleanRankPoints rankPoints;
+    rankPoints.Batches = &batches;
+    rankPoints.FirstCells = firstCells;
+    rankPoints.Ranks = ranks.data();
+    rankPoints.BatchCounts = batchOffsets.data();
+    vtkSMPTools::For(0, numBatches, rankPoints);
+    vtkIdType numUsedPts = vtkSMPTools::ExclusiveScan(
+      batchOffsets.begin(), batchOffsets.end(), batchOffsets.begin(),
+      vtkIdType(0));
+
+    order.resize(numUsedPts);
+    vtkCleanOrderPoints orderPoints;
+    orderPoints.Batches = &batches;
+    orderPoints.FirstCells = firstCells;
+    orderPoints.BatchOffsets = batchOffsets.data();
+    orderPoints.Ranks = ranks.data();
+    orderPoints.Order = order.data();
+    vtkSMPTools::For(0, numPts, orderPoints);
+    delete [] firstCells;
+  }
+  vtkIdType numUsedPts = static_cast<vtkIdType>(order.size());
+  this->UpdateProgress(0.25);
+
+  // Map the input points to the output points.
+  std::vector<vtkIdType> pointMap(numPts);
+  if ( this->PointMerging && this->Locator )
+  {
+    // Insert the points into the locator in order, one at a time. A
+    // vtkMergePoints is replaced if the tolerance is not 0.
+    this->CreateDefaultLocator(input);
+    double tol = this->ToleranceIsAbsolute ? this->AbsoluteTolerance :
+      this->Tolerance*input->GetLength();
+    this->Locator->SetTolerance(tol);
+
+    // We must be careful to 'operate' on the bounds of the locator so
+    // that all inserted points lie inside it
+    double originalbounds[6], mappedbounds[6];
+    input->GetBounds(originalbounds);
+    this->OperateOnBounds(originalbounds,mappedbounds);
+    newPts->Allocate(numUsedPts);
+    this->Locator->InitPointInsertion(newPts, mappedbounds);
+    outputPD->CopyAllocate(inputPD);
+
+    std::fill(pointMap.begin(), pointMap.end(), -1);
+    double x[3], newx[3];
+    vtkIdType ptId;
+    for (vtkIdType rank=0; rank < numUsedPts; rank++)
     {
-      outputCD->CopyData(outLineData, i, CombinedCellID);
+      inPts->GetPoint(order[rank], x);
+      this->OperateOnPoint(x, newx);
+      if ( this->Locator->InsertUniquePoint(newx, ptId) )
+      {
+        outputPD->CopyData(inputPD, order[rank], ptId);
+      }
+      pointMap[order[rank]] = ptId;
     }
-    outLineData->Delete();
+    this->Locator->Initialize(); //release memory.
+  }
+  else
+  {
+    // Apply OperateOnPoint() to the used points, in parallel if it is
+    // thread safe.
+    vtkPoints *candidates = newPts->NewInstance();
+    candidates->SetDataType(newPts->GetDataType());
+    candidates->SetNumberOfPoints(numUsedPts);
+    vtkCleanOperateOnPoints operate;
+    operate.Filter = this;
+    operate.InPts = inPts;
+    operate.Order = order.data();
+    operate.NewPts = candidates;
+    if ( this->ThreadSafeOperateOnPoint )
+    {
+      vtkSMPTools::For(0, numUsedPts, operate);
+    }
+    else
+    {
+      operate(0, numUsedPts);
+    }
+
+    // merged gives the point each used point is merged into; without
+    // merging each point is kept.
+    std::vector<vtkIdType> merged(numUsedPts);
+    if ( this->PointMerging && numUsedPts > 0 )
+    {
+      double tol = this->ToleranceIsAbsolute ? this->AbsoluteTolerance :
+        this->Tolerance*input->GetLength();
+
+      // Bin the points and find, for each one, the first point within the
+      // tolerance. With a zero tolerance these are the points with the
+      // same coordinates.
+      vtkNew<vtkPolyData> candidateSet;
+      candidateSet->SetPoints(candidates);
+      vtkNew<vtkStaticPointLocator> locator;
+      locator->SetDataSet(candidateSet.GetPointer());
+      locator->BuildLocator();
+      std::vector<vtkIdType> earliest(numUsedPts);
+      vtkCleanFindEarliest findEarliest;
+      findEarliest.Locator = locator.GetPointer();
+      findEarliest.Points = candidates;
+      findEarliest.Tolerance = tol;
+      findEarliest.Earliest = earliest.data();
+      vtkSMPTools::For(0, numUsedPts, findEarliest);
+
+      vtkCleanMergeEarliest mergeEarliest;
+      mergeEarliest.Earliest = earliest.data();
+      mergeEarliest.Merged = merged.data();
+      vtkSMPTools::For(0, numUsedPts, mergeEarliest);
+
+      // The points whose earliest neighbor is itself merged into another
+      // point are decided in order, once the points before them are. This
+      // only happens when the tolerance is not zero.
+      vtkNew<vtkIdList> neighbors;
+      double x[3];
+      for (vtkIdType rank=0; rank < numUsedPts; rank++)
+      {
+        if ( merged[rank] >= 0 )
+        {
+          continue;
+        }
+        candidates->GetPoint(rank, x);
+        locator->FindPointsWithinRadius(tol, x, neighbors.GetPointer());
+        vtkIdType keptId = rank;
+        for (vtkIdType i=0; i < neighbors->GetNumberOfIds(); i++)
+        {
+          vtkIdType id = neighbors->GetId(i);
+          if ( id < keptId && merged[id] == id )
+          {
+            keptId = id;
+          }
+        }
+        merged[rank] = keptId;
+      }
+    }
+    else
+    {
+      std::iota(merged.begin(), merged.end(), vtkIdType(0));
+    }
+    this->UpdateProgress(0.50);
+
+    // Number the kept points and copy them with their point data.
+    std::vector<vtkIdType> newIds(numUsedPts);
+    vtkCleanFlagKept flagKept;
+    flagKept.Merged = merged.data();
+    flagKept.NewIds = newIds.data();
+    vtkSMPTools::For(0, numUsedPts, flagKept);
+    vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(
+      newIds.begin(), newIds.end(), newIds.begin(), vtkIdType(0));
+
+    std::vector<vtkIdType> sources(numNewPts);
+    newPts->SetNumberOfPoints(numNewPts);
+    vtkCleanCopyKept copyKept;
+    copyKept.Merged = merged.data();
+    copyKept.NewIds = newIds.data();
+    copyKept.Order = order.data();
+    copyKept.Candidates = candidates;
+    copyKept.NewPts = newPts;
+    copyKept.Sources = sources.data();
+    vtkSMPTools::For(0, numUsedPts, copyKept);
+    candidates->Delete();
+
+    outputPD->CopyAllocate(inputPD, numNewPts);
+    outputPD->SetNumberOfTuples(numNewPts);
+    vtkCleanCopyPointData copyPointData;
+    copyPointData.Sources = sources.data();
+    copyPointData.InPD = inputPD;
+    copyPointData.OutPD = outputPD;
+    vtkSMPTools::For(0, numNewPts, copyPointData);
+
+    vtkCleanMapPoints mapPoints;
+    mapPoints.Ranks = ranks.data();
+    mapPoints.Merged = merged.data();
+    mapPoints.NewIds = newIds.data();
+    mapPoints.PointMap = pointMap.data();
+    vtkSMPTools::For(0, numPts, mapPoints);
   }
-  if (newPolys)
+  this->UpdateProgress(0.75);
+
+  // Renumber the points of the cells and convert the degenerate cells. The
+  // output cells of each kind keep the order of the input cells, so each
+  // batch is counted first, then written where the counts put it.
+  vtkCleanConvertCell convert;
+  convert.PointMap = pointMap.data();
+  convert.ConvertLinesToPoints = this->ConvertLinesToPoints;
+  convert.ConvertPolysToLines = this->ConvertPolysToLines;
+  convert.ConvertStripsToPolys = this->ConvertStripsToPolys;
+
+  std::vector<vtkIdType> batchCells(numBatches * VTK_CLEAN_KINDS);
+  std::vector<vtkIdType> batchIds(numBatches * VTK_CLEAN_KINDS);
+  vtkCleanCountCells countCells;
+  countCells.Batches = &batches;
+  countCells.Convert = convert;
+  countCells.BatchCells = batchCells.data();
+  countCells.BatchIds = batchIds.data();
+  vtkSMPTools::For(0, numBatches, countCells);
+
+  vtkIdType numNewCells[VTK_CLEAN_KINDS], numNewIds[VTK_CLEAN_KINDS];
+  for (int kind=0; kind < VTK_CLEAN_KINDS; kind++)
   {
-    for (i=0; i<polyIDcounter; i++, CombinedCellID++)
+    numNewCells[kind] = numNewIds[kind] = 0;
+    for (vtkIdType batch=0; batch < numBatches; batch++)
     {
-      outputCD->CopyData(outPolyData, i, CombinedCellID);
+      vtkIdType *cells = &batchCells[batch * VTK_CLEAN_KINDS + kind];
+      vtkIdType *ids = &batchIds[batch * VTK_CLEAN_KINDS + kind];
+      std::swap(numNewCells[kind], *cells);
+      std::swap(numNewIds[kind], *ids);
+      numNewCells[kind] += *cells;
+      numNewIds[kind] += *ids;
     }
-    outPolyData->Delete();
   }
-  if (newStrips)
+
+  vtkCellArray *newCells[VTK_CLEAN_KINDS];
+  vtkCleanCopyCells copyCells;
+  copyCells.Batches = &batches;
+  copyCells.Convert = convert;
+  copyCells.BatchCells = batchCells.data();
+  copyCells.BatchIds = batchIds.data();
+  vtkIdType numAllNewCells = 0;
+  for (int kind=0; kind < VTK_CLEAN_KINDS; kind++)
   {
-    for (i=0; i<strpIDcounter; i++, CombinedCellID++)
+    newCells[kind] = nullptr;
+    copyCells.Connectivity[kind] = nullptr;
+    copyCells.FirstCells[kind] = numAllNewCells;
+    if ( numNewCells[kind] > 0 )
     {
-      outputCD->CopyData(outStrpData, i, CombinedCellID);
+      newCells[kind] = vtkCellArray::New();
+      copyCells.Connectivity[kind] = newCells[kind]->WritePointer(
+        numNewCells[kind], numNewCells[kind] + numNewIds[kind]);
+      numAllNewCells += numNewCells[kind];
     }
-    outStrpData->Delete();
   }
+  std::vector<vtkIdType> oldCellIds(numAllNewCells);
+  copyCells.OldCellIds = oldCellIds.data();
+  vtkSMPTools::For(0, numBatches, copyCells);
+
+  outputCD->CopyAllocate(inputCD, numAllNewCells);
+  outputCD->SetNumberOfTuples(numAllNewCells);
+  vtkCleanCopyCellData copyCellData;
+  copyCellData.OldCellIds = oldCellIds.data();
+  copyCellData.InCD = inputCD;
+  copyCellData.OutCD = outputCD;
+  vtkSMPTools::For(0, numAllNewCells, copyCellData);
+
+  vtkDebugMacro(<<"Removed "
+                << numCells - numAllNewCells << " cells");
+  vtkDebugMacro(<<"Removed "
+                << numPts - newPts->GetNumberOfPoints() << " points");
 
   output->SetPoints(newPts);
   newPts->Squeeze();
   newPts->Delete();
-  if (newVerts)
+  if (newCells[VTK_CLEAN_VERTS])
   {
-    newVerts->Squeeze();
-    output->SetVerts(newVerts);
-    newVerts->Delete();
+    output->SetVerts(newCells[VTK_CLEAN_VERTS]);
+    newCells[VTK_CLEAN_VERTS]->Delete();
   }
-  if (newLines)
+  if (newCells[VTK_CLEAN_LINES])
   {
-    newLines->Squeeze();
-    output->SetLines(newLines);
-    newLines->Delete();
+    output->SetLines(newCells[VTK_CLEAN_LINES]);
+    newCells[VTK_CLEAN_LINES]->Delete();
   }
-  if (newPolys)
+  if (newCells[VTK_CLEAN_POLYS])
   {
-    newPolys->Squeeze();
-    output->SetPolys(newPolys);
-    newPolys->Delete();
+    output->SetPolys(newCells[VTK_CLEAN_POLYS]);
+    newCells[VTK_CLEAN_POLYS]->Delete();
   }
-  if (newStrips)
+  if (newCells[VTK_CLEAN_STRIPS])
   {
-    newStrips->Squeeze();
-    output->SetStrips(newStrips);
-    newStrips->Delete();
+    output->SetStrips(newCells[VTK_CLEAN_STRIPS]);
+    newCells[VTK_CLEAN_STRIPS]->Delete();
   }
 
   return 1;
@@ -634,7 +1102,7 @@ void vtkCleanPolyData::CreateDefaultLocator(vtkPolyData *input)
   else
   {
     // check that the tolerance wasn't changed from zero to non-zero
-    if ((tol>0.0) && (this->GetLocator()->GetTolerance()==0.0))
+    if ((tol>0.0) && (this->Locator->GetTolerance()==0.0))
     {
       this->SetLocator(nullptr);
       this->Locator = vtkPointLocator::New();
@@ -35,10 +35,13 @@
  * Strp with 1 points -> Vert (if ConvertStripsToPolys && ConvertPolysToLines
  *   && ConvertLinesToPoints)
  *
- * If tolerance is specified precisely=0.0, then vtkCleanPolyData will use
- * the vtkMergePoints object to merge points (which is faster). Otherwise the
- * slower vtkIncrementalPointLocator is used.  Before inserting points into the point
- * locator, this class calls a function OperateOnPoint which can be used (in
+ * Points are merged in parallel (using vtkSMPTools) with a
+ * vtkStaticPointLocator. The points are visited in the order of their first
+ * use by a cell, and each point is merged into the first kept point within
+ * the tolerance, if any. With a tolerance of 0.0 this gives the same result
+ * as vtkMergePoints. If a locator is set with SetLocator(), the points are
+ * instead inserted into it one after the other. Before merging the points,
+ * this class calls a function OperateOnPoint which can be used (in
  * subclasses) to further refine the cleaning process. See
  * vtkQuantizePolyDataPoints.
  *
@@ -51,7 +54,9 @@
  * forms. The tolerance should be chosen carefully to avoid these problems.
  * Subclasses should handle OperateOnBounds as well as OperateOnPoint
  * to ensure that the locator is correctly initialized (i.e. all modified
- * points must lie inside modified bounds).
+ * points must lie inside modified bounds). OperateOnPoint is called from
+ * several threads at once: subclasses whose OperateOnPoint is not thread
+ * safe must turn ThreadSafeOperateOnPoint off.
  *
  * @warning
  * If you wish to operate on a set of coordinates
@@ -146,15 +151,21 @@ public:
 
   //@{
   /**
-   * Set/Get a spatial locator for speeding the search process. By
-   * default an instance of vtkMergePoints is used.
+   * Set/Get an incremental spatial locator to merge the points one after
+   * the other, instead of in parallel. By default no locator is set and the
+   * points are merged in parallel. A vtkMergePoints locator is replaced by
+   * a vtkPointLocator when the tolerance is not 0 (see
+   * CreateDefaultLocator()).
    */
   virtual void SetLocator(vtkIncrementalPointLocator *locator);
   vtkGetObjectMacro(Locator,vtkIncrementalPointLocator);
   //@}
 
   /**
-   * Create default locator. Used to create one when none is specified.
+   * Create default locator: a vtkMergePoints if the tolerance is 0.0, a
+   * vtkPointLocator otherwise. If a locator is set, replace it with a
+   * vtkPointLocator if its tolerance is 0.0 and the tolerance is not. Once
+   * created, the locator is used to merge the points.
    */
   void CreateDefaultLocator(vtkPolyData *input = nullptr);
 
@@ -169,7 +180,8 @@ public:
   vtkMTimeType GetMTime() VTK_OVERRIDE;
 
   /**
-   * Perform operation on a point
+   * Perform operation on a point. It is called from several threads at
+   * once, unless ThreadSafeOperateOnPoint is off.
    */
   virtual void OperateOnPoint(double in[3], double out[3]);
 
@@ -216,6 +228,11 @@ protected:
 
   int PieceInvariant;
   int OutputPointsPrecision;
+
+  // Whether OperateOnPoint() can be called from several threads at once.
+  // On by default; the subclasses overriding it with code that is not
+  // thread safe must turn it off.
+  int ThreadSafeOperateOnPoint;
 private:
   vtkCleanPolyData(const vtkCleanPolyData&) VTK_DELETE_FUNCTION;
   void operator=(const vtkCleanPolyData&) VTK_DELETE_FUNCTION;
@@ -0,0 +1,688 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectedRegions.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkConnectedRegions.h"
+
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// The root of the tree of id. The path is halved on the way, each visited
+// entry being pointed to its grandparent. Parents have lower ids than their
+// children and only ever move up the tree, so an entry overwritten by a
+// concurrent lookup with an older ancestor stays correct.
+inline vtkIdType vtkFindRoot(std::atomic<vtkIdType> *parents, vtkIdType id)
+{
+  for (;;)
+  {
+    vtkIdType parent = parents[id].load(std::memory_order_relaxed);
+    if (parent == id)
+    {
+      return id;
+    }
+    vtkIdType grandParent = parents[parent].load(std::memory_order_relaxed);
+    if (grandParent == parent)
+    {
+      return parent;
+    }
+    parents[id].store(grandParent, std::memory_order_relaxed);
+    id = grandParent;
+  }
+}
+
+//----------------------------------------------------------------------------
+// Merge the trees of a and b by hanging the root with the higher id under
+// the other one. If another thread links that root first, the roots are
+// looked up again.
+inline void vtkUniteTrees(std::atomic<vtkIdType> *parents, vtkIdType a,
+                          vtkIdType b)
+{
+  for (;;)
+  {
+    a = vtkFindRoot(parents, a);
+    b = vtkFindRoot(parents, b);
+    if (a == b)
+    {
+      return;
+    }
+    if (a < b)
+    {
+      std::swap(a, b);
+    }
+    vtkIdType expected = a;
+    if (parents[a].compare_exchange_weak(expected, b))
+    {
+      return;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+inline void vtkAtomicMin(std::atomic<vtkIdType>& value, vtkIdType candidate)
+{
+  vtkIdType current = value.load(std::memory_order_relaxed);
+  while (candidate < current &&
+         !value.compare_exchange_weak(current, candidate,
+                                      std::memory_order_relaxed))
+  {
+  }
+}
+
+//----------------------------------------------------------------------------
+// Every cell and point starts as a tree of its own.
+struct vtkConnectedRegionsInitialize
+{
+  std::atomic<vtkIdType> *Roots;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType id = begin; id < end; ++id)
+    {
+      this->Roots[id].store(id, std::memory_order_relaxed);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Unite each connected cell with its points. Two connected cells sharing a
+// point end up in the same tree.
+struct vtkConnectedRegionsUnite
+{
+  vtkDataSet *Input;
+  vtkDataArray *Scalars;
+  double Range[2];
+  bool AllScalarsInRange;
+  std::atomic<vtkIdType> *Roots;
+  unsigned char *Connected;
+  vtkIdType NumberOfCells;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  bool InRange(const vtkIdType *pts, vtkIdType npts)
+  {
+    double range[2] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      double s = this->Scalars->GetComponent(pts[i], 0);
+      range[0] = std::min(range[0], s);
+      range[1] = std::max(range[1], s);
+    }
+    if (this->AllScalarsInRange)
+    {
+      return range[0] >= this->Range[0] && range[1] <= this->Range[1];
+    }
+    return range[1] >= this->Range[0] && range[0] <= this->Range[1];
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      this->Input->GetCellPoints(cellId, npts, pts, cellPts);
+      if (this->Scalars)
+      {
+        this->Connected[cellId] = this->InRange(pts, npts);
+        if (!this->Connected[cellId])
+        {
+          continue;
+        }
+      }
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        vtkUniteTrees(this->Roots, cellId, this->NumberOfCells + pts[i]);
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Point every entry to its root. The lookups do not compress the paths so
+// that the roots stored by other threads are never overwritten.
+struct vtkConnectedRegionsFlatten
+{
+  std::atomic<vtkIdType> *Roots;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType id = begin; id < end; ++id)
+    {
+      vtkIdType root = id, parent;
+      while ((parent = this->Roots[root].load(std::memory_order_relaxed)) !=
+             root)
+      {
+        root = parent;
+      }
+      this->Roots[id].store(root, std::memory_order_relaxed);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// A cell that is not connected starts a region of its own, which takes the
+// groups of connected cells around its points. Each group gets the lowest
+// of these cells, if lower than the group's own lowest cell.
+struct vtkConnectedRegionsClaim
+{
+  vtkDataSet *Input;
+  const std::atomic<vtkIdType> *Roots;
+  const unsigned char *Connected;
+  std::atomic<vtkIdType> *Claims;
+  vtkIdType NumberOfCells;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      if (this->Connected[cellId])
+      {
+        continue;
+      }
+      this->Input->GetCellPoints(cellId, npts, pts, cellPts);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        vtkIdType root = this->Roots[this->NumberOfCells + pts[i]].load(
+          std::memory_order_relaxed);
+        if (root < this->NumberOfCells)
+        {
+          vtkAtomicMin(this->Claims[root], cellId);
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// The cell that starts the region of each cell when the cells are traversed
+// in increasing id order.
+struct vtkConnectedRegionsStarts
+{
+  const std::atomic<vtkIdType> *Roots;
+  const unsigned char *Connected;
+  const std::atomic<vtkIdType> *Claims;
+
+  vtkIdType GetStart(vtkIdType cellId) const
+  {
+    if (this->Connected && !this->Connected[cellId])
+    {
+      return cellId;
+    }
+    vtkIdType root = this->Roots[cellId].load(std::memory_order_relaxed);
+    if (this->Claims)
+    {
+      vtkIdType claim = this->Claims[root].load(std::memory_order_relaxed);
+      if (claim < root)
+      {
+        return claim;
+      }
+    }
+    return root;
+  }
+};
+
+//----------------------------------------------------------------------------
+// Flag the cells that start a region, numbered by a scan of the flags.
+struct vtkConnectedRegionsFlagStarts : public vtkConnectedRegionsStarts
+{
+  vtkIdType *CellRegions;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      this->CellRegions[cellId] = this->GetStart(cellId) == cellId ? 1 : 0;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Give the other cells the region of their starting cell.
+struct vtkConnectedRegionsNumber : public vtkConnectedRegionsStarts
+{
+  vtkIdType *CellRegions;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      vtkIdType start = this->GetStart(cellId);
+      if (start != cellId)
+      {
+        this->CellRegions[cellId] = this->CellRegions[start];
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Count the cells of each region. Neighboring cells are often in the same
+// region, so they are counted in runs to limit the atomic updates.
+struct vtkConnectedRegionsCount
+{
+  const vtkIdType *CellRegions;
+  std::atomic<vtkIdType> *Sizes;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType region = this->CellRegions[begin];
+    vtkIdType count = 0;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      if (this->CellRegions[cellId] != region)
+      {
+        this->Sizes[region].fetch_add(count, std::memory_order_relaxed);
+        region = this->CellRegions[cellId];
+        count = 0;
+      }
+      ++count;
+    }
+    this->Sizes[region].fetch_add(count, std::memory_order_relaxed);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Find the seed cells, when seeded by points, and select the groups of
+// connected cells around their points.
+struct vtkConnectedRegionsSelect
+{
+  vtkDataSet *Input;
+  const std::atomic<vtkIdType> *Roots;
+  const unsigned char *SeedPoints;
+  unsigned char *SeedCells;
+  std::atomic<unsigned char> *Selected;
+  vtkIdType NumberOfCells;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      if (!this->SeedPoints && !this->SeedCells[cellId])
+      {
+        continue;
+      }
+      this->Input->GetCellPoints(cellId, npts, pts, cellPts);
+      if (this->SeedPoints)
+      {
+        this->SeedCells[cellId] = 0;
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          if (this->SeedPoints[pts[i]])
+          {
+            this->SeedCells[cellId] = 1;
+            break;
+          }
+        }
+        if (!this->SeedCells[cellId])
+        {
+          continue;
+        }
+      }
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        vtkIdType root = this->Roots[this->NumberOfCells + pts[i]].load(
+          std::memory_order_relaxed);
+        if (root < this->NumberOfCells)
+        {
+          this->Selected[root].store(1, std::memory_order_relaxed);
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Label the seed cells and the cells of the selected groups.
+struct vtkConnectedRegionsLabelSeeded
+{
+  const std::atomic<vtkIdType> *Roots;
+  const unsigned char *Connected;
+  const unsigned char *SeedCells;
+  const std::atomic<unsigned char> *Selected;
+  vtkIdType *CellRegions;
+  vtkSMPThreadLocal<vtkIdType> Count;
+  vtkIdType NumberOfLabeledCells;
+
+  void Initialize()
+  {
+    this->Count.Local() = 0;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType& count = this->Count.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      bool labeled = this->SeedCells[cellId] != 0;
+      if (!labeled && (!this->Connected || this->Connected[cellId]))
+      {
+        vtkIdType root = this->Roots[cellId].load(std::memory_order_relaxed);
+        labeled = this->Selected[root].load(std::memory_order_relaxed) != 0;
+      }
+      this->CellRegions[cellId] = labeled ? 0 : -1;
+      count += labeled ? 1 : 0;
+    }
+  }
+
+  void Reduce()
+  {
+    this->NumberOfLabeledCells = 0;
+    for (vtkSMPThreadLocal<vtkIdType>::iterator it = this->Count.begin();
+         it != this->Count.end(); ++it)
+    {
+      this->NumberOfLabeledCells += *it;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Without scalars all the cells using a point are in the point's group.
+struct vtkConnectedRegionsGroupPoints
+{
+  const std::atomic<vtkIdType> *Roots;
+  const vtkIdType *CellRegions;
+  vtkIdType *PointRegions;
+  vtkIdType NumberOfCells;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      vtkIdType root = this->Roots[this->NumberOfCells + ptId].load(
+        std::memory_order_relaxed);
+      this->PointRegions[ptId] =
+        root < this->NumberOfCells ? this->CellRegions[root] : -1;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// With scalars the cells using a point may be in different regions.
+struct vtkConnectedRegionsMinPoints
+{
+  vtkDataSet *Input;
+  const vtkIdType *CellRegions;
+  std::atomic<vtkIdType> *PointRegions;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      vtkIdType region = this->CellRegions[cellId];
+      if (region < 0)
+      {
+        continue;
+      }
+      this->Input->GetCellPoints(cellId, npts, pts, cellPts);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        vtkAtomicMin(this->PointRegions[pts[i]], region);
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+struct vtkConnectedRegionsCopyPoints
+{
+  const std::atomic<vtkIdType> *MinRegions;
+  vtkIdType *PointRegions;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      vtkIdType region = this->MinRegions[ptId].load(std::memory_order_relaxed);
+      this->PointRegions[ptId] = region == VTK_ID_MAX ? -1 : region;
+    }
+  }
+};
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+vtkConnectedRegions::vtkConnectedRegions()
+{
+  this->Input = nullptr;
+  this->NumberOfCells = 0;
+  this->NumberOfPoints = 0;
+  this->Roots = nullptr;
+}
+
+//----------------------------------------------------------------------------
+vtkConnectedRegions::~vtkConnectedRegions()
+{
+  delete [] this->Roots;
+}
+
+//----------------------------------------------------------------------------
+void vtkConnectedRegions::Build(vtkDataSet *input, vtkDataArray *scalars,
+                                const double range[2], bool allScalarsInRange)
+{
+  this->Input = input;
+  this->NumberOfCells = input->GetNumberOfCells();
+  this->NumberOfPoints = input->GetNumberOfPoints();
+  vtkIdType numIds = this->NumberOfCells + this->NumberOfPoints;
+
+  delete [] this->Roots;
+  this->Roots = new std::atomic<vtkIdType>[numIds];
+  vtkConnectedRegionsInitialize initialize = { this->Roots };
+  vtkSMPTools::For(0, numIds, initialize);
+
+  if (scalars)
+  {
+    this->Connected.resize(this->NumberOfCells);
+  }
+  else
+  {
+    this->Connected.clear();
+  }
+
+  // The union-find reads the cells from several threads: build them first.
+  if (this->NumberOfCells > 0)
+  {
+    vtkNew<vtkIdList> cellPts;
+    input->GetCellPoints(0, cellPts.GetPointer());
+  }
+
+  vtkConnectedRegionsUnite unite;
+  unite.Input = input;
+  unite.Scalars = scalars;
+  unite.Range[0] = range[0];
+  unite.Range[1] = range[1];
+  unite.AllScalarsInRange = allScalarsInRange;
+  unite.Roots = this->Roots;
+  unite.Connected = this->Connected.data();
+  unite.NumberOfCells = this->NumberOfCells;
+  vtkSMPTools::For(0, this->NumberOfCells, unite);
+
+  vtkConnectedRegionsFlatten flatten = { this->Roots };
+  vtkSMPTools::For(0, numIds, flatten);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectedRegions::LabelAllRegions(vtkIdType *cellRegions,
+                                               vtkIdTypeArray *regionSizes)
+{
+  const vtkIdType numCells = this->NumberOfCells;
+  std::atomic<vtkIdType> *claims = nullptr;
+  if (!this->Connected.empty())
+  {
+    claims = new std::atomic<vtkIdType>[numCells];
+    vtkSMPTools::Fill(claims, claims + numCells, vtkIdType(VTK_ID_MAX));
+    vtkConnectedRegionsClaim claim;
+    claim.Input = this->Input;
+    claim.Roots = this->Roots;
+    claim.Connected = this->Connected.data();
+    claim.Claims = claims;
+    claim.NumberOfCells = numCells;
+    vtkSMPTools::For(0, numCells, claim);
+  }
+
+  // Number the starting cells in increasing order, then hand their numbers
+  // to the rest of their region.
+  vtkConnectedRegionsFlagStarts flagStarts;
+  flagStarts.Roots = this->Roots;
+  flagStarts.Connected = claims ? this->Connected.data() : nullptr;
+  flagStarts.Claims = claims;
+  flagStarts.CellRegions = cellRegions;
+  vtkSMPTools::For(0, numCells, flagStarts);
+  vtkIdType numRegions = vtkSMPTools::ExclusiveScan(
+    cellRegions, cellRegions + numCells, cellRegions, vtkIdType(0));
+
+  vtkConnectedRegionsNumber number;
+  number.Roots = this->Roots;
+  number.Connected = flagStarts.Connected;
+  number.Claims = claims;
+  number.CellRegions = cellRegions;
+  vtkSMPTools::For(0, numCells, number);
+  delete [] claims;
+
+  std::atomic<vtkIdType> *sizes = new std::atomic<vtkIdType>[numRegions];
+  vtkSMPTools::Fill(sizes, sizes + numRegions, vtkIdType(0));
+  vtkConnectedRegionsCount count = { cellRegions, sizes };
+  vtkSMPTools::For(0, numCells, count);
+
+  regionSizes->SetNumberOfValues(numRegions);
+  vtkIdType largestRegion = 0;
+  for (vtkIdType region = 0; region < numRegions; ++region)
+  {
+    vtkIdType size = sizes[region].load(std::memory_order_relaxed);
+    regionSizes->SetValue(region, size);
+    if (size > regionSizes->GetValue(largestRegion))
+    {
+      largestRegion = region;
+    }
+  }
+  delete [] sizes;
+
+  return largestRegion;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectedRegions::LabelCellSeededRegion(vtkIdList *seedCells,
+                                                     vtkIdType *cellRegions)
+{
+  std::vector<unsigned char> seeds(this->NumberOfCells, 0);
+  for (vtkIdType i = 0; i < seedCells->GetNumberOfIds(); ++i)
+  {
+    vtkIdType cellId = seedCells->GetId(i);
+    if (cellId >= 0 && cellId < this->NumberOfCells)
+    {
+      seeds[cellId] = 1;
+    }
+  }
+  return this->LabelSeededRegion(nullptr, seeds, cellRegions);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectedRegions::LabelPointSeededRegion(vtkIdList *seedPoints,
+                                                      vtkIdType *cellRegions)
+{
+  std::vector<unsigned char> seedPts(this->NumberOfPoints, 0);
+  for (vtkIdType i = 0; i < seedPoints->GetNumberOfIds(); ++i)
+  {
+    vtkIdType ptId = seedPoints->GetId(i);
+    if (ptId >= 0 && ptId < this->NumberOfPoints)
+    {
+      seedPts[ptId] = 1;
+    }
+  }
+  std::vector<unsigned char> seeds(this->NumberOfCells);
+  return this->LabelSeededRegion(seedPts.data(), seeds, cellRegions);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectedRegions::LabelSeededRegion(
+  const unsigned char *seedPoints, std::vector<unsigned char>& seedCells,
+  vtkIdType *cellRegions)
+{
+  const vtkIdType numCells = this->NumberOfCells;
+  std::atomic<unsigned char> *selected =
+    new std::atomic<unsigned char>[numCells];
+  vtkSMPTools::Fill(selected, selected + numCells,
+                    static_cast<unsigned char>(0));
+
+  vtkConnectedRegionsSelect select;
+  select.Input = this->Input;
+  select.Roots = this->Roots;
+  select.SeedPoints = seedPoints;
+  select.SeedCells = seedCells.data();
+  select.Selected = selected;
+  select.NumberOfCells = numCells;
+  vtkSMPTools::For(0, numCells, select);
+
+  vtkConnectedRegionsLabelSeeded label;
+  label.Roots = this->Roots;
+  label.Connected = this->Connected.empty() ? nullptr : this->Connected.data();
+  label.SeedCells = seedCells.data();
+  label.Selected = selected;
+  label.CellRegions = cellRegions;
+  label.NumberOfLabeledCells = 0;
+  vtkSMPTools::For(0, numCells, label);
+  delete [] selected;
+
+  return label.NumberOfLabeledCells;
+}
+
+//----------------------------------------------------------------------------
+void vtkConnectedRegions::LabelPoints(const vtkIdType *cellRegions,
+                                      vtkIdType *pointRegions)
+{
+  if (this->Connected.empty())
+  {
+    vtkConnectedRegionsGroupPoints group = { this->Roots, cellRegions,
+                                             pointRegions,
+                                             this->NumberOfCells };
+    vtkSMPTools::For(0, this->NumberOfPoints, group);
+    return;
+  }
+
+  std::atomic<vtkIdType> *minRegions =
+    new std::atomic<vtkIdType>[this->NumberOfPoints];
+  vtkSMPTools::Fill(minRegions, minRegions + this->NumberOfPoints,
+                    vtkIdType(VTK_ID_MAX));
+  vtkConnectedRegionsMinPoints minPoints;
+  minPoints.Input = this->Input;
+  minPoints.CellRegions = cellRegions;
+  minPoints.PointRegions = minRegions;
+  vtkSMPTools::For(0, this->NumberOfCells, minPoints);
+
+  vtkConnectedRegionsCopyPoints copy = { minRegions, pointRegions };
+  vtkSMPTools::For(0, this->NumberOfPoints, copy);
+  delete [] minRegions;
+}
@@ -0,0 +1,114 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectedRegions.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkConnectedRegions
+ * @brief   A utility class used by the connectivity filters
+ *
+ * vtkConnectedRegions groups the cells of a dataset that share points into
+ * regions. The groups are found with a concurrent union-find over the cells
+ * and the points, using vtkSMPTools and atomic path compression, and the
+ * regions are then numbered and sized in parallel. The labels are the ones
+ * the connectivity filters get from a breadth-first traversal of the cells
+ * in increasing id order, whatever the number of threads: regions are
+ * numbered in the order of their lowest cell id.
+ *
+ * With scalars, only the cells whose point scalars are in range connect to
+ * their neighbors. A cell that is not in range still starts a region, which
+ * takes in the connected cells around its points that no region with a lower
+ * starting cell took first, exactly as the traversal does.
+ * @sa
+ * vtkConnectivityFilter vtkPolyDataConnectivityFilter
+*/
+
+#ifndef vtkConnectedRegions_h
+#define vtkConnectedRegions_h
+
+#include "vtkFiltersCoreModule.h" // For export macro
+#include "vtkType.h" // For vtkIdType
+
+#include <atomic> // For the union-find forest
+#include <vector> // For member variables
+
+class vtkDataArray;
+class vtkDataSet;
+class vtkIdList;
+class vtkIdTypeArray;
+
+class VTKFILTERSCORE_EXPORT vtkConnectedRegions
+{
+public:
+  vtkConnectedRegions();
+  ~vtkConnectedRegions();
+
+  /**
+   * Group the cells of input sharing points. When scalars is not nullptr,
+   * a cell connects to its neighbors only if the first component of the
+   * scalars of one of its points (of all its points, with
+   * allScalarsInRange) lies in range. The input must not be modified until
+   * the labels have been computed.
+   */
+  void Build(vtkDataSet *input, vtkDataArray *scalars, const double range[2],
+             bool allScalarsInRange);
+
+  /**
+   * Label all the cells. cellRegions receives the region of each cell and
+   * regionSizes the number of cells of each region. Returns the largest
+   * region, the first one when several have the largest size.
+   */
+  vtkIdType LabelAllRegions(vtkIdType *cellRegions,
+                            vtkIdTypeArray *regionSizes);
+
+  //@{
+  /**
+   * Label the seed cells, or the cells using the seed points, and the cells
+   * connected to them with region 0, and the other cells with -1. Ids out
+   * of range are ignored. Returns the number of cells of region 0.
+   */
+  vtkIdType LabelCellSeededRegion(vtkIdList *seedCells,
+                                  vtkIdType *cellRegions);
+  vtkIdType LabelPointSeededRegion(vtkIdList *seedPoints,
+                                   vtkIdType *cellRegions);
+  //@}
+
+  /**
+   * Give each point the lowest region of the labeled cells using it, or -1
+   * when no labeled cell uses it.
+   */
+  void LabelPoints(const vtkIdType *cellRegions, vtkIdType *pointRegions);
+
+private:
+  vtkConnectedRegions(const vtkConnectedRegions&) VTK_DELETE_FUNCTION;
+  vtkConnectedRegions& operator=(const vtkConnectedRegions&) VTK_DELETE_FUNCTION;
+
+  vtkIdType LabelSeededRegion(const unsigned char *seedPoints,
+                              std::vector<unsigned char>& seedCells,
+                              vtkIdType *cellRegions);
+
+  vtkDataSet *Input;
+  vtkIdType NumberOfCells;
+  vtkIdType NumberOfPoints;
+
+  // The union-find forest over the cells [0, NumberOfCells) followed by the
+  // points. Once built every entry is the root of its tree, which is the
+  // lowest cell of the group or the point itself if no connected cell uses
+  // it.
+  std::atomic<vtkIdType> *Roots;
+
+  // Whether each cell connects to its neighbors; empty when they all do.
+  std::vector<unsigned char> Connected;
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkConnectedRegions.h
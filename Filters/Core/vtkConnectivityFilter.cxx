@@ -14,23 +14,152 @@
 =========================================================================*/
 #include "vtkConnectivityFilter.h"
 
-#include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkConnectedRegions.h"
 #include "vtkDataSet.h"
-#include "vtkFloatArray.h"
 #include "vtkIdList.h"
+#include "vtkIdMapInverter.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
-#include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
-#include "vtkIdTypeArray.h"
+
+#include <vector>
 
 vtkStandardNewMacro(vtkConnectivityFilter);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Flag the cells to extract: the labeled cells, of the extracted regions
+// when given. An extracted cell gets the size of its legacy connectivity
+// (npts+1), the other cells get 0.
+struct vtkConnectivityFlagCells
+{
+  vtkDataSet *Input;
+  const vtkIdType *CellRegions;
+  const unsigned char *ExtractedRegions;
+  vtkIdType *CellFlags;
+  vtkIdType *ConnectivitySizes;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      vtkIdType region = this->CellRegions[cellId];
+      if ( region >= 0 &&
+           (!this->ExtractedRegions || this->ExtractedRegions[region]) )
+      {
+        this->Input->GetCellPoints(cellId, npts, pts, cellPts);
+        this->CellFlags[cellId] = 1;
+        this->ConnectivitySizes[cellId] = npts + 1;
+      }
+      else
+      {
+        this->CellFlags[cellId] = 0;
+        this->ConnectivitySizes[cellId] = 0;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// The points used by the labeled cells are kept.
+struct vtkConnectivityIsLabeled
+{
+  vtkIdType operator()(vtkIdType region) const
+  {
+    return region >= 0 ? 1 : 0;
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the kept points, their attributes and their regions.
+struct vtkConnectivityCopyPoints
+{
+  vtkDataSet *Input;
+  const vtkIdType *OldPointIds;
+  const vtkIdType *PointRegions;
+  vtkPoints *NewPoints;
+  vtkIdType *NewScalars;
+  vtkPointData *InPD;
+  vtkPointData *OutPD;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for (vtkIdType newId = ptId; newId < endPtId; ++newId)
+    {
+      vtkIdType oldId = this->OldPointIds[newId];
+      this->Input->GetPoint(oldId, x);
+      this->NewPoints->SetPoint(newId, x);
+      this->NewScalars[newId] = this->PointRegions[oldId];
+    }
+    this->OutPD->GatherData(this->InPD, this->OldPointIds + ptId, ptId,
+                            endPtId - ptId);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the extracted cells, renumbering their points, their attributes and
+// their regions.
+struct vtkConnectivityCopyCells
+{
+  vtkDataSet *Input;
+  const vtkIdType *OldCellIds;
+  const vtkIdType *CellRegions;
+  const vtkIdType *PointMap;
+  const vtkIdType *Locations;
+  vtkIdType *Connectivity;
+  unsigned char *Types;
+  vtkIdType *NewLocations;
+  vtkIdType *NewCellScalars;
+  vtkCellData *InCD;
+  vtkCellData *OutCD;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for (vtkIdType newId = cellId; newId < endCellId; ++newId)
+    {
+      vtkIdType oldId = this->OldCellIds[newId];
+      this->Input->GetCellPoints(oldId, npts, pts, cellPts);
+      vtkIdType loc = this->Locations[oldId];
+      vtkIdType *conn = this->Connectivity + loc;
+      *conn++ = npts;
+      for (vtkIdType i=0; i < npts; i++)
+      {
+        conn[i] = this->PointMap[pts[i]];
+      }
+      this->Types[newId] =
+        static_cast<unsigned char>(this->Input->GetCellType(oldId));
+      this->NewLocations[newId] = loc;
+      this->NewCellScalars[newId] = this->CellRegions[oldId];
+    }
+    this->OutCD->GatherData(this->InCD, this->OldCellIds + cellId, cellId,
+                            endCellId - cellId);
+  }
+};
+
+} // end anon namespace
+
 // Construct with default extraction mode to extract largest regions.
 vtkConnectivityFilter::vtkConnectivityFilter()
 {
@@ -44,26 +173,15 @@ vtkConnectivityFilter::vtkConnectivityFilter()
 
   this->ClosestPoint[0] = this->ClosestPoint[1] = this->ClosestPoint[2] = 0.0;
 
-  this->CellScalars = vtkFloatArray::New();
-  this->CellScalars->Allocate(8);
-
-  this->NeighborCellPointIds = vtkIdList::New();
-  this->NeighborCellPointIds->Allocate(8);
-
   this->Seeds = vtkIdList::New();
   this->SpecifiedRegionIds = vtkIdList::New();
 
-  this->NewScalars = nullptr;
-  this->NewCellScalars = nullptr;
-
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
 }
 
 vtkConnectivityFilter::~vtkConnectivityFilter()
 {
   this->RegionSizes->Delete();
-  this->CellScalars->Delete();
-  this->NeighborCellPointIds->Delete();
   this->Seeds->Delete();
   this->SpecifiedRegionIds->Delete();
 }
@@ -83,11 +201,8 @@ int vtkConnectivityFilter::RequestData(
   vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType numPts, numCells, cellId, newCellId, i, j, pt;
+  vtkIdType numPts, numCells, i;
   vtkPoints *newPts;
-  int id;
-  int maxCellsInRegion;
-  int largestRegionId = 0;
   vtkPointData *pd=input->GetPointData(), *outputPD=output->GetPointData();
   vtkCellData *cd=input->GetCellData(), *outputCD=output->GetCellData();
 
@@ -101,148 +216,70 @@ int vtkConnectivityFilter::RequestData(
     vtkDebugMacro(<<"No data to connect!");
     return 1;
   }
-  output->Allocate(numCells,numCells);
 
   // See whether to consider scalar connectivity
   //
-  this->InScalars = input->GetPointData()->GetScalars();
-  if ( !this->ScalarConnectivity )
-  {
-    this->InScalars = nullptr;
-  }
-  else
+  vtkDataArray *inScalars = nullptr;
+  if ( this->ScalarConnectivity )
   {
+    inScalars = input->GetPointData()->GetScalars();
     if ( this->ScalarRange[1] < this->ScalarRange[0] )
     {
       this->ScalarRange[1] = this->ScalarRange[0];
     }
   }
 
-  // Initialize.  Keep track of points and cells visited.
+  // Group the cells sharing points (and meeting the scalar criterion) in
+  // parallel. The regions are then numbered as a traversal of the cells in
+  // increasing id order would: each cell not yet visited starts a region.
   //
-  this->RegionSizes->Reset();
-  this->Visited = new vtkIdType[numCells];
-  for ( i=0; i < numCells; i++ )
-  {
-    this->Visited[i] = -1;
-  }
-  this->PointMap = new vtkIdType[numPts];
-  for ( i=0; i < numPts; i++ )
-  {
-    this->PointMap[i] = -1;
-  }
-
-  this->NewScalars = vtkIdTypeArray::New();
-  this->NewScalars->SetName("RegionId");
-  this->NewScalars->SetNumberOfTuples(numPts);
-
-  this->NewCellScalars = vtkIdTypeArray::New();
-  this->NewCellScalars->SetName("RegionId");
-  this->NewCellScalars->SetNumberOfTuples(numCells);
-
-  newPts = vtkPoints::New();
+  vtkConnectedRegions regions;
+  regions.Build(input, inScalars, this->ScalarRange, false);
+  this->UpdateProgress(0.5);
 
-  // Set the desired precision for the points in the output.
-  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    vtkPointSet *inputPointSet = vtkPointSet::SafeDownCast(input);
-    if(inputPointSet)
-    {
-      newPts->SetDataType(inputPointSet->GetPoints()->GetDataType());
-    }
-    else
-    {
-      newPts->SetDataType(VTK_FLOAT);
-    }
-  }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_FLOAT);
-  }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_DOUBLE);
-  }
-
-  newPts->Allocate(numPts);
-
-  // Traverse all cells marking those visited.  Each new search
-  // starts a new connected region. Connected region grows
-  // using a connected wave propagation.
-  //
-  this->Wave = vtkIdList::New();
-  this->Wave->Allocate(numPts/4+1,numPts);
-  this->Wave2 = vtkIdList::New();
-  this->Wave2->Allocate(numPts/4+1,numPts);
-
-  this->PointNumber = 0;
-  this->RegionNumber = 0;
-  maxCellsInRegion = 0;
-
-  this->CellIds = vtkIdList::New();
-  this->CellIds->Allocate(8, VTK_CELL_SIZE);
-  this->PointIds = vtkIdList::New();
-  this->PointIds->Allocate(8, VTK_CELL_SIZE);
+  this->RegionSizes->Reset();
+  std::vector<vtkIdType> cellRegions(numCells);
+  std::vector<unsigned char> extractedRegions;
 
   if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
-  { //visit all cells marking with region number
-    for (cellId=0; cellId < numCells; cellId++)
-    {
-      if ( cellId && !(cellId % 5000) )
-      {
-        this->UpdateProgress (0.1 + 0.8*cellId/numCells);
-      }
+  { //label all cells with region number
+    vtkIdType largestRegionId =
+      regions.LabelAllRegions(&cellRegions[0], this->RegionSizes);
+    vtkIdType numRegions = this->RegionSizes->GetNumberOfTuples();
 
-      if ( this->Visited[cellId] < 0 )
+    if ( this->ExtractionMode == VTK_EXTRACT_SPECIFIED_REGIONS )
+    {
+      extractedRegions.resize(numRegions, 0);
+      for (i=0; i < this->SpecifiedRegionIds->GetNumberOfIds(); i++)
       {
-        this->NumCellsInRegion = 0;
-        this->Wave->InsertNextId(cellId);
-        this->TraverseAndMark (input);
-
-        if ( this->NumCellsInRegion > maxCellsInRegion )
+        vtkIdType regionId = this->SpecifiedRegionIds->GetId(i);
+        if ( regionId >= 0 && regionId < numRegions )
         {
-          maxCellsInRegion = this->NumCellsInRegion;
-          largestRegionId = this->RegionNumber;
+          extractedRegions[regionId] = 1;
         }
-
-        this->RegionSizes->InsertValue(this->RegionNumber++,
-                                       this->NumCellsInRegion);
-        this->Wave->Reset();
-        this->Wave2->Reset();
       }
     }
+    else if ( this->ExtractionMode == VTK_EXTRACT_LARGEST_REGION )
+    {
+      extractedRegions.resize(numRegions, 0);
+      extractedRegions[largestRegionId] = 1;
+    }
   }
   else // regions have been seeded, everything considered in same region
   {
-    this->NumCellsInRegion = 0;
+    vtkIdType numCellsInRegion = 0;
 
     if ( this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS )
     {
-      for (i=0; i < this->Seeds->GetNumberOfIds(); i++)
-      {
-        pt = this->Seeds->GetId(i);
-        if ( pt >= 0 )
-        {
-          input->GetPointCells(pt,this->CellIds);
-          for (j=0; j < this->CellIds->GetNumberOfIds(); j++)
-          {
-            this->Wave->InsertNextId(this->CellIds->GetId(j));
-          }
-        }
-      }
+      numCellsInRegion =
+        regions.LabelPointSeededRegion(this->Seeds, &cellRegions[0]);
     }
     else if ( this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS )
     {
-      for (i=0; i < this->Seeds->GetNumberOfIds(); i++)
-      {
-        cellId = this->Seeds->GetId(i);
-        if ( cellId >= 0 )
-        {
-          this->Wave->InsertNextId(cellId);
-        }
-      }
+      numCellsInRegion =
+        regions.LabelCellSeededRegion(this->Seeds, &cellRegions[0]);
     }
     else if ( this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION )
     {//loop over points, find closest one
@@ -258,175 +295,180 @@ int vtkConnectivityFilter::RequestData(
           minDist2 = dist2;
         }
       }
-      input->GetPointCells(minId,this->CellIds);
-      for (j=0; j < this->CellIds->GetNumberOfIds(); j++)
-      {
-        this->Wave->InsertNextId(this->CellIds->GetId(j));
-      }
+      vtkNew<vtkIdList> closestPoint;
+      closestPoint->InsertNextId(minId);
+      numCellsInRegion = regions.LabelPointSeededRegion(
+        closestPoint.GetPointer(), &cellRegions[0]);
     }
-    this->UpdateProgress (0.5);
-
-    //mark all seeded regions
-    this->TraverseAndMark (input);
-    this->RegionSizes->InsertValue(this->RegionNumber,this->NumCellsInRegion);
-    this->UpdateProgress (0.9);
+    this->RegionSizes->InsertValue(0, numCellsInRegion);
   }
+  this->UpdateProgress(0.7);
 
-  vtkDebugMacro (<<"Extracted " << this->RegionNumber << " region(s)");
-  this->Wave->Delete();
-  this->Wave2->Delete();
+  vtkDebugMacro (<<"Extracted " << this->GetNumberOfExtractedRegions()
+                 << " region(s)");
 
-  // Now that points and cells have been marked, traverse these lists pulling
-  // everything that has been visited.
+  // Now that the cells have been labeled, number the points of the labeled
+  // cells in increasing order and the cells to extract. pointMap maps old
+  // point ids into new.
+  //
+  std::vector<vtkIdType> pointRegions(numPts);
+  regions.LabelPoints(&cellRegions[0], &pointRegions[0]);
+
+  std::vector<vtkIdType> pointMap(numPts+1);
+  vtkSMPTools::Transform(pointRegions.begin(), pointRegions.end(),
+                         pointMap.begin(), vtkConnectivityIsLabeled());
+  vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(
+    pointMap.begin(), pointMap.begin() + numPts, pointMap.begin(),
+    vtkIdType(0));
+  pointMap[numPts] = numNewPts;
+
+  std::vector<vtkIdType> cellMap(numCells+1);
+  std::vector<vtkIdType> locations(numCells+1);
+  vtkConnectivityFlagCells flagCells;
+  flagCells.Input = input;
+  flagCells.CellRegions = &cellRegions[0];
+  flagCells.ExtractedRegions =
+    extractedRegions.empty() ? nullptr : &extractedRegions[0];
+  flagCells.CellFlags = &cellMap[0];
+  flagCells.ConnectivitySizes = &locations[0];
+  vtkSMPTools::For(0, numCells, flagCells);
+  vtkIdType numNewCells = vtkSMPTools::ExclusiveScan(
+    cellMap.begin(), cellMap.begin() + numCells, cellMap.begin(),
+    vtkIdType(0));
+  cellMap[numCells] = numNewCells;
+  vtkIdType connSize = vtkSMPTools::ExclusiveScan(
+    locations.begin(), locations.begin() + numCells, locations.begin(),
+    vtkIdType(0));
+  locations[numCells] = connSize;
+
+  // The input ids of the kept points and cells, in increasing order.
+  std::vector<vtkIdType> oldPointIds(numNewPts);
+  vtkIdMapInverter::Invert(&pointMap[0], numPts, oldPointIds.data());
+  std::vector<vtkIdType> oldCellIds(numNewCells);
+  vtkIdMapInverter::Invert(&cellMap[0], numCells, oldCellIds.data());
+
+  // Pass through the points and point data that have been visited.
   //
-  //Pass through point data that has been visited
   outputPD->CopyAllocate(pd);
   outputCD->CopyAllocate(cd);
 
-  for (i=0; i < numPts; i++)
+  newPts = vtkPoints::New();
+
+  // Set the desired precision for the points in the output.
+  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
   {
-    if ( this->PointMap[i] > -1 )
+    vtkPointSet *inputPointSet = vtkPointSet::SafeDownCast(input);
+    if(inputPointSet && inputPointSet->GetPoints())
+    {
+      newPts->SetDataType(inputPointSet->GetPoints()->GetDataType());
+    }
+    else
     {
-      newPts->InsertPoint(this->PointMap[i],input->GetPoint(i));
-      outputPD->CopyData(pd,i,this->PointMap[i]);
+      newPts->SetDataType(VTK_FLOAT);
     }
   }
-
-  // if coloring regions; send down new scalar data
-  if ( this->ColorRegions )
+  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
   {
-    int idx = outputPD->AddArray(this->NewScalars);
-    outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
-    idx = outputCD->AddArray(this->NewCellScalars);
-    outputCD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
   }
-  this->NewScalars->Delete();
-  this->NewCellScalars->Delete();
+
+  newPts->SetNumberOfPoints(numNewPts);
+  outputPD->SetNumberOfTuples(numNewPts);
+  vtkIdTypeArray *newScalars = vtkIdTypeArray::New();
+  newScalars->SetName("RegionId");
+  newScalars->SetNumberOfTuples(numNewPts);
+  vtkConnectivityCopyPoints copyPoints = { input, oldPointIds.data(),
+                                           &pointRegions[0], newPts,
+                                           newScalars->GetPointer(0), pd,
+                                           outputPD };
+  vtkSMPTools::For(0, numNewPts, copyPoints);
 
   output->SetPoints(newPts);
   newPts->Delete();
 
-  // Create output cells
+  // Create output cells, with the region of each cell.
   //
-  if ( this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS ||
-  this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS ||
-  this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION ||
-  this->ExtractionMode == VTK_EXTRACT_ALL_REGIONS)
-  { // extract any cell that's been visited
-    for (cellId=0; cellId < numCells; cellId++)
+  vtkIdTypeArray *newCellScalars = vtkIdTypeArray::New();
+  newCellScalars->SetName("RegionId");
+  newCellScalars->SetNumberOfTuples(numNewCells);
+  vtkUnstructuredGrid *inputGrid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (inputGrid && inputGrid->GetFaces())
+  {
+    // special handling for polyhedron cells: their face streams are
+    // inserted one cell at a time.
+    vtkNew<vtkIdList> cellPts;
+    output->Allocate(numNewCells);
+    outputCD->SetNumberOfTuples(numNewCells);
+    for (vtkIdType newCellId=0; newCellId < numNewCells; newCellId++)
     {
-      if ( this->Visited[cellId] >= 0 )
+      vtkIdType cellId = oldCellIds[newCellId];
+      int cellType = inputGrid->GetCellType(cellId);
+      if (cellType == VTK_POLYHEDRON)
       {
-        // special handling for polyhedron cells
-        if (vtkUnstructuredGrid::SafeDownCast(input) &&
-            input->GetCellType(cellId) == VTK_POLYHEDRON)
-        {
-          vtkUnstructuredGrid::SafeDownCast(input)->
-            GetFaceStream(cellId, this->PointIds);
-          vtkUnstructuredGrid::ConvertFaceStreamPointIds(this->PointIds,
-                                                         this->PointMap);
-        }
-        else
-        {
-          input->GetCellPoints(cellId, this->PointIds);
-          for (i=0; i < this->PointIds->GetNumberOfIds(); i++)
-          {
-            id = this->PointMap[this->PointIds->GetId(i)];
-            this->PointIds->InsertId(i,id);
-          }
-        }
-        newCellId = output->InsertNextCell(input->GetCellType(cellId),
-                                           this->PointIds);
-        outputCD->CopyData(cd,cellId,newCellId);
+        inputGrid->GetFaceStream(cellId, cellPts.GetPointer());
+        vtkUnstructuredGrid::ConvertFaceStreamPointIds(cellPts.GetPointer(),
+                                                       &pointMap[0]);
       }
-    }
-  }
-  else if ( this->ExtractionMode == VTK_EXTRACT_SPECIFIED_REGIONS )
-  {
-    for (cellId=0; cellId < numCells; cellId++)
-    {
-      int inReg, regionId;
-      if ( (regionId=this->Visited[cellId]) >= 0 )
+      else
       {
-        for (inReg=0,i=0; i<this->SpecifiedRegionIds->GetNumberOfIds(); i++)
+        inputGrid->GetCellPoints(cellId, cellPts.GetPointer());
+        for (i=0; i < cellPts->GetNumberOfIds(); i++)
         {
-          if ( regionId == this->SpecifiedRegionIds->GetId(i) )
-          {
-            inReg = 1;
-            break;
-          }
-        }
-        if ( inReg )
-        {
-          // special handling for polyhedron cells
-          if (vtkUnstructuredGrid::SafeDownCast(input) &&
-              input->GetCellType(cellId) == VTK_POLYHEDRON)
-          {
-            vtkUnstructuredGrid::SafeDownCast(input)->
-              GetFaceStream(cellId, this->PointIds);
-            vtkUnstructuredGrid::ConvertFaceStreamPointIds(this->PointIds,
-                                                           this->PointMap);
-          }
-          else
-          {
-            input->GetCellPoints(cellId, this->PointIds);
-            for (i=0; i < this->PointIds->GetNumberOfIds(); i++)
-            {
-              id = this->PointMap[this->PointIds->GetId(i)];
-              this->PointIds->InsertId(i,id);
-            }
-          }
-          newCellId = output->InsertNextCell(input->GetCellType(cellId),
-                                             this->PointIds);
-          outputCD->CopyData(cd,cellId,newCellId);
+          cellPts->SetId(i, pointMap[cellPts->GetId(i)]);
         }
       }
+      output->InsertNextCell(cellType, cellPts.GetPointer());
+      newCellScalars->SetValue(newCellId, cellRegions[cellId]);
     }
+    outputCD->GatherData(cd, oldCellIds.data(), 0, numNewCells);
   }
-  else //extract largest region
+  else
   {
-    for (cellId=0; cellId < numCells; cellId++)
-    {
-      if ( this->Visited[cellId] == largestRegionId )
-      {
-        // special handling for polyhedron cells
-        if (vtkUnstructuredGrid::SafeDownCast(input) &&
-            input->GetCellType(cellId) == VTK_POLYHEDRON)
-        {
-          vtkUnstructuredGrid::SafeDownCast(input)->
-            GetFaceStream(cellId, this->PointIds);
-          vtkUnstructuredGrid::ConvertFaceStreamPointIds(this->PointIds,
-                                                         this->PointMap);
-        }
-        else
-        {
-          input->GetCellPoints(cellId, this->PointIds);
-          for (i=0; i < this->PointIds->GetNumberOfIds(); i++)
-          {
-            id = this->PointMap[this->PointIds->GetId(i)];
-            this->PointIds->InsertId(i,id);
-          }
-        }
-        newCellId = output->InsertNextCell(input->GetCellType(cellId),
-                                           this->PointIds);
-        outputCD->CopyData(cd,cellId,newCellId);
-      }
-    }
+    vtkUnsignedCharArray *types = vtkUnsignedCharArray::New();
+    types->SetNumberOfValues(numNewCells);
+    vtkIdTypeArray *newLocations = vtkIdTypeArray::New();
+    newLocations->SetNumberOfValues(numNewCells);
+    vtkCellArray *newCells = vtkCellArray::New();
+    vtkIdType *connectivity = newCells->WritePointer(numNewCells, connSize);
+    outputCD->SetNumberOfTuples(numNewCells);
+    vtkConnectivityCopyCells copyCells;
+    copyCells.Input = input;
+    copyCells.OldCellIds = oldCellIds.data();
+    copyCells.CellRegions = &cellRegions[0];
+    copyCells.PointMap = &pointMap[0];
+    copyCells.Locations = &locations[0];
+    copyCells.Connectivity = connectivity;
+    copyCells.Types = types->GetPointer(0);
+    copyCells.NewLocations = newLocations->GetPointer(0);
+    copyCells.NewCellScalars = newCellScalars->GetPointer(0);
+    copyCells.InCD = cd;
+    copyCells.OutCD = outputCD;
+    vtkSMPTools::For(0, numNewCells, copyCells);
+    output->SetCells(types, newLocations, newCells);
+    types->Delete();
+    newLocations->Delete();
+    newCells->Delete();
   }
 
-  delete [] this->Visited;
-  delete [] this->PointMap;
-  this->PointIds->Delete();
-  this->CellIds->Delete();
-  output->Squeeze();
-  vtkDataArray* outScalars = nullptr;
-  if (this->ColorRegions && (outScalars=output->GetPointData()->GetScalars()))
+  // if coloring regions; send down new scalar data
+  if ( this->ColorRegions )
   {
-    outScalars->Resize(output->GetNumberOfPoints());
+    int idx = outputPD->AddArray(newScalars);
+    outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+    idx = outputCD->AddArray(newCellScalars);
+    outputCD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
   }
+  newScalars->Delete();
+  newCellScalars->Delete();
+
+  output->Squeeze();
 
   int num = this->GetNumberOfExtractedRegions();
-  int count = 0;
+  vtkIdType count = 0;
 
   for (int ii = 0; ii < num; ii++)
   {
@@ -438,90 +480,6 @@ int vtkConnectivityFilter::RequestData(
   return 1;
 }
 
-
-// Mark current cell as visited and assign region number.  Note:
-// traversal occurs across shared vertices.
-//
-void vtkConnectivityFilter::TraverseAndMark (vtkDataSet *input)
-{
-  vtkIdType i, j, k, cellId, numIds, ptId, numPts, numCells;
-  vtkIdList *tmpWave;
-
-  while ( (numIds=this->Wave->GetNumberOfIds()) > 0 )
-  {
-    for ( i=0; i < numIds; i++ )
-    {
-      cellId = this->Wave->GetId(i);
-      if ( this->Visited[cellId] < 0 )
-      {
-        this->NewCellScalars->SetValue(cellId, this->RegionNumber);
-        this->Visited[cellId] = this->RegionNumber;
-        this->NumCellsInRegion++;
-        input->GetCellPoints(cellId, this->PointIds);
-
-        numPts = this->PointIds->GetNumberOfIds();
-        for (j=0; j < numPts; j++)
-        {
-          if ( this->PointMap[ptId=this->PointIds->GetId(j)] < 0 )
-          {
-            this->PointMap[ptId] = this->PointNumber++;
-            this->NewScalars->SetValue(this->PointMap[ptId],
-                                       this->RegionNumber);
-          }
-
-          input->GetPointCells(ptId,this->CellIds);
-
-          // check connectivity criterion (geometric + scalar)
-          numCells = this->CellIds->GetNumberOfIds();
-          for (k=0; k < numCells; k++)
-          {
-            cellId = this->CellIds->GetId(k);
-            if ( this->InScalars )
-            {
-              int numScalars, ii;
-              double s, range[2];
-
-              input->GetCellPoints(cellId, this->NeighborCellPointIds);
-              numScalars = this->NeighborCellPointIds->GetNumberOfIds();
-              this->CellScalars->SetNumberOfComponents(this->InScalars->GetNumberOfComponents());
-              this->CellScalars->SetNumberOfTuples(numScalars);
-              this->InScalars->GetTuples(this->NeighborCellPointIds,
-                                         this->CellScalars);
-              range[0] = VTK_DOUBLE_MAX; range[1] = -VTK_DOUBLE_MAX;
-              for (ii=0; ii < numScalars;  ii++)
-              {
-                s = this->CellScalars->GetComponent(ii,0);
-                if ( s < range[0] )
-                {
-                  range[0] = s;
-                }
-                if ( s > range[1] )
-                {
-                  range[1] = s;
-                }
-              }
-              if ( range[1] >= this->ScalarRange[0] &&
-                   range[0] <= this->ScalarRange[1] )
-              {
-                this->Wave2->InsertNextId(cellId);
-              }
-            }
-            else
-            {
-              this->Wave2->InsertNextId(cellId);
-            }
-          }//for all cells using this point
-        }//for all points of this cell
-      }//if cell not yet visited
-    }//for all cells in this wave
-
-    tmpWave = this->Wave;
-    this->Wave = this->Wave2;
-    this->Wave2 = tmpWave;
-    tmpWave->Reset();
-  } //while wave is not empty
-}
-
 // Obtain the number of connected regions.
 int vtkConnectivityFilter::GetNumberOfExtractedRegions()
 {
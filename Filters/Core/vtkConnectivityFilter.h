@@ -43,6 +43,12 @@
  * structure. These voxels can then be contoured or processed by other
  * visualization filters.
  *
+ * The regions are found in parallel with vtkSMPTools, by a union-find over
+ * the cells and their points, and are numbered in the order of their lowest
+ * cell id whatever the number of threads. The output points keep the order
+ * of the input points. When ColorRegions is on, the RegionId cell array
+ * gives the region of each output cell.
+ *
  * @sa
  * vtkPolyDataConnectivityFilter
 */
@@ -61,10 +67,8 @@
 #define VTK_EXTRACT_CLOSEST_POINT_REGION 6
 
 class vtkDataArray;
-class vtkFloatArray;
 class vtkIdList;
 class vtkIdTypeArray;
-class vtkIntArray;
 
 class VTKFILTERSCORE_EXPORT vtkConnectivityFilter : public vtkUnstructuredGridAlgorithm
 {
@@ -201,24 +205,6 @@ protected:
   int ScalarConnectivity;
   double ScalarRange[2];
 
-  void TraverseAndMark(vtkDataSet *input);
-
-private:
-  // used to support algorithm execution
-  vtkFloatArray *CellScalars;
-  vtkIdList *NeighborCellPointIds;
-  vtkIdType *Visited;
-  vtkIdType *PointMap;
-  vtkIdTypeArray *NewScalars;
-  vtkIdTypeArray *NewCellScalars;
-  vtkIdType RegionNumber;
-  vtkIdType PointNumber;
-  vtkIdType NumCellsInRegion;
-  vtkDataArray *InScalars;
-  vtkIdList *Wave;
-  vtkIdList *Wave2;
-  vtkIdList *PointIds;
-  vtkIdList *CellIds;
 private:
   vtkConnectivityFilter(const vtkConnectivityFilter&) VTK_DELETE_FUNCTION;
   void operator=(const vtkConnectivityFilter&) VTK_DELETE_FUNCTION;
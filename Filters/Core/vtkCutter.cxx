@@ -38,11 +38,15 @@
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkSynchronizedTemplates3D.h"
 #include "vtkSynchronizedTemplatesCutter3D.h"
+#include "vtkUnstructuredGrid.h"
 #include "vtkUnstructuredGridBase.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
@@ -52,6 +56,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkCutter);
 vtkCxxSetObjectMacro(vtkCutter,CutFunction,vtkImplicitFunction);
@@ -318,6 +323,10 @@ void vtkCutter::RectilinearGridCutter(vtkDataSet *dataSetInput,
 }
 
 namespace{
+// The number of consecutive cells cut together by the threaded unstructured
+// grid cutter, in each pass.
+const vtkIdType CutterBatchSize = 16384;
+
 //----------------------------------------------------------------------------
 // Find the first visible cell in a vtkStructuredGrid.
 //
@@ -706,6 +715,18 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
 //----------------------------------------------------------------------------
 void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
 {
+  // Cut large unstructured grids with several threads when the output can
+  // be the same as the serial one.
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (grid && this->SortBy == VTK_SORT_BY_VALUE && this->GenerateTriangles &&
+      (!this->Locator || vtkMergePoints::SafeDownCast(this->Locator)) &&
+      grid->GetNumberOfCells() > CutterBatchSize &&
+      vtkSMPTools::GetEstimatedNumberOfThreads() > 1)
+  {
+    this->ThreadedUnstructuredGridCutter(grid, output);
+    return;
+  }
+
   vtkIdType i;
   int iter;
   vtkDoubleArray *cellScalars;
@@ -1014,6 +1035,608 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
   output->Squeeze();
 }
 
+namespace
+{
+//----------------------------------------------------------------------------
+// The output of a batch of cells. It is only allocated when some cells of
+// the batch are cut.
+struct vtkCutterBatch
+{
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkCellArray> Verts;
+  vtkSmartPointer<vtkCellArray> Lines;
+  vtkSmartPointer<vtkCellArray> Polys;
+  vtkSmartPointer<vtkPointData> PointData;
+  vtkSmartPointer<vtkCellData> CellData;
+  std::vector<vtkIdType> Buckets; // locator bucket of each point
+};
+
+//----------------------------------------------------------------------------
+// A vtkMergePoints giving the bucket of the points it inserted. The serial
+// cutter only merges identical points found in the same bucket, so the
+// points of the batches are merged by bucket and coordinates.
+class vtkCutterMergePoints : public vtkMergePoints
+{
+public:
+  static vtkCutterMergePoints *New();
+  vtkTypeMacro(vtkCutterMergePoints, vtkMergePoints);
+
+  void GetPointBuckets(std::vector<vtkIdType> &buckets)
+  {
+    buckets.resize(this->Points->GetNumberOfPoints());
+    for (vtkIdType bucket = 0; bucket < this->NumberOfBuckets; ++bucket)
+    {
+      vtkIdList *ptIds = this->HashTable[bucket];
+      vtkIdType numIds = ptIds ? ptIds->GetNumberOfIds() : 0;
+      for (vtkIdType i = 0; i < numIds; ++i)
+      {
+        buckets[ptIds->GetId(i)] = bucket;
+      }
+    }
+  }
+
+protected:
+  vtkCutterMergePoints() {}
+  ~vtkCutterMergePoints() VTK_OVERRIDE {}
+
+private:
+  vtkCutterMergePoints(const vtkCutterMergePoints&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkCutterMergePoints&) VTK_DELETE_FUNCTION;
+};
+
+vtkStandardNewMacro(vtkCutterMergePoints);
+
+//----------------------------------------------------------------------------
+// Cut the cells of one dimensionality into their batch output, like a pass
+// of the serial cutter sorting by value. The points of a batch are merged
+// by a vtkMergePoints with the buckets of the serial locator.
+struct vtkCutterCutBatches
+{
+  vtkUnstructuredGrid *Input;
+  vtkDoubleArray *CutScalars;
+  vtkPointData *InPD;
+  vtkCellData *InCD;
+  const double *ContourValues;
+  int NumberOfContours;
+  const unsigned char *CellTypeDimensions;
+  int PointsType;
+  const double *Bounds;
+  const int *Divisions;
+  int Dimensionality;
+  vtkCutterBatch *Batches;
+
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocalObject<vtkDoubleArray> CellScalars;
+  vtkSMPThreadLocalObject<vtkIdList> CellPointIds;
+  vtkSMPThreadLocalObject<vtkIdList> CutCells;
+  vtkSMPThreadLocalObject<vtkCutterMergePoints> Locator;
+  vtkSMPThreadLocal<vtkIdType> UnknownCellTypes;
+
+  vtkCutterCutBatches() : UnknownCellTypes(0) {}
+
+  void Initialize()
+  {
+    vtkDoubleArray *cellScalars = this->CellScalars.Local();
+    cellScalars->SetNumberOfComponents(
+      this->CutScalars->GetNumberOfComponents());
+    cellScalars->Allocate(
+      VTK_CELL_SIZE * this->CutScalars->GetNumberOfComponents());
+  }
+
+  void operator()(vtkIdType beginBatch, vtkIdType endBatch)
+  {
+    for (vtkIdType batchId = beginBatch; batchId < endBatch; ++batchId)
+    {
+      this->CutBatch(batchId);
+    }
+  }
+
+  void Reduce()
+  {
+  }
+
+  void CutBatch(vtkIdType batchId)
+  {
+    vtkIdType beginCell = batchId * CutterBatchSize;
+    vtkIdType endCell = std::min(beginCell + CutterBatchSize,
+                                 this->Input->GetNumberOfCells());
+    const double *scalars = this->CutScalars->GetPointer(0);
+    const double *contourValuesEnd =
+      this->ContourValues + this->NumberOfContours;
+    vtkIdList *cellPointIds = this->CellPointIds.Local();
+    vtkIdList *cutCells = this->CutCells.Local();
+    cutCells->Reset();
+
+    // Find the cells of the batch to cut.
+    for (vtkIdType cellId = beginCell; cellId < endCell; ++cellId)
+    {
+      int cellType = this->Input->GetCellType(cellId);
+      if (cellType >= VTK_NUMBER_OF_CELL_TYPES)
+      {
+        ++this->UnknownCellTypes.Local();
+        continue;
+      }
+      if (this->CellTypeDimensions[cellType] != this->Dimensionality)
+      {
+        continue;
+      }
+
+      vtkIdType npts;
+      const vtkIdType *pts;
+      this->Input->GetCellPoints(cellId, npts, pts, cellPointIds);
+      if (npts < 1)
+      {
+        continue;
+      }
+      double range[2];
+      range[0] = range[1] = scalars[pts[0]];
+      for (vtkIdType i = 1; i < npts; ++i)
+      {
+        range[0] = std::min(range[0], scalars[pts[i]]);
+        range[1] = std::max(range[1], scalars[pts[i]]);
+      }
+
+      const double *contourIter = this->ContourValues;
+      for (; contourIter != contourValuesEnd; ++contourIter)
+      {
+        if (*contourIter >= range[0] && *contourIter <= range[1])
+        {
+          break;
+        }
+      }
+      if (contourIter == contourValuesEnd)
+      {
+        continue;
+      }
+
+      cutCells->InsertNextId(cellId);
+    }
+
+    vtkIdType numCutCells = cutCells->GetNumberOfIds();
+    if (numCutCells == 0)
+    {
+      return;
+    }
+
+    // Same estimate as the serial cutter, for the cells of the batch.
+    vtkIdType estimatedSize = static_cast<vtkIdType>(
+      pow(static_cast<double>(numCutCells), .75)) * this->NumberOfContours;
+    estimatedSize = estimatedSize / 1024 * 1024; //multiple of 1024
+    if (estimatedSize < 1024)
+    {
+      estimatedSize = 1024;
+    }
+
+    vtkCutterBatch &batch = this->Batches[batchId];
+    batch.Points = vtkSmartPointer<vtkPoints>::New();
+    batch.Points->SetDataType(this->PointsType);
+    batch.Points->Allocate(estimatedSize, estimatedSize / 2);
+    batch.Verts = vtkSmartPointer<vtkCellArray>::New();
+    batch.Verts->Allocate(estimatedSize, estimatedSize / 2);
+    batch.Lines = vtkSmartPointer<vtkCellArray>::New();
+    batch.Lines->Allocate(estimatedSize, estimatedSize / 2);
+    batch.Polys = vtkSmartPointer<vtkCellArray>::New();
+    batch.Polys->Allocate(estimatedSize, estimatedSize / 2);
+    batch.PointData = vtkSmartPointer<vtkPointData>::New();
+    batch.PointData->InterpolateAllocate(this->InPD, estimatedSize,
+                                         estimatedSize / 2);
+    batch.CellData = vtkSmartPointer<vtkCellData>::New();
+    batch.CellData->CopyAllocate(this->InCD, estimatedSize,
+                                 estimatedSize / 2);
+
+    vtkCutterMergePoints *locator = this->Locator.Local();
+    locator->SetDivisions(this->Divisions[0], this->Divisions[1],
+                          this->Divisions[2]);
+    locator->InitPointInsertion(batch.Points, this->Bounds);
+
+    vtkGenericCell *cell = this->Cell.Local();
+    vtkDoubleArray *cellScalars = this->CellScalars.Local();
+    vtkContourHelper helper(locator, batch.Verts, batch.Lines, batch.Polys,
+                            this->InPD, this->InCD, batch.PointData,
+                            batch.CellData, estimatedSize, true);
+    for (vtkIdType i = 0; i < numCutCells; ++i)
+    {
+      vtkIdType cellId = cutCells->GetId(i);
+      this->Input->GetCell(cellId, cell);
+      this->CutScalars->GetTuples(cell->GetPointIds(), cellScalars);
+      for (const double *contourIter = this->ContourValues;
+           contourIter != contourValuesEnd; ++contourIter)
+      {
+        helper.Contour(cell, *contourIter, cellScalars, cellId);
+      }
+    }
+    locator->GetPointBuckets(batch.Buckets);
+    locator->Initialize(); //release the search structure
+  }
+};
+
+//----------------------------------------------------------------------------
+// Where the output of a batch goes in the merged output. The cells of the
+// batch are counted in the cell data, and as verts, lines and polys with
+// their connectivity entries.
+struct vtkCutterBatchOffsets
+{
+  vtkIdType Points;
+  vtkIdType Cells;
+  vtkIdType TypedCells[3];
+  vtkIdType Entries[3];
+};
+
+//----------------------------------------------------------------------------
+// Gather the points of all batches, in order, as doubles with their bucket.
+struct vtkCutterGatherPoints
+{
+  vtkCutterBatch *const *Batches;
+  const vtkCutterBatchOffsets *Offsets;
+  double *Coordinates;
+  vtkIdType *Buckets;
+
+  void operator()(vtkIdType beginBatch, vtkIdType endBatch)
+  {
+    for (vtkIdType b = beginBatch; b < endBatch; ++b)
+    {
+      vtkPoints *points = this->Batches[b]->Points;
+      double *x = this->Coordinates + 3 * this->Offsets[b].Points;
+      vtkIdType numPts = points->GetNumberOfPoints();
+      for (vtkIdType i = 0; i < numPts; ++i, x += 3)
+      {
+        points->GetPoint(i, x);
+      }
+      std::copy(this->Batches[b]->Buckets.begin(),
+                this->Batches[b]->Buckets.end(),
+                this->Buckets + this->Offsets[b].Points);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Order the points by bucket and coordinates, and the identical points by
+// index.
+struct vtkCutterPointLess
+{
+  const double *Coordinates;
+  const vtkIdType *Buckets;
+
+  bool operator()(vtkIdType a, vtkIdType b) const
+  {
+    if (this->Buckets[a] != this->Buckets[b])
+    {
+      return this->Buckets[a] < this->Buckets[b];
+    }
+    const double *xa = this->Coordinates + 3 * a;
+    const double *xb = this->Coordinates + 3 * b;
+    for (int i = 0; i < 3; ++i)
+    {
+      if (xa[i] != xb[i])
+      {
+        return xa[i] < xb[i];
+      }
+    }
+    return a < b;
+  }
+};
+
+//----------------------------------------------------------------------------
+// Map each point to the first point with the same bucket and coordinates,
+// which is the first of its run in the sorted order, and flag the first
+// points.
+struct vtkCutterFindDuplicates
+{
+  const double *Coordinates;
+  const vtkIdType *Buckets;
+  const vtkIdType *Order;
+  vtkIdType *FirstPoint;
+  vtkIdType *IsFirst;
+
+  bool SamePoint(vtkIdType a, vtkIdType b) const
+  {
+    const double *xa = this->Coordinates + 3 * a;
+    const double *xb = this->Coordinates + 3 * b;
+    return this->Buckets[a] == this->Buckets[b] &&
+      xa[0] == xb[0] && xa[1] == xb[1] && xa[2] == xb[2];
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkIdType first = i;
+      while (first > 0 && this->SamePoint(this->Order[first - 1],
+                                          this->Order[i]))
+      {
+        --first;
+      }
+      this->FirstPoint[this->Order[i]] = this->Order[first];
+      this->IsFirst[this->Order[i]] = (first == i ? 1 : 0);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the merged points, their point data, the cells with their new point
+// ids and the cell data of each batch to the output.
+struct vtkCutterMergeBatches
+{
+  vtkCutterBatch *const *Batches;
+  const vtkCutterBatchOffsets *Offsets;
+  const vtkIdType *FirstPoint;
+  const vtkIdType *NewPointIds;
+  vtkPoints *OutPoints;
+  vtkPointData *OutPD;
+  vtkCellData *OutCD;
+  vtkIdType *Cells[3];
+
+  void operator()(vtkIdType beginBatch, vtkIdType endBatch)
+  {
+    int numPointArrays = this->OutPD->GetNumberOfArrays();
+    int numCellArrays = this->OutCD->GetNumberOfArrays();
+    for (vtkIdType b = beginBatch; b < endBatch; ++b)
+    {
+      const vtkCutterBatch &batch = *this->Batches[b];
+      const vtkCutterBatchOffsets &offsets = this->Offsets[b];
+
+      vtkIdType numPts = batch.Points->GetNumberOfPoints();
+      for (vtkIdType i = 0; i < numPts; ++i)
+      {
+        vtkIdType ptId = offsets.Points + i;
+        if (this->FirstPoint[ptId] != ptId)
+        {
+          continue;
+        }
+        vtkIdType newId = this->NewPointIds[ptId];
+        double x[3];
+        batch.Points->GetPoint(i, x);
+        this->OutPoints->SetPoint(newId, x);
+        for (int a = 0; a < numPointArrays; ++a)
+        {
+          this->OutPD->GetAbstractArray(a)->SetTuple(
+            newId, i, batch.PointData->GetAbstractArray(a));
+        }
+      }
+
+      vtkCellArray *cellArrays[3] = { batch.Verts, batch.Lines, batch.Polys };
+      for (int type = 0; type < 3; ++type)
+      {
+        vtkIdType numEntries =
+          cellArrays[type]->GetNumberOfConnectivityEntries();
+        const vtkIdType *cells = cellArrays[type]->GetPointer();
+        vtkIdType *outCells = this->Cells[type] + offsets.Entries[type];
+        for (vtkIdType i = 0; i < numEntries; )
+        {
+          vtkIdType npts = cells[i];
+          outCells[i++] = npts;
+          for (vtkIdType end = i + npts; i < end; ++i)
+          {
+            outCells[i] =
+              this->NewPointIds[this->FirstPoint[offsets.Points + cells[i]]];
+          }
+        }
+      }
+
+      vtkIdType numCells = batch.CellData->GetNumberOfTuples();
+      for (int a = 0; a < numCellArrays; ++a)
+      {
+        vtkAbstractArray *outArray = this->OutCD->GetAbstractArray(a);
+        vtkAbstractArray *inArray = batch.CellData->GetAbstractArray(a);
+        for (vtkIdType i = 0; i < numCells; ++i)
+        {
+          outArray->SetTuple(offsets.Cells + i, i, inArray);
+        }
+      }
+    }
+  }
+};
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+// Threaded version of the unstructured grid cutter sorting by value. The
+// three passes of the serial cutter cut batches of consecutive cells in
+// parallel, each into its own points and cells. The batches are then
+// merged in their serial order: the points with identical coordinates in
+// the same locator bucket are merged by sorting them, keeping the first
+// one as vtkMergePoints does, so the output matches the serial cutter
+// exactly.
+void vtkCutter::ThreadedUnstructuredGridCutter(vtkUnstructuredGrid *input,
+                                               vtkPolyData *output)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkCellData *inCD = input->GetCellData();
+  vtkPointData *inPD = input->GetPointData();
+
+  // Set precision for the points in the output
+  int pointsType = VTK_FLOAT;
+  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    pointsType = input->GetPoints()->GetDataType();
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    pointsType = VTK_DOUBLE;
+  }
+
+  vtkNew<vtkDoubleArray> cutScalars;
+  cutScalars->SetNumberOfTuples(numPts);
+  this->CutFunction->FunctionValue(input->GetPoints()->GetData(),
+                                   cutScalars.GetPointer());
+
+  // Interpolate data along edge. If generating cut scalars, do necessary setup
+  vtkSmartPointer<vtkPointData> cutPD = inPD;
+  if (this->GenerateCutScalars)
+  {
+    cutPD = vtkSmartPointer<vtkPointData>::New();
+    cutPD->ShallowCopy(inPD);//copies original attributes
+    cutPD->SetScalars(cutScalars.GetPointer());
+  }
+
+  // Build the cells of the grid, if needed, before contouring them in
+  // parallel.
+  vtkNew<vtkIdList> cellPts;
+  input->GetCellPoints(0, cellPts.GetPointer());
+
+  unsigned char cellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+  vtkCutter::GetCellTypeDimensions(cellTypeDimensions);
+
+  // The batches use the buckets the serial cutter would use.
+  if ( this->Locator == nullptr )
+  {
+    this->CreateDefaultLocator();
+  }
+  int divisions[3];
+  static_cast<vtkMergePoints*>(this->Locator)->GetDivisions(divisions);
+  double bounds[6];
+  input->GetBounds(bounds);
+
+  vtkIdType numBatches = (numCells + CutterBatchSize - 1) / CutterBatchSize;
+  std::vector<vtkCutterBatch> batches(3 * numBatches);
+
+  vtkCutterCutBatches cutBatches;
+  cutBatches.Input = input;
+  cutBatches.CutScalars = cutScalars.GetPointer();
+  cutBatches.InPD = cutPD;
+  cutBatches.InCD = inCD;
+  cutBatches.ContourValues = this->ContourValues->GetValues();
+  cutBatches.NumberOfContours = this->ContourValues->GetNumberOfContours();
+  cutBatches.CellTypeDimensions = cellTypeDimensions;
+  cutBatches.PointsType = pointsType;
+  cutBatches.Bounds = bounds;
+  cutBatches.Divisions = divisions;
+
+  // We skip 0d cells (points), because they cannot be cut (generate no data).
+  int abortExecute = 0;
+  for (int dimensionality = 1; dimensionality <= 3 && !abortExecute;
+       ++dimensionality)
+  {
+    cutBatches.Dimensionality = dimensionality;
+    cutBatches.Batches = &batches[(dimensionality - 1) * numBatches];
+    vtkSMPTools::For(0, numBatches, 1, cutBatches);
+
+    this->UpdateProgress(dimensionality / 4.0);
+    abortExecute = this->GetAbortExecute();
+  }
+
+  vtkIdType numUnknownCells = 0;
+  for (vtkSMPThreadLocal<vtkIdType>::iterator iter =
+         cutBatches.UnknownCellTypes.begin();
+       iter != cutBatches.UnknownCellTypes.end(); ++iter)
+  {
+    numUnknownCells += *iter;
+  }
+  if (numUnknownCells > 0)
+  {
+    vtkErrorMacro("Skipped " << numUnknownCells
+                  << " cells of unknown cell type");
+  }
+
+  // The batches with some output, in the order of the serial cutter.
+  std::vector<vtkCutterBatch*> cutBatchList;
+  for (size_t b = 0; b < batches.size(); ++b)
+  {
+    if (batches[b].Points)
+    {
+      cutBatchList.push_back(&batches[b]);
+    }
+  }
+  vtkIdType numCutBatches = static_cast<vtkIdType>(cutBatchList.size());
+
+  // Where each batch goes in the output. A pass only generates cells of
+  // one type (verts from lines, lines from polygons, polygons from
+  // volumes), so keeping each type in batch order and numbering the cell
+  // data in batch order gives the serial order of the cells.
+  std::vector<vtkCutterBatchOffsets> offsets(numCutBatches + 1);
+  vtkCutterBatchOffsets total = { 0, 0, { 0, 0, 0 }, { 0, 0, 0 } };
+  for (vtkIdType b = 0; b < numCutBatches; ++b)
+  {
+    const vtkCutterBatch &batch = *cutBatchList[b];
+    offsets[b] = total;
+    vtkCellArray *cellArrays[3] = { batch.Verts, batch.Lines, batch.Polys };
+    total.Points += batch.Points->GetNumberOfPoints();
+    total.Cells += batch.CellData->GetNumberOfTuples();
+    for (int type = 0; type < 3; ++type)
+    {
+      total.TypedCells[type] += cellArrays[type]->GetNumberOfCells();
+      total.Entries[type] += cellArrays[type]->GetNumberOfConnectivityEntries();
+    }
+  }
+  offsets[numCutBatches] = total;
+
+  // Merge the identical points of each bucket.
+  std::vector<double> coordinates(3 * total.Points);
+  std::vector<vtkIdType> buckets(total.Points);
+  vtkCutterGatherPoints gatherPoints = { cutBatchList.data(), offsets.data(),
+                                         coordinates.data(), buckets.data() };
+  vtkSMPTools::For(0, numCutBatches, 1, gatherPoints);
+
+  std::vector<vtkIdType> order(total.Points);
+  for (vtkIdType i = 0; i < total.Points; ++i)
+  {
+    order[i] = i;
+  }
+  vtkCutterPointLess pointLess = { coordinates.data(), buckets.data() };
+  vtkSMPTools::Sort(order.begin(), order.end(), pointLess);
+
+  std::vector<vtkIdType> firstPoint(total.Points);
+  std::vector<vtkIdType> newPointIds(total.Points);
+  vtkCutterFindDuplicates findDuplicates = { coordinates.data(),
+    buckets.data(), order.data(), firstPoint.data(), newPointIds.data() };
+  vtkSMPTools::For(0, total.Points, findDuplicates);
+  vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(newPointIds.begin(),
+    newPointIds.end(), newPointIds.begin(), vtkIdType(0));
+  std::vector<double>().swap(coordinates);
+  std::vector<vtkIdType>().swap(buckets);
+  std::vector<vtkIdType>().swap(order);
+
+  // Allocate the output, and copy the batches to it.
+  vtkNew<vtkPoints> newPoints;
+  newPoints->SetDataType(pointsType);
+  newPoints->SetNumberOfPoints(numNewPts);
+
+  vtkPointData *outPD = output->GetPointData();
+  outPD->InterpolateAllocate(cutPD, numNewPts);
+  for (int a = 0; a < outPD->GetNumberOfArrays(); ++a)
+  {
+    outPD->GetAbstractArray(a)->SetNumberOfTuples(numNewPts);
+  }
+  vtkCellData *outCD = output->GetCellData();
+  outCD->CopyAllocate(inCD, total.Cells);
+  for (int a = 0; a < outCD->GetNumberOfArrays(); ++a)
+  {
+    outCD->GetAbstractArray(a)->SetNumberOfTuples(total.Cells);
+  }
+
+  vtkNew<vtkCellArray> newCells[3];
+  vtkCutterMergeBatches mergeBatches;
+  mergeBatches.Batches = cutBatchList.data();
+  mergeBatches.Offsets = offsets.data();
+  mergeBatches.FirstPoint = firstPoint.data();
+  mergeBatches.NewPointIds = newPointIds.data();
+  mergeBatches.OutPoints = newPoints.GetPointer();
+  mergeBatches.OutPD = outPD;
+  mergeBatches.OutCD = outCD;
+  for (int type = 0; type < 3; ++type)
+  {
+    mergeBatches.Cells[type] = newCells[type]->WritePointer(
+      total.TypedCells[type], total.Entries[type]);
+  }
+  vtkSMPTools::For(0, numCutBatches, 1, mergeBatches);
+
+  output->SetPoints(newPoints.GetPointer());
+  if (total.TypedCells[0])
+  {
+    output->SetVerts(newCells[0].GetPointer());
+  }
+  if (total.TypedCells[1])
+  {
+    output->SetLines(newCells[1].GetPointer());
+  }
+  if (total.TypedCells[2])
+  {
+    output->SetPolys(newCells[2].GetPointer());
+  }
+  output->Squeeze();
+}
+
 //----------------------------------------------------------------------------
 // Specify a spatial locator for merging points. By default,
 // an instance of vtkMergePoints is used.
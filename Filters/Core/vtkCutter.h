@@ -38,6 +38,12 @@
  * By default, if an implicit function is set it is used to clip the data
  * set, otherwise the dataset scalars are used to perform the clipping.
  *
+ * Unstructured grids are cut with several threads (see vtkSMPTools) when
+ * sorting by value, generating triangles and merging points with a
+ * vtkMergePoints locator (the default). Each thread cuts batches of cells
+ * into its own output, and the batches are then merged in parallel. The
+ * output is identical to the one of the serial algorithm, used otherwise.
+ *
  * @sa
  * vtkImplicitFunction vtkClipPolyData
 */
@@ -59,6 +65,7 @@ class vtkSynchronizedTemplates3D;
 class vtkSynchronizedTemplatesCutter3D;
 class vtkGridSynchronizedTemplates3D;
 class vtkRectilinearSynchronizedTemplates;
+class vtkUnstructuredGrid;
 
 class VTKFILTERSCORE_EXPORT vtkCutter : public vtkPolyDataAlgorithm
 {
@@ -231,6 +238,8 @@ protected:
   int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *) VTK_OVERRIDE;
   int FillInputPortInformation(int port, vtkInformation *info) VTK_OVERRIDE;
   void UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output);
+  void ThreadedUnstructuredGridCutter(vtkUnstructuredGrid *input,
+                                      vtkPolyData *output);
   void DataSetCutter(vtkDataSet *input, vtkPolyData *output);
   void StructuredPointsCutter(vtkDataSet *, vtkPolyData *,
                               vtkInformation *, vtkInformationVector **,
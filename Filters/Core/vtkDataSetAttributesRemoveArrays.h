@@ -0,0 +1,75 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataSetAttributesRemoveArrays.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * Helpers of vtkCellDataToPointData and vtkPointDataToCellData, which
+ * remove the output arrays they did not map when their execution was
+ * aborted, rather than leaving these arrays without tuples.
+ *
+ * @sa
+ *  vtkCellDataToPointData vtkPointDataToCellData
+ * @warning
+ *  Do not include this file in a header file.
+*/
+
+#ifndef vtkDataSetAttributesRemoveArrays_h
+#define vtkDataSetAttributesRemoveArrays_h
+
+#include "vtkAbstractArray.h"
+#include "vtkDataSetAttributes.h"
+
+#include <vector>
+
+/**
+ * Remove the given arrays from the attributes.
+ */
+inline void vtkDataSetAttributesRemoveArrays(
+  vtkDataSetAttributes *attributes,
+  const std::vector<vtkAbstractArray*> &arrays)
+{
+  for (size_t i = 0; i < arrays.size(); ++i)
+  {
+    for (int j = attributes->GetNumberOfArrays(); j--;)
+    {
+      if (attributes->GetAbstractArray(j) == arrays[i])
+      {
+        attributes->RemoveArray(j);
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * Remove the arrays of the attributes that receive the values of the
+ * arrays fromIndex to numArrays - 1 of the attributes given to the last
+ * CopyAllocate() or InterpolateAllocate() (see
+ * vtkDataSetAttributes::GetTargetArray()).
+ */
+inline void vtkDataSetAttributesRemoveTargetArrays(
+  vtkDataSetAttributes *attributes, int fromIndex, int numArrays)
+{
+  std::vector<vtkAbstractArray*> targets;
+  for (int i = fromIndex; i < numArrays; ++i)
+  {
+    if (vtkAbstractArray *target = attributes->GetTargetArray(i))
+    {
+      targets.push_back(target);
+    }
+  }
+  vtkDataSetAttributesRemoveArrays(attributes, targets);
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkDataSetAttributesRemoveArrays.h
@@ -245,6 +245,7 @@ int vtkDecimatePro::RequestData(
     meshPD->DeepCopy(inPD);
     meshPD->CopyAllocate(meshPD, input->GetNumberOfPoints());
 
+    this->Mesh->EditableOn();
     this->Mesh->BuildLinks();
   }
   else
@@ -444,6 +444,7 @@ int vtkDelaunay2D::RequestData(
 
   this->Mesh->SetPoints(points);
   this->Mesh->SetPolys(triangles);
+  this->Mesh->EditableOn();
   this->Mesh->BuildLinks(); //build cell structure
 
   // For each point; find triangle containing point. Then evaluate three
@@ -851,6 +851,7 @@ vtkUnstructuredGrid *vtkDelaunay3D::InitPointInsertion(double center[3],
 
   Mesh->SetPoints(points);
   points->Delete();
+  Mesh->EditableOn();
   Mesh->BuildLinks();
 
   // Keep track of change in references to points
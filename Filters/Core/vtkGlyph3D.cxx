@@ -14,18 +14,25 @@
 =========================================================================*/
 #include "vtkGlyph3D.h"
 
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntArray.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
@@ -33,6 +40,9 @@
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkGlyph3D);
 vtkCxxSetObjectMacro(vtkGlyph3D, SourceTransform, vtkTransform);
 
@@ -58,6 +68,7 @@ vtkGlyph3D::vtkGlyph3D()
   this->SetPointIdsName("InputPointIds");
   this->SetNumberOfInputPorts(2);
   this->FillCellData = 0;
+  this->InstancedOutput = 0;
   this->SourceTransform = nullptr;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
 
@@ -119,6 +130,396 @@ bool vtkGlyph3D::Execute(
   return this->Execute(input, sourceVector, output, inSScalars, inVectors);
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+
+// Whether the array can be read from several threads. The arrays of other
+// layouts than AOS and SOA, e.g. mapped arrays, may go through a shared
+// tuple buffer.
+bool vtkGlyphCanReadInParallel(vtkDataArray *array)
+{
+  return array == nullptr ||
+    array->GetArrayType() == vtkAbstractArray::AoSDataArrayTemplate ||
+    array->GetArrayType() == vtkAbstractArray::SoADataArrayTemplate;
+}
+
+//----------------------------------------------------------------------------
+// What a glyph needs from its input point.
+struct vtkGlyph
+{
+  double Matrix[4][4];
+  double Point[3];
+  double Vector[3];
+  double VectorMagnitude;
+  double Scale; // the data scale, before the scale factor
+  int SourceIndex;
+};
+
+//----------------------------------------------------------------------------
+// The parameters of the filter, to compute the glyphs from several threads.
+struct vtkGlyphParameters
+{
+  vtkDataSet *Input;
+  vtkDataArray *Scalars;
+  vtkDataArray *Vectors; // the vectors or normals, if the glyphs use them
+  int Scaling;
+  int ScaleMode;
+  double ScaleFactor;
+  double Range[2];
+  double Den;
+  int Orient;
+  int Clamping;
+  int IndexMode;
+  int NumberOfSources;
+
+  // Compute the glyph of an input point like the sequential loop does, with
+  // a transform owned by the calling thread.
+  void GetGlyph(vtkIdType ptId, vtkTransform *trans, vtkGlyph& glyph) const
+  {
+    double scalex = 1.0, scaley = 1.0, scalez = 1.0, s = 0.0;
+    double *v = glyph.Vector;
+    double& vMag = glyph.VectorMagnitude;
+    vMag = 0.0;
+
+    if (this->Scalars)
+    {
+      s = this->Scalars->GetComponent(ptId, 0);
+      if (this->ScaleMode == VTK_SCALE_BY_SCALAR ||
+          this->ScaleMode == VTK_DATA_SCALING_OFF)
+      {
+        scalex = scaley = scalez = s;
+      }
+    }
+
+    if (this->Vectors)
+    {
+      v[0] = 0;
+      v[1] = 0;
+      v[2] = 0;
+      this->Vectors->GetTuple(ptId, v);
+      vMag = vtkMath::Norm(v);
+      if (this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS)
+      {
+        scalex = v[0];
+        scaley = v[1];
+        scalez = v[2];
+      }
+      else if (this->ScaleMode == VTK_SCALE_BY_VECTOR)
+      {
+        scalex = scaley = scalez = vMag;
+      }
+    }
+
+    // Clamp data scale if enabled
+    if (this->Clamping)
+    {
+      scalex = (scalex < this->Range[0] ? this->Range[0] :
+                (scalex > this->Range[1] ? this->Range[1] : scalex));
+      scalex = (scalex - this->Range[0]) / this->Den;
+      scaley = (scaley < this->Range[0] ? this->Range[0] :
+                (scaley > this->Range[1] ? this->Range[1] : scaley));
+      scaley = (scaley - this->Range[0]) / this->Den;
+      scalez = (scalez < this->Range[0] ? this->Range[0] :
+                (scalez > this->Range[1] ? this->Range[1] : scalez));
+      scalez = (scalez - this->Range[0]) / this->Den;
+    }
+    glyph.Scale = scalex;
+
+    // Compute index into table of glyphs
+    glyph.SourceIndex = 0;
+    if (this->IndexMode != VTK_INDEXING_OFF)
+    {
+      double value = this->IndexMode == VTK_INDEXING_BY_SCALAR ? s : vMag;
+      int index = static_cast<int>(
+        (value - this->Range[0])*this->NumberOfSources / this->Den);
+      glyph.SourceIndex = (index < 0 ? 0 :
+        (index >= this->NumberOfSources ? (this->NumberOfSources-1) : index));
+    }
+
+    // translate Source to Input point, orient, and scale
+    trans->Identity();
+    double *x = glyph.Point;
+    this->Input->GetPoint(ptId, x);
+    trans->Translate(x[0], x[1], x[2]);
+
+    if (this->Vectors && this->Orient && vMag > 0.0)
+    {
+      // if there is no y or z component
+      if (v[1] == 0.0 && v[2] == 0.0)
+      {
+        if (v[0] < 0) //just flip x if we need to
+        {
+          trans->RotateWXYZ(180.0, 0, 1, 0);
+        }
+      }
+      else
+      {
+        trans->RotateWXYZ(180.0, (v[0]+vMag) / 2.0, v[1] / 2.0, v[2] / 2.0);
+      }
+    }
+
+    if (this->Scaling)
+    {
+      if (this->ScaleMode == VTK_DATA_SCALING_OFF)
+      {
+        scalex = scaley = scalez = this->ScaleFactor;
+      }
+      else
+      {
+        scalex *= this->ScaleFactor;
+        scaley *= this->ScaleFactor;
+        scalez *= this->ScaleFactor;
+      }
+      trans->Scale(scalex == 0.0 ? 1.0e-10 : scalex,
+                   scaley == 0.0 ? 1.0e-10 : scaley,
+                   scalez == 0.0 ? 1.0e-10 : scalez);
+    }
+
+    vtkMatrix4x4::DeepCopy(*glyph.Matrix, trans->GetMatrix());
+  }
+};
+
+//----------------------------------------------------------------------------
+// Return the cell array holding all the cells of the source (0 for the
+// verts, 1 for the lines, 2 for the polys and 3 for the strips), or -1 if
+// they are of several kinds. The glyphs of such a source interleave cells of
+// several kinds, and are copied sequentially.
+int vtkGlyphSourceCellKind(vtkPolyData *source)
+{
+  vtkIdType numCells = source->GetNumberOfCells();
+  vtkIdType counts[4] = { source->GetNumberOfVerts(),
+                          source->GetNumberOfLines(),
+                          source->GetNumberOfPolys(),
+                          source->GetNumberOfStrips() };
+  for (int kind = 0; kind < 4; kind++)
+  {
+    if (counts[kind] == numCells)
+    {
+      return numCells > 0 ? kind : 2;
+    }
+  }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+// Compute the glyphs of an index range of the glyphed points, and write
+// their output in place. Each glyph adds NumberOfGlyphPoints points, which
+// are the transformed source points, or the input point if the output is
+// instanced.
+struct vtkGlyphWriter
+{
+  const vtkGlyphParameters *Parameters;
+  const vtkIdType *GlyphPointIds;
+  vtkIdType NumberOfGlyphPoints;
+  vtkIdType NumberOfGlyphCells;
+
+  // The source, with the SourceTransform applied to its points.
+  const double *SourcePoints;
+  const double *SourceNormals;
+  const float *SourceTCoords;
+  int NumberOfTCoordComponents;
+  const vtkIdType *SourceConnectivity;
+  vtkIdType SourceConnectivitySize;
+  const double *SourceMatrix;
+
+  // The output. Points are either float or double.
+  float *FloatPoints;
+  double *DoublePoints;
+  float *Normals;
+  float *TCoords;
+  vtkIdType *Connectivity;
+  double *Transforms;
+  int *SourceIndices;
+  float *Vectors;
+  float *FloatScalars; // the scale or the vector magnitude
+  vtkDataArray *Scalars; // the color scalars
+  vtkDataArray *ColorScalars;
+  int ColorMode;
+  vtkIdType *PointIds;
+  vtkPointData *InPD;
+  vtkPointData *OutPD;
+  vtkCellData *OutCD;
+
+  vtkSMPThreadLocal<std::vector<vtkIdType> > SourceIds;
+  vtkSMPThreadLocalObject<vtkTransform> Transform;
+
+  template <class T>
+  void TransformPoints(const double matrix[4][4], T *out)
+  {
+    const double *in = this->SourcePoints;
+    for (vtkIdType i = 0; i < this->NumberOfGlyphPoints; i++, in += 3)
+    {
+      T x = static_cast<T>(
+        matrix[0][0]*in[0]+matrix[0][1]*in[1]+matrix[0][2]*in[2]+matrix[0][3]);
+      T y = static_cast<T>(
+        matrix[1][0]*in[0]+matrix[1][1]*in[1]+matrix[1][2]*in[2]+matrix[1][3]);
+      T z = static_cast<T>(
+        matrix[2][0]*in[0]+matrix[2][1]*in[1]+matrix[2][2]*in[2]+matrix[2][3]);
+      *out++ = x;
+      *out++ = y;
+      *out++ = z;
+    }
+  }
+
+  void TransformNormals(const double matrix[4][4], float *out)
+  {
+    // to transform the normal, multiply by the transposed inverse matrix
+    double inverse[4][4];
+    vtkMatrix4x4::Invert(*matrix, *inverse);
+    vtkMatrix4x4::Transpose(*inverse, *inverse);
+    const double *in = this->SourceNormals;
+    for (vtkIdType i = 0; i < this->NumberOfGlyphPoints; i++, in += 3)
+    {
+      out[0] = static_cast<float>(
+        inverse[0][0]*in[0] + inverse[0][1]*in[1] + inverse[0][2]*in[2]);
+      out[1] = static_cast<float>(
+        inverse[1][0]*in[0] + inverse[1][1]*in[1] + inverse[1][2]*in[2]);
+      out[2] = static_cast<float>(
+        inverse[2][0]*in[0] + inverse[2][1]*in[1] + inverse[2][2]*in[2]);
+      vtkMath::Normalize(out);
+      out += 3;
+    }
+  }
+
+  void operator()(vtkIdType glyphId, vtkIdType endGlyphId)
+  {
+    std::vector<vtkIdType>& sourceIds = this->SourceIds.Local();
+    vtkTransform *trans = this->Transform.Local();
+    vtkIdType n = this->NumberOfGlyphPoints;
+    vtkGlyph glyph;
+    for ( ; glyphId < endGlyphId; glyphId++)
+    {
+      vtkIdType ptId = this->GlyphPointIds[glyphId];
+      vtkIdType ptIncr = glyphId * n;
+      this->Parameters->GetGlyph(ptId, trans, glyph);
+
+      if (this->Transforms)
+      {
+        double *transform = this->Transforms + 16 * glyphId;
+        if (this->SourceMatrix)
+        {
+          vtkMatrix4x4::Multiply4x4(*glyph.Matrix, this->SourceMatrix,
+                                    transform);
+        }
+        else
+        {
+          std::copy(*glyph.Matrix, *glyph.Matrix + 16, transform);
+        }
+        if (this->SourceIndices)
+        {
+          this->SourceIndices[glyphId] = glyph.SourceIndex;
+        }
+        if (this->FloatPoints)
+        {
+          std::copy(glyph.Point, glyph.Point + 3,
+                    this->FloatPoints + 3 * glyphId);
+        }
+        else
+        {
+          std::copy(glyph.Point, glyph.Point + 3,
+                    this->DoublePoints + 3 * glyphId);
+        }
+      }
+      else
+      {
+        if (this->FloatPoints)
+        {
+          this->TransformPoints(glyph.Matrix, this->FloatPoints + 3 * ptIncr);
+        }
+        else
+        {
+          this->TransformPoints(glyph.Matrix, this->DoublePoints + 3 * ptIncr);
+        }
+        if (this->Normals)
+        {
+          this->TransformNormals(glyph.Matrix, this->Normals + 3 * ptIncr);
+        }
+        if (this->TCoords)
+        {
+          vtkIdType size = this->NumberOfTCoordComponents * n;
+          std::copy(this->SourceTCoords, this->SourceTCoords + size,
+                    this->TCoords + size * glyphId);
+        }
+        vtkIdType *conn =
+          this->Connectivity + this->SourceConnectivitySize * glyphId;
+        const vtkIdType *sourceConn = this->SourceConnectivity;
+        const vtkIdType *sourceConnEnd =
+          sourceConn + this->SourceConnectivitySize;
+        while (sourceConn < sourceConnEnd)
+        {
+          vtkIdType npts = *sourceConn++;
+          *conn++ = npts;
+          for (vtkIdType i = 0; i < npts; i++)
+          {
+            *conn++ = *sourceConn++ + ptIncr;
+          }
+        }
+      }
+
+      for (vtkIdType i = 0; i < n; i++)
+      {
+        if (this->Vectors)
+        {
+          std::copy(glyph.Vector, glyph.Vector + 3,
+                    this->Vectors + 3 * (ptIncr + i));
+        }
+        if (this->FloatScalars)
+        {
+          this->FloatScalars[ptIncr + i] = static_cast<float>(
+            this->ColorMode == VTK_COLOR_BY_VECTOR ?
+            glyph.VectorMagnitude : glyph.Scale);
+        }
+        else if (this->Scalars)
+        {
+          this->Scalars->SetTuple(ptIncr + i, ptId, this->ColorScalars);
+        }
+        if (this->PointIds)
+        {
+          this->PointIds[ptIncr + i] = ptId;
+        }
+      }
+
+      // Copy point data from the input point
+      if (this->InPD)
+      {
+        vtkIdType m = std::max(n, this->NumberOfGlyphCells);
+        sourceIds.assign(m, ptId);
+        this->OutPD->GatherData(this->InPD, sourceIds.data(), ptIncr, n);
+        if (this->OutCD)
+        {
+          this->OutCD->GatherData(this->InPD, sourceIds.data(),
+                                  glyphId * this->NumberOfGlyphCells,
+                                  this->NumberOfGlyphCells);
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Find the source index of the glyphs when indexing is on.
+struct vtkGlyphSourceIndices
+{
+  const vtkGlyphParameters *Parameters;
+  const vtkIdType *GlyphPointIds;
+  int *SourceIndices;
+  vtkSMPThreadLocalObject<vtkTransform> Transform;
+
+  void operator()(vtkIdType glyphId, vtkIdType endGlyphId)
+  {
+    vtkTransform *trans = this->Transform.Local();
+    vtkGlyph glyph;
+    for ( ; glyphId < endGlyphId; glyphId++)
+    {
+      this->Parameters->GetGlyph(this->GlyphPointIds[glyphId], trans, glyph);
+      this->SourceIndices[glyphId] = glyph.SourceIndex;
+    }
+  }
+};
+
+} // end anon namespace
+
 //----------------------------------------------------------------------------
 bool vtkGlyph3D::Execute(
   vtkDataSet* input,
@@ -265,6 +666,34 @@ bool vtkGlyph3D::Execute(
     source = defaultSource.Get();
   }
 
+  // Glyph with several threads when all the glyphs have the cells of the
+  // source, in a single cell array, and the input arrays can be read from
+  // several threads. The instanced output is only built by ThreadedExecute(),
+  // which then runs on a single thread if needed.
+  vtkPointSet *inputPS = vtkPointSet::SafeDownCast(input);
+  bool parallel =
+    vtkGlyphCanReadInParallel(inSScalars) &&
+    vtkGlyphCanReadInParallel(inVectors) &&
+    vtkGlyphCanReadInParallel(inNormals) &&
+    vtkGlyphCanReadInParallel(inCScalars) &&
+    (!inputPS || !inputPS->GetPoints() ||
+     vtkGlyphCanReadInParallel(inputPS->GetPoints()->GetData()));
+  for (int arrayId = 0; pd && arrayId < pd->GetNumberOfArrays(); arrayId++)
+  {
+    parallel = parallel && vtkGlyphCanReadInParallel(pd->GetArray(arrayId));
+  }
+  if (this->InstancedOutput ||
+      (parallel && this->IndexMode == VTK_INDEXING_OFF &&
+       vtkGlyphSourceCellKind(source) >= 0))
+  {
+    pts->Delete();
+    trans->Delete();
+    vtkSMPTools::LocalScope scope(vtkSMPTools::Config(parallel ? 0 : 1));
+    return this->ThreadedExecute(input, source, sourceVector, output,
+                                 inSScalars, inVectors, inNormals, inCScalars,
+                                 inGhostLevels);
+  }
+
   if ( this->IndexMode != VTK_INDEXING_OFF )
   {
     pd = nullptr;
@@ -743,6 +1172,388 @@ bool vtkGlyph3D::Execute(
   return true;
 }
 
+//----------------------------------------------------------------------------
+// The glyphs are written in place: the points to glyph are listed first, so
+// the output of each one is at a known offset.
+bool vtkGlyph3D::ThreadedExecute(
+  vtkDataSet *input,
+  vtkPolyData *source,
+  vtkInformationVector *sourceVector,
+  vtkPolyData *output,
+  vtkDataArray *inSScalars,
+  vtkDataArray *inVectors,
+  vtkDataArray *inNormals,
+  vtkDataArray *inCScalars,
+  unsigned char *inGhostLevels)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPointData *pd = input->GetPointData();
+  vtkPointData *outputPD = output->GetPointData();
+  vtkCellData *outputCD = output->GetCellData();
+  int numberOfSources = this->GetNumberOfInputConnections(1);
+
+  vtkGlyphParameters params;
+  params.Input = input;
+  params.Scalars = inSScalars;
+  params.Vectors = nullptr;
+  if (this->VectorMode != VTK_VECTOR_ROTATION_OFF)
+  {
+    params.Vectors =
+      this->VectorMode == VTK_USE_NORMAL ? inNormals : inVectors;
+  }
+  if (params.Vectors && params.Vectors->GetNumberOfComponents() > 3)
+  {
+    vtkErrorMacro(<<"vtkDataArray "<<params.Vectors->GetName()<<" has more than 3 components.\n");
+    return false;
+  }
+  params.Scaling = this->Scaling;
+  params.ScaleMode = this->ScaleMode;
+  params.ScaleFactor = this->ScaleFactor;
+  params.Range[0] = this->Range[0];
+  params.Range[1] = this->Range[1];
+  params.Den = this->Range[1] - this->Range[0];
+  if (params.Den == 0.0)
+  {
+    params.Den = 1.0;
+  }
+  params.Orient = this->Orient;
+  params.Clamping = this->Clamping;
+  params.IndexMode = this->IndexMode;
+  params.NumberOfSources = numberOfSources;
+
+  // List the points to glyph. IsPointVisible() may not be thread-safe.
+  vtkUniformGrid *inputUG = vtkUniformGrid::SafeDownCast(input);
+  std::vector<vtkIdType> glyphPtIds;
+  glyphPtIds.reserve(numPts);
+  for (vtkIdType inPtId = 0; inPtId < numPts; inPtId++)
+  {
+    if ((inGhostLevels &&
+         inGhostLevels[inPtId] & vtkDataSetAttributes::DUPLICATEPOINT) ||
+        (inputUG && !inputUG->IsPointVisible(inPtId)) ||
+        !this->IsPointVisible(input, inPtId))
+    {
+      continue;
+    }
+    glyphPtIds.push_back(inPtId);
+  }
+
+  // Skip the points whose glyph has no source.
+  std::vector<int> sourceIndices;
+  if (this->IndexMode != VTK_INDEXING_OFF)
+  {
+    sourceIndices.resize(glyphPtIds.size());
+    vtkGlyphSourceIndices findIndices;
+    findIndices.Parameters = &params;
+    findIndices.GlyphPointIds = glyphPtIds.data();
+    findIndices.SourceIndices = sourceIndices.data();
+    vtkSMPTools::For(0, static_cast<vtkIdType>(glyphPtIds.size()),
+                     findIndices);
+    std::vector<bool> haveSource(numberOfSources);
+    for (int i = 0; i < numberOfSources; i++)
+    {
+      haveSource[i] = this->GetSource(i, sourceVector) != nullptr;
+    }
+    size_t numGlyphs = 0;
+    for (size_t i = 0; i < glyphPtIds.size(); i++)
+    {
+      if (haveSource[sourceIndices[i]])
+      {
+        glyphPtIds[numGlyphs++] = glyphPtIds[i];
+      }
+    }
+    glyphPtIds.resize(numGlyphs);
+  }
+  vtkIdType numGlyphs = static_cast<vtkIdType>(glyphPtIds.size());
+  this->UpdateProgress(0.25);
+
+  vtkGlyphWriter writer;
+  writer.Parameters = &params;
+  writer.GlyphPointIds = glyphPtIds.data();
+  writer.NumberOfGlyphPoints = 1;
+  writer.NumberOfGlyphCells = 0;
+  writer.SourcePoints = nullptr;
+  writer.SourceNormals = nullptr;
+  writer.SourceTCoords = nullptr;
+  writer.NumberOfTCoordComponents = 0;
+  writer.SourceConnectivity = nullptr;
+  writer.SourceConnectivitySize = 0;
+  writer.SourceMatrix = nullptr;
+  writer.Normals = nullptr;
+  writer.TCoords = nullptr;
+  writer.Connectivity = nullptr;
+  writer.Transforms = nullptr;
+  writer.SourceIndices = nullptr;
+
+  // The source points, normals, texture coordinates and cells, ready to be
+  // copied to each glyph.
+  std::vector<double> sourcePoints;
+  std::vector<double> sourceNormals;
+  std::vector<float> sourceTCoords;
+  std::vector<vtkIdType> sourceConn;
+  vtkSmartPointer<vtkCellArray> newCells;
+  vtkSmartPointer<vtkDoubleArray> transforms;
+  vtkSmartPointer<vtkIntArray> newSourceIndices;
+  vtkSmartPointer<vtkFloatArray> newNormals;
+  vtkSmartPointer<vtkFloatArray> newTCoords;
+  int cellKind = 0;
+  if (this->InstancedOutput)
+  {
+    transforms = vtkSmartPointer<vtkDoubleArray>::New();
+    transforms->SetName("GlyphTransform");
+    transforms->SetNumberOfComponents(16);
+    transforms->SetNumberOfTuples(numGlyphs);
+    writer.Transforms = transforms->GetPointer(0);
+    if (this->SourceTransform)
+    {
+      writer.SourceMatrix = *this->SourceTransform->GetMatrix()->Element;
+    }
+    if (this->IndexMode != VTK_INDEXING_OFF)
+    {
+      newSourceIndices = vtkSmartPointer<vtkIntArray>::New();
+      newSourceIndices->SetName("GlyphSourceIndex");
+      newSourceIndices->SetNumberOfTuples(numGlyphs);
+      writer.SourceIndices = newSourceIndices->GetPointer(0);
+    }
+  }
+  else
+  {
+    vtkPoints *sourcePts = source->GetPoints();
+    vtkIdType numSourcePts = source->GetNumberOfPoints();
+    vtkIdType numSourceCells = source->GetNumberOfCells();
+    writer.NumberOfGlyphPoints = numSourcePts;
+    writer.NumberOfGlyphCells = numSourceCells;
+
+    sourcePoints.resize(3 * numSourcePts);
+    if (this->SourceTransform)
+    {
+      vtkNew<vtkPoints> transformedSourcePts;
+      transformedSourcePts->SetDataTypeToDouble();
+      this->SourceTransform->TransformPoints(
+        sourcePts, transformedSourcePts.GetPointer());
+      sourcePts = transformedSourcePts.GetPointer();
+      for (vtkIdType i = 0; i < numSourcePts; i++)
+      {
+        sourcePts->GetPoint(i, &sourcePoints[3 * i]);
+      }
+    }
+    else
+    {
+      for (vtkIdType i = 0; i < numSourcePts; i++)
+      {
+        sourcePts->GetPoint(i, &sourcePoints[3 * i]);
+      }
+    }
+    writer.SourcePoints = sourcePoints.data();
+
+    vtkDataArray *inSourceNormals = source->GetPointData()->GetNormals();
+    if (inSourceNormals)
+    {
+      sourceNormals.resize(3 * numSourcePts);
+      for (vtkIdType i = 0; i < numSourcePts; i++)
+      {
+        inSourceNormals->GetTuple(i, &sourceNormals[3 * i]);
+      }
+      writer.SourceNormals = sourceNormals.data();
+      newNormals = vtkSmartPointer<vtkFloatArray>::New();
+      newNormals->SetNumberOfComponents(3);
+      newNormals->SetNumberOfTuples(numGlyphs * numSourcePts);
+      newNormals->SetName("Normals");
+      writer.Normals = newNormals->GetPointer(0);
+    }
+
+    vtkDataArray *inSourceTCoords = source->GetPointData()->GetTCoords();
+    if (inSourceTCoords)
+    {
+      int numComps = inSourceTCoords->GetNumberOfComponents();
+      sourceTCoords.resize(numComps * numSourcePts);
+      for (vtkIdType i = 0; i < numSourcePts; i++)
+      {
+        for (int j = 0; j < numComps; j++)
+        {
+          sourceTCoords[numComps * i + j] = static_cast<float>(
+            inSourceTCoords->GetComponent(i, j));
+        }
+      }
+      writer.SourceTCoords = sourceTCoords.data();
+      writer.NumberOfTCoordComponents = numComps;
+      newTCoords = vtkSmartPointer<vtkFloatArray>::New();
+      newTCoords->SetNumberOfComponents(numComps);
+      newTCoords->SetNumberOfTuples(numGlyphs * numSourcePts);
+      newTCoords->SetName("TCoords");
+      writer.TCoords = newTCoords->GetPointer(0);
+    }
+
+    // All the cells of the source are in one cell array.
+    vtkNew<vtkIdList> cellPts;
+    for (vtkIdType cellId = 0; cellId < numSourceCells; cellId++)
+    {
+      source->GetCellPoints(cellId, cellPts.GetPointer());
+      sourceConn.push_back(cellPts->GetNumberOfIds());
+      sourceConn.insert(sourceConn.end(), cellPts->GetPointer(0),
+                        cellPts->GetPointer(0) + cellPts->GetNumberOfIds());
+    }
+    writer.SourceConnectivity = sourceConn.data();
+    writer.SourceConnectivitySize = static_cast<vtkIdType>(sourceConn.size());
+    cellKind = vtkGlyphSourceCellKind(source);
+    newCells = vtkSmartPointer<vtkCellArray>::New();
+    writer.Connectivity = newCells->WritePointer(
+      numGlyphs * numSourceCells,
+      numGlyphs * writer.SourceConnectivitySize);
+  }
+  vtkIdType numNewPts = numGlyphs * writer.NumberOfGlyphPoints;
+
+  vtkPoints *newPts = vtkPoints::New();
+  newPts->SetDataType(
+    this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION ?
+    VTK_DOUBLE : VTK_FLOAT);
+  newPts->SetNumberOfPoints(numNewPts);
+  writer.FloatPoints = nullptr;
+  writer.DoublePoints = nullptr;
+  if (newPts->GetDataType() == VTK_FLOAT)
+  {
+    writer.FloatPoints =
+      static_cast<vtkFloatArray *>(newPts->GetData())->GetPointer(0);
+  }
+  else
+  {
+    writer.DoublePoints =
+      static_cast<vtkDoubleArray *>(newPts->GetData())->GetPointer(0);
+  }
+
+  // Prepare to copy output.
+  writer.InPD = pd;
+  writer.OutPD = outputPD;
+  writer.OutCD = nullptr;
+  outputPD->CopyAllocate(pd, numNewPts);
+  outputPD->SetNumberOfTuples(numNewPts);
+  if (this->FillCellData && !this->InstancedOutput)
+  {
+    vtkIdType numNewCells = numGlyphs * writer.NumberOfGlyphCells;
+    outputCD->CopyAllocate(pd, numNewCells);
+    outputCD->SetNumberOfTuples(numNewCells);
+    writer.OutCD = outputCD;
+  }
+
+  writer.PointIds = nullptr;
+  if (this->GeneratePointIds)
+  {
+    vtkIdTypeArray *pointIds = vtkIdTypeArray::New();
+    pointIds->SetName(this->PointIdsName);
+    pointIds->SetNumberOfTuples(numNewPts);
+    writer.PointIds = pointIds->GetPointer(0);
+    outputPD->AddArray(pointIds);
+    pointIds->Delete();
+  }
+
+  vtkDataArray *newScalars = nullptr;
+  writer.FloatScalars = nullptr;
+  writer.Scalars = nullptr;
+  writer.ColorScalars = inCScalars;
+  writer.ColorMode = this->ColorMode;
+  if (this->ColorMode == VTK_COLOR_BY_SCALAR && inCScalars)
+  {
+    newScalars = inCScalars->NewInstance();
+    newScalars->SetNumberOfComponents(inCScalars->GetNumberOfComponents());
+    newScalars->SetNumberOfTuples(numNewPts);
+    newScalars->SetName(inCScalars->GetName());
+    writer.Scalars = newScalars;
+  }
+  else if ((this->ColorMode == VTK_COLOR_BY_SCALE && inSScalars) ||
+           (this->ColorMode == VTK_COLOR_BY_VECTOR && params.Vectors))
+  {
+    vtkFloatArray *floatScalars = vtkFloatArray::New();
+    floatScalars->SetNumberOfTuples(numNewPts);
+    if (this->ColorMode == VTK_COLOR_BY_VECTOR)
+    {
+      floatScalars->SetName("VectorMagnitude");
+    }
+    else if (this->ScaleMode == VTK_SCALE_BY_SCALAR)
+    {
+      floatScalars->SetName(inSScalars->GetName());
+    }
+    else
+    {
+      floatScalars->SetName("GlyphScale");
+    }
+    writer.FloatScalars = floatScalars->GetPointer(0);
+    newScalars = floatScalars;
+  }
+
+  vtkFloatArray *newVectors = nullptr;
+  writer.Vectors = nullptr;
+  if (params.Vectors)
+  {
+    newVectors = vtkFloatArray::New();
+    newVectors->SetNumberOfComponents(3);
+    newVectors->SetNumberOfTuples(numNewPts);
+    newVectors->SetName("GlyphVector");
+    writer.Vectors = newVectors->GetPointer(0);
+  }
+
+  vtkSMPTools::For(0, numGlyphs, writer);
+  this->UpdateProgress(0.9);
+
+  // Update ourselves and release memory
+  //
+  output->SetPoints(newPts);
+  newPts->Delete();
+
+  if (newCells)
+  {
+    switch (cellKind)
+    {
+      case 0:
+        output->SetVerts(newCells);
+        break;
+      case 1:
+        output->SetLines(newCells);
+        break;
+      case 2:
+        output->SetPolys(newCells);
+        break;
+      default:
+        output->SetStrips(newCells);
+    }
+  }
+
+  if (transforms)
+  {
+    outputPD->AddArray(transforms);
+  }
+
+  if (newSourceIndices)
+  {
+    outputPD->AddArray(newSourceIndices);
+  }
+
+  if (newScalars)
+  {
+    int idx = outputPD->AddArray(newScalars);
+    outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+    newScalars->Delete();
+  }
+
+  if (newVectors)
+  {
+    outputPD->SetVectors(newVectors);
+    newVectors->Delete();
+  }
+
+  if (newNormals)
+  {
+    outputPD->SetNormals(newNormals);
+  }
+
+  if (newTCoords)
+  {
+    outputPD->SetTCoords(newTCoords);
+  }
+
+  output->Squeeze();
+
+  return true;
+}
+
 //----------------------------------------------------------------------------
 // Specify a source object at a specified table location.
 void vtkGlyph3D::SetSourceConnection(int id, vtkAlgorithmOutput* algOutput)
@@ -893,6 +1704,8 @@ void vtkGlyph3D::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Fill Cell Data: " << (this->FillCellData ? "On\n" : "Off\n");
+  os << indent << "Instanced Output: "
+     << (this->InstancedOutput ? "On\n" : "Off\n");
 
   os << indent << "SourceTransform: ";
   if (this->SourceTransform)
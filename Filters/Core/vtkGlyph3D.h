@@ -34,6 +34,14 @@
  * you'll have to decide whether to index into it with scalar value or with
  * vector magnitude.
  *
+ * The glyphs are computed with several threads (see vtkSMPTools) when
+ * indexing is off, the cells of the source are all vertices, lines, polygons
+ * or triangle strips, and the input points and point data are stored in AOS
+ * or SOA arrays (not mapped arrays). The instanced output is always built
+ * this way, on a single thread for arrays of other layouts. The output is the
+ * same as the sequential one. IsPointVisible() is still called from a single
+ * thread.
+ *
  * @warning
  * The scaling of the glyphs is controlled by the ScaleFactor ivar multiplied
  * by the scalar value at each point (if VTK_SCALE_BY_SCALAR is set), or
@@ -287,6 +295,23 @@ public:
   vtkBooleanMacro(FillCellData,int);
   //@}
 
+  //@{
+  /**
+   * Enable/disable the instanced output. When on, the source geometry is not
+   * copied: the output has one point per glyph, at the input point, with the
+   * transform of the glyph in a point data array named "GlyphTransform". The
+   * transform is a 4x4 matrix stored in 16 components, row by row, that
+   * includes the SourceTransform. When indexing is on, the index of the
+   * source of each glyph is in a point data array named "GlyphSourceIndex".
+   * The input point data, the point ids, the glyph vectors and the color
+   * scalars are output once per glyph. The output has no cells. This is
+   * meant for mappers that draw the glyphs with instancing. Off by default.
+   */
+  vtkSetMacro(InstancedOutput,int);
+  vtkGetMacro(InstancedOutput,int);
+  vtkBooleanMacro(InstancedOutput,int);
+  //@}
+
   /**
    * This can be overwritten by subclass to return 0 when a point is
    * blanked. Default implementation is to always return 1;
@@ -344,6 +369,20 @@ protected:
                        vtkDataArray *inVectors);
   //@}
 
+  /**
+   * The threaded version of the glyph loop of Execute(), which also builds
+   * the instanced output. The source is the one used when indexing is off.
+   */
+  bool ThreadedExecute(vtkDataSet *input,
+                       vtkPolyData *source,
+                       vtkInformationVector *sourceVector,
+                       vtkPolyData *output,
+                       vtkDataArray *inSScalars,
+                       vtkDataArray *inVectors,
+                       vtkDataArray *inNormals,
+                       vtkDataArray *inCScalars,
+                       unsigned char *inGhostLevels);
+
   vtkPolyData **Source; // Geometry to copy to each point
   int Scaling; // Determine whether scaling of geometry is performed
   int ScaleMode; // Scale by scalar value or vector magnitude
@@ -356,6 +395,7 @@ protected:
   int IndexMode; // what to use to index into glyph table
   int GeneratePointIds; // produce input points ids for each output point
   int FillCellData; // whether to fill output cell data
+  int InstancedOutput; // output the glyph transforms instead of the glyphs
   char *PointIdsName;
   vtkTransform* SourceTransform;
   int OutputPointsPrecision;
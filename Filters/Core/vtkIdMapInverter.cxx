@@ -0,0 +1,47 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkIdMapInverter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkIdMapInverter.h"
+
+#include "vtkSMPTools.h"
+
+namespace
+{
+
+struct vtkIdMapInverterFunctor
+{
+  const vtkIdType *Map;
+  vtkIdType *InverseMap;
+
+  void operator()(vtkIdType id, vtkIdType endId)
+  {
+    for ( ; id < endId; ++id )
+    {
+      if ( this->Map[id+1] != this->Map[id] )
+      {
+        this->InverseMap[this->Map[id]] = id;
+      }
+    }
+  }
+};
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+void vtkIdMapInverter::Invert(const vtkIdType *map, vtkIdType numberOfIds,
+                              vtkIdType *inverseMap)
+{
+  vtkIdMapInverterFunctor invert = { map, inverseMap };
+  vtkSMPTools::For(0, numberOfIds, invert);
+}
@@ -0,0 +1,51 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkIdMapInverter.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkIdMapInverter
+ * @brief   A utility class used by the filters extracting points and cells
+ *
+ * The filters that extract a subset of the points or cells of their input
+ * flag the kept ids with 1 and the others with 0, and turn the flags into
+ * a map from input to output ids with vtkSMPTools::ExclusiveScan.
+ * vtkIdMapInverter computes the inverse map, from output to input ids, in
+ * parallel.
+ * @sa
+ * vtkConnectivityFilter vtkPolyDataConnectivityFilter vtkThreshold
+*/
+
+#ifndef vtkIdMapInverter_h
+#define vtkIdMapInverter_h
+
+#include "vtkFiltersCoreModule.h" // For export macro
+#include "vtkType.h" // For vtkIdType
+
+class VTKFILTERSCORE_EXPORT vtkIdMapInverter
+{
+public:
+  /**
+   * Invert map, the exclusive prefix sum of numberOfIds 0/1 flags followed
+   * by their total. The ids whose entry differs from the next one are kept:
+   * inverseMap, of size map[numberOfIds], receives them in increasing
+   * order.
+   */
+  static void Invert(const vtkIdType *map, vtkIdType numberOfIds,
+                     vtkIdType *inverseMap);
+
+private:
+  vtkIdMapInverter() VTK_DELETE_FUNCTION;
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkIdMapInverter.h
@@ -17,19 +17,36 @@
 #include <algorithm>
 #include <cassert>
 #include <limits>
+#include <set>
+#include <string>
 #include <vector>
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
 #include "vtkDataArray.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
+#include "vtkDataSetAttributesRemoveArrays.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #define VTK_EPSILON 1.e-6
 
+// The names of the arrays to process when ProcessAllArrays is off.
+class vtkPointDataToCellData::Internals
+{
+public:
+  std::set<std::string> PointDataArrays;
+};
+
 namespace
 {
 class Histogram
@@ -57,7 +74,9 @@ public:
   typedef std::vector<Bin> HistogramBins;
   typedef HistogramBins::iterator BinIt;
 
-  Histogram(vtkIdType size)
+  // The default size only serves the thread local storage, which copies
+  // an exemplar into each thread's histogram.
+  Histogram(vtkIdType size = 0)
   {
     // Construct the array of bins.
     this->Bins.assign(size + 1, this->Init);
@@ -148,6 +167,160 @@ vtkIdType Histogram::IndexOfLargestBin()
   return std::max_element(this->Bins.begin(), it2, BinCountCmp)->Index;
 }
 
+//----------------------------------------------------------------------------
+// Average the point values of an array over the points of each cell. This
+// gives the same values as vtkDataSetAttributes::InterpolatePoint() with
+// equal weights. Empty cells are set to zero.
+template <typename DstArrayT, typename SrcArrayT>
+struct vtkPointDataToCellDataAverage
+{
+  typedef typename vtkDataArrayAccessor<DstArrayT>::APIType ValueType;
+
+  DstArrayT *Dst;
+  SrcArrayT *Src;
+  vtkDataSet *DataSet;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  vtkPointDataToCellDataAverage(DstArrayT *dst, SrcArrayT *src,
+                                vtkDataSet *ds)
+    : Dst(dst), Src(src), DataSet(ds)
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkDataArrayAccessor<DstArrayT> dst(this->Dst);
+    vtkDataArrayAccessor<SrcArrayT> src(this->Src);
+    const int numComps = this->Src->GetNumberOfComponents();
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      this->DataSet->GetCellPoints(cellId, npts, pts, cellPts);
+      const double weight = npts > 0 ? 1.0 / npts : 0.0;
+      for (int comp = 0; comp < numComps; ++comp)
+      {
+        double value = 0.0;
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          value += weight * static_cast<double>(src.Get(pts[i], comp));
+        }
+        ValueType valueT;
+        vtkMath::RoundDoubleToIntegralIfNecessary(value, &valueT);
+        dst.Set(cellId, comp, valueT);
+      }
+    }
+  }
+};
+
+struct vtkPointDataToCellDataAverageWorker
+{
+  vtkDataSet *DataSet;
+  bool Threaded;
+
+  template <typename DstArrayT, typename SrcArrayT>
+  void operator()(DstArrayT *dst, SrcArrayT *src)
+  {
+    vtkPointDataToCellDataAverage<DstArrayT, SrcArrayT> average(dst, src,
+                                                               this->DataSet);
+    if (this->Threaded)
+    {
+      vtkSMPTools::For(0, this->DataSet->GetNumberOfCells(), average);
+    }
+    else
+    {
+      average(0, this->DataSet->GetNumberOfCells());
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Interpolate an array the typed kernels do not handle (e.g. a
+// vtkStringArray, or an attribute copied from the nearest point) one cell
+// at a time, as vtkDataSetAttributes::InterpolatePoint() does.
+void vtkPointDataToCellDataInterpolateArray(vtkDataSet *input,
+                                            vtkAbstractArray *dstArray,
+                                            vtkAbstractArray *srcArray,
+                                            bool nearest)
+{
+  vtkNew<vtkIdList> cellPts;
+  std::vector<double> weights;
+  std::vector<double> nullTuple(dstArray->GetNumberOfComponents(), 0.0);
+  vtkDataArray *dstDA = vtkArrayDownCast<vtkDataArray>(dstArray);
+  const vtkIdType numCells = input->GetNumberOfCells();
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    input->GetCellPoints(cellId, cellPts.GetPointer());
+    const vtkIdType numPts = cellPts->GetNumberOfIds();
+    if (numPts == 0)
+    {
+      if (dstDA)
+      {
+        dstDA->InsertTuple(cellId, &nullTuple[0]);
+      }
+    }
+    else if (nearest)
+    {
+      // All the points have the same weight, the first one is the nearest.
+      dstArray->InsertTuple(cellId, cellPts->GetId(0), srcArray);
+    }
+    else
+    {
+      weights.assign(numPts, 1.0 / numPts);
+      dstArray->InterpolateTuple(cellId, cellPts.GetPointer(), srcArray,
+                                 &weights[0]);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Find the majority point of each cell for categorical data, or -1 for the
+// empty cells.
+struct vtkPointDataToCellDataMajority
+{
+  vtkDataSet *DataSet;
+  vtkDataArray *Scalars;
+  vtkIdType *PointIds;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+  vtkSMPThreadLocal<Histogram> Histograms;
+
+  vtkPointDataToCellDataMajority(vtkDataSet *ds, vtkDataArray *scalars,
+                                 vtkIdType *pointIds)
+    : DataSet(ds), Scalars(scalars), PointIds(pointIds),
+      Histograms(Histogram(ds->GetMaxCellSize()))
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    Histogram &hist = this->Histograms.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      this->DataSet->GetCellPoints(cellId, npts, pts, cellPts);
+      if (npts == 0)
+      {
+        this->PointIds[cellId] = -1;
+        continue;
+      }
+
+      // Populate a histogram from the scalar values at each point, and
+      // then select the bin with the most elements.
+      hist.Reset(npts);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        hist.Fill(pts[i], this->Scalars->GetComponent(pts[i], 0));
+      }
+      this->PointIds[cellId] = hist.IndexOfLargestBin();
+    }
+  }
+};
+
 }
 
 
@@ -159,6 +332,71 @@ vtkPointDataToCellData::vtkPointDataToCellData()
 {
   this->PassPointData = 0;
   this->CategoricalData = 0;
+  this->ProcessAllArrays = 1;
+  this->Implementation = new Internals();
+}
+
+//----------------------------------------------------------------------------
+vtkPointDataToCellData::~vtkPointDataToCellData()
+{
+  delete this->Implementation;
+}
+
+//----------------------------------------------------------------------------
+void vtkPointDataToCellData::AddPointDataArray(const char *name)
+{
+  if (name && this->Implementation->PointDataArrays.insert(name).second)
+  {
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkPointDataToCellData::RemovePointDataArray(const char *name)
+{
+  if (name && this->Implementation->PointDataArrays.erase(name) > 0)
+  {
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkPointDataToCellData::ClearPointDataArrays()
+{
+  if (!this->Implementation->PointDataArrays.empty())
+  {
+    this->Implementation->PointDataArrays.clear();
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkPointDataToCellData::GetNumberOfPointArraysToProcess()
+{
+  return static_cast<int>(this->Implementation->PointDataArrays.size());
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkPointData>
+vtkPointDataToCellData::GetPointDataToProcess(vtkDataSet *input)
+{
+  vtkSmartPointer<vtkPointData> inPD = input->GetPointData();
+  if (!this->ProcessAllArrays)
+  {
+    inPD = vtkSmartPointer<vtkPointData>::New();
+    inPD->ShallowCopy(input->GetPointData());
+    const std::set<std::string> &names =
+      this->Implementation->PointDataArrays;
+    for (int i = inPD->GetNumberOfArrays(); i--;)
+    {
+      const char *name = inPD->GetAbstractArray(i)->GetName();
+      if (!name || names.find(name) == names.end())
+      {
+        inPD->RemoveArray(i);
+      }
+    }
+  }
+  return inPD;
 }
 
 //----------------------------------------------------------------------------
@@ -175,14 +413,8 @@ int vtkPointDataToCellData::RequestData(
   vtkDataSet *input = vtkDataSet::SafeDownCast(
     inInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType cellId, ptId, pointId;
-  vtkIdType numCells, numPts;
-  vtkPointData *inPD=input->GetPointData();
+  vtkIdType numCells;
   vtkCellData *outCD=output->GetCellData();
-  int maxCellSize=input->GetMaxCellSize();
-  vtkIdList *cellPts;
-  double weight;
-  double *weights;
 
   vtkDebugMacro(<<"Mapping point data to cell data");
 
@@ -194,9 +426,6 @@ int vtkPointDataToCellData::RequestData(
     vtkDebugMacro(<<"No input cells!");
     return 1;
   }
-  weights=new double[maxCellSize];
-
-  Histogram hist(maxCellSize);
 
   if (this->CategoricalData == 1)
   {
@@ -205,13 +434,11 @@ int vtkPointDataToCellData::RequestData(
     if (!input->GetPointData()->GetScalars())
     {
       vtkDebugMacro(<<"No input scalars!");
-      delete [] weights;
       return 1;
     }
     if (input->GetPointData()->GetScalars()->GetNumberOfComponents() != 1)
     {
       vtkDebugMacro(<<"Input scalars have more than one component! Cannot categorize!");
-      delete [] weights;
       return 1;
     }
 
@@ -222,9 +449,6 @@ int vtkPointDataToCellData::RequestData(
                                              vtkDataSetAttributes::INTERPOLATE);
   }
 
-  cellPts = vtkIdList::New();
-  cellPts->Allocate(maxCellSize);
-
   // Pass the cell data first. The fields and attributes
   // which also exist in the point data of the input will
   // be over-written during CopyAllocate
@@ -234,51 +458,110 @@ int vtkPointDataToCellData::RequestData(
 
   // notice that inPD and outCD are vtkPointData and vtkCellData; respectively.
   // It's weird, but it works.
+  vtkSmartPointer<vtkPointData> inPD = this->GetPointDataToProcess(input);
   outCD->InterpolateAllocate(inPD,numCells);
 
-  int abort=0;
-  vtkIdType progressInterval=numCells/20 + 1;
-  for (cellId=0; cellId < numCells && !abort; cellId++)
+  // Build the cells of the dataset, if needed, on this thread.
+  vtkNew<vtkIdList> cellPts;
+  input->GetCellPoints(0, cellPts.GetPointer());
+
+  const int numArrays = inPD->GetNumberOfArrays();
+  if (this->CategoricalData)
   {
-    if ( !(cellId % progressInterval) )
+    // Each cell copies the values of the point holding the majority value.
+    std::vector<vtkIdType> pointIds(numCells);
+    vtkPointDataToCellDataMajority majority(
+      input, input->GetPointData()->GetScalars(), &pointIds[0]);
+    vtkSMPTools::For(0, numCells, majority);
+    this->UpdateProgress(0.5);
+
+    for (int i = 0; i < numArrays; ++i)
     {
-      this->UpdateProgress((double)cellId/numCells);
-      abort = GetAbortExecute();
+      if (vtkAbstractArray *dstArray = outCD->GetTargetArray(i))
+      {
+        dstArray->SetNumberOfTuples(numCells);
+      }
     }
 
-    input->GetCellPoints(cellId, cellPts);
-    numPts = cellPts->GetNumberOfIds();
-
-    if (numPts == 0)
+    // Gather the values of the majority points, and set the empty cells to
+    // zero as the other modes do.
+    for (vtkIdType begin = 0, end = 0; begin < numCells; begin = end)
     {
-      continue;
-    }
+      for (end = begin; end < numCells && pointIds[end] < 0; ++end)
+      {
+      }
+      for (int i = 0; end > begin && i < numArrays; ++i)
+      {
+        vtkDataArray *dstArray =
+          vtkArrayDownCast<vtkDataArray>(outCD->GetTargetArray(i));
+        for (vtkIdType cellId = begin; dstArray && cellId < end; ++cellId)
+        {
+          for (int comp = 0; comp < dstArray->GetNumberOfComponents(); ++comp)
+          {
+            dstArray->SetComponent(cellId, comp, 0.0);
+          }
+        }
+      }
 
-    // If we aren't dealing with categorical data...
-    if (!(this->CategoricalData))
-    {
-      // ...then we simply provide each point with an equal weight value and
-      // interpolate.
-      weight = 1.0 / numPts;
-      for (ptId=0; ptId < numPts; ptId++)
+      for (begin = end; end < numCells && pointIds[end] >= 0; ++end)
+      {
+      }
+      if (end > begin)
       {
-        weights[ptId] = weight;
+        outCD->GatherData(inPD, &pointIds[begin], begin, end - begin);
       }
-      outCD->InterpolatePoint(inPD, cellId, cellPts, weights);
     }
-    else
+  }
+  else
+  {
+    vtkPointDataToCellDataAverageWorker worker;
+    worker.DataSet = input;
+
+    for (int i = 0; i < numArrays; ++i)
     {
-      // ...otherwise, we populate a histogram from the scalar values at each
-      // point, and then select the bin with the most elements.
-      hist.Reset(numPts);
-      for (ptId=0; ptId < numPts; ptId++)
+      this->UpdateProgress(static_cast<double>(i) / numArrays);
+      if (this->GetAbortExecute())
+      {
+        vtkDataSetAttributesRemoveTargetArrays(outCD, i, numArrays);
+        break;
+      }
+
+      vtkAbstractArray *srcArray = inPD->GetAbstractArray(i);
+      vtkAbstractArray *dstArray = outCD->GetTargetArray(i);
+      if (!dstArray)
+      {
+        continue;
+      }
+
+      // Attributes may be copied from the nearest point instead.
+      bool nearest = false;
+      for (int attr = 0; attr < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attr)
+      {
+        if (outCD->GetAbstractAttribute(attr) == dstArray &&
+            outCD->GetCopyAttribute(attr,
+                                    vtkDataSetAttributes::INTERPOLATE) == 2)
+        {
+          nearest = true;
+        }
+      }
+
+      vtkDataArray *srcDA = vtkArrayDownCast<vtkDataArray>(srcArray);
+      vtkDataArray *dstDA = vtkArrayDownCast<vtkDataArray>(dstArray);
+      if (!srcDA || !dstDA || nearest)
       {
-        pointId = cellPts->GetId(ptId);
-        hist.Fill(pointId,
-                  input->GetPointData()->GetScalars()->GetTuple1(pointId));
+        vtkPointDataToCellDataInterpolateArray(input, dstArray, srcArray,
+                                               nearest);
+        continue;
       }
 
-      outCD->CopyData(inPD, hist.IndexOfLargestBin(), cellId);
+      dstDA->SetNumberOfTuples(numCells);
+      worker.Threaded = true;
+      if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(dstDA, srcDA,
+                                                             worker))
+      {
+        worker.Threaded = false;
+        worker(dstDA, srcDA);
+      }
     }
   }
 
@@ -289,9 +572,6 @@ int vtkPointDataToCellData::RequestData(
   }
   output->GetPointData()->PassData(input->GetPointData());
 
-  cellPts->Delete();
-  delete [] weights;
-
   return 1;
 }
 
@@ -301,4 +581,10 @@ void vtkPointDataToCellData::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "Pass Point Data: " << (this->PassPointData ? "On\n" : "Off\n");
+  os << indent << "Categorical Data: "
+     << (this->CategoricalData ? "On\n" : "Off\n");
+  os << indent << "Process All Arrays: "
+     << (this->ProcessAllArrays ? "On\n" : "Off\n");
+  os << indent << "Point Data Arrays: "
+     << this->Implementation->PointDataArrays.size() << endl;
 }
@@ -22,6 +22,11 @@
  * values of all points defining a particular cell. Optionally, the input point
  * data can be passed through to the output as well.
  *
+ * The cell values are computed in parallel with vtkSMPTools, one typed
+ * kernel per array. By default all the point data arrays are mapped; turn
+ * ProcessAllArrays off and list the arrays with AddPointDataArray() to map
+ * only some of them.
+ *
  * @warning
  * This filter is an abstract filter, that is, the output is an abstract type
  * (i.e., vtkDataSet). Use the convenience methods (e.g.,
@@ -37,6 +42,10 @@
 
 #include "vtkFiltersCoreModule.h" // For export macro
 #include "vtkDataSetAlgorithm.h"
+#include "vtkSmartPointer.h" // For GetPointDataToProcess
+
+class vtkDataSet;
+class vtkPointData;
 
 class VTKFILTERSCORE_EXPORT vtkPointDataToCellData : public vtkDataSetAlgorithm
 {
@@ -67,16 +76,55 @@ public:
   vtkBooleanMacro(CategoricalData,int);
   //@}
 
+  //@{
+  /**
+   * Control whether all the point data arrays are mapped to cell data, or
+   * only the arrays listed with AddPointDataArray(). The arrays that are
+   * not processed are not present in the output cell data. The default is
+   * on.
+   */
+  vtkSetMacro(ProcessAllArrays, int);
+  vtkGetMacro(ProcessAllArrays, int);
+  vtkBooleanMacro(ProcessAllArrays, int);
+  //@}
+
+  //@{
+  /**
+   * Add, remove or clear the names of the point data arrays to map when
+   * ProcessAllArrays is off. Names that are not in the input are ignored.
+   */
+  void AddPointDataArray(const char *name);
+  void RemovePointDataArray(const char *name);
+  void ClearPointDataArrays();
+  //@}
+
+  /**
+   * Return the number of point data arrays listed with AddPointDataArray().
+   */
+  int GetNumberOfPointArraysToProcess();
+
 protected:
   vtkPointDataToCellData();
-  ~vtkPointDataToCellData() VTK_OVERRIDE {}
+  ~vtkPointDataToCellData() VTK_OVERRIDE;
 
   int RequestData(vtkInformation* request,
                   vtkInformationVector** inputVector,
                   vtkInformationVector* outputVector) VTK_OVERRIDE;
 
+  /**
+   * Return the point data of input to map: the input point data itself
+   * when ProcessAllArrays is on, otherwise a shallow copy holding only the
+   * listed arrays.
+   */
+  vtkSmartPointer<vtkPointData> GetPointDataToProcess(vtkDataSet *input);
+
   int PassPointData;
   int CategoricalData;
+  int ProcessAllArrays;
+
+  class Internals;
+  Internals *Implementation;
+
 private:
   vtkPointDataToCellData(const vtkPointDataToCellData&) VTK_DELETE_FUNCTION;
   void operator=(const vtkPointDataToCellData&) VTK_DELETE_FUNCTION;
@@ -16,21 +16,141 @@
 
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
-#include "vtkCell.h"
-#include "vtkFloatArray.h"
+#include "vtkConnectedRegions.h"
 #include "vtkIdList.h"
+#include "vtkIdMapInverter.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
-#include <algorithm> // for fill_n
+#include <vector>
 
 vtkStandardNewMacro(vtkPolyDataConnectivityFilter);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Flag the cells to extract: the labeled cells, of the extracted regions
+// when given. An extracted cell gets the size of its legacy connectivity
+// (npts+1), the other cells get 0.
+struct vtkPolyDataConnectivityFlagCells
+{
+  vtkPolyData *Input;
+  const vtkIdType *CellRegions;
+  const unsigned char *ExtractedRegions;
+  vtkIdType *CellFlags;
+  vtkIdType *ConnectivitySizes;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      vtkIdType region = this->CellRegions[cellId];
+      if ( region >= 0 &&
+           (!this->ExtractedRegions || this->ExtractedRegions[region]) )
+      {
+        this->Input->GetCellPoints(cellId, npts, pts, cellPts);
+        this->CellFlags[cellId] = 1;
+        this->ConnectivitySizes[cellId] = npts + 1;
+      }
+      else
+      {
+        this->CellFlags[cellId] = 0;
+        this->ConnectivitySizes[cellId] = 0;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// The points used by the labeled cells are kept.
+struct vtkPolyDataConnectivityIsLabeled
+{
+  vtkIdType operator()(vtkIdType region) const
+  {
+    return region >= 0 ? 1 : 0;
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the kept points, their attributes and their regions.
+struct vtkPolyDataConnectivityCopyPoints
+{
+  vtkPoints *InPoints;
+  const vtkIdType *OldPointIds;
+  const vtkIdType *PointRegions;
+  vtkPoints *NewPoints;
+  vtkIdType *NewScalars;
+  vtkPointData *InPD;
+  vtkPointData *OutPD;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for (vtkIdType newId = ptId; newId < endPtId; ++newId)
+    {
+      vtkIdType oldId = this->OldPointIds[newId];
+      this->InPoints->GetPoint(oldId, x);
+      this->NewPoints->SetPoint(newId, x);
+      this->NewScalars[newId] = this->PointRegions[oldId];
+    }
+    this->OutPD->GatherData(this->InPD, this->OldPointIds + ptId, ptId,
+                            endPtId - ptId);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the extracted cells of one cell array, renumbering their points, and
+// their attributes. Locations are those of the cells in the connectivity of
+// all the extracted cells, which starts at Base for this cell array.
+struct vtkPolyDataConnectivityCopyCells
+{
+  vtkPolyData *Input;
+  const vtkIdType *OldCellIds;
+  const vtkIdType *PointMap;
+  const vtkIdType *Locations;
+  vtkIdType Base;
+  vtkIdType *Connectivity;
+  vtkCellData *InCD;
+  vtkCellData *OutCD;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for (vtkIdType newId = cellId; newId < endCellId; ++newId)
+    {
+      vtkIdType oldId = this->OldCellIds[newId];
+      this->Input->GetCellPoints(oldId, npts, pts, cellPts);
+      vtkIdType *conn =
+        this->Connectivity + this->Locations[oldId] - this->Base;
+      *conn++ = npts;
+      for (vtkIdType i=0; i < npts; i++)
+      {
+        conn[i] = this->PointMap[pts[i]];
+      }
+    }
+    this->OutCD->GatherData(this->InCD, this->OldCellIds + cellId, cellId,
+                            endCellId - cellId);
+  }
+};
+
+} // end anon namespace
+
 // Construct with default extraction mode to extract largest regions.
 vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
 {
@@ -45,12 +165,6 @@ vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
 
   this->ClosestPoint[0] = this->ClosestPoint[1] = this->ClosestPoint[2] = 0.0;
 
-  this->CellScalars = vtkFloatArray::New();
-  this->CellScalars->Allocate(8);
-
-  this->NeighborCellPointIds = vtkIdList::New();
-  this->NeighborCellPointIds->Allocate(8);
-
   this->Seeds = vtkIdList::New();
   this->SpecifiedRegionIds = vtkIdList::New();
 
@@ -63,8 +177,6 @@ vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
 vtkPolyDataConnectivityFilter::~vtkPolyDataConnectivityFilter()
 {
   this->RegionSizes->Delete();
-  this->CellScalars->Delete();
-  this->NeighborCellPointIds->Delete();
   this->Seeds->Delete();
   this->SpecifiedRegionIds->Delete();
   this->VisitedPointIds->Delete();
@@ -85,13 +197,9 @@ int vtkPolyDataConnectivityFilter::RequestData(
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType cellId, newCellId, i, pt;
+  vtkIdType i;
   vtkPoints *inPts;
   vtkPoints *newPts;
-  vtkIdType *cells, *pts, npts, id, n;
-  unsigned short ncells;
-  vtkIdType maxCellsInRegion;
-  vtkIdType largestRegionId = 0;
   vtkPointData *pd=input->GetPointData(), *outputPD=output->GetPointData();
   vtkCellData *cd=input->GetCellData(), *outputCD=output->GetCellData();
 
@@ -118,138 +226,76 @@ int vtkPolyDataConnectivityFilter::RequestData(
 
   // See whether to consider scalar connectivity
   //
-  this->InScalars = input->GetPointData()->GetScalars();
-  if ( !this->ScalarConnectivity )
-  {
-    this->InScalars = nullptr;
-  }
-  else
+  vtkDataArray *inScalars = nullptr;
+  if ( this->ScalarConnectivity )
   {
+    inScalars = input->GetPointData()->GetScalars();
     if ( this->ScalarRange[1] < this->ScalarRange[0] )
     {
       this->ScalarRange[1] = this->ScalarRange[0];
     }
   }
 
-  // Build cell structure
-  //
-  this->Mesh = vtkPolyData::New();
-  this->Mesh->CopyStructure(input);
-  this->Mesh->BuildLinks();
-  this->UpdateProgress(0.10);
-
   // Remove all visited point ids
   this->VisitedPointIds->Reset();
 
-  // Initialize.  Keep track of points and cells visited.
+  // Group the cells sharing points (and meeting the scalar criterion) in
+  // parallel. The regions are then numbered as a traversal of the cells in
+  // increasing id order would: each cell not yet visited starts a region.
   //
-  this->RegionSizes->Reset();
-  this->Visited = new vtkIdType[numCells];
-  std::fill_n(this->Visited, numCells, -1);
-  this->PointMap = new vtkIdType[numPts];
-  std::fill_n(this->PointMap, numPts, -1);
-
-  this->NewScalars = vtkIdTypeArray::New();
-  this->NewScalars->SetName("RegionId");
-  this->NewScalars->SetNumberOfTuples(numPts);
-  newPts = vtkPoints::New();
-
-  // Set the desired precision for the points in the output.
-  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    newPts->SetDataType(inPts->GetDataType());
-  }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_FLOAT);
-  }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_DOUBLE);
-  }
-
-  newPts->Allocate(numPts);
-
-  // Traverse all cells marking those visited.  Each new search
-  // starts a new connected region. Connected region grows
-  // using a connected wave propagation.
-  //
-  this->Wave.reserve(numPts);
-  this->Wave2.reserve(numPts);
+  vtkConnectedRegions regions;
+  regions.Build(input, inScalars, this->ScalarRange,
+                this->FullScalarConnectivity != 0);
+  this->UpdateProgress(0.5);
 
-  this->PointNumber = 0;
-  this->RegionNumber = 0;
-  maxCellsInRegion = 0;
-
-  this->CellIds = vtkIdList::New();
-  this->CellIds->Allocate(8, VTK_CELL_SIZE);
-  this->PointIds = vtkIdList::New();
-  this->PointIds->Allocate(8, VTK_CELL_SIZE);
+  this->RegionSizes->Reset();
+  std::vector<vtkIdType> cellRegions(numCells);
+  std::vector<unsigned char> extractedRegions;
 
   if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
-  { //visit all cells marking with region number
-    for (cellId=0; cellId < numCells; cellId++)
-    {
-      if ( cellId && !(cellId % 5000) )
-      {
-        this->UpdateProgress (0.1 + 0.8*cellId/numCells);
-      }
+  { //label all cells with region number
+    vtkIdType largestRegionId =
+      regions.LabelAllRegions(&cellRegions[0], this->RegionSizes);
+    vtkIdType numRegions = this->RegionSizes->GetNumberOfTuples();
 
-      if ( this->Visited[cellId] < 0 )
+    if ( this->ExtractionMode == VTK_EXTRACT_SPECIFIED_REGIONS )
+    {
+      extractedRegions.resize(numRegions, 0);
+      for (i=0; i < this->SpecifiedRegionIds->GetNumberOfIds(); i++)
       {
-        this->NumCellsInRegion = 0;
-        this->Wave.push_back(cellId);
-        this->TraverseAndMark ();
-
-        if ( this->NumCellsInRegion > maxCellsInRegion )
+        vtkIdType regionId = this->SpecifiedRegionIds->GetId(i);
+        if ( regionId >= 0 && regionId < numRegions )
         {
-          maxCellsInRegion = this->NumCellsInRegion;
-          largestRegionId = this->RegionNumber;
+          extractedRegions[regionId] = 1;
         }
-
-        this->RegionSizes->InsertValue(this->RegionNumber++,
-                                       this->NumCellsInRegion);
-        this->Wave.clear();
-        this->Wave2.clear();
       }
     }
+    else if ( this->ExtractionMode == VTK_EXTRACT_LARGEST_REGION )
+    {
+      extractedRegions.resize(numRegions, 0);
+      extractedRegions[largestRegionId] = 1;
+    }
   }
   else // regions have been seeded, everything considered in same region
   {
-    this->NumCellsInRegion = 0;
+    vtkIdType numCellsInRegion = 0;
 
     if ( this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS )
     {
-      for (i=0; i < this->Seeds->GetNumberOfIds(); i++)
-      {
-        pt = this->Seeds->GetId(i);
-        if ( pt >= 0 )
-        {
-          this->Mesh->GetPointCells(pt,ncells,cells);
-          for (unsigned short j = 0; j < ncells; ++j)
-          {
-            this->Wave.push_back(cells[j]);
-          }
-        }
-      }
+      numCellsInRegion =
+        regions.LabelPointSeededRegion(this->Seeds, &cellRegions[0]);
     }
     else if ( this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS )
     {
-      for (i=0; i < this->Seeds->GetNumberOfIds(); i++)
-      {
-        cellId = this->Seeds->GetId(i);
-        if ( cellId >= 0 )
-        {
-          this->Wave.push_back(cellId);
-        }
-      }
+      numCellsInRegion =
+        regions.LabelCellSeededRegion(this->Seeds, &cellRegions[0]);
     }
     else if ( this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION )
     {//loop over points, find closest one
       double minDist2, dist2, x[3];
-      int minId = 0;
+      vtkIdType minId = 0;
       for (minDist2=VTK_DOUBLE_MAX, i=0; i<numPts; i++)
       {
         inPts->GetPoint(i,x);
@@ -260,178 +306,175 @@ int vtkPolyDataConnectivityFilter::RequestData(
           minDist2 = dist2;
         }
       }
-      this->Mesh->GetPointCells(minId,ncells,cells);
-      for (unsigned short j=0; j < ncells; ++j)
-      {
-        this->Wave.push_back(cells[j]);
-      }
+      vtkNew<vtkIdList> closestPoint;
+      closestPoint->InsertNextId(minId);
+      numCellsInRegion = regions.LabelPointSeededRegion(
+        closestPoint.GetPointer(), &cellRegions[0]);
     }
-    this->UpdateProgress (0.5);
-
-    //mark all seeded regions
-    this->TraverseAndMark ();
-    this->RegionSizes->InsertValue(this->RegionNumber,this->NumCellsInRegion);
-    this->UpdateProgress (0.9);
+    this->RegionSizes->InsertValue(0, numCellsInRegion);
   }//else extracted seeded cells
+  this->UpdateProgress(0.7);
 
-  vtkDebugMacro (<<"Extracted " << this->RegionNumber << " region(s)");
+  vtkDebugMacro (<<"Extracted " << this->GetNumberOfExtractedRegions()
+                 << " region(s)");
 
-  // Now that points and cells have been marked, traverse these lists pulling
-  // everything that has been visited.
+  // Now that the cells have been labeled, number the points of the labeled
+  // cells in increasing order and the cells to extract. pointMap maps old
+  // point ids into new.
   //
-  //Pass through point data that has been visited
+  std::vector<vtkIdType> pointRegions(numPts);
+  regions.LabelPoints(&cellRegions[0], &pointRegions[0]);
+
+  std::vector<vtkIdType> pointMap(numPts+1);
+  vtkSMPTools::Transform(pointRegions.begin(), pointRegions.end(),
+                         pointMap.begin(), vtkPolyDataConnectivityIsLabeled());
+  vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(
+    pointMap.begin(), pointMap.begin() + numPts, pointMap.begin(),
+    vtkIdType(0));
+  pointMap[numPts] = numNewPts;
+
+  std::vector<vtkIdType> cellMap(numCells+1);
+  std::vector<vtkIdType> locations(numCells+1);
+  vtkPolyDataConnectivityFlagCells flagCells;
+  flagCells.Input = input;
+  flagCells.CellRegions = &cellRegions[0];
+  flagCells.ExtractedRegions =
+    extractedRegions.empty() ? nullptr : &extractedRegions[0];
+  flagCells.CellFlags = &cellMap[0];
+  flagCells.ConnectivitySizes = &locations[0];
+  vtkSMPTools::For(0, numCells, flagCells);
+  vtkIdType numNewCells = vtkSMPTools::ExclusiveScan(
+    cellMap.begin(), cellMap.begin() + numCells, cellMap.begin(),
+    vtkIdType(0));
+  cellMap[numCells] = numNewCells;
+  vtkIdType connSize = vtkSMPTools::ExclusiveScan(
+    locations.begin(), locations.begin() + numCells, locations.begin(),
+    vtkIdType(0));
+  locations[numCells] = connSize;
+
+  // The input ids of the kept points and cells, in increasing order.
+  std::vector<vtkIdType> oldPointIds(numNewPts);
+  vtkIdMapInverter::Invert(&pointMap[0], numPts, oldPointIds.data());
+  std::vector<vtkIdType> oldCellIds(numNewCells);
+  vtkIdMapInverter::Invert(&cellMap[0], numCells, oldCellIds.data());
+
+  //Pass through the points and point data that have been visited
   outputPD->CopyAllocate(pd);
   outputCD->CopyAllocate(cd);
 
-  for (i=0; i < numPts; i++)
+  newPts = vtkPoints::New();
+
+  // Set the desired precision for the points in the output.
+  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
   {
-    if ( this->PointMap[i] > -1 )
-    {
-      newPts->InsertPoint(this->PointMap[i],inPts->GetPoint(i));
-      outputPD->CopyData(pd,i,this->PointMap[i]);
-    }
+    newPts->SetDataType(inPts->GetDataType());
   }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
+
+  newPts->SetNumberOfPoints(numNewPts);
+  outputPD->SetNumberOfTuples(numNewPts);
+  vtkIdTypeArray *newScalars = vtkIdTypeArray::New();
+  newScalars->SetName("RegionId");
+  newScalars->SetNumberOfTuples(numNewPts);
+  vtkPolyDataConnectivityCopyPoints copyPoints = { inPts, oldPointIds.data(),
+                                                   &pointRegions[0], newPts,
+                                                   newScalars->GetPointer(0),
+                                                   pd, outputPD };
+  vtkSMPTools::For(0, numNewPts, copyPoints);
 
   // if coloring regions; send down new scalar data
   if ( this->ColorRegions )
   {
-    int idx = outputPD->AddArray(this->NewScalars);
+    int idx = outputPD->AddArray(newScalars);
     outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
   }
-  this->NewScalars->Delete();
+  newScalars->Delete();
 
   output->SetPoints(newPts);
   newPts->Delete();
 
-  // Create output cells. Have to allocate storage first.
+  // Create output cells. The cells of the input are numbered verts first,
+  // then lines, polys and strips, so the extracted cells of each cell array
+  // follow each other.
   //
-  if ( (n=input->GetVerts()->GetNumberOfCells()) > 0 )
+  outputCD->SetNumberOfTuples(numNewCells);
+  vtkCellArray *inCells[4] = { input->GetVerts(), input->GetLines(),
+                               input->GetPolys(), input->GetStrips() };
+  vtkIdType firstCellId = 0;
+  for (int type = 0; type < 4; ++type)
   {
-    vtkCellArray *newVerts = vtkCellArray::New();
-    newVerts->Allocate(n,n);
-    output->SetVerts(newVerts);
-    newVerts->Delete();
-  }
-  if ( (n=input->GetLines()->GetNumberOfCells()) > 0 )
-  {
-    vtkCellArray *newLines = vtkCellArray::New();
-    newLines->Allocate(2*n,n);
-    output->SetLines(newLines);
-    newLines->Delete();
-  }
-  if ( (n=input->GetPolys()->GetNumberOfCells()) > 0 )
-  {
-    vtkCellArray *newPolys = vtkCellArray::New();
-    newPolys->Allocate(3*n,n);
-    output->SetPolys(newPolys);
-    newPolys->Delete();
-  }
-  if ( (n=input->GetStrips()->GetNumberOfCells()) > 0 )
-  {
-    vtkCellArray *newStrips = vtkCellArray::New();
-    newStrips->Allocate(5*n,n);
-    output->SetStrips(newStrips);
-    newStrips->Delete();
-  }
-
-  if ( this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS ||
-  this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS ||
-  this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION ||
-  this->ExtractionMode == VTK_EXTRACT_ALL_REGIONS)
-  { // extract any cell that's been visited
-    for (cellId=0; cellId < numCells; cellId++)
-    {
-      if ( this->Visited[cellId] >= 0 )
-      {
-        this->Mesh->GetCellPoints(cellId, npts, pts);
-        this->PointIds->Reset();
-        for (i=0; i < npts; i++)
-        {
-          id = this->PointMap[pts[i]];
-          this->PointIds->InsertId(i,id);
-
-          // If we asked to mark the visited point ids, mark them.
-          if (this->MarkVisitedPointIds)
-          {
-            this->VisitedPointIds->InsertUniqueId(id);
-          }
-        }
-        newCellId = output->InsertNextCell(this->Mesh->GetCellType(cellId),
-                                           this->PointIds);
-        outputCD->CopyData(cd,cellId,newCellId);
-      }
-    }
-  }
-  else if ( this->ExtractionMode == VTK_EXTRACT_SPECIFIED_REGIONS )
-  {
-    for (cellId=0; cellId < numCells; cellId++)
+    vtkIdType n = inCells[type]->GetNumberOfCells();
+    if ( n > 0 )
     {
-      int inReg, regionId;
-      if ( (regionId=this->Visited[cellId]) >= 0 )
+      vtkIdType beginNewId = cellMap[firstCellId];
+      vtkIdType endNewId = cellMap[firstCellId + n];
+      vtkIdType base = locations[firstCellId];
+
+      vtkCellArray *newCells = vtkCellArray::New();
+      vtkPolyDataConnectivityCopyCells copyCells;
+      copyCells.Input = input;
+      copyCells.OldCellIds = oldCellIds.data();
+      copyCells.PointMap = &pointMap[0];
+      copyCells.Locations = &locations[0];
+      copyCells.Base = base;
+      copyCells.Connectivity = newCells->WritePointer(
+        endNewId - beginNewId, locations[firstCellId + n] - base);
+      copyCells.InCD = cd;
+      copyCells.OutCD = outputCD;
+      vtkSMPTools::For(beginNewId, endNewId, copyCells);
+
+      switch (type)
       {
-        for (inReg=0,i=0; i<this->SpecifiedRegionIds->GetNumberOfIds(); i++)
-        {
-          if ( regionId == this->SpecifiedRegionIds->GetId(i) )
-          {
-            inReg = 1;
-            break;
-          }
-        }
-        if ( inReg )
-        {
-          this->Mesh->GetCellPoints(cellId, npts, pts);
-          this->PointIds->Reset ();
-          for (i=0; i < npts; i++)
-          {
-            id = this->PointMap[pts[i]];
-            this->PointIds->InsertId(i,id);
-
-            // If we asked to mark the visited point ids, mark them.
-            if (this->MarkVisitedPointIds)
-            {
-              this->VisitedPointIds->InsertUniqueId(id);
-            }
-
-          }
-          newCellId = output->InsertNextCell(this->Mesh->GetCellType(cellId),
-                                             this->PointIds);
-          outputCD->CopyData(cd,cellId,newCellId);
-        }
+        case 0:
+          output->SetVerts(newCells);
+          break;
+        case 1:
+          output->SetLines(newCells);
+          break;
+        case 2:
+          output->SetPolys(newCells);
+          break;
+        default:
+          output->SetStrips(newCells);
+          break;
       }
+      newCells->Delete();
     }
+    firstCellId += n;
   }
-  else //extract largest region
+
+  // If we asked to mark the visited point ids, list the points of the
+  // extracted cells in the order they are first used.
+  if ( this->MarkVisitedPointIds )
   {
-    for (cellId=0; cellId < numCells; cellId++)
+    std::vector<unsigned char> visited(numNewPts, 0);
+    vtkNew<vtkIdList> cellPts;
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for (vtkIdType newCellId=0; newCellId < numNewCells; newCellId++)
     {
-      if ( this->Visited[cellId] == largestRegionId )
+      input->GetCellPoints(oldCellIds[newCellId], npts, pts,
+                           cellPts.GetPointer());
+      for (i=0; i < npts; i++)
       {
-        this->Mesh->GetCellPoints(cellId, npts, pts);
-        this->PointIds->Reset ();
-        for (i=0; i < npts; i++)
+        vtkIdType id = pointMap[pts[i]];
+        if ( !visited[id] )
         {
-          id = this->PointMap[pts[i]];
-          this->PointIds->InsertId(i,id);
-
-          // If we asked to mark the visited point ids, mark them.
-          if (this->MarkVisitedPointIds)
-          {
-            this->VisitedPointIds->InsertUniqueId(id);
-          }
+          visited[id] = 1;
+          this->VisitedPointIds->InsertNextId(id);
         }
-        newCellId = output->InsertNextCell(this->Mesh->GetCellType(cellId),
-                                           this->PointIds);
-        outputCD->CopyData(cd,cellId,newCellId);
       }
     }
   }
 
-  delete [] this->Visited;
-  delete [] this->PointMap;
-  this->Mesh->Delete();
   output->Squeeze();
-  this->CellIds->Delete();
-  this->PointIds->Delete();
 
   int num = this->GetNumberOfExtractedRegions();
   vtkIdType count = 0;
@@ -446,121 +489,6 @@ int vtkPolyDataConnectivityFilter::RequestData(
   return 1;
 }
 
-// Mark current cell as visited and assign region number.  Note:
-// traversal occurs across shared vertices.
-//
-void vtkPolyDataConnectivityFilter::TraverseAndMark ()
-{
-  vtkIdType cellId, ptId, numIds, i;
-  int j, k;
-  vtkIdType *pts, *cells, npts;
-  unsigned short ncells;
-  const vtkIdType numCells = this->Mesh->GetNumberOfCells();
-
-  while ( (numIds=static_cast<vtkIdType>(this->Wave.size())) > 0 )
-  {
-    for ( i=0; i < numIds; i++ )
-    {
-      cellId = this->Wave[i];
-      if ( this->Visited[cellId] < 0 )
-      {
-        this->Visited[cellId] = this->RegionNumber;
-        this->NumCellsInRegion++;
-        this->Mesh->GetCellPoints(cellId, npts, pts);
-
-        for (j=0; j < npts; j++)
-        {
-          if ( this->PointMap[ptId=pts[j]] < 0 )
-          {
-            this->PointMap[ptId] = this->PointNumber++;
-            vtkArrayDownCast<vtkIdTypeArray>(this->NewScalars)->SetValue(
-              this->PointMap[ptId], this->RegionNumber);
-
-            this->Mesh->GetPointCells(ptId,ncells,cells);
-
-            // check connectivity criterion (geometric + scalar)
-            if ( this->InScalars )
-            {
-              for (k = 0; k < ncells; ++k)
-              {
-                if (this->IsScalarConnected(cells[k]))
-                {
-                  this->Wave2.push_back(cells[k]);
-                }
-              }
-            }
-            else
-            {
-              for (k = 0; k < ncells; ++k)
-              {
-                this->Wave2.push_back(cells[k]);
-              }
-            }
-          }
-        }//for all points of this cell
-      }//if cell not yet visited
-    }//for all cells in this wave
-
-    this->Wave = this->Wave2;
-    this->Wave2.clear();
-    this->Wave2.reserve(numCells);
-  } //while wave is not empty
-}
-
-// --------------------------------------------------------------------------
-int vtkPolyDataConnectivityFilter::IsScalarConnected( vtkIdType cellId )
-{
-  double s;
-
-  this->Mesh->GetCellPoints(cellId, this->NeighborCellPointIds);
-  const int numScalars = this->NeighborCellPointIds->GetNumberOfIds();
-
-  this->CellScalars->SetNumberOfTuples(numScalars);
-  this->InScalars->GetTuples(this->NeighborCellPointIds,
-                             this->CellScalars);
-
-  double range[2] = {VTK_DOUBLE_MAX, VTK_DOUBLE_MIN};
-
-  // Loop through the cell points.
-  for (int ii=0; ii < numScalars;  ii++)
-  {
-    s = this->CellScalars->GetComponent(ii, 0);
-    if ( s < range[0] )
-    {
-      range[0] = s;
-    }
-    if ( s > range[1] )
-    {
-      range[1] = s;
-    }
-  }
-
-  // Check if the scalars lie within the user supplied scalar range.
-
-  if ( this->FullScalarConnectivity )
-  {
-    // All points in this cell must lie in the user supplied scalar range
-    // for this cell to qualify as being connected.
-    if (range[0] >= this->ScalarRange[0] &&
-        range[1] <= this->ScalarRange[1])
-    {
-      return 1;
-    }
-  }
-  else
-  {
-    // Any point from this cell must lie is the user supplied scalar range
-    // for this cell to qualify as being connected
-    if ( range[1] >= this->ScalarRange[0] &&
-         range[0] <= this->ScalarRange[1] )
-    {
-      return 1;
-    }
-  }
-
-  return 0;
-}
-
 // --------------------------------------------------------------------------
 // Obtain the number of connected regions.
 int vtkPolyDataConnectivityFilter::GetNumberOfExtractedRegions()
@@ -43,6 +43,11 @@
  * This use of ScalarConnectivity is particularly useful for selecting cells
  * for later processing.
  *
+ * The regions are found in parallel with vtkSMPTools, by a union-find over
+ * the cells and their points, and are numbered in the order of their lowest
+ * cell id whatever the number of threads. The output points keep the order
+ * of the input points.
+ *
  * @sa
  * vtkConnectivityFilter
 */
@@ -60,7 +65,6 @@
 #define VTK_EXTRACT_ALL_REGIONS 5
 #define VTK_EXTRACT_CLOSEST_POINT_REGION 6
 
-class vtkDataArray;
 class vtkIdList;
 class vtkIdTypeArray;
 
@@ -239,28 +243,8 @@ protected:
   int ScalarConnectivity;
   int FullScalarConnectivity;
 
-  // Does this cell qualify as being scalar connected ?
-  int IsScalarConnected( vtkIdType cellId );
-
   double ScalarRange[2];
 
-  void TraverseAndMark();
-
-  // used to support algorithm execution
-  vtkDataArray *CellScalars;
-  vtkIdList *NeighborCellPointIds;
-  vtkIdType *Visited;
-  vtkIdType *PointMap;
-  vtkDataArray *NewScalars;
-  vtkIdType RegionNumber;
-  vtkIdType PointNumber;
-  vtkIdType NumCellsInRegion;
-  vtkDataArray *InScalars;
-  vtkPolyData *Mesh;
-  std::vector<vtkIdType> Wave;
-  std::vector<vtkIdType> Wave2;
-  vtkIdList *PointIds;
-  vtkIdList *CellIds;
   vtkIdList *VisitedPointIds;
 
   int MarkVisitedPointIds;
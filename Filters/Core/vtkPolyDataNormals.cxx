@@ -26,9 +26,15 @@
 #include "vtkPolygon.h"
 #include "vtkTriangleStrip.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #include "vtkNew.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkPolyDataNormals);
 
 // Construct with feature angle=30, splitting and consistency turned on,
@@ -60,6 +66,534 @@ vtkPolyDataNormals::vtkPolyDataNormals()
 #define VTK_CELL_NOT_VISITED     0
 #define VTK_CELL_VISITED         1
 
+// Waves of polygons smaller than this are checked serially, as are all
+// waves when a single thread is used.
+#define VTK_PARALLEL_WAVE_SIZE   512
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// The edge neighbors found by a range [Begin, ...) of the cells of a wave,
+// in the order the serial traversal finds them. The neighbors whose
+// ordering has to be reversed are stored as ~cellId.
+struct vtkPolyDataNormalsWaveChunk
+{
+  vtkIdType Begin;
+  std::vector<vtkIdType> Neighbors;
+};
+
+bool vtkPolyDataNormalsChunkBefore(const vtkPolyDataNormalsWaveChunk *a,
+                                   const vtkPolyDataNormalsWaveChunk *b)
+{
+  return a->Begin < b->Begin;
+}
+
+//----------------------------------------------------------------------------
+// Find the unvisited edge neighbors of the cells of a wave and whether
+// their ordering is consistent with the wave cell. Nothing is modified:
+// the neighbors are claimed afterwards, in wave order, so that a neighbor
+// shared by several cells of the wave is ordered from the same cell as in
+// the serial traversal.
+struct vtkPolyDataNormalsCheckWave
+{
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  const int *Visited;
+  const vtkIdType *Wave;
+  int NonManifoldTraversal;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+  vtkSMPThreadLocal<std::vector<vtkPolyDataNormalsWaveChunk> > Chunks;
+
+  vtkPolyDataNormalsCheckWave(vtkPolyData *oldMesh, vtkPolyData *newMesh,
+                              const int *visited, const vtkIdType *wave,
+                              int nonManifoldTraversal)
+    : OldMesh(oldMesh), NewMesh(newMesh), Visited(visited), Wave(wave),
+      NonManifoldTraversal(nonManifoldTraversal)
+  {
+  }
+
+  void Initialize()
+  {
+    this->CellIds.Local()->Allocate(VTK_CELL_SIZE);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellIds = this->CellIds.Local();
+    std::vector<vtkPolyDataNormalsWaveChunk> &chunks = this->Chunks.Local();
+    chunks.push_back(vtkPolyDataNormalsWaveChunk());
+    vtkPolyDataNormalsWaveChunk &chunk = chunks.back();
+    chunk.Begin = begin;
+
+    vtkIdType *pts, *neiPts, npts, numNeiPts;
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkIdType cellId = this->Wave[i];
+      this->NewMesh->GetCellPoints(cellId, npts, pts);
+
+      for (vtkIdType j = 0, j1 = 1; j < npts; ++j, j1 = (j1 + 1 < npts ? j1 + 1 : 0))
+      {
+        this->OldMesh->GetCellEdgeNeighbors(cellId, pts[j], pts[j1], cellIds);
+        vtkIdType numNeighbors = cellIds->GetNumberOfIds();
+        if ( numNeighbors != 1 && !this->NonManifoldTraversal )
+        {
+          continue;
+        }
+        for (vtkIdType k = 0; k < numNeighbors; ++k)
+        {
+          vtkIdType neighbor = cellIds->GetId(k);
+          if (this->Visited[neighbor] != VTK_CELL_NOT_VISITED)
+          {
+            continue;
+          }
+          this->NewMesh->GetCellPoints(neighbor, numNeiPts, neiPts);
+          vtkIdType l;
+          for (l = 0; l < numNeiPts; l++)
+          {
+            if (neiPts[l] == pts[j1])
+            {
+              break;
+            }
+          }
+          chunk.Neighbors.push_back(
+            neiPts[(l+1)%numNeiPts] != pts[j] ? ~neighbor : neighbor);
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+
+  // The chunks of all threads, in wave order.
+  void GetChunks(std::vector<const vtkPolyDataNormalsWaveChunk*> &chunks)
+  {
+    chunks.clear();
+    for (vtkSMPThreadLocal<std::vector<vtkPolyDataNormalsWaveChunk> >::iterator
+           iter = this->Chunks.begin(); iter != this->Chunks.end(); ++iter)
+    {
+      for (size_t c = 0; c < iter->size(); ++c)
+      {
+        chunks.push_back(&(*iter)[c]);
+      }
+    }
+    std::sort(chunks.begin(), chunks.end(), vtkPolyDataNormalsChunkBefore);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Compute the normal of each polygon.
+struct vtkPolyDataNormalsComputePolyNormals
+{
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  float *PolyNormals;
+
+  vtkPolyDataNormalsComputePolyNormals(vtkPolyData *mesh, vtkPoints *points,
+                                       float *polyNormals)
+    : Mesh(mesh), Points(points), PolyNormals(polyNormals)
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdType npts, *pts;
+    double n[3];
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      vtkPolygon::ComputeNormal(this->Points, npts, pts, n);
+      float *polyNormal = this->PolyNormals + 3 * cellId;
+      polyNormal[0] = static_cast<float>(n[0]);
+      polyNormal[1] = static_cast<float>(n[1]);
+      polyNormal[2] = static_cast<float>(n[2]);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Label the cells around ptId with the region they belong to: the cells of
+// a region are connected through edges that use ptId and are not feature
+// edges. cells lists the cells using ptId, in increasing order, and
+// regions[i] receives the region of cells[i] (a cell using ptId several
+// times is labeled at its first position). Returns the number of regions.
+int vtkPolyDataNormalsMarkRegions(vtkPolyData *mesh, const float *polyNormals,
+                                  double cosAngle, vtkIdType ptId,
+                                  vtkIdType ncells, const vtkIdType *cells,
+                                  int *regions, vtkIdList *cellIds)
+{
+  const vtkIdType *cellsEnd = cells + ncells;
+
+  // Start by initializing the cells as unvisited
+  for (vtkIdType i=0; i<ncells; i++)
+  {
+    regions[i] = -1;
+  }
+
+  // Loop over all cells and mark the region that each is in.
+  //
+  vtkIdType numPts, *pts;
+  int numRegions = 0;
+  vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
+  double thisNormal[3], neiNormal[3];
+  for (vtkIdType j=0; j<ncells; j++) //for all cells connected to point
+  {
+    int *region = regions + (std::lower_bound(cells, cellsEnd, cells[j]) - cells);
+    if ( *region < 0 ) //for all unvisited cells
+    {
+      *region = numRegions;
+      //okay, mark all the cells connected to this seed cell and using ptId
+      mesh->GetCellPoints(cells[j],numPts,pts);
+
+      //find the two edges
+      for (spot=0; spot < numPts; spot++)
+      {
+        if ( pts[spot] == ptId )
+        {
+          break;
+        }
+      }
+
+      if ( spot == 0 )
+      {
+        neiPt[0] = pts[spot+1];
+        neiPt[1] = pts[numPts-1];
+      }
+      else if ( spot == (numPts-1) )
+      {
+        neiPt[0] = pts[spot-1];
+        neiPt[1] = pts[0];
+      }
+      else
+      {
+        neiPt[0] = pts[spot+1];
+        neiPt[1] = pts[spot-1];
+      }
+
+      for (int i=0; i<2; i++) //for each of the two edges of the seed cell
+      {
+        cellId = cells[j];
+        nei = neiPt[i];
+        while ( cellId >= 0 ) //while we can grow this region
+        {
+          mesh->GetCellEdgeNeighbors(cellId,ptId,nei,cellIds);
+          int *neiRegion = nullptr;
+          if ( cellIds->GetNumberOfIds() == 1 )
+          {
+            neiCellId = cellIds->GetId(0);
+            neiRegion =
+              regions + (std::lower_bound(cells, cellsEnd, neiCellId) - cells);
+          }
+          if ( neiRegion && *neiRegion < 0 )
+          {
+            const float *n1 = polyNormals + 3 * cellId;
+            const float *n2 = polyNormals + 3 * neiCellId;
+            thisNormal[0] = n1[0];
+            thisNormal[1] = n1[1];
+            thisNormal[2] = n1[2];
+            neiNormal[0] = n2[0];
+            neiNormal[1] = n2[1];
+            neiNormal[2] = n2[2];
+
+            if ( vtkMath::Dot(thisNormal,neiNormal) > cosAngle )
+            {
+              //visit and arrange to visit next edge neighbor
+              *neiRegion = numRegions;
+              cellId = neiCellId;
+              mesh->GetCellPoints(cellId,numPts,pts);
+
+              for (spot=0; spot < numPts; spot++)
+              {
+                if ( pts[spot] == ptId )
+                {
+                  break;
+                }
+              }
+
+              if (spot == 0)
+              {
+                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[numPts-1]);
+              }
+              else if (spot == (numPts-1))
+              {
+                nei = (pts[spot-1] != nei ? pts[spot-1] : pts[0]);
+              }
+              else
+              {
+                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[spot-1]);
+              }
+
+            }//if not separated by edge angle
+            else
+            {
+              cellId = -1; //separated by edge angle
+            }
+          }//if can move to edge neighbor
+          else
+          {
+            cellId = -1;//separated by previous visit, boundary, or non-manifold
+          }
+        }//while visit wave is propagating
+      }//for each of the two edges of the starting cell
+      numRegions++;
+    }//if cell is unvisited
+  }//for all cells connected to point ptId
+
+  return numRegions;
+}
+
+//----------------------------------------------------------------------------
+// A point id of the connectivity of a polygon to be replaced by the
+// duplicate of the point for the given region (see MarkRegions()).
+struct vtkPolyDataNormalsSplit
+{
+  vtkIdType *Slot;
+  vtkIdType PtId;
+  int Region;
+};
+
+//----------------------------------------------------------------------------
+// Count the duplicates each point is split into and record the point ids of
+// the polygons to replace. Nothing is modified, so all the points can be
+// processed at once.
+struct vtkPolyDataNormalsMarkSplits
+{
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  const float *PolyNormals;
+  double CosAngle;
+  vtkIdType *NumSplits;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+  vtkSMPThreadLocal<std::vector<int> > Regions;
+  vtkSMPThreadLocal<std::vector<vtkPolyDataNormalsSplit> > Splits;
+
+  vtkPolyDataNormalsMarkSplits(vtkPolyData *oldMesh, vtkPolyData *newMesh,
+                               const float *polyNormals, double cosAngle,
+                               vtkIdType *numSplits)
+    : OldMesh(oldMesh), NewMesh(newMesh), PolyNormals(polyNormals),
+      CosAngle(cosAngle), NumSplits(numSplits)
+  {
+  }
+
+  void Initialize()
+  {
+    this->CellIds.Local()->Allocate(VTK_CELL_SIZE);
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkIdList *cellIds = this->CellIds.Local();
+    std::vector<int> &regions = this->Regions.Local();
+    std::vector<vtkPolyDataNormalsSplit> &splits = this->Splits.Local();
+    vtkIdType ncells, *cells, npts, *pts;
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      this->NumSplits[ptId] = 0;
+      this->OldMesh->GetPointCells(ptId, ncells, cells);
+      if ( ncells <= 1 )
+      {
+        continue; //point does not need to be further disconnected
+      }
+      if (regions.size() < static_cast<size_t>(ncells))
+      {
+        regions.resize(ncells);
+      }
+      int numRegions = vtkPolyDataNormalsMarkRegions(
+        this->OldMesh, this->PolyNormals, this->CosAngle, ptId, ncells,
+        cells, &regions[0], cellIds);
+      if ( numRegions <= 1 )
+      {
+        continue; //a single region, no splitting ever required
+      }
+      this->NumSplits[ptId] = numRegions - 1;
+
+      // For all cells not in the first region, the ptId is replaced with a
+      // new ptId, which is a duplicate of the point but disconnected
+      // topologically. A cell using ptId several times is listed as many
+      // times, each occurrence is replaced in turn.
+      for (vtkIdType j = 0; j < ncells; ++j)
+      {
+        vtkIdType first = std::lower_bound(cells, cells + ncells, cells[j]) - cells;
+        if ( regions[first] <= 0 )
+        {
+          continue;
+        }
+        this->NewMesh->GetCellPoints(cells[j], npts, pts);
+        for (vtkIdType i = 0, occurrence = j - first; i < npts; ++i)
+        {
+          if ( pts[i] == ptId && occurrence-- == 0 )
+          {
+            vtkPolyDataNormalsSplit split = { pts + i, ptId, regions[first] };
+            splits.push_back(split);
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+//----------------------------------------------------------------------------
+// List the input point duplicated by each new point.
+struct vtkPolyDataNormalsFillMap
+{
+  const vtkIdType *Offsets;
+  vtkIdType NumPts;
+  vtkIdType *Map;
+
+  vtkPolyDataNormalsFillMap(const vtkIdType *offsets, vtkIdType numPts,
+                            vtkIdType *map)
+    : Offsets(offsets), NumPts(numPts), Map(map)
+  {
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      this->Map[ptId] = ptId;
+      for (vtkIdType newId = this->NumPts + this->Offsets[ptId];
+           newId < this->NumPts + this->Offsets[ptId + 1]; ++newId)
+      {
+        this->Map[newId] = ptId;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the points, split points included, and their attributes.
+struct vtkPolyDataNormalsCopyPoints
+{
+  vtkPoints *InPoints;
+  const vtkIdType *Map;
+  vtkPoints *NewPoints;
+  vtkPointData *InPD;
+  vtkPointData *OutPD;
+
+  vtkPolyDataNormalsCopyPoints(vtkPoints *inPoints, const vtkIdType *map,
+                               vtkPoints *newPoints, vtkPointData *inPD,
+                               vtkPointData *outPD)
+    : InPoints(inPoints), Map(map), NewPoints(newPoints), InPD(inPD),
+      OutPD(outPD)
+  {
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for (vtkIdType newId = ptId; newId < endPtId; ++newId)
+    {
+      this->InPoints->GetPoint(this->Map[newId], x);
+      this->NewPoints->SetPoint(newId, x);
+    }
+    this->OutPD->GatherData(this->InPD, this->Map + ptId, ptId,
+                            endPtId - ptId);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Average the normals of the polygons using each input point and its
+// duplicates. The cells using a point are listed in increasing order so the
+// normals are summed in the same order as a serial loop over the polygons
+// would.
+struct vtkPolyDataNormalsAverage
+{
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  vtkIdType NumPts;
+  const vtkIdType *Offsets;
+  const float *PolyNormals;
+  double FlipDirection;
+  float *Normals;
+
+  vtkPolyDataNormalsAverage(vtkPolyData *oldMesh, vtkPolyData *newMesh,
+                            vtkIdType numPts, const vtkIdType *offsets,
+                            const float *polyNormals, double flipDirection,
+                            float *normals)
+    : OldMesh(oldMesh), NewMesh(newMesh), NumPts(numPts), Offsets(offsets),
+      PolyNormals(polyNormals), FlipDirection(flipDirection), Normals(normals)
+  {
+  }
+
+  void Normalize(vtkIdType ptId)
+  {
+    float *normal = this->Normals + 3 * ptId;
+    const double length = sqrt(normal[0] * normal[0] +
+                               normal[1] * normal[1] +
+                               normal[2] * normal[2]) * this->FlipDirection;
+    if (length != 0.0)
+    {
+      normal[0] /= length;
+      normal[1] /= length;
+      normal[2] /= length;
+    }
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkIdType ncells, *cells, npts, *pts;
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      vtkIdType firstNewId = 0, numSplits = 0;
+      if (this->Offsets)
+      {
+        firstNewId = this->NumPts + this->Offsets[ptId];
+        numSplits = this->Offsets[ptId + 1] - this->Offsets[ptId];
+      }
+      std::fill_n(this->Normals + 3 * ptId, 3, 0.0f);
+      std::fill_n(this->Normals + 3 * firstNewId, 3 * numSplits, 0.0f);
+
+      this->OldMesh->GetPointCells(ptId, ncells, cells);
+      for (vtkIdType c = 0; c < ncells; ++c)
+      {
+        const float *polyNormal = this->PolyNormals + 3 * cells[c];
+        if (numSplits == 0)
+        {
+          float *normal = this->Normals + 3 * ptId;
+          normal[0] += polyNormal[0];
+          normal[1] += polyNormal[1];
+          normal[2] += polyNormal[2];
+          continue;
+        }
+
+        // The cell may use the point or one of its duplicates.
+        if (c > 0 && cells[c] == cells[c - 1])
+        {
+          continue;
+        }
+        this->NewMesh->GetCellPoints(cells[c], npts, pts);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          vtkIdType id = pts[i];
+          if (id == ptId ||
+              (id >= firstNewId && id < firstNewId + numSplits))
+          {
+            float *normal = this->Normals + 3 * id;
+            normal[0] += polyNormal[0];
+            normal[1] += polyNormal[1];
+            normal[2] += polyNormal[2];
+          }
+        }
+      }
+
+      this->Normalize(ptId);
+      for (vtkIdType i = 0; i < numSplits; ++i)
+      {
+        this->Normalize(firstNewId + i);
+      }
+    }
+  }
+};
+
+} // end anon namespace
+
 // Generate normals for polygon meshes
 int vtkPolyDataNormals::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -91,7 +625,7 @@ int vtkPolyDataNormals::RequestData(
   vtkDataSetAttributes* outCD = output->GetCellData();
   double n[3];
   vtkCellArray *newPolys;
-  vtkIdType ptId, oldId;
+  vtkIdType ptId;
 
   vtkDebugMacro(<<"Generating surface normals");
 
@@ -169,11 +703,25 @@ int vtkPolyDataNormals::RequestData(
     polys->Delete();
     numPolys = polys->GetNumberOfCells();//added some new triangles
   }
+  else if ( inPolys->GetStorage() == vtkCellArray::OFFSETS32_STORAGE )
+  {
+    // copy the input cells, their storage is converted below
+    polys = vtkCellArray::New();
+    polys->DeepCopy(inPolys);
+    this->OldMesh->SetPolys(polys);
+    polys->Delete();
+  }
   else
   {
     this->OldMesh->SetPolys(inPolys);
     polys = inPolys;
   }
+  // The cells are accessed through pointers from several threads, which
+  // would convert 32-bit storage on first access.
+  if ( polys->GetStorage() == vtkCellArray::OFFSETS32_STORAGE )
+  {
+    polys->SetStorageToOffsets();
+  }
   this->OldMesh->BuildLinks();
   this->UpdateProgress(0.10);
 
@@ -190,7 +738,7 @@ int vtkPolyDataNormals::RequestData(
 
   // The visited array keeps track of which polygons have been visited.
   //
-  if ( this->Consistency || this->Splitting || this->AutoOrientNormals )
+  if ( this->Consistency || this->AutoOrientNormals )
   {
     this->Visited = new int[numPolys];
     memset(this->Visited, VTK_CELL_NOT_VISITED, numPolys*sizeof(int));
@@ -336,6 +884,14 @@ int vtkPolyDataNormals::RequestData(
     }//Consistent ordering
   } // don't automatically orient normals
 
+  if ( this->Visited )
+  {
+    delete [] this->Visited;
+    this->Visited = nullptr;
+    this->CellIds->Delete();
+    this->CellIds = nullptr;
+  }
+
   this->UpdateProgress(0.333);
 
   //  Initial pass to compute polygon normals without effects of neighbors
@@ -345,21 +901,14 @@ int vtkPolyDataNormals::RequestData(
   this->PolyNormals->Allocate(3*numPolys);
   this->PolyNormals->SetName("Normals");
   this->PolyNormals->SetNumberOfTuples(numPolys);
+  float *fPolyNormals = this->PolyNormals->WritePointer(0, 3 * numPolys);
 
-  for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
-       cellId++ )
-  {
-    if ((cellId % 1000) == 0)
-    {
-      this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
-      if (this->GetAbortExecute())
-      {
-        break;
-      }
-    }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(cellId,n);
-  }
+  vtkPolyDataNormalsComputePolyNormals computePolyNormals(
+    this->NewMesh, inPts, fPolyNormals);
+  vtkSMPTools::For(0, numPolys, computePolyNormals);
+  this->UpdateProgress(0.5);
+
+  std::vector<vtkIdType> offsets;
 
   // Split mesh if sharp features
   if ( this->Splitting )
@@ -369,22 +918,39 @@ int vtkPolyDataNormals::RequestData(
     // connectivity.
     //
       this->CosAngle = cos( vtkMath::RadiansFromDegrees( this->FeatureAngle) );
+    //  Find the points to split, the duplicates of a point are numbered
+    // after those of the points before it.
+    //
+    offsets.resize(numPts + 1);
+    vtkPolyDataNormalsMarkSplits markSplits(this->OldMesh, this->NewMesh,
+      fPolyNormals, this->CosAngle, &offsets[0]);
+    vtkSMPTools::For(0, numPts, markSplits);
+    numNewPts = numPts + vtkSMPTools::ExclusiveScan(
+      offsets.begin(), offsets.begin() + numPts, offsets.begin(),
+      vtkIdType(0));
+    offsets[numPts] = numNewPts - numPts;
+
     //  Splitting will create new points.  We have to create index array
     // to map new points into old points.
     //
     this->Map = vtkIdList::New();
-    this->Map->SetNumberOfIds(numPts);
-    for (vtkIdType i=0; i < numPts; i++)
-    {
-      this->Map->SetId(i,i);
-    }
+    this->Map->SetNumberOfIds(numNewPts);
+    vtkPolyDataNormalsFillMap fillMap(&offsets[0], numPts,
+                                      this->Map->GetPointer(0));
+    vtkSMPTools::For(0, numPts, fillMap);
 
-    for (ptId=0; ptId < numPts; ptId++)
+    //  Replace the split points in the polygons connectivity array.
+    //
+    for (vtkSMPThreadLocal<std::vector<vtkPolyDataNormalsSplit> >::iterator
+           iter = markSplits.Splits.begin(); iter != markSplits.Splits.end();
+         ++iter)
     {
-      this->MarkAndSplit(ptId);
-    }//for all input points
-
-    numNewPts = this->Map->GetNumberOfIds();
+      for (size_t i = 0; i < iter->size(); ++i)
+      {
+        const vtkPolyDataNormalsSplit &split = (*iter)[i];
+        *split.Slot = numPts + offsets[split.PtId] + split.Region - 1; // this is very nasty! direct write!
+      }
+    }
 
     vtkDebugMacro(<<"Created " << numNewPts-numPts << " new points");
 
@@ -418,12 +984,10 @@ int vtkPolyDataNormals::RequestData(
     }
 
     newPts->SetNumberOfPoints(numNewPts);
-    for (ptId=0; ptId < numNewPts; ptId++)
-    {
-      oldId = this->Map->GetId(ptId);
-      newPts->SetPoint(ptId,inPts->GetPoint(oldId));
-      outPD->CopyData(pd,oldId,ptId);
-    }
+    outPD->SetNumberOfTuples(numNewPts);
+    vtkPolyDataNormalsCopyPoints copyPoints(inPts, this->Map->GetPointer(0),
+                                            newPts, pd, outPD);
+    vtkSMPTools::For(0, numNewPts, copyPoints);
     this->Map->Delete();
   } //splitting
 
@@ -434,12 +998,6 @@ int vtkPolyDataNormals::RequestData(
     outPD->PassData(pd);
   }
 
-  if ( this->Consistency || this->Splitting )
-  {
-    delete [] this->Visited;
-    this->CellIds->Delete();
-  }
-
   this->UpdateProgress(0.80);
 
   //  Finally, traverse all elements, computing polygon normals and
@@ -455,36 +1013,17 @@ int vtkPolyDataNormals::RequestData(
   newNormals->SetNumberOfTuples(numNewPts);
   newNormals->SetName("Normals");
   float *fNormals = newNormals->WritePointer(0, 3 * numNewPts);
-  std::fill_n(fNormals, 3 * numNewPts, 0);
-
-  float *fPolyNormals = this->PolyNormals->WritePointer(0, 3 * numPolys);
 
   if (this->ComputePointNormals)
   {
-    for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);
-         ++cellId)
-    {
-      for (vtkIdType i = 0; i < npts; ++i)
-      {
-        fNormals[3 * pts[i]] += fPolyNormals[3 * cellId];
-        fNormals[3 * pts[i] + 1] += fPolyNormals[3 * cellId + 1];
-        fNormals[3 * pts[i] + 2] += fPolyNormals[3 * cellId + 2];
-      }
-    }
-
-    for (vtkIdType i = 0; i < numNewPts; ++i)
-    {
-      const double length = sqrt(fNormals[3 * i] * fNormals[3 * i] +
-                                 fNormals[3 * i + 1] * fNormals[3 * i + 1] +
-                                 fNormals[3 * i + 2] * fNormals[3 * i + 2]
-                                 ) * flipDirection;
-      if (length != 0.0)
-      {
-        fNormals[3 * i] /= length;
-        fNormals[3 * i + 1] /= length;
-        fNormals[3 * i + 2] /= length;
-      }
-    }
+    vtkPolyDataNormalsAverage average(this->OldMesh, this->NewMesh, numPts,
+      offsets.empty() ? nullptr : &offsets[0], fPolyNormals, flipDirection,
+      fNormals);
+    vtkSMPTools::For(0, numPts, average);
+  }
+  else
+  {
+    std::fill_n(fNormals, 3 * numNewPts, 0);
   }
 
   //  Update ourselves.  If no new nodes have been created (i.e., no
@@ -538,220 +1077,93 @@ void vtkPolyDataNormals::TraverseAndOrder (void)
   vtkIdType *pts, *neiPts, npts, numNeiPts;
   vtkIdType neighbor;
   vtkIdList *tmpWave;
+  const bool parallel = vtkSMPTools::GetEstimatedNumberOfThreads() > 1;
 
   // propagate wave until nothing left in wave
   while ( (numIds=this->Wave->GetNumberOfIds()) > 0 )
   {
-    for ( i=0; i < numIds; i++ )
+    if ( parallel && numIds >= VTK_PARALLEL_WAVE_SIZE )
     {
-      cellId = this->Wave->GetId(i);
-
-      this->NewMesh->GetCellPoints(cellId, npts, pts);
-
-      for (j = 0, j1 = 1; j < npts; ++j, (j1 = (++j1 < npts) ? j1 : 0)) //for each edge neighbor
+      // Look for the neighbors of the wave in parallel, then visit them in
+      // the order of the serial loop below.
+      vtkPolyDataNormalsCheckWave checkWave(this->OldMesh, this->NewMesh,
+        this->Visited, this->Wave->GetPointer(0), this->NonManifoldTraversal);
+      vtkSMPTools::For(0, numIds, checkWave);
+      std::vector<const vtkPolyDataNormalsWaveChunk*> chunks;
+      checkWave.GetChunks(chunks);
+      for (size_t c = 0; c < chunks.size(); ++c)
       {
-        this->OldMesh->GetCellEdgeNeighbors(cellId, pts[j], pts[j1], this->CellIds);
-
-        //  Check the direction of the neighbor ordering.  Should be
-        //  consistent with us (i.e., if we are n1->n2,
-        // neighbor should be n2->n1).
-        if ( this->CellIds->GetNumberOfIds() == 1 ||
-             this->NonManifoldTraversal )
+        const std::vector<vtkIdType> &neighbors = chunks[c]->Neighbors;
+        for (size_t n = 0; n < neighbors.size(); ++n)
         {
-          for (k=0; k < this->CellIds->GetNumberOfIds(); k++)
+          neighbor = (neighbors[n] >= 0 ? neighbors[n] : ~neighbors[n]);
+          if (this->Visited[neighbor] == VTK_CELL_NOT_VISITED)
           {
-            if (this->Visited[this->CellIds->GetId(k)]==VTK_CELL_NOT_VISITED)
+            if ( neighbors[n] < 0 )
             {
-              neighbor = this->CellIds->GetId(k);
-              this->NewMesh->GetCellPoints(neighbor,numNeiPts,neiPts);
-              for (l=0; l < numNeiPts; l++)
-              {
-                if (neiPts[l] == pts[j1])
-                {
-                  break;
-                }
-              }
-
-              //  Have to reverse ordering if neighbor not consistent
-              //
-              if ( neiPts[(l+1)%numNeiPts] != pts[j] )
-              {
-                this->NumFlips++;
-                this->NewMesh->ReverseCell(neighbor);
-              }
-              this->Visited[neighbor] = VTK_CELL_VISITED;
-              this->Wave2->InsertNextId(neighbor);
-            }// if cell not visited
-          } // for each edge neighbor
-        } //for manifold or non-manifold traversal allowed
-      } // for all edges of this polygon
-    } //for all cells in wave
-
-    //swap wave and proceed with propagation
-    tmpWave = this->Wave;
-    this->Wave = this->Wave2;
-    this->Wave2 = tmpWave;
-    this->Wave2->Reset();
-  } //while wave still propagating
-}
-
-//
-//  Mark polygons around vertex.  Create new vertex (if necessary) and
-//  replace (i.e., split mesh).
-//
-void vtkPolyDataNormals::MarkAndSplit (vtkIdType ptId)
-{
-  int i,j;
-
-  // Get the cells using this point and make sure that we have to do something
-  unsigned short ncells;
-  vtkIdType *cells;
-  this->OldMesh->GetPointCells(ptId,ncells,cells);
-  if ( ncells <= 1 )
-  {
-    return; //point does not need to be further disconnected
-  }
-
-  // Start moving around the "cycle" of points using the point. Label
-  // each point as requiring a visit. Then label each subregion of cells
-  // connected to this point that are connected (and not separated by
-  // a feature edge) with a given region number. For each N regions
-  // created, N-1 duplicate (split) points are created. The split point
-  // replaces the current point ptId in the polygons connectivity array.
-  //
-  // Start by initializing the cells as unvisited
-  for (i=0; i<ncells; i++)
-  {
-    this->Visited[cells[i]] = -1;
-  }
-
-  // Loop over all cells and mark the region that each is in.
-  //
-  vtkIdType numPts;
-  vtkIdType *pts;
-  int numRegions = 0;
-  vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
-  double thisNormal[3], neiNormal[3];
-  for (j=0; j<ncells; j++) //for all cells connected to point
-  {
-    if ( this->Visited[cells[j]] < 0 ) //for all unvisited cells
-    {
-      this->Visited[cells[j]] = numRegions;
-      //okay, mark all the cells connected to this seed cell and using ptId
-      this->OldMesh->GetCellPoints(cells[j],numPts,pts);
-
-      //find the two edges
-      for (spot=0; spot < numPts; spot++)
-      {
-        if ( pts[spot] == ptId )
-        {
-          break;
+              this->NumFlips++;
+              this->NewMesh->ReverseCell(neighbor);
+            }
+            this->Visited[neighbor] = VTK_CELL_VISITED;
+            this->Wave2->InsertNextId(neighbor);
+          }
         }
       }
-
-      if ( spot == 0 )
-      {
-        neiPt[0] = pts[spot+1];
-        neiPt[1] = pts[numPts-1];
-      }
-      else if ( spot == (numPts-1) )
-      {
-        neiPt[0] = pts[spot-1];
-        neiPt[1] = pts[0];
-      }
-      else
+    }
+    else
+    {
+      for ( i=0; i < numIds; i++ )
       {
-        neiPt[0] = pts[spot+1];
-        neiPt[1] = pts[spot-1];
-      }
+        cellId = this->Wave->GetId(i);
 
-      for (i=0; i<2; i++) //for each of the two edges of the seed cell
-      {
-        cellId = cells[j];
-        nei = neiPt[i];
-        while ( cellId >= 0 ) //while we can grow this region
+        this->NewMesh->GetCellPoints(cellId, npts, pts);
+
+        for (j = 0, j1 = 1; j < npts; ++j, (j1 = (++j1 < npts) ? j1 : 0)) //for each edge neighbor
         {
-          this->OldMesh->GetCellEdgeNeighbors(cellId,ptId,nei,this->CellIds);
-          if ( this->CellIds->GetNumberOfIds() == 1 &&
-               this->Visited[(neiCellId=this->CellIds->GetId(0))] < 0 )
-          {
-            this->PolyNormals->GetTuple(cellId, thisNormal);
-            this->PolyNormals->GetTuple(neiCellId, neiNormal);
+          this->OldMesh->GetCellEdgeNeighbors(cellId, pts[j], pts[j1], this->CellIds);
 
-            if ( vtkMath::Dot(thisNormal,neiNormal) > CosAngle )
+          //  Check the direction of the neighbor ordering.  Should be
+          //  consistent with us (i.e., if we are n1->n2,
+          // neighbor should be n2->n1).
+          if ( this->CellIds->GetNumberOfIds() == 1 ||
+               this->NonManifoldTraversal )
+          {
+            for (k=0; k < this->CellIds->GetNumberOfIds(); k++)
             {
-              //visit and arrange to visit next edge neighbor
-              this->Visited[neiCellId] = numRegions;
-              cellId = neiCellId;
-              this->OldMesh->GetCellPoints(cellId,numPts,pts);
-
-              for (spot=0; spot < numPts; spot++)
+              if (this->Visited[this->CellIds->GetId(k)]==VTK_CELL_NOT_VISITED)
               {
-                if ( pts[spot] == ptId )
+                neighbor = this->CellIds->GetId(k);
+                this->NewMesh->GetCellPoints(neighbor,numNeiPts,neiPts);
+                for (l=0; l < numNeiPts; l++)
                 {
-                  break;
+                  if (neiPts[l] == pts[j1])
+                  {
+                    break;
+                  }
                 }
-              }
-
-              if (spot == 0)
-              {
-                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[numPts-1]);
-              }
-              else if (spot == (numPts-1))
-              {
-                nei = (pts[spot-1] != nei ? pts[spot-1] : pts[0]);
-              }
-              else
-              {
-                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[spot-1]);
-              }
 
-            }//if not separated by edge angle
-            else
-            {
-              cellId = -1; //separated by edge angle
-            }
-          }//if can move to edge neighbor
-          else
-          {
-            cellId = -1;//separated by previous visit, boundary, or non-manifold
-          }
-        }//while visit wave is propagating
-      }//for each of the two edges of the starting cell
-      numRegions++;
-    }//if cell is unvisited
-  }//for all cells connected to point ptId
-
-  if ( numRegions <=1 )
-  {
-    return; //a single region, no splitting ever required
-  }
-
-  // Okay, for all cells not in the first region, the ptId is
-  // replaced with a new ptId, which is a duplicate of the first
-  // point, but disconnected topologically.
-  //
-  vtkIdType lastId = this->Map->GetNumberOfIds();
-  vtkIdType replacementPoint;
-  for (j=0; j<ncells; j++)
-  {
-    if (this->Visited[cells[j]] > 0 ) //replace point if splitting needed
-    {
-      replacementPoint = lastId + this->Visited[cells[j]] - 1;
-
-      this->Map->InsertId(replacementPoint, ptId);
+                //  Have to reverse ordering if neighbor not consistent
+                //
+                if ( neiPts[(l+1)%numNeiPts] != pts[j] )
+                {
+                  this->NumFlips++;
+                  this->NewMesh->ReverseCell(neighbor);
+                }
+                this->Visited[neighbor] = VTK_CELL_VISITED;
+                this->Wave2->InsertNextId(neighbor);
+              }// if cell not visited
+            } // for each edge neighbor
+          } //for manifold or non-manifold traversal allowed
+        } // for all edges of this polygon
+      } //for all cells in wave
+    } //serial wave
 
-      this->NewMesh->GetCellPoints(cells[j],numPts,pts);
-      for (i=0; i < numPts; i++)
-      {
-        if ( pts[i] == ptId )
-        {
-          pts[i] = replacementPoint; // this is very nasty! direct write!
-          break;
-        }
-      }//replace ptId with split point
-    }//if not in first regions and requiring splitting
-  }//for all cells connected to ptId
+    //swap wave and proceed with propagation
+    tmpWave = this->Wave;
+    this->Wave = this->Wave2;
+    this->Wave2 = tmpWave;
+    this->Wave2->Reset();
+  } //while wave still propagating
 }
 
 void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
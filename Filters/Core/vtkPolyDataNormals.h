@@ -39,6 +39,12 @@
  * are split and new points generated to prevent blurry edges (due to
  * Gouraud shading).
  *
+ * The polygon normals, the splitting of sharp edges and the averaging of
+ * the normals at the points run in parallel with vtkSMPTools. The
+ * consistent ordering of the polygons propagates waves of polygons from a
+ * seed; large waves are checked in parallel. The output does not depend on
+ * the number of threads.
+ *
  * @warning
  * Normals are computed only for polygons and triangle strips. Normals are
  * not computed for lines or vertices.
@@ -206,11 +212,6 @@ private:
   // checked and properly ordered polygons.
   void TraverseAndOrder(void);
 
-  // Check the point id give to see whether it lies on a feature
-  // edge. If so, split the point (i.e., duplicate it) to topologically
-  // separate the mesh.
-  void MarkAndSplit(vtkIdType ptId);
-
 private:
   vtkPolyDataNormals(const vtkPolyDataNormals&) VTK_DELETE_FUNCTION;
   void operator=(const vtkPolyDataNormals&) VTK_DELETE_FUNCTION;
@@ -34,6 +34,14 @@
  * vertices is a single iteration. Many iterations (generally around 20 or
  * so) are repeated until the desired result is obtained.
  *
+ * Each iteration moves the vertices from the positions of the previous
+ * iteration, so the vertices can be smoothed in parallel with vtkSMPTools
+ * and the result does not depend on the number of threads. The topological
+ * analysis also runs in parallel. Constrained smoothing (see the Source
+ * below) is sequential. Earlier versions moved each vertex from the already
+ * moved positions of its neighbors, so their output differs slightly (by
+ * less than 0.03% of the bounding box diagonal in the regression tests).
+ *
  * There are some special instance variables used to control the execution
  * of this filter. (These ivars basically control what vertices can be
  * smoothed, and the creation of the connectivity array.) The
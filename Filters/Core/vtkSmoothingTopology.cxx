@@ -0,0 +1,493 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSmoothingTopology.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSmoothingTopology.h"
+
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkTriangleFilter.h"
+
+// The classification of the polygon edges. Edges are classified by the
+// first polygon using them, the other polygons skip them.
+#define VTK_SKIPPED_EDGE -1
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// The number of points of each polygon, turned into their locations in the
+// edge classification by a scan.
+struct vtkSmoothingPolygonSizes
+{
+  vtkPolyData *Mesh;
+  vtkIdType *Sizes;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType npts, *pts;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      this->Sizes[cellId] = npts;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Classify the edges of each polygon, edge i joining points i and i+1.
+struct vtkSmoothingClassifyEdges
+{
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  const vtkIdType *Locations;
+  signed char *EdgeTypes;
+  double CosFeatureAngle;
+  int FeatureEdgeSmoothing;
+  int NonManifoldSmoothing;
+  vtkSMPThreadLocalObject<vtkIdList> Neighbors;
+
+  void Initialize()
+  {
+    this->Neighbors.Local()->Allocate(VTK_CELL_SIZE);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *neighbors = this->Neighbors.Local();
+    vtkIdType npts, *pts, numNeiPts, *neiPts;
+    double normal[3], neiNormal[3];
+
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      signed char *edgeTypes = this->EdgeTypes + this->Locations[cellId];
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        vtkIdType p1 = pts[i];
+        vtkIdType p2 = pts[(i+1)%npts];
+
+        this->Mesh->GetCellEdgeNeighbors(cellId, p1, p2, neighbors);
+        vtkIdType numNei = neighbors->GetNumberOfIds();
+
+        signed char edge = vtkSmoothingTopology::SIMPLE_VERTEX;
+        if ( numNei == 0 )
+        {
+          edge = vtkSmoothingTopology::BOUNDARY_EDGE_VERTEX;
+        }
+        else if ( numNei >= 2 )
+        {
+          // non-manifold case, check nonmanifold smoothing state
+          if ( !this->NonManifoldSmoothing )
+          {
+            // check to make sure that this edge hasn't been marked already
+            vtkIdType j;
+            for (j=0; j < numNei; j++)
+            {
+              if ( neighbors->GetId(j) < cellId )
+              {
+                break;
+              }
+            }
+            if ( j >= numNei )
+            {
+              edge = vtkSmoothingTopology::FEATURE_EDGE_VERTEX;
+            }
+          }
+        }
+        else if ( neighbors->GetId(0) > cellId )
+        {
+          if ( this->FeatureEdgeSmoothing )
+          {
+            vtkPolygon::ComputeNormal(this->Points,npts,pts,normal);
+            this->Mesh->GetCellPoints(neighbors->GetId(0),numNeiPts,neiPts);
+            vtkPolygon::ComputeNormal(this->Points,numNeiPts,neiPts,
+                                      neiNormal);
+
+            if ( vtkMath::Dot(normal,neiNormal) <= this->CosFeatureAngle )
+            {
+              edge = vtkSmoothingTopology::FEATURE_EDGE_VERTEX;
+            }
+          }
+        }
+        else // a visited edge; skip rest of analysis
+        {
+          edge = VTK_SKIPPED_EDGE;
+        }
+        edgeTypes[i] = edge;
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+//----------------------------------------------------------------------------
+// Classify the points and gather their neighbors. Each point replays, in
+// increasing cell order, the edges of the polygons using it, which is the
+// order of a serial traversal of the polygons. The first pass counts the
+// neighbors, the second one stores them and checks the edge vertices.
+struct vtkSmoothingClassifyPoints
+{
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  const vtkIdType *Locations;
+  const signed char *EdgeTypes;
+  const vtkIdType *LineNeighbors;
+  char *Types;
+  vtkIdType *Offsets;
+  vtkIdType *Neighbors;
+  bool StoreNeighbors;
+  double CosEdgeAngle;
+  int BoundarySmoothing;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > Counts;
+
+  vtkSmoothingClassifyPoints() : Counts(std::vector<vtkIdType>(4, 0))
+  {
+  }
+
+  // Add the neighbor nei joined by an edge of the given type. A simple
+  // vertex restarts its list at its first edge, so the neighbors found
+  // before may not fit in the size counted for the point: they are dropped.
+  static void InsertNeighbor(char &type, vtkIdType *neighbors,
+                             vtkIdType size, vtkIdType &n, vtkIdType nei,
+                             signed char edge)
+  {
+    if ( edge && type == vtkSmoothingTopology::SIMPLE_VERTEX )
+    {
+      n = 0;
+      if ( neighbors )
+      {
+        neighbors[n] = nei;
+      }
+      ++n;
+      type = edge;
+    }
+    else if ( (edge && type == vtkSmoothingTopology::BOUNDARY_EDGE_VERTEX) ||
+              (edge && type == vtkSmoothingTopology::FEATURE_EDGE_VERTEX) ||
+              (!edge && type == vtkSmoothingTopology::SIMPLE_VERTEX) )
+    {
+      if ( neighbors && n < size )
+      {
+        neighbors[n] = nei;
+      }
+      ++n;
+      if ( type && edge == vtkSmoothingTopology::BOUNDARY_EDGE_VERTEX )
+      {
+        type = vtkSmoothingTopology::BOUNDARY_EDGE_VERTEX;
+      }
+    }
+  }
+
+  // Classify ptId, storing its neighbors when neighbors is not null, in
+  // which case it has room for the size neighbors counted by the first pass.
+  vtkIdType Classify(vtkIdType ptId, char &type, vtkIdType *neighbors,
+                     vtkIdType size)
+  {
+    vtkIdType n = 0;
+    if ( type == vtkSmoothingTopology::FEATURE_EDGE_VERTEX )
+    { // interior point of a line
+      if ( neighbors )
+      {
+        neighbors[0] = this->LineNeighbors[2*ptId];
+        neighbors[1] = this->LineNeighbors[2*ptId+1];
+      }
+      n = 2;
+    }
+    if ( !this->Mesh || type == vtkSmoothingTopology::FIXED_VERTEX )
+    {
+      return n;
+    }
+
+    vtkIdType ncells, *cells, npts, *pts;
+    this->Mesh->GetPointCells(ptId, ncells, cells);
+    for (vtkIdType j = 0; j < ncells; ++j)
+    {
+      vtkIdType cellId = cells[j];
+      if ( j > 0 && cellId == cells[j-1] )
+      { // the cell uses the point several times
+        continue;
+      }
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      const signed char *edgeTypes = this->EdgeTypes + this->Locations[cellId];
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        vtkIdType p1 = pts[i];
+        vtkIdType p2 = pts[(i+1)%npts];
+        if ( edgeTypes[i] == VTK_SKIPPED_EDGE || (p1 != ptId && p2 != ptId) )
+        {
+          continue;
+        }
+        if ( p1 == ptId )
+        {
+          this->InsertNeighbor(type, neighbors, size, n, p2, edgeTypes[i]);
+        }
+        if ( p2 == ptId )
+        {
+          this->InsertNeighbor(type, neighbors, size, n, p1, edgeTypes[i]);
+        }
+      }
+    }
+    return n;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    if ( !this->StoreNeighbors )
+    {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        char type = this->Types[ptId];
+        this->Offsets[ptId] = this->Classify(ptId, type, nullptr, 0);
+      }
+      return;
+    }
+
+    std::vector<vtkIdType> &counts = this->Counts.Local();
+    double x1[3], x2[3], x3[3], l1[3], l2[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      char &type = this->Types[ptId];
+      vtkIdType *neighbors = this->Neighbors + this->Offsets[ptId];
+      vtkIdType npts = this->Classify(ptId, type, neighbors,
+        this->Offsets[ptId+1] - this->Offsets[ptId]);
+
+      // post-process edge vertices to make sure we can smooth them
+      if ( type == vtkSmoothingTopology::SIMPLE_VERTEX ||
+           type == vtkSmoothingTopology::FIXED_VERTEX )
+      {
+        ++counts[type];
+      }
+      else if ( !this->BoundarySmoothing &&
+                type == vtkSmoothingTopology::BOUNDARY_EDGE_VERTEX )
+      {
+        type = vtkSmoothingTopology::FIXED_VERTEX;
+        ++counts[vtkSmoothingTopology::BOUNDARY_EDGE_VERTEX];
+      }
+      else if ( npts != 2 )
+      {
+        // can only smooth edges on 2-manifold surfaces
+        type = vtkSmoothingTopology::FIXED_VERTEX;
+        ++counts[vtkSmoothingTopology::FIXED_VERTEX];
+      }
+      else //check angle between edges
+      {
+        this->Points->GetPoint(neighbors[0],x1);
+        this->Points->GetPoint(ptId,x2);
+        this->Points->GetPoint(neighbors[1],x3);
+
+        for (int k=0; k<3; k++)
+        {
+          l1[k] = x2[k] - x1[k];
+          l2[k] = x3[k] - x2[k];
+        }
+        if ( vtkMath::Normalize(l1) >= 0.0 &&
+             vtkMath::Normalize(l2) >= 0.0 &&
+             vtkMath::Dot(l1,l2) < this->CosEdgeAngle )
+        {
+          type = vtkSmoothingTopology::FIXED_VERTEX;
+          ++counts[vtkSmoothingTopology::FIXED_VERTEX];
+        }
+        else
+        {
+          ++counts[type];
+        }
+      }
+    }
+  }
+};
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+vtkSmoothingTopology::vtkSmoothingTopology()
+{
+  for (int i = 0; i < 4; ++i)
+  {
+    this->NumberOfVertices[i] = 0;
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkSmoothingTopology::~vtkSmoothingTopology()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkSmoothingTopology::Build(vtkPolyData *input, double featureAngle,
+                                 double edgeAngle, int featureEdgeSmoothing,
+                                 int boundarySmoothing,
+                                 int nonManifoldSmoothing)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPoints *inPts = input->GetPoints();
+  vtkIdType npts = 0;
+  vtkIdType *pts = nullptr;
+
+  this->Types.assign(numPts, SIMPLE_VERTEX);
+  std::vector<vtkIdType> lineNeighbors;
+
+  // check vertices first. Vertices are never smoothed_--------------
+  vtkCellArray *inVerts = input->GetVerts();
+  for (inVerts->InitTraversal(); inVerts->GetNextCell(npts,pts); )
+  {
+    for (vtkIdType j=0; j<npts; j++)
+    {
+      this->Types[pts[j]] = FIXED_VERTEX;
+    }
+  }
+
+  // now check lines. Only manifold lines can be smoothed------------
+  vtkCellArray *inLines = input->GetLines();
+  if ( inLines->GetNumberOfCells() > 0 )
+  {
+    lineNeighbors.resize(2*numPts);
+  }
+  for (inLines->InitTraversal(); inLines->GetNextCell(npts,pts); )
+  {
+    for (vtkIdType j=0; j<npts; j++)
+    {
+      char &type = this->Types[pts[j]];
+      if ( type == SIMPLE_VERTEX )
+      {
+        if ( j == (npts-1) || j == 0 ) //end of line marked FIXED
+        {
+          type = FIXED_VERTEX;
+        }
+        else //is edge vertex (unless already edge vertex!)
+        {
+          type = FEATURE_EDGE_VERTEX;
+          lineNeighbors[2*pts[j]] = pts[j-1];
+          lineNeighbors[2*pts[j]+1] = pts[j+1];
+        }
+      } //if simple vertex
+
+      else if ( type == FEATURE_EDGE_VERTEX )
+      { //multiply connected, becomes fixed!
+        type = FIXED_VERTEX;
+      }
+    } //for all points in this line
+  } //for all lines
+
+  // now polygons and triangle strips-------------------------------
+  vtkCellArray *inPolys = input->GetPolys();
+  vtkCellArray *inStrips = input->GetStrips();
+  vtkSmartPointer<vtkPolyData> mesh;
+  std::vector<vtkIdType> locations;
+  std::vector<signed char> edgeTypes;
+
+  if ( inPolys->GetNumberOfCells() > 0 || inStrips->GetNumberOfCells() > 0 )
+  { //build cell structure
+    mesh = vtkSmartPointer<vtkPolyData>::New();
+    mesh->SetPoints(inPts);
+    if ( inStrips->GetNumberOfCells() > 0 )
+    { // convert data to triangles
+      vtkNew<vtkPolyData> inMesh;
+      inMesh->SetPoints(inPts);
+      inMesh->SetPolys(inPolys);
+      inMesh->SetStrips(inStrips);
+      vtkNew<vtkTriangleFilter> toTris;
+      toTris->SetInputData(inMesh.GetPointer());
+      toTris->Update();
+      mesh->SetPolys(toTris->GetOutput()->GetPolys());
+    }
+    else if ( inPolys->GetStorage() == vtkCellArray::OFFSETS32_STORAGE )
+    {
+      // copy the input cells, their storage is converted below
+      vtkNew<vtkCellArray> polys;
+      polys->DeepCopy(inPolys);
+      mesh->SetPolys(polys.GetPointer());
+    }
+    else
+    {
+      mesh->SetPolys(inPolys);
+    }
+    // The cells are accessed through pointers from several threads, which
+    // would convert 32-bit storage on first access.
+    vtkCellArray *polys = mesh->GetPolys();
+    if ( polys->GetStorage() == vtkCellArray::OFFSETS32_STORAGE )
+    {
+      polys->SetStorageToOffsets();
+    }
+    mesh->BuildLinks(); //to do neighborhood searching
+
+    // Classify the edges of the polygons, each edge once.
+    vtkIdType numPolys = polys->GetNumberOfCells();
+    locations.resize(numPolys+1);
+    vtkSmoothingPolygonSizes sizes = { mesh.GetPointer(), &locations[0] };
+    vtkSMPTools::For(0, numPolys, sizes);
+    locations[numPolys] = vtkSMPTools::ExclusiveScan(
+      locations.begin(), locations.begin() + numPolys, locations.begin(),
+      vtkIdType(0));
+    edgeTypes.resize(locations[numPolys]);
+
+    vtkSmoothingClassifyEdges classifyEdges;
+    classifyEdges.Mesh = mesh.GetPointer();
+    classifyEdges.Points = inPts;
+    classifyEdges.Locations = &locations[0];
+    classifyEdges.EdgeTypes = edgeTypes.data();
+    classifyEdges.CosFeatureAngle =
+      cos( vtkMath::RadiansFromDegrees( featureAngle) );
+    classifyEdges.FeatureEdgeSmoothing = featureEdgeSmoothing;
+    classifyEdges.NonManifoldSmoothing = nonManifoldSmoothing;
+    vtkSMPTools::For(0, numPolys, classifyEdges);
+  }//if strips or polys
+
+  // Count the neighbors of the points, then store them.
+  this->Offsets.resize(numPts+1);
+  vtkSmoothingClassifyPoints classifyPoints;
+  classifyPoints.Mesh = mesh.GetPointer();
+  classifyPoints.Points = inPts;
+  classifyPoints.Locations = locations.data();
+  classifyPoints.EdgeTypes = edgeTypes.data();
+  classifyPoints.LineNeighbors = lineNeighbors.data();
+  classifyPoints.Types = &this->Types[0];
+  classifyPoints.Offsets = &this->Offsets[0];
+  classifyPoints.Neighbors = nullptr;
+  classifyPoints.StoreNeighbors = false;
+  classifyPoints.CosEdgeAngle = cos( vtkMath::RadiansFromDegrees( edgeAngle) );
+  classifyPoints.BoundarySmoothing = boundarySmoothing;
+  vtkSMPTools::For(0, numPts, classifyPoints);
+
+  this->Offsets[numPts] = vtkSMPTools::ExclusiveScan(
+    this->Offsets.begin(), this->Offsets.begin() + numPts,
+    this->Offsets.begin(), vtkIdType(0));
+  this->Neighbors.resize(this->Offsets[numPts]);
+  classifyPoints.Neighbors = this->Neighbors.data();
+  classifyPoints.StoreNeighbors = true;
+  vtkSMPTools::For(0, numPts, classifyPoints);
+
+  for (int i = 0; i < 4; ++i)
+  {
+    this->NumberOfVertices[i] = 0;
+  }
+  for (vtkSMPThreadLocal<std::vector<vtkIdType> >::iterator it =
+         classifyPoints.Counts.begin(); it != classifyPoints.Counts.end(); ++it)
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      this->NumberOfVertices[i] += (*it)[i];
+    }
+  }
+}
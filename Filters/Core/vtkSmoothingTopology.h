@@ -0,0 +1,112 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSmoothingTopology.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkSmoothingTopology
+ * @brief   A utility class used by the mesh smoothing filters
+ *
+ * vtkSmoothingTopology performs the topological analysis shared by the
+ * smoothing filters. Each point of a polygonal mesh is classified as a
+ * simple, fixed, feature edge or boundary edge vertex, and the points it
+ * is smoothed with are stored in a compressed row layout: the neighbors of
+ * point i are GetNeighbors(i)[0, GetNumberOfNeighbors(i)). The analysis
+ * runs in parallel with vtkSMPTools and gives the same result as a serial
+ * traversal of the cells, whatever the number of threads.
+ * @sa
+ * vtkSmoothPolyDataFilter vtkWindowedSincPolyDataFilter
+*/
+
+#ifndef vtkSmoothingTopology_h
+#define vtkSmoothingTopology_h
+
+#include "vtkFiltersCoreModule.h" // For export macro
+#include "vtkType.h" // For vtkIdType
+
+#include <vector> // For member variables
+
+class vtkPolyData;
+
+class VTKFILTERSCORE_EXPORT vtkSmoothingTopology
+{
+public:
+  enum VertexType
+  {
+    SIMPLE_VERTEX = 0,
+    FIXED_VERTEX = 1,
+    FEATURE_EDGE_VERTEX = 2,
+    BOUNDARY_EDGE_VERTEX = 3
+  };
+
+  vtkSmoothingTopology();
+  ~vtkSmoothingTopology();
+
+  /**
+   * Classify the points of input. Vertices are never smoothed, only
+   * manifold lines are, and polygon edges whose polygons make an angle
+   * larger than featureAngle (when featureEdgeSmoothing is on), that are
+   * used by a single polygon, or by more than two polygons (unless
+   * nonManifoldSmoothing is on) restrict the smoothing of their points to
+   * the edges of the same kind. Edge vertices whose two edges make an angle
+   * larger than edgeAngle are fixed, as are boundary vertices when
+   * boundarySmoothing is off. Angles are in degrees.
+   */
+  void Build(vtkPolyData *input, double featureAngle, double edgeAngle,
+             int featureEdgeSmoothing, int boundarySmoothing,
+             int nonManifoldSmoothing);
+
+  /**
+   * The classification of a point, one of the VertexType values.
+   */
+  int GetType(vtkIdType ptId) const
+  {
+    return this->Types[ptId];
+  }
+
+  //@{
+  /**
+   * The points a point is smoothed with. A fixed vertex may have neighbors,
+   * which are those found by the analysis before it was fixed.
+   */
+  vtkIdType GetNumberOfNeighbors(vtkIdType ptId) const
+  {
+    return this->Offsets[ptId+1] - this->Offsets[ptId];
+  }
+  const vtkIdType *GetNeighbors(vtkIdType ptId) const
+  {
+    return this->Neighbors.data() + this->Offsets[ptId];
+  }
+  //@}
+
+  /**
+   * The number of points found of the given VertexType. Boundary vertices
+   * fixed because boundary smoothing is off are counted as boundary edge
+   * vertices.
+   */
+  vtkIdType GetNumberOfVertices(int type) const
+  {
+    return this->NumberOfVertices[type];
+  }
+
+private:
+  vtkSmoothingTopology(const vtkSmoothingTopology&) VTK_DELETE_FUNCTION;
+  vtkSmoothingTopology& operator=(const vtkSmoothingTopology&) VTK_DELETE_FUNCTION;
+
+  std::vector<char> Types;
+  std::vector<vtkIdType> Offsets;
+  std::vector<vtkIdType> Neighbors;
+  vtkIdType NumberOfVertices[4];
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSmoothingTopology.h
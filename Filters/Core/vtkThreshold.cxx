@@ -14,18 +14,25 @@
 =========================================================================*/
 #include "vtkThreshold.h"
 
-#include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkIdList.h"
+#include "vtkIdMapInverter.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMath.h"
 
 #include <algorithm>
+#include <atomic>
+#include <vector>
 
 vtkStandardNewMacro(vtkThreshold);
 
@@ -90,6 +97,176 @@ void vtkThreshold::ThresholdBetween(double lower, double upper)
   }
 }
 
+//----------------------------------------------------------------------------
+// Evaluate the criterion of the cells. A kept cell gets the size of its
+// legacy connectivity (npts+1) and its points are marked as used, the other
+// cells get 0.
+class vtkThreshold::EvaluateCells
+{
+public:
+  vtkThreshold *Self;
+  vtkDataSet *Input;
+  vtkDataArray *Scalars;
+  bool UsePointScalars;
+  vtkIdType *CellFlags;
+  vtkIdType *ConnectivitySizes;
+  std::atomic<vtkIdType> *PointFlags;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  EvaluateCells(vtkThreshold *self, vtkDataSet *input, vtkDataArray *scalars,
+                bool usePointScalars, vtkIdType *cellFlags,
+                vtkIdType *connSizes, std::atomic<vtkIdType> *pointFlags)
+    : Self(self), Input(input), Scalars(scalars),
+      UsePointScalars(usePointScalars), CellFlags(cellFlags),
+      ConnectivitySizes(connSizes), PointFlags(pointFlags)
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType i, npts;
+    const vtkIdType *pts;
+    int keepCell;
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      this->Input->GetCellPoints(cellId, npts, pts, cellPts);
+
+      if ( this->UsePointScalars )
+      {
+        if (this->Self->AllScalars)
+        {
+          keepCell = 1;
+          for ( i=0; keepCell && (i < npts); i++)
+          {
+            keepCell = this->Self->EvaluateComponents(this->Scalars, pts[i]);
+          }
+        }
+        else if (!this->Self->UseContinuousCellRange)
+        {
+          keepCell = 0;
+          for ( i=0; (!keepCell) && (i < npts); i++)
+          {
+            keepCell = this->Self->EvaluateComponents(this->Scalars, pts[i]);
+          }
+        }
+        else
+        {
+          keepCell = this->Self->EvaluateCell(this->Scalars, pts, npts);
+        }
+      }
+      else //use cell scalars
+      {
+        keepCell = this->Self->EvaluateComponents(this->Scalars, cellId);
+      }
+
+      // satisfied thresholding (also non-empty cell, i.e. not VTK_EMPTY_CELL)
+      if ( npts > 0 && keepCell )
+      {
+        this->CellFlags[cellId] = 1;
+        this->ConnectivitySizes[cellId] = npts + 1;
+        for ( i=0; i < npts; i++ )
+        {
+          this->PointFlags[pts[i]].store(1, std::memory_order_relaxed);
+        }
+      }
+      else
+      {
+        this->CellFlags[cellId] = 0;
+        this->ConnectivitySizes[cellId] = 0;
+      }
+    }
+  }
+};
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Copy the kept points and their attributes.
+struct vtkThresholdCopyPoints
+{
+  vtkDataSet *Input;
+  const vtkIdType *OldPointIds;
+  vtkPoints *NewPoints;
+  vtkPointData *InPD;
+  vtkPointData *OutPD;
+
+  vtkThresholdCopyPoints(vtkDataSet *input, const vtkIdType *oldPointIds,
+                         vtkPoints *newPoints, vtkPointData *inPD,
+                         vtkPointData *outPD)
+    : Input(input), OldPointIds(oldPointIds), NewPoints(newPoints),
+      InPD(inPD), OutPD(outPD)
+  {
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for (vtkIdType newId = ptId; newId < endPtId; ++newId)
+    {
+      this->Input->GetPoint(this->OldPointIds[newId], x);
+      this->NewPoints->SetPoint(newId, x);
+    }
+    this->OutPD->GatherData(this->InPD, this->OldPointIds + ptId, ptId,
+                            endPtId - ptId);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the kept cells, renumbering their points, and their attributes.
+struct vtkThresholdCopyCells
+{
+  vtkDataSet *Input;
+  const vtkIdType *OldCellIds;
+  const vtkIdType *PointMap;
+  const vtkIdType *Locations;
+  vtkIdType *Connectivity;
+  unsigned char *Types;
+  vtkIdType *NewLocations;
+  vtkCellData *InCD;
+  vtkCellData *OutCD;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  vtkThresholdCopyCells(vtkDataSet *input, const vtkIdType *oldCellIds,
+                        const vtkIdType *pointMap, const vtkIdType *locations,
+                        vtkIdType *connectivity, unsigned char *types,
+                        vtkIdType *newLocations, vtkCellData *inCD,
+                        vtkCellData *outCD)
+    : Input(input), OldCellIds(oldCellIds), PointMap(pointMap),
+      Locations(locations), Connectivity(connectivity), Types(types),
+      NewLocations(newLocations), InCD(inCD), OutCD(outCD)
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for (vtkIdType newId = cellId; newId < endCellId; ++newId)
+    {
+      vtkIdType oldId = this->OldCellIds[newId];
+      this->Input->GetCellPoints(oldId, npts, pts, cellPts);
+      vtkIdType loc = this->Locations[oldId];
+      vtkIdType *conn = this->Connectivity + loc;
+      *conn++ = npts;
+      for (vtkIdType i=0; i < npts; i++)
+      {
+        conn[i] = this->PointMap[pts[i]];
+      }
+      this->Types[newId] =
+        static_cast<unsigned char>(this->Input->GetCellType(oldId));
+      this->NewLocations[newId] = loc;
+    }
+    this->OutCD->GatherData(this->InCD, this->OldCellIds + cellId, cellId,
+                            endCellId - cellId);
+  }
+};
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
 int vtkThreshold::RequestData(
   vtkInformation *vtkNotUsed(request),
   vtkInformationVector **inputVector,
@@ -105,17 +282,10 @@ int vtkThreshold::RequestData(
   vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType cellId, newCellId;
-  vtkIdList *cellPts, *pointMap;
-  vtkIdList *newCellPts;
-  vtkCell *cell;
   vtkPoints *newPoints;
-  vtkIdType i, ptId, newId, numPts;
-  int numCellPts;
-  double x[3];
+  vtkIdType numPts, numCells;
   vtkPointData *pd=input->GetPointData(), *outPD=output->GetPointData();
   vtkCellData *cd=input->GetCellData(), *outCD=output->GetCellData();
-  int keepCell;
 
   vtkDebugMacro(<< "Executing threshold filter");
 
@@ -139,7 +309,7 @@ int vtkThreshold::RequestData(
   outCD->CopyAllocate(cd);
 
   numPts = input->GetNumberOfPoints();
-  output->Allocate(input->GetNumberOfCells());
+  numCells = input->GetNumberOfCells();
 
   newPoints = vtkPoints::New();
 
@@ -165,98 +335,110 @@ int vtkThreshold::RequestData(
     newPoints->SetDataType(VTK_DOUBLE);
   }
 
-  newPoints->Allocate(numPts);
-
-  pointMap = vtkIdList::New(); //maps old point ids into new
-  pointMap->SetNumberOfIds(numPts);
-  for (i=0; i < numPts; i++)
-  {
-    pointMap->SetId(i,-1);
-  }
-
-  newCellPts = vtkIdList::New();
-
   // are we using pointScalars?
   int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
   bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
 
-  // Check that the scalars of each cell satisfy the threshold criterion
-  for (cellId=0; cellId < input->GetNumberOfCells(); cellId++)
+  // Build the cells of the input, if needed, before the threads read them.
+  vtkIdList *cellPts = vtkIdList::New();
+  if ( numCells > 0 )
   {
-    cell = input->GetCell(cellId);
-    cellPts = cell->GetPointIds();
-    numCellPts = cell->GetNumberOfPoints();
+    input->GetCellPoints(0, cellPts);
+  }
 
-    if ( usePointScalars )
+  // Check that the scalars of each cell satisfy the threshold criterion.
+  // The extra entries of the maps receive the totals of the prefix sums.
+  std::vector<vtkIdType> cellMap(numCells+1);
+  std::vector<vtkIdType> locations(numCells+1);
+  std::atomic<vtkIdType> *pointFlags = new std::atomic<vtkIdType>[numPts];
+  vtkSMPTools::Fill(pointFlags, pointFlags + numPts, vtkIdType(0));
+  EvaluateCells evaluateCells(this, input, inScalars, usePointScalars,
+                              &cellMap[0], &locations[0], pointFlags);
+  vtkSMPTools::For(0, numCells, evaluateCells);
+
+  // Number the kept cells and points, and locate the kept cells in the
+  // output connectivity. pointMap maps old point ids into new.
+  vtkIdType numNewCells = vtkSMPTools::ExclusiveScan(
+    cellMap.begin(), cellMap.begin() + numCells, cellMap.begin(),
+    vtkIdType(0));
+  cellMap[numCells] = numNewCells;
+  vtkIdType connSize = vtkSMPTools::ExclusiveScan(
+    locations.begin(), locations.begin() + numCells, locations.begin(),
+    vtkIdType(0));
+  locations[numCells] = connSize;
+  std::vector<vtkIdType> pointMap(numPts+1);
+  vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(
+    pointFlags, pointFlags + numPts, pointMap.begin(), vtkIdType(0));
+  pointMap[numPts] = numNewPts;
+  delete [] pointFlags;
+
+  // The output ids of the kept cells and points, in increasing order.
+  std::vector<vtkIdType> oldCellIds(numNewCells);
+  vtkIdMapInverter::Invert(&cellMap[0], numCells, oldCellIds.data());
+  std::vector<vtkIdType> oldPointIds(numNewPts);
+  vtkIdMapInverter::Invert(&pointMap[0], numPts, oldPointIds.data());
+
+  // Copy the points and the point data.
+  newPoints->SetNumberOfPoints(numNewPts);
+  outPD->SetNumberOfTuples(numNewPts);
+  vtkThresholdCopyPoints copyPoints(input, oldPointIds.data(), newPoints,
+                                    pd, outPD);
+  vtkSMPTools::For(0, numNewPts, copyPoints);
+
+  vtkUnstructuredGrid *inputGrid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (inputGrid && inputGrid->GetFaces())
+  {
+    // special handling for polyhedron cells: their face streams are
+    // inserted one cell at a time.
+    output->Allocate(numNewCells);
+    outCD->SetNumberOfTuples(numNewCells);
+    for (vtkIdType newCellId=0; newCellId < numNewCells; newCellId++)
     {
-      if (this->AllScalars)
+      vtkIdType cellId = oldCellIds[newCellId];
+      int cellType = inputGrid->GetCellType(cellId);
+      if (cellType == VTK_POLYHEDRON)
       {
-        keepCell = 1;
-        for ( i=0; keepCell && (i < numCellPts); i++)
-        {
-          ptId = cellPts->GetId(i);
-          keepCell = this->EvaluateComponents( inScalars, ptId );
-        }
+        inputGrid->GetFaceStream(cellId, cellPts);
+        vtkUnstructuredGrid::ConvertFaceStreamPointIds(cellPts, &pointMap[0]);
       }
       else
       {
-        if(!this->UseContinuousCellRange)
-        {
-          keepCell = 0;
-          for ( i=0; (!keepCell) && (i < numCellPts); i++)
-          {
-            ptId = cellPts->GetId(i);
-            keepCell = this->EvaluateComponents( inScalars, ptId );
-          }
-        }
-        else
+        inputGrid->GetCellPoints(cellId, cellPts);
+        for (vtkIdType i=0; i < cellPts->GetNumberOfIds(); i++)
         {
-          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
+          cellPts->SetId(i, pointMap[cellPts->GetId(i)]);
         }
       }
+      output->InsertNextCell(cellType, cellPts);
     }
-    else //use cell scalars
-    {
-      keepCell = this->EvaluateComponents( inScalars, cellId );
-    }
-
-    if (  numCellPts > 0 && keepCell )
-    {
-      // satisfied thresholding (also non-empty cell, i.e. not VTK_EMPTY_CELL)
-      for (i=0; i < numCellPts; i++)
-      {
-        ptId = cellPts->GetId(i);
-        if ( (newId = pointMap->GetId(ptId)) < 0 )
-        {
-          input->GetPoint(ptId, x);
-          newId = newPoints->InsertNextPoint(x);
-          pointMap->SetId(ptId,newId);
-          outPD->CopyData(pd,ptId,newId);
-        }
-        newCellPts->InsertId(i,newId);
-      }
-      // special handling for polyhedron cells
-      if (vtkUnstructuredGrid::SafeDownCast(input) &&
-          input->GetCellType(cellId) == VTK_POLYHEDRON)
-      {
-        newCellPts->Reset();
-        vtkUnstructuredGrid::SafeDownCast(input)->
-          GetFaceStream(cellId, newCellPts);
-        vtkUnstructuredGrid::ConvertFaceStreamPointIds(
-          newCellPts, pointMap->GetPointer(0));
-      }
-      newCellId = output->InsertNextCell(cell->GetCellType(),newCellPts);
-      outCD->CopyData(cd,cellId,newCellId);
-      newCellPts->Reset();
-    } // satisfied thresholding
-  } // for all cells
+    outCD->GatherData(cd, oldCellIds.data(), 0, numNewCells);
+  }
+  else
+  {
+    // Copy the cells and the cell data.
+    vtkUnsignedCharArray *types = vtkUnsignedCharArray::New();
+    types->SetNumberOfValues(numNewCells);
+    vtkIdTypeArray *newLocations = vtkIdTypeArray::New();
+    newLocations->SetNumberOfValues(numNewCells);
+    vtkCellArray *newCells = vtkCellArray::New();
+    vtkIdType *connectivity = newCells->WritePointer(numNewCells, connSize);
+    outCD->SetNumberOfTuples(numNewCells);
+    vtkThresholdCopyCells copyCells(input, oldCellIds.data(), &pointMap[0],
+                                    &locations[0], connectivity,
+                                    types->GetPointer(0),
+                                    newLocations->GetPointer(0), cd, outCD);
+    vtkSMPTools::For(0, numNewCells, copyCells);
+    output->SetCells(types, newLocations, newCells);
+    types->Delete();
+    newLocations->Delete();
+    newCells->Delete();
+  }
 
   vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells()
                 << " number of cells.");
 
   // now clean up / update ourselves
-  pointMap->Delete();
-  newCellPts->Delete();
+  cellPts->Delete();
 
   output->SetPoints(newPoints);
   newPoints->Delete();
@@ -267,6 +449,20 @@ int vtkThreshold::RequestData(
 }
 
 int vtkThreshold::EvaluateCell( vtkDataArray *scalars,vtkIdList* cellPts, int numCellPts )
+{
+  return this->EvaluateCell(scalars, cellPts->GetPointer(0),
+                            static_cast<vtkIdType>(numCellPts));
+}
+
+int vtkThreshold::EvaluateCell( vtkDataArray *scalars, int c, vtkIdList* cellPts, int numCellPts )
+{
+  return this->EvaluateCell(scalars, c, cellPts->GetPointer(0),
+                            static_cast<vtkIdType>(numCellPts));
+}
+
+int vtkThreshold::EvaluateCell( vtkDataArray *scalars,
+                                const vtkIdType *cellPts,
+                                vtkIdType numCellPts )
 {
   int c(0);
   int numComp = scalars->GetNumberOfComponents();
@@ -295,12 +491,14 @@ int vtkThreshold::EvaluateCell( vtkDataArray *scalars,vtkIdList* cellPts, int nu
   return keepCell;
 }
 
-int vtkThreshold::EvaluateCell( vtkDataArray *scalars, int c, vtkIdList* cellPts, int numCellPts )
+int vtkThreshold::EvaluateCell( vtkDataArray *scalars, int c,
+                                const vtkIdType *cellPts,
+                                vtkIdType numCellPts )
 {
   double minScalar=DBL_MAX, maxScalar=DBL_MIN;
-  for (int i=0; i < numCellPts; i++)
+  for (vtkIdType i=0; i < numCellPts; i++)
   {
-    vtkIdType ptId = cellPts->GetId(i);
+    vtkIdType ptId = cellPts[i];
     double s = scalars->GetComponent(ptId,c);
     minScalar = std::min(s,minScalar);
     maxScalar = std::max(s,maxScalar);
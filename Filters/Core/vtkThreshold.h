@@ -30,6 +30,12 @@
  * By default only the first scalar value is used in the decision. Use the ComponentMode
  * and SelectedComponent ivars to control this behavior.
  *
+ * The cells are processed in parallel with vtkSMPTools: the criterion is
+ * evaluated for every cell first, prefix sums of the kept cells and of the
+ * points they use then give the output ids, and the points, cells and
+ * attributes are finally copied without any per-cell allocation. The output
+ * points keep their relative order in the input, and so do the cells.
+ *
  * @sa
  * vtkThresholdPoints vtkThresholdTextureCoords
 */
@@ -212,6 +218,14 @@ protected:
   int EvaluateComponents( vtkDataArray *scalars, vtkIdType id );
   int EvaluateCell( vtkDataArray *scalars, vtkIdList* cellPts, int numCellPts );
   int EvaluateCell( vtkDataArray *scalars, int c, vtkIdList* cellPts, int numCellPts );
+  int EvaluateCell( vtkDataArray *scalars, const vtkIdType *cellPts,
+                    vtkIdType numCellPts );
+  int EvaluateCell( vtkDataArray *scalars, int c, const vtkIdType *cellPts,
+                    vtkIdType numCellPts );
+
+  // Evaluates the criterion of the cells in parallel.
+  class EvaluateCells;
+
 private:
   vtkThreshold(const vtkThreshold&) VTK_DELETE_FUNCTION;
   void operator=(const vtkThreshold&) VTK_DELETE_FUNCTION;
@@ -23,9 +23,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
-#include "vtkPolygon.h"
-#include "vtkTriangle.h"
-#include "vtkTriangleFilter.h"
+#include "vtkSMPTools.h"
+#include "vtkSmoothingTopology.h"
 
 vtkStandardNewMacro(vtkWindowedSincPolyDataFilter);
 
@@ -52,17 +51,151 @@ vtkWindowedSincPolyDataFilter::vtkWindowedSincPolyDataFilter()
   this->NormalizeCoordinates = 0;
 }
 
-#define VTK_SIMPLE_VERTEX 0
-#define VTK_FIXED_VERTEX 1
-#define VTK_FEATURE_EDGE_VERTEX 2
-#define VTK_BOUNDARY_EDGE_VERTEX 3
+namespace
+{
+
+//----------------------------------------------------------------------------
+// The first iteration of the filter: x1 = x0 - 0.5 L(x0) and
+// x3 = c0 x0 + c1 x1.
+struct vtkWindowedSincFirstIteration
+{
+  const vtkSmoothingTopology *Topology;
+  const float *X0;
+  float *X1;
+  float *X3;
+  const double *C;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double x[3], deltaX[3];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkIdType npts = this->Topology->GetNumberOfNeighbors(i);
+      if ( npts > 0 )
+      {
+        // point is allowed to move
+        const vtkIdType *edges = this->Topology->GetNeighbors(i);
+        for (int k=0; k<3; k++) //use current points
+        {
+          x[k] = this->X0[3*i+k];
+        }
+        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+        // calculate the negative of the laplacian
+        for (vtkIdType j=0; j<npts; j++) //for all connected points
+        {
+          const float *y = this->X0 + 3*edges[j];
+          for (int k=0; k<3; k++)
+          {
+            deltaX[k] += (x[k] - y[k]) / npts;
+          }
+        }
+        // newPts[one] = newPts[zero] - 0.5 newPts[one]
+        for (int k=0; k<3; k++)
+        {
+          deltaX[k] = x[k] - 0.5*deltaX[k];
+          this->X1[3*i+k] = static_cast<float>(deltaX[k]);
+        }
+
+        // calculate newPts[three] = c0 newPts[zero] + c1 newPts[one]
+        for (int k=0; k < 3; k++)
+        {
+          deltaX[k] = this->C[0]*x[k] + this->C[1]*deltaX[k];
+          if (this->Topology->GetType(i) == vtkSmoothingTopology::FIXED_VERTEX)
+          {
+            this->X3[3*i+k] = this->X0[3*i+k];
+          }
+          else
+          {
+            this->X3[3*i+k] = static_cast<float>(deltaX[k]);
+          }
+        }
+      }//if can move point
+      else
+      {
+        // point is not allowed to move, just use the old point...
+        // (zero out the Laplacian)
+        for (int k=0; k<3; k++)
+        {
+          this->X1[3*i+k] = 0.0;
+          this->X3[3*i+k] = this->X0[3*i+k];
+        }
+      }
+    }//for all points
+  }
+};
 
-// Special structure for marking vertices
-typedef struct _vtkMeshVertex
+//----------------------------------------------------------------------------
+// The following iterations: x2 = (x1 - x0) + (x1 - L(x1)) and
+// x3 = x3 + cj x2. Only x2 and x3 are written, the Laplacian of the points
+// that cannot move is zero in x1.
+struct vtkWindowedSincIteration
 {
-  char      type;
-  vtkIdList *edges; // connected edges (list of connected point ids)
-} vtkMeshVertex, *vtkMeshVertexPtr;
+  const vtkSmoothingTopology *Topology;
+  const float *X0;
+  const float *X1;
+  float *X2;
+  float *X3;
+  double C;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double p_x0[3], p_x1[3], deltaX[3];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkIdType npts = this->Topology->GetNumberOfNeighbors(i);
+      if ( npts > 0 )
+      {
+        // point is allowed to move
+        const vtkIdType *edges = this->Topology->GetNeighbors(i);
+        for (int k=0; k<3; k++) //use current points
+        {
+          p_x0[k] = this->X0[3*i+k];
+          p_x1[k] = this->X1[3*i+k];
+        }
+
+        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+        // calculate the negative laplacian of x1
+        for (vtkIdType j=0; j<npts; j++)
+        {
+          const float *y = this->X1 + 3*edges[j];
+          for (int k=0; k<3; k++)
+          {
+            deltaX[k] += (p_x1[k] - y[k]) / npts;
+          }
+        }//for all connected points
+
+        // Taubin:  x2 = (x1 - x0) + (x1 - x2)
+        for (int k=0; k<3; k++)
+        {
+          deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
+          this->X2[3*i+k] = static_cast<float>(deltaX[k]);
+        }
+
+        // smooth the vertex (x3 = x3 + cj x2)
+        if (this->Topology->GetType(i) != vtkSmoothingTopology::FIXED_VERTEX)
+        {
+          for (int k=0;k<3;k++)
+          {
+            this->X3[3*i+k] = static_cast<float>(
+              this->X3[3*i+k] + this->C * deltaX[k]);
+          }
+        }
+      }//if can move point
+      else
+      {
+        // point is not allowed to move, zero out the Laplacian
+        for (int k=0; k<3; k++)
+        {
+          this->X2[3*i+k] = 0.0;
+        }
+      }
+    }//for all points
+  }
+};
+
+} // end anon namespace
 
 int vtkWindowedSincPolyDataFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -79,26 +212,15 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType numPts, numCells, numPolys, numStrips, i;
-  int j, k;
-  vtkIdType npts = 0;
-  vtkIdType *pts = nullptr;
-  vtkIdType p1, p2;
-  double x[3], y[3], deltaX[3], xNew[3];
-  double x1[3], x2[3], x3[3], l1[3], l2[3];
-  double CosFeatureAngle; //Cosine of angle between adjacent polys
-  double CosEdgeAngle; // Cosine of angle between adjacent edges
+  vtkIdType numPts, numCells, i;
+  int j;
+  double x1[3], x2[3], x3[3];
   int iterationNumber;
-  vtkIdType numSimple=0, numBEdges=0, numFixed=0, numFEdges=0;
-  vtkPolyData *inMesh = nullptr, *Mesh;
   vtkPoints *inPts;
-  vtkTriangleFilter *toTris=nullptr;
-  vtkCellArray *inVerts, *inLines, *inPolys, *inStrips;
   vtkPoints *newPts[4];
-  vtkMeshVertexPtr Verts;
 
   // variables specific to windowed sinc interpolation
-  double theta_pb, k_pb, sigma, p_x0[3], p_x1[3], p_x3[3];
+  double theta_pb, k_pb, sigma;
   double *w, *c, *cprime;
   int zero, one, two, three;
 
@@ -113,9 +235,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     return 1;
   }
 
-  CosFeatureAngle = cos( vtkMath::RadiansFromDegrees( this->FeatureAngle) );
-  CosEdgeAngle    = cos( vtkMath::RadiansFromDegrees( this->EdgeAngle) );
-
   vtkDebugMacro(<<"Smoothing " << numPts << " vertices, " << numCells
                << " cells with:\n"
                << "\tIterations= " << this->NumberOfIterations << "\n"
@@ -149,285 +268,23 @@ int vtkWindowedSincPolyDataFilter::RequestData(
 // using a subset of the attached vertices.
 //
   vtkDebugMacro(<<"Analyzing topology...");
-  Verts = new vtkMeshVertex[numPts];
-  for (i=0; i<numPts; i++)
-  {
-    Verts[i].type = VTK_SIMPLE_VERTEX; //can smooth
-    Verts[i].edges = nullptr;
-  }
-
   inPts = input->GetPoints();
 
-  // check vertices first. Vertices are never smoothed_--------------
-  for (inVerts=input->GetVerts(), inVerts->InitTraversal();
-  inVerts->GetNextCell(npts,pts); )
-  {
-    for (j=0; j<npts; j++)
-    {
-      Verts[pts[j]].type = VTK_FIXED_VERTEX;
-    }
-  }
-
-  this->UpdateProgress(0.10);
-
-  // now check lines. Only manifold lines can be smoothed------------
-  for (inLines=input->GetLines(), inLines->InitTraversal();
-  inLines->GetNextCell(npts,pts); )
-  {
-    for (j=0; j<npts; j++)
-    {
-      if ( Verts[pts[j]].type == VTK_SIMPLE_VERTEX )
-      {
-        if ( j == (npts-1) ) //end-of-line marked FIXED
-        {
-          Verts[pts[j]].type = VTK_FIXED_VERTEX;
-        }
-        else if ( j == 0 ) //beginning-of-line marked FIXED
-        {
-          Verts[pts[0]].type = VTK_FIXED_VERTEX;
-          inPts->GetPoint(pts[0],x2);
-          inPts->GetPoint(pts[1],x3);
-        }
-        else //is edge vertex (unless already edge vertex!)
-        {
-          Verts[pts[j]].type = VTK_FEATURE_EDGE_VERTEX;
-          Verts[pts[j]].edges = vtkIdList::New();
-          Verts[pts[j]].edges->SetNumberOfIds(2);
-          //Verts[pts[j]].edges = new vtkIdList(2,2);
-          Verts[pts[j]].edges->SetId(0,pts[j-1]);
-          Verts[pts[j]].edges->SetId(1,pts[j+1]);
-        }
-      } //if simple vertex
-
-      else if ( Verts[pts[j]].type == VTK_FEATURE_EDGE_VERTEX )
-      { //multiply connected, becomes fixed!
-        Verts[pts[j]].type = VTK_FIXED_VERTEX;
-        Verts[pts[j]].edges->Delete();
-        Verts[pts[j]].edges = nullptr;
-      }
-
-    } //for all points in this line
-  } //for all lines
-
-  this->UpdateProgress(0.25);
-
-  // now polygons and triangle strips-------------------------------
-  inPolys=input->GetPolys();
-  numPolys = inPolys->GetNumberOfCells();
-  inStrips=input->GetStrips();
-  numStrips = inStrips->GetNumberOfCells();
-
-  if ( numPolys > 0 || numStrips > 0 )
-  { //build cell structure
-    vtkCellArray *polys;
-    vtkIdType cellId;
-    int numNei, nei, edge;
-    vtkIdType numNeiPts;
-    vtkIdType *neiPts;
-    double normal[3], neiNormal[3];
-    vtkIdList *neighbors;
-
-    inMesh = vtkPolyData::New();
-    inMesh->SetPoints(inPts);
-    inMesh->SetPolys(inPolys);
-    Mesh = inMesh;
-    neighbors = vtkIdList::New();
-    neighbors->Allocate(VTK_CELL_SIZE);
-
-    if ( (numStrips = inStrips->GetNumberOfCells()) > 0 )
-    { // convert data to triangles
-      inMesh->SetStrips(inStrips);
-      toTris = vtkTriangleFilter::New();
-      toTris->SetInputData(inMesh);
-      toTris->Update();
-      Mesh = toTris->GetOutput();
-    }
-
-    Mesh->BuildLinks(); //to do neighborhood searching
-    polys = Mesh->GetPolys();
-
-    for (cellId=0, polys->InitTraversal(); polys->GetNextCell(npts,pts);
-         cellId++)
-    {
-      for (i=0; i < npts; i++)
-      {
-        p1 = pts[i];
-        p2 = pts[(i+1)%npts];
-
-        if ( Verts[p1].edges == nullptr )
-        {
-          Verts[p1].edges = vtkIdList::New();
-          Verts[p1].edges->Allocate(16,6);
-          // Verts[p1].edges = new vtkIdList(6,6);
-        }
-        if ( Verts[p2].edges == nullptr )
-        {
-          Verts[p2].edges = vtkIdList::New();
-          Verts[p2].edges->Allocate(16,6);
-          // Verts[p2].edges = new vtkIdList(6,6);
-        }
-
-        Mesh->GetCellEdgeNeighbors(cellId,p1,p2,neighbors);
-        numNei = neighbors->GetNumberOfIds();
-
-        edge = VTK_SIMPLE_VERTEX;
-        if ( numNei == 0 )
-        {
-          edge = VTK_BOUNDARY_EDGE_VERTEX;
-        }
-
-        else if ( numNei >= 2 )
-        {
-          // non-manifold case, check nonmanifold smoothing state
-          if (!this->NonManifoldSmoothing)
-          {
-            // check to make sure that this edge hasn't been marked already
-            for (j=0; j < numNei; j++)
-            {
-              if ( neighbors->GetId(j) < cellId )
-              {
-                break;
-              }
-            }
-            if ( j >= numNei )
-            {
-              edge = VTK_FEATURE_EDGE_VERTEX;
-            }
-          }
-        }
-
-        else if ( numNei == 1 && (nei=neighbors->GetId(0)) > cellId )
-        {
-          if (this->FeatureEdgeSmoothing)
-          {
-            vtkPolygon::ComputeNormal(inPts,npts,pts,normal);
-            Mesh->GetCellPoints(nei,numNeiPts,neiPts);
-            vtkPolygon::ComputeNormal(inPts,numNeiPts,neiPts,neiNormal);
-
-            if ( vtkMath::Dot(normal,neiNormal) <= CosFeatureAngle )
-            {
-              edge = VTK_FEATURE_EDGE_VERTEX;
-            }
-          }
-        }
-        else // a visited edge; skip rest of analysis
-        {
-          continue;
-        }
-
-        if ( edge && Verts[p1].type == VTK_SIMPLE_VERTEX )
-        {
-          Verts[p1].edges->Reset();
-          Verts[p1].edges->InsertNextId(p2);
-          Verts[p1].type = edge;
-        }
-        else if ( (edge && Verts[p1].type == VTK_BOUNDARY_EDGE_VERTEX) ||
-        (edge && Verts[p1].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p1].type == VTK_SIMPLE_VERTEX ) )
-        {
-          Verts[p1].edges->InsertNextId(p2);
-          if ( Verts[p1].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
-          {
-            Verts[p1].type = VTK_BOUNDARY_EDGE_VERTEX;
-          }
-        }
-
-        if ( edge && Verts[p2].type == VTK_SIMPLE_VERTEX )
-        {
-          Verts[p2].edges->Reset();
-          Verts[p2].edges->InsertNextId(p1);
-          Verts[p2].type = edge;
-        }
-        else if ( (edge && Verts[p2].type == VTK_BOUNDARY_EDGE_VERTEX ) ||
-        (edge && Verts[p2].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p2].type == VTK_SIMPLE_VERTEX ) )
-        {
-          Verts[p2].edges->InsertNextId(p1);
-          if ( Verts[p2].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
-          {
-            Verts[p2].type = VTK_BOUNDARY_EDGE_VERTEX;
-          }
-        }
-      }
-    }
-
-    //    delete inMesh; // delete this later, windowed sinc smoothing needs it
-    if (toTris)
-    {
-      toTris->Delete();
-    }
-    neighbors->Delete();
-  }//if strips or polys
-
+  vtkSmoothingTopology topology;
+  topology.Build(input, this->FeatureAngle, this->EdgeAngle,
+                 this->FeatureEdgeSmoothing, this->BoundarySmoothing,
+                 this->NonManifoldSmoothing);
   this->UpdateProgress(0.50);
 
-  //post-process edge vertices to make sure we can smooth them
-  for (i=0; i<numPts; i++)
-  {
-    if ( Verts[i].type == VTK_SIMPLE_VERTEX )
-    {
-      numSimple++;
-    }
-
-    else if ( Verts[i].type == VTK_FIXED_VERTEX )
-    {
-      numFixed++;
-    }
-
-    else if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX ||
-    Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
-    { //see how many edges; if two, what the angle is
-
-      if ( !this->BoundarySmoothing &&
-      Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
-      {
-        Verts[i].type = VTK_FIXED_VERTEX;
-        numBEdges++;
-      }
-
-      else if ( (npts = Verts[i].edges->GetNumberOfIds()) != 2 )
-      {
-        // can only smooth edges on 2-manifold surfaces
-        Verts[i].type = VTK_FIXED_VERTEX;
-        numFixed++;
-      }
-
-      else //check angle between edges
-      {
-        inPts->GetPoint(Verts[i].edges->GetId(0),x1);
-        inPts->GetPoint(i,x2);
-        inPts->GetPoint(Verts[i].edges->GetId(1),x3);
-
-        for (k=0; k<3; k++)
-        {
-          l1[k] = x2[k] - x1[k];
-          l2[k] = x3[k] - x2[k];
-        }
-        if ((vtkMath::Normalize(l1) >= 0.0) && (vtkMath::Normalize(l2) >= 0.0)
-            && (vtkMath::Dot(l1,l2) < CosEdgeAngle))
-        {
-          numFixed++;
-          Verts[i].type = VTK_FIXED_VERTEX;
-        }
-        else
-        {
-          if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX )
-          {
-            numFEdges++;
-          }
-          else
-          {
-            numBEdges++;
-          }
-        }
-      }//if along edge
-    }//if edge vertex
-  }//for all points
-
-  vtkDebugMacro(<<"Found\n\t" << numSimple << " simple vertices\n\t"
-                << numFEdges << " feature edge vertices\n\t"
-                << numBEdges << " boundary edge vertices\n\t"
-                << numFixed << " fixed vertices\n\t");
+  vtkDebugMacro(<<"Found\n\t"
+    << topology.GetNumberOfVertices(vtkSmoothingTopology::SIMPLE_VERTEX)
+    << " simple vertices\n\t"
+    << topology.GetNumberOfVertices(vtkSmoothingTopology::FEATURE_EDGE_VERTEX)
+    << " feature edge vertices\n\t"
+    << topology.GetNumberOfVertices(vtkSmoothingTopology::BOUNDARY_EDGE_VERTEX)
+    << " boundary edge vertices\n\t"
+    << topology.GetNumberOfVertices(vtkSmoothingTopology::FIXED_VERTEX)
+    << " fixed vertices\n\t");
 //
 // Perform Windowed Sinc function interpolation
 //
@@ -490,9 +347,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   c = new double[this->NumberOfIterations+1];
   cprime = new double[this->NumberOfIterations+1];
 
-  double zerovector[3];
-  zerovector[0] = zerovector[1] = zerovector[2] = 0.0;
-
   //
   // Calculate the weights and the Chebychev coefficients c.
   //
@@ -579,53 +433,13 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   }
 
   // first iteration
-  for (i=0; i<numPts; i++)
-  {
-    if ( Verts[i].edges != nullptr &&
-         (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-    {
-      // point is allowed to move
-      newPts[zero]->GetPoint(i, x); //use current points
-      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-
-      // calculate the negative of the laplacian
-      for (j=0; j<npts; j++) //for all connected points
-      {
-        newPts[zero]->GetPoint(Verts[i].edges->GetId(j), y);
-        for (k=0; k<3; k++)
-        {
-          deltaX[k] += (x[k] - y[k]) / npts;
-        }
-      }
-      // newPts[one] = newPts[zero] - 0.5 newPts[one]
-      for (k=0; k<3; k++)
-      {
-        deltaX[k] = x[k] - 0.5*deltaX[k];
-      }
-      newPts[one]->SetPoint(i, deltaX);
-
-      // calculate newPts[three] = c0 newPts[zero] + c1 newPts[one]
-      for (k=0; k < 3; k++)
-      {
-        deltaX[k] = c[0]*x[k] + c[1]*deltaX[k];
-      }
-      if (Verts[i].type == VTK_FIXED_VERTEX)
-      {
-        newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-      }
-      else
-      {
-        newPts[three]->SetPoint(i, deltaX);
-      }
-    }//if can move point
-    else
-    {
-      // point is not allowed to move, just use the old point...
-      // (zero out the Laplacian)
-      newPts[one]->SetPoint(i, zerovector);
-      newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-    }
-  }//for all points
+  vtkWindowedSincFirstIteration firstIteration;
+  firstIteration.Topology = &topology;
+  firstIteration.X0 = static_cast<float*>(newPts[zero]->GetVoidPointer(0));
+  firstIteration.X1 = static_cast<float*>(newPts[one]->GetVoidPointer(0));
+  firstIteration.X3 = static_cast<float*>(newPts[three]->GetVoidPointer(0));
+  firstIteration.C = c;
+  vtkSMPTools::For(0, numPts, firstIteration);
 
   // for the rest of the iterations
   for ( iterationNumber=2;
@@ -641,53 +455,14 @@ int vtkWindowedSincPolyDataFilter::RequestData(
       }
     }
 
-    for (i=0; i<numPts; i++)
-    {
-      if ( Verts[i].edges != nullptr &&
-           (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-      {
-        // point is allowed to move
-        newPts[zero]->GetPoint(i, p_x0); //use current points
-        newPts[one]->GetPoint(i, p_x1);
-
-        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-
-        // calculate the negative laplacian of x1
-        for (j=0; j<npts; j++)
-        {
-          newPts[one]->GetPoint(Verts[i].edges->GetId(j), y);
-          for (k=0; k<3; k++)
-          {
-            deltaX[k] += (p_x1[k] - y[k]) / npts;
-          }
-        }//for all connected points
-
-        // Taubin:  x2 = (x1 - x0) + (x1 - x2)
-        for (k=0; k<3; k++)
-        {
-          deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
-        }
-        newPts[two]->SetPoint(i, deltaX);
-
-        // smooth the vertex (x3 = x3 + cj x2)
-        newPts[three]->GetPoint(i, p_x3);
-        for (k=0;k<3;k++)
-        {
-          xNew[k] = p_x3[k] + c[iterationNumber] * deltaX[k];
-        }
-        if (Verts[i].type != VTK_FIXED_VERTEX)
-        {
-          newPts[three]->SetPoint(i,xNew);
-        }
-      }//if can move point
-      else
-      {
-        // point is not allowed to move, just use the old point...
-        // (zero out the Laplacian)
-        newPts[one]->SetPoint(i, zerovector);
-        newPts[two]->SetPoint(i, zerovector);
-      }
-    }//for all points
+    vtkWindowedSincIteration iteration;
+    iteration.Topology = &topology;
+    iteration.X0 = static_cast<float*>(newPts[zero]->GetVoidPointer(0));
+    iteration.X1 = static_cast<float*>(newPts[one]->GetVoidPointer(0));
+    iteration.X2 = static_cast<float*>(newPts[two]->GetVoidPointer(0));
+    iteration.X3 = static_cast<float*>(newPts[three]->GetVoidPointer(0));
+    iteration.C = c[iterationNumber];
+    vtkSMPTools::For(0, numPts, iteration);
 
     // update the pointers. three is always three. all other pointers
     // shift by one and wrap.
@@ -779,16 +554,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   output->SetPolys(input->GetPolys());
   output->SetStrips(input->GetStrips());
 
-  // finally delete the constructed (local) mesh
-  inMesh->Delete();
-
-  //free up connectivity storage
-  for (i=0; i<numPts; i++)
-  {
-    if ( Verts[i].edges != nullptr ) {Verts[i].edges->Delete();}
-  }
-  delete [] Verts;
-
   return 1;
 }
 
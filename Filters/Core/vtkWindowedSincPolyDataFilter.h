@@ -119,6 +119,10 @@
  * vertices, this limits all the frequency modes in a polyhedral mesh to
  * between 0 and 2.)
  *
+ * The topological analysis and the smoothing passes run in parallel with
+ * vtkSMPTools. Each pass only reads the points computed by the previous
+ * ones, so the output does not depend on the number of threads.
+ *
  * There are two instance variables that control the generation of error
  * data. If the ivar GenerateErrorScalars is on, then a scalar value indicating
  * the distance of each vertex from its original position is computed. If the
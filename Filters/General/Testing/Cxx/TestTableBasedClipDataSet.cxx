@@ -0,0 +1,147 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTableBasedClipDataSet.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkTableBasedClipDataSet keeps the expected side of the clip
+// surface, and gives the same output, points and cells in the same order,
+// whatever the number of threads, for image data, structured grid and
+// unstructured grid inputs.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkImageDataToPointSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointDataToCellData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphere.h"
+#include "vtkTableBasedClipDataSet.h"
+#include "vtkTestDataSetComparison.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+
+// The value of the clip at a point of the output: the interpolated scalars,
+// or the distance to the origin for the sphere.
+double ClipValue(vtkDataSet *output, vtkIdType ptId, bool sphere)
+{
+  if (sphere)
+  {
+    double x[3];
+    output->GetPoint(ptId, x);
+    return std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+  }
+  return output->GetPointData()->GetArray("RTData")->GetTuple1(ptId);
+}
+
+// Check that the clip gives the same outputs with one and several threads,
+// and that the kept points are on the expected side of the clip value, the
+// others on the clipped output.
+bool CheckOutputs(vtkTableBasedClipDataSet *clip, double value, bool sphere)
+{
+  if (!vtkTest::SameThreadedOutputs(clip, 4, 0) ||
+      !vtkTest::SameThreadedOutputs(clip, 4, 1))
+  {
+    cerr << "The outputs depend on the number of threads\n";
+    return false;
+  }
+
+  // The scalars are kept above the value, the sphere inside its radius.
+  const double tolerance = 1.0e-3 * value;
+  const double sign = sphere ? -1.0 : 1.0;
+  vtkDataSet *outputs[2] = { clip->GetOutput(), clip->GetClippedOutput() };
+  for (int i = 0; i < 2; ++i)
+  {
+    if (outputs[i]->GetNumberOfCells() == 0)
+    {
+      cerr << "Output " << i << " is empty\n";
+      return false;
+    }
+    for (vtkIdType ptId = 0; ptId < outputs[i]->GetNumberOfPoints(); ++ptId)
+    {
+      double d = sign * (ClipValue(outputs[i], ptId, sphere) - value);
+      if ((i == 0 && d < -tolerance) || (i == 1 && d > tolerance))
+      {
+        cerr << "Point " << ptId << " of output " << i
+             << " is on the wrong side of the clip\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestTableBasedClipDataSet(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-30, 30, -30, 30, -30, 30);
+  vtkNew<vtkPointDataToCellData> cellData;
+  cellData->SetInputConnection(source->GetOutputPort());
+  cellData->PassPointDataOn();
+
+  vtkNew<vtkImageDataToPointSet> structuredGrid;
+  structuredGrid->SetInputConnection(cellData->GetOutputPort());
+  vtkNew<vtkAppendFilter> hexahedra;
+  hexahedra->AddInputConnection(cellData->GetOutputPort());
+  vtkNew<vtkDataSetTriangleFilter> tetrahedra;
+  tetrahedra->SetInputConnection(cellData->GetOutputPort());
+
+  const char *names[4] = { "image data", "structured grid", "hexahedra",
+                           "tetrahedra" };
+  vtkAlgorithmOutput *inputs[4] = { cellData->GetOutputPort(),
+                                    structuredGrid->GetOutputPort(),
+                                    hexahedra->GetOutputPort(),
+                                    tetrahedra->GetOutputPort() };
+
+  vtkNew<vtkSphere> sphere;
+  sphere->SetRadius(20.0);
+
+  int errors = 0;
+  for (int i = 0; i < 4; ++i)
+  {
+    vtkNew<vtkTableBasedClipDataSet> clip;
+    clip->SetInputConnection(inputs[i]);
+    clip->GenerateClippedOutputOn();
+    clip->SetValue(150.0);
+    clip->SetInputArrayToProcess(0, 0, 0,
+      vtkDataObject::FIELD_ASSOCIATION_POINTS, "RTData");
+    if (!CheckOutputs(clip.GetPointer(), 150.0, false))
+    {
+      cerr << "Clip of " << names[i] << " by scalars failed\n";
+      ++errors;
+    }
+
+    clip->SetClipFunction(sphere.GetPointer());
+    clip->SetValue(0.0);
+    clip->InsideOutOn();
+    if (!CheckOutputs(clip.GetPointer(), 20.0, true))
+    {
+      cerr << "Clip of " << names[i] << " by a sphere failed\n";
+      ++errors;
+    }
+  }
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,179 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TimeCellLocators.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compares the build, line intersection and closest point times of the cell
+// locators on a triangulated surface.
+
+#include "vtkBVHCellLocator.h"
+#include "vtkCellArray.h"
+#include "vtkCellLocator.h"
+#include "vtkCellTreeLocator.h"
+#include "vtkGenericCell.h"
+#include "vtkMath.h"
+#include "vtkModifiedBSPTree.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkTimerLog.h"
+
+#include <cmath>
+
+int TimeCellLocators(int , char *[])
+{
+  const int res = 200;
+  const int nLines = 10000;
+  const int nQ = 2000;
+  const int numLocators = 5;
+
+  // A bumpy surface
+  vtkPoints* points = vtkPoints::New();
+  vtkCellArray* tris = vtkCellArray::New();
+  for (int j=0; j <= res; ++j)
+  {
+    for (int i=0; i <= res; ++i)
+    {
+      double x = static_cast<double>(i) / res;
+      double y = static_cast<double>(j) / res;
+      points->InsertNextPoint(x, y, 0.1*sin(6.0*x)*cos(4.0*y));
+    }
+  }
+  for (int j=0; j < res; ++j)
+  {
+    for (int i=0; i < res; ++i)
+    {
+      vtkIdType p0 = i + j*(res+1);
+      vtkIdType tri0[3] = { p0, p0+1, p0+res+2 };
+      vtkIdType tri1[3] = { p0, p0+res+2, p0+res+1 };
+      tris->InsertNextCell(3, tri0);
+      tris->InsertNextCell(3, tri1);
+    }
+  }
+  vtkPolyData* polydata = vtkPolyData::New();
+  polydata->SetPoints(points);
+  polydata->SetPolys(tris);
+
+  cout << "\nTiming for " << polydata->GetNumberOfCells() << " cells, "
+       << nLines << " lines, " << nQ << " closest point queries\n";
+
+  // Oblique lines through the surface, and query points around it
+  vtkMath::RandomSeed(314159);
+  double (*lines)[6] = new double [nLines][6];
+  for (int i=0; i < nLines; ++i)
+  {
+    lines[i][0] = vtkMath::Random(-0.1, 1.1);
+    lines[i][1] = vtkMath::Random(-0.1, 1.1);
+    lines[i][2] = -1.0;
+    lines[i][3] = vtkMath::Random(-0.1, 1.1);
+    lines[i][4] = vtkMath::Random(-0.1, 1.1);
+    lines[i][5] = 1.0;
+  }
+  double (*qPoints)[3] = new double [nQ][3];
+  for (int i=0; i < nQ; ++i)
+  {
+    qPoints[i][0] = vtkMath::Random(-0.2, 1.2);
+    qPoints[i][1] = vtkMath::Random(-0.2, 1.2);
+    qPoints[i][2] = vtkMath::Random(-0.3, 0.3);
+  }
+
+  const char *names[numLocators] = { "Uniform", "Static", "Cell Tree",
+                                     "Modified BSP", "BVH" };
+  double buildTime[numLocators], lineTime[numLocators], cpTime[numLocators];
+  int hits[numLocators];
+
+  vtkTimerLog* timer = vtkTimerLog::New();
+  vtkGenericCell *cell = vtkGenericCell::New();
+  for (int l=0; l < numLocators; ++l)
+  {
+    vtkAbstractCellLocator *locator;
+    switch (l)
+    {
+      case 0: locator = vtkCellLocator::New(); break;
+      case 1: locator = vtkStaticCellLocator::New(); break;
+      case 2: locator = vtkCellTreeLocator::New(); break;
+      case 3: locator = vtkModifiedBSPTree::New(); break;
+      default: locator = vtkBVHCellLocator::New(); break;
+    }
+    locator->SetDataSet(polydata);
+    locator->AutomaticOn();
+    timer->StartTimer();
+    locator->BuildLocator();
+    timer->StopTimer();
+    buildTime[l] = timer->GetElapsedTime();
+
+    double t, x[3], pcoords[3];
+    int subId;
+    vtkIdType cellId;
+    hits[l] = 0;
+    timer->StartTimer();
+    for (int i=0; i < nLines; ++i)
+    {
+      hits[l] += locator->IntersectWithLine(lines[i], lines[i]+3, 0.0001, t,
+                                            x, pcoords, subId, cellId, cell);
+    }
+    timer->StopTimer();
+    lineTime[l] = timer->GetElapsedTime();
+
+    // Only some of the locators support closest point queries
+    cpTime[l] = -1.0;
+    if ( l == 0 || l == numLocators-1 )
+    {
+      double closest[3], dist2;
+      timer->StartTimer();
+      for (int i=0; i < nQ; ++i)
+      {
+        locator->FindClosestPoint(qPoints[i], closest, cell, cellId, subId,
+                                  dist2);
+      }
+      timer->StopTimer();
+      cpTime[l] = timer->GetElapsedTime();
+    }
+    locator->Delete();
+  }
+
+  //---------------------------------------------------------------------------
+  // Print out the statistics
+  cout << "Build tree\n";
+  for (int l=0; l < numLocators; ++l)
+  {
+    cout << "\t" << names[l] << ": " << buildTime[l] << "\n";
+  }
+
+  cout << "Line intersections\n";
+  for (int l=0; l < numLocators; ++l)
+  {
+    cout << "\t" << names[l] << ": " << lineTime[l] << " (" << hits[l]
+         << " hits)\n";
+  }
+
+  cout << "Closest point queries\n";
+  for (int l=0; l < numLocators; ++l)
+  {
+    if ( cpTime[l] >= 0.0 )
+    {
+      cout << "\t" << names[l] << ": " << cpTime[l] << "\n";
+    }
+  }
+
+  timer->Delete();
+  cell->Delete();
+  points->Delete();
+  tris->Delete();
+  polydata->Delete();
+  delete [] lines;
+  delete [] qPoints;
+
+  // Always return success, although the test infrastructure should catch
+  // excessive execution times.
+  return 0;
+}
@@ -57,6 +57,7 @@
 #include "vtkRectilinearGrid.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkGenericCell.h"
+#include "vtkSMPTools.h"
 
 #include "vtkTableBasedClipCases.h"
 
@@ -467,6 +468,7 @@ class vtkTableBasedClipperShapeList
     int            GetTotalNumberOfShapes() const;
     int            GetNumberOfLists() const;
     int            GetList(int, const int *& ) const;
+    void           AddShape( const int * );
   protected:
     int         ** list;
     int            currentList;
@@ -633,6 +635,8 @@ class  vtkTableBasedClipperVolumeFromVolume :
     void     AddVertex(int z, int v0)
              { this->vertices.AddVertex( z, v0 ); }
 
+    void     Append( const vtkTableBasedClipperVolumeFromVolume & );
+
   protected:
     vtkTableBasedClipperCentroidPointList centroid_list;
     vtkTableBasedClipperHexList     hexes;
@@ -829,6 +833,43 @@ int  vtkTableBasedClipperShapeList::GetTotalNumberOfShapes() const
   return numFullLists * shapesPerList + numExtra;
 }
 
+void vtkTableBasedClipperShapeList::AddShape( const int * shape )
+{
+  if ( currentShape >= shapesPerList )
+  {
+    if (  ( currentList + 1 )  >=  listSize  )
+    {
+      int ** tmpList = new int * [ 2 * listSize ];
+
+      for ( int i = 0; i < listSize; i ++ )
+      {
+        tmpList[i] = list[i];
+      }
+
+      for ( int i = listSize; i < listSize * 2; i ++ )
+      {
+        tmpList[i] = nullptr;
+      }
+
+      listSize *= 2;
+      delete [] list;
+      list = tmpList;
+    }
+
+    currentList ++;
+    list[ currentList ] = new int[  ( shapeSize + 1 ) * shapesPerList  ];
+    currentShape = 0;
+  }
+
+  // The cell id followed by the point ids.
+  int * dest = list[ currentList ] + ( shapeSize + 1 ) * currentShape;
+  for ( int i = 0; i <= shapeSize; i ++ )
+  {
+    dest[i] = shape[i];
+  }
+  currentShape ++;
+}
+
 vtkTableBasedClipperHexList::vtkTableBasedClipperHexList()
     : vtkTableBasedClipperShapeList( 8 )
 {
@@ -1199,6 +1240,77 @@ void vtkTableBasedClipperVertexList::AddVertex( int cellId, int v1 )
   currentShape ++;
 }
 
+// Append the points and shapes of another volume, built from the next cells
+// of the same input. The edge points already known keep their ids, so that
+// appending the volumes of consecutive ranges of cells in order gives the
+// same points and shapes as adding all the cells to a single volume.
+void vtkTableBasedClipperVolumeFromVolume::
+     Append( const vtkTableBasedClipperVolumeFromVolume & other )
+{
+  int   i, j, k, l;
+
+  // The ids of the edge points of the other volume in this one.
+  std::vector< int > edgeIds( other.pt_list.GetTotalNumberOfPoints() );
+  int   n = 0;
+  int   nLists = other.pt_list.GetNumberOfLists();
+  for ( i = 0; i < nLists; i ++ )
+  {
+    const TableBasedClipperPointEntry * pe_list = nullptr;
+    int nPts = other.pt_list.GetList( i, pe_list );
+    for ( j = 0; j < nPts; j ++ )
+    {
+      edgeIds[ n ++ ] = AddPoint( pe_list[j].ptIds[0], pe_list[j].ptIds[1],
+                                  pe_list[j].percent );
+    }
+  }
+
+  // The centroid points only refer to points defined before them.
+  std::vector< int > centroidIds
+    ( other.centroid_list.GetTotalNumberOfPoints() );
+  n = 0;
+  nLists = other.centroid_list.GetNumberOfLists();
+  for ( i = 0; i < nLists; i ++ )
+  {
+    const TableBasedClipperCentroidPointEntry * ce_list = nullptr;
+    int nPts = other.centroid_list.GetList( i, ce_list );
+    for ( j = 0; j < nPts; j ++ )
+    {
+      int ptIds[8];
+      for ( k = 0; k < ce_list[j].nPts; k ++ )
+      {
+        int pt = ce_list[j].ptIds[k];
+        ptIds[k] = ( pt < 0 ? centroidIds[ -1 - pt ] :
+                     pt >= numPrevPts ? edgeIds[ pt - numPrevPts ] : pt );
+      }
+      centroidIds[ n ++ ] = AddCentroidPoint( ce_list[j].nPts, ptIds );
+    }
+  }
+
+  for ( i = 0; i < nshapes; i ++ )
+  {
+    int shapesize = shapes[i]->GetShapeSize();
+    nLists = other.shapes[i]->GetNumberOfLists();
+    for ( j = 0; j < nLists; j ++ )
+    {
+      const int * list;
+      int listSize = other.shapes[i]->GetList( j, list );
+      for ( k = 0; k < listSize; k ++ )
+      {
+        int shape[9];
+        shape[0] = list[0];
+        for ( l = 1; l <= shapesize; l ++ )
+        {
+          int pt = list[l];
+          shape[l] = ( pt < 0 ? centroidIds[ -1 - pt ] :
+                       pt >= numPrevPts ? edgeIds[ pt - numPrevPts ] : pt );
+        }
+        shapes[i]->AddShape( shape );
+        list += shapesize + 1;
+      }
+    }
+  }
+}
+
 void vtkTableBasedClipperVolumeFromVolume::
      ConstructDataSet( vtkDataSet * input,
                        vtkUnstructuredGrid * output, double * pts_ptr )
@@ -1597,151 +1709,654 @@ inline void GetPoint( double * pt, const double * X, const double * Y,
 // ============================================================================
 
 
-//-----------------------------------------------------------------------------
-// Construct with user-specified implicit function; InsideOut turned off; value
-// set to 0.0; and generate clip scalars turned off.
-vtkTableBasedClipDataSet::vtkTableBasedClipDataSet( vtkImplicitFunction * cf )
-{
-  this->Locator      = nullptr;
-  this->ClipFunction = cf;
+// ============================================================================
+// ================= vtkTableBasedClipper cell clipping (begin) ===============
+// ============================================================================
 
-  // setup a callback to report progress
-  this->InternalProgressObserver = vtkCallbackCommand::New();
-  this->InternalProgressObserver->SetCallback
-        ( &vtkTableBasedClipDataSet::InternalProgressCallbackFunction );
-  this->InternalProgressObserver->SetClientData( this );
+namespace
+{
 
-  this->Value     = 0.0;
-  this->InsideOut = 0;
-  this->MergeTolerance        = 0.01;
-  this->UseValueAsOffset      = true;
-  this->GenerateClipScalars   = 0;
-  this->GenerateClippedOutput = 0;
+typedef const int vtkTableBasedClipperEdgeVertices[2];
 
-  this->OutputPointsPrecision = DEFAULT_PRECISION;
+// The minimum number of cells clipped by a thread.
+const int vtkTableBasedClipperBatchSize = 16384;
 
-  this->SetNumberOfOutputPorts( 2 );
-  vtkUnstructuredGrid * output2 = vtkUnstructuredGrid::New();
-  this->GetExecutive()->SetOutputData( 1, output2 );
-  output2->Delete();
-  output2 = nullptr;
+//-----------------------------------------------------------------------------
+// Add to the volume the shapes of the clip case of a cell, on the side
+// selected by insideOut. ptIds are the point ids of the cell vertices,
+// edgeVtxs the vertices of the cell edges and grdDiffs the clip scalars
+// minus the iso value at the vertices. Return the number of invalid entries
+// found in the case.
+int vtkTableBasedClipperAddCase
+  ( vtkTableBasedClipperVolumeFromVolume * visItVFV, int cellId,
+    const unsigned char * thisCase, int nOutputs, const int * ptIds,
+    vtkTableBasedClipperEdgeVertices * edgeVtxs, const double * grdDiffs,
+    int insideOut )
+{
+  int   errors = 0;
+  int   intrpIds[4];
+  for ( int j = 0; j < nOutputs; j ++ )
+  {
+    int      nCellPts = 0;
+    int      theColor = -1;
+    int      intrpIdx = -1;
+    unsigned char theShape = *thisCase ++;
+
+    // number of points and color
+    switch ( theShape )
+    {
+      case ST_HEX:
+        nCellPts = 8;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_WDG:
+        nCellPts = 6;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_PYR:
+        nCellPts = 5;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_TET:
+        nCellPts = 4;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_QUA:
+        nCellPts = 4;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_TRI:
+        nCellPts = 3;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_LIN:
+        nCellPts = 2;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_VTX:
+        nCellPts = 1;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_PNT:
+        intrpIdx = *thisCase ++;
+        theColor = *thisCase ++;
+        nCellPts = *thisCase ++;
+        break;
 
-  // process active point scalars by default
-  this->SetInputArrayToProcess
-        ( 0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS,
-          vtkDataSetAttributes::SCALARS );
-}
+      default:
+        errors ++;
+    }
 
-//-----------------------------------------------------------------------------
-vtkTableBasedClipDataSet::~vtkTableBasedClipDataSet()
-{
-  if ( this->Locator )
-  {
-    this->Locator->UnRegister( this );
-    this->Locator = nullptr;
-  }
-  this->SetClipFunction( nullptr );
-  this->InternalProgressObserver->Delete();
-  this->InternalProgressObserver = nullptr;
-}
+    if ( (!insideOut && theColor == COLOR0 ) ||
+         ( insideOut && theColor == COLOR1 )
+       )
+    {
+      // We don't want this one; it's the wrong side.
+      thisCase += nCellPts;
+      continue;
+    }
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::InternalProgressCallbackFunction
-   ( vtkObject * arg, unsigned long, void * clientdata, void * )
-{
-  reinterpret_cast < vtkTableBasedClipDataSet * > ( clientdata )
-    ->InternalProgressCallback(  static_cast < vtkAlgorithm * > ( arg )  );
-}
+    int   shapeIds[8];
+    for ( int p = 0; p < nCellPts; p ++ )
+    {
+      unsigned char pntIndex = *thisCase ++;
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::InternalProgressCallback
-   ( vtkAlgorithm * algorithm )
-{
-  double progress = algorithm->GetProgress();
-  this->UpdateProgress( progress );
+      if ( pntIndex <= P7 )
+      {
+        // We know pt P0 must be >P0 since we already
+        // assume P0 == 0.  This is why we do not
+        // bother subtracting P0 from pt here.
+        shapeIds[p] = ptIds[ pntIndex ];
+      }
+      else
+      if ( pntIndex >= EA && pntIndex <= EL )
+      {
+        int  pt1Index = edgeVtxs[ pntIndex-EA ][0];
+        int  pt2Index = edgeVtxs[ pntIndex-EA ][1];
+        if ( pt2Index < pt1Index )
+        {
+          int temp = pt2Index;
+          pt2Index = pt1Index;
+          pt1Index = temp;
+        }
+        double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
+        double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
+        double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
+
+        // We may have physically (though not logically) degenerate cells
+        // if p1Weight == 0 or p1Weight == 1. These points are nevertheless
+        // added: a synthetic Wavelet dataset clipped exactly at (0,0,0)
+        // would otherwise give an open 'box', as duplicate points are
+        // detected with a hash instead of a point locator.
+        shapeIds[p] = visItVFV->AddPoint
+                      ( ptIds[ pt1Index ], ptIds[ pt2Index ], p1Weight );
+      }
+      else
+      if ( pntIndex >= N0 && pntIndex <= N3 )
+      {
+        shapeIds[p] = intrpIds[ pntIndex - N0 ];
+      }
+      else
+      {
+        errors ++;
+      }
+    }
 
-  if ( this->AbortExecute )
-  {
-    algorithm->SetAbortExecute( 1 );
+    switch ( theShape )
+    {
+      case ST_HEX:
+        visItVFV->AddHex( cellId, shapeIds[0], shapeIds[1],
+                          shapeIds[2], shapeIds[3], shapeIds[4],
+                          shapeIds[5], shapeIds[6], shapeIds[7] );
+        break;
+
+      case ST_WDG:
+        visItVFV->AddWedge( cellId, shapeIds[0], shapeIds[1], shapeIds[2],
+                            shapeIds[3], shapeIds[4], shapeIds[5] );
+        break;
+
+      case ST_PYR:
+        visItVFV->AddPyramid( cellId, shapeIds[0], shapeIds[1],
+                              shapeIds[2], shapeIds[3], shapeIds[4] );
+        break;
+
+      case ST_TET:
+        visItVFV->AddTet( cellId, shapeIds[0], shapeIds[1],
+                          shapeIds[2], shapeIds[3] );
+        break;
+
+      case ST_QUA:
+        visItVFV->AddQuad( cellId, shapeIds[0], shapeIds[1],
+                           shapeIds[2], shapeIds[3] );
+        break;
+
+      case ST_TRI:
+        visItVFV->AddTri( cellId, shapeIds[0], shapeIds[1], shapeIds[2] );
+        break;
+
+      case ST_LIN:
+        visItVFV->AddLine( cellId, shapeIds[0], shapeIds[1] );
+        break;
+
+      case ST_VTX:
+        visItVFV->AddVertex( cellId, shapeIds[0] );
+        break;
+
+      case ST_PNT:
+        intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
+                                         ( nCellPts, shapeIds );
+        break;
+    }
   }
+
+  return errors;
 }
 
 //-----------------------------------------------------------------------------
-vtkMTimeType vtkTableBasedClipDataSet::GetMTime()
-{
-  vtkMTimeType time;
-  vtkMTimeType mTime = this->Superclass::GetMTime();
+// The cells of a rectilinear or a structured grid, hexahedra or quads.
+struct vtkTableBasedClipperStructuredCells
+{
+  vtkDataArray * ClipArray;
+  double         IsoValue;
+  int            InsideOut;
+  int            IsTwoDim;
+  int          * ShiftLUT[3];
+  int            CellDims[3];
+  int            CyStride;
+  int            CzStride;
+  int            PyStride;
+  int            PzStride;
+
+  // Clip the cells [begin, end) into the volume. Return the number of
+  // invalid clip case entries.
+  int ClipCells( vtkTableBasedClipperVolumeFromVolume * visItVFV,
+                 int begin, int end ) const
+  {
+    int   errors = 0;
+    for ( int i = begin; i < end; i ++ )
+    {
+      int    j;
+      int    caseIndx = 0;
+      int    nCellPts = this->IsTwoDim ? 4 : 8;
+      int    theCellI = ( this->CellDims[0] > 0 ?
+                          i % this->CellDims[0] : 0 );
+      int    theCellJ = ( this->CellDims[1] > 0 ?
+                          ( i / this->CyStride ) % this->CellDims[1] : 0 );
+      int    theCellK = ( this->CellDims[2] > 0 ? ( i / this->CzStride ) : 0 );
+      int    ptIds[8];
+      double grdDiffs[8];
 
-  if ( this->ClipFunction != nullptr )
-  {
-    time  = this->ClipFunction->GetMTime();
-    mTime = ( time > mTime ? time : mTime );
-  }
+      for ( j = 0; j < 8; j ++ )
+      {
+        ptIds[j] = ( theCellI + this->ShiftLUT[0][j] ) +
+                   ( theCellJ + this->ShiftLUT[1][j] ) * this->PyStride +
+                   ( theCellK + this->ShiftLUT[2][j] ) * this->PzStride;
+      }
 
-  if ( this->Locator != nullptr )
-  {
-    time  = this->Locator->GetMTime();
-    mTime = ( time > mTime ? time : mTime );
-  }
+      for ( j = nCellPts - 1; j >= 0; j -- )
+      {
+        grdDiffs[j] = this->ClipArray->GetComponent( ptIds[j], 0 )
+                      - this->IsoValue;
+        caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
+        caseIndx  <<= (  1 - ( !j )  );
+      }
 
-  return mTime;
-}
+      int             nOutputs;
+      unsigned char * thisCase = nullptr;
 
-vtkUnstructuredGrid *vtkTableBasedClipDataSet::GetClippedOutput()
-{
-  if ( !this->GenerateClippedOutput )
-  {
-    return nullptr;
-  }
+      if ( this->IsTwoDim )
+      {
+        thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua
+                 [  vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ]  ];
+        nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
+      }
+      else
+      {
+        thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex
+                 [  vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ]  ];
+        nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
+      }
 
-  return vtkUnstructuredGrid::SafeDownCast
-        (  this->GetExecutive()->GetOutputData( 1 )  );
-}
+      errors += vtkTableBasedClipperAddCase( visItVFV, i, thisCase, nOutputs,
+        ptIds, vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges,
+        grdDiffs, this->InsideOut );
+    }
+    return errors;
+  }
+};
 
 //-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::SetLocator
-   ( vtkIncrementalPointLocator * locator )
+// The cells of an unstructured grid. Only the cell types that the clip
+// tables handle are clipped, see CanClip().
+struct vtkTableBasedClipperUnstructuredCells
 {
-  if ( this->Locator == locator)
-  {
-    return;
-  }
+  vtkUnstructuredGrid * Grid;
+  vtkDataArray        * ClipArray;
+  double                IsoValue;
+  int                   InsideOut;
 
-  if ( this->Locator )
+  static bool CanClip( int cellType )
   {
-    this->Locator->UnRegister( this );
-    this->Locator = nullptr;
+    switch ( cellType )
+    {
+      case VTK_TETRA:
+      case VTK_PYRAMID:
+      case VTK_WEDGE:
+      case VTK_HEXAHEDRON:
+      case VTK_VOXEL:
+      case VTK_TRIANGLE:
+      case VTK_QUAD:
+      case VTK_PIXEL:
+      case VTK_LINE:
+      case VTK_VERTEX:
+        return true;
+
+      default:
+        return false;
+    }
   }
 
-  if ( locator )
+  // Clip the cells [begin, end) into the volume. Return the number of
+  // invalid clip case entries.
+  int ClipCells( vtkTableBasedClipperVolumeFromVolume * visItVFV,
+                 int begin, int end ) const
   {
-    locator->Register( this );
-  }
+    int         errors = 0;
+    vtkIdList * cellIds = vtkIdList::New();
+    for ( int i = begin; i < end; i ++ )
+    {
+      int cellType = this->Grid->GetCellType( i );
+      if ( !CanClip( cellType ) )
+      {
+        continue;
+      }
 
-  this->Locator = locator;
-  this->Modified();
-}
+      vtkIdType         numbPnts = 0;
+      const vtkIdType * pntIndxs = nullptr;
+      this->Grid->GetCellPoints( i, numbPnts, pntIndxs, cellIds );
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::CreateDefaultLocator()
-{
-  if ( this->Locator == nullptr )
-  {
-    this->Locator = vtkMergePoints::New();
-    this->Locator->Register( this );
-    this->Locator->Delete();
-  }
-}
+      int    caseIndx = 0;
+      int    ptIds[8];
+      double grdDiffs[8];
 
-//-----------------------------------------------------------------------------
-int vtkTableBasedClipDataSet::FillInputPortInformation
-  ( int, vtkInformation * info )
-{
-  info->Set( vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet" );
-  return 1;
-}
+      for ( int j = static_cast< int >( numbPnts ) - 1; j >= 0; j -- )
+      {
+        ptIds[j]    = static_cast< int >( pntIndxs[j] );
+        grdDiffs[j] = this->ClipArray->GetComponent( pntIndxs[j], 0 )
+                      - this->IsoValue;
+        caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
+        caseIndx  <<= (  1 - ( !j )  );
+      }
 
-//-----------------------------------------------------------------------------
+      int               startIdx = 0;
+      int               nOutputs = 0;
+      vtkTableBasedClipperEdgeVertices * edgeVtxs = nullptr;
+      unsigned char   * thisCase = nullptr;
+
+      // start index, split case, number of output, and vertices from edges
+      switch ( cellType )
+      {
+        case VTK_TETRA:
+          startIdx = vtkTableBasedClipperClipTables::StartClipShapesTet[ caseIndx ];
+          thisCase =&vtkTableBasedClipperClipTables::ClipShapesTet[ startIdx ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTet[ caseIndx ];
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::TetVerticesFromEdges;
+          break;
+
+        case VTK_PYRAMID:
+          startIdx = vtkTableBasedClipperClipTables::StartClipShapesPyr[ caseIndx ];
+          thisCase =&vtkTableBasedClipperClipTables::ClipShapesPyr[ startIdx ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPyr[ caseIndx ];
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::PyramidVerticesFromEdges;
+          break;
+
+        case VTK_WEDGE:
+          startIdx = vtkTableBasedClipperClipTables::StartClipShapesWdg[ caseIndx ];
+          thisCase =&vtkTableBasedClipperClipTables::ClipShapesWdg[ startIdx ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesWdg[ caseIndx ];
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::WedgeVerticesFromEdges;
+          break;
+
+        case VTK_HEXAHEDRON:
+          startIdx = vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ];
+          thisCase =&vtkTableBasedClipperClipTables::ClipShapesHex[ startIdx ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
+          break;
+
+        case VTK_VOXEL:
+          startIdx = vtkTableBasedClipperClipTables::StartClipShapesVox[ caseIndx ];
+          thisCase =&vtkTableBasedClipperClipTables::ClipShapesVox[ startIdx ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVox[ caseIndx ];
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::VoxVerticesFromEdges;
+          break;
+
+        case VTK_TRIANGLE:
+          startIdx = vtkTableBasedClipperClipTables::StartClipShapesTri[ caseIndx ];
+          thisCase =&vtkTableBasedClipperClipTables::ClipShapesTri[ startIdx ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTri[ caseIndx ];
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::TriVerticesFromEdges;
+          break;
+
+        case VTK_QUAD:
+          startIdx = vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ];
+          thisCase =&vtkTableBasedClipperClipTables::ClipShapesQua[ startIdx ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
+          break;
+
+        case VTK_PIXEL:
+          startIdx = vtkTableBasedClipperClipTables::StartClipShapesPix[ caseIndx ];
+          thisCase =&vtkTableBasedClipperClipTables::ClipShapesPix[ startIdx ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPix[ caseIndx ];
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::PixelVerticesFromEdges;
+          break;
+
+        case VTK_LINE:
+          startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[ caseIndx ];
+          thisCase =&vtkTableBasedClipperClipTables::ClipShapesLin[ startIdx ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesLin[ caseIndx ];
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
+          break;
+
+        case VTK_VERTEX:
+          startIdx = vtkTableBasedClipperClipTables::StartClipShapesVtx[ caseIndx ];
+          thisCase =&vtkTableBasedClipperClipTables::ClipShapesVtx[ startIdx ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVtx[ caseIndx ];
+          edgeVtxs = nullptr;
+          break;
+      }
+
+      errors += vtkTableBasedClipperAddCase( visItVFV, i, thisCase, nOutputs,
+        ptIds, edgeVtxs, grdDiffs, this->InsideOut );
+    }
+    cellIds->Delete();
+    return errors;
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Clip batches of consecutive cells, each into its own volume.
+template < typename TCells >
+struct vtkTableBasedClipperClipBatches
+{
+  const TCells & Cells;
+  vtkIdType      NumCells;
+  vtkIdType      NumBatches;
+  int            Precision;
+  int            NumPts;
+  std::vector< vtkTableBasedClipperVolumeFromVolume * > & Volumes;
+  std::vector< int > & Errors;
+
+  vtkTableBasedClipperClipBatches( const TCells & cells, vtkIdType numCells,
+    int precision, int numPts,
+    std::vector< vtkTableBasedClipperVolumeFromVolume * > & volumes,
+    std::vector< int > & errors )
+    : Cells( cells ), NumCells( numCells ),
+      NumBatches( static_cast< vtkIdType >( volumes.size() ) ),
+      Precision( precision ), NumPts( numPts ), Volumes( volumes ),
+      Errors( errors )
+  {
+  }
+
+  void operator()( vtkIdType batch, vtkIdType endBatch )
+  {
+    for ( ; batch < endBatch; batch ++ )
+    {
+      int begin = static_cast< int >
+                  ( batch * this->NumCells / this->NumBatches );
+      int end   = static_cast< int >
+                  ( ( batch + 1 ) * this->NumCells / this->NumBatches );
+      this->Volumes[ batch ] = new vtkTableBasedClipperVolumeFromVolume(
+        this->Precision, this->NumPts,
+        int(   pow(  double( end - begin ), double( 0.6667f )  )   ) * 5 + 100 );
+      this->Errors[ batch ] =
+        this->Cells.ClipCells( this->Volumes[ batch ], begin, end );
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Clip all the cells into the volume. Large inputs are clipped in parallel,
+// by batches of cells each filling a volume of its own. The volumes are
+// then appended in the order of the cells, which deduplicates the points
+// created on the edges shared by several batches and gives the same points
+// and shapes, in the same order, as a sequential clip. Return the number of
+// invalid clip case entries.
+template < typename TCells >
+int vtkTableBasedClipperClipAllCells( const TCells & cells, int numCells,
+  vtkTableBasedClipperVolumeFromVolume * visItVFV, int precision,
+  int numPts )
+{
+  vtkIdType numBatches = 1;
+  int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  if ( numThreads > 1 )
+  {
+    numBatches = std::min( static_cast< vtkIdType >( 4 * numThreads ),
+      static_cast< vtkIdType >( numCells / vtkTableBasedClipperBatchSize ) );
+  }
+  if ( numBatches <= 1 )
+  {
+    return cells.ClipCells( visItVFV, 0, numCells );
+  }
+
+  std::vector< vtkTableBasedClipperVolumeFromVolume * >
+    volumes( numBatches, nullptr );
+  std::vector< int > errors( numBatches, 0 );
+  vtkTableBasedClipperClipBatches< TCells > clipBatches( cells, numCells,
+    precision, numPts, volumes, errors );
+  vtkSMPTools::For( 0, numBatches, 1, clipBatches );
+
+  int numErrors = 0;
+  for ( vtkIdType batch = 0; batch < numBatches; batch ++ )
+  {
+    visItVFV->Append( *volumes[ batch ] );
+    delete volumes[ batch ];
+    numErrors += errors[ batch ];
+  }
+  return numErrors;
+}
+
+} // end anon namespace
+
+// ============================================================================
+// ================== vtkTableBasedClipper cell clipping (end) ================
+// ============================================================================
+
+
+//-----------------------------------------------------------------------------
+// Construct with user-specified implicit function; InsideOut turned off; value
+// set to 0.0; and generate clip scalars turned off.
+vtkTableBasedClipDataSet::vtkTableBasedClipDataSet( vtkImplicitFunction * cf )
+{
+  this->Locator      = nullptr;
+  this->ClipFunction = cf;
+
+  // setup a callback to report progress
+  this->InternalProgressObserver = vtkCallbackCommand::New();
+  this->InternalProgressObserver->SetCallback
+        ( &vtkTableBasedClipDataSet::InternalProgressCallbackFunction );
+  this->InternalProgressObserver->SetClientData( this );
+
+  this->Value     = 0.0;
+  this->InsideOut = 0;
+  this->MergeTolerance        = 0.01;
+  this->UseValueAsOffset      = true;
+  this->GenerateClipScalars   = 0;
+  this->GenerateClippedOutput = 0;
+
+  this->OutputPointsPrecision = DEFAULT_PRECISION;
+
+  this->SetNumberOfOutputPorts( 2 );
+  vtkUnstructuredGrid * output2 = vtkUnstructuredGrid::New();
+  this->GetExecutive()->SetOutputData( 1, output2 );
+  output2->Delete();
+  output2 = nullptr;
+
+  // process active point scalars by default
+  this->SetInputArrayToProcess
+        ( 0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS,
+          vtkDataSetAttributes::SCALARS );
+}
+
+//-----------------------------------------------------------------------------
+vtkTableBasedClipDataSet::~vtkTableBasedClipDataSet()
+{
+  if ( this->Locator )
+  {
+    this->Locator->UnRegister( this );
+    this->Locator = nullptr;
+  }
+  this->SetClipFunction( nullptr );
+  this->InternalProgressObserver->Delete();
+  this->InternalProgressObserver = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::InternalProgressCallbackFunction
+   ( vtkObject * arg, unsigned long, void * clientdata, void * )
+{
+  reinterpret_cast < vtkTableBasedClipDataSet * > ( clientdata )
+    ->InternalProgressCallback(  static_cast < vtkAlgorithm * > ( arg )  );
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::InternalProgressCallback
+   ( vtkAlgorithm * algorithm )
+{
+  double progress = algorithm->GetProgress();
+  this->UpdateProgress( progress );
+
+  if ( this->AbortExecute )
+  {
+    algorithm->SetAbortExecute( 1 );
+  }
+}
+
+//-----------------------------------------------------------------------------
+vtkMTimeType vtkTableBasedClipDataSet::GetMTime()
+{
+  vtkMTimeType time;
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+
+  if ( this->ClipFunction != nullptr )
+  {
+    time  = this->ClipFunction->GetMTime();
+    mTime = ( time > mTime ? time : mTime );
+  }
+
+  if ( this->Locator != nullptr )
+  {
+    time  = this->Locator->GetMTime();
+    mTime = ( time > mTime ? time : mTime );
+  }
+
+  return mTime;
+}
+
+vtkUnstructuredGrid *vtkTableBasedClipDataSet::GetClippedOutput()
+{
+  if ( !this->GenerateClippedOutput )
+  {
+    return nullptr;
+  }
+
+  return vtkUnstructuredGrid::SafeDownCast
+        (  this->GetExecutive()->GetOutputData( 1 )  );
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::SetLocator
+   ( vtkIncrementalPointLocator * locator )
+{
+  if ( this->Locator == locator)
+  {
+    return;
+  }
+
+  if ( this->Locator )
+  {
+    this->Locator->UnRegister( this );
+    this->Locator = nullptr;
+  }
+
+  if ( locator )
+  {
+    locator->Register( this );
+  }
+
+  this->Locator = locator;
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::CreateDefaultLocator()
+{
+  if ( this->Locator == nullptr )
+  {
+    this->Locator = vtkMergePoints::New();
+    this->Locator->Register( this );
+    this->Locator->Delete();
+  }
+}
+
+//-----------------------------------------------------------------------------
+int vtkTableBasedClipDataSet::FillInputPortInformation
+  ( int, vtkInformation * info )
+{
+  info->Set( vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet" );
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
 int vtkTableBasedClipDataSet::RequestData( vtkInformation * vtkNotUsed( request ),
     vtkInformationVector ** inputVector, vtkInformationVector * outputVector )
 {
@@ -2394,277 +3009,49 @@ void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd,
   int shiftLUTy[8] = { 0, 0, 1, 1, 0, 0, 1, 1 };
   int shiftLUTz[8] = { 0, 0, 0, 0, 1, 1, 1, 1 };
 
-  int* shiftLUT[3];
+  vtkTableBasedClipperStructuredCells cells;
   if (isTwoDim && twoDimType == XZ)
   {
-    shiftLUT[0] = shiftLUTx;
-    shiftLUT[1] = shiftLUTz;
-    shiftLUT[2] = shiftLUTy;
+    cells.ShiftLUT[0] = shiftLUTx;
+    cells.ShiftLUT[1] = shiftLUTz;
+    cells.ShiftLUT[2] = shiftLUTy;
   }
   else if (isTwoDim && twoDimType == YZ)
   {
-    shiftLUT[0] = shiftLUTy;
-    shiftLUT[1] = shiftLUTz;
-    shiftLUT[2] = shiftLUTx;
+    cells.ShiftLUT[0] = shiftLUTy;
+    cells.ShiftLUT[1] = shiftLUTz;
+    cells.ShiftLUT[2] = shiftLUTx;
   }
   else
   {
-    shiftLUT[0] = shiftLUTx;
-    shiftLUT[1] = shiftLUTy;
-    shiftLUT[2] = shiftLUTz;
+    cells.ShiftLUT[0] = shiftLUTx;
+    cells.ShiftLUT[1] = shiftLUTy;
+    cells.ShiftLUT[2] = shiftLUTz;
   }
 
   int   cellDims[3] = { rectDims[0] - 1, rectDims[1] - 1, rectDims[2] - 1 };
-  int   cyStride    = (cellDims[0] ? cellDims[0] : 1);
-  int   czStride    = (cellDims[0] ? cellDims[0] : 1) * (cellDims[1] ? cellDims[1] : 1);
-  int   pyStride    = rectDims[0];
-  int   pzStride    = rectDims[0] * rectDims[1];
+  cells.ClipArray   = clipAray;
+  cells.IsoValue    = isoValue;
+  cells.InsideOut   = this->InsideOut;
+  cells.IsTwoDim    = isTwoDim;
+  cells.CellDims[0] = cellDims[0];
+  cells.CellDims[1] = cellDims[1];
+  cells.CellDims[2] = cellDims[2];
+  cells.CyStride    = (cellDims[0] ? cellDims[0] : 1);
+  cells.CzStride    = (cellDims[0] ? cellDims[0] : 1) * (cellDims[1] ? cellDims[1] : 1);
+  cells.PyStride    = rectDims[0];
+  cells.PzStride    = rectDims[0] * rectDims[1];
 
-  for ( i = 0; i < numCells; i ++ )
+  if ( vtkTableBasedClipperClipAllCells( cells, numCells, visItVFV,
+         this->OutputPointsPrecision, rectGrid->GetNumberOfPoints() ) )
   {
-    int    caseIndx = 0;
-    int    nCellPts = isTwoDim ? 4 : 8;
-    int    theCellI = (cellDims[0] > 0 ? i % cellDims[0] : 0);
-    int    theCellJ = (cellDims[1] > 0 ? ( i / cyStride ) % cellDims[1] : 0);
-    int    theCellK = (cellDims[2] > 0 ? ( i / czStride ) : 0);
-    double grdDiffs[8];
-
-    for ( j = nCellPts - 1; j >= 0; j -- )
-    {
-      grdDiffs[j] = clipAray->GetComponent
-                              (  ( theCellK + shiftLUT[2][j] ) * pzStride +
-                                 ( theCellJ + shiftLUT[1][j] ) * pyStride +
-                                 ( theCellI + shiftLUT[0][j] ),  0
-                              ) - isoValue;
-      caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
-      caseIndx  <<= (  1 - ( !j )  );
-    }
+    vtkErrorMacro( << "An invalid output shape or point was found "
+                   << "in the ClipCases." << endl );
+  }
 
-    int             nOutputs;
-    int             intrpIds[4];
-    unsigned char * thisCase = nullptr;
-
-    if ( isTwoDim )
-    {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua
-               [  vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
-    }
-    else
-    {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex
-               [  vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
-    }
-
-    for ( j = 0; j < nOutputs; j++ )
-    {
-      int      intrpIdx = -1;
-      int      theColor = -1;
-      unsigned char theShape = *thisCase ++;
-
-      nCellPts = 0;
-      switch ( theShape )
-      {
-        case ST_HEX:
-          nCellPts = 8;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_WDG:
-          nCellPts = 6;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_PYR:
-          nCellPts = 5;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_TET:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_QUA:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_TRI:
-          nCellPts = 3;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_LIN:
-          nCellPts = 2;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_VTX:
-          nCellPts = 1;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_PNT:
-          intrpIdx = *thisCase ++;
-          theColor = *thisCase ++;
-          nCellPts = *thisCase ++;
-          break;
-
-        default:
-          vtkErrorMacro( << "An invalid output shape was found in "
-                         << "the ClipCases." << endl );
-      }
-
-      if ( (!this->InsideOut && theColor == COLOR0 ) ||
-           ( this->InsideOut && theColor == COLOR1 )
-         )
-      {
-        // We don't want this one; it's the wrong side.
-        thisCase += nCellPts;
-        continue;
-      }
-
-      int   shapeIds[8];
-      for ( int p = 0; p < nCellPts; p ++ )
-      {
-        unsigned char pntIndex = *thisCase ++;
-
-        if ( pntIndex <= P7 )
-        {
-          // We know pt P0 must be >P0 since we already
-          // assume P0 == 0.  This is why we do not
-          // bother subtracting P0 from pt here.
-          shapeIds[p] =
-                      (   (  theCellI + shiftLUT[0][ pntIndex ]  ) +
-                          (  theCellJ + shiftLUT[1][ pntIndex ]  ) * pyStride +
-                          (  theCellK + shiftLUT[2][ pntIndex ]  ) * pzStride
-                      );
-        }
-        else
-        if ( pntIndex >= EA && pntIndex <= EL )
-        {
-          int pt1Index = vtkTableBasedClipperTriangulationTables::
-                         HexVerticesFromEdges[ pntIndex - EA ][0];
-          int pt2Index = vtkTableBasedClipperTriangulationTables::
-                         HexVerticesFromEdges[ pntIndex - EA ][1];
-
-          if ( pt2Index < pt1Index )
-          {
-            int temp = pt2Index;
-            pt2Index = pt1Index;
-            pt1Index = temp;
-          }
-
-          double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
-          double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
-          double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
-
-          int    pntIndx1 =
-                 (   (  theCellI + shiftLUT[0][ pt1Index ]  ) +
-                     (  theCellJ + shiftLUT[1][ pt1Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt1Index ]  ) * pzStride
-                 );
-          int    pntIndx2 =
-                 (   (  theCellI + shiftLUT[0][ pt2Index ]  ) +
-                     (  theCellJ + shiftLUT[1][ pt2Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt2Index ]  ) * pzStride
-                 );
-
-          /* We may have physically (though not logically) degenerate cells
-          // if p1Weight == 0 or p1Weight == 1. We could pretty easily and
-          // mostly safely clamp percent to the range [1e-4, 1 - 1e-4].
-          if( p1Weight == 1.0)
-            {
-            shapeIds[p] = pntIndx1;
-            }
-          else
-          if( p1Weight == 0.0 )
-            {
-            shapeIds[p] = pntIndx2;
-            }
-          else
-
-            {
-            shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-            }
-          */
-
-          // Turning on the above code segment, the alternative, would cause
-          // a bug with a synthetic Wavelet dataset (vtkImageData) when the
-          // the clipping plane (x/y/z axis) is positioned exactly at (0,0,0).
-          // The problem occurs in the form of an open 'box', as opposed to an
-          // expected closed one. This is due to the use of hash instead of a
-          // point-locator based detection of duplicate points.
-          shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-        }
-        else
-        if ( pntIndex >= N0 && pntIndex <= N3 )
-        {
-          shapeIds[p] = intrpIds[ pntIndex - N0 ];
-        }
-        else
-        {
-          vtkErrorMacro( << "An invalid output point value "
-                         << "was found in the ClipCases." << endl );
-        }
-      }
-
-      switch ( theShape )
-      {
-        case ST_HEX:
-          visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3], shapeIds[4],
-                               shapeIds[5], shapeIds[6], shapeIds[7] );
-          break;
-
-        case ST_WDG:
-          visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
-                                 shapeIds[3], shapeIds[4], shapeIds[5] );
-          break;
-
-        case ST_PYR:
-          visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
-                                   shapeIds[2], shapeIds[3], shapeIds[4] );
-          break;
-
-        case ST_TET:
-          visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3] );
-          break;
-
-        case ST_QUA:
-          visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
-                                shapeIds[2], shapeIds[3] );
-          break;
-
-        case ST_TRI:
-          visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
-          break;
-
-        case ST_LIN:
-          visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
-          break;
-
-        case ST_VTX:
-          visItVFV->AddVertex( i, shapeIds[0] );
-          break;
-
-        case ST_PNT:
-          intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
-                                           ( nCellPts, shapeIds );
-          break;
-      }
-    }
-
-    thisCase = nullptr;
-  }
-
-
-  int            toDelete    = 0;
-  double       * theCords[3] = { nullptr, nullptr, nullptr };
-  vtkDataArray * theArays[3] = { nullptr, nullptr, nullptr };
+  int            toDelete    = 0;
+  double       * theCords[3] = { nullptr, nullptr, nullptr };
+  vtkDataArray * theArays[3] = { nullptr, nullptr, nullptr };
 
   if ( rectGrid->GetXCoordinates()->GetDataType() == VTK_DOUBLE &&
        rectGrid->GetYCoordinates()->GetDataType() == VTK_DOUBLE &&
@@ -2719,7 +3106,7 @@ void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
 {
   vtkStructuredGrid * strcGrid = vtkStructuredGrid::SafeDownCast( inputGrd );
 
-  int   i, j;
+  int   i;
   int   isTwoDim    = 0;
   enum TwoDimType { XY, YZ, XZ };
   TwoDimType twoDimType;
@@ -2741,250 +3128,47 @@ void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
   int shiftLUTy[8] = { 0, 0, 1, 1, 0, 0, 1, 1 };
   int shiftLUTz[8] = { 0, 0, 0, 0, 1, 1, 1, 1 };
 
-  int* shiftLUT[3];
+  vtkTableBasedClipperStructuredCells cells;
   if (isTwoDim && twoDimType == XZ)
   {
-    shiftLUT[0] = shiftLUTx;
-    shiftLUT[1] = shiftLUTz;
-    shiftLUT[2] = shiftLUTy;
+    cells.ShiftLUT[0] = shiftLUTx;
+    cells.ShiftLUT[1] = shiftLUTz;
+    cells.ShiftLUT[2] = shiftLUTy;
   }
   else if (isTwoDim && twoDimType == YZ)
   {
-    shiftLUT[0] = shiftLUTy;
-    shiftLUT[1] = shiftLUTz;
-    shiftLUT[2] = shiftLUTx;
+    cells.ShiftLUT[0] = shiftLUTy;
+    cells.ShiftLUT[1] = shiftLUTz;
+    cells.ShiftLUT[2] = shiftLUTx;
   }
   else
   {
-    shiftLUT[0] = shiftLUTx;
-    shiftLUT[1] = shiftLUTy;
-    shiftLUT[2] = shiftLUTz;
+    cells.ShiftLUT[0] = shiftLUTx;
+    cells.ShiftLUT[1] = shiftLUTy;
+    cells.ShiftLUT[2] = shiftLUTz;
   }
 
-  int   numbPnts    = 0;
   int   cellDims[3] = { gridDims[0] - 1, gridDims[1] - 1, gridDims[2] - 1 };
-  int   cyStride    = (cellDims[0] ? cellDims[0] : 1);
-  int   czStride    = (cellDims[0] ? cellDims[0] : 1) * (cellDims[1] ? cellDims[1] : 1);
-  int   pyStride    = gridDims[0];
-  int   pzStride    = gridDims[0] * gridDims[1];
-
-  for ( i = 0; i < numCells; i ++ )
-  {
-    int    caseIndx = 0;
-    int    theCellI = (cellDims[0] > 0 ? i % cellDims[0] : 0);
-    int    theCellJ = (cellDims[1] > 0 ? ( i / cyStride ) % cellDims[1] : 0);
-    int    theCellK = (cellDims[2] > 0 ? ( i / czStride ) : 0);
-    double grdDiffs[8];
-
-    numbPnts = isTwoDim ? 4 : 8;
-
-    for ( j = numbPnts - 1; j >= 0; j -- )
-    {
-      int pntIndex = ( theCellI + shiftLUT[0][j] ) +
-                     ( theCellJ + shiftLUT[1][j] ) * pyStride +
-                     ( theCellK + shiftLUT[2][j] ) * pzStride;
-
-      grdDiffs[j]  = clipAray->GetComponent( pntIndex, 0 ) - isoValue;
-      caseIndx    += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
-      caseIndx   <<= (  1 - ( !j )  );
-    }
-
-    int             nOutputs;
-    int             intrpIds[4];
-    unsigned char * thisCase = nullptr;
-
-    if ( isTwoDim )
-    {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua
-               [  vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
-    }
-    else
-    {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex
-               [  vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
-    }
-
-    for ( j = 0; j < nOutputs; j ++ )
-    {
-      int      nCellPts = 0;
-      int      intrpIdx = -1;
-      int      theColor = -1;
-      unsigned char theShape = *thisCase ++;
-
-      switch ( theShape )
-      {
-        case ST_HEX:
-          nCellPts = 8;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_WDG:
-          nCellPts = 6;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_PYR:
-          nCellPts = 5;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_TET:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_QUA:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_TRI:
-          nCellPts = 3;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_LIN:
-          nCellPts = 2;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_VTX:
-          nCellPts = 1;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_PNT:
-          intrpIdx = *thisCase ++;
-          theColor = *thisCase ++;
-          nCellPts = *thisCase ++;
-          break;
-
-        default:
-          vtkErrorMacro( << "An invalid output shape was found in "
-                         << "the ClipCases." << endl );
-      }
-
-      if ( (!this->InsideOut && theColor == COLOR0 ) ||
-           ( this->InsideOut && theColor == COLOR1 )
-         )
-      {
-        // We don't want this one; it's the wrong side.
-        thisCase += nCellPts;
-        continue;
-      }
-
-      int   shapeIds[8];
-      for ( int p = 0; p < nCellPts; p ++ )
-      {
-        unsigned char pntIndex = *thisCase ++;
-
-        if ( pntIndex <= P7 )
-        {
-          // We know pt P0 must be >P0 since we already
-          // assume P0 == 0.  This is why we do not
-          // bother subtracting P0 from pt here.
-          shapeIds[p] =
-                      (   (  theCellI + shiftLUT[0][ pntIndex ]  ) +
-                          (  theCellJ + shiftLUT[1][ pntIndex ]  ) * pyStride +
-                          (  theCellK + shiftLUT[2][ pntIndex ]  ) * pzStride
-                      );
-        }
-        else
-        if ( pntIndex >= EA && pntIndex <= EL )
-        {
-          int  pt1Index = vtkTableBasedClipperTriangulationTables::
-                          HexVerticesFromEdges[ pntIndex - EA ][0];
-          int  pt2Index = vtkTableBasedClipperTriangulationTables::
-                          HexVerticesFromEdges[ pntIndex - EA ][1];
-
-          if ( pt2Index < pt1Index )
-          {
-            int temp = pt2Index;
-            pt2Index = pt1Index;
-            pt1Index = temp;
-          }
-
-          double pt1ToPt2 = grdDiffs[ pt2Index] - grdDiffs[ pt1Index ];
-          double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
-          double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
-
-          int    pntIndx1 =
-                 (   (  theCellI + shiftLUT[0][ pt1Index ] ) +
-                     (  theCellJ + shiftLUT[1][ pt1Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt1Index ]  ) * pzStride
-                 );
-          int    pntIndx2 =
-                 (   (  theCellI + shiftLUT[0][ pt2Index ]  ) +
-                     (  theCellJ + shiftLUT[1][ pt2Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt2Index ]  ) * pzStride
-                 );
-
-          shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-        }
-        else
-        if ( pntIndex >= N0 && pntIndex <= N3 )
-        {
-          shapeIds[p] = intrpIds[ pntIndex - N0 ];
-        }
-        else
-        {
-          vtkErrorMacro( << "An invalid output point value "
-                         << "was found in the ClipCases." << endl );
-        }
-      }
-
-      switch ( theShape )
-      {
-        case ST_HEX:
-          visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3], shapeIds[4],
-                               shapeIds[5], shapeIds[6], shapeIds[7] );
-          break;
-
-        case ST_WDG:
-          visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
-                                 shapeIds[3], shapeIds[4], shapeIds[5] );
-          break;
-
-        case ST_PYR:
-          visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
-                                   shapeIds[2], shapeIds[3], shapeIds[4] );
-          break;
-
-        case ST_TET:
-          visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3] );
-          break;
-
-        case ST_QUA:
-          visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
-                                shapeIds[2], shapeIds[3] );
-          break;
-
-        case ST_TRI:
-          visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
-          break;
-
-        case ST_LIN:
-          visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
-          break;
-
-        case ST_VTX:
-          visItVFV->AddVertex( i, shapeIds[0] );
-          break;
-
-        case ST_PNT:
-          intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
-                                           ( nCellPts, shapeIds );
-          break;
-      }
-    }
-
-    thisCase = nullptr;
-  }
-
+  cells.ClipArray   = clipAray;
+  cells.IsoValue    = isoValue;
+  cells.InsideOut   = this->InsideOut;
+  cells.IsTwoDim    = isTwoDim;
+  cells.CellDims[0] = cellDims[0];
+  cells.CellDims[1] = cellDims[1];
+  cells.CellDims[2] = cellDims[2];
+  cells.CyStride    = (cellDims[0] ? cellDims[0] : 1);
+  cells.CzStride    = (cellDims[0] ? cellDims[0] : 1) * (cellDims[1] ? cellDims[1] : 1);
+  cells.PyStride    = gridDims[0];
+  cells.PzStride    = gridDims[0] * gridDims[1];
+
+  if ( vtkTableBasedClipperClipAllCells( cells, numCells, visItVFV,
+         this->OutputPointsPrecision, strcGrid->GetNumberOfPoints() ) )
+  {
+    vtkErrorMacro( << "An invalid output shape or point was found "
+                   << "in the ClipCases." << endl );
+  }
+
+  int         numbPnts = 0;
   int         toDelete = 0;
   double    * theCords = nullptr;
   vtkPoints * inputPts = strcGrid->GetPoints();
@@ -3023,7 +3207,7 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
 {
   vtkUnstructuredGrid * unstruct = vtkUnstructuredGrid::SafeDownCast( inputGrd );
 
-  vtkIdType   i, j;
+  vtkIdType   i;
   vtkIdType   numbPnts = 0;
   int         numCants = 0; // number of cells not clipped by this filter
   int         numCells = unstruct->GetNumberOfCells();
@@ -3040,327 +3224,56 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
   specials->GetPointData()->ShallowCopy( unstruct->GetPointData() );
   specials->Allocate( numCells );
 
-  for ( i = 0; i < numCells; i ++ )
+  // The first access builds the cell locations of the grid, which must
+  // exist before the cells are clipped in parallel.
+  if ( numCells > 0 )
   {
-    int         cellType = unstruct->GetCellType( i );
-    vtkIdType * pntIndxs = nullptr;
-    unstruct->GetCellPoints( i, numbPnts, pntIndxs );
+    vtkIdList * cellIds = vtkIdList::New();
+    unstruct->GetCellPoints( 0, cellIds );
+    cellIds->Delete();
+  }
 
-    bool     bCanClip = false;
-    switch ( cellType )
-    {
-      case VTK_TETRA:
-      case VTK_PYRAMID:
-      case VTK_WEDGE:
-      case VTK_HEXAHEDRON:
-      case VTK_VOXEL:
-      case VTK_TRIANGLE:
-      case VTK_QUAD:
-      case VTK_PIXEL:
-      case VTK_LINE:
-      case VTK_VERTEX:
-           bCanClip = true;
-           break;
+  vtkTableBasedClipperUnstructuredCells cells;
+  cells.Grid      = unstruct;
+  cells.ClipArray = clipAray;
+  cells.IsoValue  = isoValue;
+  cells.InsideOut = this->InsideOut;
+  if ( vtkTableBasedClipperClipAllCells( cells, numCells, visItVFV,
+         this->OutputPointsPrecision, unstruct->GetNumberOfPoints() ) )
+  {
+    vtkErrorMacro( << "An invalid output shape or point was found "
+                   << "in the ClipCases." << endl );
+  }
 
-      default:
-           bCanClip = false;
-           break;
+  // the cells that can not be clipped by the tables
+  for ( i = 0; i < numCells; i ++ )
+  {
+    int cellType = unstruct->GetCellType( i );
+    if ( vtkTableBasedClipperUnstructuredCells::CanClip( cellType ) )
+    {
+      continue;
     }
 
-    if ( bCanClip )
+    if ( numCants == 0 )
     {
-      int    caseIndx = 0;
-      double grdDiffs[8];
-
-      for ( j = numbPnts-1; j >= 0; j -- )
-      {
-        grdDiffs[j] = clipAray->GetComponent( pntIndxs[j], 0 ) - isoValue;
-        caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
-        caseIndx  <<= (  1 - ( !j )  );
-      }
-
-      int               startIdx = 0;
-      int               nOutputs = 0;
-      typedef const int EDGEIDXS[2];
-      EDGEIDXS        * edgeVtxs = nullptr;
-      unsigned char   * thisCase = nullptr;
-
-      // start index, split case, number of output, and vertices from edges
-      switch ( cellType )
-      {
-        case VTK_TETRA:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesTet[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesTet[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTet[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::TetVerticesFromEdges;
-          break;
-
-        case VTK_PYRAMID:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesPyr[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesPyr[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPyr[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::PyramidVerticesFromEdges;
-          break;
-
-        case VTK_WEDGE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesWdg[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesWdg[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesWdg[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::WedgeVerticesFromEdges;
-          break;
-
-        case VTK_HEXAHEDRON:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesHex[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
-          break;
-
-        case VTK_VOXEL:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesVox[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesVox[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVox[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::VoxVerticesFromEdges;
-          break;
-
-        case VTK_TRIANGLE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesTri[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesTri[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTri[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::TriVerticesFromEdges;
-          break;
-
-        case VTK_QUAD:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesQua[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
-          break;
-
-        case VTK_PIXEL:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesPix[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesPix[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPix[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::PixelVerticesFromEdges;
-          break;
-
-        case VTK_LINE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesLin[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesLin[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
-          break;
-
-        case VTK_VERTEX:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesVtx[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesVtx[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVtx[ caseIndx ];
-          edgeVtxs = nullptr;
-          break;
-      }
-
-      int   intrpIds[4];
-      for ( j = 0; j < nOutputs; j ++ )
-      {
-        int      nCellPts = 0;
-        int      theColor = -1;
-        int      intrpIdx = -1;
-        unsigned char theShape = *thisCase ++;
-
-        // number of points and color
-        switch ( theShape )
-        {
-          case ST_HEX:
-            nCellPts = 8;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_WDG:
-            nCellPts = 6;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_PYR:
-            nCellPts = 5;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_TET:
-            nCellPts = 4;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_QUA:
-            nCellPts = 4;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_TRI:
-            nCellPts = 3;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_LIN:
-            nCellPts = 2;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_VTX:
-            nCellPts = 1;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_PNT:
-            intrpIdx = *thisCase ++;
-            theColor = *thisCase ++;
-            nCellPts = *thisCase ++;
-            break;
-
-          default:
-            vtkErrorMacro( << "An invalid output shape was found "
-                           << "in the ClipCases." << endl );
-        }
-
-        if ( (!this->InsideOut && theColor == COLOR0 ) ||
-             ( this->InsideOut && theColor == COLOR1 )
-           )
-        {
-          // We don't want this one; it's the wrong side.
-          thisCase += nCellPts;
-          continue;
-        }
-
-        int   shapeIds[8];
-        for ( int p = 0; p < nCellPts; p ++ )
-        {
-          unsigned char pntIndex = *thisCase ++;
-
-          if ( pntIndex <= P7 )
-          {
-            // We know pt P0 must be >P0 since we already
-            // assume P0 == 0.  This is why we do not
-            // bother subtracting P0 from pt here.
-            shapeIds[p] = pntIndxs[ pntIndex ];
-          }
-          else
-          if ( pntIndex >= EA && pntIndex <= EL )
-          {
-            int  pt1Index = edgeVtxs[ pntIndex-EA ][0];
-            int  pt2Index = edgeVtxs[ pntIndex-EA ][1];
-            if ( pt2Index < pt1Index )
-            {
-              int temp = pt2Index;
-              pt2Index = pt1Index;
-              pt1Index = temp;
-            }
-            double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
-            double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
-            double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
-
-            int    pntIndx1 = pntIndxs[ pt1Index ];
-            int    pntIndx2 = pntIndxs[ pt2Index ];
-
-            shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-          }
-          else
-          if ( pntIndex >= N0 && pntIndex <= N3 )
-          {
-            shapeIds[p] = intrpIds[ pntIndex - N0 ];
-          }
-          else
-          {
-            vtkErrorMacro( << "An invalid output point value was found "
-                           << "in the ClipCases." << endl );
-          }
-        }
-
-        switch ( theShape )
-        {
-          case ST_HEX:
-            visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
-                                 shapeIds[2], shapeIds[3], shapeIds[4],
-                                 shapeIds[5], shapeIds[6], shapeIds[7] );
-            break;
-
-          case ST_WDG:
-            visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
-                                   shapeIds[3], shapeIds[4], shapeIds[5] );
-            break;
-
-          case ST_PYR:
-            visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
-                                     shapeIds[2], shapeIds[3], shapeIds[4] );
-            break;
-
-          case ST_TET:
-            visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
-                                 shapeIds[2], shapeIds[3] );
-            break;
-
-          case ST_QUA:
-            visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
-                                  shapeIds[2], shapeIds[3] );
-            break;
-
-          case ST_TRI:
-            visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
-            break;
-
-          case ST_LIN:
-            visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
-            break;
-
-          case ST_VTX:
-            visItVFV->AddVertex( i, shapeIds[0] );
-            break;
-
-          case ST_PNT:
-            intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
-                                             ( nCellPts, shapeIds );
-            break;
-        }
-      }
-
-      edgeVtxs = nullptr;
-      thisCase = nullptr;
+        specials->GetCellData()
+                ->CopyAllocate( unstruct->GetCellData(), numCells );
     }
-    else if (cellType == VTK_POLYHEDRON)
+    if ( cellType == VTK_POLYHEDRON )
     {
-      if ( numCants == 0 )
-      {
-          specials->GetCellData()
-                  ->CopyAllocate( unstruct->GetCellData(), numCells );
-      }
       vtkIdType nfaces, *facePtIds;
       unstruct->GetFaceStream(i, nfaces, facePtIds);
       specials->InsertNextCell(cellType, nfaces, facePtIds);
-      specials->GetCellData()
-              ->CopyData( unstruct->GetCellData(), i, numCants );
-      numCants ++;
     }
     else
     {
-      if ( numCants == 0 )
-      {
-          specials->GetCellData()
-                  ->CopyAllocate( unstruct->GetCellData(), numCells );
-      }
+      vtkIdType * pntIndxs = nullptr;
+      unstruct->GetCellPoints( i, numbPnts, pntIndxs );
       specials->InsertNextCell( cellType, numbPnts, pntIndxs );
-      specials->GetCellData()
-              ->CopyData( unstruct->GetCellData(), i, numCants );
-      numCants ++;
     }
-
-    pntIndxs = nullptr;
+    specials->GetCellData()
+            ->CopyData( unstruct->GetCellData(), i, numCants );
+    numCants ++;
   }
 
   int         toDelete = 0;
@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetSurfaceFilterThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkDataSetSurfaceFilter extracts the expected faces of an
+// unstructured grid of hexahedra, voxels and wedges, and that the threaded
+// extraction gives the same output as the sequential face hash. The threaded
+// extraction is called directly, so that it is also checked when vtkSMPTools
+// runs on a single thread.
+
+#include "vtkCellType.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataSetComparison.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstdlib>
+
+// Always use the threaded extraction, whatever the number of threads.
+class vtkThreadedSurfaceFilter : public vtkDataSetSurfaceFilter
+{
+public:
+  static vtkThreadedSurfaceFilter *New();
+  vtkTypeMacro(vtkThreadedSurfaceFilter, vtkDataSetSurfaceFilter);
+
+protected:
+  vtkThreadedSurfaceFilter() {}
+  ~vtkThreadedSurfaceFilter() VTK_OVERRIDE {}
+
+  int UnstructuredGridExecute(vtkDataSet *input,
+                              vtkPolyData *output) VTK_OVERRIDE
+  {
+    return this->ThreadedUnstructuredGridExecute(
+      vtkUnstructuredGrid::SafeDownCast(input), output);
+  }
+
+private:
+  vtkThreadedSurfaceFilter(const vtkThreadedSurfaceFilter&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkThreadedSurfaceFilter&) VTK_DELETE_FUNCTION;
+};
+
+vtkStandardNewMacro(vtkThreadedSurfaceFilter);
+
+namespace
+{
+
+const int Resolution = 12;
+
+vtkSmartPointer<vtkDataSet> Surface(vtkDataSetSurfaceFilter *surface,
+                                    vtkUnstructuredGrid *input,
+                                    int numberOfThreads)
+{
+  surface->SetInputData(input);
+  surface->PassThroughPointIdsOn();
+  surface->PassThroughCellIdsOn();
+  return vtkTest::UpdateWithThreads(surface, numberOfThreads);
+}
+
+vtkIdType PointId(int i, int j, int k)
+{
+  return i + (Resolution + 1) * (j + (Resolution + 1) * k);
+}
+
+} // end anon namespace
+
+int TestDataSetSurfaceFilterThreads(int, char *[])
+{
+  vtkSMPTools::Initialize(4);
+
+  // A block of cubes. The cubes of every third column are split into two
+  // wedges, which stack up, so their triangles are only on the top and the
+  // bottom of the block. The other cubes are hexahedra or voxels.
+  vtkNew<vtkUnstructuredGrid> grid;
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k <= Resolution; ++k)
+  {
+    for (int j = 0; j <= Resolution; ++j)
+    {
+      for (int i = 0; i <= Resolution; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+  grid->SetPoints(points.GetPointer());
+  grid->Allocate();
+  vtkIdType numWedgeColumns = 0;
+  for (int k = 0; k < Resolution; ++k)
+  {
+    for (int j = 0; j < Resolution; ++j)
+    {
+      for (int i = 0; i < Resolution; ++i)
+      {
+        vtkIdType p[8] = {
+          PointId(i, j, k), PointId(i + 1, j, k),
+          PointId(i + 1, j + 1, k), PointId(i, j + 1, k),
+          PointId(i, j, k + 1), PointId(i + 1, j, k + 1),
+          PointId(i + 1, j + 1, k + 1), PointId(i, j + 1, k + 1) };
+        int kind = (i + 2 * j) % 3;
+        if (kind == 0)
+        {
+          grid->InsertNextCell(VTK_HEXAHEDRON, 8, p);
+        }
+        else if (kind == 1)
+        {
+          vtkIdType voxel[8] = { p[0], p[1], p[3], p[2],
+                                 p[4], p[5], p[7], p[6] };
+          grid->InsertNextCell(VTK_VOXEL, 8, voxel);
+        }
+        else
+        {
+          vtkIdType wedge0[6] = { p[0], p[1], p[2], p[4], p[5], p[6] };
+          vtkIdType wedge1[6] = { p[0], p[2], p[3], p[4], p[6], p[7] };
+          grid->InsertNextCell(VTK_WEDGE, 6, wedge0);
+          grid->InsertNextCell(VTK_WEDGE, 6, wedge1);
+          numWedgeColumns += k == 0 ? 1 : 0;
+        }
+      }
+    }
+  }
+  // A vertex and a triangle on their own.
+  vtkIdType vertex = PointId(0, 0, 0);
+  grid->InsertNextCell(VTK_VERTEX, 1, &vertex);
+  vtkIdType triangle[3] = { PointId(0, 0, 0), PointId(Resolution, 0, 0),
+                            PointId(0, Resolution, Resolution) };
+  grid->InsertNextCell(VTK_TRIANGLE, 3, triangle);
+
+  // The face hash, on a single thread, is the reference.
+  int errors = 0;
+  vtkNew<vtkDataSetSurfaceFilter> hash;
+  vtkNew<vtkThreadedSurfaceFilter> threaded;
+  vtkSmartPointer<vtkDataSet> serial =
+    Surface(hash.GetPointer(), grid.GetPointer(), 1);
+  vtkIdType numSidePts = (Resolution + 1) * (Resolution + 1) * 2 +
+    (Resolution - 1) * 4 * Resolution;
+  vtkIdType numPolys = 6 * Resolution * Resolution + 2 * numWedgeColumns + 1;
+  vtkPolyData *polys = vtkPolyData::SafeDownCast(serial);
+  if (polys->GetNumberOfPoints() != numSidePts ||
+      polys->GetNumberOfPolys() != numPolys ||
+      polys->GetNumberOfVerts() != 1)
+  {
+    cerr << "Expected " << numSidePts << " points and " << numPolys
+         << " polygons, got " << polys->GetNumberOfPoints() << " points and "
+         << polys->GetNumberOfPolys() << " polygons\n";
+    ++errors;
+  }
+  for (int threads = 1; threads <= 4; threads += 3)
+  {
+    if (!vtkTest::SameDataSets(
+           serial, Surface(threaded.GetPointer(), grid.GetPointer(), threads)))
+    {
+      cerr << "Threaded extraction on " << threads << " threads differs\n";
+      ++errors;
+    }
+  }
+
+  // The same with the cells stored with offsets.
+  grid->GetCells()->SetStorageToOffsets();
+  if (!vtkTest::SameDataSets(
+         serial, Surface(threaded.GetPointer(), grid.GetPointer(), 4)))
+  {
+    cerr << "Threaded extraction with offsets differs\n";
+    ++errors;
+  }
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
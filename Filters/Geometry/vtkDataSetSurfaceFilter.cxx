@@ -21,6 +21,7 @@
 #include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
 #include "vtkHexahedron.h"
+#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -31,6 +32,9 @@
 #include "vtkPolyData.h"
 #include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGridGeometryFilter.h"
@@ -47,6 +51,9 @@
 #include "vtkStructuredData.h"
 
 #include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
 #include <vtksys/hash_map.hxx>
 
 #include <cassert>
@@ -1505,6 +1512,16 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
     input = tempInput;
     cellIter = vtkSmartPointer<vtkCellIterator>::Take(input->NewCellIterator());
   }
+  else
+  {
+    // Grids made of the common linear cells are processed with several
+    // threads.
+    vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(input);
+    if (grid && this->CanExecuteInParallel(grid))
+    {
+      return this->ThreadedUnstructuredGridExecute(grid, output);
+    }
+  }
 
   vtkUnsignedCharArray* ghosts = input->GetPointGhostArray();
   vtkCellArray *newVerts;
@@ -2180,6 +2197,1085 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
   return 1;
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+
+// The cells, and then the output items, are processed in batches of
+// consecutive ids.
+const vtkIdType vtkSurfaceBatchSize = 1024;
+
+// The output items of the threaded extraction, in their order: the vertices,
+// the lines, and the polygons (the 2D cells, then the faces of the 3D cells
+// that are not shared).
+enum
+{
+  VTK_SURFACE_VERTS = 0,
+  VTK_SURFACE_LINES,
+  VTK_SURFACE_POLYS,
+  VTK_SURFACE_FACES
+};
+
+// The faces inserted into the hash for each 3D cell type, in the order of
+// UnstructuredGridExecute(), each one ended by -1.
+const int vtkSurfaceTetraFaces[4][7] = {
+  {0,1,3,-1}, {0,2,1,-1}, {0,3,2,-1}, {1,2,3,-1} };
+const int vtkSurfaceHexahedronFaces[6][7] = {
+  {0,1,5,4,-1}, {0,3,2,1,-1}, {0,4,7,3,-1},
+  {1,2,6,5,-1}, {2,3,7,6,-1}, {4,5,6,7,-1} };
+const int vtkSurfaceVoxelFaces[6][7] = {
+  {0,1,5,4,-1}, {0,2,3,1,-1}, {0,4,6,2,-1},
+  {1,3,7,5,-1}, {2,6,7,3,-1}, {4,5,7,6,-1} };
+const int vtkSurfacePentagonalPrismFaces[7][7] = {
+  {0,1,6,5,-1}, {1,2,7,6,-1}, {2,3,8,7,-1}, {3,4,9,8,-1}, {4,0,5,9,-1},
+  {0,1,2,3,4,-1}, {5,6,7,8,9,-1} };
+const int vtkSurfaceHexagonalPrismFaces[8][7] = {
+  {0,1,7,6,-1}, {1,2,8,7,-1}, {2,3,9,8,-1}, {3,4,10,9,-1}, {4,5,11,10,-1},
+  {5,0,6,11,-1}, {0,1,2,3,4,5,-1}, {6,7,8,9,10,11,-1} };
+
+//----------------------------------------------------------------------------
+// The output items a cell type produces, or -1 if the threaded extraction
+// does not handle it.
+int vtkSurfaceGetSection(int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_VERTEX:
+    case VTK_POLY_VERTEX:
+      return VTK_SURFACE_VERTS;
+    case VTK_LINE:
+    case VTK_POLY_LINE:
+      return VTK_SURFACE_LINES;
+    case VTK_TRIANGLE:
+    case VTK_QUAD:
+    case VTK_POLYGON:
+    case VTK_PIXEL:
+    case VTK_TRIANGLE_STRIP:
+      return VTK_SURFACE_POLYS;
+    case VTK_TETRA:
+    case VTK_HEXAHEDRON:
+    case VTK_VOXEL:
+    case VTK_WEDGE:
+    case VTK_PYRAMID:
+    case VTK_PENTAGONAL_PRISM:
+    case VTK_HEXAGONAL_PRISM:
+      return VTK_SURFACE_FACES;
+    default:
+      return -1;
+  }
+}
+
+//----------------------------------------------------------------------------
+// Get the faces of a 3D cell type and return their number. The wedges and
+// pyramids use the faces of vtkCell::GetFace().
+int vtkSurfaceGetFaces(int cellType, const int **faces)
+{
+  int numFaces = 0;
+  switch (cellType)
+  {
+    case VTK_TETRA:
+      for ( ; numFaces < 4; numFaces++)
+      {
+        faces[numFaces] = vtkSurfaceTetraFaces[numFaces];
+      }
+      break;
+    case VTK_HEXAHEDRON:
+      for ( ; numFaces < 6; numFaces++)
+      {
+        faces[numFaces] = vtkSurfaceHexahedronFaces[numFaces];
+      }
+      break;
+    case VTK_VOXEL:
+      for ( ; numFaces < 6; numFaces++)
+      {
+        faces[numFaces] = vtkSurfaceVoxelFaces[numFaces];
+      }
+      break;
+    case VTK_WEDGE:
+      for ( ; numFaces < 5; numFaces++)
+      {
+        faces[numFaces] = vtkWedge::GetFaceArray(numFaces);
+      }
+      break;
+    case VTK_PYRAMID:
+      for ( ; numFaces < 5; numFaces++)
+      {
+        faces[numFaces] = vtkPyramid::GetFaceArray(numFaces);
+      }
+      break;
+    case VTK_PENTAGONAL_PRISM:
+      for ( ; numFaces < 7; numFaces++)
+      {
+        faces[numFaces] = vtkSurfacePentagonalPrismFaces[numFaces];
+      }
+      break;
+    case VTK_HEXAGONAL_PRISM:
+      for ( ; numFaces < 8; numFaces++)
+      {
+        faces[numFaces] = vtkSurfaceHexagonalPrismFaces[numFaces];
+      }
+      break;
+  }
+  return numFaces;
+}
+
+//----------------------------------------------------------------------------
+inline int vtkSurfaceGetFaceSize(const int *face)
+{
+  int npts = 0;
+  while (face[npts] >= 0)
+  {
+    npts++;
+  }
+  return npts;
+}
+
+//----------------------------------------------------------------------------
+// Rotate the points of a face like InsertTriInHash(), InsertQuadInHash()
+// and InsertPolygonInHash() do. The first point is the bin of the face.
+void vtkSurfaceOrderFace(const vtkIdType *pts, int npts, vtkIdType *face)
+{
+  int first = 0;
+  if (npts == 3)
+  {
+    if (pts[1] < pts[0] && pts[1] < pts[2])
+    {
+      first = 1;
+    }
+    else if (pts[2] < pts[0] && pts[2] < pts[1])
+    {
+      first = 2;
+    }
+  }
+  else if (npts == 4)
+  {
+    if (pts[1] < pts[0] && pts[1] < pts[2] && pts[1] < pts[3])
+    {
+      first = 1;
+    }
+    else if (pts[2] < pts[0] && pts[2] < pts[1] && pts[2] < pts[3])
+    {
+      first = 2;
+    }
+    else if (pts[3] < pts[0] && pts[3] < pts[1] && pts[3] < pts[2])
+    {
+      first = 3;
+    }
+  }
+  else
+  {
+    for (int i = 1; i < npts; i++)
+    {
+      if (pts[i] < pts[first])
+      {
+        first = i;
+      }
+    }
+  }
+  for (int i = 0; i < npts; i++)
+  {
+    face[i] = pts[(first + i) % npts];
+  }
+}
+
+//----------------------------------------------------------------------------
+// Whether two faces of the same bin match in the hash.
+bool vtkSurfaceSameFaces(const vtkIdType *f, vtkIdType n,
+                         const vtkIdType *g, vtkIdType m)
+{
+  if (n != m)
+  {
+    return false;
+  }
+  if (n == 3)
+  {
+    return (f[1] == g[1] && f[2] == g[2]) || (f[1] == g[2] && f[2] == g[1]);
+  }
+  if (n == 4)
+  {
+    return f[2] == g[2] &&
+      ((f[1] == g[1] && f[3] == g[3]) || (f[1] == g[3] && f[3] == g[1]));
+  }
+  if (f[1] == g[1])
+  {
+    for (vtkIdType i = 2; i < n; i++)
+    {
+      if (f[i] != g[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+  for (vtkIdType i = 1; i < n; i++)
+  {
+    if (f[n-i] != g[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+inline void vtkSurfaceAtomicMin(std::atomic<vtkIdType>& value,
+                                vtkIdType candidate)
+{
+  vtkIdType current = value.load(std::memory_order_relaxed);
+  while (candidate < current &&
+         !value.compare_exchange_weak(current, candidate,
+                                      std::memory_order_relaxed))
+  {
+  }
+}
+
+//----------------------------------------------------------------------------
+// A face of a 3D cell is referred to by the cell id times 8 plus its index
+// in the cell, which also orders the faces like the hash insertions.
+const int vtkSurfaceMaxFaces = 8;
+
+//----------------------------------------------------------------------------
+// Get the points of a face of a 3D cell, in the order of the face hash.
+int vtkSurfaceGetFace(vtkUnstructuredGrid *input, const unsigned char *types,
+                      vtkIdType face, vtkIdList *cellPts, vtkIdType *facePts)
+{
+  vtkIdType cellId = face / vtkSurfaceMaxFaces;
+  const int *faces[vtkSurfaceMaxFaces];
+  vtkSurfaceGetFaces(types[cellId], faces);
+  const int *cellFace = faces[face % vtkSurfaceMaxFaces];
+  vtkIdType npts;
+  const vtkIdType *pts;
+  input->GetCellPoints(cellId, npts, pts, cellPts);
+  vtkIdType unordered[12];
+  int numFacePts = vtkSurfaceGetFaceSize(cellFace);
+  for (int i = 0; i < numFacePts; i++)
+  {
+    unordered[i] = pts[cellFace[i]];
+  }
+  vtkSurfaceOrderFace(unordered, numFacePts, facePts);
+  return numFacePts;
+}
+
+//----------------------------------------------------------------------------
+// Count the items and the connectivity entries each batch of cells adds to
+// the verts, lines and polys, and the faces of the 3D cells in each bin.
+struct vtkSurfaceCountItems
+{
+  vtkUnstructuredGrid *Input;
+  const unsigned char *Types;
+  vtkIdType NumberOfCells;
+  vtkIdType *BatchItems;
+  vtkIdType *BatchConnectivity;
+  std::atomic<vtkIdType> *BinSizes;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    const int *faces[vtkSurfaceMaxFaces];
+    vtkIdType facePts[12];
+    for ( ; batch < endBatch; batch++)
+    {
+      vtkIdType *items = this->BatchItems + batch * VTK_SURFACE_FACES;
+      vtkIdType *conn = this->BatchConnectivity + batch * VTK_SURFACE_FACES;
+      std::fill_n(items, VTK_SURFACE_FACES, 0);
+      std::fill_n(conn, VTK_SURFACE_FACES, 0);
+      vtkIdType cellId = batch * vtkSurfaceBatchSize;
+      vtkIdType endCellId =
+        std::min(cellId + vtkSurfaceBatchSize, this->NumberOfCells);
+      for ( ; cellId < endCellId; cellId++)
+      {
+        int cellType = this->Types[cellId];
+        int section = vtkSurfaceGetSection(cellType);
+        this->Input->GetCellPoints(cellId, npts, pts, cellPts);
+        if (section == VTK_SURFACE_FACES)
+        {
+          int numFaces = vtkSurfaceGetFaces(cellType, faces);
+          for (int j = 0; j < numFaces; j++)
+          {
+            int numFacePts = vtkSurfaceGetFaceSize(faces[j]);
+            for (int i = 0; i < numFacePts; i++)
+            {
+              facePts[i] = pts[faces[j][i]];
+            }
+            vtkSurfaceOrderFace(facePts, numFacePts, facePts);
+            this->BinSizes[facePts[0]].fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+        else if (cellType == VTK_TRIANGLE_STRIP)
+        {
+          // A strip becomes triangles. Like in UnstructuredGridExecute(), a
+          // strip of two points adds its points but no cell.
+          if (npts > 2)
+          {
+            items[section] += npts - 2;
+            conn[section] += 4 * (npts - 2);
+          }
+          else if (npts == 2)
+          {
+            items[section]++;
+            conn[section] += 3;
+          }
+        }
+        else
+        {
+          items[section]++;
+          conn[section] += npts + 1;
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Write the items of the vertices, lines and 2D cells from the offsets of
+// each batch, and list the faces of the 3D cells in their bins.
+struct vtkSurfaceFillItems
+{
+  vtkUnstructuredGrid *Input;
+  const unsigned char *Types;
+  vtkIdType NumberOfCells;
+  const vtkIdType *BatchItems;
+  const vtkIdType *BatchConnectivity;
+  vtkIdType *Connectivity;
+  vtkIdType *Locations;
+  vtkIdType *SourceIds;
+  std::atomic<vtkIdType> *BinEnds;
+  vtkIdType *BinFaces;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void AddItem(vtkIdType& item, vtkIdType& loc, vtkIdType sourceId,
+               vtkIdType npts, const vtkIdType *pts)
+  {
+    this->Locations[item] = loc;
+    this->SourceIds[item++] = sourceId;
+    this->Connectivity[loc++] = npts;
+    for (vtkIdType i = 0; i < npts; i++)
+    {
+      this->Connectivity[loc++] = pts[i];
+    }
+  }
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    const int *faces[vtkSurfaceMaxFaces];
+    vtkIdType facePts[12];
+    for ( ; batch < endBatch; batch++)
+    {
+      vtkIdType items[VTK_SURFACE_FACES];
+      vtkIdType locs[VTK_SURFACE_FACES];
+      std::copy_n(this->BatchItems + batch * VTK_SURFACE_FACES,
+                  VTK_SURFACE_FACES, items);
+      std::copy_n(this->BatchConnectivity + batch * VTK_SURFACE_FACES,
+                  VTK_SURFACE_FACES, locs);
+      vtkIdType cellId = batch * vtkSurfaceBatchSize;
+      vtkIdType endCellId =
+        std::min(cellId + vtkSurfaceBatchSize, this->NumberOfCells);
+      for ( ; cellId < endCellId; cellId++)
+      {
+        int cellType = this->Types[cellId];
+        int section = vtkSurfaceGetSection(cellType);
+        this->Input->GetCellPoints(cellId, npts, pts, cellPts);
+        if (section == VTK_SURFACE_FACES)
+        {
+          int numFaces = vtkSurfaceGetFaces(cellType, faces);
+          for (int j = 0; j < numFaces; j++)
+          {
+            int numFacePts = vtkSurfaceGetFaceSize(faces[j]);
+            for (int i = 0; i < numFacePts; i++)
+            {
+              facePts[i] = pts[faces[j][i]];
+            }
+            vtkSurfaceOrderFace(facePts, numFacePts, facePts);
+            vtkIdType pos = this->BinEnds[facePts[0]].fetch_add(
+              1, std::memory_order_relaxed);
+            this->BinFaces[pos] = cellId * vtkSurfaceMaxFaces + j;
+          }
+          continue;
+        }
+        vtkIdType& item = items[section];
+        vtkIdType& loc = locs[section];
+        if (cellType == VTK_PIXEL)
+        {
+          vtkIdType quad[4] = { pts[0], pts[1], pts[3], pts[2] };
+          this->AddItem(item, loc, cellId, 4, quad);
+        }
+        else if (cellType == VTK_TRIANGLE_STRIP)
+        {
+          if (npts > 2)
+          {
+            // Change strips to triangles so we do not have to worry about
+            // order.
+            int toggle = 0;
+            vtkIdType ptIds[3] = { pts[0], pts[1], 0 };
+            for (vtkIdType i = 2; i < npts; i++)
+            {
+              ptIds[2] = pts[i];
+              this->AddItem(item, loc, cellId, 3, ptIds);
+              ptIds[toggle] = ptIds[2];
+              toggle = !toggle;
+            }
+          }
+          else if (npts == 2)
+          {
+            this->AddItem(item, loc, -1, 2, pts);
+          }
+        }
+        else
+        {
+          this->AddItem(item, loc, cellId, npts, pts);
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Put the faces of each bin in insertion order, and flag those that no other
+// face of the bin matches: they are on the boundary. Like in the hash
+// traversal, a boundary face whose points are all duplicate ghosts, or one
+// of them hidden, adds its points but no cell: it is flagged as hidden.
+struct vtkSurfaceFindBoundaryFaces
+{
+  vtkUnstructuredGrid *Input;
+  const unsigned char *Types;
+  const std::atomic<vtkIdType> *BinEnds;
+  const unsigned char *Ghosts;
+  vtkIdType *BinFaces;
+  unsigned char *Boundary;
+  unsigned char *Hidden;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > BinPts;
+
+  void operator()(vtkIdType bin, vtkIdType endBin)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    std::vector<vtkIdType>& binPts = this->BinPts.Local();
+    for ( ; bin < endBin; bin++)
+    {
+      vtkIdType begin =
+        bin > 0 ? this->BinEnds[bin-1].load(std::memory_order_relaxed) : 0;
+      vtkIdType end = this->BinEnds[bin].load(std::memory_order_relaxed);
+      vtkIdType numBinFaces = end - begin;
+      if (numBinFaces == 0)
+      {
+        continue;
+      }
+      vtkIdType *binFaces = this->BinFaces + begin;
+      std::sort(binFaces, binFaces + numBinFaces);
+
+      // The points of each face, its size first.
+      binPts.resize(numBinFaces * 13);
+      for (vtkIdType i = 0; i < numBinFaces; i++)
+      {
+        vtkIdType *face = &binPts[i * 13];
+        face[0] = vtkSurfaceGetFace(this->Input, this->Types, binFaces[i],
+                                    cellPts, face + 1);
+      }
+
+      for (vtkIdType i = 0; i < numBinFaces; i++)
+      {
+        const vtkIdType *face = &binPts[i * 13];
+        bool shared = false;
+        for (vtkIdType j = 0; j < numBinFaces && !shared; j++)
+        {
+          const vtkIdType *other = &binPts[j * 13];
+          shared = j != i &&
+            vtkSurfaceSameFaces(face + 1, face[0], other + 1, other[0]);
+        }
+        this->Boundary[begin + i] = shared ? 0 : 1;
+        this->Hidden[begin + i] = 0;
+        if (shared || !this->Ghosts)
+        {
+          continue;
+        }
+        bool allGhosts = true;
+        bool oneHidden = false;
+        for (vtkIdType k = 1; k <= face[0]; k++)
+        {
+          unsigned char val = this->Ghosts[face[k]];
+          if (!(val & vtkDataSetAttributes::DUPLICATEPOINT))
+          {
+            allGhosts = false;
+          }
+          if (val & vtkDataSetAttributes::HIDDENPOINT)
+          {
+            oneHidden = true;
+          }
+        }
+        this->Hidden[begin + i] = allGhosts || oneHidden ? 1 : 0;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// List the boundary faces in bin order, given the prefix sum of their flags.
+struct vtkSurfaceListBoundaryFaces
+{
+  const vtkIdType *BinFaces;
+  const unsigned char *Boundary;
+  const unsigned char *Hidden;
+  const vtkIdType *BoundaryMap;
+  vtkIdType *BoundaryFaces;
+  vtkIdType *BoundaryCells;
+
+  void operator()(vtkIdType pos, vtkIdType endPos)
+  {
+    for ( ; pos < endPos; pos++)
+    {
+      if (this->Boundary[pos])
+      {
+        vtkIdType face = this->BinFaces[pos];
+        vtkIdType boundaryId = this->BoundaryMap[pos];
+        this->BoundaryFaces[boundaryId] = face;
+        this->BoundaryCells[boundaryId] =
+          this->Hidden[pos] ? -1 : face / vtkSurfaceMaxFaces;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// The output items: the items of the vertices, lines and 2D cells, followed
+// by the boundary faces. Each one has a list of points and the cell it comes
+// from, which is -1 if the item adds its points but no cell.
+struct vtkSurfaceItems
+{
+  vtkUnstructuredGrid *Input;
+  const unsigned char *Types;
+  vtkIdType NumberOfCellItems;
+  const vtkIdType *Connectivity;
+  const vtkIdType *Locations;
+  const vtkIdType *SourceIds;
+  const vtkIdType *BoundaryFaces;
+  const vtkIdType *BoundaryCells;
+
+  // The points of the boundary faces are written to facePts.
+  const vtkIdType *GetPoints(vtkIdType item, vtkIdType& npts,
+                             vtkIdList *cellPts, vtkIdType *facePts) const
+  {
+    if (item < this->NumberOfCellItems)
+    {
+      const vtkIdType *pts = this->Connectivity + this->Locations[item];
+      npts = *pts;
+      return pts + 1;
+    }
+    npts = vtkSurfaceGetFace(this->Input, this->Types,
+      this->BoundaryFaces[item - this->NumberOfCellItems], cellPts, facePts);
+    return facePts;
+  }
+
+  vtkIdType GetSourceId(vtkIdType item) const
+  {
+    return item < this->NumberOfCellItems ? this->SourceIds[item] :
+      this->BoundaryCells[item - this->NumberOfCellItems];
+  }
+};
+
+//----------------------------------------------------------------------------
+// Find the first item using each point.
+struct vtkSurfaceFirstUses
+{
+  const vtkSurfaceItems *Items;
+  std::atomic<vtkIdType> *FirstItems;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType item, vtkIdType endItem)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts, facePts[12];
+    for ( ; item < endItem; item++)
+    {
+      const vtkIdType *pts =
+        this->Items->GetPoints(item, npts, cellPts, facePts);
+      for (vtkIdType i = 0; i < npts; i++)
+      {
+        vtkSurfaceAtomicMin(this->FirstItems[pts[i]], item);
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Number the points first used by each batch of items in the order they are
+// met, and count them.
+struct vtkSurfaceRankPoints
+{
+  const vtkSurfaceItems *Items;
+  vtkIdType NumberOfItems;
+  const std::atomic<vtkIdType> *FirstItems;
+  vtkIdType *Ranks;
+  vtkIdType *BatchCounts;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts, facePts[12];
+    for ( ; batch < endBatch; batch++)
+    {
+      vtkIdType count = 0;
+      vtkIdType item = batch * vtkSurfaceBatchSize;
+      vtkIdType endItem =
+        std::min(item + vtkSurfaceBatchSize, this->NumberOfItems);
+      for ( ; item < endItem; item++)
+      {
+        const vtkIdType *pts =
+          this->Items->GetPoints(item, npts, cellPts, facePts);
+        for (vtkIdType i = 0; i < npts; i++)
+        {
+          vtkIdType ptId = pts[i];
+          if (this->FirstItems[ptId].load(std::memory_order_relaxed) == item &&
+              this->Ranks[ptId] < 0)
+          {
+            this->Ranks[ptId] = count++;
+          }
+        }
+      }
+      this->BatchCounts[batch] = count;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Offset the ranks of the points by the points first used by the previous
+// batches, and list the used points in order.
+struct vtkSurfaceOrderPoints
+{
+  const std::atomic<vtkIdType> *FirstItems;
+  const vtkIdType *BatchOffsets;
+  vtkIdType *Ranks;
+  vtkIdType *Order;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ptId++)
+    {
+      if (this->Ranks[ptId] >= 0)
+      {
+        vtkIdType item = this->FirstItems[ptId].load(std::memory_order_relaxed);
+        this->Ranks[ptId] += this->BatchOffsets[item / vtkSurfaceBatchSize];
+        this->Order[this->Ranks[ptId]] = ptId;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the used points and their attributes.
+struct vtkSurfaceCopyPoints
+{
+  vtkUnstructuredGrid *Input;
+  const vtkIdType *Order;
+  vtkPoints *NewPts;
+  vtkPointData *InPD;
+  vtkPointData *OutPD;
+  vtkIdTypeArray *OriginalPointIds;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for (vtkIdType newId = ptId; newId < endPtId; newId++)
+    {
+      this->Input->GetPoint(this->Order[newId], x);
+      this->NewPts->SetPoint(newId, x);
+      if (this->OriginalPointIds)
+      {
+        this->OriginalPointIds->SetValue(newId, this->Order[newId]);
+      }
+    }
+    this->OutPD->GatherData(this->InPD, this->Order + ptId, ptId,
+                            endPtId - ptId);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Flag the items that add a cell, and count their connectivity entries.
+struct vtkSurfaceCountCells
+{
+  const vtkSurfaceItems *Items;
+  vtkIdType *CellMap;
+  vtkIdType *ConnectivityMap;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType item, vtkIdType endItem)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts, facePts[12];
+    for ( ; item < endItem; item++)
+    {
+      bool isCell = this->Items->GetSourceId(item) >= 0;
+      if (isCell)
+      {
+        this->Items->GetPoints(item, npts, cellPts, facePts);
+      }
+      this->CellMap[item] = isCell ? 1 : 0;
+      this->ConnectivityMap[item] = isCell ? npts + 1 : 0;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Write the items that add a cell to the verts, lines or polys, with the
+// output point ids, given the prefix sums of their cells and connectivity
+// sizes.
+struct vtkSurfaceCopyCells
+{
+  const vtkSurfaceItems *Items;
+  const vtkIdType *SectionEnds;
+  const vtkIdType *CellMap;
+  const vtkIdType *ConnectivityMap;
+  const vtkIdType *Ranks;
+  vtkIdType *Connectivity[VTK_SURFACE_FACES];
+  vtkIdType *SourceIds;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType item, vtkIdType endItem)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkIdType npts, facePts[12];
+    for ( ; item < endItem; item++)
+    {
+      if (this->CellMap[item+1] == this->CellMap[item])
+      {
+        continue;
+      }
+      int section = VTK_SURFACE_VERTS;
+      while (item >= this->SectionEnds[section])
+      {
+        section++;
+      }
+      vtkIdType sectionStart =
+        section == VTK_SURFACE_VERTS ? 0 : this->SectionEnds[section-1];
+      vtkIdType *conn = this->Connectivity[section] +
+        this->ConnectivityMap[item] - this->ConnectivityMap[sectionStart];
+      const vtkIdType *pts =
+        this->Items->GetPoints(item, npts, cellPts, facePts);
+      *conn++ = npts;
+      for (vtkIdType i = 0; i < npts; i++)
+      {
+        conn[i] = this->Ranks[pts[i]];
+      }
+      this->SourceIds[this->CellMap[item]] = this->Items->GetSourceId(item);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the attributes of the cells.
+struct vtkSurfaceCopyCellData
+{
+  const vtkIdType *SourceIds;
+  vtkCellData *InCD;
+  vtkCellData *OutCD;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    this->OutCD->GatherData(this->InCD, this->SourceIds + cellId, cellId,
+                            endCellId - cellId);
+  }
+};
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+bool vtkDataSetSurfaceFilter::CanExecuteInParallel(vtkUnstructuredGrid *input)
+{
+  // On one thread, the face hash is faster.
+  vtkUnsignedCharArray *types = input->GetCellTypesArray();
+  if (vtkSMPTools::GetEstimatedNumberOfThreads() <= 1 || !types ||
+      input->GetNumberOfCells() == 0)
+  {
+    return false;
+  }
+  const unsigned char *cellTypes = types->GetPointer(0);
+  vtkIdType numCells = input->GetNumberOfCells();
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+  {
+    if (vtkSurfaceGetSection(cellTypes[cellId]) < 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// The threaded version of UnstructuredGridExecute() gives the same output.
+// Instead of a hash table with chained bins, the faces of the 3D cells are
+// counted in their bin, then listed in it, and each bin is processed on its
+// own: its faces are put in insertion order, which is the order of the hash
+// traversal, and a face is on the boundary if no other face of the bin
+// matches it. The output points are numbered in the order of their first use
+// by the output items, which is the order GetOutputPointId() meets them in.
+int vtkDataSetSurfaceFilter::ThreadedUnstructuredGridExecute(
+  vtkUnstructuredGrid *input, vtkPolyData *output)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numCells = input->GetNumberOfCells();
+  const unsigned char *types = input->GetCellTypesArray()->GetPointer(0);
+  vtkUnsignedCharArray *ghosts = input->GetPointGhostArray();
+  vtkPointData *inputPD = input->GetPointData();
+  vtkCellData *inputCD = input->GetCellData();
+  vtkPointData *outputPD = output->GetPointData();
+  vtkCellData *outputCD = output->GetCellData();
+
+  // Shallow copy field data not associated with points or cells
+  output->GetFieldData()->ShallowCopy(input->GetFieldData());
+
+  // Count the items of each batch of cells, and turn the counts into the
+  // offsets of the batches: the verts, then the lines, then the polys.
+  // binEnds first counts the faces of each bin.
+  vtkIdType numBatches =
+    (numCells + vtkSurfaceBatchSize - 1) / vtkSurfaceBatchSize;
+  std::vector<vtkIdType> batchItems(numBatches * VTK_SURFACE_FACES);
+  std::vector<vtkIdType> batchConn(numBatches * VTK_SURFACE_FACES);
+  std::atomic<vtkIdType> *binEnds = new std::atomic<vtkIdType>[numPts];
+  vtkSMPTools::Fill(binEnds, binEnds + numPts, vtkIdType(0));
+  vtkSurfaceCountItems countItems;
+  countItems.Input = input;
+  countItems.Types = types;
+  countItems.NumberOfCells = numCells;
+  countItems.BatchItems = batchItems.data();
+  countItems.BatchConnectivity = batchConn.data();
+  countItems.BinSizes = binEnds;
+  vtkSMPTools::For(0, numBatches, countItems);
+
+  vtkIdType sectionEnds[VTK_SURFACE_FACES];
+  vtkIdType numItems = 0, connSize = 0;
+  for (int section = 0; section < VTK_SURFACE_FACES; section++)
+  {
+    for (vtkIdType batch = 0; batch < numBatches; batch++)
+    {
+      vtkIdType index = batch * VTK_SURFACE_FACES + section;
+      std::swap(numItems, batchItems[index]);
+      numItems += batchItems[index];
+      std::swap(connSize, batchConn[index]);
+      connSize += batchConn[index];
+    }
+    sectionEnds[section] = numItems;
+  }
+  // The bins start where the previous ones end. Listing the faces moves
+  // binEnds from the start to the end of their bin.
+  vtkIdType numFaces = vtkSMPTools::ExclusiveScan(
+    binEnds, binEnds + numPts, binEnds, vtkIdType(0));
+
+  std::vector<vtkIdType> connectivity(connSize);
+  std::vector<vtkIdType> locations(numItems);
+  std::vector<vtkIdType> sourceIds(numItems);
+  std::vector<vtkIdType> binFaces(numFaces);
+  vtkSurfaceFillItems fillItems;
+  fillItems.Input = input;
+  fillItems.Types = types;
+  fillItems.NumberOfCells = numCells;
+  fillItems.BatchItems = batchItems.data();
+  fillItems.BatchConnectivity = batchConn.data();
+  fillItems.Connectivity = connectivity.data();
+  fillItems.Locations = locations.data();
+  fillItems.SourceIds = sourceIds.data();
+  fillItems.BinEnds = binEnds;
+  fillItems.BinFaces = binFaces.data();
+  vtkSMPTools::For(0, numBatches, fillItems);
+  this->UpdateProgress(0.25);
+
+  // Keep the faces that are not shared, in bin order.
+  std::vector<unsigned char> boundary(numFaces);
+  std::vector<unsigned char> hidden(numFaces);
+  vtkSurfaceFindBoundaryFaces findBoundary;
+  findBoundary.Input = input;
+  findBoundary.Types = types;
+  findBoundary.BinEnds = binEnds;
+  findBoundary.Ghosts = ghosts ? ghosts->GetPointer(0) : nullptr;
+  findBoundary.BinFaces = binFaces.data();
+  findBoundary.Boundary = boundary.data();
+  findBoundary.Hidden = hidden.data();
+  vtkSMPTools::For(0, numPts, findBoundary);
+  delete [] binEnds;
+
+  std::vector<vtkIdType> boundaryMap(numFaces);
+  vtkIdType numBoundaryFaces = vtkSMPTools::ExclusiveScan(
+    boundary.begin(), boundary.end(), boundaryMap.begin(), vtkIdType(0));
+  std::vector<vtkIdType> boundaryFaces(numBoundaryFaces);
+  std::vector<vtkIdType> boundaryCells(numBoundaryFaces);
+  vtkSurfaceListBoundaryFaces listBoundary;
+  listBoundary.BinFaces = binFaces.data();
+  listBoundary.Boundary = boundary.data();
+  listBoundary.Hidden = hidden.data();
+  listBoundary.BoundaryMap = boundaryMap.data();
+  listBoundary.BoundaryFaces = boundaryFaces.data();
+  listBoundary.BoundaryCells = boundaryCells.data();
+  vtkSMPTools::For(0, numFaces, listBoundary);
+  std::vector<vtkIdType>().swap(binFaces);
+  std::vector<vtkIdType>().swap(boundaryMap);
+  std::vector<unsigned char>().swap(boundary);
+  std::vector<unsigned char>().swap(hidden);
+  this->UpdateProgress(0.5);
+
+  vtkSurfaceItems items;
+  items.Input = input;
+  items.Types = types;
+  items.NumberOfCellItems = numItems;
+  items.Connectivity = connectivity.data();
+  items.Locations = locations.data();
+  items.SourceIds = sourceIds.data();
+  items.BoundaryFaces = boundaryFaces.data();
+  items.BoundaryCells = boundaryCells.data();
+  numItems += numBoundaryFaces;
+  sectionEnds[VTK_SURFACE_POLYS] = numItems;
+
+  // Number the points in the order the items first use them.
+  std::vector<vtkIdType> ranks(numPts, -1);
+  std::vector<vtkIdType> order;
+  {
+    std::atomic<vtkIdType> *firstItems = new std::atomic<vtkIdType>[numPts];
+    vtkSMPTools::Fill(firstItems, firstItems + numPts, VTK_ID_MAX);
+    vtkSurfaceFirstUses firstUses;
+    firstUses.Items = &items;
+    firstUses.FirstItems = firstItems;
+    vtkSMPTools::For(0, numItems, firstUses);
+
+    vtkIdType numItemBatches =
+      (numItems + vtkSurfaceBatchSize - 1) / vtkSurfaceBatchSize;
+    std::vector<vtkIdType> batchOffsets(numItemBatches);
+    vtkSurfaceRankPoints rankPoints;
+    rankPoints.Items = &items;
+    rankPoints.NumberOfItems = numItems;
+    rankPoints.FirstItems = firstItems;
+    rankPoints.Ranks = ranks.data();
+    rankPoints.BatchCounts = batchOffsets.data();
+    vtkSMPTools::For(0, numItemBatches, rankPoints);
+    vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(
+      batchOffsets.begin(), batchOffsets.end(), batchOffsets.begin(),
+      vtkIdType(0));
+
+    order.resize(numNewPts);
+    vtkSurfaceOrderPoints orderPoints;
+    orderPoints.FirstItems = firstItems;
+    orderPoints.BatchOffsets = batchOffsets.data();
+    orderPoints.Ranks = ranks.data();
+    orderPoints.Order = order.data();
+    vtkSMPTools::For(0, numPts, orderPoints);
+    delete [] firstItems;
+  }
+  vtkIdType numNewPts = static_cast<vtkIdType>(order.size());
+
+  // Copy the points and the point data.
+  vtkPoints *newPts = vtkPoints::New();
+  newPts->SetDataType(input->GetPoints()->GetData()->GetDataType());
+  newPts->SetNumberOfPoints(numNewPts);
+  outputPD->CopyGlobalIdsOn();
+  outputPD->CopyAllocate(inputPD, numNewPts);
+  outputPD->SetNumberOfTuples(numNewPts);
+  vtkIdTypeArray *originalPointIds = nullptr;
+  if (this->PassThroughPointIds)
+  {
+    originalPointIds = vtkIdTypeArray::New();
+    originalPointIds->SetName(this->GetOriginalPointIdsName());
+    originalPointIds->SetNumberOfComponents(1);
+    originalPointIds->SetNumberOfTuples(numNewPts);
+  }
+  vtkSurfaceCopyPoints copyPoints;
+  copyPoints.Input = input;
+  copyPoints.Order = order.data();
+  copyPoints.NewPts = newPts;
+  copyPoints.InPD = inputPD;
+  copyPoints.OutPD = outputPD;
+  copyPoints.OriginalPointIds = originalPointIds;
+  vtkSMPTools::For(0, numNewPts, copyPoints);
+  this->UpdateProgress(0.75);
+
+  // Number the items that add a cell, and locate them in the connectivity
+  // of their cell array.
+  std::vector<vtkIdType> cellMap(numItems + 1);
+  std::vector<vtkIdType> connMap(numItems + 1);
+  vtkSurfaceCountCells countCells;
+  countCells.Items = &items;
+  countCells.CellMap = cellMap.data();
+  countCells.ConnectivityMap = connMap.data();
+  vtkSMPTools::For(0, numItems, countCells);
+  vtkIdType numNewCells = vtkSMPTools::ExclusiveScan(
+    cellMap.begin(), cellMap.begin() + numItems, cellMap.begin(),
+    vtkIdType(0));
+  cellMap[numItems] = numNewCells;
+  vtkIdType newConnSize = vtkSMPTools::ExclusiveScan(
+    connMap.begin(), connMap.begin() + numItems, connMap.begin(),
+    vtkIdType(0));
+  connMap[numItems] = newConnSize;
+
+  // Copy the cells, and then their attributes.
+  vtkCellArray *newCells[VTK_SURFACE_FACES];
+  std::vector<vtkIdType> newSourceIds(numNewCells);
+  vtkSurfaceCopyCells copyCells;
+  vtkIdType sectionStart = 0;
+  for (int section = 0; section < VTK_SURFACE_FACES; section++)
+  {
+    vtkIdType sectionEnd = sectionEnds[section];
+    newCells[section] = vtkCellArray::New();
+    copyCells.Connectivity[section] = newCells[section]->WritePointer(
+      cellMap[sectionEnd] - cellMap[sectionStart],
+      connMap[sectionEnd] - connMap[sectionStart]);
+    sectionStart = sectionEnd;
+  }
+  copyCells.Items = &items;
+  copyCells.SectionEnds = sectionEnds;
+  copyCells.CellMap = cellMap.data();
+  copyCells.ConnectivityMap = connMap.data();
+  copyCells.Ranks = ranks.data();
+  copyCells.SourceIds = newSourceIds.data();
+  vtkSMPTools::For(0, numItems, copyCells);
+
+  outputCD->CopyGlobalIdsOn();
+  outputCD->CopyAllocate(inputCD, numNewCells);
+  outputCD->SetNumberOfTuples(numNewCells);
+  vtkSurfaceCopyCellData copyCellData;
+  copyCellData.SourceIds = newSourceIds.data();
+  copyCellData.InCD = inputCD;
+  copyCellData.OutCD = outputCD;
+  vtkSMPTools::For(0, numNewCells, copyCellData);
+
+  if (this->PassThroughCellIds)
+  {
+    vtkIdTypeArray *originalCellIds = vtkIdTypeArray::New();
+    originalCellIds->SetName(this->GetOriginalCellIdsName());
+    originalCellIds->SetNumberOfComponents(1);
+    originalCellIds->SetNumberOfTuples(numNewCells);
+    std::copy(newSourceIds.begin(), newSourceIds.end(),
+              originalCellIds->GetPointer(0));
+    outputCD->AddArray(originalCellIds);
+    originalCellIds->Delete();
+  }
+  if (originalPointIds)
+  {
+    outputPD->AddArray(originalPointIds);
+    originalPointIds->Delete();
+  }
+
+  output->SetPoints(newPts);
+  newPts->Delete();
+  output->SetPolys(newCells[VTK_SURFACE_POLYS]);
+  if (newCells[VTK_SURFACE_VERTS]->GetNumberOfCells() > 0)
+  {
+    output->SetVerts(newCells[VTK_SURFACE_VERTS]);
+  }
+  if (newCells[VTK_SURFACE_LINES]->GetNumberOfCells() > 0)
+  {
+    output->SetLines(newCells[VTK_SURFACE_LINES]);
+  }
+  for (int section = 0; section < VTK_SURFACE_FACES; section++)
+  {
+    newCells[section]->Delete();
+  }
+  output->Squeeze();
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 void vtkDataSetSurfaceFilter::InitializeQuadHash(vtkIdType numPoints)
 {
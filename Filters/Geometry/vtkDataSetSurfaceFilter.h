@@ -21,6 +21,12 @@
  * vtkGeometryFilter.  It only has one option: whether to use triangle strips
  * when the input type is structured.
  *
+ * Unstructured grids made only of vertices, lines, 2D linear cells,
+ * tetrahedra, hexahedra, voxels, wedges, pyramids and prisms are processed
+ * with several threads when vtkSMPTools runs more than one, with the same
+ * output as the sequential face hash. Subclasses that override the hash methods
+ * (InsertQuadInHash() ...) should also override UnstructuredGridExecute().
+ *
  * @sa
  * vtkGeometryFilter vtkStructuredGridGeometryFilter.
 */
@@ -35,6 +41,7 @@ class vtkPointData;
 class vtkPoints;
 class vtkIdTypeArray;
 class vtkStructuredGrid;
+class vtkUnstructuredGrid;
 
 // Helper structure for hashing faces.
 struct vtkFastGeomQuadStruct
@@ -209,6 +216,19 @@ protected:
                         int aAxis, int bAxis, int cAxis,
                         vtkIdType *wholeExt);
 
+  /**
+   * Whether ThreadedUnstructuredGridExecute() handles all the cells of the
+   * input, and more than one thread is available.
+   */
+  bool CanExecuteInParallel(vtkUnstructuredGrid *input);
+
+  /**
+   * The threaded version of UnstructuredGridExecute(), for inputs made of
+   * linear cells of the common types. It does not use the face hash.
+   */
+  int ThreadedUnstructuredGridExecute(vtkUnstructuredGrid *input,
+                                      vtkPolyData *output);
+
   void InitializeQuadHash(vtkIdType numPoints);
   void DeleteQuadHash();
   virtual void InsertQuadInHash(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType d,
@@ -916,6 +916,7 @@ namespace {
         }
       }
     }
+    pData->EditableOn();
     pData->BuildLinks();
 
     // Check the topology of the edges and ensure that it is valid.  If there
@@ -19,9 +19,8 @@
 #include "vtkStaticPointLocator.h"
 #include "vtkPointSet.h"
 #include "vtkPoints.h"
-#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkSMPTools.h"
-#include "vtkSMPThreadLocalObject.h"
 
 
 vtkStandardNewMacro(vtkRadiusOutlierRemoval);
@@ -32,67 +31,32 @@ vtkCxxSetObjectMacro(vtkRadiusOutlierRemoval,Locator,vtkAbstractPointLocator);
 namespace {
 
 //----------------------------------------------------------------------------
-// The threaded core of the algorithm (first pass)
-template <typename T>
+// Mark the points with too few neighbors. The offsets delimit the neighbors
+// of each point, as computed by the batched locator query.
 struct RemoveOutliers
 {
-  const T *Points;
-  vtkAbstractPointLocator *Locator;
-  double Radius;
+  const vtkIdType *Offsets;
   int NumNeighbors;
   vtkIdType *PointMap;
 
-  // Don't want to allocate working arrays on every thread invocation. Thread local
-  // storage lots of new/delete.
-  vtkSMPThreadLocalObject<vtkIdList> PIds;
-
-  RemoveOutliers(T *points, vtkAbstractPointLocator *loc, double radius, int numNei,
-                 vtkIdType *map) : Points(points), Locator(loc), Radius(radius),
-                                   NumNeighbors(numNei), PointMap(map)
-  {
-  }
-
-  // Just allocate a little bit of memory to get started.
-  void Initialize()
+  RemoveOutliers(const vtkIdType *offsets, int numNei, vtkIdType *map) :
+    Offsets(offsets), NumNeighbors(numNei), PointMap(map)
   {
-    vtkIdList*& pIds = this->PIds.Local();
-    pIds->Allocate(128); //allocate some memory
   }
 
   void operator() (vtkIdType ptId, vtkIdType endPtId)
   {
-      const T *p = this->Points + 3*ptId;
+      const vtkIdType *offsets = this->Offsets + ptId;
       vtkIdType *map = this->PointMap + ptId;
-      double x[3];
-      vtkIdList*& pIds = this->PIds.Local();
 
-      for ( ; ptId < endPtId; ++ptId)
+      for ( ; ptId < endPtId; ++ptId, ++offsets)
       {
-        x[0] = static_cast<double>(*p++);
-        x[1] = static_cast<double>(*p++);
-        x[2] = static_cast<double>(*p++);
-
-        this->Locator->FindPointsWithinRadius(this->Radius, x, pIds);
-        vtkIdType numPts = pIds->GetNumberOfIds();
-
         // Keep in mind that The FindPoints method will always return at
         // least one point (itself).
+        vtkIdType numPts = offsets[1] - offsets[0];
         *map++ = ( numPts > this->NumNeighbors ? 1 : -1 );
       }
   }
-
-  void Reduce()
-  {
-  }
-
-  static void Execute(vtkRadiusOutlierRemoval *self, vtkIdType numPts,
-                      T *points, vtkIdType *map)
-  {
-      RemoveOutliers remove(points, self->GetLocator(), self->GetRadius(),
-                            self->GetNumberOfNeighbors(), map);
-      vtkSMPTools::For(0, numPts, remove);
-  }
-
 }; //RemoveOutliers
 
 } //anonymous namespace
@@ -129,14 +93,16 @@ int vtkRadiusOutlierRemoval::FilterPoints(vtkPointSet *input)
   this->Locator->BuildLocator();
 
   // Determine which points, if any, should be removed. We create a map
-  // to keep track. The bulk of the algorithmic work is done in this pass.
+  // to keep track. The bulk of the algorithmic work is done by the batched
+  // locator query, which only counts the neighbors of each point.
   vtkIdType numPts = input->GetNumberOfPoints();
-  void *inPtr = input->GetPoints()->GetVoidPointer(0);
-  switch (input->GetPoints()->GetDataType())
-  {
-    vtkTemplateMacro(RemoveOutliers<VTK_TT>::
-                     Execute(this, numPts, (VTK_TT *)inPtr, this->PointMap));
-  }
+  vtkIdTypeArray *offsets = vtkIdTypeArray::New();
+  this->Locator->FindPointsWithinRadius(this->Radius, input->GetPoints(),
+                                        offsets, nullptr);
+  RemoveOutliers remove(offsets->GetPointer(0), this->NumberOfNeighbors,
+                        this->PointMap);
+  vtkSMPTools::For(0, numPts, remove);
+  offsets->Delete();
 
   return 1;
 }
@@ -9,7 +9,6 @@
 #include "vtkUnstructuredGrid.h"
 #include "vtkStructuredGrid.h"
 #include "vtkPolyData.h"
-#include "vtkCellLinks.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkCompositeDataSet.h"
@@ -146,14 +145,14 @@ int vtkCellDistanceSelector::RequestData( vtkInformation* vtkNotUsed( request ),
         vtkStructuredGrid* sg_input = vtkStructuredGrid::SafeDownCast( input );
         vtkPolyData* pd_input = vtkPolyData::SafeDownCast( input);
 
-        vtkCellLinks * links = nullptr;
+        vtkSmartPointer<vtkIdList> cellIds;
         if ( ug_input )
         {
-          if ( ! ug_input->GetCellLinks() )
+          if ( ! ug_input->GetLinks() )
           {
             ug_input->BuildLinks();
           }
-          links = ug_input->GetCellLinks();
+          cellIds = vtkSmartPointer<vtkIdList>::New();
         }
 
         std::vector<int> flags( numCells, 0 );
@@ -198,11 +197,11 @@ int vtkCellDistanceSelector::RequestData( vtkInformation* vtkNotUsed( request ),
               for ( int k = 0; k < n; ++ k )
               {
                 vtkIdType pid = points[k];
-                int np = links->GetNcells( pid );
-                vtkIdType* cells = links->GetCells( pid );
-                for ( int j = 0; j < np; ++ j )
+                ug_input->GetPointCells( pid, cellIds );
+                vtkIdType np = cellIds->GetNumberOfIds();
+                for ( vtkIdType j = 0; j < np; ++ j )
                 {
-                  vtkIdType cid = cells[j];
+                  vtkIdType cid = cellIds->GetId( j );
                   if( cid >= 0 && cid < numCells )
                   {
                     if ( ! flags[cid] )
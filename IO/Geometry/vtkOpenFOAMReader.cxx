@@ -7175,6 +7175,7 @@ vtkMultiBlockDataSet *vtkOpenFOAMReaderPrivate::MakeBoundaryMesh(
       // links of physical-processor shared points to avoid cracky seams
       // on fixedValue-type boundaries which are noticeable when all the
       // decomposed meshes are appended
+      this->AllBoundaries->EditableOn();
       this->AllBoundaries->BuildLinks();
       for (int pointI = 0; pointI < nAllBoundaryPoints; pointI++)
       {
@@ -7313,6 +7314,30 @@ void vtkOpenFOAMReaderPrivate::MoveBoundaryMesh(
   }
 }
 
+//-----------------------------------------------------------------------------
+// The cells using a point, from the links of an unstructured grid or from a
+// polydata when links is nullptr.
+static void GetMeshPointCells(vtkAbstractCellLinks *links, vtkPolyData *pd,
+    vtkIdType ptId, unsigned short &nCells, vtkIdType *&cells)
+{
+  if (!links)
+  {
+    pd->GetPointCells(ptId, nCells, cells);
+  }
+  else if (links->GetType() == vtkAbstractCellLinks::STATIC_CELL_LINKS)
+  {
+    vtkStaticCellLinks *staticLinks = static_cast<vtkStaticCellLinks *>(links);
+    nCells = staticLinks->GetNcells(ptId);
+    cells = const_cast<vtkIdType *>(staticLinks->GetCells(ptId));
+  }
+  else
+  {
+    vtkCellLinks *cellLinks = static_cast<vtkCellLinks *>(links);
+    nCells = cellLinks->GetNcells(ptId);
+    cells = cellLinks->GetCells(ptId);
+  }
+}
+
 //-----------------------------------------------------------------------------
 // as of now the function does not do interpolation, but do just averaging.
 void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
@@ -7337,10 +7362,10 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
   // do a tedious task
   vtkUnstructuredGrid *ug = vtkUnstructuredGrid::SafeDownCast(mesh);
   vtkPolyData *pd = vtkPolyData::SafeDownCast(mesh);
-  vtkCellLinks *cl = nullptr;
+  vtkAbstractCellLinks *links = nullptr;
   if (ug)
   {
-    cl = ug->GetCellLinks();
+    links = ug->GetLinks();
   }
 
   const int nComponents = iData->GetNumberOfComponents();
@@ -7355,16 +7380,7 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
           ? GetLabelValue(pointList, pointI, use64BitLabels) : pointI;
       unsigned short nCells;
       vtkIdType *cells;
-      if (cl)
-      {
-        const vtkCellLinks::Link &l = cl->GetLink(pI);
-        nCells = l.ncells;
-        cells = l.cells;
-      }
-      else
-      {
-        pd->GetPointCells(pI, nCells, cells);
-      }
+      GetMeshPointCells(links, pd, pI, nCells, cells);
       // use double intermediate variable for precision
       double interpolatedValue = 0.0;
       for (int cellI = 0; cellI < nCells; cellI++)
@@ -7386,16 +7402,7 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
           ? GetLabelValue(pointList, pointI, use64BitLabels) : pointI;
       unsigned short nCells;
       vtkIdType *cells;
-      if (cl)
-      {
-        const vtkCellLinks::Link &l = cl->GetLink(pI);
-        nCells = l.ncells;
-        cells = l.cells;
-      }
-      else
-      {
-        pd->GetPointCells(pI, nCells, cells);
-      }
+      GetMeshPointCells(links, pd, pI, nCells, cells);
       // use double intermediate variables for precision
       const double weight = (nCells ? 1.0 / static_cast<double>(nCells) : 0.0);
       double summedValue0 = 0.0, summedValue1 = 0.0, summedValue2 = 0.0;
@@ -7424,16 +7431,7 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
           ? GetLabelValue(pointList, pointI, use64BitLabels) : pointI;
       unsigned short nCells;
       vtkIdType *cells;
-      if (cl)
-      {
-        const vtkCellLinks::Link &l = cl->GetLink(pI);
-        nCells = l.ncells;
-        cells = l.cells;
-      }
-      else
-      {
-        pd->GetPointCells(pI, nCells, cells);
-      }
+      GetMeshPointCells(links, pd, pI, nCells, cells);
       // use double intermediate variables for precision
       const double weight = (nCells ? 1.0 / static_cast<double>(nCells) : 0.0);
       float *interpolatedValue = &pDataPtr[nComponents * pI];
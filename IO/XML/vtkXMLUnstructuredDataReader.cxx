@@ -23,8 +23,56 @@
 #include "vtkInformation.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include "vtkSmartPointer.h"
+#include "vtkTypeInt32Array.h"
+
+#include <algorithm>
 #include <cassert>
 
+namespace
+{
+// Append cells given by their end offsets and point ids to the offsets
+// storage of outCells, shifting the point ids by startPoint.
+template <typename ArrayT>
+void AppendCells(vtkCellArray* outCells, bool append,
+                 vtkIdType totalNumberOfCells, vtkIdType numberOfCells,
+                 const vtkIdType* cellOffsets, const vtkIdType* cellPoints,
+                 vtkIdType numberOfPoints, vtkIdType startPoint)
+{
+  typedef typename ArrayT::ValueType ValueType;
+  vtkSmartPointer<ArrayT> offsets;
+  vtkSmartPointer<ArrayT> connectivity;
+  if (append)
+  {
+    offsets = static_cast<ArrayT*>(outCells->GetOffsetsArray());
+    connectivity = static_cast<ArrayT*>(outCells->GetConnectivityArray());
+  }
+  else
+  {
+    offsets = vtkSmartPointer<ArrayT>::New();
+    offsets->Allocate(totalNumberOfCells + 1);
+    offsets->InsertNextValue(0);
+    connectivity = vtkSmartPointer<ArrayT>::New();
+  }
+
+  vtkIdType numCells = offsets->GetNumberOfValues() - 1;
+  vtkIdType start = connectivity->GetNumberOfValues();
+  ValueType* optr = offsets->WritePointer(numCells + 1, numberOfCells);
+  for (vtkIdType i = 0; i < numberOfCells; ++i)
+  {
+    optr[i] = static_cast<ValueType>(start + cellOffsets[i]);
+  }
+
+  ValueType* cptr = connectivity->WritePointer(start, numberOfPoints);
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+  {
+    cptr[i] = static_cast<ValueType>(cellPoints[i] + startPoint);
+  }
+
+  outCells->SetData(offsets.GetPointer(), connectivity.GetPointer());
+}
+}
+
 
 //----------------------------------------------------------------------------
 vtkXMLUnstructuredDataReader::vtkXMLUnstructuredDataReader()
@@ -667,38 +715,48 @@ int vtkXMLUnstructuredDataReader::ReadCellArray(vtkIdType numberOfCells,
   }
 
 
-  // Allocate memory in the output connectivity array.
-  vtkIdType curSize = 0;
-  if (this->Piece > this->StartPiece && outCells->GetData())
+  // Append to the cells already read. Refer to BUG #12202 and BUG #12690.
+  // The (this->Piece > this->StartPiece) check ensures that when we are
+  // reading multiple timesteps, we don't end up appending to existing cell
+  // arrays infinitely. An earlier version of the fix assumed that
+  // vtkXMLUnstructuredDataReader read only 1 piece at a time, which was
+  // incorrect (and hence BUG #12690).
+  bool append = this->Piece > this->StartPiece &&
+    outCells->GetNumberOfCells() > 0;
+
+  // Store the cells as offsets and connectivity, using 32-bit integers when
+  // the point ids and the connectivity size fit.
+  bool use32 = !append ||
+    outCells->GetStorage() == vtkCellArray::OFFSETS32_STORAGE;
+  if (use32)
   {
-    // Refer to BUG #12202 and BUG #12690. The (this->Piece > this->StartPiece)
-    // check ensures that when we are reading multiple timesteps, we don't end
-    // up appending to existing cell arrays infinitely. An earlier version of
-    // the fix assumed that vtkXMLUnstructuredDataReader read only 1 piece at a
-    // time, which was incorrect (and hence  BUG #12690).
-    curSize = outCells->GetData()->GetNumberOfTuples();
+    vtkIdType connectivitySize = cpLength +
+      (append ? outCells->GetNumberOfConnectivityIds() : 0);
+    vtkIdType* cpts = cellPoints->GetPointer(0);
+    vtkIdType maxId = cpLength > 0 ? *std::max_element(cpts, cpts + cpLength)
+      : 0;
+    use32 = VTK_SIZEOF_ID_TYPE == 8 &&
+      connectivitySize <= VTK_TYPE_INT32_MAX &&
+      maxId + this->StartPoint <= VTK_TYPE_INT32_MAX;
+  }
+  if (append && !use32)
+  {
+    outCells->SetStorageToOffsets();
   }
 
-  vtkIdType newSize = curSize+numberOfCells+cellPoints->GetNumberOfTuples();
-  vtkIdType* cptr = outCells->WritePointer(totalNumberOfCells, newSize);
-  cptr += curSize;
-
-  // Copy the connectivity data.
-  vtkIdType previousOffset = 0;
-  for(i=0; i < numberOfCells; ++i)
+  if (use32)
   {
-    vtkIdType length = cellOffsets->GetValue(i)-previousOffset;
-    *cptr++ = length;
-    vtkIdType* sptr = cellPoints->GetPointer(previousOffset);
-    // Copy the point indices, but increment them for the appended
-    // version's index.
-    vtkIdType j;
-    for(j=0;j < length; ++j)
-    {
-      cptr[j] = sptr[j]+this->StartPoint;
-    }
-    cptr += length;
-    previousOffset += length;
+    AppendCells<vtkTypeInt32Array>(outCells, append, totalNumberOfCells,
+                                   numberOfCells, coffset,
+                                   cellPoints->GetPointer(0), cpLength,
+                                   this->StartPoint);
+  }
+  else
+  {
+    AppendCells<vtkIdTypeArray>(outCells, append, totalNumberOfCells,
+                                numberOfCells, coffset,
+                                cellPoints->GetPointer(0), cpLength,
+                                this->StartPoint);
   }
 
   cellPoints->Delete();
@@ -273,31 +273,25 @@ int vtkXMLUnstructuredGridReader::ReadPieceData()
     }
   }
 
-  // Construct the cell locations.
+  // Construct the cell locations from the sizes of the cells, which are
+  // read in offsets storage.
   vtkIdTypeArray* locations = output->GetCellLocationsArray();
   vtkIdType* locs = locations->GetPointer(this->StartCell);
-  vtkIdTypeArray* cellArrayData = output->GetCells()->GetData();
+  vtkCellArray* outCells = output->GetCells();
   vtkIdType startLoc = 0;
   if (this->StartCell > 0)
   {
-    // this set the startLoc to point to the location in the cellArray where the
-    // cell for this piece will start writing.
-
-    // Id for last written cell:
+    // startLoc = location-of-last-written-cell + 1 (for the count of items
+    //            in the cell) + (number of items in the cell).
     vtkIdType lastWrittenCell = this->StartCell - 1;
-    vtkIdType locationOfLastWrittenCell = locations->GetValue(lastWrittenCell);
-    startLoc = locationOfLastWrittenCell + 1 +
-      cellArrayData->GetValue(locationOfLastWrittenCell);
-    // startLoc = location-of-last-written-cell + 1 (for put the count for items in the cell)
-    //            + (number of items in the cell).
+    startLoc = locations->GetValue(lastWrittenCell) + 1 +
+      outCells->GetCellSize(lastWrittenCell);
   }
-  vtkIdType* begin = output->GetCells()->GetData()->GetPointer(startLoc);
-  vtkIdType* cur = begin;
   vtkIdType i;
   for(i=0; i < this->NumberOfCells[this->Piece]; ++i)
   {
-    locs[i] = startLoc + cur - begin;
-    cur += *cur + 1;
+    locs[i] = startLoc;
+    startLoc += outCells->GetCellSize(this->StartCell + i) + 1;
   }
 
   // Set the range of progress for the cell types.
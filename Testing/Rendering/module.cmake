@@ -1,11 +1,11 @@
 vtk_module(vtkTestingRendering
   DEPENDS
     vtkCommonCore
+    vtkCommonDataModel
+    vtkCommonExecutionModel
     vtkRenderingCore
     vtkTestingCore
   PRIVATE_DEPENDS
-    vtkCommonDataModel
-    vtkCommonExecutionModel
     vtkCommonSystem
     vtkIOImage
     vtkImagingCore
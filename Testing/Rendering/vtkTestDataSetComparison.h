@@ -0,0 +1,207 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTestDataSetComparison.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Helpers to compare the outputs of a filter exactly, e.g. a threaded run
+// and a sequential one. The values are compared bit for bit, and the points
+// and cells must be in the same order.
+
+#ifndef vtkTestDataSetComparison_h
+#define vtkTestDataSetComparison_h
+
+#include "vtkAlgorithm.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkFieldData.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+#include <cstring> // Needed for strcmp
+
+namespace vtkTest
+{
+
+/**
+ * Return true if both arrays are null, or have the same values.
+ */
+inline bool SameArrays(vtkDataArray *a, vtkDataArray *b)
+{
+  if (!a || !b)
+  {
+    return a == b;
+  }
+  if (a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+  {
+    for (int j = 0; j < a->GetNumberOfComponents(); ++j)
+    {
+      if (a->GetComponent(i, j) != b->GetComponent(i, j))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Return true if both cell arrays list the same cells, whatever their
+ * storage.
+ */
+inline bool SameCells(vtkCellArray *a, vtkCellArray *b)
+{
+  if (!a || !b)
+  {
+    return a == b;
+  }
+  if (a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  vtkIdType nptsA, nptsB;
+  vtkIdType *ptsA, *ptsB;
+  a->InitTraversal();
+  b->InitTraversal();
+  while (a->GetNextCell(nptsA, ptsA) && b->GetNextCell(nptsB, ptsB))
+  {
+    if (nptsA != nptsB)
+    {
+      return false;
+    }
+    for (vtkIdType i = 0; i < nptsA; ++i)
+    {
+      if (ptsA[i] != ptsB[i])
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Return true if both containers have the same data arrays, with the same
+ * names, in the same order. The other arrays (e.g. string arrays) are not
+ * compared.
+ */
+inline bool SameFieldData(vtkFieldData *a, vtkFieldData *b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    const char *nameA = a->GetArrayName(i);
+    const char *nameB = b->GetArrayName(i);
+    if ((!nameA || !nameB) ? nameA != nameB : strcmp(nameA, nameB) != 0)
+    {
+      return false;
+    }
+    if (!SameArrays(a->GetArray(i), b->GetArray(i)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Return true if both datasets have the same points, the same cells and
+ * the same point and cell data arrays.
+ */
+inline bool SameDataSets(vtkDataSet *a, vtkDataSet *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  for (vtkIdType ptId = 0; ptId < a->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3], y[3];
+    a->GetPoint(ptId, x);
+    b->GetPoint(ptId, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      return false;
+    }
+  }
+  vtkNew<vtkIdList> ptsA;
+  vtkNew<vtkIdList> ptsB;
+  for (vtkIdType cellId = 0; cellId < a->GetNumberOfCells(); ++cellId)
+  {
+    a->GetCellPoints(cellId, ptsA.GetPointer());
+    b->GetCellPoints(cellId, ptsB.GetPointer());
+    if (a->GetCellType(cellId) != b->GetCellType(cellId) ||
+        ptsA->GetNumberOfIds() != ptsB->GetNumberOfIds())
+    {
+      return false;
+    }
+    for (vtkIdType i = 0; i < ptsA->GetNumberOfIds(); ++i)
+    {
+      if (ptsA->GetId(i) != ptsB->GetId(i))
+      {
+        return false;
+      }
+    }
+  }
+  return SameFieldData(a->GetPointData(), b->GetPointData()) &&
+         SameFieldData(a->GetCellData(), b->GetCellData());
+}
+
+/**
+ * Execute the algorithm again with the given number of threads, and return
+ * a copy of its output dataset on the given port.
+ */
+inline vtkSmartPointer<vtkDataSet> UpdateWithThreads(vtkAlgorithm *algorithm,
+                                                     int numberOfThreads,
+                                                     int port = 0)
+{
+  vtkSMPTools::LocalScope scope((vtkSMPTools::Config(numberOfThreads)));
+  algorithm->Modified();
+  algorithm->Update(port);
+  vtkDataSet *output =
+    vtkDataSet::SafeDownCast(algorithm->GetOutputDataObject(port));
+  vtkSmartPointer<vtkDataSet> copy;
+  copy.TakeReference(output->NewInstance());
+  copy->DeepCopy(output);
+  return copy;
+}
+
+/**
+ * Return true if the algorithm gives the same output dataset on the given
+ * port with one thread and with the given number of threads.
+ */
+inline bool SameThreadedOutputs(vtkAlgorithm *algorithm, int numberOfThreads,
+                                int port = 0)
+{
+  vtkSmartPointer<vtkDataSet> serial = UpdateWithThreads(algorithm, 1, port);
+  vtkSmartPointer<vtkDataSet> threaded =
+    UpdateWithThreads(algorithm, numberOfThreads, port);
+  return SameDataSets(serial, threaded);
+}
+
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkTestDataSetComparison.h